@@ -0,0 +1,46 @@
+#include "audio/pcm_cache.hpp"
+
+namespace osc::audio {
+
+std::shared_ptr<const DecodedWave> PcmCache::find(const std::string& key) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return nullptr;
+    lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+    return it->second.wave;
+}
+
+void PcmCache::insert(const std::string& key,
+                      std::shared_ptr<const DecodedWave> wave) {
+    if (!wave) return;
+
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        bytes_ -= it->second.wave->bytes();
+        lru_.erase(it->second.lru_it);
+        entries_.erase(it);
+    }
+
+    size_t size = wave->bytes();
+    if (size > budget_) return;
+    evict_to(budget_ - size);
+
+    lru_.push_front(key);
+    entries_[key] = Entry{std::move(wave), lru_.begin()};
+    bytes_ += size;
+}
+
+void PcmCache::set_budget(size_t bytes) {
+    budget_ = bytes;
+    evict_to(budget_);
+}
+
+void PcmCache::evict_to(size_t limit) {
+    while (bytes_ > limit && !lru_.empty()) {
+        auto it = entries_.find(lru_.back());
+        bytes_ -= it->second.wave->bytes();
+        entries_.erase(it);
+        lru_.pop_back();
+    }
+}
+
+} // namespace osc::audio
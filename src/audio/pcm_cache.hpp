@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace osc::audio {
+
+/// A fully decoded wave: interleaved f32 samples at the source rate.
+struct DecodedWave {
+    std::vector<f32> samples;
+    u32 channels = 1;
+    u32 sample_rate = 22050;
+    u64 frames = 0;
+
+    size_t bytes() const { return samples.size() * sizeof(f32); }
+};
+
+/// LRU cache of decoded waves, bounded by total sample bytes.
+/// Entries are shared: a voice still playing an evicted wave keeps it alive.
+class PcmCache {
+public:
+    static constexpr size_t DEFAULT_BUDGET = 64u << 20;
+
+    explicit PcmCache(size_t budget_bytes = DEFAULT_BUDGET)
+        : budget_(budget_bytes) {}
+
+    /// Look up a wave, marking it most recently used. nullptr on miss.
+    std::shared_ptr<const DecodedWave> find(const std::string& key);
+
+    /// Insert (or replace) a wave, evicting least recently used entries
+    /// until the cache fits. Waves larger than the budget are not cached.
+    void insert(const std::string& key,
+                std::shared_ptr<const DecodedWave> wave);
+
+    void set_budget(size_t bytes);
+    size_t budget() const { return budget_; }
+    size_t bytes() const { return bytes_; }
+    size_t size() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        std::shared_ptr<const DecodedWave> wave;
+        std::list<std::string>::iterator lru_it;
+    };
+
+    void evict_to(size_t limit);
+
+    size_t budget_;
+    size_t bytes_ = 0;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_; // most recent first
+};
+
+} // namespace osc::audio
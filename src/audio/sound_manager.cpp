@@ -8,24 +8,33 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <functional>
 
 namespace osc::audio {
 
 // ---- Pimpl structs (keep miniaudio.h out of header) ----
 
 struct SoundManager::AudioEngine {
+    ma_context context;
     ma_engine engine;
+    bool context_initialized = false;
     bool initialized = false;
 };
 
-struct SoundManager::ActiveSound {
-    ma_decoder decoder;
+struct SoundManager::Voice {
+    ma_audio_buffer buffer; // reads straight from wave->samples
     ma_sound sound;
-    std::vector<u8> wav_data; // must outlive decoder
-    bool decoder_initialized = false;
-    bool sound_initialized = false;
+    std::shared_ptr<const DecodedWave> wave; // must outlive buffer
+    bool in_use = false;
     bool looping = false;
+    VoicePriority priority = VoicePriority::Positional;
+    size_t cue_key = 0;
+    u64 serial = 0;
+    SoundHandle handle = INVALID_SOUND;
+    u32 live_index = 0; // position in live_
 };
 
 // ---- WAV header synthesis ----
@@ -126,9 +135,10 @@ static std::vector<u8> build_wav(const WaveInfo& info, const std::vector<u8>& ra
 
 // ---- SoundManager implementation ----
 
-SoundManager::SoundManager(const fs::path& sounds_dir)
+SoundManager::SoundManager(const fs::path& sounds_dir, bool null_device)
     : sounds_dir_(sounds_dir)
     , engine_(std::make_unique<AudioEngine>())
+    , voices_(std::make_unique<Voice[]>(MAX_VOICES))
 {
     if (!fs::exists(sounds_dir_)) {
         spdlog::warn("Sound directory not found: {} — running headless",
@@ -140,6 +150,18 @@ SoundManager::SoundManager(const fs::path& sounds_dir)
     ma_engine_config cfg = ma_engine_config_init();
     cfg.listenerCount = 1;
 
+    if (null_device) {
+        ma_backend backends[] = {ma_backend_null};
+        if (ma_context_init(backends, 1, nullptr, &engine_->context) !=
+            MA_SUCCESS) {
+            spdlog::warn("Failed to initialize null audio backend — running headless");
+            headless_ = true;
+            return;
+        }
+        engine_->context_initialized = true;
+        cfg.pContext = &engine_->context;
+    }
+
     ma_result result = ma_engine_init(&cfg, &engine_->engine);
     if (result != MA_SUCCESS) {
         spdlog::warn("Failed to initialize audio engine (error {}) — running headless",
@@ -152,20 +174,15 @@ SoundManager::SoundManager(const fs::path& sounds_dir)
 }
 
 SoundManager::~SoundManager() {
-    // Stop and clean up all active sounds
-    for (auto& [handle, snd] : active_sounds_) {
-        if (snd->sound_initialized) {
-            ma_sound_uninit(&snd->sound);
-        }
-        if (snd->decoder_initialized) {
-            ma_decoder_uninit(&snd->decoder);
-        }
-    }
-    active_sounds_.clear();
+    // Stop and clean up all active voices
+    while (live_count_ > 0) release_voice(live_[live_count_ - 1].slot);
 
     if (engine_ && engine_->initialized) {
         ma_engine_uninit(&engine_->engine);
     }
+    if (engine_ && engine_->context_initialized) {
+        ma_context_uninit(&engine_->context);
+    }
 }
 
 SoundManager::BankPair* SoundManager::ensure_bank(const std::string& bank_name) {
@@ -228,10 +245,188 @@ SoundHandle SoundManager::play_loop(const std::string& bank, const std::string&
     return play_internal(bank, cue, pos, true);
 }
 
+std::shared_ptr<const DecodedWave> SoundManager::load_wave(XwbParser& xwb,
+                                                           u32 track) {
+    std::string key = xwb.bank_name() + '#' + std::to_string(track);
+    if (auto cached = pcm_cache_.find(key)) {
+        stats_.cache_hits++;
+        return cached;
+    }
+
+    // Read raw wave data from XWB
+    auto raw = xwb.read_wave_data(track);
+    if (raw.empty()) {
+        spdlog::debug("Empty wave data for track {}", track);
+        return nullptr;
+    }
+
+    // Wrap in WAV header for miniaudio decoding
+    auto wav = wrap_as_wav(xwb.entry(track), raw);
+
+    ma_decoder_config dec_cfg = ma_decoder_config_init(
+        ma_format_f32,
+        0,  // use source channel count
+        0   // use source sample rate
+    );
+    ma_decoder decoder;
+    ma_result r = ma_decoder_init_memory(wav.data(), wav.size(), &dec_cfg,
+                                         &decoder);
+    if (r != MA_SUCCESS) {
+        spdlog::debug("Failed to decode {} (error {})", key, static_cast<int>(r));
+        return nullptr;
+    }
+
+    // Decode the whole wave once; every later play shares these samples
+    auto wave = std::make_shared<DecodedWave>();
+    wave->channels = decoder.outputChannels;
+    wave->sample_rate = decoder.outputSampleRate;
+    constexpr ma_uint64 CHUNK_FRAMES = 4096;
+    for (;;) {
+        size_t base = wave->samples.size();
+        wave->samples.resize(base + CHUNK_FRAMES * wave->channels);
+        ma_uint64 read = 0;
+        ma_decoder_read_pcm_frames(&decoder, wave->samples.data() + base,
+                                   CHUNK_FRAMES, &read);
+        wave->frames += read;
+        if (read < CHUNK_FRAMES) break;
+    }
+    ma_decoder_uninit(&decoder);
+    wave->samples.resize(static_cast<size_t>(wave->frames) * wave->channels);
+    wave->samples.shrink_to_fit();
+    if (wave->frames == 0) return nullptr;
+
+    stats_.decodes++;
+    pcm_cache_.insert(key, wave);
+    return wave;
+}
+
+i32 SoundManager::acquire_voice(size_t cue_key, VoicePriority priority) {
+    // Per-cue limit: a cue at its cap replaces its own oldest one-shot
+    u32 same_cue = 0;
+    i32 oldest_same = -1;
+    i32 free_slot = -1;
+    i32 victim = -1;
+    if (live_count_ < MAX_VOICES) {
+        for (u32 i = 0; i < MAX_VOICES; i++) {
+            if (!voices_[i].in_use) { free_slot = static_cast<i32>(i); break; }
+        }
+    }
+    for (u32 l = 0; l < live_count_; l++) {
+        u32 i = live_[l].slot;
+        const auto& v = voices_[i];
+        if (v.cue_key == cue_key) same_cue++;
+        if (v.looping) continue; // loops are owned by their handle
+        if (v.cue_key == cue_key &&
+            (oldest_same < 0 || v.serial < voices_[oldest_same].serial))
+            oldest_same = static_cast<i32>(i);
+        if (victim < 0 || v.priority < voices_[victim].priority ||
+            (v.priority == voices_[victim].priority &&
+             v.serial < voices_[victim].serial))
+            victim = static_cast<i32>(i);
+    }
+
+    i32 slot = -1;
+    if (same_cue >= MAX_VOICES_PER_CUE) {
+        slot = oldest_same;
+    } else if (free_slot >= 0) {
+        return free_slot;
+    } else if (victim >= 0 && voices_[victim].priority <= priority) {
+        slot = victim;
+    }
+    if (slot < 0) return -1;
+
+    release_voice(static_cast<u32>(slot));
+    stats_.voices_stolen++;
+    return slot;
+}
+
+void SoundManager::release_voice(u32 slot) {
+    auto& v = voices_[slot];
+    if (!v.in_use) return;
+    ma_sound_stop(&v.sound);
+    ma_sound_uninit(&v.sound);
+    ma_audio_buffer_uninit(&v.buffer);
+    v.wave.reset();
+    v.in_use = false;
+    v.handle = INVALID_SOUND;
+
+    // Swap-remove from the dense live array
+    u32 last = --live_count_;
+    if (v.live_index != last) {
+        live_[v.live_index] = live_[last];
+        voices_[live_[v.live_index].slot].live_index = v.live_index;
+    }
+}
+
+SoundHandle SoundManager::try_coalesce(size_t cue_key, const sim::Vector3& pos) {
+    constexpr f32 R2 = COALESCE_RADIUS * COALESCE_RADIUS;
+    for (u32 l = 0; l < live_count_; l++) {
+        auto& lv = live_[l];
+        const auto& v = voices_[lv.slot];
+        if (v.cue_key != cue_key || v.looping || !lv.positional) continue;
+        if (clock_ - lv.started > COALESCE_WINDOW) continue;
+        f32 dx = pos.x - lv.x, dz = pos.z - lv.z;
+        if (dx * dx + dz * dz > R2) continue;
+
+        // Uncorrelated copies of a sound add in power: gain grows as sqrt(n).
+        // The voice drifts to the centroid of the folded emitters.
+        lv.instances++;
+        f32 n = static_cast<f32>(lv.instances);
+        lv.x += dx / n;
+        lv.z += dz / n;
+        lv.gain = std::min(std::sqrt(n), MAX_COALESCED_GAIN);
+        spatialize(lv);
+        stats_.coalesced++;
+        return v.handle;
+    }
+    return INVALID_SOUND;
+}
+
+f32 SoundManager::attenuation(f32 dist) const {
+    if (dist > hearing_max_) return 0.0f;
+    return hearing_min_ / std::max(dist, hearing_min_);
+}
+
+void SoundManager::spatialize(LiveVoice& lv) {
+    f32 volume = lv.gain;
+    f32 pan = 0.0f;
+    if (lv.positional) {
+        f32 dx = lv.x - listener_x_, dz = lv.z - listener_z_;
+        f32 dist = std::sqrt(dx * dx + dz * dz);
+        volume *= attenuation(dist);
+        f32 side = dx * listener_right_x_ + dz * listener_right_z_;
+        pan = std::clamp(side / (dist + hearing_min_), -1.0f, 1.0f);
+    }
+
+    // Skip the miniaudio calls when nothing audible changed
+    constexpr f32 EPS = 1.0f / 256.0f;
+    auto& sound = voices_[lv.slot].sound;
+    if (std::abs(volume - lv.volume) > EPS) {
+        ma_sound_set_volume(&sound, volume);
+        lv.volume = volume;
+    }
+    if (std::abs(pan - lv.pan) > EPS) {
+        ma_sound_set_pan(&sound, pan);
+        lv.pan = pan;
+    }
+}
+
 SoundHandle SoundManager::play_internal(const std::string& bank, const std::string& cue,
                                          const sim::Vector3* pos, bool looping) {
     if (headless_) return INVALID_SOUND;
 
+    // Inaudible and repeated one-shots are dropped before any bank or
+    // decode work. Only what attenuation() would silence is culled.
+    size_t cue_key = std::hash<std::string>{}(bank + '/' + cue);
+    if (pos && !looping) {
+        f32 dx = pos->x - listener_x_, dz = pos->z - listener_z_;
+        if (listener_set_ && attenuation(std::sqrt(dx * dx + dz * dz)) == 0.0f) {
+            stats_.culled++;
+            return INVALID_SOUND;
+        }
+        if (auto handle = try_coalesce(cue_key, *pos)) return handle;
+    }
+
     auto* bp = ensure_bank(bank);
     if (!bp) return INVALID_SOUND;
 
@@ -252,125 +447,132 @@ SoundHandle SoundManager::play_internal(const std::string& bank, const std::stri
         xwb = alt_bank->xwb.get();
     }
 
-    spdlog::debug("Cue {}/{} → wb={} track={}", bank, cue, wb_name,
-                  mapping->track_index);
-
     if (mapping->track_index >= xwb->entry_count()) {
         spdlog::debug("Track index {} out of range for bank {} ({} entries)",
                       mapping->track_index, wb_name, xwb->entry_count());
         return INVALID_SOUND;
     }
 
-    // Read raw wave data from XWB
-    auto raw = xwb->read_wave_data(mapping->track_index);
-    if (raw.empty()) {
-        spdlog::debug("Empty wave data for track {}", mapping->track_index);
+    auto wave = load_wave(*xwb, mapping->track_index);
+    if (!wave) return INVALID_SOUND;
+
+    VoicePriority priority = !pos ? VoicePriority::Interface
+                             : looping ? VoicePriority::Looping
+                                       : VoicePriority::Positional;
+    i32 slot = acquire_voice(cue_key, priority);
+    if (slot < 0) {
+        stats_.rejected++;
         return INVALID_SOUND;
     }
-
-    const auto& info = xwb->entry(mapping->track_index);
-
-    // Wrap in WAV header for miniaudio decoding
-    auto wav = wrap_as_wav(info, raw);
-
-    // Create active sound
-    auto active = std::make_unique<ActiveSound>();
-    active->wav_data = std::move(wav);
-    active->looping = looping;
-
-    // Initialize decoder from memory
-    ma_decoder_config dec_cfg = ma_decoder_config_init(
-        ma_format_f32,
-        0,  // use source channel count
-        0   // use source sample rate
-    );
-
-    ma_result r = ma_decoder_init_memory(
-        active->wav_data.data(),
-        active->wav_data.size(),
-        &dec_cfg,
-        &active->decoder
-    );
+    auto& voice = voices_[slot];
+
+    // Play straight from the cached samples (no copy)
+    ma_audio_buffer_config buf_cfg = ma_audio_buffer_config_init(
+        ma_format_f32, wave->channels, wave->frames, wave->samples.data(),
+        nullptr);
+    buf_cfg.sampleRate = wave->sample_rate;
+    ma_result r = ma_audio_buffer_init(&buf_cfg, &voice.buffer);
     if (r != MA_SUCCESS) {
-        spdlog::debug("Failed to decode {}/{} (error {})", bank, cue, static_cast<int>(r));
+        spdlog::debug("Failed to create buffer {}/{} (error {})", bank, cue, static_cast<int>(r));
         return INVALID_SOUND;
     }
-    active->decoder_initialized = true;
 
-    // Create sound from decoder data source
+    // Create sound from the buffer data source. Spatialization is done by
+    // update() on the game thread, not per voice in the mixer.
     r = ma_sound_init_from_data_source(
         &engine_->engine,
-        &active->decoder,
-        0, // flags
+        &voice.buffer,
+        MA_SOUND_FLAG_NO_SPATIALIZATION,
         nullptr, // group
-        &active->sound
+        &voice.sound
     );
     if (r != MA_SUCCESS) {
         spdlog::debug("Failed to create sound {}/{} (error {})", bank, cue, static_cast<int>(r));
-        ma_decoder_uninit(&active->decoder);
+        ma_audio_buffer_uninit(&voice.buffer);
         return INVALID_SOUND;
     }
-    active->sound_initialized = true;
-
-    // Configure 3D position
-    if (pos) {
-        ma_sound_set_position(&active->sound, pos->x, pos->y, pos->z);
-        ma_sound_set_spatialization_enabled(&active->sound, MA_TRUE);
-        ma_sound_set_min_distance(&active->sound, 5.0f);
-        ma_sound_set_max_distance(&active->sound, 200.0f);
-    }
 
     // Set looping
     if (looping) {
-        ma_sound_set_looping(&active->sound, MA_TRUE);
+        ma_sound_set_looping(&voice.sound, MA_TRUE);
     }
 
-    // Start playback
-    ma_sound_start(&active->sound);
+    voice.live_index = live_count_;
+    auto& lv = live_[live_count_++];
+    lv = LiveVoice{};
+    lv.slot = static_cast<u32>(slot);
+    lv.started = clock_;
+    if (pos) {
+        lv.positional = true;
+        lv.x = pos->x;
+        lv.z = pos->z;
+    }
+    spatialize(lv);
 
-    auto handle = next_handle_++;
-    active_sounds_[handle] = std::move(active);
-    return handle;
+    // Start playback
+    ma_sound_start(&voice.sound);
+
+    voice.wave = std::move(wave);
+    voice.in_use = true;
+    voice.looping = looping;
+    voice.priority = priority;
+    voice.cue_key = cue_key;
+    voice.serial = next_serial_++;
+    voice.handle = next_handle_++;
+    return voice.handle;
 }
 
 void SoundManager::stop(SoundHandle handle) {
     if (handle == INVALID_SOUND) return;
 
-    auto it = active_sounds_.find(handle);
-    if (it == active_sounds_.end()) return;
-
-    auto& snd = it->second;
-    if (snd->sound_initialized) {
-        ma_sound_stop(&snd->sound);
-        ma_sound_uninit(&snd->sound);
-    }
-    if (snd->decoder_initialized) {
-        ma_decoder_uninit(&snd->decoder);
+    for (u32 l = 0; l < live_count_; l++) {
+        u32 slot = live_[l].slot;
+        if (voices_[slot].handle == handle) {
+            release_voice(slot);
+            return;
+        }
     }
-    active_sounds_.erase(it);
 }
 
-void SoundManager::set_listener_position(const sim::Vector3& pos) {
-    if (headless_ || !engine_->initialized) return;
-    ma_engine_listener_set_position(&engine_->engine, 0, pos.x, pos.y, pos.z);
+void SoundManager::set_listener_position(const sim::Vector3& pos, f32 yaw,
+                                         f32 view_radius) {
+    listener_x_ = pos.x;
+    listener_z_ = pos.z;
+    // Zoomed out, the rolloff stretches with the view instead of
+    // silencing the edges of the screen
+    f32 scale = std::max(1.0f, view_radius / MAX_DISTANCE);
+    hearing_min_ = MIN_DISTANCE * scale;
+    hearing_max_ = MAX_DISTANCE * scale;
+    // Screen-right on the ground plane for a camera orbiting at `yaw`
+    listener_right_x_ = std::cos(yaw);
+    listener_right_z_ = -std::sin(yaw);
+    listener_set_ = true;
+}
+
+void SoundManager::update(f64 dt) {
+    if (headless_) return;
+    clock_ += dt;
+
+    for (u32 l = 0; l < live_count_; l++) {
+        spatialize(live_[l]);
+    }
+    gc();
 }
 
 void SoundManager::gc() {
     if (headless_) return;
 
-    for (auto it = active_sounds_.begin(); it != active_sounds_.end(); ) {
-        auto& snd = it->second;
-        if (!snd->looping && snd->sound_initialized &&
-            !ma_sound_is_playing(&snd->sound)) {
-            ma_sound_uninit(&snd->sound);
-            if (snd->decoder_initialized) {
-                ma_decoder_uninit(&snd->decoder);
-            }
-            it = active_sounds_.erase(it);
-        } else {
-            ++it;
+    // Walk backwards: release_voice swap-removes from live_
+    for (u32 l = live_count_; l-- > 0;) {
+        const auto& v = voices_[live_[l].slot];
+        if (!v.looping && !ma_sound_is_playing(&v.sound)) {
+            release_voice(live_[l].slot);
         }
     }
 }
 
+u32 SoundManager::active_voice_count() const {
+    return live_count_;
+}
+
 } // namespace osc::audio
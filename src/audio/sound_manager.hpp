@@ -1,8 +1,10 @@
 #pragma once
 
+#include "audio/pcm_cache.hpp"
 #include "core/types.hpp"
 #include "sim/entity.hpp" // for Vector3
 
+#include <array>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -16,11 +18,50 @@ class XsbParser;
 using SoundHandle = u32;
 constexpr SoundHandle INVALID_SOUND = 0;
 
+/// Voice stealing order: lower priorities are stolen first.
+enum class VoicePriority : u8 {
+    Positional = 0, // one-shot world sounds (weapons, impacts)
+    Looping = 1,    // ambient loops (never stolen, only rejected)
+    Interface = 2,  // non-positional UI sounds
+};
+
 /// Manages audio playback: loads XACT3 sound banks, plays sounds via miniaudio.
 /// Gracefully degrades to headless mode if no audio device or sounds directory.
+///
+/// Waves are decoded once into a shared PCM cache and played from a fixed
+/// pool of MAX_VOICES voices. When the pool is full, the oldest one-shot of
+/// the lowest priority is stolen; a cue already playing MAX_VOICES_PER_CUE
+/// times replaces its own oldest instance instead.
+///
+/// Positional one-shots the attenuation would silence (beyond the hearing
+/// range, MAX_DISTANCE widened to cover the view) are culled before any
+/// bank or decode work, and repeats of a cue within COALESCE_WINDOW
+/// seconds and COALESCE_RADIUS of a playing instance fold into that voice
+/// (louder) instead of starting another. Attenuation and panning are
+/// computed by update() once per frame over a dense array of live voices.
 class SoundManager {
 public:
-    explicit SoundManager(const fs::path& sounds_dir);
+    static constexpr u32 MAX_VOICES = 64;
+    static constexpr u32 MAX_VOICES_PER_CUE = 4;
+
+    static constexpr f32 MIN_DISTANCE = 5.0f;     // full volume inside this
+    static constexpr f32 MAX_DISTANCE = 200.0f;   // inaudible beyond this (unzoomed)
+    static constexpr f64 COALESCE_WINDOW = 0.1;   // seconds
+    static constexpr f32 COALESCE_RADIUS = 10.0f; // world units
+    static constexpr f32 MAX_COALESCED_GAIN = 2.0f;
+
+    struct Stats {
+        u32 decodes = 0;       // waves decoded (PCM cache misses)
+        u32 cache_hits = 0;    // plays served from the PCM cache
+        u32 voices_stolen = 0; // voices cut short to make room
+        u32 rejected = 0;      // plays dropped (no stealable voice)
+        u32 culled = 0;        // positional plays out of listener range
+        u32 coalesced = 0;     // plays folded into a nearby identical voice
+    };
+
+    /// null_device selects miniaudio's null backend (no audio hardware),
+    /// so the full playback path can run headless in tests.
+    explicit SoundManager(const fs::path& sounds_dir, bool null_device = false);
     ~SoundManager();
 
     // Non-copyable
@@ -40,12 +81,34 @@ public:
     /// Stop a previously started looping sound.
     void stop(SoundHandle handle);
 
-    /// Update the listener position (call once per tick).
-    void set_listener_position(const sim::Vector3& pos);
-
-    /// Clean up finished one-shot sounds. Call periodically (e.g. per tick).
+    /// Place the listener on the ground plane. yaw follows the camera
+    /// convention (0 = camera behind the target on +Z) and orients panning.
+    /// view_radius is how far from `pos` the view reaches on the ground;
+    /// when it exceeds MAX_DISTANCE the hearing range (both distances)
+    /// scales up with it, so zooming out keeps on-screen sounds audible.
+    /// Until the first call nothing is distance-culled.
+    void set_listener_position(const sim::Vector3& pos, f32 yaw = 0.0f,
+                               f32 view_radius = 0.0f);
+
+    /// Distance from the listener beyond which sounds are silent (and
+    /// one-shots culled).
+    f32 hearing_range() const { return hearing_max_; }
+
+    /// Advance the coalescing clock, apply listener-relative attenuation and
+    /// panning to every live voice, and reap finished one-shots. Call once
+    /// per frame.
+    void update(f64 dt);
+
+    /// Return finished one-shot voices to the pool. Call periodically (e.g. per tick).
     void gc();
 
+    /// Cap the decoded PCM cache (LRU eviction).
+    void set_pcm_cache_budget(size_t bytes) { pcm_cache_.set_budget(bytes); }
+    const PcmCache& pcm_cache() const { return pcm_cache_; }
+
+    const Stats& stats() const { return stats_; }
+    u32 active_voice_count() const;
+
 private:
     struct BankPair {
         std::unique_ptr<XwbParser> xwb;
@@ -53,7 +116,20 @@ private:
     };
 
     struct AudioEngine;
-    struct ActiveSound;
+    struct Voice;
+
+    /// Per-frame spatial state of a playing voice, packed densely so the
+    /// once-per-frame update touches only this array.
+    struct LiveVoice {
+        u32 slot = 0;              // index into voices_
+        f32 x = 0, z = 0;          // world position (ground plane)
+        bool positional = false;
+        f32 gain = 1.0f;           // coalescing boost
+        u32 instances = 1;         // plays folded into this voice
+        f64 started = 0;           // clock_ at start, for coalescing
+        f32 volume = -1.0f;        // last values pushed to miniaudio
+        f32 pan = 0.0f;
+    };
 
     /// Lazy-load a bank pair by name. Returns nullptr if not found.
     BankPair* ensure_bank(const std::string& bank_name);
@@ -62,6 +138,26 @@ private:
     std::vector<u8> wrap_as_wav(const struct WaveInfo& info,
                                 const std::vector<u8>& raw_data);
 
+    /// Decoded PCM for a wave bank track, decoding on first use.
+    std::shared_ptr<const DecodedWave> load_wave(XwbParser& xwb, u32 track);
+
+    /// Pick a voice slot for a new sound, stealing if needed. -1 if none.
+    i32 acquire_voice(size_t cue_key, VoicePriority priority);
+
+    /// Stop and uninitialize a voice, returning it to the pool.
+    void release_voice(u32 slot);
+
+    /// Fold a positional one-shot into a recent nearby instance of the same
+    /// cue. Returns that voice's handle, or INVALID_SOUND if none qualifies.
+    SoundHandle try_coalesce(size_t cue_key, const sim::Vector3& pos);
+
+    /// Inverse-distance gain at `dist` from the listener; 0 past the
+    /// hearing range. Shared by spatialize() and the cull in play.
+    f32 attenuation(f32 dist) const;
+
+    /// Push listener-relative volume and pan for one live voice.
+    void spatialize(LiveVoice& lv);
+
     /// Internal play implementation.
     SoundHandle play_internal(const std::string& bank, const std::string& cue,
                               const sim::Vector3* pos, bool looping);
@@ -72,8 +168,19 @@ private:
     std::unique_ptr<AudioEngine> engine_;
     std::unordered_map<std::string, std::unique_ptr<BankPair>> banks_;
 
+    PcmCache pcm_cache_;
+    std::unique_ptr<Voice[]> voices_; // MAX_VOICES, fixed addresses
+    std::array<LiveVoice, MAX_VOICES> live_; // [0, live_count_) are playing
+    u32 live_count_ = 0;
+
+    f32 listener_x_ = 0, listener_z_ = 0;
+    f32 listener_right_x_ = 1.0f, listener_right_z_ = 0.0f;
+    f32 hearing_min_ = MIN_DISTANCE, hearing_max_ = MAX_DISTANCE;
+    bool listener_set_ = false;
+    f64 clock_ = 0;
     u32 next_handle_ = 1;
-    std::unordered_map<SoundHandle, std::unique_ptr<ActiveSound>> active_sounds_;
+    u64 next_serial_ = 1; // start order, for oldest-first stealing
+    Stats stats_;
 };
 
 } // namespace osc::audio
@@ -60,6 +60,10 @@ static WaveInfo decode_miniwaveformat(u32 fmt) {
 
 Result<void> XwbParser::parse(const fs::path& xwb_path) {
     path_ = xwb_path;
+    {
+        std::lock_guard lock(file_mutex_);
+        file_.close();
+    }
     entries_.clear();
     bank_name_.clear();
 
@@ -195,19 +199,23 @@ Result<void> XwbParser::parse(const fs::path& xwb_path) {
     return Result<void>();
 }
 
-std::vector<u8> XwbParser::read_wave_data(u32 index) const {
+std::vector<u8> XwbParser::read_wave_data(u32 index) {
     if (index >= entries_.size()) return {};
 
     const auto& e = entries_[index];
     if (e.data_length == 0) return {};
 
-    std::ifstream file(path_, std::ios::binary);
-    if (!file) return {};
-
-    file.seekg(e.data_offset);
     std::vector<u8> data(e.data_length);
-    file.read(reinterpret_cast<char*>(data.data()), e.data_length);
-    if (!file) return {};
+    std::lock_guard lock(file_mutex_);
+    if (!file_.is_open()) {
+        file_.open(path_, std::ios::binary);
+        if (!file_) return {};
+    }
+
+    file_.clear(); // reset eof/fail from a previous short read
+    file_.seekg(e.data_offset);
+    file_.read(reinterpret_cast<char*>(data.data()), e.data_length);
+    if (!file_) return {};
 
     return data;
 }
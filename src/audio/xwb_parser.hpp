@@ -3,6 +3,8 @@
 #include "core/result.hpp"
 #include "core/types.hpp"
 
+#include <fstream>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -21,7 +23,9 @@ struct WaveInfo {
 };
 
 /// Parses XACT3 .xwb (Xbox Wave Bank) files.
-/// Only reads metadata on parse(); wave data is lazily read per-entry.
+/// Only reads metadata on parse(); wave data is lazily read per-entry
+/// through a file handle kept open for the parser's lifetime. Reads may
+/// come from several threads; they take turns on the handle.
 class XwbParser {
 public:
     /// Parse wave bank header and entry metadata from file.
@@ -32,10 +36,13 @@ public:
     const WaveInfo& entry(u32 index) const { return entries_[index]; }
 
     /// Read raw wave data for a specific entry from the file (lazy I/O).
-    std::vector<u8> read_wave_data(u32 index) const;
+    /// Not const: it moves the shared file handle.
+    std::vector<u8> read_wave_data(u32 index);
 
 private:
     fs::path path_;
+    std::mutex file_mutex_; // guards file_ (seek + read)
+    std::ifstream file_;    // reused by read_wave_data
     std::string bank_name_;
     std::vector<WaveInfo> entries_;
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/tracer.hpp"
 #include "core/types.hpp"
 
 #include <spdlog/spdlog.h>
@@ -257,6 +258,9 @@ struct ProfileScope {
 } // namespace osc
 
 /// Convenience macro for scoped profiling. Uses a static string literal.
+/// The zone also appears on the Tracer timeline when a capture is running.
 #define PROFILE_CONCAT_(a, b) a##b
 #define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
-#define PROFILE_ZONE(name) ::osc::ProfileScope PROFILE_CONCAT(_profile_scope_, __LINE__)(name)
+#define PROFILE_ZONE(name)                                                     \
+    TRACE_ZONE(name);                                                          \
+    ::osc::ProfileScope PROFILE_CONCAT(_profile_scope_, __LINE__)(name)
@@ -0,0 +1,203 @@
+#include "core/tracer.hpp"
+
+#include <chrono>
+#include <fmt/format.h>
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+namespace osc {
+
+namespace {
+
+u64 now_ns() {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch())
+                                .count());
+}
+
+void write_json_string(std::ostream& out, const char* s) {
+    out << '"';
+    for (; *s; ++s) {
+        char c = *s;
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << fmt::format("\\u{:04x}", static_cast<unsigned>(c));
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+/// The calling thread's buffer, handed back to the tracer when the thread
+/// exits. Threads that come and go (std::async texture loads, a decoder
+/// thread per video) then reuse buffers instead of each leaving one behind.
+struct TraceBufferLease {
+    Tracer::ThreadBuffer* buffer = nullptr;
+    ~TraceBufferLease() {
+        if (buffer) Tracer::instance().release_buffer(buffer);
+    }
+};
+
+static thread_local TraceBufferLease t_lease;
+
+void Tracer::start() {
+    std::lock_guard lock(mutex_);
+    // Writers stamp events against start_ns_ once they see the new epoch
+    start_ns_.store(now_ns(), std::memory_order_relaxed);
+    epoch_.fetch_add(1, std::memory_order_release);
+    dropped_.store(0, std::memory_order_relaxed);
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::stop() {
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+void Tracer::set_thread_name(std::string name) {
+    if (!t_lease.buffer) t_lease.buffer = acquire_buffer();
+    std::lock_guard lock(mutex_);
+    t_lease.buffer->name = std::move(name);
+}
+
+Tracer::ThreadBuffer* Tracer::acquire_buffer() {
+    std::lock_guard lock(mutex_);
+    // A buffer holding events of the current capture keeps them under its
+    // exited thread's track until the next start(); only older ones are
+    // reused, under a new track. Their stale events are skipped by readers
+    // and rewound by the first record().
+    u32 epoch = epoch_.load(std::memory_order_relaxed);
+    for (auto& buffer : free_) {
+        if (buffer->epoch.load(std::memory_order_relaxed) == epoch) continue;
+        ThreadBuffer* reused = buffer;
+        buffer = free_.back();
+        free_.pop_back();
+        reused->tid = next_tid_++;
+        reused->name.clear();
+        return reused;
+    }
+    auto* buffer = new ThreadBuffer();
+    buffer->tid = next_tid_++;
+    buffers_.push_back(buffer);
+    return buffer;
+}
+
+void Tracer::release_buffer(ThreadBuffer* buffer) {
+    std::lock_guard lock(mutex_);
+    free_.push_back(buffer);
+}
+
+void Tracer::rewind(ThreadBuffer& buffer, u32 epoch) {
+    // Readers skip the buffer until the epoch store publishes the reset
+    u32 n = buffer.block_count.load(std::memory_order_relaxed);
+    for (u32 i = 0; i < n; ++i)
+        buffer.blocks[i].load(std::memory_order_relaxed)
+            ->count.store(0, std::memory_order_relaxed);
+    buffer.block = 0;
+    buffer.used = 0;
+    buffer.epoch.store(epoch, std::memory_order_release);
+}
+
+void Tracer::record(const TraceSite* site, TraceEventType type, i64 value) {
+    ThreadBuffer* buffer = t_lease.buffer;
+    if (!buffer) buffer = t_lease.buffer = acquire_buffer();
+
+    u32 epoch = epoch_.load(std::memory_order_acquire);
+    if (buffer->epoch.load(std::memory_order_relaxed) != epoch)
+        rewind(*buffer, epoch);
+
+    if (buffer->used == BLOCK_EVENTS) {
+        if (buffer->block + 1 >= MAX_BLOCKS) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buffer->block++;
+        buffer->used = 0;
+    }
+    Block* block = buffer->blocks[buffer->block].load(std::memory_order_relaxed);
+    if (!block) {
+        block = new Block();
+        buffer->blocks[buffer->block].store(block, std::memory_order_release);
+        buffer->block_count.store(buffer->block + 1, std::memory_order_release);
+    }
+
+    TraceEvent& e = block->events[buffer->used];
+    e.ts_ns = now_ns() - start_ns_.load(std::memory_order_relaxed);
+    e.site = site;
+    e.value = value;
+    e.type = type;
+    block->count.store(++buffer->used, std::memory_order_release);
+}
+
+std::vector<Tracer::ThreadEvents> Tracer::snapshot() const {
+    std::lock_guard lock(mutex_);
+    u32 epoch = epoch_.load(std::memory_order_acquire);
+    std::vector<ThreadEvents> result;
+    for (const ThreadBuffer* buffer : buffers_) {
+        if (buffer->epoch.load(std::memory_order_acquire) != epoch) continue;
+        ThreadEvents te;
+        te.tid = buffer->tid;
+        te.name = buffer->name;
+        u32 blocks = buffer->block_count.load(std::memory_order_acquire);
+        for (u32 i = 0; i < blocks; ++i) {
+            const Block* block = buffer->blocks[i].load(std::memory_order_acquire);
+            u32 count = block->count.load(std::memory_order_acquire);
+            te.events.insert(te.events.end(), block->events,
+                             block->events + count);
+            if (count < BLOCK_EVENTS) break; // later blocks are stale
+        }
+        if (!te.events.empty()) result.push_back(std::move(te));
+    }
+    return result;
+}
+
+void Tracer::write_chrome_json(std::ostream& out) const {
+    auto threads = snapshot();
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto next = [&] {
+        if (!first) out << ",\n";
+        first = false;
+    };
+    for (const auto& t : threads) {
+        next();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << t.tid << ",\"args\":{\"name\":";
+        write_json_string(out, t.name.empty()
+                                   ? fmt::format("thread {}", t.tid).c_str()
+                                   : t.name.c_str());
+        out << "}}";
+        for (const auto& e : t.events) {
+            next();
+            out << "{\"name\":";
+            write_json_string(out, e.site->name);
+            const char* ph = e.type == TraceEventType::Begin ? "B"
+                             : e.type == TraceEventType::End ? "E"
+                                                             : "C";
+            out << fmt::format(",\"ph\":\"{}\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}",
+                               ph, static_cast<f64>(e.ts_ns) / 1000.0, t.tid);
+            if (e.type == TraceEventType::Counter)
+                out << ",\"args\":{\"value\":" << e.value << '}';
+            out << '}';
+        }
+    }
+    out << "\n]}\n";
+}
+
+bool Tracer::write_chrome_json(const fs::path& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        spdlog::error("Failed to open trace file: {}", path.string());
+        return false;
+    }
+    write_chrome_json(out);
+    if (dropped() > 0)
+        spdlog::warn("Trace: {} events dropped (thread buffers full)", dropped());
+    spdlog::info("Trace written: {}", path.string());
+    return static_cast<bool>(out);
+}
+
+} // namespace osc
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <atomic>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace osc {
+
+/// One TRACE_ZONE / TRACE_COUNTER expansion. Sites are static constexpr
+/// objects, so a zone's ID is its site's address: fixed at link time, no
+/// registration and no name lookup when a zone is entered.
+struct TraceSite {
+    const char* name;
+};
+
+enum class TraceEventType : u8 { Begin, End, Counter };
+
+struct TraceEvent {
+    u64 ts_ns = 0;                 ///< since the capture started
+    const TraceSite* site = nullptr;
+    i64 value = 0;                 ///< counters only
+    TraceEventType type = TraceEventType::Begin;
+};
+
+/// Timeline tracer for every thread (sim, loader, workers).
+///
+/// Each thread appends to its own buffer of fixed-size blocks. Only the
+/// owning thread writes; a block's event count is published with a
+/// release store, so snapshot() and the JSON export can read a capture
+/// while it is still running without locking the writers. Zones nest to
+/// any depth: a zone is just a Begin and an End event.
+///
+/// Usage:
+///   Tracer::instance().start();
+///   { TRACE_ZONE("Sim::tick"); ... TRACE_COUNTER("Entities", n); }
+///   Tracer::instance().write_chrome_json("trace.json");
+///
+/// The JSON loads in chrome://tracing and ui.perfetto.dev.
+class Tracer {
+public:
+    /// Events per block; a thread holds at most MAX_BLOCKS blocks
+    /// (2M events, 64 MB) per capture and drops events past that.
+    static constexpr u32 BLOCK_EVENTS = 4096;
+    static constexpr u32 MAX_BLOCKS = 512;
+
+    /// Never destroyed: threads hand their buffers back to it on exit,
+    /// which can happen after static destructors have run.
+    static Tracer& instance() {
+        static Tracer* s_instance = new Tracer();
+        return *s_instance;
+    }
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /// Begin a new capture, discarding the previous one.
+    void start();
+
+    /// Stop recording. The capture stays available for export.
+    void stop();
+
+    /// Label the calling thread on the timeline.
+    void set_thread_name(std::string name);
+
+    void begin(const TraceSite* site) { record(site, TraceEventType::Begin, 0); }
+    void end(const TraceSite* site) { record(site, TraceEventType::End, 0); }
+    void counter(const TraceSite* site, i64 value) {
+        if (enabled()) record(site, TraceEventType::Counter, value);
+    }
+
+    struct ThreadEvents {
+        u32 tid = 0;
+        std::string name;
+        std::vector<TraceEvent> events; ///< in recording order
+    };
+
+    /// Copy of the current capture, one entry per thread that recorded.
+    std::vector<ThreadEvents> snapshot() const;
+
+    /// Events dropped because a thread's buffer was full.
+    u64 dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /// Chrome trace event format ("traceEvents" JSON object).
+    void write_chrome_json(std::ostream& out) const;
+    bool write_chrome_json(const fs::path& path) const;
+
+private:
+    struct Block {
+        TraceEvent events[BLOCK_EVENTS];
+        std::atomic<u32> count{0};
+    };
+
+    /// One thread's events. Reused by a later thread, under a new tid, once
+    /// its owner has exited and its events left the current capture.
+    struct ThreadBuffer {
+        u32 tid = 0;      ///< guarded by mutex_
+        std::string name; ///< guarded by mutex_
+        std::atomic<u32> epoch{0};       ///< capture the contents belong to
+        std::atomic<Block*> blocks[MAX_BLOCKS] = {};
+        std::atomic<u32> block_count{0};
+        // Owner-only write position
+        u32 block = 0;
+        u32 used = 0;
+    };
+
+    friend struct TraceBufferLease;
+
+    Tracer() = default;
+
+    void record(const TraceSite* site, TraceEventType type, i64 value);
+    ThreadBuffer* acquire_buffer();
+    void release_buffer(ThreadBuffer* buffer);
+    static void rewind(ThreadBuffer& buffer, u32 epoch);
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<u32> epoch_{0};
+    std::atomic<u64> start_ns_{0};
+    std::atomic<u64> dropped_{0};
+
+    mutable std::mutex mutex_;
+    std::vector<ThreadBuffer*> buffers_; // all ever created
+    std::vector<ThreadBuffer*> free_;    // released by exited threads
+    u32 next_tid_ = 1;
+};
+
+/// RAII zone: records Begin/End when a capture is running at entry.
+class TraceScope {
+public:
+    explicit TraceScope(const TraceSite* site)
+        : site_(Tracer::instance().enabled() ? site : nullptr) {
+        if (site_) Tracer::instance().begin(site_);
+    }
+    ~TraceScope() {
+        if (site_) Tracer::instance().end(site_);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const TraceSite* site_;
+};
+
+} // namespace osc
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+/// Scoped timeline zone. `name` must be a string literal.
+#define TRACE_ZONE(name)                                                       \
+    static constexpr ::osc::TraceSite TRACE_CONCAT(_trace_site_, __LINE__){name}; \
+    ::osc::TraceScope TRACE_CONCAT(_trace_scope_, __LINE__)(                   \
+        &TRACE_CONCAT(_trace_site_, __LINE__))
+
+/// Record a counter sample (shown as a graph track).
+#define TRACE_COUNTER(name, value)                                             \
+    do {                                                                       \
+        static constexpr ::osc::TraceSite _trace_counter_site{name};           \
+        ::osc::Tracer::instance().counter(&_trace_counter_site,                \
+                                          static_cast<::osc::i64>(value));     \
+    } while (0)
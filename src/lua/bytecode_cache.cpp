@@ -0,0 +1,149 @@
+#include "lua/bytecode_cache.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+extern "C" {
+#include <lua.h>
+#include <lauxlib.h>
+}
+
+namespace osc::lua {
+
+namespace {
+
+/// Entry layout: header, then the lua_dump output.
+struct EntryHeader {
+    char magic[4];      // "OSCB"
+    u32 version;        // ENTRY_VERSION
+    u64 source_hash;
+    u64 source_len;
+    u64 bytecode_len;
+};
+
+constexpr char ENTRY_MAGIC[4] = {'O', 'S', 'C', 'B'};
+constexpr u32 ENTRY_VERSION = 1;
+
+/// Upper bound on an entry's bytecode; anything larger is corrupt.
+constexpr u64 MAX_BYTECODE_LEN = 64ull << 20;
+
+/// Bytes between the read position and the end of `in`.
+u64 bytes_left(std::ifstream& in) {
+    auto pos = in.tellg();
+    in.seekg(0, std::ios::end);
+    auto end = in.tellg();
+    in.seekg(pos);
+    if (pos < 0 || end < pos) return 0;
+    return static_cast<u64>(end - pos);
+}
+
+int write_chunk(lua_State*, const void* p, size_t sz, void* ud) {
+    static_cast<std::string*>(ud)->append(static_cast<const char*>(p), sz);
+    return 1; // non-zero: keep going
+}
+
+} // namespace
+
+BytecodeCache::BytecodeCache(fs::path dir) : dir_(std::move(dir)) {
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    if (ec) {
+        spdlog::warn("Lua bytecode cache: cannot create {}: {}",
+                     dir_.string(), ec.message());
+    }
+}
+
+u64 BytecodeCache::hash(const char* data, size_t len) {
+    u64 h = 14695981039346656037ull;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+fs::path BytecodeCache::entry_path(std::string_view name) const {
+    char file[32];
+    std::snprintf(file, sizeof(file), "%016llx.luac",
+                  static_cast<unsigned long long>(hash(name.data(), name.size())));
+    return dir_ / file;
+}
+
+int BytecodeCache::load(lua_State* L, const char* buf, size_t len,
+                        const char* name) {
+    if (!name || name[0] != '@') return luaL_loadbuffer(L, buf, len, name);
+
+    const u64 source_hash = hash(buf, len);
+    const fs::path path = entry_path(name);
+
+    // Cached entry: header must match this exact source
+    std::ifstream in(path, std::ios::binary);
+    if (in) {
+        EntryHeader header{};
+        std::string bytecode;
+        bool valid = false;
+        if (in.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+            std::memcmp(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC)) == 0 &&
+            header.version == ENTRY_VERSION &&
+            header.source_hash == source_hash && header.source_len == len &&
+            header.bytecode_len <= MAX_BYTECODE_LEN &&
+            header.bytecode_len <= bytes_left(in)) {
+            // Length checked against the file first: a truncated or corrupt
+            // entry must not size the buffer
+            bytecode.resize(header.bytecode_len);
+            valid = static_cast<bool>(in.read(bytecode.data(), bytecode.size()));
+        }
+        // lua_load recognises the binary signature and undumps
+        if (valid && luaL_loadbuffer(L, bytecode.data(), bytecode.size(), name) == 0) {
+            stats_.hits++;
+            return 0;
+        }
+        if (valid) lua_pop(L, 1); // undump error (e.g. other Lua build)
+        stats_.rejected++;
+    }
+
+    stats_.misses++;
+    int status = luaL_loadbuffer(L, buf, len, name);
+    if (status != 0) return status;
+
+    std::string bytecode;
+    lua_dump(L, write_chunk, &bytecode);
+    if (!bytecode.empty()) store(path, source_hash, len, bytecode);
+    return 0;
+}
+
+void BytecodeCache::store(const fs::path& path, u64 source_hash,
+                          size_t source_len, const std::string& bytecode) {
+    EntryHeader header{};
+    std::memcpy(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC));
+    header.version = ENTRY_VERSION;
+    header.source_hash = source_hash;
+    header.source_len = source_len;
+    header.bytecode_len = bytecode.size();
+
+    // Write beside the entry and rename over it, so a concurrent reader
+    // never sees a partial file
+    fs::path tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+            !out.write(bytecode.data(), bytecode.size())) {
+            spdlog::debug("Lua bytecode cache: cannot write {}", tmp.string());
+            return;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return;
+    }
+    stats_.stores++;
+}
+
+} // namespace osc::lua
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <string>
+#include <string_view>
+
+struct lua_State;
+
+namespace osc::lua {
+
+/// On-disk cache of compiled Lua chunks. Each file chunk ("@/lua/...") is
+/// compiled once, dumped with lua_dump and stored under its chunk name
+/// together with a hash of its source; later loads of the same source use
+/// the stored bytecode instead of re-parsing. A changed source no longer
+/// matches the stored hash, so the entry is recompiled and replaced.
+///
+/// Dumped chunks keep their debug info (source name, line numbers), so
+/// errors and debug.getinfo() read the same as for the parsed source.
+class BytecodeCache {
+public:
+    explicit BytecodeCache(fs::path dir);
+
+    /// Same contract as luaL_loadbuffer: pushes the compiled chunk (or an
+    /// error message) and returns the Lua status code. Only chunk names
+    /// starting with '@' are cached; others are compiled directly.
+    int load(lua_State* L, const char* buf, size_t len, const char* name);
+
+    struct Stats {
+        u32 hits = 0;     ///< loaded from a cache entry
+        u32 misses = 0;   ///< compiled from source
+        u32 stores = 0;   ///< entries written
+        u32 rejected = 0; ///< stale or unreadable entries replaced
+    };
+    const Stats& stats() const { return stats_; }
+    const fs::path& dir() const { return dir_; }
+
+    /// Cache file holding the chunk `name`.
+    fs::path entry_path(std::string_view name) const;
+
+    /// 64-bit FNV-1a, the source hash stored with each entry.
+    static u64 hash(const char* data, size_t len);
+
+private:
+    void store(const fs::path& path, u64 source_hash, size_t source_len,
+               const std::string& bytecode);
+
+    fs::path dir_;
+    Stats stats_;
+};
+
+} // namespace osc::lua
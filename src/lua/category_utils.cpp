@@ -64,6 +64,56 @@ static bool match_impl(lua_State* L, int cat_idx,
     return result;
 }
 
+static void compile_impl(lua_State* L, int cat_idx, sim::CategoryExpr& out,
+                         int depth) {
+    using Op = sim::CategoryExpr::Op;
+    if (depth > 16 || !lua_istable(L, cat_idx)) {
+        out.push_op(Op::None);
+        return;
+    }
+    if (cat_idx < 0) cat_idx = lua_gettop(L) + cat_idx + 1;
+
+    lua_pushstring(L, "__name");
+    lua_rawget(L, cat_idx);
+    if (lua_isstring(L, -1)) {
+        out.push_name(lua_tostring(L, -1));
+        lua_pop(L, 1);
+        return;
+    }
+    lua_pop(L, 1);
+
+    lua_pushstring(L, "__op");
+    lua_rawget(L, cat_idx);
+    Op op = Op::None;
+    if (lua_isstring(L, -1)) {
+        std::string name = lua_tostring(L, -1);
+        if (name == "union") op = Op::Union;
+        else if (name == "intersection") op = Op::Intersection;
+        else if (name == "difference") op = Op::Difference;
+    }
+    lua_pop(L, 1);
+    if (op == Op::None) {
+        out.push_op(Op::None);
+        return;
+    }
+
+    lua_pushstring(L, "__left");
+    lua_rawget(L, cat_idx);
+    compile_impl(L, lua_gettop(L), out, depth + 1);
+    lua_pop(L, 1);
+    lua_pushstring(L, "__right");
+    lua_rawget(L, cat_idx);
+    compile_impl(L, lua_gettop(L), out, depth + 1);
+    lua_pop(L, 1);
+    out.push_op(op);
+}
+
+sim::CategoryExpr compile_category(lua_State* L, int cat_idx) {
+    sim::CategoryExpr expr;
+    compile_impl(L, cat_idx, expr, 0);
+    return expr;
+}
+
 bool unit_matches_category(lua_State* L, int cat_idx,
                            const std::unordered_set<std::string>& unit_cats) {
     return match_impl(L, cat_idx, unit_cats, 0);
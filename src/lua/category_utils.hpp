@@ -1,5 +1,7 @@
 #pragma once
 
+#include "sim/category_index.hpp"
+
 #include <string>
 #include <unordered_set>
 
@@ -19,4 +21,9 @@ bool unit_matches_category(lua_State* L, int cat_idx,
 bool categories_match(lua_State* L, int cat_idx,
                       const std::unordered_set<std::string>& cats);
 
+/// Compile the category table at `cat_idx` for the registry's category
+/// index. The result matches exactly the units unit_matches_category()
+/// accepts, malformed nodes included (they never match).
+sim::CategoryExpr compile_category(lua_State* L, int cat_idx);
+
 } // namespace osc::lua
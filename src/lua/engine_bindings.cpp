@@ -178,7 +178,7 @@ static int l_doscript(lua_State* L) {
 
     // Load the chunk with the virtual path as chunk name
     std::string chunk_name = std::string("@") + path;
-    int status = luaL_loadbuffer(L, buf, len, chunk_name.c_str());
+    int status = LuaState::load_buffer(L, buf, len, chunk_name.c_str());
     if (status != 0) {
         return lua_error(L);
     }
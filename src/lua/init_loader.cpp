@@ -3,6 +3,7 @@
 #include "lua/engine_bindings.hpp"
 #include "lua/blueprint_bindings.hpp"
 #include "core/log.hpp"
+#include "core/tracer.hpp"
 #include "vfs/virtual_file_system.hpp"
 #include "vfs/directory_mount.hpp"
 #include "vfs/zip_mount.hpp"
@@ -21,9 +22,15 @@ namespace osc::lua {
 Result<void> InitLoader::execute_init(LuaState& state,
                                         const InitConfig& config,
                                         vfs::VirtualFileSystem& vfs) {
+    TRACE_ZONE("InitLoader::execute_init");
     // Register init-context bindings
     register_init_bindings(state);
 
+    // Compiled chunks from earlier runs (kept across session reloads)
+    if (!bytecode_cache_ && !config.bytecode_cache_dir.empty())
+        bytecode_cache_ = std::make_unique<BytecodeCache>(config.bytecode_cache_dir);
+    state.set_bytecode_cache(bytecode_cache_.get());
+
     // Set globals that init.lua expects
     auto init_dir = config.init_file.parent_path().string();
     std::replace(init_dir.begin(), init_dir.end(), '\\', '/');
@@ -138,6 +145,7 @@ Result<void> InitLoader::build_vfs_from_path_table(
 Result<void> InitLoader::load_blueprints(
     LuaState& state, const vfs::VirtualFileSystem& vfs,
     blueprints::BlueprintStore& store) {
+    TRACE_ZONE("InitLoader::load_blueprints");
     // Store VFS and BlueprintStore pointers for C bindings to access
     state.set_vfs(const_cast<vfs::VirtualFileSystem*>(&vfs));
     state.set_blueprint_store(&store);
@@ -212,6 +220,12 @@ Result<void> InitLoader::load_blueprints(
     // Expose __blueprints global to Lua (needed by shield.lua, game.lua, etc.)
     store.expose_to_lua(state.raw());
 
+    if (bytecode_cache_) {
+        const auto& st = bytecode_cache_->stats();
+        spdlog::info("Lua bytecode cache: {} hits, {} compiled, {} stale",
+                     st.hits, st.misses, st.rejected);
+    }
+
     // Log results
     store.log_statistics();
 
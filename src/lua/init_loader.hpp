@@ -2,6 +2,9 @@
 
 #include "core/result.hpp"
 #include "core/types.hpp"
+#include "lua/bytecode_cache.hpp"
+
+#include <memory>
 
 extern "C" {
 struct lua_State;
@@ -24,6 +27,7 @@ struct InitConfig {
     fs::path init_file;    ///< Path to init.lua / init_faf.lua
     fs::path fa_path;      ///< FA installation directory
     fs::path faf_data_path; ///< FAF data directory (parent of gamedata/)
+    fs::path bytecode_cache_dir; ///< Compiled Lua chunk cache (empty = off)
 };
 
 /// Orchestrates the two-phase initialization:
@@ -40,10 +44,16 @@ public:
                                   const vfs::VirtualFileSystem& vfs,
                                   blueprints::BlueprintStore& store);
 
+    /// Bytecode cache shared by every state this loader initialized
+    /// (nullptr when InitConfig::bytecode_cache_dir is empty).
+    BytecodeCache* bytecode_cache() const { return bytecode_cache_.get(); }
+
 private:
     /// Parse the path table from Lua state into VFS mounts.
     Result<void> build_vfs_from_path_table(lua_State* L,
                                             vfs::VirtualFileSystem& vfs);
+
+    std::unique_ptr<BytecodeCache> bytecode_cache_;
 };
 
 } // namespace osc::lua
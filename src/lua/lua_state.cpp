@@ -1,4 +1,5 @@
 #include "lua/lua_state.hpp"
+#include "lua/bytecode_cache.hpp"
 #include "vfs/virtual_file_system.hpp"
 #include "blueprints/blueprint_store.hpp"
 
@@ -174,7 +175,7 @@ Result<void> LuaState::do_buffer(const char* buf, size_t len,
         len -= 3;
     }
 
-    int status = luaL_loadbuffer(L_, buf, len, name);
+    int status = load_buffer(L_, buf, len, name);
     if (status != 0) {
         std::string err = lua_tostring(L_, -1);
         lua_pop(L_, 1);
@@ -215,4 +216,26 @@ blueprints::BlueprintStore* LuaState::get_blueprint_store(lua_State* L) {
     return store;
 }
 
+void LuaState::set_bytecode_cache(BytecodeCache* cache) {
+    if (cache)
+        lua_pushlightuserdata(L_, cache);
+    else
+        lua_pushnil(L_);
+    lua_setglobal(L_, REG_BYTECODE_CACHE);
+}
+
+BytecodeCache* LuaState::get_bytecode_cache(lua_State* L) {
+    lua_getglobal(L, REG_BYTECODE_CACHE);
+    auto* cache = static_cast<BytecodeCache*>(lua_touserdata(L, -1));
+    lua_pop(L, 1);
+    return cache;
+}
+
+int LuaState::load_buffer(lua_State* L, const char* buf, size_t len,
+                          const char* name) {
+    if (auto* cache = get_bytecode_cache(L))
+        return cache->load(L, buf, len, name);
+    return luaL_loadbuffer(L, buf, len, name);
+}
+
 } // namespace osc::lua
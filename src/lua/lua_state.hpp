@@ -24,6 +24,9 @@ constexpr const char* REG_VFS = "osc_vfs";
 constexpr const char* REG_BLUEPRINT_STORE = "osc_blueprint_store";
 constexpr const char* REG_SIM_STATE = "osc_sim_state";
 constexpr const char* REG_UI_STATE_FLAG = "osc_is_ui_state";
+constexpr const char* REG_BYTECODE_CACHE = "osc_bytecode_cache";
+
+class BytecodeCache;
 
 /// RAII wrapper around a Lua 5.0 state.
 class LuaState {
@@ -79,6 +82,17 @@ public:
     /// Retrieve the BlueprintStore pointer from a lua_State.
     static blueprints::BlueprintStore* get_blueprint_store(lua_State* L);
 
+    /// Store a bytecode cache pointer used by do_buffer() and doscript
+    /// (nullptr: always compile from source).
+    void set_bytecode_cache(BytecodeCache* cache);
+
+    /// Retrieve the bytecode cache pointer from a lua_State.
+    static BytecodeCache* get_bytecode_cache(lua_State* L);
+
+    /// luaL_loadbuffer through the state's bytecode cache, if one is set.
+    static int load_buffer(lua_State* L, const char* buf, size_t len,
+                           const char* name);
+
 private:
     lua_State* L_ = nullptr;
 };
@@ -10,6 +10,7 @@
 #include "sim/bone_data.hpp"
 #include "sim/entity.hpp"
 #include "sim/entity_registry.hpp"
+#include "sim/formation.hpp"
 #include "sim/ieffect.hpp"
 #include "sim/manipulator.hpp"
 #include "sim/sim_state.hpp"
@@ -37,6 +38,7 @@
 #include "map/terrain.hpp"
 #include "vfs/virtual_file_system.hpp"
 #include "core/front_end_data.hpp"
+#include "core/tracer.hpp"
 #include "core/game_state.hpp"
 #include "core/localization.hpp"
 #include "core/preferences.hpp"
@@ -46,6 +48,7 @@
 #include <chrono>
 #include <cmath>
 #include <cstring>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <vector>
@@ -754,9 +757,8 @@ static int entity_Destroy(lua_State* L) {
                     if (e->lua_table_ref() >= 0 && adj_e->lua_table_ref() >= 0) {
                         lua_rawgeti(L, LUA_REGISTRYINDEX, e->lua_table_ref());
                         int self_tbl = lua_gettop(L);
-                        lua_pushstring(L, "OnNotAdjacentTo");
-                        lua_gettable(L, self_tbl);
-                        if (lua_isfunction(L, -1)) {
+                        if (sim::LuaCallbackCache::push_hook(L, self_tbl, e,
+                                                             sim::UnitHook::OnNotAdjacentTo)) {
                             lua_pushvalue(L, self_tbl);
                             lua_rawgeti(L, LUA_REGISTRYINDEX, adj_e->lua_table_ref());
                             if (lua_pcall(L, 2, 0, 0) != 0) {
@@ -764,8 +766,6 @@ static int entity_Destroy(lua_State* L) {
                                              lua_tostring(L, -1));
                                 lua_pop(L, 1);
                             }
-                        } else {
-                            lua_pop(L, 1);
                         }
                         lua_pop(L, 1);
                     }
@@ -781,9 +781,8 @@ static int entity_Destroy(lua_State* L) {
                     if (adj_e->lua_table_ref() >= 0 && e->lua_table_ref() >= 0) {
                         lua_rawgeti(L, LUA_REGISTRYINDEX, adj_e->lua_table_ref());
                         int nb_tbl = lua_gettop(L);
-                        lua_pushstring(L, "OnNotAdjacentTo");
-                        lua_gettable(L, nb_tbl);
-                        if (lua_isfunction(L, -1)) {
+                        if (sim::LuaCallbackCache::push_hook(L, nb_tbl, adj_e,
+                                                             sim::UnitHook::OnNotAdjacentTo)) {
                             lua_pushvalue(L, nb_tbl);
                             lua_rawgeti(L, LUA_REGISTRYINDEX, e->lua_table_ref());
                             if (lua_pcall(L, 2, 0, 0) != 0) {
@@ -791,8 +790,6 @@ static int entity_Destroy(lua_State* L) {
                                              lua_tostring(L, -1));
                                 lua_pop(L, 1);
                             }
-                        } else {
-                            lua_pop(L, 1);
                         }
                         lua_pop(L, 1);
                     }
@@ -2255,25 +2252,25 @@ static int unit_GetWeapon(lua_State* L) {
 
 static int unit_SetProductionPerSecondEnergy(lua_State* L) {
     auto* u = check_unit(L);
-    if (u) u->economy().production_energy = lua_tonumber(L, 2);
+    if (u) u->edit_economy().production_energy = lua_tonumber(L, 2);
     return 0;
 }
 
 static int unit_SetProductionPerSecondMass(lua_State* L) {
     auto* u = check_unit(L);
-    if (u) u->economy().production_mass = lua_tonumber(L, 2);
+    if (u) u->edit_economy().production_mass = lua_tonumber(L, 2);
     return 0;
 }
 
 static int unit_SetConsumptionPerSecondEnergy(lua_State* L) {
     auto* u = check_unit(L);
-    if (u) u->economy().consumption_energy = lua_tonumber(L, 2);
+    if (u) u->edit_economy().consumption_energy = lua_tonumber(L, 2);
     return 0;
 }
 
 static int unit_SetConsumptionPerSecondMass(lua_State* L) {
     auto* u = check_unit(L);
-    if (u) u->economy().consumption_mass = lua_tonumber(L, 2);
+    if (u) u->edit_economy().consumption_mass = lua_tonumber(L, 2);
     return 0;
 }
 
@@ -2303,31 +2300,31 @@ static int unit_GetConsumptionPerSecondMass(lua_State* L) {
 
 static int unit_SetConsumptionActive(lua_State* L) {
     auto* u = check_unit(L);
-    if (u) u->economy().consumption_active = lua_toboolean(L, 2) != 0;
+    if (u) u->edit_economy().consumption_active = lua_toboolean(L, 2) != 0;
     return 0;
 }
 
 static int unit_SetProductionActive(lua_State* L) {
     auto* u = check_unit(L);
-    if (u) u->economy().production_active = lua_toboolean(L, 2) != 0;
+    if (u) u->edit_economy().production_active = lua_toboolean(L, 2) != 0;
     return 0;
 }
 
 static int unit_SetMaintenanceConsumptionActive(lua_State* L) {
     auto* u = check_unit(L);
-    if (u) u->economy().maintenance_active = true;
+    if (u) u->edit_economy().maintenance_active = true;
     return 0;
 }
 
 static int unit_SetMaintenanceConsumptionInactive(lua_State* L) {
     auto* u = check_unit(L);
-    if (u) u->economy().maintenance_active = false;
+    if (u) u->edit_economy().maintenance_active = false;
     return 0;
 }
 
 static int unit_SetEnergyMaintenanceConsumptionOverride(lua_State* L) {
     auto* u = check_unit(L);
-    if (u) u->economy().energy_maintenance_override = lua_tonumber(L, 2);
+    if (u) u->edit_economy().energy_maintenance_override = lua_tonumber(L, 2);
     return 0;
 }
 
@@ -2693,8 +2690,8 @@ static int unit_SetPaused(lua_State* L) {
         u->set_paused(paused);
         // When pausing, zero economy activity (FA Lua re-enables on unpause)
         if (paused) {
-            u->economy().production_active = false;
-            u->economy().consumption_active = false;
+            u->edit_economy().production_active = false;
+            u->edit_economy().consumption_active = false;
         }
     }
     return 0;
@@ -4494,9 +4491,8 @@ static int weapon_DoInstaHit(lua_State* L) {
     }
 
     // Call OnDamage on target
-    lua_pushstring(L, "OnDamage");
-    lua_gettable(L, target_idx);
-    if (lua_isfunction(L, -1)) {
+    if (sim::LuaCallbackCache::push_hook(L, target_idx, target_e,
+                                         sim::UnitHook::OnDamage)) {
         lua_pushvalue(L, target_idx); // self
         // Find instigator (owner unit)
         if (sim) {
@@ -4514,7 +4510,6 @@ static int weapon_DoInstaHit(lua_State* L) {
         lua_pushstring(L, w->damage_type.c_str());
         if (lua_pcall(L, 5, 0, 0) != 0) { lua_pop(L, 1); }
     } else {
-        lua_pop(L, 1);
         // Fallback: direct HP reduction
         target_e->set_health(target_e->health() - amount);
     }
@@ -4810,6 +4805,27 @@ static int brain_GetAllianceToArmy(lua_State* L) {
     return 1;
 }
 
+namespace {
+
+/// Category test for the area queries: membership comes from the
+/// registry's category index, one id list per army, fetched on first use.
+struct ArmyCategoryFilter {
+    sim::EntityRegistry& registry;
+    sim::CategoryExpr expr;
+    std::vector<const std::vector<u32>*> lists; // by army
+
+    bool contains(const sim::Unit& unit) {
+        i32 army = unit.army();
+        if (army < 0) return false;
+        if (static_cast<size_t>(army) >= lists.size()) lists.resize(army + 1, nullptr);
+        auto*& ids = lists[army];
+        if (!ids) ids = &registry.category_members(army, expr);
+        return std::binary_search(ids->begin(), ids->end(), unit.entity_id());
+    }
+};
+
+} // namespace
+
 static int brain_GetListOfUnits(lua_State* L) {
     auto* brain = check_brain(L);
     auto* sim = get_sim(L);
@@ -4835,19 +4851,20 @@ static int brain_GetListOfUnits(lua_State* L) {
     int built_idx = has_category ? cat_idx + 1 : -1;
     bool need_built = (built_idx > 0) && lua_toboolean(L, built_idx) != 0;
 
-    auto entities = brain->get_units(sim->entity_registry());
+    // Membership comes from the registry's category index: a repeat query
+    // for the same (army, category) reads a stored id list.
+    auto& registry = sim->entity_registry();
+    const auto& ids = registry.category_members(
+        brain->index(), has_category ? osc::lua::compile_category(L, cat_idx)
+                                     : sim::CategoryExpr::all());
 
     lua_newtable(L);
     int idx = 1;
-    for (auto* entity : entities) {
-        if (!entity || entity->destroyed()) continue;
-        if (entity->lua_table_ref() < 0) continue;
-        if (!entity->is_unit()) continue;
+    for (u32 eid : ids) {
+        auto* entity = registry.find(eid);
+        if (!entity || entity->lua_table_ref() < 0) continue;
         auto* unit = static_cast<sim::Unit*>(entity);
         if (need_built && unit->is_being_built()) continue;
-        if (has_category &&
-            !osc::lua::unit_matches_category(L, cat_idx, unit->categories()))
-            continue;
 
         lua_pushnumber(L, idx++);
         lua_rawgeti(L, LUA_REGISTRYINDEX, entity->lua_table_ref());
@@ -4912,8 +4929,16 @@ static int brain_GetUnitsAroundPoint(lua_State* L) {
     const char* team_filter = (lua_type(L, team_arg) == LUA_TSTRING)
                                   ? lua_tostring(L, team_arg) : "";
 
-    // Collect entities in radius
-    auto ids = sim->entity_registry().collect_in_radius(px, pz, radius);
+    // Collect units in radius; own-army queries filter on the index columns
+    sim::SpatialFilter filter;
+    filter.kinds = sim::spatial_kind::UNIT;
+    if (std::strcmp(team_filter, "Enemy") != 0 && std::strcmp(team_filter, "Ally") != 0)
+        filter.only_army = brain->index();
+    auto ids = sim->entity_registry().collect_in_radius(px, pz, radius, filter);
+    std::optional<ArmyCategoryFilter> cats;
+    if (has_category)
+        cats.emplace(ArmyCategoryFilter{sim->entity_registry(),
+                                        osc::lua::compile_category(L, cat_arg), {}});
 
     lua_newtable(L);
     int idx = 1;
@@ -4936,9 +4961,7 @@ static int brain_GetUnitsAroundPoint(lua_State* L) {
         }
 
         if (unit->lua_table_ref() < 0) continue;
-        if (has_category &&
-            !osc::lua::unit_matches_category(L, cat_arg, unit->categories()))
-            continue;
+        if (cats && !cats->contains(*unit)) continue;
 
         lua_pushnumber(L, idx++);
         lua_rawgeti(L, LUA_REGISTRYINDEX, unit->lua_table_ref());
@@ -5035,7 +5058,8 @@ static int brain_ForkThread(lua_State* L) {
     lua_remove(L, 2);    // remove fn from pos 2
     lua_insert(L, 1);    // move fn from top to pos 1
     // Stack is now: [1]=fn, [2]=self(brain), [3..n]=extra args
-    return sim->thread_manager().fork_thread(L);
+    // AI brain threads run within the tick budget
+    return sim->thread_manager().fork_thread(L, sim::ThreadClass::Deferrable);
 }
 
 // brain:GetPersonality() — returns a personality table with methods used by AI.
@@ -5582,7 +5606,15 @@ static int brain_GetNumUnitsAroundPoint(lua_State* L) {
     const char* team_filter = (lua_type(L, team_arg) == LUA_TSTRING)
                                   ? lua_tostring(L, team_arg) : "";
 
-    auto ids = sim->entity_registry().collect_in_radius(px, pz, radius);
+    sim::SpatialFilter filter;
+    filter.kinds = sim::spatial_kind::UNIT;
+    if (std::strcmp(team_filter, "Enemy") != 0 && std::strcmp(team_filter, "Ally") != 0)
+        filter.only_army = brain->index();
+    auto ids = sim->entity_registry().collect_in_radius(px, pz, radius, filter);
+    std::optional<ArmyCategoryFilter> cats;
+    if (has_category)
+        cats.emplace(ArmyCategoryFilter{sim->entity_registry(),
+                                        osc::lua::compile_category(L, cat_arg), {}});
 
     int count = 0;
     for (u32 eid : ids) {
@@ -5602,10 +5634,7 @@ static int brain_GetNumUnitsAroundPoint(lua_State* L) {
         }
 
         if (unit->lua_table_ref() < 0) continue;
-
-        if (has_category &&
-            !osc::lua::unit_matches_category(L, cat_arg, unit->categories()))
-            continue;
+        if (cats && !cats->contains(*unit)) continue;
 
         count++;
     }
@@ -5687,6 +5716,8 @@ static int brain_FindPlaceToBuild(lua_State* L) {
 // unit = arg 2 (Lua table with _c_object), whatToBuild = arg 3 (bp string),
 // location = arg 4 ({x, z, dist} from FindPlaceToBuild)
 static int brain_BuildStructure(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     if (!lua_istable(L, 2)) {
         spdlog::debug("brain_BuildStructure: arg2 not table");
         return 0;
@@ -5718,14 +5749,16 @@ static int brain_BuildStructure(lua_State* L) {
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::BuildMobile;
     cmd.target_pos = pos;
-    cmd.blueprint_id = bp_id;
-    unit->push_command(cmd, false);
+    cmd.set_blueprint_id(sim->command_store(), bp_id);
+    unit->push_command(sim->command_store(), cmd, false);
     return 0;
 }
 
 // brain:BuildUnit(factory, blueprintId)
 // factory = arg 2 (Lua table with _c_object), blueprintId = arg 3 (string)
 static int brain_BuildUnit(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     if (!lua_istable(L, 2)) return 0;
     lua_pushstring(L, "_c_object");
     lua_rawget(L, 2);
@@ -5740,8 +5773,8 @@ static int brain_BuildUnit(lua_State* L) {
 
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::BuildFactory;
-    cmd.blueprint_id = bp_id;
-    unit->push_command(cmd, false);
+    cmd.set_blueprint_id(sim->command_store(), bp_id);
+    unit->push_command(sim->command_store(), cmd, false);
     return 0;
 }
 
@@ -5898,6 +5931,8 @@ static int brain_CanBuildPlatoon(lua_State* L) {
 // count = multiplier for how many of each unit to build
 // Returns: nil (fire-and-forget)
 static int brain_BuildPlatoon(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     auto* brain = check_brain(L);
     if (!brain || !lua_istable(L, 2) || !lua_istable(L, 3)) return 0;
 
@@ -5952,8 +5987,8 @@ static int brain_BuildPlatoon(lua_State* L) {
         for (int n = 0; n < num; n++) {
             sim::UnitCommand cmd;
             cmd.type = sim::CommandType::BuildFactory;
-            cmd.blueprint_id = bp_id;
-            factory->push_command(cmd, false);
+            cmd.set_blueprint_id(sim->command_store(), bp_id);
+            factory->push_command(sim->command_store(), cmd, false);
         }
     }
 
@@ -6371,15 +6406,33 @@ static int platoon_MoveToLocation(lua_State* L) {
     lua_pop(L, 1);
 
     u32 cmd_id = sim->next_command_id();
+
+    // Platoons with a formation override move as one formation
+    auto shape = sim::parse_formation(platoon->formation_override());
+    if (shape != sim::FormationShape::None) {
+        std::vector<sim::Unit*> members;
+        for (u32 id : platoon->unit_ids()) {
+            auto* e = sim->entity_registry().find(id);
+            if (e && !e->destroyed() && e->is_unit())
+                members.push_back(static_cast<sim::Unit*>(e));
+        }
+        sim::issue_formation_move(sim->command_store(), members, pos, shape,
+                                  cmd_id, true, sim->pathfinder(),
+                                  sim->pathfinding_grid());
+        lua_pushnumber(L, cmd_id);
+        return 1;
+    }
+
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::Move;
     cmd.target_pos = pos;
     cmd.command_id = cmd_id;
 
+    sim::CommandGroup group(sim->command_store(), cmd);
     for (u32 id : platoon->unit_ids()) {
         auto* e = sim->entity_registry().find(id);
         if (e && !e->destroyed() && e->is_unit())
-            static_cast<sim::Unit*>(e)->push_command(cmd, true);
+            static_cast<sim::Unit*>(e)->push_command(group, true);
     }
     lua_pushnumber(L, cmd_id);
     return 1;
@@ -6410,10 +6463,11 @@ static int platoon_Patrol(lua_State* L) {
     cmd.target_pos = pos;
     cmd.command_id = cmd_id;
 
+    sim::CommandGroup group(sim->command_store(), cmd);
     for (u32 id : platoon->unit_ids()) {
         auto* e = sim->entity_registry().find(id);
         if (e && !e->destroyed() && e->is_unit())
-            static_cast<sim::Unit*>(e)->push_command(cmd, false); // append
+            static_cast<sim::Unit*>(e)->push_command(group, false); // append
     }
     lua_pushnumber(L, cmd_id);
     return 1;
@@ -6435,10 +6489,11 @@ static int platoon_AttackTarget(lua_State* L) {
     cmd.target_pos = target->position();
     cmd.command_id = cmd_id;
 
+    sim::CommandGroup group(sim->command_store(), cmd);
     for (u32 id : platoon->unit_ids()) {
         auto* e = sim->entity_registry().find(id);
         if (e && !e->destroyed() && e->is_unit())
-            static_cast<sim::Unit*>(e)->push_command(cmd, true);
+            static_cast<sim::Unit*>(e)->push_command(group, true);
     }
     lua_pushnumber(L, cmd_id);
     return 1;
@@ -6458,10 +6513,11 @@ static int platoon_GuardTarget(lua_State* L) {
     cmd.target_id = target->entity_id();
     cmd.command_id = cmd_id;
 
+    sim::CommandGroup group(sim->command_store(), cmd);
     for (u32 id : platoon->unit_ids()) {
         auto* e = sim->entity_registry().find(id);
         if (e && !e->destroyed() && e->is_unit())
-            static_cast<sim::Unit*>(e)->push_command(cmd, true);
+            static_cast<sim::Unit*>(e)->push_command(group, true);
     }
     lua_pushnumber(L, cmd_id);
     return 1;
@@ -6481,7 +6537,7 @@ static int platoon_ForkThread(lua_State* L) {
     lua_remove(L, 2);    // remove fn from pos 2
     lua_insert(L, 1);    // move fn from top to pos 1
     // Stack is now: [1]=fn, [2]=self, [3..n]=extra args
-    return sim->thread_manager().fork_thread(L);
+    return sim->thread_manager().fork_thread(L, sim::ThreadClass::Deferrable);
 }
 
 // platoon:SetAIPlan(planName)
@@ -10990,17 +11046,20 @@ static int movie_Play(lua_State* L) {
     auto* ctrl = check_control(L);
     if (ctrl) {
         ctrl->set_movie_playing(true);
-        if (ctrl->video_decoder() && ctrl->video_decoder()->is_open()) {
-            ctrl->video_decoder()->decode_next_frame();
-            ctrl->set_video_needs_upload(true);
-        }
+        // Frames are decoded ahead on a worker thread and paced by
+        // present() in the renderer
+        if (ctrl->video_decoder() && ctrl->video_decoder()->is_open())
+            ctrl->video_decoder()->start_async();
     }
     return 0;
 }
 
 static int movie_Stop(lua_State* L) {
     auto* ctrl = check_control(L);
-    if (ctrl) ctrl->set_movie_playing(false);
+    if (ctrl) {
+        ctrl->set_movie_playing(false);
+        if (ctrl->video_decoder()) ctrl->video_decoder()->stop_async();
+    }
     return 0;
 }
 
@@ -13942,6 +14001,16 @@ static int l_ConExecute(lua_State* L) {
             }
             mgr->set_speed(speed);
         }
+    } else if (s == "TraceStart") {
+        Tracer::instance().start();
+        spdlog::info("Trace capture started");
+    } else if (s == "TraceStop") {
+        Tracer::instance().stop();
+        spdlog::info("Trace capture stopped");
+    } else if (s.rfind("TraceDump", 0) == 0) {
+        // TraceDump [file]: write the capture so far (still recording)
+        std::string file = s.size() > 10 ? s.substr(10) : "trace.json";
+        Tracer::instance().write_chrome_json(fs::path(file));
     } else {
         spdlog::debug("ConExecute: '{}' (unhandled)", cmd);
     }
@@ -8,6 +8,7 @@
 #include "sim/bone_data.hpp"
 #include "sim/entity.hpp"
 #include "sim/economy_event.hpp"
+#include "sim/formation.hpp"
 #include "sim/ieffect.hpp"
 #include "sim/manipulator.hpp"
 #include "sim/sim_state.hpp"
@@ -22,6 +23,7 @@
 #include <array>
 #include <cmath>
 #include <cstring>
+#include <optional>
 #include <random>
 #include <spdlog/spdlog.h>
 
@@ -302,40 +304,40 @@ static u32 create_unit_core(lua_State* L, const char* bp_id, int army,
             if (lua_istable(L, -1)) {
                 lua_pushstring(L, "StorageMass");
                 lua_gettable(L, -2);
-                if (lua_isnumber(L, -1)) unit->economy().storage_mass = lua_tonumber(L, -1);
+                if (lua_isnumber(L, -1)) unit->edit_economy().storage_mass = lua_tonumber(L, -1);
                 lua_pop(L, 1);
 
                 lua_pushstring(L, "StorageEnergy");
                 lua_gettable(L, -2);
-                if (lua_isnumber(L, -1)) unit->economy().storage_energy = lua_tonumber(L, -1);
+                if (lua_isnumber(L, -1)) unit->edit_economy().storage_energy = lua_tonumber(L, -1);
                 lua_pop(L, 1);
 
                 lua_pushstring(L, "ProductionPerSecondMass");
                 lua_gettable(L, -2);
-                if (lua_isnumber(L, -1)) unit->economy().production_mass = lua_tonumber(L, -1);
+                if (lua_isnumber(L, -1)) unit->edit_economy().production_mass = lua_tonumber(L, -1);
                 lua_pop(L, 1);
 
                 lua_pushstring(L, "ProductionPerSecondEnergy");
                 lua_gettable(L, -2);
-                if (lua_isnumber(L, -1)) unit->economy().production_energy = lua_tonumber(L, -1);
+                if (lua_isnumber(L, -1)) unit->edit_economy().production_energy = lua_tonumber(L, -1);
                 lua_pop(L, 1);
 
                 lua_pushstring(L, "MaintenanceConsumptionPerSecondEnergy");
                 lua_gettable(L, -2);
-                if (lua_isnumber(L, -1)) unit->economy().consumption_energy = lua_tonumber(L, -1);
+                if (lua_isnumber(L, -1)) unit->edit_economy().consumption_energy = lua_tonumber(L, -1);
                 lua_pop(L, 1);
 
                 lua_pushstring(L, "ConsumptionPerSecondMass");
                 lua_gettable(L, -2);
-                if (lua_isnumber(L, -1)) unit->economy().consumption_mass = lua_tonumber(L, -1);
+                if (lua_isnumber(L, -1)) unit->edit_economy().consumption_mass = lua_tonumber(L, -1);
                 lua_pop(L, 1);
 
                 if (unit->economy().production_mass > 0.0 ||
                     unit->economy().production_energy > 0.0)
-                    unit->economy().production_active = true;
+                    unit->edit_economy().production_active = true;
                 if (unit->economy().consumption_energy > 0.0 ||
                     unit->economy().consumption_mass > 0.0)
-                    unit->economy().consumption_active = true;
+                    unit->edit_economy().consumption_active = true;
             }
             lua_pop(L, 2);
         }
@@ -780,6 +782,7 @@ static u32 create_unit_core(lua_State* L, const char* bp_id, int army,
     lua_pushvalue(L, -1);
     int ref = luaL_ref(L, LUA_REGISTRYINDEX);
     unit_ptr->set_lua_table_ref(ref);
+    unit_ptr->lua_callbacks().cache = &sim->lua_callbacks();
 
     // Air units: start at flight altitude
     if (unit_ptr->is_air_unit()) {
@@ -877,9 +880,8 @@ static int l_CreateUnit(lua_State* L) {
     // OnStopBeingBuilt (only for pre-placed units)
     auto* unit_ptr = static_cast<sim::Unit*>(sim->entity_registry().find(id));
     if (unit_ptr && !unit_ptr->is_being_built()) {
-        lua_pushstring(L, "OnStopBeingBuilt");
-        lua_gettable(L, tbl);
-        if (lua_isfunction(L, -1)) {
+        if (sim::LuaCallbackCache::push_hook(L, tbl, unit_ptr,
+                                             sim::UnitHook::OnStopBeingBuilt)) {
             lua_pushvalue(L, tbl);
             lua_pushnil(L);
             lua_pushstring(L, unit_ptr->layer().c_str());
@@ -887,8 +889,6 @@ static int l_CreateUnit(lua_State* L) {
                 spdlog::warn("Unit OnStopBeingBuilt error: {}", lua_tostring(L, -1));
                 lua_pop(L, 1);
             }
-        } else {
-            lua_pop(L, 1);
         }
 
         // Fire adjacency callbacks for pre-placed structures
@@ -1490,10 +1490,7 @@ static int l_Damage(lua_State* L) {
     }
 
     // Look up OnDamage method on the target
-    lua_pushstring(L, "OnDamage");
-    lua_gettable(L, 2); // target["OnDamage"]
-    if (!lua_isfunction(L, -1)) {
-        lua_pop(L, 1);
+    if (!sim::LuaCallbackCache::push_hook(L, 2, target_e, sim::UnitHook::OnDamage)) {
         // Fallback: directly reduce health if no OnDamage handler
         if (target_e && !target_e->destroyed()) {
             target_e->set_health(target_e->health() - amount);
@@ -1573,11 +1570,9 @@ static bool call_ondamage(lua_State* L, int target_ref,
     }
     if (amount <= 0) { lua_pop(L, 1); return true; }
 
-    lua_pushstring(L, "OnDamage");
-    lua_gettable(L, -2);
-    if (!lua_isfunction(L, -1)) {
-        lua_pop(L, 2); // pop non-function + target table
-        return true;    // no handler is not an error
+    if (!sim::LuaCallbackCache::push_hook(L, -1, e, sim::UnitHook::OnDamage)) {
+        lua_pop(L, 1); // target table
+        return true;   // no handler is not an error
     }
 
     lua_pushvalue(L, -2);            // self (target)
@@ -3546,13 +3541,38 @@ static sim::Vector3 extract_position(lua_State* L, int idx) {
 
 // IssueMove(units_table, position)
 static int l_IssueMove(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     auto target_pos = extract_position(L, 2);
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::Move;
     cmd.target_pos = target_pos;
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), false);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), false);
+    }, &group);
+    return 0;
+}
+
+// IssueFormMove(units_table, position, formation, orientation)
+// Moves the units as one formation along a shared path at the speed of the
+// slowest member. orientation (degrees, optional) fixes the final facing.
+static int l_IssueFormMove(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
+    auto target_pos = extract_position(L, 2);
+    auto shape = sim::parse_formation(luaL_optstring(L, 3, "GrowthFormation"));
+    std::optional<f32> facing;
+    if (lua_isnumber(L, 4))
+        facing = static_cast<f32>(lua_tonumber(L, 4)) * 3.14159265f / 180.0f;
+
+    std::vector<sim::Unit*> units;
+    for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
+        static_cast<std::vector<sim::Unit*>*>(c)->push_back(u);
+    }, &units);
+    sim::issue_formation_move(sim->command_store(), units, target_pos, shape,
+                              sim->next_command_id(), false, sim->pathfinder(),
+                              sim->pathfinding_grid(), facing);
     return 0;
 }
 
@@ -3607,25 +3627,29 @@ static int l_IssueToUnitStop(lua_State* L) {
 
 // IssueToUnitMove(unit, position)
 static int l_IssueToUnitMove(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     auto* u = extract_unit(L, 1);
     if (!u) return 0;
     auto target_pos = extract_position(L, 2);
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::Move;
     cmd.target_pos = target_pos;
-    u->push_command(cmd, false);
+    u->push_command(sim->command_store(), cmd, false);
     return 0;
 }
 
 // IssueToUnitMoveOffFactory(unit, position)
 static int l_IssueToUnitMoveOffFactory(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     auto* u = extract_unit(L, 1);
     if (!u) return 0;
     auto target_pos = extract_position(L, 2);
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::Move;
     cmd.target_pos = target_pos;
-    u->push_command(cmd, true);
+    u->push_command(sim->command_store(), cmd, true);
     return 0;
 }
 
@@ -3642,9 +3666,10 @@ static int l_IssueAttack(lua_State* L) {
     cmd.type = sim::CommandType::Attack;
     cmd.target_id = target->entity_id();
     cmd.target_pos = target->position();
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
     return 0;
 }
 
@@ -3660,9 +3685,10 @@ static int l_IssueGuard(lua_State* L) {
     cmd.type = sim::CommandType::Guard;
     cmd.target_id = target->entity_id();
     cmd.target_pos = target->position();
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
     return 0;
 }
 
@@ -3678,9 +3704,10 @@ static int l_IssueRepair(lua_State* L) {
     cmd.type = sim::CommandType::Repair;
     cmd.target_id = target->entity_id();
     cmd.target_pos = target->position();
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
     return 0;
 }
 
@@ -3696,18 +3723,22 @@ static int l_IssueCapture(lua_State* L) {
     cmd.type = sim::CommandType::Capture;
     cmd.target_id = target->entity_id();
     cmd.target_pos = target->position();
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
     return 0;
 }
 
 static int l_IssueDive(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::Dive;
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
     return 0;
 }
 
@@ -3774,80 +3805,95 @@ static int l_ChangeUnitArmy(lua_State* L) {
 
 // IssueUpgrade(units_table, blueprintId)
 static int l_IssueUpgrade(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     const char* bp_id = luaL_checkstring(L, 2);
 
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::Upgrade;
-    cmd.blueprint_id = bp_id;
+    cmd.set_blueprint_id(sim->command_store(), bp_id);
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
     return 0;
 }
 
 // IssueEnhancement(units_table, enhancementName)
 static int l_IssueEnhancement(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     const char* enh_name = luaL_checkstring(L, 2);
 
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::Enhance;
-    cmd.blueprint_id = enh_name;
+    cmd.set_blueprint_id(sim->command_store(), enh_name);
 
-    struct Ctx { sim::UnitCommand cmd; lua_State* L; };
-    Ctx ctx{cmd, L};
+    sim::CommandGroup group(sim->command_store(), cmd);
+    struct Ctx { const sim::CommandGroup* group; lua_State* L; };
+    Ctx ctx{&group, L};
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
         auto* ec = static_cast<Ctx*>(c);
         // Cancel any in-progress enhancement before clearing queue
         if (u->is_enhancing()) {
             u->cancel_enhance(ec->L);
         }
-        u->push_command(ec->cmd, true);
+        u->push_command(*ec->group, true);
     }, &ctx);
     return 0;
 }
 
 // IssueBuildMobile(units_table, position, blueprintId, {})
 static int l_IssueBuildMobile(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     auto target_pos = extract_position(L, 2);
     const char* bp_id = luaL_checkstring(L, 3);
 
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::BuildMobile;
     cmd.target_pos = target_pos;
-    cmd.blueprint_id = bp_id;
+    cmd.set_blueprint_id(sim->command_store(), bp_id);
 
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), false);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), false);
+    }, &group);
     return 0;
 }
 
 // IssueBuildFactory(units_table, blueprintId, count)
 static int l_IssueBuildFactory(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     const char* bp_id = luaL_checkstring(L, 2);
     int count = lua_isnumber(L, 3) ? static_cast<int>(lua_tonumber(L, 3)) : 1;
 
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::BuildFactory;
-    cmd.blueprint_id = bp_id;
+    cmd.set_blueprint_id(sim->command_store(), bp_id);
 
+    sim::CommandGroup group(sim->command_store(), cmd);
     for (int i = 0; i < count; i++) {
         for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-            u->push_command(*static_cast<sim::UnitCommand*>(c), false);
-        }, &cmd);
+            u->push_command(*static_cast<sim::CommandGroup*>(c), false);
+        }, &group);
     }
     return 0;
 }
 
 // IssueMoveOffFactory(units_table, position) — clears commands, issues Move
 static int l_IssueMoveOffFactory(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     auto target_pos = extract_position(L, 2);
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::Move;
     cmd.target_pos = target_pos;
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
     return 0;
 }
 
@@ -3883,9 +3929,10 @@ static int l_IssueReclaim(lua_State* L) {
     cmd.type = sim::CommandType::Reclaim;
     cmd.target_id = target->entity_id();
     cmd.target_pos = target->position();
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
     return 0;
 }
 
@@ -4090,6 +4137,7 @@ static int l_CreateShield(lua_State* L) {
 
     // Store shield entity ID on owner unit for O(1) lookup
     owner->set_shield_entity_id(id);
+    sim->shield_index().track(id);
 
     spdlog::info("_c_CreateShield: entity #{} for owner #{} (army {}), size={:.1f}, maxHP={:.0f}",
                  id, owner->entity_id(), owner->army(), size, max_hp);
@@ -4237,13 +4285,16 @@ static int l_GetReclaimablesInRect(lua_State* L) {
 
 // IssuePatrol(units_table, position) — append patrol waypoint (no clear)
 static int l_IssuePatrol(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     auto target_pos = extract_position(L, 2);
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::Patrol;
     cmd.target_pos = target_pos;
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), false);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), false);
+    }, &group);
     return 0;
 }
 
@@ -4251,6 +4302,8 @@ static int l_IssuePatrol(lua_State* L) {
 // IssueTransportLoad(units_table, transport_unit_table)
 // Ground units → load into transport
 static int l_IssueTransportLoad(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     // arg 1 = table of ground units to load
     // arg 2 = transport unit (single unit table)
     auto* target = extract_entity(L, 2);
@@ -4261,9 +4314,10 @@ static int l_IssueTransportLoad(lua_State* L) {
     cmd.target_id = target->entity_id();
     cmd.target_pos = target->position();
 
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
 
     return 0;
 }
@@ -4271,33 +4325,41 @@ static int l_IssueTransportLoad(lua_State* L) {
 // IssueTransportUnload(transports_table, position)
 // Transports → unload all cargo at position
 static int l_IssueTransportUnload(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     auto target_pos = extract_position(L, 2);
 
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::TransportUnload;
     cmd.target_pos = target_pos;
 
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
 
     return 0;
 }
 
 // IssueNuke(units_table, position) — fire nuke from silo
 static int l_IssueNuke(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     auto target_pos = extract_position(L, 2);
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::Nuke;
     cmd.target_pos = target_pos;
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
     return 0;
 }
 
 // IssueTactical(units_table, target) — fire tactical missile (entity or position)
 static int l_IssueTactical(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::Tactical;
 
@@ -4309,14 +4371,17 @@ static int l_IssueTactical(lua_State* L) {
     } else {
         cmd.target_pos = extract_position(L, 2);
     }
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
     return 0;
 }
 
 // IssueOvercharge(units_table, target_entity) — overcharge attack
 static int l_IssueOvercharge(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     auto* target = extract_entity(L, 2);
     if (!target || target->destroyed()) return 0;
 
@@ -4324,14 +4389,17 @@ static int l_IssueOvercharge(lua_State* L) {
     cmd.type = sim::CommandType::Overcharge;
     cmd.target_id = target->entity_id();
     cmd.target_pos = target->position();
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
     return 0;
 }
 
 // IssueSacrifice(units_table, target_entity) — sacrifice unit to build target
 static int l_IssueSacrifice(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     auto* target = extract_entity(L, 2);
     if (!target || target->destroyed() || !target->is_unit()) return 0;
 
@@ -4339,21 +4407,25 @@ static int l_IssueSacrifice(lua_State* L) {
     cmd.type = sim::CommandType::Sacrifice;
     cmd.target_id = target->entity_id();
     cmd.target_pos = target->position();
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
     return 0;
 }
 
 // IssueTeleport(units_table, location) — teleport to position
 static int l_IssueTeleport(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     auto target_pos = extract_position(L, 2);
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::Teleport;
     cmd.target_pos = target_pos;
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
-        u->push_command(*static_cast<sim::UnitCommand*>(c), true);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), true);
+    }, &group);
     return 0;
 }
 
@@ -4388,14 +4460,17 @@ static int l_IssueKillSelf(lua_State* L) {
 
 // IssueFerry(units_table, waypoint) — ferry route waypoint for transports
 static int l_IssueFerry(lua_State* L) {
+    auto* sim = get_sim(L);
+    if (!sim) return 0;
     auto target_pos = extract_position(L, 2);
     sim::UnitCommand cmd;
     cmd.type = sim::CommandType::Ferry;
     cmd.target_pos = target_pos;
+    sim::CommandGroup group(sim->command_store(), cmd);
     for_each_unit_in_table(L, 1, [](sim::Unit* u, void* c) {
         // Ferry appends like Patrol, doesn't clear
-        u->push_command(*static_cast<sim::UnitCommand*>(c), false);
-    }, &cmd);
+        u->push_command(*static_cast<sim::CommandGroup*>(c), false);
+    }, &group);
     return 0;
 }
 
@@ -4624,6 +4699,7 @@ void register_sim_bindings(LuaState& state, sim::SimState& sim) {
 
     // Orders (all stubs)
     state.register_function("IssueMove", l_IssueMove);
+    state.register_function("IssueFormMove", l_IssueFormMove);
     state.register_function("IssueAggressiveMove", l_IssueAggressiveMove);
     state.register_function("IssuePatrol", l_IssuePatrol);
     state.register_function("IssueAttack", l_IssueAttack);
@@ -8,6 +8,7 @@
 #include "core/game_state.hpp"
 #include "core/log.hpp"
 #include "core/profiler.hpp"
+#include "core/tracer.hpp"
 #include "core/types.hpp"
 #include "integration_tests.hpp"
 #include "lua/lua_state.hpp"
@@ -44,6 +45,7 @@ extern "C" {
 #include <GLFW/glfw3.h>
 
 #include <chrono>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
@@ -252,6 +254,8 @@ static void print_usage() {
               << "  --init <path>      Path to init.lua / init_faf.lua\n"
               << "  --fa-path <path>   Path to FA installation directory\n"
               << "  --faf-data <path>  Path to FAF data directory\n"
+              << "  --lua-cache <dir>  Compiled Lua chunk cache (default: cache/lua)\n"
+              << "  --no-lua-cache     Always compile Lua scripts from source\n"
               << "  --map <vfs-path>   VFS path to *_scenario.lua\n"
               << "  --ticks <n>        Number of sim ticks to run (default: 100)\n"
               << "  --damage-test      After ticks, kill entity #1 and run 10 more ticks\n"
@@ -340,12 +344,14 @@ static void print_usage() {
               << "  --phase3-test      Phase 3 integration (state machine, beat system, score flow)\n"
               << "  --profile          Enable performance profiling (prints summary at exit)\n"
               << "  --profile-test     Profiler system (zones, nesting, rolling stats)\n"
+              << "  --trace-file <f>   Record a Chrome/Perfetto timeline of all threads to <f>\n"
               << "  --instrument       Interactive instrumented mode (smoke report on exit)\n"
               << "  --help             Show this help message\n";
 }
 
 static osc::lua::InitConfig parse_args(int argc, char* argv[]) {
     osc::lua::InitConfig config;
+    bool no_lua_cache = false;
 
     for (int i = 1; i < argc; i++) {
         if (std::strcmp(argv[i], "--init") == 0 && i + 1 < argc) {
@@ -354,6 +360,10 @@ static osc::lua::InitConfig parse_args(int argc, char* argv[]) {
             config.fa_path = argv[++i];
         } else if (std::strcmp(argv[i], "--faf-data") == 0 && i + 1 < argc) {
             config.faf_data_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--lua-cache") == 0 && i + 1 < argc) {
+            config.bytecode_cache_dir = argv[++i];
+        } else if (std::strcmp(argv[i], "--no-lua-cache") == 0) {
+            no_lua_cache = true;
         } else if (std::strcmp(argv[i], "--help") == 0) {
             print_usage();
             std::exit(0);
@@ -367,6 +377,11 @@ static osc::lua::InitConfig parse_args(int argc, char* argv[]) {
     if (config.faf_data_path.empty()) {
         config.faf_data_path = "C:/ProgramData/FAForever";
     }
+    if (no_lua_cache) {
+        config.bytecode_cache_dir.clear();
+    } else if (config.bytecode_cache_dir.empty()) {
+        config.bytecode_cache_dir = "cache/lua";
+    }
 
     // Try to read fa_path from FAForever's fa_path.lua if not specified
     if (config.fa_path.empty()) {
@@ -843,6 +858,7 @@ int main(int argc, char* argv[]) {
     bool no_decals = parse_flag(argc, argv, "--no-decals");
     bool profile_enabled = parse_flag(argc, argv, "--profile");
     bool profile_test = parse_flag(argc, argv, "--profile-test");
+    auto trace_file = parse_string_arg(argc, argv, "--trace-file");
     bool construction_test = parse_flag(argc, argv, "--construction-test");
     bool phase2_test = parse_flag(argc, argv, "--phase2-test");
     bool phase3_test = parse_flag(argc, argv, "--phase3-test");
@@ -926,6 +942,25 @@ int main(int argc, char* argv[]) {
         spdlog::info("Builder debug mode enabled — verbose logging active");
     }
 
+    // Timeline capture of the whole run (--trace-file), written once on
+    // any return from main(); ConExecute("TraceDump <file>") also works
+    // at runtime without the flag.
+    struct TraceFileWriter {
+        std::string path;
+        void write() {
+            if (path.empty()) return;
+            osc::Tracer::instance().stop();
+            osc::Tracer::instance().write_chrome_json(osc::fs::path(path));
+            path.clear();
+        }
+        ~TraceFileWriter() { write(); }
+    } trace_writer{trace_file};
+    osc::Tracer::instance().set_thread_name("main");
+    if (!trace_file.empty()) {
+        osc::Tracer::instance().start();
+        spdlog::info("Tracing to {}", trace_file);
+    }
+
     // Phase 1: Init + VFS (sim Lua state)
     auto sim_lua_state = std::make_unique<osc::lua::LuaState>();
     osc::vfs::VirtualFileSystem vfs;
@@ -1049,6 +1084,7 @@ int main(int argc, char* argv[]) {
     // === UI Lua State ===
     osc::lua::LuaState ui_lua_state;
     ui_lua_state.set_vfs(&vfs);
+    ui_lua_state.set_bytecode_cache(loader.bytecode_cache());
     ui_lua_state.set_blueprint_store(&store);
 
     // Run init sequence on UI state (polyfills, config, class system, import)
@@ -1837,6 +1873,25 @@ int main(int argc, char* argv[]) {
 
                 renderer.poll_events(dt);
 
+                // Audio: listener follows the camera target and hears as
+                // far as the view reaches; attenuate and pan live voices
+                // once per frame
+                if (sim_state && sim_state->sound_manager()) {
+                    const auto& cam = renderer.camera();
+                    auto* snd = sim_state->sound_manager();
+                    osc::f32 aspect = renderer.height() > 0
+                        ? static_cast<osc::f32>(renderer.width()) / static_cast<osc::f32>(renderer.height())
+                        : 1.0f;
+                    // Half-diagonal of the view at the target's distance
+                    osc::f32 view_radius = cam.distance() *
+                        std::tan(osc::renderer::Camera::FOV_Y * 0.5f) *
+                        std::sqrt(1.0f + aspect * aspect);
+                    snd->set_listener_position(
+                        {cam.target_x(), 0.0f, cam.target_z()}, cam.yaw(),
+                        view_radius);
+                    snd->update(dt);
+                }
+
                 // Resume UI coroutines
                 ++ui_frame_count;
                 ui_thread_manager.resume_all(ui_frame_count);
@@ -3094,6 +3149,7 @@ int main(int argc, char* argv[]) {
     if (profile_enabled) {
         osc::Profiler::instance().log_summary();
     }
+    trace_writer.write();
 
     osc::log::shutdown();
     return 0;
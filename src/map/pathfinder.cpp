@@ -40,36 +40,12 @@ PathResult Pathfinder::find_path(f32 start_x, f32 start_z,
 
     // If goal cell is impassable, find nearest passable cell
     if (!grid_.is_passable_for(gx, gz, layer, draft, amphibious)) {
-        // Spiral search outward from goal for nearest passable cell
-        bool found_alt = false;
-        for (u32 radius = 1; radius <= 20 && !found_alt; ++radius) {
-            i32 igx = static_cast<i32>(gx);
-            i32 igz = static_cast<i32>(gz);
-            for (i32 dz = -static_cast<i32>(radius); dz <= static_cast<i32>(radius) && !found_alt; ++dz) {
-                for (i32 dx = -static_cast<i32>(radius); dx <= static_cast<i32>(radius); ++dx) {
-                    if (std::abs(dx) != static_cast<i32>(radius) &&
-                        std::abs(dz) != static_cast<i32>(radius))
-                        continue; // only check perimeter
-                    i32 nx = igx + dx;
-                    i32 nz = igz + dz;
-                    if (nx < 0 || nz < 0) continue;
-                    u32 ux = static_cast<u32>(nx);
-                    u32 uz = static_cast<u32>(nz);
-                    if (grid_.is_passable_for(ux, uz, layer, draft, amphibious)) {
-                        gx = ux;
-                        gz = uz;
-                        // Update goal world position to cell center
-                        grid_.grid_to_world(gx, gz, goal_x, goal_z);
-                        found_alt = true;
-                        break;
-                    }
-                }
-            }
-        }
-        if (!found_alt) {
+        if (!nearest_passable(gx, gz, layer, draft, amphibious)) {
             spdlog::debug("Pathfinder: no passable cell near goal ({}, {})", goal_x, goal_z);
             return result; // found = false
         }
+        // Update goal world position to cell center
+        grid_.grid_to_world(gx, gz, goal_x, goal_z);
     }
 
     // Run A*
@@ -80,24 +56,78 @@ PathResult Pathfinder::find_path(f32 start_x, f32 start_z,
         return result; // found = false
     }
 
+    result.found = true;
+    result.waypoints = to_waypoints(grid_path, goal_x, goal_z, layer, draft,
+                                    amphibious);
+    return result;
+}
+
+bool Pathfinder::nearest_passable(u32& gx, u32& gz, const std::string& layer,
+                                  f32 draft, bool amphibious) const {
+    // Spiral search outward from goal for nearest passable cell
+    i32 igx = static_cast<i32>(gx);
+    i32 igz = static_cast<i32>(gz);
+    for (i32 radius = 1; radius <= 20; ++radius) {
+        for (i32 dz = -radius; dz <= radius; ++dz) {
+            for (i32 dx = -radius; dx <= radius; ++dx) {
+                if (std::abs(dx) != radius && std::abs(dz) != radius)
+                    continue; // only check perimeter
+                i32 nx = igx + dx;
+                i32 nz = igz + dz;
+                if (nx < 0 || nz < 0) continue;
+                u32 ux = static_cast<u32>(nx);
+                u32 uz = static_cast<u32>(nz);
+                if (grid_.is_passable_for(ux, uz, layer, draft, amphibious)) {
+                    gx = ux;
+                    gz = uz;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool Pathfinder::snap_to_passable(f32& x, f32& z, const std::string& layer,
+                                  f32 draft, bool amphibious) const {
+    u32 gx, gz;
+    grid_.world_to_grid(x, z, gx, gz);
+    if (grid_.is_passable_for(gx, gz, layer, draft, amphibious)) return true;
+    if (!nearest_passable(gx, gz, layer, draft, amphibious)) return false;
+    grid_.grid_to_world(gx, gz, x, z);
+    return true;
+}
+
+bool Pathfinder::segment_passable(f32 x0, f32 z0, f32 x1, f32 z1,
+                                  const std::string& layer,
+                                  f32 draft, bool amphibious) const {
+    u32 ax, az, bx, bz;
+    grid_.world_to_grid(x0, z0, ax, az);
+    grid_.world_to_grid(x1, z1, bx, bz);
+    return has_line_of_sight(ax, az, bx, bz, layer, draft, amphibious);
+}
+
+std::vector<sim::Vector3> Pathfinder::to_waypoints(
+    const std::vector<std::pair<u32, u32>>& cells, f32 goal_x, f32 goal_z,
+    const std::string& layer, f32 draft, bool amphibious) const {
     // Smooth path
-    auto smoothed = smooth_path(grid_path, layer, draft, amphibious);
+    auto smoothed = smooth_path(cells, layer, draft, amphibious);
 
     // Convert to world coordinates
-    result.found = true;
+    std::vector<sim::Vector3> waypoints;
+    waypoints.reserve(smoothed.size());
     for (size_t i = 0; i < smoothed.size(); ++i) {
         f32 wx, wz;
         grid_.grid_to_world(smoothed[i].first, smoothed[i].second, wx, wz);
-        result.waypoints.push_back({wx, 0, wz});
+        waypoints.push_back({wx, 0, wz});
     }
 
     // Replace last waypoint with exact goal position
-    if (!result.waypoints.empty()) {
-        result.waypoints.back().x = goal_x;
-        result.waypoints.back().z = goal_z;
+    if (!waypoints.empty()) {
+        waypoints.back().x = goal_x;
+        waypoints.back().z = goal_z;
     }
-
-    return result;
+    return waypoints;
 }
 
 std::vector<std::pair<u32, u32>> Pathfinder::astar(
@@ -155,6 +185,7 @@ std::vector<std::pair<u32, u32>> Pathfinder::astar(
         if (closed[cur_idx]) continue;
         closed[cur_idx] = true;
 
+        nodes_expanded_++;
         if (++nodes_explored > MAX_NODES_EXPLORED) {
             spdlog::debug("Pathfinder: A* hit search limit ({} nodes)", MAX_NODES_EXPLORED);
             return {}; // give up
@@ -217,6 +248,217 @@ std::vector<std::pair<u32, u32>> Pathfinder::astar(
     return path;
 }
 
+PathResult Pathfinder::pursue(PursuitState& state, f32 start_x, f32 start_z,
+                              f32 goal_x, f32 goal_z, const std::string& layer,
+                              f32 draft, bool amphibious) const {
+    PathResult result;
+    if (state.layer != layer || state.draft != draft ||
+        state.amphibious != amphibious ||
+        state.grid_revision != grid_.revision()) {
+        state.reset();
+        state.layer = layer;
+        state.draft = draft;
+        state.amphibious = amphibious;
+        state.grid_revision = grid_.revision();
+    }
+
+    const u32 w = grid_.grid_width();
+    u32 sx, sz, gx, gz;
+    grid_.world_to_grid(start_x, start_z, sx, sz);
+    grid_.world_to_grid(goal_x, goal_z, gx, gz);
+    if (!grid_.is_passable_for(gx, gz, layer, draft, amphibious)) {
+        if (!nearest_passable(gx, gz, layer, draft, amphibious)) {
+            state.path.clear();
+            return result; // found = false
+        }
+        grid_.grid_to_world(gx, gz, goal_x, goal_z);
+    }
+    const u32 start = sz * w + sx;
+    const u32 goal = gz * w + gx;
+
+    auto chebyshev = [w](u32 a, u32 b) {
+        u32 dx = a % w > b % w ? a % w - b % w : b % w - a % w;
+        u32 dz = a / w > b / w ? a / w - b / w : b / w - a / w;
+        return std::max(dx, dz);
+    };
+    auto path_from = [&](size_t first) {
+        std::vector<std::pair<u32, u32>> cells;
+        cells.reserve(state.path.size() - first + 1);
+        if (state.path[first] != start) cells.push_back({sx, sz});
+        for (size_t i = first; i < state.path.size(); ++i)
+            cells.push_back({state.path[i] % w, state.path[i] / w});
+        return to_waypoints(cells, goal_x, goal_z, layer, draft, amphibious);
+    };
+
+    if (!state.path.empty()) {
+        // How far along the current path the pursuer has got
+        size_t at = 0;
+        u32 off_path = UINT32_MAX;
+        for (size_t i = 0; i < state.path.size(); ++i) {
+            u32 d = chebyshev(state.path[i], start);
+            if (d <= off_path) { off_path = d; at = i; }
+        }
+        if (off_path <= PURSUIT_CORRIDOR &&
+            has_line_of_sight(sx, sz, state.path[at] % w, state.path[at] / w,
+                              layer, draft, amphibious)) {
+            // Goal still in the same neighbourhood: keep the path
+            if (chebyshev(goal, state.goal) <= 1) {
+                result.found = true;
+                result.retargeted = true;
+                result.waypoints.push_back({goal_x, 0, goal_z});
+                return result;
+            }
+            // Goal still beside the path ahead: splice it on
+            size_t k = at;
+            u32 k_dist = UINT32_MAX;
+            for (size_t i = at; i < state.path.size(); ++i) {
+                u32 d = chebyshev(state.path[i], goal);
+                if (d <= k_dist) { k_dist = d; k = i; }
+            }
+            if (k_dist <= PURSUIT_CORRIDOR &&
+                has_line_of_sight(state.path[k] % w, state.path[k] / w, gx, gz,
+                                  layer, draft, amphibious)) {
+                state.path.resize(k + 1);
+                if (state.path.back() != goal) state.path.push_back(goal);
+                state.goal = goal;
+                result.found = true;
+                result.waypoints = path_from(at);
+                return result;
+            }
+        }
+    }
+
+    // The goal left the corridor: search, resuming the retained tree
+    if (!can_pathfind()) {
+        result.throttled = true;
+        return result;
+    }
+    increment_request_count();
+
+    auto closed = [&](u32 cell) {
+        auto it = state.nodes.find(cell);
+        return it != state.nodes.end() && it->second.closed;
+    };
+    bool reuse = state.root != PursuitState::NO_CELL &&
+                 state.nodes.size() < MAX_PURSUIT_NODES && closed(start);
+    for (;;) {
+        if (!reuse) {
+            state.reset();
+            state.root = start;
+            state.nodes[start].g = 0;
+            state.open.push_back({0.0f, start});
+        }
+        if (resume_search(state, goal)) {
+            // Tree path to the goal, cut where the pursuer stands
+            std::vector<u32> cells;
+            for (u32 c = goal; c != PursuitState::NO_CELL;
+                 c = state.nodes[c].parent) {
+                cells.push_back(c);
+                if (c == start) break;
+            }
+            if (cells.back() == start) {
+                std::reverse(cells.begin(), cells.end());
+                state.path = std::move(cells);
+                state.goal = goal;
+                result.found = true;
+                result.waypoints = path_from(0);
+                return result;
+            }
+        }
+        if (!reuse) break;
+        reuse = false; // pursuer is off this tree's path: re-root at it
+    }
+    spdlog::debug("Pathfinder: pursuit found no path from ({},{}) to ({},{})",
+                  sx, sz, gx, gz);
+    state.path.clear();
+    return result; // found = false
+}
+
+bool Pathfinder::resume_search(PursuitState& state, u32 goal) const {
+    const u32 w = grid_.grid_width();
+    const u32 h = grid_.grid_height();
+    const f32 cs = static_cast<f32>(grid_.cell_size());
+    const u32 gx = goal % w, gz = goal / w;
+    const auto& layer = state.layer;
+
+    auto goal_node = state.nodes.find(goal);
+    if (goal_node != state.nodes.end() && goal_node->second.closed) return true;
+
+    auto heuristic = [&](u32 x, u32 z) -> f32 {
+        f32 dx = static_cast<f32>(x > gx ? x - gx : gx - x);
+        f32 dz = static_cast<f32>(z > gz ? z - gz : gz - z);
+        f32 mn = std::min(dx, dz);
+        f32 mx = std::max(dx, dz);
+        return (mx + (SQRT2 - 1.0f) * mn) * cs;
+    };
+
+    // Re-key the open list for the new goal. (f, cell) pairs order ties
+    // by cell, so the search is deterministic.
+    auto& open = state.open;
+    open.clear();
+    for (const auto& [cell, node] : state.nodes) {
+        if (!node.closed)
+            open.push_back({node.g + heuristic(cell % w, cell / w), cell});
+    }
+    std::make_heap(open.begin(), open.end(), std::greater<>());
+
+    static constexpr i32 dirs[8][2] = {
+        {1, 0}, {-1, 0}, {0, 1}, {0, -1},
+        {1, 1}, {1, -1}, {-1, 1}, {-1, -1}
+    };
+
+    u32 nodes_explored = 0;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), std::greater<>());
+        u32 cur_idx = open.back().second;
+        open.pop_back();
+
+        auto& cur = state.nodes[cur_idx];
+        if (cur.closed) continue;
+        cur.closed = true;
+        const f32 cur_g = cur.g; // node references do not survive inserts
+        nodes_expanded_++;
+        if (cur_idx == goal) return true;
+        if (++nodes_explored > MAX_NODES_EXPLORED) {
+            spdlog::debug("Pathfinder: pursuit hit search limit ({} nodes)",
+                          MAX_NODES_EXPLORED);
+            return false;
+        }
+
+        u32 cx = cur_idx % w;
+        u32 cz = cur_idx / w;
+        for (auto& dir : dirs) {
+            i32 nx = static_cast<i32>(cx) + dir[0];
+            i32 nz = static_cast<i32>(cz) + dir[1];
+            if (nx < 0 || nz < 0 || static_cast<u32>(nx) >= w || static_cast<u32>(nz) >= h)
+                continue;
+            u32 unx = static_cast<u32>(nx);
+            u32 unz = static_cast<u32>(nz);
+            if (!grid_.is_passable_for(unx, unz, layer, state.draft, state.amphibious))
+                continue;
+
+            bool diagonal = (dir[0] != 0 && dir[1] != 0);
+            // No corner cutting through walls
+            if (diagonal &&
+                (!grid_.is_passable_for(unx, cz, layer, state.draft, state.amphibious) ||
+                 !grid_.is_passable_for(cx, unz, layer, state.draft, state.amphibious)))
+                continue;
+
+            u32 n_idx = unz * w + unx;
+            auto& next = state.nodes[n_idx];
+            if (next.closed) continue;
+            f32 new_g = cur_g + (diagonal ? SQRT2 * cs : cs);
+            if (new_g < next.g) {
+                next.g = new_g;
+                next.parent = cur_idx;
+                open.push_back({new_g + heuristic(unx, unz), n_idx});
+                std::push_heap(open.begin(), open.end(), std::greater<>());
+            }
+        }
+    }
+    return false;
+}
+
 std::vector<std::pair<u32, u32>> Pathfinder::smooth_path(
     const std::vector<std::pair<u32, u32>>& path,
     const std::string& layer, f32 draft, bool amphibious) const {
@@ -3,7 +3,9 @@
 #include "core/types.hpp"
 #include "sim/entity.hpp" // Vector3
 
+#include <cfloat>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -14,9 +16,42 @@ class PathfindingGrid;
 struct PathResult {
     bool found = false;
     bool throttled = false;  // true if request was deferred (budget exhausted)
+    bool retargeted = false; // pursuit: keep the path; waypoints holds its new end
     std::vector<sim::Vector3> waypoints; // world-space positions
 };
 
+/// Search state one pursuer keeps between Pathfinder::pursue calls: an A*
+/// tree grown from the cell where the chase began, its open list, and the
+/// current path. g-values of closed cells are exact start distances
+/// whatever the goal, so a moved goal only needs the open list re-keyed
+/// (LPA* on a grid whose costs have not changed).
+struct PursuitState {
+    static constexpr u32 NO_CELL = UINT32_MAX;
+
+    struct Node {
+        f32 g = FLT_MAX;
+        u32 parent = NO_CELL;
+        bool closed = false;
+    };
+
+    u32 root = NO_CELL;  ///< cell the tree grows from
+    u32 goal = NO_CELL;  ///< goal cell of the current path
+    u32 grid_revision = 0;
+    std::string layer;
+    f32 draft = 0;
+    bool amphibious = false;
+    std::unordered_map<u32, Node> nodes;
+    std::vector<std::pair<f32, u32>> open; ///< (f, cell) min-heap
+    std::vector<u32> path;                 ///< cells, root side first
+
+    void reset() {
+        root = goal = NO_CELL;
+        nodes.clear();
+        open.clear();
+        path.clear();
+    }
+};
+
 class Pathfinder {
 public:
     explicit Pathfinder(const PathfindingGrid& grid);
@@ -28,12 +63,50 @@ public:
                          const std::string& layer,
                          f32 draft = 0, bool amphibious = false) const;
 
+    /// Path toward a moving goal, reusing `state` from earlier calls.
+    /// A goal still within one cell of the last one keeps the path
+    /// (result.retargeted). A goal near the rest of the path is spliced
+    /// onto it. Only a goal that leaves that corridor costs a search,
+    /// resumed from the retained tree. Searches count against the
+    /// per-tick request budget; repairs do not.
+    PathResult pursue(PursuitState& state, f32 start_x, f32 start_z,
+                      f32 goal_x, f32 goal_z, const std::string& layer,
+                      f32 draft = 0, bool amphibious = false) const;
+
+    /// Move a world position off an impassable cell onto the centre of the
+    /// nearest passable one (within 20 cells). False if there is none.
+    bool snap_to_passable(f32& x, f32& z, const std::string& layer,
+                          f32 draft = 0, bool amphibious = false) const;
+
+    /// True if every cell on the straight grid line between two world
+    /// positions is passable for the layer.
+    bool segment_passable(f32 x0, f32 z0, f32 x1, f32 z1,
+                          const std::string& layer,
+                          f32 draft = 0, bool amphibious = false) const;
+
+    /// Total A* node expansions since construction (profiling and tests).
+    u64 nodes_expanded() const { return nodes_expanded_; }
+
     bool can_pathfind() const { return requests_this_tick_ < MAX_REQUESTS_PER_TICK; }
     void increment_request_count() const { ++requests_this_tick_; }
     void reset_request_count() const { requests_this_tick_ = 0; }
+    int requests_this_tick() const { return requests_this_tick_; }
     static constexpr int MAX_REQUESTS_PER_TICK = 8;
 
 private:
+    /// Move (gx, gz) to the nearest passable cell within 20 cells.
+    bool nearest_passable(u32& gx, u32& gz, const std::string& layer,
+                          f32 draft, bool amphibious) const;
+
+    /// Grow the pursuit tree until `goal` is closed. False if unreachable
+    /// or over the node limit.
+    bool resume_search(PursuitState& state, u32 goal) const;
+
+    /// Smoothed world waypoints for grid cells, ending exactly at the goal.
+    std::vector<sim::Vector3> to_waypoints(
+        const std::vector<std::pair<u32, u32>>& cells, f32 goal_x, f32 goal_z,
+        const std::string& layer, f32 draft, bool amphibious) const;
+
     /// Raw A* on the grid. Returns grid cell path (start→goal).
     std::vector<std::pair<u32, u32>> astar(
         u32 sx, u32 sz, u32 gx, u32 gz,
@@ -52,7 +125,10 @@ private:
     const PathfindingGrid& grid_;
 
     static constexpr u32 MAX_NODES_EXPLORED = 50000;
+    static constexpr u32 PURSUIT_CORRIDOR = 4;      // cells either side of the path
+    static constexpr size_t MAX_PURSUIT_NODES = 16384; // re-root beyond this
     mutable int requests_this_tick_ = 0;
+    mutable u64 nodes_expanded_ = 0;
 
     // Reusable buffers for A* to avoid per-call heap allocations.
     mutable std::vector<f32> g_cost_buf_;
@@ -151,6 +151,7 @@ void PathfindingGrid::mark_obstacle(f32 wx, f32 wz, f32 sizeX, f32 sizeZ) {
             cells_[z * grid_width_ + x] = CellPassability::Obstacle;
         }
     }
+    revision_++;
 }
 
 void PathfindingGrid::clear_obstacle(f32 wx, f32 wz, f32 sizeX, f32 sizeZ) {
@@ -166,6 +167,7 @@ void PathfindingGrid::clear_obstacle(f32 wx, f32 wz, f32 sizeX, f32 sizeZ) {
             cells_[z * grid_width_ + x] = base_cells_[z * grid_width_ + x];
         }
     }
+    revision_++;
 }
 
 } // namespace osc::map
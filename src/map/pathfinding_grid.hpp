@@ -53,6 +53,10 @@ public:
     /// Clear obstacle back to original terrain passability.
     void clear_obstacle(f32 wx, f32 wz, f32 sizeX, f32 sizeZ);
 
+    /// Bumped whenever passability changes; retained searches compare it
+    /// to know when their trees are stale.
+    u32 revision() const { return revision_; }
+
 private:
     u32 grid_width_;
     u32 grid_height_;
@@ -63,6 +67,7 @@ private:
     std::vector<CellPassability> base_cells_; // terrain-only (for restore)
     std::vector<f32> water_depth_;
     f32 water_elevation_ = 0;
+    u32 revision_ = 0;
 };
 
 } // namespace osc::map
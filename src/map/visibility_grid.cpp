@@ -125,6 +125,17 @@ void VisibilityGrid::build_height_grid(const Terrain& terrain) {
     }
 }
 
+f32 VisibilityGrid::eye_height(f32 wx, f32 wz) const {
+    if (height_grid_.empty()) return EYE_OFFSET;
+    u32 gx, gz;
+    world_to_grid(wx, wz, gx, gz);
+    return height_grid_[gz * grid_width_ + gx] + EYE_OFFSET;
+}
+
+i32 VisibilityGrid::horizon_reach(f32 radius) {
+    return static_cast<i32>(radius / static_cast<f32>(CELL_SIZE) + 0.5f);
+}
+
 bool VisibilityGrid::check_los(u32 src_gx, u32 src_gz, u32 tgt_gx,
                                 u32 tgt_gz, f32 eye_height) const {
     if (src_gx == tgt_gx && src_gz == tgt_gz) return true;
@@ -213,8 +224,8 @@ bool VisibilityGrid::check_los(u32 src_gx, u32 src_gz, u32 tgt_gx,
     return true; // fallback — Bresenham always reaches target
 }
 
-void VisibilityGrid::paint_circle_los(u32 army, f32 wx, f32 wz, f32 radius,
-                                       f32 eye_height) {
+void VisibilityGrid::paint_circle_los_bresenham(u32 army, f32 wx, f32 wz,
+                                                 f32 radius, f32 eye_height) {
     if (army >= MAX_ARMIES || radius <= 0.0f || height_grid_.empty()) return;
 
     u32 src_gx, src_gz;
@@ -251,4 +262,232 @@ void VisibilityGrid::paint_circle_los(u32 army, f32 wx, f32 wz, f32 radius,
     }
 }
 
+template <typename Fn>
+void VisibilityGrid::sweep_horizon(u32 src_gx, u32 src_gz, u32 gx_min,
+                                   u32 gz_min, u32 gx_max, u32 gz_max,
+                                   f32 eye_height, Fn&& fn) {
+    // Local window over the bounding box. Every cell a ray passes through
+    // lies between the source and its target, so the window is sufficient.
+    i32 win_w = static_cast<i32>(gx_max - gx_min + 1);
+    i32 win_h = static_cast<i32>(gz_max - gz_min + 1);
+    i32 ox = static_cast<i32>(src_gx - gx_min);
+    i32 oz = static_cast<i32>(src_gz - gz_min);
+    horizon_scratch_.resize(static_cast<size_t>(win_w) * win_h);
+
+    // Horizon: max slope (rise/run from the eye) of terrain along the ray
+    // from the source up to and including the cell.
+    auto horizon = [&](i32 rx, i32 rz) -> f32& {
+        return horizon_scratch_[(oz + rz) * win_w + (ox + rx)];
+    };
+    horizon(0, 0) = -1e30f;
+
+    f32 cell_f = static_cast<f32>(CELL_SIZE);
+    auto visit = [&](i32 rx, i32 rz, i32 k) {
+        i32 lx = ox + rx;
+        i32 lz = oz + rz;
+        if (lx < 0 || lz < 0 || lx >= win_w || lz >= win_h) return;
+
+        // The ray to (rx, rz) crosses ring k-1 between two adjacent cells on
+        // the minor axis; interpolate their horizons at the crossing point.
+        // Integer floor-division keeps the crossing exact (no float drift
+        // into the current ring on diagonals).
+        bool x_major = std::abs(rx) >= std::abs(rz);
+        i32 minor = x_major ? rz : rx;
+        i32 num = minor * (k - 1);
+        i32 lo = num >= 0 ? num / k : -((-num + k - 1) / k);
+        i32 rem = num - lo * k;
+        i32 major = (x_major ? rx : rz) > 0 ? k - 1 : -(k - 1);
+        f32 h_in = x_major ? horizon(major, lo) : horizon(lo, major);
+        if (rem > 0) {
+            f32 h_hi =
+                x_major ? horizon(major, lo + 1) : horizon(lo + 1, major);
+            f32 w = static_cast<f32>(rem) / static_cast<f32>(k);
+            h_in += (h_hi - h_in) * w;
+        }
+
+        u32 gx = static_cast<u32>(static_cast<i32>(src_gx) + rx);
+        u32 gz = static_cast<u32>(static_cast<i32>(src_gz) + rz);
+        f32 ddx = static_cast<f32>(rx) * cell_f;
+        f32 ddz = static_cast<f32>(rz) * cell_f;
+        f32 slope = (height_grid_[gz * grid_width_ + gx] - eye_height) /
+                    std::sqrt(ddx * ddx + ddz * ddz);
+        horizon(rx, rz) = std::max(h_in, slope);
+        fn(gx, gz, rx, rz, h_in, slope);
+    };
+
+    // Sweep outward ring by ring (Chebyshev distance); each ring depends
+    // only on the ring inside it.
+    i32 rings = std::max(std::max(ox, win_w - 1 - ox),
+                         std::max(oz, win_h - 1 - oz));
+    for (i32 k = 1; k <= rings; ++k) {
+        for (i32 r = -k; r <= k; ++r) {
+            visit(r, -k, k);
+            visit(r, k, k);
+        }
+        for (i32 r = -k + 1; r <= k - 1; ++r) {
+            visit(-k, r, k);
+            visit(k, r, k);
+        }
+    }
+}
+
+void VisibilityGrid::paint_circle_los(u32 army, f32 wx, f32 wz, f32 radius,
+                                       f32 eye_height) {
+    if (army >= MAX_ARMIES || radius <= 0.0f || height_grid_.empty()) return;
+
+    u32 src_gx, src_gz;
+    world_to_grid(wx, wz, src_gx, src_gz);
+
+    u32 gx_min, gz_min, gx_max, gz_max;
+    world_to_grid(wx - radius, wz - radius, gx_min, gz_min);
+    world_to_grid(wx + radius, wz + radius, gx_max, gz_max);
+
+    f32 cell_f = static_cast<f32>(CELL_SIZE);
+    f32 r_sq = radius * radius;
+    auto paint_if_in_radius = [&](u32 gx, u32 gz) {
+        f32 cx = (static_cast<f32>(gx) + 0.5f) * cell_f - wx;
+        f32 cz = (static_cast<f32>(gz) + 0.5f) * cell_f - wz;
+        if (cx * cx + cz * cz > r_sq) return;
+        cells_[army][gz * grid_width_ + gx] |=
+            VisFlag::Vision | VisFlag::EverSeen;
+    };
+
+    // Source cell: always visible
+    paint_if_in_radius(src_gx, src_gz);
+
+    // Target is visible if it rises to at least the horizon in front.
+    sweep_horizon(src_gx, src_gz, gx_min, gz_min, gx_max, gz_max, eye_height,
+                  [&](u32 gx, u32 gz, i32, i32, f32 h_in, f32 slope) {
+                      if (slope >= h_in) paint_if_in_radius(gx, gz);
+                  });
+}
+
+u16 VisibilityGrid::elevation_code(f32 slope) {
+    // s / (1 + |s|) maps (-inf, inf) monotonically onto (-1, 1)
+    f32 n = slope / (1.0f + std::abs(slope));
+    return static_cast<u16>(32768.0f + n * 32767.0f);
+}
+
+void VisibilityGrid::set_horizon_cache_budget(size_t bytes) {
+    horizon_cache_budget_ = bytes;
+    evict_horizon_tables(bytes);
+}
+
+void VisibilityGrid::evict_horizon_tables(size_t limit) {
+    while (horizon_cache_bytes_ > limit && !horizon_lru_.empty()) {
+        auto it = horizon_tables_.find(horizon_lru_.back());
+        horizon_cache_bytes_ -= it->second.horizon.size() * sizeof(u16);
+        horizon_tables_.erase(it);
+        horizon_lru_.pop_back();
+    }
+}
+
+const VisibilityGrid::HorizonTable* VisibilityGrid::horizon_table(
+    u32 src_gx, u32 src_gz, i32 reach) {
+    u32 key = src_gz * grid_width_ + src_gx;
+    auto found = horizon_tables_.find(key);
+    if (found != horizon_tables_.end()) {
+        if (found->second.reach >= reach) {
+            horizon_lru_.splice(horizon_lru_.begin(), horizon_lru_,
+                                found->second.lru_it);
+            return &found->second;
+        }
+        // A wider emitter stopped here: rebuild at its reach. The inner
+        // cells come out the same, so smaller radii keep using it.
+        horizon_cache_bytes_ -= found->second.horizon.size() * sizeof(u16);
+        horizon_lru_.erase(found->second.lru_it);
+        horizon_tables_.erase(found);
+    }
+
+    auto r = static_cast<u32>(reach);
+    HorizonTable table;
+    table.reach = reach;
+    table.gx_min = src_gx > r ? src_gx - r : 0;
+    table.gz_min = src_gz > r ? src_gz - r : 0;
+    u32 gx_max = std::min(src_gx + r, grid_width_ - 1);
+    u32 gz_max = std::min(src_gz + r, grid_height_ - 1);
+    table.width = gx_max - table.gx_min + 1;
+    table.height = gz_max - table.gz_min + 1;
+    table.eye_height = height_grid_[key] + EYE_OFFSET;
+
+    size_t bytes = static_cast<size_t>(table.width) * table.height *
+                   sizeof(u16);
+    if (bytes > horizon_cache_budget_) return nullptr;
+    evict_horizon_tables(horizon_cache_budget_ - bytes);
+
+    // Source cell keeps code 0: always visible
+    table.horizon.assign(static_cast<size_t>(table.width) * table.height, 0);
+    sweep_horizon(src_gx, src_gz, table.gx_min, table.gz_min, gx_max, gz_max,
+                  table.eye_height,
+                  [&](u32 gx, u32 gz, i32, i32, f32 h_in, f32) {
+                      table.horizon[(gz - table.gz_min) * table.width +
+                                    (gx - table.gx_min)] =
+                          elevation_code(h_in);
+                  });
+
+    horizon_cache_bytes_ += bytes;
+    horizon_lru_.push_front(key);
+    table.lru_it = horizon_lru_.begin();
+    return &horizon_tables_.emplace(key, std::move(table)).first->second;
+}
+
+void VisibilityGrid::paint_circle_los_cached(u32 army, f32 wx, f32 wz,
+                                              f32 radius) {
+    if (army >= MAX_ARMIES || radius <= 0.0f || height_grid_.empty()) return;
+
+    u32 src_gx, src_gz;
+    world_to_grid(wx, wz, src_gx, src_gz);
+
+    f32 cell_f = static_cast<f32>(CELL_SIZE);
+    const HorizonTable* table = nullptr;
+    i32 reach = horizon_reach(radius);
+    if (reach <= HORIZON_TABLE_RADIUS)
+        table = horizon_table(src_gx, src_gz, std::max(reach, 1));
+    if (!table) {
+        paint_circle_los(army, wx, wz, radius, eye_height(wx, wz));
+        return;
+    }
+
+    u32 gx_min, gz_min, gx_max, gz_max;
+    world_to_grid(wx - radius, wz - radius, gx_min, gz_min);
+    world_to_grid(wx + radius, wz + radius, gx_max, gz_max);
+    gx_min = std::max(gx_min, table->gx_min);
+    gz_min = std::max(gz_min, table->gz_min);
+    gx_max = std::min(gx_max, table->gx_min + table->width - 1);
+    gz_max = std::min(gz_max, table->gz_min + table->height - 1);
+
+    // 1 / world distance per |offset|, shared by every table
+    constexpr i32 lut_w = HORIZON_TABLE_RADIUS + 1;
+    static const std::array<f32, lut_w * lut_w> inv_dist = [] {
+        std::array<f32, lut_w * lut_w> lut{};
+        for (i32 z = 0; z < lut_w; ++z)
+            for (i32 x = 0; x < lut_w; ++x) {
+                if ((x | z) == 0) continue;
+                f32 d = std::sqrt(static_cast<f32>(x * x + z * z));
+                lut[z * lut_w + x] = 1.0f / (d * static_cast<f32>(CELL_SIZE));
+            }
+        return lut;
+    }();
+
+    f32 r_sq = radius * radius;
+    for (u32 gz = gz_min; gz <= gz_max; ++gz) {
+        f32 cz = (static_cast<f32>(gz) + 0.5f) * cell_f - wz;
+        const f32* lut_row =
+            &inv_dist[std::abs(static_cast<i32>(gz - src_gz)) * lut_w];
+        const u16* row =
+            &table->horizon[(gz - table->gz_min) * table->width];
+        for (u32 gx = gx_min; gx <= gx_max; ++gx) {
+            f32 cx = (static_cast<f32>(gx) + 0.5f) * cell_f - wx;
+            if (cx * cx + cz * cz > r_sq) continue;
+
+            // Source cell has horizon code 0 and inverse distance 0
+            u32 idx = gz * grid_width_ + gx;
+            f32 slope = (height_grid_[idx] - table->eye_height) *
+                        lut_row[std::abs(static_cast<i32>(gx - src_gx))];
+            if (elevation_code(slope) < row[gx - table->gx_min]) continue;
+            cells_[army][idx] |= VisFlag::Vision | VisFlag::EverSeen;
+        }
+    }
+}
+
 } // namespace osc::map
@@ -3,6 +3,8 @@
 #include "core/types.hpp"
 
 #include <array>
+#include <list>
+#include <unordered_map>
 #include <vector>
 
 namespace osc::map {
@@ -41,6 +43,11 @@ public:
     static constexpr u32 CELL_SIZE = 16;
     static constexpr u32 MAX_ARMIES = 16;
     static constexpr f32 EYE_OFFSET = 2.0f;
+    /// Largest reach of a cached horizon table, in cells from the source
+    /// cell. Each table only covers its emitter's radius (see horizon_reach).
+    static constexpr i32 HORIZON_TABLE_RADIUS = 32;
+    /// Default byte budget for cached horizon tables (~2000 source cells).
+    static constexpr size_t DEFAULT_HORIZON_CACHE_BUDGET = 16u << 20;
 
     VisibilityGrid(u32 map_width, u32 map_height);
 
@@ -58,10 +65,42 @@ public:
     /// If flag includes Vision, also sets EverSeen on affected cells.
     void paint_circle(u32 army, f32 wx, f32 wz, f32 radius, VisFlag flag);
 
+    /// Eye height of a vision source at a world position: the sampled
+    /// ground of its cell + EYE_OFFSET. The sweeps treat the eye as being at
+    /// the cell center, so movers and cached tables both use this and LOS
+    /// does not change when a unit stops or starts.
+    f32 eye_height(f32 wx, f32 wz) const;
+
+    /// Cells from the source cell that a circle of `radius` can reach:
+    /// cell centers lie within half a cell of any point in the source cell.
+    static i32 horizon_reach(f32 radius);
+
     /// Paint Vision with terrain line-of-sight occlusion.
-    /// eye_height = terrain_height(unit_pos) + EYE_OFFSET.
+    /// eye_height is normally eye_height(wx, wz).
+    /// Single radial sweep (XDraw-style horizon propagation): each ring of
+    /// cells interpolates its horizon from the ring inside it, O(r^2).
     void paint_circle_los(u32 army, f32 wx, f32 wz, f32 radius, f32 eye_height);
 
+    /// Reference LOS paint: independent Bresenham ray per target cell, O(r^3).
+    /// Kept for validation and benchmarking against paint_circle_los.
+    void paint_circle_los_bresenham(u32 army, f32 wx, f32 wz, f32 radius,
+                                    f32 eye_height);
+
+    /// LOS paint for stationary emitters via a cached horizon table.
+    /// The first paint from a source cell runs the sweep once from
+    /// eye_height() and stores a quantized horizon profile: for each cell
+    /// within horizon_reach(radius), the max elevation of the terrain in
+    /// front of it along its azimuth. Later paints only compare each
+    /// target's elevation against the table; a larger radius from the same
+    /// cell rebuilds it wider. Falls back to paint_circle_los when the cache
+    /// is disabled or the reach exceeds HORIZON_TABLE_RADIUS.
+    void paint_circle_los_cached(u32 army, f32 wx, f32 wz, f32 radius);
+
+    /// Byte budget for cached horizon tables (LRU eviction). 0 disables.
+    void set_horizon_cache_budget(size_t bytes);
+    size_t horizon_cache_bytes() const { return horizon_cache_bytes_; }
+    size_t horizon_cache_size() const { return horizon_tables_.size(); }
+
     /// Pre-compute terrain height at each grid cell center.
     /// Must be called once after construction, before paint_circle_los.
     void build_height_grid(const Terrain& terrain);
@@ -85,6 +124,36 @@ private:
     u32 map_width_;
     u32 map_height_;
 
+    /// Quantized horizon profile for one source cell.
+    struct HorizonTable {
+        u32 gx_min = 0, gz_min = 0; // window origin in grid coordinates
+        u32 width = 0, height = 0;  // window size in cells
+        i32 reach = 0;              // cells covered around the source
+        f32 eye_height = 0.0f;
+        // Horizon in front of each window cell, as elevation_code()
+        std::vector<u16> horizon;
+        std::list<u32>::iterator lru_it;
+    };
+
+    /// Monotone 16-bit code for an elevation slope (rise/run). Ordering is
+    /// preserved, so "visible" is code(target) >= code(horizon).
+    static u16 elevation_code(f32 slope);
+
+    /// Radial horizon sweep over the window [gx_min..gx_max]x[gz_min..gz_max]
+    /// around the source. Calls fn(gx, gz, rx, rz, horizon_in, slope) for
+    /// every window cell except the source, ring by ring.
+    template <typename Fn>
+    void sweep_horizon(u32 src_gx, u32 src_gz, u32 gx_min, u32 gz_min,
+                       u32 gx_max, u32 gz_max, f32 eye_height, Fn&& fn);
+
+    /// Find or build the horizon table for a source cell covering at least
+    /// `reach` cells (LRU touch). Returns nullptr if a single table would
+    /// exceed the budget.
+    const HorizonTable* horizon_table(u32 src_gx, u32 src_gz, i32 reach);
+
+    /// Drop least-recently-used tables until the cache fits in limit bytes.
+    void evict_horizon_tables(size_t limit);
+
     /// Bresenham LOS check: returns true if target cell is visible from source.
     bool check_los(u32 src_gx, u32 src_gz, u32 tgt_gx, u32 tgt_gz,
                    f32 eye_height) const;
@@ -94,6 +163,15 @@ private:
 
     // Pre-sampled terrain height at each cell center
     std::vector<f32> height_grid_;
+
+    // Per-cell horizon slope scratch for the radial sweep (reused per paint)
+    std::vector<f32> horizon_scratch_;
+
+    // Cached horizon tables keyed by source cell index, most recent first
+    std::unordered_map<u32, HorizonTable> horizon_tables_;
+    std::list<u32> horizon_lru_;
+    size_t horizon_cache_budget_ = 0;
+    size_t horizon_cache_bytes_ = 0;
 };
 
 } // namespace osc::map
@@ -112,7 +112,7 @@ std::array<f32, 16> Camera::view_proj(f32 aspect) const {
     auto view = math::look_at(eye_x, eye_y, eye_z,
                               tx, 0.0f, tz,
                               0.0f, 1.0f, 0.0f);
-    auto proj = math::perspective(0.785f, aspect, 1.0f, 5000.0f); // 45 deg FOV
+    auto proj = math::perspective(FOV_Y, aspect, 1.0f, 5000.0f);
 
     return math::mat4_mul(proj, view);
 }
@@ -218,7 +218,7 @@ bool Camera::screen_to_world(f32 screen_x, f32 screen_y,
     auto view = math::look_at(ex, ey, ez,
                                target_x_, 0.0f, target_z_,
                                0.0f, 1.0f, 0.0f);
-    auto proj = math::perspective(0.785f, aspect, 1.0f, 5000.0f);
+    auto proj = math::perspective(FOV_Y, aspect, 1.0f, 5000.0f);
 
     // We need to invert VP to go from NDC to world.
     // Instead, construct ray directly from camera parameters:
@@ -228,8 +228,7 @@ bool Camera::screen_to_world(f32 screen_x, f32 screen_y,
     f32 fx = -view[2], fy = -view[6], fz = -view[10]; // forward (negated -Z)
 
     // Half-angles from perspective
-    f32 fov = 0.785f; // 45 deg
-    f32 tan_half = std::tan(fov * 0.5f);
+    f32 tan_half = std::tan(FOV_Y * 0.5f);
 
     // Direction in world space
     f32 dx = fx + ndc_x * aspect * tan_half * rx + ndc_y * tan_half * ux;
@@ -12,6 +12,8 @@ namespace osc::renderer {
 /// Produces a combined view-projection matrix as push constant data.
 class Camera {
 public:
+    static constexpr f32 FOV_Y = 0.785f; // vertical field of view, 45 deg
+
     /// Initialize camera centered on map.
     void init(f32 map_width, f32 map_height);
 
@@ -1,5 +1,3 @@
-#include "stb/stb_truetype.h"
-
 #include "renderer/font_cache.hpp"
 #include "vfs/virtual_file_system.hpp"
 
@@ -7,6 +5,8 @@
 #include <vk_mem_alloc.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
 
 // forward-declare from vk_utils.cpp
@@ -161,7 +161,7 @@ void FontCache::init(VkDevice device, VmaAllocator allocator,
     sampler_ = sampler;
     vfs_ = vfs;
 
-    // Create descriptor pool for font atlas textures (64 max fonts)
+    // Create descriptor pool for font atlas textures (64 max font files)
     VkDescriptorPoolSize pool_size{};
     pool_size.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     pool_size.descriptorCount = 64;
@@ -209,156 +209,83 @@ std::string FontCache::resolve_font_path(const std::string& family) const {
     return direct;
 }
 
-FontAtlas* FontCache::load_font(const std::string& family, i32 pointsize) {
-    std::string font_path = resolve_font_path(family);
-
-    // Load TTF data from VFS (cache raw data for reuse at different sizes)
-    auto ttf_it = ttf_data_cache_.find(font_path);
-    if (ttf_it == ttf_data_cache_.end()) {
-        if (!vfs_) return nullptr;
-        auto data = vfs_->read_file(font_path);
+FontCache::FontFile* FontCache::load_font_file(const std::string& family) {
+    const std::string font_path = resolve_font_path(family);
+    auto file_it = files_.find(font_path);
+    if (file_it != files_.end()) return file_it->second.get();
+    if (!vfs_) return nullptr;
+
+    // Load TTF data from VFS (only needed until the atlas exists)
+    auto data = vfs_->read_file(font_path);
+    if (!data || data->empty()) {
+        // Try lowercase
+        std::string lower_path = font_path;
+        std::transform(lower_path.begin(), lower_path.end(),
+                       lower_path.begin(), ::tolower);
+        data = vfs_->read_file(lower_path);
         if (!data || data->empty()) {
-            // Try lowercase
-            std::string lower_path = font_path;
-            std::transform(lower_path.begin(), lower_path.end(),
-                           lower_path.begin(), ::tolower);
-            data = vfs_->read_file(lower_path);
-            if (!data || data->empty()) {
-                spdlog::warn("FontCache: font not found: {}", font_path);
-                return nullptr;
-            }
-            font_path = lower_path;
+            spdlog::warn("FontCache: font not found: {}", font_path);
+            files_[font_path] = nullptr;
+            return nullptr;
         }
-        ttf_data_cache_[font_path] = std::move(*data);
-        ttf_it = ttf_data_cache_.find(font_path);
     }
 
-    const auto& ttf_data = ttf_it->second;
-
-    // Initialize stb_truetype
-    stbtt_fontinfo font;
-    if (!stbtt_InitFont(&font,
-                        reinterpret_cast<const unsigned char*>(ttf_data.data()),
-                        stbtt_GetFontOffsetForIndex(
-                            reinterpret_cast<const unsigned char*>(ttf_data.data()), 0))) {
-        spdlog::error("FontCache: failed to init font: {}", font_path);
-        return nullptr;
+    const auto* ttf = reinterpret_cast<const u8*>(data->data());
+    const u64 font_hash = SdfFont::hash(ttf, data->size());
+    auto file = std::make_unique<FontFile>();
+    auto start = std::chrono::steady_clock::now();
+
+    // Atlas from an earlier run, named after the font and its content hash
+    fs::path atlas_path;
+    if (!atlas_dir_.empty()) {
+        std::string stem = fs::path(font_path).stem().string();
+        std::transform(stem.begin(), stem.end(), stem.begin(), ::tolower);
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), "-%016llx.sdf",
+                      static_cast<unsigned long long>(font_hash));
+        atlas_path = atlas_dir_ / (stem + suffix);
     }
-
-    f32 scale = stbtt_ScaleForPixelHeight(&font, static_cast<f32>(pointsize));
-
-    // Get font metrics
-    int ascent_raw, descent_raw, line_gap_raw;
-    stbtt_GetFontVMetrics(&font, &ascent_raw, &descent_raw, &line_gap_raw);
-
-    auto atlas = std::make_unique<FontAtlas>();
-    atlas->metrics.ascent = ascent_raw * scale;
-    atlas->metrics.descent = -descent_raw * scale; // stb gives negative descent
-    atlas->metrics.line_gap = line_gap_raw * scale;
-    atlas->metrics.line_height = atlas->metrics.ascent + atlas->metrics.descent +
-                                  atlas->metrics.line_gap;
-
-    // Rasterize ASCII printable characters (32-126)
-    constexpr u32 FIRST_CHAR = 32;
-    constexpr u32 LAST_CHAR = 126;
-    constexpr u32 CHAR_COUNT = LAST_CHAR - FIRST_CHAR + 1;
-
-    // Determine atlas size (pack glyphs in rows)
-    // Estimate: each glyph ~pointsize x pointsize, pack ~16 per row
-    u32 cols = 16;
-    u32 rows = (CHAR_COUNT + cols - 1) / cols;
-    u32 cell_w = static_cast<u32>(pointsize) + 2;
-    u32 cell_h = static_cast<u32>(pointsize) + 2;
-    atlas->atlas_width = cols * cell_w;
-    atlas->atlas_height = rows * cell_h;
-
-    // Ensure power-of-two dimensions for compatibility
-    auto next_pow2 = [](u32 v) -> u32 {
-        v--;
-        v |= v >> 1; v |= v >> 2; v |= v >> 4;
-        v |= v >> 8; v |= v >> 16;
-        return v + 1;
-    };
-    atlas->atlas_width = next_pow2(atlas->atlas_width);
-    atlas->atlas_height = next_pow2(atlas->atlas_height);
-
-    // Rasterize all glyphs into atlas bitmap
-    std::vector<u8> bitmap(atlas->atlas_width * atlas->atlas_height, 0);
-
-    for (u32 i = 0; i < CHAR_COUNT; i++) {
-        u32 codepoint = FIRST_CHAR + i;
-        u32 col = i % cols;
-        u32 row = i / cols;
-        u32 x0 = col * cell_w + 1; // 1px padding
-        u32 y0 = row * cell_h + 1;
-
-        int gw, gh, xoff, yoff;
-        unsigned char* glyph_bmp = stbtt_GetCodepointBitmap(
-            &font, 0, scale,
-            static_cast<int>(codepoint),
-            &gw, &gh, &xoff, &yoff);
-
-        if (glyph_bmp) {
-            // Clamp to cell bounds
-            u32 copy_w = std::min(static_cast<u32>(gw), cell_w - 2);
-            u32 copy_h = std::min(static_cast<u32>(gh), cell_h - 2);
-
-            for (u32 py = 0; py < copy_h; py++) {
-                for (u32 px = 0; px < copy_w; px++) {
-                    u32 dst_x = x0 + px;
-                    u32 dst_y = y0 + py;
-                    if (dst_x < atlas->atlas_width && dst_y < atlas->atlas_height) {
-                        bitmap[dst_y * atlas->atlas_width + dst_x] =
-                            glyph_bmp[py * gw + px];
-                    }
-                }
-            }
-
-            stbtt_FreeBitmap(glyph_bmp, nullptr);
-
-            // Store glyph info
-            GlyphInfo gi{};
-            gi.u0 = static_cast<f32>(x0) / atlas->atlas_width;
-            gi.v0 = static_cast<f32>(y0) / atlas->atlas_height;
-            gi.u1 = static_cast<f32>(x0 + copy_w) / atlas->atlas_width;
-            gi.v1 = static_cast<f32>(y0 + copy_h) / atlas->atlas_height;
-            gi.x_offset = static_cast<f32>(xoff);
-            gi.y_offset = static_cast<f32>(yoff);
-            gi.width = static_cast<f32>(copy_w);
-            gi.height = static_cast<f32>(copy_h);
-
-            int advance_raw, lsb;
-            stbtt_GetCodepointHMetrics(&font, static_cast<int>(codepoint),
-                                       &advance_raw, &lsb);
-            gi.x_advance = advance_raw * scale;
-
-            atlas->glyphs[codepoint] = gi;
+    const bool loaded = !atlas_path.empty() && file->sdf.load(atlas_path, font_hash);
+    if (!loaded) {
+        if (!file->sdf.build(ttf, data->size())) {
+            spdlog::error("FontCache: failed to init font: {}", font_path);
+            files_[font_path] = nullptr;
+            return nullptr;
         }
+        if (!atlas_path.empty() && !file->sdf.save(atlas_path))
+            spdlog::debug("FontCache: cannot write {}", atlas_path.string());
     }
 
+    const f64 ms = std::chrono::duration<f64, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    stats_.atlas_ms += ms;
+    if (loaded) stats_.atlases_loaded++;
+    else stats_.atlases_built++;
+
     // Upload atlas to GPU
+    const SdfFont& sdf = file->sdf;
     if (device_ && allocator_) {
-        atlas->image = upload_r8_image(allocator_, device_, cmd_pool_, queue_,
-                                        bitmap.data(),
-                                        atlas->atlas_width, atlas->atlas_height);
+        file->image = upload_r8_image(allocator_, device_, cmd_pool_, queue_,
+                                      sdf.pixels().data(),
+                                      sdf.width(), sdf.height());
 
         // Create descriptor set
-        if (atlas->image.view && descriptor_pool_) {
+        if (file->image.view && descriptor_pool_) {
             VkDescriptorSetAllocateInfo ds_ai{};
             ds_ai.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
             ds_ai.descriptorPool = descriptor_pool_;
             ds_ai.descriptorSetCount = 1;
             ds_ai.pSetLayouts = &ds_layout_;
-            vkAllocateDescriptorSets(device_, &ds_ai, &atlas->descriptor_set);
+            vkAllocateDescriptorSets(device_, &ds_ai, &file->descriptor_set);
 
             VkDescriptorImageInfo img_info{};
             img_info.sampler = sampler_;
-            img_info.imageView = atlas->image.view;
+            img_info.imageView = file->image.view;
             img_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
             VkWriteDescriptorSet write{};
             write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            write.dstSet = atlas->descriptor_set;
+            write.dstSet = file->descriptor_set;
             write.dstBinding = 0;
             write.descriptorCount = 1;
             write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -367,14 +294,36 @@ FontAtlas* FontCache::load_font(const std::string& family, i32 pointsize) {
         }
     }
 
+    spdlog::info("FontCache: {} SDF atlas {} in {:.1f} ms ({} glyphs, {}x{})",
+                 font_path, loaded ? "loaded" : "built", ms,
+                 static_cast<u32>(sdf.glyphs().size()), sdf.width(), sdf.height());
+
+    auto* ptr = file.get();
+    files_[font_path] = std::move(file);
+    return ptr;
+}
+
+FontAtlas* FontCache::load_font(const std::string& family, i32 pointsize) {
+    FontFile* file = load_font_file(family);
+    if (!file) return nullptr;
+
+    // A new size is just the shared atlas's glyph table, rescaled
+    const f32 size = static_cast<f32>(pointsize);
+    auto atlas = std::make_unique<FontAtlas>();
+    atlas->descriptor_set = file->descriptor_set;
+    atlas->metrics = file->sdf.metrics(size);
+    file->sdf.glyphs_at(size, atlas->glyphs);
+    atlas->index = &file->sdf.index();
+    atlas->atlas_width = file->sdf.width();
+    atlas->atlas_height = file->sdf.height();
+
     std::string key = make_key(family, pointsize);
     auto* ptr = atlas.get();
     cache_[key] = std::move(atlas);
+    stats_.sizes++;
 
-    spdlog::debug("FontCache: loaded {} {}pt ({} glyphs, {}x{} atlas)",
-                  family, pointsize,
-                  static_cast<u32>(ptr->glyphs.size()),
-                  ptr->atlas_width, ptr->atlas_height);
+    spdlog::debug("FontCache: {} {}pt from the shared atlas ({} glyphs)",
+                  family, pointsize, static_cast<u32>(ptr->glyphs.size()));
     return ptr;
 }
 
@@ -402,30 +351,28 @@ f32 FontCache::string_advance(const std::string& family, i32 pointsize,
 
     f32 advance = 0.0f;
     for (unsigned char c : text) {
-        auto git = atlas->glyphs.find(static_cast<u32>(c));
-        if (git != atlas->glyphs.end()) {
-            advance += git->second.x_advance;
+        if (const GlyphInfo* gi = atlas->glyph(c)) {
+            advance += gi->x_advance;
         } else {
             // Unknown glyph — use space width or heuristic
-            auto space_it = atlas->glyphs.find(32);
-            if (space_it != atlas->glyphs.end())
-                advance += space_it->second.x_advance;
-            else
-                advance += static_cast<f32>(pointsize) * 0.6f;
+            const GlyphInfo* space = atlas->glyph(32);
+            advance += space ? space->x_advance
+                             : static_cast<f32>(pointsize) * 0.6f;
         }
     }
     return advance;
 }
 
 void FontCache::destroy(VkDevice device, VmaAllocator allocator) {
-    for (auto& [key, atlas] : cache_) {
-        if (atlas->image.view)
-            vkDestroyImageView(device, atlas->image.view, nullptr);
-        if (atlas->image.image)
-            vmaDestroyImage(allocator, atlas->image.image, atlas->image.allocation);
+    for (auto& [path, file] : files_) {
+        if (!file) continue;
+        if (file->image.view)
+            vkDestroyImageView(device, file->image.view, nullptr);
+        if (file->image.image)
+            vmaDestroyImage(allocator, file->image.image, file->image.allocation);
     }
     cache_.clear();
-    ttf_data_cache_.clear();
+    files_.clear();
 
     if (descriptor_pool_)
         vkDestroyDescriptorPool(device, descriptor_pool_, nullptr);
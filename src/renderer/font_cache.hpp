@@ -1,10 +1,12 @@
 #pragma once
 
+#include "renderer/sdf_font.hpp"
 #include "renderer/vk_types.hpp"
 #include "core/types.hpp"
 
 #include <vulkan/vulkan.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -15,35 +17,29 @@ class VirtualFileSystem;
 
 namespace osc::renderer {
 
-/// Per-glyph data for a rasterized character.
-struct GlyphInfo {
-    f32 u0, v0, u1, v1;  // UV coords in atlas
-    f32 x_offset;         // left bearing in pixels
-    f32 y_offset;         // top bearing in pixels (from baseline)
-    f32 width;            // glyph bitmap width in pixels
-    f32 height;           // glyph bitmap height in pixels
-    f32 x_advance;        // horizontal advance in pixels
-};
-
-/// Font metrics for a loaded font at a specific point size.
-struct FontMetrics {
-    f32 ascent;           // pixels above baseline
-    f32 descent;          // pixels below baseline (positive value)
-    f32 line_gap;         // extra leading between lines
-    f32 line_height;      // ascent + descent + line_gap
-};
-
-/// A GPU-resident font atlas with glyph data.
+/// One point size of a font: metrics and glyph quads scaled from the
+/// font file's distance-field atlas. Every size of a font shares its
+/// texture and descriptor set.
 struct FontAtlas {
-    AllocatedImage image{};
     VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
     FontMetrics metrics{};
-    std::unordered_map<u32, GlyphInfo> glyphs; // codepoint → glyph
+    std::vector<GlyphInfo> glyphs;           // by slot
+    const std::vector<u16>* index = nullptr; // BMP codepoint → slot + 1
     u32 atlas_width = 0;
     u32 atlas_height = 0;
+
+    /// Glyph for a codepoint, or nullptr if the font has none.
+    const GlyphInfo* glyph(u32 codepoint) const {
+        if (!index || codepoint >= index->size()) return nullptr;
+        u16 slot = (*index)[codepoint];
+        return slot ? &glyphs[slot - 1] : nullptr;
+    }
 };
 
-/// Caches rasterized font atlases keyed by (family, pointsize).
+/// Caches one signed-distance-field atlas per font file and the per-size
+/// views of it, keyed by (family, pointsize). A new size only scales the
+/// glyph table; the atlas is rasterized once per font, or read back from
+/// the atlas directory when an earlier run already built it.
 class FontCache {
 public:
     void init(VkDevice device, VmaAllocator allocator,
@@ -51,6 +47,10 @@ public:
               VkDescriptorSetLayout ds_layout, VkSampler sampler,
               vfs::VirtualFileSystem* vfs);
 
+    /// Directory for generated atlases (default "cache/fonts"); empty
+    /// disables reading and writing them.
+    void set_atlas_dir(fs::path dir) { atlas_dir_ = std::move(dir); }
+
     /// Get or lazily load a font atlas for a given family and pointsize.
     /// Returns nullptr if the font cannot be loaded.
     const FontAtlas* get(const std::string& family, i32 pointsize);
@@ -64,13 +64,32 @@ public:
 
     void destroy(VkDevice device, VmaAllocator allocator);
 
+    struct Stats {
+        u32 atlases_built = 0;  ///< rasterized from the font
+        u32 atlases_loaded = 0; ///< read from the atlas directory
+        u32 sizes = 0;          ///< (family, pointsize) views created
+        f64 atlas_ms = 0;       ///< time spent building or loading atlases
+    };
+    const Stats& stats() const { return stats_; }
+
 private:
+    /// A font file's atlas and its GPU copy.
+    struct FontFile {
+        SdfFont sdf;
+        AllocatedImage image{};
+        VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+    };
+
     std::string make_key(const std::string& family, i32 pointsize) const;
     std::string resolve_font_path(const std::string& family) const;
+    FontFile* load_font_file(const std::string& family);
     FontAtlas* load_font(const std::string& family, i32 pointsize);
 
     std::unordered_map<std::string, std::unique_ptr<FontAtlas>> cache_;
-    std::unordered_map<std::string, std::vector<char>> ttf_data_cache_;
+    /// By resolved font path; null when the font could not be loaded.
+    std::unordered_map<std::string, std::unique_ptr<FontFile>> files_;
+    fs::path atlas_dir_ = "cache/fonts";
+    Stats stats_;
 
     VkDescriptorPool descriptor_pool_ = VK_NULL_HANDLE;
     VkDescriptorSetLayout ds_layout_ = VK_NULL_HANDLE;
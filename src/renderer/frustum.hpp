@@ -16,6 +16,12 @@ public:
     /// Test if a bounding sphere is at least partially inside the frustum.
     bool is_sphere_visible(f32 cx, f32 cy, f32 cz, f32 radius) const;
 
+    /// Plane i (left, right, bottom, top, near, far) as {a, b, c, d}.
+    std::array<f32, 4> plane(u32 i) const {
+        const auto& p = planes_[i];
+        return {p.a, p.b, p.c, p.d};
+    }
+
 private:
     struct Plane {
         f32 a, b, c, d; // normal (a,b,c) + distance d; normalized
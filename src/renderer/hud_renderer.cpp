@@ -81,16 +81,15 @@ f32 HudRenderer::emit_text(const std::string& text, f32 x, f32 y,
 
     for (char c : text) {
         u32 cp = static_cast<u32>(static_cast<u8>(c));
-        auto it = atlas->glyphs.find(cp);
-        if (it == atlas->glyphs.end()) {
+        const GlyphInfo* glyph = atlas->glyph(cp);
+        if (!glyph) {
             // Try space width for unknown glyphs
-            auto sp = atlas->glyphs.find(32);
-            if (sp != atlas->glyphs.end())
-                cursor_x += sp->second.x_advance;
+            if (const GlyphInfo* sp = atlas->glyph(32))
+                cursor_x += sp->x_advance;
             continue;
         }
 
-        auto& gi = it->second;
+        const auto& gi = *glyph;
 
         f32 gx = cursor_x + gi.x_offset;
         f32 gy = baseline_y - gi.y_offset; // y_offset is from baseline upward
@@ -0,0 +1,329 @@
+#include "renderer/icon_clustering.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace osc::renderer {
+
+namespace {
+
+// Base cell coordinates are biased to stay positive; the bias is a
+// multiple of every level's cell so coarser cells stay aligned.
+constexpr i32 CELL_BIAS = 1 << 16;
+constexpr u32 MAX_BADGE = 9999;
+
+u32 cell_coord(f32 s) {
+    f32 c = std::floor(s / IconClusterer::BASE_CELL_PX);
+    c = std::clamp(c, static_cast<f32>(-CELL_BIAS), static_cast<f32>(CELL_BIAS - 1));
+    return static_cast<u32>(static_cast<i32>(c) + CELL_BIAS);
+}
+
+u64 make_key(u32 cx, u32 cy) {
+    return (static_cast<u64>(cy) << 32) | cx;
+}
+
+u32 key_x(u64 key) { return static_cast<u32>(key); }
+u32 key_y(u64 key) { return static_cast<u32>(key >> 32); }
+
+f32 cell_center(u32 c) {
+    return (static_cast<f32>(static_cast<i32>(c) - CELL_BIAS) + 0.5f) *
+           IconClusterer::BASE_CELL_PX;
+}
+
+size_t army_slot(i32 army) {
+    if (army < 0 || army >= IconClusterer::MAX_ARMIES) return 0;
+    return static_cast<size_t>(army) + 1;
+}
+
+u32 badge_digits(u32 count) {
+    if (count <= 1) return 0;
+    u32 n = std::min(count, MAX_BADGE);
+    u32 digits = 1;
+    while (n >= 10) {
+        n /= 10;
+        ++digits;
+    }
+    return digits;
+}
+
+void push_quad(std::vector<IconQuad>& out, f32 x, f32 y, f32 w, f32 h,
+               f32 u0, f32 u1, f32 r, f32 g, f32 b, f32 a) {
+    IconQuad q{};
+    q.rect[0] = x; q.rect[1] = y; q.rect[2] = w; q.rect[3] = h;
+    q.uv[0] = u0; q.uv[1] = 0.0f; q.uv[2] = u1; q.uv[3] = 1.0f;
+    q.color[0] = r; q.color[1] = g; q.color[2] = b; q.color[3] = a;
+    out.push_back(q);
+}
+
+f32 atlas_u(u32 cell) {
+    return static_cast<f32>(cell) / static_cast<f32>(ICON_ATLAS_COLS);
+}
+
+} // namespace
+
+bool world_to_screen(f32 wx, f32 wy, f32 wz, const std::array<f32, 16>& vp,
+                     f32 sw, f32 sh, f32& out_x, f32& out_y) {
+    f32 cx = vp[0]*wx + vp[4]*wy + vp[8]*wz  + vp[12];
+    f32 cy = vp[1]*wx + vp[5]*wy + vp[9]*wz  + vp[13];
+    f32 cw = vp[3]*wx + vp[7]*wy + vp[11]*wz + vp[15];
+
+    if (cw <= 0.001f) return false;
+
+    f32 ndc_x = cx / cw;
+    f32 ndc_y = cy / cw;
+
+    out_x = (ndc_x + 1.0f) * 0.5f * sw;
+    out_y = (ndc_y + 1.0f) * 0.5f * sh;
+    return true;
+}
+
+// --- IconClusterer ---
+
+u32 IconClusterer::level_for_icon(f32 icon_size) {
+    u32 level = 0;
+    while (level < MAX_LEVEL &&
+           BASE_CELL_PX * static_cast<f32>(1u << level) < icon_size)
+        ++level;
+    return level;
+}
+
+u32 IconClusterer::quad_count(const IconCluster& c) {
+    return (c.selected ? 1u : 0u) + 1u + badge_digits(c.count);
+}
+
+void IconClusterer::begin_frame() {
+    ++frame_;
+    stats_.frames++;
+    for (auto& a : armies_) a.seen = 0;
+}
+
+void IconClusterer::add(u32 id, i32 army, StrategicIconType type,
+                        f32 sx, f32 sy, bool selected) {
+    stats_.samples++;
+    auto& a = armies_[army_slot(army)];
+    a.seen++;
+    const u64 cell = make_key(cell_coord(sx), cell_coord(sy));
+
+    auto [it, inserted] = a.units.try_emplace(id);
+    Slot& s = it->second;
+    if (!inserted && s.frame == frame_) {
+        // Added twice in one frame: the second sample wins
+        a.seen--;
+    }
+    if (inserted || s.cell != cell || s.type != type || s.selected != selected) {
+        if (!inserted) bin_remove(a, id, s);
+        s.cell = cell;
+        s.type = type;
+        s.selected = selected;
+        bin_add(a, id, s);
+        stats_.moved++;
+    }
+    s.sx = sx;
+    s.sy = sy;
+    s.frame = frame_;
+}
+
+void IconClusterer::end_frame() {
+    for (auto& a : armies_) {
+        if (a.seen == a.units.size()) continue;
+        for (auto it = a.units.begin(); it != a.units.end();) {
+            if (it->second.frame == frame_) {
+                ++it;
+                continue;
+            }
+            bin_remove(a, it->first, it->second);
+            it = a.units.erase(it);
+            stats_.removed++;
+        }
+    }
+}
+
+void IconClusterer::bin_add(ArmyBins& a, u32 id, const Slot& s) {
+    Bin& b = a.cells[s.cell];
+    b.count++;
+    b.selected += s.selected ? 1 : 0;
+    b.id_xor ^= id;
+    b.types[static_cast<u32>(s.type)]++;
+}
+
+void IconClusterer::bin_remove(ArmyBins& a, u32 id, const Slot& s) {
+    auto it = a.cells.find(s.cell);
+    if (it == a.cells.end()) return;
+    Bin& b = it->second;
+    if (--b.count == 0) {
+        a.cells.erase(it);
+        return;
+    }
+    b.selected -= s.selected ? 1 : 0;
+    b.id_xor ^= id;
+    b.types[static_cast<u32>(s.type)]--;
+}
+
+const std::vector<IconCluster>& IconClusterer::build(u32 min_level, u32 max_quads) {
+    u32 level = std::min(min_level, MAX_LEVEL);
+    for (;;) {
+        build_level(level);
+        u32 quads = 0;
+        for (const auto& c : clusters_) quads += quad_count(c);
+        if (quads <= max_quads || level == MAX_LEVEL) break;
+        ++level;
+    }
+    level_ = level;
+    return clusters_;
+}
+
+void IconClusterer::build_level(u32 level) {
+    constexpr size_t SLOTS = MAX_ARMIES + 1;
+    cluster_of_.clear();
+    cluster_key_.clear();
+    cluster_army_.clear();
+    cluster_types_.clear();
+    cluster_cx_.clear();
+    cluster_cy_.clear();
+    clusters_.clear();
+
+    for (size_t slot = 0; slot < SLOTS; ++slot) {
+        const auto& a = armies_[slot];
+        for (const auto& [cell, bin] : a.cells) {
+            const u64 key = make_key(key_x(cell) >> level, key_y(cell) >> level);
+            auto [it, inserted] =
+                cluster_of_.try_emplace(key, static_cast<u32>(cluster_key_.size()));
+            const u32 ci = it->second;
+            if (inserted) {
+                cluster_key_.push_back(key);
+                cluster_army_.resize(cluster_army_.size() + SLOTS, 0);
+                cluster_types_.resize(cluster_types_.size() + ICON_TYPE_COUNT, 0);
+                cluster_cx_.push_back(0);
+                cluster_cy_.push_back(0);
+                clusters_.emplace_back();
+            }
+            auto& c = clusters_[ci];
+            c.count += bin.count;
+            c.selected |= bin.selected > 0;
+            cluster_army_[ci * SLOTS + slot] += bin.count;
+            for (u32 t = 0; t < ICON_TYPE_COUNT; ++t)
+                cluster_types_[ci * ICON_TYPE_COUNT + t] += bin.types[t];
+            const f32 w = static_cast<f32>(bin.count);
+            cluster_cx_[ci] += cell_center(key_x(cell)) * w;
+            cluster_cy_[ci] += cell_center(key_y(cell)) * w;
+            if (c.count == 1) {
+                // Only member so far: place it exactly
+                const auto& s = a.units.at(bin.id_xor);
+                c.sx = s.sx;
+                c.sy = s.sy;
+            }
+        }
+    }
+
+    for (size_t ci = 0; ci < clusters_.size(); ++ci) {
+        auto& c = clusters_[ci];
+        if (c.count > 1) {
+            c.sx = cluster_cx_[ci] / static_cast<f32>(c.count);
+            c.sy = cluster_cy_[ci] / static_cast<f32>(c.count);
+        }
+        // Dominant army: most units, ties to the lower army, no-army last
+        const u32* armies = &cluster_army_[ci * SLOTS];
+        size_t best = 0;
+        for (size_t slot = 1; slot < SLOTS; ++slot)
+            if (armies[slot] > armies[best] || (best == 0 && armies[slot] == armies[0]))
+                best = slot;
+        c.army = best == 0 ? -1 : static_cast<i32>(best) - 1;
+        // Dominant type: ties to the lower type
+        const u32* types = &cluster_types_[ci * ICON_TYPE_COUNT];
+        u32 best_type = 0;
+        for (u32 t = 1; t < ICON_TYPE_COUNT; ++t)
+            if (types[t] > types[best_type]) best_type = t;
+        c.type = static_cast<StrategicIconType>(best_type);
+    }
+
+    // Row-major screen order, so output does not depend on hash order
+    order_.resize(clusters_.size());
+    for (u32 i = 0; i < order_.size(); ++i) order_[i] = i;
+    std::sort(order_.begin(), order_.end(), [&](u32 l, u32 r) {
+        return cluster_key_[l] < cluster_key_[r];
+    });
+    std::vector<IconCluster> sorted;
+    sorted.reserve(clusters_.size());
+    for (u32 i : order_) sorted.push_back(clusters_[i]);
+    clusters_.swap(sorted);
+}
+
+void IconClusterer::clear() {
+    for (auto& a : armies_) {
+        a.units.clear();
+        a.cells.clear();
+        a.seen = 0;
+    }
+    clusters_.clear();
+}
+
+size_t IconClusterer::unit_count() const {
+    size_t n = 0;
+    for (const auto& a : armies_) n += a.units.size();
+    return n;
+}
+
+// --- Quad layout ---
+
+u32 build_icon_quads(const std::vector<IconCluster>& clusters, f32 icon_size,
+                     const IconPalette& palette, u32 max_quads,
+                     std::vector<IconQuad>& out) {
+    out.clear();
+    const f32 half = icon_size * 0.5f;
+
+    // Pass 1: selection rings (white texture, behind icons). Limit rings
+    // to half the budget so icons always have room.
+    const u32 max_rings = max_quads / 2;
+    for (const auto& c : clusters) {
+        if (!c.selected) continue;
+        if (out.size() >= max_rings) break;
+        f32 ring_size = icon_size + 4.0f;
+        f32 ring_half = ring_size * 0.5f;
+        push_quad(out, c.sx - ring_half, c.sy - ring_half, ring_size, ring_size,
+                  0.0f, 1.0f, 0.2f, 1.0f, 0.2f, 0.5f);
+    }
+    const u32 ring_count = static_cast<u32>(out.size());
+
+    // Pass 2: icons and count badges (atlas)
+    const f32 digit = icon_size * 0.6f;
+    const f32 advance = digit * 0.5f; // glyphs fill the middle of their cell
+    for (const auto& c : clusters) {
+        const u32 digits = badge_digits(c.count);
+        if (out.size() + 1 + digits > max_quads) break;
+
+        f32 r = 0.7f, g = 0.7f, b = 0.7f;
+        if (c.army >= 0 && c.army < IconClusterer::MAX_ARMIES) {
+            const auto& rgb = palette[static_cast<size_t>(c.army)];
+            r = rgb[0]; g = rgb[1]; b = rgb[2];
+        }
+        if (c.selected) {
+            r = r * 0.5f + 0.5f;
+            g = g * 0.5f + 0.5f;
+            b = b * 0.5f + 0.5f;
+        }
+        const u32 cell = static_cast<u32>(c.type);
+        push_quad(out, c.sx - half, c.sy - half, icon_size, icon_size,
+                  atlas_u(cell), atlas_u(cell + 1), r, g, b, 1.0f);
+
+        if (digits == 0) continue;
+        // Badge over the top-right corner, right-aligned
+        char text[8];
+        u32 n = std::min(c.count, MAX_BADGE);
+        for (u32 i = digits; i-- > 0;) {
+            text[i] = static_cast<char>('0' + n % 10);
+            n /= 10;
+        }
+        const f32 bx = c.sx + half + advance * 0.5f -
+                       static_cast<f32>(digits) * advance;
+        const f32 by = c.sy - half - digit * 0.25f;
+        for (u32 i = 0; i < digits; ++i) {
+            const u32 dcell = ICON_DIGIT_FIRST_CELL + static_cast<u32>(text[i] - '0');
+            const f32 x = bx + static_cast<f32>(i) * advance - (digit - advance) * 0.5f;
+            push_quad(out, x, by, digit, digit, atlas_u(dcell), atlas_u(dcell + 1),
+                      1.0f, 1.0f, 1.0f, 1.0f);
+        }
+    }
+    return ring_count;
+}
+
+} // namespace osc::renderer
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+namespace osc::renderer {
+
+/// Icon types derived from unit categories.
+enum class StrategicIconType : u8 {
+    Land = 0,
+    Air,
+    Naval,
+    Engineer,
+    Commander,
+    Structure,
+    Generic,
+    COUNT
+};
+
+inline constexpr u32 ICON_TYPE_COUNT = static_cast<u32>(StrategicIconType::COUNT);
+
+/// Strategic icon atlas layout: one row of square cells, the icon shapes in
+/// StrategicIconType order followed by the digits 0-9 of the count badges.
+inline constexpr u32 ICON_DIGIT_FIRST_CELL = ICON_TYPE_COUNT;
+inline constexpr u32 ICON_ATLAS_COLS = ICON_TYPE_COUNT + 10;
+
+/// Every icon quad is drawn as two triangles, without an index buffer.
+inline constexpr u32 ICON_VERTICES_PER_QUAD = 6;
+
+/// Project a world position to screen pixels through a view-projection
+/// matrix (column-major). False when the point is behind the camera.
+bool world_to_screen(f32 wx, f32 wy, f32 wz, const std::array<f32, 16>& vp,
+                     f32 screen_w, f32 screen_h, f32& out_x, f32& out_y);
+
+/// Icons merged into one screen cell: drawn as one icon in the colour of
+/// the army with the most units and the shape of the most common type,
+/// with a count badge when more than one unit is inside.
+struct IconCluster {
+    f32 sx = 0, sy = 0; ///< unit position for a single unit, else the
+                        ///< count-weighted centre of the occupied cells
+    u32 count = 0;
+    i32 army = -1;
+    StrategicIconType type = StrategicIconType::Generic;
+    bool selected = false; ///< any member is selected
+};
+
+/// Screen-space grid aggregation of strategic icons.
+///
+/// Units are binned into a fine base grid (BASE_CELL_PX), per army. A unit
+/// keeps its cell between frames, so a frame only touches the bins of
+/// units that crossed a cell edge, changed type or selection, or left the
+/// view; a still camera over a mostly still army costs one projection and
+/// one lookup per unit. Clusters are built from the non-empty base cells
+/// at a coarser level (cells of BASE_CELL_PX << level), picked from the
+/// icon size and raised until the quads fit the budget.
+class IconClusterer {
+public:
+    static constexpr f32 BASE_CELL_PX = 8.0f;
+    static constexpr u32 MAX_LEVEL = 6;
+    static constexpr i32 MAX_ARMIES = 16;
+
+    /// Finest level whose cells are at least one icon wide, so icons that
+    /// would overlap share a cell.
+    static u32 level_for_icon(f32 icon_size);
+
+    /// Quads a cluster draws: selection ring, icon, badge digits.
+    static u32 quad_count(const IconCluster& c);
+
+    void begin_frame();
+
+    /// Record a unit's screen position for this frame. Call once per
+    /// visible unit between begin_frame() and end_frame().
+    void add(u32 id, i32 army, StrategicIconType type, f32 sx, f32 sy,
+             bool selected);
+
+    /// Drop units that were not added this frame.
+    void end_frame();
+
+    /// Clusters at `min_level` or the first coarser level whose quads fit
+    /// `max_quads`, ordered by screen cell (row-major). The reference is
+    /// valid until the next build().
+    const std::vector<IconCluster>& build(u32 min_level, u32 max_quads);
+
+    /// Level used by the last build().
+    u32 level() const { return level_; }
+
+    void clear();
+    size_t unit_count() const;
+
+    struct Stats {
+        u64 frames = 0;
+        u64 samples = 0; ///< units added
+        u64 moved = 0;   ///< units that changed bin (including new ones)
+        u64 removed = 0; ///< units dropped by end_frame()
+    };
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Slot {
+        u64 cell;
+        f32 sx, sy;
+        u32 frame;
+        StrategicIconType type;
+        bool selected;
+    };
+    struct Bin {
+        u32 count = 0;
+        u32 selected = 0;
+        u32 id_xor = 0; ///< the remaining member's id when count == 1
+        u32 types[ICON_TYPE_COUNT] = {};
+    };
+    struct ArmyBins {
+        std::unordered_map<u32, Slot> units;
+        std::unordered_map<u64, Bin> cells;
+        u32 seen = 0; ///< units added this frame
+    };
+
+    void bin_add(ArmyBins& a, u32 id, const Slot& s);
+    void bin_remove(ArmyBins& a, u32 id, const Slot& s);
+    void build_level(u32 level);
+
+    /// Slot 0 holds units without a valid army.
+    std::array<ArmyBins, MAX_ARMIES + 1> armies_;
+    u32 frame_ = 0;
+    u32 level_ = 0;
+
+    // build() scratch
+    std::unordered_map<u64, u32> cluster_of_;
+    std::vector<u64> cluster_key_;
+    std::vector<u32> cluster_army_;  ///< per cluster, MAX_ARMIES + 1 counts
+    std::vector<u32> cluster_types_; ///< per cluster, ICON_TYPE_COUNT counts
+    std::vector<f32> cluster_cx_, cluster_cy_;
+    std::vector<u32> order_;
+    std::vector<IconCluster> clusters_;
+
+    Stats stats_;
+};
+
+/// One textured quad for the UI pipeline (same fields as UIInstance).
+struct IconQuad {
+    f32 rect[4];  // x, y, w, h in pixels
+    f32 uv[4];    // u0, v0, u1, v1
+    f32 color[4]; // r, g, b, a
+};
+
+/// Army colours by army index (entries beyond MAX_ARMIES are unused).
+using IconPalette = std::array<std::array<f32, 3>, IconClusterer::MAX_ARMIES>;
+
+/// Lay out the quads for `clusters` into `out`: selection rings first (at
+/// most half of `max_quads`), then icons with their count badges. Returns
+/// the number of rings; stops at `max_quads` in total.
+u32 build_icon_quads(const std::vector<IconCluster>& clusters, f32 icon_size,
+                     const IconPalette& palette, u32 max_quads,
+                     std::vector<IconQuad>& out);
+
+} // namespace osc::renderer
@@ -3,6 +3,7 @@
 
 #include "sim/sim_state.hpp"
 #include "sim/entity.hpp"
+#include "sim/formation.hpp"
 #include "sim/unit.hpp"
 #include "sim/unit_command.hpp"
 #include "map/terrain.hpp"
@@ -107,16 +108,17 @@ void InputHandler::update(Renderer& renderer, sim::SimState& sim,
 
             bool shift = renderer.is_key_pressed(GLFW_KEY_LEFT_SHIFT) ||
                          renderer.is_key_pressed(GLFW_KEY_RIGHT_SHIFT);
+            sim::UnitCommand cmd;
+            cmd.type = sim::CommandType::Move;
+            cmd.target_pos = {mm_wx, wy, mm_wz};
+            cmd.command_id = sim.next_command_id();
+            // One payload for the whole selection
+            sim::CommandGroup group(sim.command_store(), cmd);
             for (u32 uid : selected_) {
                 auto* e = sim.entity_registry().find(uid);
                 if (!e || !e->is_unit() || e->destroyed()) continue;
                 auto* unit = static_cast<sim::Unit*>(e);
-
-                sim::UnitCommand cmd;
-                cmd.type = sim::CommandType::Move;
-                cmd.target_pos = {mm_wx, wy, mm_wz};
-                cmd.command_id = sim.next_command_id();
-                unit->push_command(cmd, !shift); // shift-click queues without clearing
+                unit->push_command(group, !shift); // shift-click queues without clearing
             }
             spdlog::debug("Minimap move: {} units to ({:.0f},{:.0f})",
                           selected_.size(), mm_wx, mm_wz);
@@ -227,23 +229,39 @@ void InputHandler::handle_right_click(Renderer& renderer,
     bool shift = renderer.is_key_pressed(GLFW_KEY_LEFT_SHIFT) ||
                  renderer.is_key_pressed(GLFW_KEY_RIGHT_SHIFT);
 
-    // Issue commands to all selected units
+    // Group move to ground: keep formation instead of converging on one
+    // point. Planning searches paths, so the sim does it on its next tick.
+    if (enemy_id == 0 && selected_.size() > 1) {
+        sim::SimState::FormationMoveOrder order;
+        order.unit_ids.assign(selected_.begin(), selected_.end());
+        std::sort(order.unit_ids.begin(), order.unit_ids.end()); // set order varies
+        order.goal = {wx, wy, wz};
+        order.shape = sim::FormationShape::Growth;
+        order.command_id = sim.next_command_id();
+        order.clear_existing = !shift;
+        sim.queue_formation_move(std::move(order));
+        spdlog::debug("Right-click: formation move to {} units at ({:.0f},{:.0f})",
+                      selected_.size(), wx, wz);
+        return;
+    }
+
+    // Issue one shared command to all selected units
+    sim::UnitCommand cmd;
+    if (enemy_id != 0) {
+        cmd.type = sim::CommandType::Attack;
+        cmd.target_id = enemy_id;
+        cmd.target_pos = {wx, wy, wz};
+    } else {
+        cmd.type = sim::CommandType::Move;
+        cmd.target_pos = {wx, wy, wz};
+    }
+    cmd.command_id = sim.next_command_id();
+    sim::CommandGroup group(sim.command_store(), cmd);
     for (u32 uid : selected_) {
         auto* e = sim.entity_registry().find(uid);
         if (!e || !e->is_unit() || e->destroyed()) continue;
         auto* unit = static_cast<sim::Unit*>(e);
-
-        sim::UnitCommand cmd;
-        if (enemy_id != 0) {
-            cmd.type = sim::CommandType::Attack;
-            cmd.target_id = enemy_id;
-            cmd.target_pos = {wx, wy, wz};
-        } else {
-            cmd.type = sim::CommandType::Move;
-            cmd.target_pos = {wx, wy, wz};
-        }
-        cmd.command_id = sim.next_command_id();
-        unit->push_command(cmd, !shift); // shift-click queues without clearing
+        unit->push_command(group, !shift); // shift-click queues without clearing
     }
 
     spdlog::debug("Right-click: {} to {} units at ({:.0f},{:.0f})",
@@ -0,0 +1,179 @@
+#include "renderer/instance_culling.hpp"
+#include "renderer/frustum.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace osc::renderer {
+
+static_assert(sizeof(CullInstance) == 112, "CullInstance must match std430");
+static_assert(sizeof(CullLODSet) == 8, "CullLODSet must match std430");
+static_assert(sizeof(CullLOD) == 8, "CullLOD must match std430");
+static_assert(sizeof(DrawIndexedIndirect) == 20,
+              "DrawIndexedIndirect must match VkDrawIndexedIndirectCommand");
+static_assert(sizeof(CulledInstance) == 96, "CulledInstance must match MeshInstance");
+static_assert(sizeof(CullParams) <= 128, "CullParams exceeds the push constant minimum");
+
+u32 CullScene::add_set(const std::vector<f32>& cutoffs,
+                       const std::vector<u32>& index_counts) {
+    CullLODSet set;
+    set.first_lod = static_cast<u32>(lods_.size());
+    set.lod_count = static_cast<u32>(cutoffs.size());
+    for (size_t i = 0; i < cutoffs.size(); ++i) {
+        lods_.push_back({cutoffs[i], 0});
+        DrawIndexedIndirect draw;
+        draw.index_count = i < index_counts.size() ? index_counts[i] : 0;
+        draws_.push_back(draw);
+    }
+    sets_.push_back(set);
+    set_instances_.push_back(0);
+    layout_changed_ = true;
+    return static_cast<u32>(sets_.size() - 1);
+}
+
+u32 CullScene::add_instance(const CullInstance& inst) {
+    u32 index = static_cast<u32>(instances_.size());
+    instances_.push_back(inst);
+    set_instances_[inst.lod_set]++;
+    dirty_.push_back(index);
+    layout_changed_ = true;
+    return index;
+}
+
+void CullScene::update_instance(u32 index, const CullInstance& inst) {
+    u32 old_set = instances_[index].lod_set;
+    if (inst.lod_set != old_set) {
+        set_instances_[old_set]--;
+        set_instances_[inst.lod_set]++;
+        layout_changed_ = true;
+    }
+    instances_[index] = inst;
+    dirty_.push_back(index);
+}
+
+u32 CullScene::remove_instance(u32 index) {
+    set_instances_[instances_[index].lod_set]--;
+    layout_changed_ = true;
+    u32 last = static_cast<u32>(instances_.size() - 1);
+    if (index == last) {
+        instances_.pop_back();
+        return NO_INSTANCE;
+    }
+    instances_[index] = instances_[last];
+    instances_.pop_back();
+    dirty_.push_back(index);
+    return last;
+}
+
+void CullScene::take_dirty(std::vector<u32>& out) {
+    out.insert(out.end(), dirty_.begin(), dirty_.end());
+    dirty_.clear();
+}
+
+void CullScene::finalize() {
+    u32 offset = 0;
+    for (size_t s = 0; s < sets_.size(); ++s) {
+        const auto& set = sets_[s];
+        for (u32 k = 0; k < set.lod_count; ++k) {
+            lods_[set.first_lod + k].first_instance = offset;
+            offset += set_instances_[s];
+        }
+    }
+    output_capacity_ = offset;
+    layout_changed_ = false;
+    layout_revision_++;
+}
+
+void CullScene::clear() {
+    instances_.clear();
+    sets_.clear();
+    lods_.clear();
+    draws_.clear();
+    set_instances_.clear();
+    dirty_.clear();
+    output_capacity_ = 0;
+    layout_changed_ = false;
+    layout_revision_++;
+}
+
+CullParams make_cull_params(const Frustum* frustum, const f32* eye,
+                            u32 instance_count) {
+    CullParams params;
+    for (u32 i = 0; i < 6; ++i) {
+        if (frustum) {
+            auto p = frustum->plane(i);
+            std::memcpy(params.planes[i], p.data(), sizeof(params.planes[i]));
+        } else {
+            params.planes[i][3] = 1.0f;
+        }
+    }
+    if (eye) {
+        params.eye[0] = eye[0];
+        params.eye[1] = eye[1];
+        params.eye[2] = eye[2];
+        params.eye[3] = 1.0f;
+    }
+    params.instance_count = instance_count;
+    return params;
+}
+
+u32 cull_instances(const CullScene& scene, const CullParams& params,
+                   std::vector<DrawIndexedIndirect>& draws,
+                   std::vector<CulledInstance>& out) {
+    draws = scene.draws();
+    out.resize(scene.output_capacity());
+
+    const auto& instances = scene.instances();
+    const auto& sets = scene.sets();
+    const auto& lods = scene.lods();
+    u32 visible = 0;
+    u32 count = std::min<u32>(params.instance_count,
+                              static_cast<u32>(instances.size()));
+    for (u32 i = 0; i < count; ++i) {
+        const auto& inst = instances[i];
+        const f32* s = inst.sphere;
+
+        bool inside = true;
+        for (const auto& p : params.planes) {
+            if (p[0] * s[0] + p[1] * s[1] + p[2] * s[2] + p[3] < -s[3]) {
+                inside = false;
+                break;
+            }
+        }
+        if (!inside) continue;
+
+        f32 dist = 0.0f;
+        if (params.eye[3] != 0.0f) {
+            f32 dx = s[0] - params.eye[0];
+            f32 dy = s[1] - params.eye[1];
+            f32 dz = s[2] - params.eye[2];
+            dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+        }
+
+        // Same walk as MeshCache::get_lod: first level whose cutoff
+        // reaches, else the coarsest
+        const auto& set = sets[inst.lod_set];
+        if (set.lod_count == 0) continue;
+        u32 level = set.lod_count - 1;
+        for (u32 k = 0; k < set.lod_count; ++k) {
+            f32 cutoff = lods[set.first_lod + k].cutoff;
+            if (cutoff == 0.0f || cutoff >= dist) {
+                level = k;
+                break;
+            }
+        }
+
+        u32 lod = set.first_lod + level;
+        u32 slot = draws[lod].instance_count++;
+        auto& dst = out[lods[lod].first_instance + slot];
+        std::memcpy(dst.model, inst.model, sizeof(dst.model));
+        std::memcpy(dst.color, inst.color, sizeof(dst.color));
+        dst.bone_base = inst.bone_base;
+        dst.bone_count = inst.bone_count;
+        visible++;
+    }
+    return visible;
+}
+
+} // namespace osc::renderer
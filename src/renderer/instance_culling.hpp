@@ -0,0 +1,150 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <vector>
+
+namespace osc::renderer {
+
+class Frustum; // forward
+
+// Data layouts shared with the instance_cull compute shader (std430).
+// The shader and cull_instances() below implement the same test; keep
+// them in step.
+
+/// Persistent per-instance record, uploaded when it changes.
+struct CullInstance {
+    f32 model[16];      // column-major model matrix
+    f32 color[4];       // army color + alpha
+    f32 sphere[4];      // world-space bounding sphere: center xyz, radius w
+    u32 lod_set = 0;    // index into CullScene::sets()
+    u32 bone_base = 0;  // first matrix in the bone SSBO
+    u32 bone_count = 0; // 0 = not skinned
+    u32 pad = 0;
+};
+
+/// A blueprint's LOD chain: lods[first_lod .. first_lod + lod_count),
+/// sorted by cutoff ascending like LODSet.
+struct CullLODSet {
+    u32 first_lod = 0;
+    u32 lod_count = 0;
+};
+
+/// One LOD level. Level i owns draw command i and the output range
+/// [first_instance, first_instance + instance count of its set).
+struct CullLOD {
+    f32 cutoff = 0.0f; // max camera distance (0 = no limit)
+    u32 first_instance = 0;
+};
+
+/// Mirror of VkDrawIndexedIndirectCommand. first_instance stays 0: the
+/// output range is selected with the instance vertex-buffer offset, which
+/// does not need the drawIndirectFirstInstance feature.
+struct DrawIndexedIndirect {
+    u32 index_count = 0;
+    u32 instance_count = 0;
+    u32 first_index = 0;
+    i32 vertex_offset = 0;
+    u32 first_instance = 0;
+};
+
+/// Compacted output record; same layout as MeshInstance, so the mesh
+/// pipelines read it as their per-instance vertex binding.
+struct CulledInstance {
+    f32 model[16];
+    f32 color[4];
+    u32 bone_base;
+    u32 bone_count;
+    u32 pad[2];
+};
+
+/// Push constants of the culling shader.
+struct CullParams {
+    f32 planes[6][4] = {}; // normalized frustum planes; (0,0,0,1) keeps all
+    f32 eye[4] = {};       // camera position; w = 0 selects the finest LOD
+    u32 instance_count = 0;
+};
+
+/// Culling inputs: the persistent records plus the LOD and draw tables
+/// they index. Records are added, changed and removed one at a time as
+/// entities come and go or move; the tables only change when a set gains
+/// or loses instances (finalize()), and their size follows the number of
+/// LOD levels, not of instances.
+class CullScene {
+public:
+    static constexpr u32 NO_INSTANCE = ~0u;
+
+    /// Add a LOD chain; `cutoffs` and `index_counts` are per level, finest
+    /// first. Returns the set index for CullInstance::lod_set.
+    u32 add_set(const std::vector<f32>& cutoffs,
+                const std::vector<u32>& index_counts);
+
+    /// Add an instance of an existing set. Returns its record index.
+    u32 add_instance(const CullInstance& inst);
+
+    /// Overwrite record `index` (it may change set).
+    void update_instance(u32 index, const CullInstance& inst);
+
+    /// Remove record `index`; the last record moves into its place so the
+    /// records stay dense. Returns the old index of the moved record, or
+    /// NO_INSTANCE if `index` was the last one.
+    u32 remove_instance(u32 index);
+
+    /// Assign each LOD level its output range. Call once the records are
+    /// in place and again whenever layout_changed().
+    void finalize();
+
+    /// A set gained or lost instances (or a set was added) since the last
+    /// finalize(), so the output ranges no longer fit.
+    bool layout_changed() const { return layout_changed_; }
+
+    /// Bumped by every finalize(); the sets, LODs and draws change only then.
+    u32 layout_revision() const { return layout_revision_; }
+
+    /// Append the indices of records added, changed or moved since the
+    /// last call, and forget them. Duplicates are possible.
+    void take_dirty(std::vector<u32>& out);
+
+    void clear();
+
+    const std::vector<CullInstance>& instances() const { return instances_; }
+    const std::vector<CullLODSet>& sets() const { return sets_; }
+    const std::vector<CullLOD>& lods() const { return lods_; }
+
+    /// Draw commands with instance_count = 0, one per LOD level; reset the
+    /// GPU copy from this every frame before culling.
+    const std::vector<DrawIndexedIndirect>& draws() const { return draws_; }
+
+    /// Records currently in `set`.
+    u32 set_instance_count(u32 set) const { return set_instances_[set]; }
+
+    /// Output records needed: every level can take every instance of its set.
+    u32 output_capacity() const { return output_capacity_; }
+
+private:
+    std::vector<CullInstance> instances_;
+    std::vector<CullLODSet> sets_;
+    std::vector<CullLOD> lods_;
+    std::vector<DrawIndexedIndirect> draws_;
+    std::vector<u32> set_instances_;
+    std::vector<u32> dirty_;
+    u32 output_capacity_ = 0;
+    u32 layout_revision_ = 0;
+    bool layout_changed_ = false;
+};
+
+/// Culling parameters for a frame. A null frustum keeps every instance;
+/// a null eye selects the finest LOD, as MeshCache::get_lod does without
+/// a camera.
+CullParams make_cull_params(const Frustum* frustum, const f32* eye,
+                            u32 instance_count);
+
+/// CPU reference of the culling shader: frustum test, LOD selection and
+/// compaction into `draws` (reset from scene.draws()) and `out` (sized to
+/// output_capacity()). Output order within a draw differs from the GPU,
+/// where slots come from atomics. Returns the number of visible instances.
+u32 cull_instances(const CullScene& scene, const CullParams& params,
+                   std::vector<DrawIndexedIndirect>& draws,
+                   std::vector<CulledInstance>& out);
+
+} // namespace osc::renderer
@@ -1,11 +1,11 @@
 #include "renderer/mesh_cache.hpp"
-#include "sim/scm_parser.hpp"
 #include "blueprints/blueprint_store.hpp"
 #include "vfs/virtual_file_system.hpp"
 
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <cstring>
 
 extern "C" {
 #include "lua.h"
@@ -29,6 +29,48 @@ void MeshCache::init(VkDevice device, VmaAllocator allocator,
     queue_ = queue;
     vfs_ = vfs;
     store_ = store;
+
+    loader_ = std::make_unique<MeshLoader>(
+        [vfs](const std::string& path) -> std::optional<std::vector<char>> {
+            if (!vfs) return std::nullopt;
+            return vfs->read_file(path);
+        });
+    create_upload_resources();
+}
+
+void MeshCache::create_upload_resources() {
+    VkBufferCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    ci.size = STAGING_RING_BYTES;
+    ci.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+    VmaAllocationCreateInfo alloc_ci{};
+    alloc_ci.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+    alloc_ci.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VmaAllocationInfo info{};
+    if (vmaCreateBuffer(allocator_, &ci, &alloc_ci, &staging_.buffer,
+                        &staging_.allocation, &info) != VK_SUCCESS) {
+        spdlog::warn("MeshCache: staging ring allocation failed, "
+                     "uploads will block");
+        staging_ = {};
+    } else {
+        staging_mapped_ = static_cast<u8*>(info.pMappedData);
+    }
+
+    VkCommandBufferAllocateInfo cmd_ai{};
+    cmd_ai.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    cmd_ai.commandPool = cmd_pool_;
+    cmd_ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmd_ai.commandBufferCount = 1;
+
+    VkFenceCreateInfo fence_ci{};
+    fence_ci.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    for (auto& batch : batches_) {
+        vkAllocateCommandBuffers(device_, &cmd_ai, &batch.cmd);
+        vkCreateFence(device_, &fence_ci, nullptr, &batch.fence);
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -44,7 +86,7 @@ const GPUMesh* MeshCache::get_lod(const std::string& blueprint_id,
                                    f32 camera_distance, lua_State* L) {
     if (device_ == VK_NULL_HANDLE) return nullptr;
 
-    // Check if already loaded
+    // Check if already loaded (or loading: the LODs uploaded so far)
     auto it = lod_cache_.find(blueprint_id);
     if (it != lod_cache_.end()) {
         const auto& lods = it->second.lods;
@@ -62,14 +104,17 @@ const GPUMesh* MeshCache::get_lod(const std::string& blueprint_id,
 
     if (failed_.count(blueprint_id)) return nullptr;
 
-    // Try loading all LODs
-    if (!load_lod_set(blueprint_id, L)) {
+    // Resolve the LOD descriptors here, where Lua may be used; the loader
+    // workers only see the descriptor.
+    auto set = resolve_mesh_set(blueprint_id, L);
+    if (!set) {
         failed_.insert(blueprint_id);
         return nullptr;
     }
-
-    // Recurse once now that lod_cache_ is populated
-    return get_lod(blueprint_id, camera_distance, L);
+    loader_->submit(*set);
+    loading_.insert(blueprint_id);
+    lod_cache_[blueprint_id].lods.reserve(set->lods.size());
+    return nullptr;
 }
 
 const LODSet* MeshCache::get_lod_set(const std::string& blueprint_id) const {
@@ -78,140 +123,271 @@ const LODSet* MeshCache::get_lod_set(const std::string& blueprint_id) const {
     return nullptr;
 }
 
+bool MeshCache::loading(const std::string& blueprint_id) const {
+    return loading_.count(blueprint_id) != 0;
+}
+
 // ---------------------------------------------------------------------------
-// LOD loading
+// Uploads
 // ---------------------------------------------------------------------------
 
-GPUMesh MeshCache::upload_scm_mesh(const std::string& mesh_path) {
-    GPUMesh result{};
-
-    auto file_data = vfs_->read_file(mesh_path);
-    if (!file_data) {
-        spdlog::debug("MeshCache: VFS read failed for '{}'", mesh_path);
-        return result;
+void MeshCache::flush_uploads() {
+    if (!loader_ || loading_.empty()) return;
+
+    reclaim_batches(false);
+    auto& batch = batches_[batch_index_];
+    if (batch.in_flight) return; // both batches still on the GPU
+
+    loader_->drain([this](ParsedLOD& lod) { return stage_lod(lod); });
+
+    if (batch.recording) {
+        // Make the copies visible to vertex input in every later submission
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+                                VK_ACCESS_INDEX_READ_BIT;
+        vkCmdPipelineBarrier(batch.cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0,
+                             1, &barrier, 0, nullptr, 0, nullptr);
+        vkEndCommandBuffer(batch.cmd);
+
+        VkSubmitInfo submit{};
+        submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit.commandBufferCount = 1;
+        submit.pCommandBuffers = &batch.cmd;
+        vkQueueSubmit(queue_, 1, &submit, batch.fence);
+        batch.recording = false;
+        batch.in_flight = true;
+        batch_index_ = (batch_index_ + 1) % UPLOAD_BATCHES;
+    }
+
+    // Retire blueprints whose last LOD has landed
+    for (auto it = loading_.begin(); it != loading_.end(); ) {
+        if (loader_->pending(*it) != 0) { ++it; continue; }
+        auto set = lod_cache_.find(*it);
+        if (set == lod_cache_.end() || set->second.lods.empty()) {
+            if (failed_.size() < 5)
+                spdlog::info("MeshCache: no loadable mesh for '{}' (cube fallback)", *it);
+            else
+                spdlog::debug("MeshCache: no loadable mesh for '{}'", *it);
+            if (set != lod_cache_.end()) lod_cache_.erase(set);
+            failed_.insert(*it);
+        } else {
+            spdlog::debug("MeshCache: loaded '{}' with {} LOD level(s)",
+                          *it, set->second.lods.size());
+        }
+        it = loading_.erase(it);
     }
+}
 
-    auto mesh = sim::parse_scm_mesh(*file_data);
-    if (!mesh || mesh->vertices.empty() || mesh->indices.empty()) {
-        spdlog::debug("MeshCache: SCM parse failed for '{}'", mesh_path);
-        return result;
+void MeshCache::finish_loading() {
+    if (!loader_) return;
+    while (!loading_.empty()) {
+        loader_->wait_parsed();
+        flush_uploads();
+        reclaim_batches(true);
     }
+}
+
+bool MeshCache::stage_lod(ParsedLOD& lod) {
+    if (!lod.ok()) return true; // nothing to upload; counts as done
+
+    const VkDeviceSize vb = lod.vertex_bytes(), ib = lod.index_bytes();
+    GPUMesh gpu{};
+    if (!staging_mapped_ || vb + ib > STAGING_RING_BYTES / 2) {
+        if (upload_lod_blocking(lod, gpu)) add_lod(lod, std::move(gpu));
+        return true;
+    }
+
+    auto offset = ring_alloc(vb + ib);
+    if (!offset) return false;
+
+    auto create = [&](VkDeviceSize size, VkBufferUsageFlags usage,
+                      AllocatedBuffer& out) {
+        VkBufferCreateInfo ci{};
+        ci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        ci.size = size;
+        ci.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        VmaAllocationCreateInfo alloc_ci{};
+        alloc_ci.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        return vmaCreateBuffer(allocator_, &ci, &alloc_ci, &out.buffer,
+                               &out.allocation, nullptr) == VK_SUCCESS;
+    };
+    if (!create(vb, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, gpu.vertex_buf)) {
+        spdlog::warn("MeshCache: vertex buffer allocation failed for '{}'",
+                     lod.desc.mesh_path);
+        return true;
+    }
+    if (!create(ib, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, gpu.index_buf)) {
+        vmaDestroyBuffer(allocator_, gpu.vertex_buf.buffer, gpu.vertex_buf.allocation);
+        spdlog::warn("MeshCache: index buffer allocation failed for '{}'",
+                     lod.desc.mesh_path);
+        return true;
+    }
+
+    std::memcpy(staging_mapped_ + *offset, lod.mesh.vertices.data(), vb);
+    std::memcpy(staging_mapped_ + *offset + vb, lod.indices.data(), ib);
+
+    auto& batch = batches_[batch_index_];
+    if (!batch.recording) {
+        vkResetCommandBuffer(batch.cmd, 0);
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(batch.cmd, &begin_info);
+        batch.recording = true;
+    }
+    VkBufferCopy copy{};
+    copy.srcOffset = *offset;
+    copy.size = vb;
+    vkCmdCopyBuffer(batch.cmd, staging_.buffer, gpu.vertex_buf.buffer, 1, &copy);
+    copy.srcOffset = *offset + vb;
+    copy.size = ib;
+    vkCmdCopyBuffer(batch.cmd, staging_.buffer, gpu.index_buf.buffer, 1, &copy);
+
+    add_lod(lod, std::move(gpu));
+    return true;
+}
 
-    auto vert_buf = upload_buffer(
+bool MeshCache::upload_lod_blocking(const ParsedLOD& lod, GPUMesh& out) {
+    out.vertex_buf = upload_buffer(
         device_, allocator_, cmd_pool_, queue_,
-        mesh->vertices.data(),
-        mesh->vertices.size() * sizeof(sim::SCMMesh::Vertex),
+        lod.mesh.vertices.data(), lod.vertex_bytes(),
         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-
-    if (!vert_buf.buffer) {
-        spdlog::warn("MeshCache: vertex upload failed for '{}'", mesh_path);
-        return result;
+    if (!out.vertex_buf.buffer) {
+        spdlog::warn("MeshCache: vertex upload failed for '{}'", lod.desc.mesh_path);
+        return false;
     }
-
-    auto idx_buf = upload_buffer(
+    out.index_buf = upload_buffer(
         device_, allocator_, cmd_pool_, queue_,
-        mesh->indices.data(),
-        mesh->indices.size() * sizeof(u32),
+        lod.indices.data(), lod.index_bytes(),
         VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
-
-    if (!idx_buf.buffer) {
-        vmaDestroyBuffer(allocator_, vert_buf.buffer, vert_buf.allocation);
-        spdlog::warn("MeshCache: index upload failed for '{}'", mesh_path);
-        return result;
+    if (!out.index_buf.buffer) {
+        vmaDestroyBuffer(allocator_, out.vertex_buf.buffer, out.vertex_buf.allocation);
+        spdlog::warn("MeshCache: index upload failed for '{}'", lod.desc.mesh_path);
+        return false;
     }
+    return true;
+}
 
-    result.vertex_buf = vert_buf;
-    result.index_buf = idx_buf;
-    result.index_count = static_cast<u32>(mesh->indices.size());
+void MeshCache::add_lod(const ParsedLOD& lod, GPUMesh&& gpu) {
+    gpu.index_count = static_cast<u32>(lod.indices.size());
+    gpu.quant = lod.mesh.quant;
+    gpu.uniform_scale = lod.uniform_scale;
+    gpu.texture_path = lod.desc.texture_path;
+    gpu.specteam_path = lod.desc.specteam_path;
+    gpu.normal_path = lod.desc.normal_path;
 
     spdlog::debug("MeshCache: uploaded '{}' ({} verts, {} indices)",
-                   mesh_path, mesh->vertices.size(), mesh->indices.size());
-    return result;
+                  lod.desc.mesh_path, lod.mesh.vertices.size(), lod.indices.size());
+
+    LODEntry entry;
+    entry.mesh = std::move(gpu);
+    entry.cutoff = lod.desc.cutoff;
+
+    // Keep sorted by cutoff ascending (highest detail / smallest cutoff
+    // first); 0 means "no limit" and sorts to the end
+    auto& lods = lod_cache_[lod.bp_id].lods;
+    auto pos = std::upper_bound(lods.begin(), lods.end(), entry,
+                                [](const LODEntry& a, const LODEntry& b) {
+                                    if (a.cutoff == 0.0f) return false;
+                                    if (b.cutoff == 0.0f) return true;
+                                    return a.cutoff < b.cutoff;
+                                });
+    lods.insert(pos, std::move(entry));
+}
+
+std::optional<VkDeviceSize> MeshCache::ring_alloc(VkDeviceSize size) {
+    size = (size + 15) & ~VkDeviceSize{15};
+    VkDeviceSize offset = ring_head_;
+    VkDeviceSize padding = 0;
+    if (offset + size > STAGING_RING_BYTES) {
+        padding = STAGING_RING_BYTES - offset; // skip the tail, wrap to 0
+        offset = 0;
+    }
+    if (ring_used_ + padding + size > STAGING_RING_BYTES) return std::nullopt;
+
+    ring_used_ += padding + size;
+    ring_head_ = offset + size;
+    batches_[batch_index_].bytes += padding + size;
+    return offset;
 }
 
-bool MeshCache::load_lod_set(const std::string& bp_id, lua_State* L) {
+void MeshCache::reclaim_batches(bool wait) {
+    for (u32 n = 0; n < UPLOAD_BATCHES; ++n) {
+        auto& batch = batches_[oldest_batch_];
+        if (!batch.in_flight) break;
+        if (wait) {
+            vkWaitForFences(device_, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+        } else if (vkGetFenceStatus(device_, batch.fence) != VK_SUCCESS) {
+            break;
+        }
+        vkResetFences(device_, 1, &batch.fence);
+        ring_used_ -= batch.bytes;
+        batch.bytes = 0;
+        batch.in_flight = false;
+        oldest_batch_ = (oldest_batch_ + 1) % UPLOAD_BATCHES;
+    }
+    if (ring_used_ == 0) ring_head_ = 0;
+}
+
+// ---------------------------------------------------------------------------
+// LOD resolution
+// ---------------------------------------------------------------------------
+
+std::optional<MeshSetDescriptor> MeshCache::resolve_mesh_set(
+        const std::string& bp_id, lua_State* L) {
     std::string mesh_bp_id = resolve_mesh_bp_id(bp_id, L);
     if (mesh_bp_id.empty()) {
         if (failed_.size() < 5)
             spdlog::info("MeshCache: no mesh blueprint for '{}' (cube fallback)", bp_id);
         else
             spdlog::debug("MeshCache: no mesh blueprint for '{}'", bp_id);
-        return false;
+        return std::nullopt;
     }
 
-    f32 scale = resolve_uniform_scale(bp_id, L);
-    LODSet lod_set;
+    MeshSetDescriptor set;
+    set.bp_id = bp_id;
+    set.uniform_scale = resolve_uniform_scale(bp_id, L);
 
     // Try LODs[1] through LODs[4] from the mesh blueprint
     for (i32 lod_index = 1; lod_index <= 4; ++lod_index) {
         std::string mesh_path = resolve_mesh_path_for_lod(mesh_bp_id, lod_index, L);
         if (mesh_path.empty()) continue;
 
-        GPUMesh gpu = upload_scm_mesh(mesh_path);
-        if (!gpu.vertex_buf.buffer) continue;
-
-        gpu.uniform_scale = scale;
-
         // Resolve textures for this LOD, falling back to LOD 1 textures
-        gpu.texture_path = resolve_albedo_path_for_lod(mesh_bp_id, lod_index, L);
-        gpu.specteam_path = resolve_specteam_path_for_lod(mesh_bp_id, lod_index, L);
-        gpu.normal_path = resolve_normal_path_for_lod(mesh_bp_id, lod_index, L);
-
-        f32 cutoff = read_lod_cutoff(mesh_bp_id, lod_index, L);
-
-        LODEntry entry;
-        entry.mesh = std::move(gpu);
-        entry.cutoff = cutoff;
-        lod_set.lods.push_back(std::move(entry));
+        LODDescriptor lod;
+        lod.mesh_path = std::move(mesh_path);
+        lod.texture_path = resolve_albedo_path_for_lod(mesh_bp_id, lod_index, L);
+        lod.specteam_path = resolve_specteam_path_for_lod(mesh_bp_id, lod_index, L);
+        lod.normal_path = resolve_normal_path_for_lod(mesh_bp_id, lod_index, L);
+        lod.cutoff = read_lod_cutoff(mesh_bp_id, lod_index, L);
+        set.lods.push_back(std::move(lod));
     }
 
     // If no LODs found with MeshName fields (common due to ExtractMeshBlueprint
     // overwriting LODs[1]), fall back to existing single-LOD loading
-    if (lod_set.lods.empty()) {
+    if (set.lods.empty()) {
         std::string mesh_path = resolve_mesh_path(bp_id, L);
         if (mesh_path.empty()) {
             if (failed_.size() < 5)
                 spdlog::info("MeshCache: no mesh path for '{}' (cube fallback)", bp_id);
             else
                 spdlog::debug("MeshCache: no mesh path for '{}'", bp_id);
-            return false;
-        }
-
-        GPUMesh gpu = upload_scm_mesh(mesh_path);
-        if (!gpu.vertex_buf.buffer) {
-            if (failed_.size() < 5)
-                spdlog::info("MeshCache: upload failed for '{}' (cube fallback)", mesh_path);
-            else
-                spdlog::debug("MeshCache: upload failed for '{}'", mesh_path);
-            return false;
+            return std::nullopt;
         }
 
-        gpu.uniform_scale = scale;
-        gpu.texture_path = resolve_albedo_path(bp_id, L);
-        gpu.specteam_path = resolve_specteam_path(bp_id, L);
-        gpu.normal_path = resolve_normal_path(bp_id, L);
-
-        LODEntry entry;
-        entry.mesh = std::move(gpu);
-        entry.cutoff = 0.0f; // no limit — single LOD
-        lod_set.lods.push_back(std::move(entry));
+        LODDescriptor lod;
+        lod.mesh_path = std::move(mesh_path);
+        lod.texture_path = resolve_albedo_path(bp_id, L);
+        lod.specteam_path = resolve_specteam_path(bp_id, L);
+        lod.normal_path = resolve_normal_path(bp_id, L);
+        lod.cutoff = 0.0f; // no limit — single LOD
+        set.lods.push_back(std::move(lod));
     }
 
-    // Sort by cutoff ascending (highest detail / smallest cutoff first)
-    std::sort(lod_set.lods.begin(), lod_set.lods.end(),
-              [](const LODEntry& a, const LODEntry& b) {
-                  // 0 means "no limit" — sort to the end
-                  if (a.cutoff == 0.0f && b.cutoff == 0.0f) return false;
-                  if (a.cutoff == 0.0f) return false;
-                  if (b.cutoff == 0.0f) return true;
-                  return a.cutoff < b.cutoff;
-              });
-
-    spdlog::debug("MeshCache: loaded '{}' with {} LOD level(s), scale={:.2f}",
-                   bp_id, lod_set.lods.size(), scale);
-
-    lod_cache_[bp_id] = std::move(lod_set);
-    return true;
+    return set;
 }
 
 // ---------------------------------------------------------------------------
@@ -326,7 +502,7 @@ std::string MeshCache::resolve_albedo_path_for_lod(const std::string& mesh_bp_id
     std::string base = derive_base_path(mesh_bp_id);
     if (!base.empty() && vfs_) {
         std::string path = base + "_Albedo.dds";
-        if (vfs_->read_file(path)) return path;
+        if (vfs_->file_exists(path)) return path;
     }
     return {};
 }
@@ -351,7 +527,7 @@ std::string MeshCache::resolve_specteam_path_for_lod(const std::string& mesh_bp_
     std::string base = derive_base_path(mesh_bp_id);
     if (!base.empty() && vfs_) {
         std::string path = base + "_SpecTeam.dds";
-        if (vfs_->read_file(path)) return path;
+        if (vfs_->file_exists(path)) return path;
     }
     return {};
 }
@@ -376,9 +552,9 @@ std::string MeshCache::resolve_normal_path_for_lod(const std::string& mesh_bp_id
     std::string base = derive_base_path(mesh_bp_id);
     if (!base.empty() && vfs_) {
         std::string path = base + "_normalsTS.dds";
-        if (vfs_->read_file(path)) return path;
+        if (vfs_->file_exists(path)) return path;
         path = base + "_NormalsTS.dds";
-        if (vfs_->read_file(path)) return path;
+        if (vfs_->file_exists(path)) return path;
     }
     return {};
 }
@@ -559,7 +735,7 @@ std::string MeshCache::resolve_albedo_path(const std::string& bp_id,
     std::string base = derive_base_path(mesh_bp_id);
     if (!base.empty()) {
         std::string path = base + "_Albedo.dds";
-        if (vfs_ && vfs_->read_file(path)) return path;
+        if (vfs_ && vfs_->file_exists(path)) return path;
     }
 
     return {};
@@ -616,7 +792,7 @@ std::string MeshCache::resolve_specteam_path(const std::string& bp_id,
     std::string base = derive_base_path(mesh_bp_id);
     if (!base.empty() && vfs_) {
         std::string path = base + "_SpecTeam.dds";
-        if (vfs_->read_file(path)) return path;
+        if (vfs_->file_exists(path)) return path;
     }
 
     return {};
@@ -673,10 +849,10 @@ std::string MeshCache::resolve_normal_path(const std::string& bp_id,
     std::string base = derive_base_path(mesh_bp_id);
     if (!base.empty() && vfs_) {
         std::string path = base + "_normalsTS.dds";
-        if (vfs_->read_file(path)) return path;
+        if (vfs_->file_exists(path)) return path;
         // Try capitalized variant
         path = base + "_NormalsTS.dds";
-        if (vfs_->read_file(path)) return path;
+        if (vfs_->file_exists(path)) return path;
     }
 
     return {};
@@ -714,6 +890,22 @@ f32 MeshCache::resolve_uniform_scale(const std::string& bp_id,
 // ---------------------------------------------------------------------------
 
 void MeshCache::destroy(VkDevice device, VmaAllocator allocator) {
+    // Stop the workers before the buffers they feed go away
+    loader_.reset();
+    loading_.clear();
+    for (auto& batch : batches_) {
+        if (batch.in_flight)
+            vkWaitForFences(device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+        if (batch.fence) vkDestroyFence(device, batch.fence, nullptr);
+        if (batch.cmd) vkFreeCommandBuffers(device, cmd_pool_, 1, &batch.cmd);
+        batch = {};
+    }
+    if (staging_.buffer)
+        vmaDestroyBuffer(allocator, staging_.buffer, staging_.allocation);
+    staging_ = {};
+    staging_mapped_ = nullptr;
+    ring_head_ = ring_used_ = 0;
+
     for (auto& [id, lod_set] : lod_cache_) {
         for (auto& entry : lod_set.lods) {
             if (entry.mesh.vertex_buf.buffer)
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "renderer/mesh_loader.hpp"
+#include "renderer/mesh_vertex.hpp"
 #include "renderer/vk_types.hpp"
 #include "core/types.hpp"
 
+#include <array>
+#include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -25,6 +30,7 @@ struct GPUMesh {
     AllocatedBuffer vertex_buf{};
     AllocatedBuffer index_buf{};
     u32 index_count = 0;
+    MeshQuantization quant;     // dequantizes the packed vertices in vertex_buf
     f32 uniform_scale = 1.0f;
     std::string texture_path;   // VFS path to albedo DDS (empty = no texture)
     std::string specteam_path;  // VFS path to SpecTeam DDS (empty = no team color mask)
@@ -44,7 +50,9 @@ struct LODSet {
 };
 
 /// Caches GPU mesh buffers per blueprint ID.
-/// Lazily loads .scm files via VFS, parses vertices+indices, uploads to GPU.
+/// On first use a blueprint's LODs are resolved from Lua (main thread) and
+/// handed to a MeshLoader, whose workers read and parse the .scm files.
+/// flush_uploads() copies finished LODs to the GPU through a staging ring.
 /// Supports multiple LOD levels per blueprint with distance-based selection.
 class MeshCache {
 public:
@@ -54,14 +62,27 @@ public:
               blueprints::BlueprintStore* store);
 
     /// Get or lazily load GPU mesh for a blueprint ID (highest detail LOD).
-    /// Returns nullptr if mesh unavailable (caller falls back to cube).
+    /// Returns nullptr if mesh unavailable or still loading (caller falls
+    /// back to cube).
     const GPUMesh* get(const std::string& blueprint_id, lua_State* L);
 
-    /// Get best LOD mesh for given camera distance.
-    /// Returns nullptr if mesh unavailable.
+    /// Get best LOD mesh for given camera distance. While a blueprint loads
+    /// this is the best LOD uploaded so far (coarsest arrive first), or
+    /// nullptr before the first one lands.
     const GPUMesh* get_lod(const std::string& blueprint_id, f32 camera_distance,
                            lua_State* L);
 
+    /// Upload LODs the loader has finished, in one staged batch.
+    /// Call once per frame, before meshes are looked up for drawing:
+    /// adding a LOD may move the GPUMesh objects of its set.
+    void flush_uploads();
+
+    /// Block until every requested mesh is parsed and uploaded (preload).
+    void finish_loading();
+
+    /// True if `blueprint_id` still has LODs in flight.
+    bool loading(const std::string& blueprint_id) const;
+
     /// Get the full LODSet for introspection. Returns nullptr if not loaded.
     const LODSet* get_lod_set(const std::string& blueprint_id) const;
 
@@ -78,8 +99,10 @@ private:
     /// Derive base path from mesh bp ID: "/units/uel0001/uel0001_mesh" -> "/units/uel0001/uel0001"
     static std::string derive_base_path(const std::string& mesh_bp_id);
 
-    /// Load all LOD levels for a blueprint. Returns true if at least one LOD loaded.
-    bool load_lod_set(const std::string& bp_id, lua_State* L);
+    /// Resolve all LOD levels for a blueprint into a Lua-free descriptor.
+    /// Returns nullopt if the blueprint has no mesh.
+    std::optional<MeshSetDescriptor> resolve_mesh_set(const std::string& bp_id,
+                                                      lua_State* L);
 
     /// Read LODCutoff from __blueprints[mesh_bp_id].LODs[lod_index].
     f32 read_lod_cutoff(const std::string& mesh_bp_id, i32 lod_index, lua_State* L);
@@ -102,11 +125,41 @@ private:
     std::string read_lod_string_field(const std::string& mesh_bp_id, i32 lod_index,
                                       const char* field_name, lua_State* L);
 
-    /// Upload a single SCM mesh to GPU buffers. Returns empty GPUMesh on failure.
-    GPUMesh upload_scm_mesh(const std::string& mesh_path);
+    /// Stage one parsed LOD into the current upload batch. Returns false
+    /// if the staging ring is full (retry next flush).
+    bool stage_lod(ParsedLOD& lod);
+    /// Oversized LODs bypass the ring with a blocking upload.
+    bool upload_lod_blocking(const ParsedLOD& lod, GPUMesh& out);
+    void add_lod(const ParsedLOD& lod, GPUMesh&& gpu);
+    /// Reserve `size` bytes of the staging ring; returns its offset.
+    std::optional<VkDeviceSize> ring_alloc(VkDeviceSize size);
+    /// Release ring space of batches whose fence has signalled.
+    void reclaim_batches(bool wait);
+    void create_upload_resources();
 
     std::unordered_map<std::string, LODSet> lod_cache_;
     std::unordered_set<std::string> failed_;
+    std::unordered_set<std::string> loading_;
+    std::unique_ptr<MeshLoader> loader_;
+
+    /// Staging ring shared by all upload batches. Batches retire in
+    /// submission order, so the ring frees from its tail.
+    static constexpr VkDeviceSize STAGING_RING_BYTES = 16ull << 20;
+    static constexpr u32 UPLOAD_BATCHES = 2;
+    struct UploadBatch {
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+        VkDeviceSize bytes = 0;  // ring bytes held, including wrap padding
+        bool in_flight = false;
+        bool recording = false;
+    };
+    AllocatedBuffer staging_{};
+    u8* staging_mapped_ = nullptr;
+    VkDeviceSize ring_head_ = 0;
+    VkDeviceSize ring_used_ = 0;
+    std::array<UploadBatch, UPLOAD_BATCHES> batches_{};
+    u32 batch_index_ = 0;  // batch being filled / next to submit
+    u32 oldest_batch_ = 0; // oldest batch possibly in flight
 
     VkDevice device_ = VK_NULL_HANDLE;
     VmaAllocator allocator_ = VK_NULL_HANDLE;
@@ -0,0 +1,138 @@
+#include "renderer/mesh_loader.hpp"
+#include "core/tracer.hpp"
+#include "sim/scm_parser.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace osc::renderer {
+
+namespace {
+
+/// LOD reach for ordering: a zero cutoff means no limit.
+f32 lod_reach(const LODDescriptor& d) {
+    return d.cutoff == 0.0f ? std::numeric_limits<f32>::max() : d.cutoff;
+}
+
+} // namespace
+
+MeshLoader::MeshLoader(ReadFile read, u32 workers) : read_(std::move(read)) {
+    if (workers == 0)
+        workers = std::clamp(std::thread::hardware_concurrency(), 1u, MAX_WORKERS);
+    workers_.reserve(workers);
+    for (u32 i = 0; i < workers; ++i)
+        workers_.emplace_back([this] { worker_loop(); });
+}
+
+MeshLoader::~MeshLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        queue_.clear();
+    }
+    work_cv_.notify_all();
+    for (auto& w : workers_) w.join();
+}
+
+void MeshLoader::submit(const MeshSetDescriptor& set) {
+    if (set.lods.empty()) return;
+
+    std::vector<const LODDescriptor*> order;
+    order.reserve(set.lods.size());
+    for (const auto& lod : set.lods) order.push_back(&lod);
+    std::stable_sort(order.begin(), order.end(),
+                     [](const LODDescriptor* a, const LODDescriptor* b) {
+                         return lod_reach(*a) > lod_reach(*b);
+                     });
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto* lod : order)
+            queue_.push_back({set.bp_id, set.uniform_scale, *lod});
+    }
+    pending_[set.bp_id] += static_cast<u32>(order.size());
+    work_cv_.notify_all();
+}
+
+u32 MeshLoader::pending(const std::string& bp_id) const {
+    auto it = pending_.find(bp_id);
+    return it != pending_.end() ? it->second : 0;
+}
+
+u32 MeshLoader::drain(const std::function<bool(ParsedLOD&)>& upload) {
+    u32 accepted = 0;
+    for (;;) {
+        ParsedLOD lod;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (finished_.empty()) break;
+            lod = std::move(finished_.front());
+            finished_.pop_front();
+        }
+        std::string bp_id = lod.bp_id; // the uploader may move from lod
+        if (!upload(lod)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_.push_front(std::move(lod));
+            break;
+        }
+        auto it = pending_.find(bp_id);
+        if (it != pending_.end() && --it->second == 0) pending_.erase(it);
+        accepted++;
+    }
+    return accepted;
+}
+
+void MeshLoader::wait_parsed() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return queue_.empty() && in_progress_ == 0; });
+}
+
+void MeshLoader::worker_loop() {
+    Tracer::instance().set_thread_name("mesh loader");
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (stop_) return;
+            job = std::move(queue_.front());
+            queue_.pop_front();
+            in_progress_++;
+        }
+
+        ParsedLOD lod = parse(std::move(job));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_.push_back(std::move(lod));
+            in_progress_--;
+        }
+        done_cv_.notify_all();
+    }
+}
+
+ParsedLOD MeshLoader::parse(Job job) const {
+    TRACE_ZONE("MeshLoader::parse");
+    ParsedLOD out;
+    out.bp_id = std::move(job.bp_id);
+    out.uniform_scale = job.uniform_scale;
+    out.desc = std::move(job.desc);
+
+    auto file_data = read_(out.desc.mesh_path);
+    if (!file_data) {
+        spdlog::debug("MeshLoader: read failed for '{}'", out.desc.mesh_path);
+        return out;
+    }
+    auto mesh = sim::parse_scm_mesh(*file_data);
+    if (!mesh || mesh->vertices.empty() || mesh->indices.empty()) {
+        spdlog::debug("MeshLoader: SCM parse failed for '{}'", out.desc.mesh_path);
+        return out;
+    }
+    out.mesh = pack_scm_mesh(*mesh);
+    out.indices = std::move(mesh->indices);
+    return out;
+}
+
+} // namespace osc::renderer
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "renderer/mesh_vertex.hpp"
+#include "core/types.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace osc::renderer {
+
+/// One LOD level as resolved from the blueprint: plain data, so loading it
+/// never needs the Lua state.
+struct LODDescriptor {
+    std::string mesh_path;
+    std::string texture_path;
+    std::string specteam_path;
+    std::string normal_path;
+    f32 cutoff = 0.0f;  // max camera distance (0 = no limit)
+};
+
+/// Every LOD of one blueprint. Resolved once, on the main thread.
+struct MeshSetDescriptor {
+    std::string bp_id;
+    f32 uniform_scale = 1.0f;
+    std::vector<LODDescriptor> lods;
+};
+
+/// A LOD after the worker stage: read, parsed and packed, ready to upload.
+/// Empty vertices/indices mean the read or parse failed.
+struct ParsedLOD {
+    std::string bp_id;
+    f32 uniform_scale = 1.0f;
+    LODDescriptor desc;
+    PackedMesh mesh;
+    std::vector<u32> indices;
+
+    bool ok() const { return !mesh.vertices.empty() && !indices.empty(); }
+    size_t vertex_bytes() const { return mesh.vertices.size() * sizeof(PackedMeshVertex); }
+    size_t index_bytes() const { return indices.size() * sizeof(u32); }
+};
+
+/// Background .scm loading for MeshCache. The main thread submits resolved
+/// descriptors; worker threads do the file read, SCM parse and vertex
+/// packing; the main thread drains finished LODs into its uploader.
+/// submit/drain/pending must be called from one (the render) thread.
+class MeshLoader {
+public:
+    using ReadFile = std::function<std::optional<std::vector<char>>(const std::string&)>;
+
+    /// `workers` = 0 picks from hardware_concurrency (1..MAX_WORKERS).
+    explicit MeshLoader(ReadFile read, u32 workers = 0);
+    ~MeshLoader();
+
+    MeshLoader(const MeshLoader&) = delete;
+    MeshLoader& operator=(const MeshLoader&) = delete;
+
+    /// Queue every LOD of `set`, coarsest first so a usable mesh shows up
+    /// as early as possible.
+    void submit(const MeshSetDescriptor& set);
+
+    /// LODs of `bp_id` submitted but not yet drained.
+    u32 pending(const std::string& bp_id) const;
+
+    /// True when nothing is queued, parsing or waiting to be drained.
+    bool idle() const { return pending_.empty(); }
+
+    /// Hand finished LODs to `upload` in completion order. Stops at the
+    /// first LOD it declines, which is kept for the next call. Returns the
+    /// number accepted.
+    u32 drain(const std::function<bool(ParsedLOD&)>& upload);
+
+    /// Block until every queued LOD has been parsed (not drained).
+    void wait_parsed();
+
+    u32 worker_count() const { return static_cast<u32>(workers_.size()); }
+
+    static constexpr u32 MAX_WORKERS = 2;
+
+private:
+    struct Job {
+        std::string bp_id;
+        f32 uniform_scale = 1.0f;
+        LODDescriptor desc;
+    };
+
+    void worker_loop();
+    ParsedLOD parse(Job job) const;
+
+    ReadFile read_;
+    std::vector<std::thread> workers_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::deque<Job> queue_;          // guarded by mutex_
+    std::deque<ParsedLOD> finished_; // guarded by mutex_
+    u32 in_progress_ = 0;            // guarded by mutex_
+    bool stop_ = false;              // guarded by mutex_
+
+    std::unordered_map<std::string, u32> pending_; // render thread only
+};
+
+} // namespace osc::renderer
@@ -0,0 +1,139 @@
+#include "renderer/mesh_vertex.hpp"
+#include "sim/scm_parser.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace osc::renderer {
+
+namespace {
+
+constexpr f32 SNORM16_MAX = 32767.0f;
+constexpr f32 UNORM16_MAX = 65535.0f;
+
+/// Vulkan SNORM conversion: c / 32767, clamped to -1.
+f32 snorm16_to_float(i16 c) {
+    return std::max(static_cast<f32>(c) / SNORM16_MAX, -1.0f);
+}
+
+i16 float_to_snorm16(f32 f) {
+    return static_cast<i16>(std::lround(std::clamp(f, -1.0f, 1.0f) * SNORM16_MAX));
+}
+
+u16 float_to_unorm16(f32 f) {
+    return static_cast<u16>(std::lround(std::clamp(f, 0.0f, 1.0f) * UNORM16_MAX));
+}
+
+} // namespace
+
+std::array<f32, 3> oct_decode(i16 ex, i16 ey) {
+    f32 x = snorm16_to_float(ex), y = snorm16_to_float(ey);
+    f32 z = 1.0f - std::abs(x) - std::abs(y);
+    f32 t = std::max(-z, 0.0f);
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+    f32 len = std::sqrt(x * x + y * y + z * z);
+    if (len <= 0.0f) return {0, 0, 1};
+    return {x / len, y / len, z / len};
+}
+
+std::array<i16, 2> oct_encode(f32 x, f32 y, f32 z) {
+    f32 l1 = std::abs(x) + std::abs(y) + std::abs(z);
+    if (l1 <= 0.0f) return {0, 0};
+    f32 px = x / l1, py = y / l1;
+    if (z < 0.0f) {
+        f32 fx = (1.0f - std::abs(py)) * (px >= 0.0f ? 1.0f : -1.0f);
+        f32 fy = (1.0f - std::abs(px)) * (py >= 0.0f ? 1.0f : -1.0f);
+        px = fx;
+        py = fy;
+    }
+
+    // Try the four neighbouring grid points; keep the closest direction.
+    // Compared by chord length: a float dot product near 1 cannot resolve
+    // the differences involved.
+    f32 inv = 1.0f / std::sqrt(x * x + y * y + z * z);
+    const f32 ux = x * inv, uy = y * inv, uz = z * inv;
+    f32 bx = std::floor(px * SNORM16_MAX), by = std::floor(py * SNORM16_MAX);
+    std::array<i16, 2> best{float_to_snorm16(px), float_to_snorm16(py)};
+    f32 best_d2 = 8.0f;
+    for (int i = 0; i < 4; ++i) {
+        std::array<i16, 2> c{float_to_snorm16((bx + static_cast<f32>(i & 1)) / SNORM16_MAX),
+                             float_to_snorm16((by + static_cast<f32>(i >> 1)) / SNORM16_MAX)};
+        auto d = oct_decode(c[0], c[1]);
+        f32 ex = d[0] - ux, ey = d[1] - uy, ez = d[2] - uz;
+        f32 d2 = ex * ex + ey * ey + ez * ez;
+        if (d2 < best_d2) {
+            best_d2 = d2;
+            best = c;
+        }
+    }
+    return best;
+}
+
+PackedMesh pack_scm_mesh(const sim::SCMMesh& mesh) {
+    PackedMesh out;
+    if (mesh.vertices.empty()) return out;
+
+    f32 lo[3], hi[3];
+    f32 uv_lo = mesh.vertices[0].u, uv_hi = uv_lo;
+    const auto& first = mesh.vertices[0];
+    lo[0] = hi[0] = first.px;
+    lo[1] = hi[1] = first.py;
+    lo[2] = hi[2] = first.pz;
+    for (const auto& v : mesh.vertices) {
+        const f32 p[3] = {v.px, v.py, v.pz};
+        for (int a = 0; a < 3; ++a) {
+            lo[a] = std::min(lo[a], p[a]);
+            hi[a] = std::max(hi[a], p[a]);
+        }
+        uv_lo = std::min({uv_lo, v.u, v.v});
+        uv_hi = std::max({uv_hi, v.u, v.v});
+    }
+
+    auto& q = out.quant;
+    for (int a = 0; a < 3; ++a) {
+        q.offset[a] = 0.5f * (lo[a] + hi[a]);
+        q.scale[a] = 0.5f * (hi[a] - lo[a]);
+        if (q.scale[a] <= 0.0f) q.scale[a] = 1.0f; // flat axis
+    }
+    q.offset[3] = uv_lo;
+    q.scale[3] = uv_hi > uv_lo ? uv_hi - uv_lo : 1.0f;
+
+    out.vertices.resize(mesh.vertices.size());
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        const auto& v = mesh.vertices[i];
+        auto& p = out.vertices[i];
+        p.pos[0] = float_to_snorm16((v.px - q.offset[0]) / q.scale[0]);
+        p.pos[1] = float_to_snorm16((v.py - q.offset[1]) / q.scale[1]);
+        p.pos[2] = float_to_snorm16((v.pz - q.offset[2]) / q.scale[2]);
+        p.pos[3] = 0;
+        auto n = oct_encode(v.nx, v.ny, v.nz);
+        auto t = oct_encode(v.tx, v.ty, v.tz);
+        p.normal[0] = n[0];
+        p.normal[1] = n[1];
+        p.tangent[0] = t[0];
+        p.tangent[1] = t[1];
+        p.uv[0] = float_to_unorm16((v.u - q.offset[3]) / q.scale[3]);
+        p.uv[1] = float_to_unorm16((v.v - q.offset[3]) / q.scale[3]);
+        std::memcpy(p.bone_indices, v.bone_indices, 4);
+    }
+    return out;
+}
+
+UnpackedMeshVertex unpack_vertex(const PackedMeshVertex& v,
+                                 const MeshQuantization& q) {
+    UnpackedMeshVertex out;
+    out.px = q.offset[0] + snorm16_to_float(v.pos[0]) * q.scale[0];
+    out.py = q.offset[1] + snorm16_to_float(v.pos[1]) * q.scale[1];
+    out.pz = q.offset[2] + snorm16_to_float(v.pos[2]) * q.scale[2];
+    auto n = oct_decode(v.normal[0], v.normal[1]);
+    auto t = oct_decode(v.tangent[0], v.tangent[1]);
+    out.nx = n[0]; out.ny = n[1]; out.nz = n[2];
+    out.tx = t[0]; out.ty = t[1]; out.tz = t[2];
+    out.u = q.offset[3] + static_cast<f32>(v.uv[0]) / UNORM16_MAX * q.scale[3];
+    out.v = q.offset[3] + static_cast<f32>(v.uv[1]) / UNORM16_MAX * q.scale[3];
+    return out;
+}
+
+} // namespace osc::renderer
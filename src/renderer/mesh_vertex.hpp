@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <array>
+#include <vector>
+
+namespace osc::sim {
+struct SCMMesh;
+}
+
+namespace osc::renderer {
+
+/// Quantized SCM vertex as uploaded to the GPU: 24 bytes against the
+/// 64-byte sim::SCMMesh::Vertex. Decoded by mesh_vert / shadow_mesh_vert.
+/// Bone weights are not stored: SCM blends its four slots equally.
+struct PackedMeshVertex {
+    i16 pos[4];         // snorm16 position within the mesh bounds (w = 0)
+    i16 normal[2];      // octahedral, snorm16
+    i16 tangent[2];     // octahedral, snorm16
+    u16 uv[2];          // unorm16 within the mesh's UV range
+    u8  bone_indices[4];
+};
+static_assert(sizeof(PackedMeshVertex) == 24);
+
+/// Per-mesh dequantization constants, pushed with each draw:
+///   position = offset.xyz + snorm(pos) * scale.xyz
+///   uv       = offset.w   + unorm(uv)  * scale.w
+struct MeshQuantization {
+    f32 offset[4] = {0, 0, 0, 0};
+    f32 scale[4] = {1, 1, 1, 1};
+};
+
+struct PackedMesh {
+    std::vector<PackedMeshVertex> vertices;
+    MeshQuantization quant;
+};
+
+/// Quantize parsed SCM vertices against the mesh's own bounds.
+PackedMesh pack_scm_mesh(const sim::SCMMesh& mesh);
+
+/// Octahedral unit-vector encoding; picks the rounding with the smallest
+/// angular error.
+std::array<i16, 2> oct_encode(f32 x, f32 y, f32 z);
+
+/// Inverse of oct_encode, as the shaders compute it.
+std::array<f32, 3> oct_decode(i16 ex, i16 ey);
+
+/// A packed vertex decoded the way the vertex shaders do (tests, tools).
+struct UnpackedMeshVertex {
+    f32 px, py, pz;
+    f32 nx, ny, nz;
+    f32 tx, ty, tz;
+    f32 u, v;
+};
+UnpackedMeshVertex unpack_vertex(const PackedMeshVertex& v,
+                                 const MeshQuantization& q);
+
+} // namespace osc::renderer
@@ -13,10 +13,8 @@
 
 namespace osc::renderer {
 
-static void get_army_color_simple(const sim::Entity& entity,
-                                   const sim::SimState& sim,
+static void get_army_color_simple(i32 army, const sim::SimState& sim,
                                    f32& r, f32& g, f32& b) {
-    i32 army = entity.army();
     if (army >= 0 && army < static_cast<i32>(sim.army_count())) {
         auto* brain = sim.army_at(static_cast<size_t>(army));
         if (brain && (brain->color_r() || brain->color_g() ||
@@ -53,6 +51,36 @@ void MinimapRenderer::init(VkDevice device, VmaAllocator allocator) {
                         &instance_buf_[i].buffer, &instance_buf_[i].allocation, &info);
         instance_mapped_[i] = info.pMappedData;
     }
+
+    // Unit dot segments, one copy per frame in flight
+    VkBufferCreateInfo dot_info{};
+    dot_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    dot_info.size = MinimapDotBuffer::SEGMENTS *
+                    MinimapDotBuffer::MAX_DOTS_PER_SEGMENT * sizeof(MinimapDot);
+    dot_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+
+    // Tile staging: room for every tile of the texture
+    VkBufferCreateInfo staging_info{};
+    staging_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    staging_info.size = MINIMAP_TEX_SIZE * MINIMAP_TEX_SIZE * 4;
+    staging_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+    VmaAllocationCreateInfo staging_alloc{};
+    staging_alloc.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+    staging_alloc.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    staging_alloc.requiredFlags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    for (u32 i = 0; i < FRAMES_IN_FLIGHT; i++) {
+        VmaAllocationInfo info{};
+        vmaCreateBuffer(allocator, &dot_info, &alloc_info,
+                        &dot_buf_[i].buffer, &dot_buf_[i].allocation, &info);
+        dot_mapped_[i] = info.pMappedData;
+
+        vmaCreateBuffer(allocator, &staging_info, &staging_alloc,
+                        &tile_staging_[i].buffer, &tile_staging_[i].allocation,
+                        &info);
+        tile_mapped_[i] = info.pMappedData;
+    }
 }
 
 void MinimapRenderer::destroy(VkDevice /*device*/, VmaAllocator allocator) {
@@ -62,7 +90,20 @@ void MinimapRenderer::destroy(VkDevice /*device*/, VmaAllocator allocator) {
                              instance_buf_[i].allocation);
         instance_buf_[i] = {};
         instance_mapped_[i] = nullptr;
+
+        if (dot_buf_[i].buffer)
+            vmaDestroyBuffer(allocator, dot_buf_[i].buffer,
+                             dot_buf_[i].allocation);
+        dot_buf_[i] = {};
+        dot_mapped_[i] = nullptr;
+
+        if (tile_staging_[i].buffer)
+            vmaDestroyBuffer(allocator, tile_staging_[i].buffer,
+                             tile_staging_[i].allocation);
+        tile_staging_[i] = {};
+        tile_mapped_[i] = nullptr;
     }
+    terrain_image_ = VK_NULL_HANDLE;
 }
 
 void MinimapRenderer::build_terrain_texture(
@@ -136,7 +177,12 @@ void MinimapRenderer::build_terrain_texture(
                                            pixels.data(), TEX, TEX);
     if (gpu_tex) {
         terrain_ds_ = gpu_tex->descriptor_set;
+        terrain_image_ = gpu_tex->image.image;
     }
+
+    // Base colours for tile recompositing (fog, intel, reclaim)
+    tiles_.set_terrain(std::move(pixels), map_w_, map_h_);
+    dots_.set_map_size(map_w_, map_h_);
 }
 
 void MinimapRenderer::emit_quad(f32 x, f32 y, f32 w, f32 h,
@@ -162,10 +208,13 @@ void MinimapRenderer::emit_quad(f32 x, f32 y, f32 w, f32 h,
 void MinimapRenderer::update(const sim::SimState& sim, const Camera& camera,
                               TextureCache& tex_cache,
                               const std::unordered_set<u32>* /*selected_ids*/,
+                              const map::VisibilityGrid* fog, u32 fog_army,
                               u32 viewport_w, u32 viewport_h) {
     quads_.clear();
     quad_count_ = 0;
     draw_groups_.clear();
+    dot_group_ = 0;
+    dot_count_.fill(0);
     white_ds_ = tex_cache.fallback_descriptor();
 
     if (map_w_ <= 0 || map_h_ <= 0) return;
@@ -185,29 +234,32 @@ void MinimapRenderer::update(const sim::SimState& sim, const Camera& camera,
     // --- Terrain background texture ---
     VkDescriptorSet bg_ds = terrain_ds_ ? terrain_ds_ : white_ds_;
     emit_quad(mm_x_, mm_y_, mm_size_, mm_size_, 1.0f, 1.0f, 1.0f, 1.0f, bg_ds);
+    dot_group_ = static_cast<u32>(draw_groups_.size());
 
-    // --- Unit dots ---
+    // --- Unit dots and reclaim ---
+    // Only dots that changed pixel and tiles whose reclaim changed are
+    // uploaded (record_upload); the dots are drawn from the GPU segments.
     auto& registry = sim.entity_registry();
+    dots_.begin_frame();
+    tiles_.begin_reclaim();
     registry.for_each([&](const sim::Entity& entity) {
         if (entity.destroyed()) return;
-        if (!entity.is_unit()) return;
-
         auto pos = entity.position();
-        // Map world position to minimap pixel position
-        f32 nx = pos.x / map_w_; // normalized [0,1]
-        f32 nz = pos.z / map_h_;
-        if (nx < 0 || nx > 1 || nz < 0 || nz > 1) return;
-
-        f32 dot_x = mm_x_ + nx * mm_size_;
-        f32 dot_y = mm_y_ + nz * mm_size_;
-
-        f32 r, g, b;
-        get_army_color_simple(entity, sim, r, g, b);
-
-        constexpr f32 DOT_SIZE = 3.0f;
-        emit_quad(dot_x - DOT_SIZE * 0.5f, dot_y - DOT_SIZE * 0.5f,
-                  DOT_SIZE, DOT_SIZE, r, g, b, 1.0f, white_ds_);
+        if (entity.is_unit())
+            dots_.add(entity.entity_id(), entity.army(), pos.x, pos.z);
+        else if (entity.is_prop() && entity.is_wreckage())
+            tiles_.add_reclaim(pos.x, pos.z);
     });
+    dots_.end_frame();
+    tiles_.end_reclaim();
+    tiles_.update_fog(fog, fog_army);
+
+    for (u32 seg = 0; seg < MinimapDotBuffer::SEGMENTS; seg++) {
+        dot_count_[seg] = static_cast<u32>(dots_.dots(seg).size());
+        auto& c = dot_color_[seg];
+        get_army_color_simple(static_cast<i32>(seg) - 1, sim, c[0], c[1], c[2]);
+        c[3] = 1.0f;
+    }
 
     // --- Camera frustum box ---
     // Unproject the 4 screen corners to world XZ to get the camera view area
@@ -263,39 +315,139 @@ void MinimapRenderer::update(const sim::SimState& sim, const Camera& camera,
     }
 }
 
-void MinimapRenderer::render(VkCommandBuffer cmd, VkPipelineLayout layout,
+void MinimapRenderer::upload_dots(u32 segment, u32 first,
+                                  const MinimapDot* dots, u32 count) {
+    if (!dot_mapped_[fi_]) return;
+    auto* dst = static_cast<u8*>(dot_mapped_[fi_]) +
+                (static_cast<size_t>(segment) * MinimapDotBuffer::MAX_DOTS_PER_SEGMENT +
+                 first) * sizeof(MinimapDot);
+    std::memcpy(dst, dots, count * sizeof(MinimapDot));
+}
+
+void MinimapRenderer::upload_tile(u32 tx, u32 ty, const u8* rgba) {
+    if (!tile_mapped_[fi_] || !terrain_image_) return;
+    constexpr u32 TILE = MinimapTiles::TILE_SIZE;
+    constexpr size_t TILE_BYTES = TILE * TILE * 4;
+    size_t offset = tile_copies_.size() * TILE_BYTES;
+    std::memcpy(static_cast<u8*>(tile_mapped_[fi_]) + offset, rgba, TILE_BYTES);
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = offset;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {static_cast<i32>(tx * TILE), static_cast<i32>(ty * TILE), 0};
+    region.imageExtent = {TILE, TILE, 1};
+    tile_copies_.push_back(region);
+}
+
+void MinimapRenderer::record_upload(VkCommandBuffer cmd) {
+    dots_.flush(*this, fi_);
+
+    tile_copies_.clear();
+    tiles_.flush(*this);
+    if (tile_copies_.empty()) return;
+
+    // SHADER_READ -> TRANSFER_DST
+    VkImageMemoryBarrier to_dst{};
+    to_dst.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    to_dst.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    to_dst.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    to_dst.image = terrain_image_;
+    to_dst.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    to_dst.subresourceRange.levelCount = 1;
+    to_dst.subresourceRange.layerCount = 1;
+    to_dst.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    to_dst.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &to_dst);
+
+    vkCmdCopyBufferToImage(cmd, tile_staging_[fi_].buffer, terrain_image_,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<u32>(tile_copies_.size()),
+                           tile_copies_.data());
+
+    // TRANSFER_DST -> SHADER_READ
+    VkImageMemoryBarrier to_read = to_dst;
+    to_read.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    to_read.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    to_read.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    to_read.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &to_read);
+}
+
+void MinimapRenderer::render(VkCommandBuffer cmd,
+                              VkPipeline ui_pipeline, VkPipelineLayout ui_layout,
+                              VkPipeline dot_pipeline, VkPipelineLayout dot_layout,
                               u32 viewport_w, u32 viewport_h) {
     if (quad_count_ == 0) return;
 
-    // Push viewport size
+    // Scissor to minimap area (with small border margin, clamped to >= 0)
+    VkRect2D scissor{};
+    scissor.offset.x = std::max(0, static_cast<i32>(mm_x_) - 2);
+    scissor.offset.y = std::max(0, static_cast<i32>(mm_y_) - 2);
+    scissor.extent.width = static_cast<u32>(mm_size_) + 4;
+    scissor.extent.height = static_cast<u32>(mm_size_) + 4;
+
     f32 vp[2] = {static_cast<f32>(viewport_w),
                  static_cast<f32>(viewport_h)};
-    vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_VERTEX_BIT, 0,
-                       sizeof(f32) * 2, vp);
-
-    // Bind instance buffer
-    VkBuffer buf = instance_buf_[fi_].buffer;
-    VkDeviceSize offset = 0;
-    vkCmdBindVertexBuffers(cmd, 0, 1, &buf, &offset);
-
-    // Draw each group with its descriptor set
-    for (auto& group : draw_groups_) {
-        if (group.count == 0 || !group.ds) continue;
-
-        // Set scissor to minimap area (with small border margin, clamped to >= 0)
-        VkRect2D scissor{};
-        scissor.offset.x = std::max(0, static_cast<i32>(mm_x_) - 2);
-        scissor.offset.y = std::max(0, static_cast<i32>(mm_y_) - 2);
-        scissor.extent.width = static_cast<u32>(mm_size_) + 4;
-        scissor.extent.height = static_cast<u32>(mm_size_) + 4;
-        vkCmdSetScissor(cmd, 0, 1, &scissor);
 
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                layout, 0, 1, &group.ds, 0, nullptr);
+    // Draw UI quad groups [begin, end) with their descriptor sets
+    auto draw_quads = [&](u32 begin, u32 end) {
+        if (begin >= end) return;
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, ui_pipeline);
+        vkCmdPushConstants(cmd, ui_layout, VK_SHADER_STAGE_VERTEX_BIT, 0,
+                           sizeof(f32) * 2, vp);
+        VkBuffer buf = instance_buf_[fi_].buffer;
+        VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(cmd, 0, 1, &buf, &offset);
+        for (u32 i = begin; i < end; i++) {
+            const auto& group = draw_groups_[i];
+            if (group.count == 0 || !group.ds) continue;
+            vkCmdSetScissor(cmd, 0, 1, &scissor);
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                    ui_layout, 0, 1, &group.ds, 0, nullptr);
+            vkCmdDraw(cmd, 6, group.count, 0, group.offset);
+        }
+    };
+
+    const u32 group_count = static_cast<u32>(draw_groups_.size());
+    const u32 split = std::min(dot_group_, group_count);
+
+    // Terrain and border
+    draw_quads(0, split);
 
-        vkCmdDraw(cmd, 6, group.count, 0, group.offset);
+    // Unit dots: one instanced draw per army segment
+    if (dot_pipeline && dot_buf_[fi_].buffer) {
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, dot_pipeline);
+        vkCmdSetScissor(cmd, 0, 1, &scissor);
+        VkBuffer buf = dot_buf_[fi_].buffer;
+        VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(cmd, 0, 1, &buf, &offset);
+
+        DotPushConstants pc{};
+        pc.rect[0] = mm_x_;
+        pc.rect[1] = mm_y_;
+        pc.rect[2] = mm_size_;
+        pc.rect[3] = DOT_SIZE;
+        pc.viewport[0] = vp[0];
+        pc.viewport[1] = vp[1];
+        pc.resolution = static_cast<f32>(MINIMAP_TEX_SIZE);
+        for (u32 seg = 0; seg < MinimapDotBuffer::SEGMENTS; seg++) {
+            if (dot_count_[seg] == 0) continue;
+            std::memcpy(pc.color, dot_color_[seg].data(), sizeof(pc.color));
+            vkCmdPushConstants(cmd, dot_layout, VK_SHADER_STAGE_VERTEX_BIT, 0,
+                               sizeof(pc), &pc);
+            vkCmdDraw(cmd, 6, dot_count_[seg], 0,
+                      seg * MinimapDotBuffer::MAX_DOTS_PER_SEGMENT);
+        }
     }
 
+    // Camera box on top
+    draw_quads(split, group_count);
+
     // Restore full-screen scissor
     VkRect2D full_scissor{};
     full_scissor.extent = {viewport_w, viewport_h};
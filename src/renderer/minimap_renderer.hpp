@@ -1,6 +1,7 @@
 #pragma once
 
 #include "renderer/vk_types.hpp"
+#include "renderer/minimap_tiles.hpp"
 #include "renderer/ui_renderer.hpp" // UIInstance
 #include "core/types.hpp"
 
@@ -10,6 +11,7 @@
 
 namespace osc::map {
 class Terrain;
+class VisibilityGrid;
 }
 
 namespace osc::sim {
@@ -23,7 +25,12 @@ class TextureCache;
 
 /// Renders a minimap in the bottom-left corner showing terrain, unit dots,
 /// and camera frustum. Supports click-to-jump via hit_test().
-class MinimapRenderer {
+///
+/// Unit dots live in GPU buffers split into per-army segments and are only
+/// rewritten for units that moved to another minimap pixel; they are drawn
+/// as instanced sprites straight from those buffers. The terrain texture is
+/// updated per tile where fog, intel or reclaim changed.
+class MinimapRenderer : private MinimapUploader {
 public:
     void init(VkDevice device, VmaAllocator allocator);
 
@@ -32,14 +39,23 @@ public:
     void build_terrain_texture(const map::Terrain& terrain,
                                TextureCache& tex_cache);
 
-    /// Build minimap quads each frame.
+    /// Track unit dots, fog and reclaim, and build the frame quads.
+    /// `fog` is the grid shown for `fog_army`, or null with fog off.
     void update(const sim::SimState& sim, const Camera& camera,
                 TextureCache& tex_cache,
                 const std::unordered_set<u32>* selected_ids,
+                const map::VisibilityGrid* fog, u32 fog_army,
                 u32 viewport_w, u32 viewport_h);
 
-    /// Issue draw calls. Caller must have the UI pipeline bound.
-    void render(VkCommandBuffer cmd, VkPipelineLayout layout,
+    /// Write changed dots into this frame's dot buffer and record the
+    /// copies of dirty terrain tiles (before any render pass).
+    void record_upload(VkCommandBuffer cmd);
+
+    /// Issue draw calls: background quads with the UI pipeline, unit dots
+    /// with the dot pipeline, then the camera box. Binds both pipelines.
+    void render(VkCommandBuffer cmd,
+                VkPipeline ui_pipeline, VkPipelineLayout ui_layout,
+                VkPipeline dot_pipeline, VkPipelineLayout dot_layout,
                 u32 viewport_w, u32 viewport_h);
 
     void destroy(VkDevice device, VmaAllocator allocator);
@@ -47,6 +63,8 @@ public:
     void set_frame_index(u32 fi) { fi_ = fi; }
 
     u32 quad_count() const { return quad_count_; }
+    const MinimapDotBuffer& dots() const { return dots_; }
+    const MinimapTiles& tiles() const { return tiles_; }
 
     /// Test if screen-space point (mx, my) is inside the minimap.
     /// If true, writes world coordinates to out_wx, out_wz.
@@ -59,8 +77,23 @@ public:
     static constexpr u32 MINIMAP_TEX_SIZE = 256; // terrain texture resolution
     static constexpr u32 MAX_MINIMAP_QUADS = 2048;
     static constexpr u32 FRAMES_IN_FLIGHT = 2;
+    static constexpr f32 DOT_SIZE = 3.0f; // pixels
+
+    /// Push constants of the dot pipeline (minimap_dot.vert).
+    struct DotPushConstants {
+        f32 rect[4];   // minimap x, y, size; dot size
+        f32 color[4];
+        f32 viewport[2];
+        f32 resolution;
+        f32 pad;
+    };
 
 private:
+    // MinimapUploader
+    void upload_dots(u32 segment, u32 first, const MinimapDot* dots,
+                     u32 count) override;
+    void upload_tile(u32 tx, u32 ty, const u8* rgba) override;
+
     void emit_quad(f32 x, f32 y, f32 w, f32 h,
                    f32 r, f32 g, f32 b, f32 a,
                    VkDescriptorSet ds = VK_NULL_HANDLE);
@@ -72,6 +105,21 @@ private:
     std::vector<UIInstance> quads_;
     u32 quad_count_ = 0;
 
+    // Unit dots: CPU mirror and per-frame GPU copies (segment s at
+    // s * MAX_DOTS_PER_SEGMENT)
+    MinimapDotBuffer dots_{MINIMAP_TEX_SIZE, FRAMES_IN_FLIGHT};
+    AllocatedBuffer dot_buf_[FRAMES_IN_FLIGHT] = {};
+    void* dot_mapped_[FRAMES_IN_FLIGHT] = {};
+    std::array<u32, MinimapDotBuffer::SEGMENTS> dot_count_{};
+    std::array<std::array<f32, 4>, MinimapDotBuffer::SEGMENTS> dot_color_{};
+
+    // Terrain tiles: staged per frame, copied into the terrain image
+    MinimapTiles tiles_{MINIMAP_TEX_SIZE};
+    VkImage terrain_image_ = VK_NULL_HANDLE;
+    AllocatedBuffer tile_staging_[FRAMES_IN_FLIGHT] = {};
+    void* tile_mapped_[FRAMES_IN_FLIGHT] = {};
+    std::vector<VkBufferImageCopy> tile_copies_;
+
     // Terrain background texture descriptor
     VkDescriptorSet terrain_ds_ = VK_NULL_HANDLE;
     VkDescriptorSet white_ds_ = VK_NULL_HANDLE;
@@ -90,6 +138,7 @@ private:
         u32 count = 0;
     };
     std::vector<DrawGroup> draw_groups_;
+    u32 dot_group_ = 0; // groups before this index are drawn under the dots
 };
 
 } // namespace osc::renderer
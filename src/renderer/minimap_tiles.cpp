@@ -0,0 +1,329 @@
+#include "renderer/minimap_tiles.hpp"
+#include "map/visibility_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace osc::renderer {
+
+namespace {
+
+/// Brightness of the terrain under each fog level.
+constexpr f32 FOG_SHADE[4] = {0.35f, 0.6f, 0.8f, 1.0f};
+
+/// Wreckage colour (pale yellow, like the reclaim overlay).
+constexpr u8 RECLAIM_RGB[3] = {220, 210, 110};
+
+u64 mix_pixel(u32 pixel) {
+    u64 z = pixel + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+u8 fog_level(map::VisFlag flags) {
+    using map::VisFlag;
+    if (has_flag(flags, VisFlag::Vision)) return MinimapTiles::FOG_VISION;
+    if (has_flag(flags, VisFlag::Radar | VisFlag::Sonar | VisFlag::Omni))
+        return MinimapTiles::FOG_INTEL;
+    if (has_flag(flags, VisFlag::EverSeen)) return MinimapTiles::FOG_EXPLORED;
+    return MinimapTiles::FOG_UNEXPLORED;
+}
+
+/// Minimap pixel under a world coordinate (clamped).
+u32 to_pixel(f32 w, f32 map_size, u32 res) {
+    if (map_size <= 0) return 0;
+    f32 p = std::floor(w / map_size * static_cast<f32>(res));
+    return static_cast<u32>(std::clamp(p, 0.0f, static_cast<f32>(res - 1)));
+}
+
+} // namespace
+
+// --- MinimapDotBuffer ---
+
+MinimapDotBuffer::MinimapDotBuffer(u32 resolution, u32 copies)
+    : resolution_(resolution), copies_(std::max(copies, 1u)) {
+    for (auto& s : segments_) s.dirty.resize(copies_);
+}
+
+u32 MinimapDotBuffer::segment_of(i32 army) {
+    if (army < 0 || army >= MAX_ARMIES) return 0;
+    return static_cast<u32>(army) + 1;
+}
+
+void MinimapDotBuffer::set_map_size(f32 map_w, f32 map_h) {
+    map_w_ = map_w;
+    map_h_ = map_h;
+}
+
+void MinimapDotBuffer::begin_frame() {
+    ++frame_;
+    stats_.frames++;
+    for (auto& s : segments_) s.seen = 0;
+}
+
+void MinimapDotBuffer::mark(Segment& s, u32 slot) {
+    for (auto& d : s.dirty) d.push_back(slot);
+}
+
+void MinimapDotBuffer::add(u32 id, i32 army, f32 wx, f32 wz) {
+    if (map_w_ <= 0 || map_h_ <= 0) return;
+    const f32 nx = wx / map_w_;
+    const f32 nz = wz / map_h_;
+    if (nx < 0 || nx > 1 || nz < 0 || nz > 1) return;
+
+    const f32 res = static_cast<f32>(resolution_);
+    MinimapDot dot;
+    dot.x = static_cast<u16>(std::min(nx * res, res - 1));
+    dot.y = static_cast<u16>(std::min(nz * res, res - 1));
+
+    Segment& s = segments_[segment_of(army)];
+    auto it = s.slot_of.find(id);
+    if (it == s.slot_of.end()) {
+        if (s.dots.size() >= MAX_DOTS_PER_SEGMENT) return;
+        const u32 slot = static_cast<u32>(s.dots.size());
+        s.dots.push_back(dot);
+        s.ids.push_back(id);
+        s.frame.push_back(frame_);
+        s.slot_of.emplace(id, slot);
+        s.seen++;
+        mark(s, slot);
+        stats_.moved++;
+        return;
+    }
+
+    const u32 slot = it->second;
+    if (s.frame[slot] != frame_) {
+        s.frame[slot] = frame_;
+        s.seen++;
+    }
+    // Less than a minimap pixel of movement changes nothing on screen
+    if (s.dots[slot].x != dot.x || s.dots[slot].y != dot.y) {
+        s.dots[slot] = dot;
+        mark(s, slot);
+        stats_.moved++;
+    }
+}
+
+void MinimapDotBuffer::end_frame() {
+    for (auto& s : segments_) {
+        if (s.seen == s.ids.size()) continue;
+        // Back to front: the slot swapped in has already been checked
+        for (u32 slot = static_cast<u32>(s.ids.size()); slot-- > 0;) {
+            if (s.frame[slot] == frame_) continue;
+            const u32 last = static_cast<u32>(s.ids.size() - 1);
+            s.slot_of.erase(s.ids[slot]);
+            if (slot != last) {
+                s.dots[slot] = s.dots[last];
+                s.ids[slot] = s.ids[last];
+                s.frame[slot] = s.frame[last];
+                s.slot_of[s.ids[slot]] = slot;
+                mark(s, slot);
+            }
+            s.dots.pop_back();
+            s.ids.pop_back();
+            s.frame.pop_back();
+            stats_.removed++;
+        }
+    }
+}
+
+void MinimapDotBuffer::flush(MinimapUploader& uploader, u32 copy) {
+    if (copy >= copies_) return;
+    for (u32 seg = 0; seg < SEGMENTS; ++seg) {
+        Segment& s = segments_[seg];
+        auto& d = s.dirty[copy];
+        if (d.empty()) continue;
+        std::sort(d.begin(), d.end());
+        d.erase(std::unique(d.begin(), d.end()), d.end());
+        // Slots past the end were removed; the draw count drops them
+        const u32 size = static_cast<u32>(s.dots.size());
+        d.erase(std::lower_bound(d.begin(), d.end(), size), d.end());
+
+        for (size_t i = 0; i < d.size();) {
+            size_t j = i + 1;
+            while (j < d.size() && d[j] == d[j - 1] + 1) ++j;
+            const u32 first = d[i];
+            const u32 count = static_cast<u32>(j - i);
+            uploader.upload_dots(seg, first, s.dots.data() + first, count);
+            stats_.uploaded += count;
+            stats_.runs++;
+            i = j;
+        }
+        d.clear();
+    }
+}
+
+size_t MinimapDotBuffer::unit_count() const {
+    size_t n = 0;
+    for (const auto& s : segments_) n += s.ids.size();
+    return n;
+}
+
+// --- MinimapTiles ---
+
+MinimapTiles::MinimapTiles(u32 resolution)
+    : resolution_(resolution),
+      tiles_(resolution / TILE_SIZE),
+      dirty_(static_cast<size_t>(tiles_) * tiles_, 1),
+      tile_rgba_(static_cast<size_t>(TILE_SIZE) * TILE_SIZE * 4),
+      reclaim_(static_cast<size_t>(tiles_) * tiles_),
+      reclaim_prev_(static_cast<size_t>(tiles_) * tiles_) {}
+
+void MinimapTiles::set_terrain(std::vector<u8> rgba, f32 map_w, f32 map_h) {
+    terrain_ = std::move(rgba);
+    map_w_ = map_w;
+    map_h_ = map_h;
+    mark_all();
+}
+
+void MinimapTiles::update_fog(const map::VisibilityGrid* grid, u32 army) {
+    if (!grid) {
+        if (!fog_.empty()) {
+            fog_.clear();
+            fog_w_ = fog_h_ = 0;
+            mark_all();
+        }
+        return;
+    }
+    stats_.fog_updates++;
+
+    const u32 gw = grid->grid_width();
+    const u32 gh = grid->grid_height();
+    if (gw != fog_w_ || gh != fog_h_ || fog_.empty()) {
+        fog_w_ = gw;
+        fog_h_ = gh;
+        fog_cell_ = grid->cell_size();
+        fog_.assign(static_cast<size_t>(gw) * gh, 0xFF); // no level matches
+        mark_all();
+    }
+
+    const f32 to_px_x = map_w_ > 0 ? static_cast<f32>(resolution_) / map_w_ : 0;
+    const f32 to_px_z = map_h_ > 0 ? static_cast<f32>(resolution_) / map_h_ : 0;
+    const f32 cs = static_cast<f32>(fog_cell_);
+    for (u32 gz = 0; gz < gh; ++gz) {
+        for (u32 gx = 0; gx < gw; ++gx) {
+            u8 level = fog_level(grid->get(gx, gz, army));
+            u8& prev = fog_[static_cast<size_t>(gz) * gw + gx];
+            if (level == prev) continue;
+            prev = level;
+            stats_.fog_cells_changed++;
+            // Pixels whose centre lies in the cell (the last row/column
+            // also owns everything past the grid, as world_to_grid clamps)
+            u32 px0 = static_cast<u32>(static_cast<f32>(gx) * cs * to_px_x);
+            u32 py0 = static_cast<u32>(static_cast<f32>(gz) * cs * to_px_z);
+            u32 px1 = gx + 1 == gw ? resolution_ - 1
+                      : static_cast<u32>(static_cast<f32>(gx + 1) * cs * to_px_x);
+            u32 py1 = gz + 1 == gh ? resolution_ - 1
+                      : static_cast<u32>(static_cast<f32>(gz + 1) * cs * to_px_z);
+            mark_pixel_rect(px0, py0, px1, py1);
+        }
+    }
+}
+
+u8 MinimapTiles::fog_at(u32 px, u32 py) const {
+    if (fog_.empty() || map_w_ <= 0 || map_h_ <= 0) return FOG_VISION;
+    const f32 res = static_cast<f32>(resolution_);
+    const f32 wx = (static_cast<f32>(px) + 0.5f) / res * map_w_;
+    const f32 wz = (static_cast<f32>(py) + 0.5f) / res * map_h_;
+    const u32 gx = std::min(fog_w_ - 1, static_cast<u32>(wx / static_cast<f32>(fog_cell_)));
+    const u32 gz = std::min(fog_h_ - 1, static_cast<u32>(wz / static_cast<f32>(fog_cell_)));
+    return fog_[static_cast<size_t>(gz) * fog_w_ + gx];
+}
+
+void MinimapTiles::begin_reclaim() {
+    reclaim_.swap(reclaim_prev_);
+    for (auto& t : reclaim_) {
+        t.pixels.clear();
+        t.hash = 0;
+    }
+}
+
+void MinimapTiles::add_reclaim(f32 wx, f32 wz) {
+    if (map_w_ <= 0 || map_h_ <= 0) return;
+    if (wx < 0 || wz < 0 || wx > map_w_ || wz > map_h_) return;
+    const u32 px = to_pixel(wx, map_w_, resolution_);
+    const u32 py = to_pixel(wz, map_h_, resolution_);
+    auto& t = reclaim_[(py / TILE_SIZE) * tiles_ + px / TILE_SIZE];
+    const u32 pixel = py * resolution_ + px;
+    t.pixels.push_back(pixel);
+    t.hash += mix_pixel(pixel);
+}
+
+void MinimapTiles::end_reclaim() {
+    for (size_t i = 0; i < reclaim_.size(); ++i) {
+        if (reclaim_[i].pixels.size() != reclaim_prev_[i].pixels.size() ||
+            reclaim_[i].hash != reclaim_prev_[i].hash)
+            dirty_[i] = 1;
+    }
+}
+
+void MinimapTiles::mark_world_rect(f32 x0, f32 z0, f32 x1, f32 z1) {
+    mark_pixel_rect(to_pixel(std::min(x0, x1), map_w_, resolution_),
+                    to_pixel(std::min(z0, z1), map_h_, resolution_),
+                    to_pixel(std::max(x0, x1), map_w_, resolution_),
+                    to_pixel(std::max(z0, z1), map_h_, resolution_));
+}
+
+void MinimapTiles::mark_all() {
+    std::fill(dirty_.begin(), dirty_.end(), 1);
+}
+
+void MinimapTiles::mark_pixel_rect(u32 px0, u32 py0, u32 px1, u32 py1) {
+    if (tiles_ == 0) return;
+    const u32 tx0 = std::min(px0 / TILE_SIZE, tiles_ - 1);
+    const u32 ty0 = std::min(py0 / TILE_SIZE, tiles_ - 1);
+    const u32 tx1 = std::min(px1 / TILE_SIZE, tiles_ - 1);
+    const u32 ty1 = std::min(py1 / TILE_SIZE, tiles_ - 1);
+    for (u32 ty = ty0; ty <= ty1; ++ty)
+        for (u32 tx = tx0; tx <= tx1; ++tx) dirty_[ty * tiles_ + tx] = 1;
+}
+
+u32 MinimapTiles::dirty_count() const {
+    return static_cast<u32>(std::count(dirty_.begin(), dirty_.end(), 1));
+}
+
+void MinimapTiles::composite(u32 tx, u32 ty) {
+    const bool has_terrain =
+        terrain_.size() >= static_cast<size_t>(resolution_) * resolution_ * 4;
+    for (u32 y = 0; y < TILE_SIZE; ++y) {
+        const u32 py = ty * TILE_SIZE + y;
+        for (u32 x = 0; x < TILE_SIZE; ++x) {
+            const u32 px = tx * TILE_SIZE + x;
+            const f32 shade = FOG_SHADE[fog_at(px, py)];
+            const u8* src = has_terrain
+                ? &terrain_[(static_cast<size_t>(py) * resolution_ + px) * 4]
+                : nullptr;
+            u8* dst = &tile_rgba_[(static_cast<size_t>(y) * TILE_SIZE + x) * 4];
+            for (u32 c = 0; c < 3; ++c)
+                dst[c] = static_cast<u8>((src ? src[c] : 64) * shade);
+            dst[3] = 255;
+        }
+    }
+    // Wreckage on explored ground
+    for (u32 pixel : reclaim_[ty * tiles_ + tx].pixels) {
+        const u32 px = pixel % resolution_;
+        const u32 py = pixel / resolution_;
+        const u8 fog = fog_at(px, py);
+        if (fog == FOG_UNEXPLORED) continue;
+        const f32 shade = FOG_SHADE[fog];
+        u8* dst = &tile_rgba_[(static_cast<size_t>(py - ty * TILE_SIZE) * TILE_SIZE +
+                               (px - tx * TILE_SIZE)) * 4];
+        for (u32 c = 0; c < 3; ++c) dst[c] = static_cast<u8>(RECLAIM_RGB[c] * shade);
+    }
+}
+
+void MinimapTiles::flush(MinimapUploader& uploader) {
+    for (u32 ty = 0; ty < tiles_; ++ty) {
+        for (u32 tx = 0; tx < tiles_; ++tx) {
+            u8& d = dirty_[ty * tiles_ + tx];
+            if (!d) continue;
+            composite(tx, ty);
+            uploader.upload_tile(tx, ty, tile_rgba_.data());
+            stats_.tiles_uploaded++;
+            d = 0;
+        }
+    }
+}
+
+} // namespace osc::renderer
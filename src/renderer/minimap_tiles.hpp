@@ -0,0 +1,189 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+namespace osc::map {
+class VisibilityGrid;
+}
+
+namespace osc::renderer {
+
+/// One unit dot: its minimap pixel. Drawn as an instanced sprite straight
+/// from the per-army dot buffer (minimap_dot.vert), so the layout is
+/// shared with the shader's R16G16_UINT attribute.
+struct MinimapDot {
+    u16 x = 0;
+    u16 y = 0;
+};
+
+/// Receives the minimap's incremental GPU updates. MinimapRenderer writes
+/// them into its mapped buffers; tests record them.
+class MinimapUploader {
+public:
+    virtual ~MinimapUploader() = default;
+
+    /// Dots [first, first + count) of an army's segment changed.
+    virtual void upload_dots(u32 segment, u32 first, const MinimapDot* dots,
+                             u32 count) = 0;
+
+    /// A whole tile of the minimap texture changed: TILE_SIZE x TILE_SIZE
+    /// RGBA8 pixels, row-major, for tile (tx, ty).
+    virtual void upload_tile(u32 tx, u32 ty, const u8* rgba) = 0;
+};
+
+/// Unit dots kept per army in compact buffers that mirror the GPU copies.
+///
+/// Each frame the visible units are added with their world position. A
+/// unit only rewrites its dot when it moves onto another minimap pixel;
+/// units that are gone are swapped out of their segment. Changed slots are
+/// queued once per GPU copy (frames in flight) and sent as runs of
+/// consecutive slots by flush().
+class MinimapDotBuffer {
+public:
+    /// Segment 0 holds units without a valid army; army a uses a + 1.
+    static constexpr i32 MAX_ARMIES = 16;
+    static constexpr u32 SEGMENTS = MAX_ARMIES + 1;
+    static constexpr u32 MAX_DOTS_PER_SEGMENT = 4096;
+
+    /// `resolution` is the minimap side in pixels; `copies` the number of
+    /// GPU buffers fed from this one (FRAMES_IN_FLIGHT).
+    MinimapDotBuffer(u32 resolution, u32 copies);
+
+    static u32 segment_of(i32 army);
+
+    void set_map_size(f32 map_w, f32 map_h);
+
+    void begin_frame();
+
+    /// Record a unit for this frame. Units off the map are skipped; so is
+    /// a segment past MAX_DOTS_PER_SEGMENT.
+    void add(u32 id, i32 army, f32 wx, f32 wz);
+
+    /// Drop units that were not added this frame.
+    void end_frame();
+
+    /// Send the slots changed since the last flush of `copy`.
+    void flush(MinimapUploader& uploader, u32 copy);
+
+    const std::vector<MinimapDot>& dots(u32 segment) const {
+        return segments_[segment].dots;
+    }
+    u32 resolution() const { return resolution_; }
+    size_t unit_count() const;
+
+    struct Stats {
+        u64 frames = 0;
+        u64 moved = 0;    ///< dots rewritten (including new units)
+        u64 removed = 0;
+        u64 uploaded = 0; ///< dots sent, summed over copies
+        u64 runs = 0;     ///< upload_dots() calls
+    };
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Segment {
+        std::vector<MinimapDot> dots;
+        std::vector<u32> ids;   ///< unit per slot
+        std::vector<u32> frame; ///< frame the slot's unit was last added
+        std::unordered_map<u32, u32> slot_of;
+        std::vector<std::vector<u32>> dirty; ///< changed slots per copy
+        u32 seen = 0;
+    };
+
+    void mark(Segment& s, u32 slot);
+
+    u32 resolution_;
+    u32 copies_;
+    f32 map_w_ = 0, map_h_ = 0;
+    u32 frame_ = 0;
+    std::array<Segment, SEGMENTS> segments_;
+    Stats stats_;
+};
+
+/// The minimap texture split into tiles, recomposited only where fog,
+/// intel or reclaim changed.
+///
+/// Fog is compared per visibility-grid cell, so a frame where nobody's
+/// vision moved costs one byte compare per cell. Reclaim (wreckage) is
+/// re-collected each frame into per-tile lists and compared by a count and
+/// order-independent hash. A dirty tile is rebuilt from the terrain colours
+/// and sent whole by flush().
+class MinimapTiles {
+public:
+    static constexpr u32 TILE_SIZE = 32;
+
+    /// Fog levels per visibility cell: direct vision, radar/sonar/omni
+    /// only, explored, never seen.
+    static constexpr u8 FOG_VISION = 3;
+    static constexpr u8 FOG_INTEL = 2;
+    static constexpr u8 FOG_EXPLORED = 1;
+    static constexpr u8 FOG_UNEXPLORED = 0;
+
+    /// `resolution` must be a multiple of TILE_SIZE.
+    explicit MinimapTiles(u32 resolution);
+
+    /// Base terrain colours (resolution^2 RGBA8) and map size. Marks every
+    /// tile dirty.
+    void set_terrain(std::vector<u8> rgba, f32 map_w, f32 map_h);
+
+    /// Compare `army`'s fog in `grid` against the last call and mark the
+    /// tiles under changed cells. A null grid shows everything (no fog).
+    void update_fog(const map::VisibilityGrid* grid, u32 army);
+
+    void begin_reclaim();
+    void add_reclaim(f32 wx, f32 wz);
+    /// Mark tiles whose reclaim changed since the last frame.
+    void end_reclaim();
+
+    /// Mark the tiles covering a world-space rectangle.
+    void mark_world_rect(f32 x0, f32 z0, f32 x1, f32 z1);
+    void mark_all();
+
+    /// Recomposite and send the dirty tiles.
+    void flush(MinimapUploader& uploader);
+
+    u32 resolution() const { return resolution_; }
+    u32 tiles_per_side() const { return tiles_; }
+    u32 dirty_count() const;
+    bool dirty(u32 tx, u32 ty) const { return dirty_[ty * tiles_ + tx] != 0; }
+
+    /// Fog level of a minimap pixel as last seen by update_fog().
+    u8 fog_at(u32 px, u32 py) const;
+
+    struct Stats {
+        u64 fog_updates = 0;
+        u64 fog_cells_changed = 0;
+        u64 tiles_uploaded = 0;
+    };
+    const Stats& stats() const { return stats_; }
+
+private:
+    void mark_pixel_rect(u32 px0, u32 py0, u32 px1, u32 py1);
+    void composite(u32 tx, u32 ty);
+
+    u32 resolution_;
+    u32 tiles_;
+    f32 map_w_ = 0, map_h_ = 0;
+    std::vector<u8> terrain_;
+    std::vector<u8> dirty_;
+    std::vector<u8> tile_rgba_;
+
+    // Fog per visibility cell (empty until the first grid)
+    u32 fog_w_ = 0, fog_h_ = 0, fog_cell_ = 0;
+    std::vector<u8> fog_;
+
+    // Reclaim pixels per tile, this frame and last
+    struct ReclaimTile {
+        std::vector<u32> pixels; ///< py * resolution + px
+        u64 hash = 0;
+    };
+    std::vector<ReclaimTile> reclaim_, reclaim_prev_;
+
+    Stats stats_;
+};
+
+} // namespace osc::renderer
@@ -1,10 +1,10 @@
 #define VMA_IMPLEMENTATION
 #include "renderer/renderer.hpp"
 #include "core/profiler.hpp"
+#include "renderer/mesh_vertex.hpp"
 #include "renderer/pipeline_builder.hpp"
 #include "renderer/shader_utils.hpp"
 #include "renderer/terrain_mesh.hpp"
-#include "sim/scm_parser.hpp"
 #include "sim/sim_state.hpp"
 #include "sim/entity.hpp"
 #include "map/terrain.hpp"
@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstring>
 #include <unordered_map>
 
@@ -268,6 +269,9 @@ bool Renderer::init(u32 width, u32 height, const std::string& title) {
     // Shadow depth-only pipelines (need shadow_render_pass_ + bone_ds_layout_)
     create_shadow_pipelines();
 
+    // Compute pass that culls props into indirect draws
+    create_cull_pipeline();
+
     // Bloom post-processing pipelines (fullscreen triangle passes)
     create_bloom_pipelines();
 
@@ -750,30 +754,32 @@ void Renderer::create_pipelines() {
     // --- Mesh pipeline (real SCM meshes, GPU skinning, per-instance model matrix + texture) ---
     {
         std::array<VkVertexInputBindingDescription, 2> bindings{};
-        // Binding 0: per-vertex mesh data (pos + normal + UV + bone_indices + bone_weights + tangent = 64 bytes)
+        // Binding 0: per-vertex packed mesh data (pos + oct normal/tangent + UV + bone_indices = 24 bytes)
         bindings[0].binding = 0;
-        bindings[0].stride = static_cast<u32>(sizeof(sim::SCMMesh::Vertex));
+        bindings[0].stride = static_cast<u32>(sizeof(PackedMeshVertex));
         bindings[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        // Binding 1: per-instance data (mat4 model + vec4 color = 80 bytes)
+        // Binding 1: per-instance data (mat4 model + vec4 color + bone range = 96 bytes)
         bindings[1].binding = 1;
         bindings[1].stride = sizeof(MeshInstance);
         bindings[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
 
-        // 11 attributes: pos(0), normal(1), uv(2), model col0-3(3-6), color(7), bone_indices(8), bone_weights(9), tangent(10)
+        // 11 attributes: pos(0), normal(1), uv(2), model col0-3(3-6), color(7), bone_indices(8),
+        //   bone range(9), tangent(10)
         std::array<VkVertexInputAttributeDescription, 11> attrs{};
-        attrs[0] = {0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0};                              // position
-        attrs[1] = {1, 0, VK_FORMAT_R32G32B32_SFLOAT, sizeof(f32) * 3};                // normal
-        attrs[2] = {2, 0, VK_FORMAT_R32G32_SFLOAT, sizeof(f32) * 6};                   // UV
+        attrs[0] = {0, 0, VK_FORMAT_R16G16B16A16_SNORM, offsetof(PackedMeshVertex, pos)};    // position
+        attrs[1] = {1, 0, VK_FORMAT_R16G16_SNORM, offsetof(PackedMeshVertex, normal)};        // octahedral normal
+        attrs[2] = {2, 0, VK_FORMAT_R16G16_UNORM, offsetof(PackedMeshVertex, uv)};            // UV
         attrs[3] = {3, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(MeshInstance, model) + 0};
         attrs[4] = {4, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(MeshInstance, model) + sizeof(f32) * 4};
         attrs[5] = {5, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(MeshInstance, model) + sizeof(f32) * 8};
         attrs[6] = {6, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(MeshInstance, model) + sizeof(f32) * 12};
         attrs[7] = {7, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(MeshInstance, r)};   // color
-        attrs[8] = {8, 0, VK_FORMAT_R8G8B8A8_UINT, offsetof(sim::SCMMesh::Vertex, bone_indices)};    // bone_indices
-        attrs[9] = {9, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(sim::SCMMesh::Vertex, bone_weights)}; // bone_weights
-        attrs[10] = {10, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(sim::SCMMesh::Vertex, tx)};  // tangent
+        attrs[8] = {8, 0, VK_FORMAT_R8G8B8A8_UINT, offsetof(PackedMeshVertex, bone_indices)};  // bone_indices
+        attrs[9] = {10, 0, VK_FORMAT_R16G16_SNORM, offsetof(PackedMeshVertex, tangent)};      // octahedral tangent
+        attrs[10] = {9, 1, VK_FORMAT_R32G32_UINT, offsetof(MeshInstance, bone_base)};        // bone base + count
 
-        // Push constant: mat4 viewProj (64B) + uint boneBase (4B) + uint bonesPerInst (4B) + vec3 eye (12B) = 84B
+        // Push constant: mat4 viewProj (64B) + vec3 eye (12B) + pad (4B)
+        //   + vec4 quantOffset (16B) + vec4 quantScale (16B) = 112B
         mesh_pipeline_ = PipelineBuilder()
             .set_shaders(mv, mf)
             .set_vertex_input(bindings.data(),
@@ -783,7 +789,8 @@ void Renderer::create_pipelines() {
             .set_depth_test(true, true)
             .set_blend(true)
             .set_cull_mode(VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_COUNTER_CLOCKWISE)
-            .set_push_constant(sizeof(f32) * 16 + sizeof(u32) * 2 + sizeof(f32) * 3,
+            .set_push_constant(sizeof(f32) * 16 + sizeof(f32) * 4 +
+                                   sizeof(MeshQuantization),
                                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
             .set_descriptor_set_layout(texture_ds_layout_)   // set=0: albedo
             .add_descriptor_set_layout(bone_ds_layout_)       // set=1: bone SSBO
@@ -881,6 +888,28 @@ void Renderer::create_pipelines() {
             .build(device_, render_pass_, &ui_layout_);
     }
 
+    // --- Minimap dot pipeline (instanced sprites from the dot segments) ---
+    auto mdv = compile_glsl(device_, shaders::minimap_dot_vert, "minimap_dot.vert", true);
+    auto mdf = compile_glsl(device_, shaders::minimap_dot_frag, "minimap_dot.frag", false);
+    if (mdv && mdf) {
+        VkVertexInputBindingDescription binding{};
+        binding.binding = 0;
+        binding.stride = sizeof(MinimapDot);
+        binding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+        VkVertexInputAttributeDescription attr{0, 0, VK_FORMAT_R16G16_UINT, 0}; // pixel
+
+        minimap_dot_pipeline_ = PipelineBuilder()
+            .set_shaders(mdv, mdf)
+            .set_vertex_input(&binding, 1, &attr, 1)
+            .set_depth_test(false, false)
+            .set_blend(true)
+            .set_cull_mode(VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE)
+            .set_push_constant(sizeof(MinimapRenderer::DotPushConstants),
+                               VK_SHADER_STAGE_VERTEX_BIT)
+            .build(device_, render_pass_, &minimap_dot_layout_);
+    }
+
     // Destroy shader modules (already compiled into pipelines)
     vkDestroyShaderModule(device_, tv, nullptr);
     vkDestroyShaderModule(device_, tf, nullptr);
@@ -894,6 +923,8 @@ void Renderer::create_pipelines() {
     vkDestroyShaderModule(device_, df, nullptr);
     if (uiv) vkDestroyShaderModule(device_, uiv, nullptr);
     if (uif) vkDestroyShaderModule(device_, uif, nullptr);
+    if (mdv) vkDestroyShaderModule(device_, mdv, nullptr);
+    if (mdf) vkDestroyShaderModule(device_, mdf, nullptr);
 }
 
 void Renderer::create_shadow_pipelines() {
@@ -939,26 +970,26 @@ void Renderer::create_shadow_pipelines() {
     {
         std::array<VkVertexInputBindingDescription, 2> bindings{};
         bindings[0].binding = 0;
-        bindings[0].stride = static_cast<u32>(sizeof(sim::SCMMesh::Vertex));
+        bindings[0].stride = static_cast<u32>(sizeof(PackedMeshVertex));
         bindings[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
         bindings[1].binding = 1;
         bindings[1].stride = sizeof(MeshInstance);
         bindings[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
 
         std::array<VkVertexInputAttributeDescription, 11> attrs{};
-        attrs[0] = {0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0};
-        attrs[1] = {1, 0, VK_FORMAT_R32G32B32_SFLOAT, sizeof(f32) * 3};
-        attrs[2] = {2, 0, VK_FORMAT_R32G32_SFLOAT, sizeof(f32) * 6};
+        attrs[0] = {0, 0, VK_FORMAT_R16G16B16A16_SNORM, offsetof(PackedMeshVertex, pos)};
+        attrs[1] = {1, 0, VK_FORMAT_R16G16_SNORM, offsetof(PackedMeshVertex, normal)};
+        attrs[2] = {2, 0, VK_FORMAT_R16G16_UNORM, offsetof(PackedMeshVertex, uv)};
         attrs[3] = {3, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(MeshInstance, model) + 0};
         attrs[4] = {4, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(MeshInstance, model) + sizeof(f32) * 4};
         attrs[5] = {5, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(MeshInstance, model) + sizeof(f32) * 8};
         attrs[6] = {6, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(MeshInstance, model) + sizeof(f32) * 12};
         attrs[7] = {7, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(MeshInstance, r)};
-        attrs[8] = {8, 0, VK_FORMAT_R8G8B8A8_UINT, offsetof(sim::SCMMesh::Vertex, bone_indices)};
-        attrs[9] = {9, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(sim::SCMMesh::Vertex, bone_weights)};
-        attrs[10] = {10, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(sim::SCMMesh::Vertex, tx)};
+        attrs[8] = {8, 0, VK_FORMAT_R8G8B8A8_UINT, offsetof(PackedMeshVertex, bone_indices)};
+        attrs[9] = {10, 0, VK_FORMAT_R16G16_SNORM, offsetof(PackedMeshVertex, tangent)};
+        attrs[10] = {9, 1, VK_FORMAT_R32G32_UINT, offsetof(MeshInstance, bone_base)};
 
-        // Push constant 72B: mat4 lightVP (64) + uint boneBase (4) + uint bonesPerInst (4)
+        // Push constant 96B: mat4 lightVP (64) + vec4 quantOffset (16) + vec4 quantScale (16)
         shadow_mesh_pipeline_ = PipelineBuilder()
             .set_shaders(smv, sf)
             .set_vertex_input(bindings.data(),
@@ -967,7 +998,8 @@ void Renderer::create_shadow_pipelines() {
                               static_cast<u32>(attrs.size()))
             .set_depth_test(true, true)
             .set_cull_mode(VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_COUNTER_CLOCKWISE)
-            .set_push_constant(sizeof(f32) * 16 + sizeof(u32) * 2, VK_SHADER_STAGE_VERTEX_BIT)
+            .set_push_constant(sizeof(f32) * 16 + sizeof(MeshQuantization),
+                               VK_SHADER_STAGE_VERTEX_BIT)
             .set_descriptor_set_layout(bone_ds_layout_)   // set=0: bone SSBO
             .set_no_color_attachment()
             .set_depth_bias(4.0f, 1.5f)
@@ -1013,6 +1045,140 @@ void Renderer::create_shadow_pipelines() {
     spdlog::info("Shadow pipelines created (terrain + mesh + unit)");
 }
 
+void Renderer::create_cull_pipeline() {
+    // The culling pass is recorded into the graphics command buffer
+    u32 family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> families(family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &family_count,
+                                             families.data());
+    if (graphics_queue_family_ >= family_count ||
+        !(families[graphics_queue_family_].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+        spdlog::info("Graphics queue has no compute support; instances are culled on the CPU");
+        return;
+    }
+
+    // set=0, bindings 0-4: instances, LOD sets, LODs, draws, visible output
+    std::array<VkDescriptorSetLayoutBinding, 5> bindings{};
+    for (u32 i = 0; i < bindings.size(); ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    VkDescriptorSetLayoutCreateInfo ds_ci{};
+    ds_ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    ds_ci.bindingCount = static_cast<u32>(bindings.size());
+    ds_ci.pBindings = bindings.data();
+    VK_CHECK(vkCreateDescriptorSetLayout(device_, &ds_ci, nullptr, &cull_ds_layout_));
+
+    VkPushConstantRange push_range{};
+    push_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    push_range.size = sizeof(CullParams);
+
+    VkPipelineLayoutCreateInfo layout_ci{};
+    layout_ci.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_ci.setLayoutCount = 1;
+    layout_ci.pSetLayouts = &cull_ds_layout_;
+    layout_ci.pushConstantRangeCount = 1;
+    layout_ci.pPushConstantRanges = &push_range;
+    VK_CHECK(vkCreatePipelineLayout(device_, &layout_ci, nullptr, &cull_layout_));
+
+    VkShaderModule cs = compile_compute_glsl(device_, shaders::instance_cull_comp,
+                                             "instance_cull.comp");
+    if (!cs) {
+        spdlog::warn("Instance culling shader failed to compile; instances are culled on the CPU");
+        return;
+    }
+
+    VkComputePipelineCreateInfo pipe_ci{};
+    pipe_ci.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipe_ci.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipe_ci.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipe_ci.stage.module = cs;
+    pipe_ci.stage.pName = "main";
+    pipe_ci.layout = cull_layout_;
+    VkResult res = vkCreateComputePipelines(device_, VK_NULL_HANDLE, 1, &pipe_ci,
+                                            nullptr, &cull_pipeline_);
+    vkDestroyShaderModule(device_, cs, nullptr);
+    if (res != VK_SUCCESS) {
+        cull_pipeline_ = VK_NULL_HANDLE;
+        spdlog::warn("Instance culling pipeline creation failed; instances are culled on the CPU");
+        return;
+    }
+
+    VkDescriptorPoolSize pool_size{};
+    pool_size.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pool_size.descriptorCount = FRAMES_IN_FLIGHT * static_cast<u32>(bindings.size());
+
+    VkDescriptorPoolCreateInfo pool_ci{};
+    pool_ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_ci.maxSets = FRAMES_IN_FLIGHT;
+    pool_ci.poolSizeCount = 1;
+    pool_ci.pPoolSizes = &pool_size;
+    VK_CHECK(vkCreateDescriptorPool(device_, &pool_ci, nullptr, &cull_ds_pool_));
+
+    for (u32 i = 0; i < FRAMES_IN_FLIGHT; ++i) {
+        VkDescriptorSetAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        alloc_info.descriptorPool = cull_ds_pool_;
+        alloc_info.descriptorSetCount = 1;
+        alloc_info.pSetLayouts = &cull_ds_layout_;
+        VK_CHECK(vkAllocateDescriptorSets(device_, &alloc_info, &cull_ds_[i]));
+    }
+
+    unit_renderer_.set_gpu_culling(true);
+    spdlog::info("GPU instance culling enabled for units, projectiles and props");
+}
+
+void Renderer::record_instance_culling(VkCommandBuffer cmd, u32 fi) {
+    u32 count = unit_renderer_.cull_instance_count();
+    if (!cull_pipeline_ || count == 0) return;
+    PROFILE_ZONE("Render::instance_culling");
+
+    // Point the set at this frame's buffers again after they were regrown
+    auto bufs = unit_renderer_.cull_buffers(fi);
+    if (bufs.version != cull_ds_version_[fi]) {
+        const VkBuffer targets[] = {bufs.instances, bufs.sets, bufs.lods,
+                                    bufs.draws, bufs.visible};
+        std::array<VkDescriptorBufferInfo, 5> infos{};
+        std::array<VkWriteDescriptorSet, 5> writes{};
+        for (u32 i = 0; i < writes.size(); ++i) {
+            infos[i].buffer = targets[i];
+            infos[i].offset = 0;
+            infos[i].range = VK_WHOLE_SIZE;
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = cull_ds_[fi];
+            writes[i].dstBinding = i;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].descriptorCount = 1;
+            writes[i].pBufferInfo = &infos[i];
+        }
+        vkUpdateDescriptorSets(device_, static_cast<u32>(writes.size()),
+                               writes.data(), 0, nullptr);
+        cull_ds_version_[fi] = bufs.version;
+    }
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, cull_pipeline_);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, cull_layout_,
+                            0, 1, &cull_ds_[fi], 0, nullptr);
+    const CullParams& params = unit_renderer_.cull_params();
+    vkCmdPushConstants(cmd, cull_layout_, VK_SHADER_STAGE_COMPUTE_BIT,
+                       0, sizeof(params), &params);
+    vkCmdDispatch(cmd, (count + 63) / 64, 1, 1);
+
+    // Draw counts and culled instances are read by the shadow and scene passes
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT |
+                            VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
 void Renderer::create_bloom_resources() {
     u32 w = window_width_;
     u32 h = window_height_;
@@ -1364,6 +1530,9 @@ void Renderer::clear_scene() {
         bone_ds_pool_ = VK_NULL_HANDLE;
         for (auto& ds : bone_ds_) ds = VK_NULL_HANDLE;
     }
+    // The unit renderer's cull buffers are gone; rewrite the sets on next use
+    for (auto& v : cull_ds_version_) v = 0;
+    for (auto& v : bone_ds_version_) v = 0;
     if (terrain_tex_ds_pool_) {
         vkDestroyDescriptorPool(device_, terrain_tex_ds_pool_, nullptr);
         terrain_tex_ds_pool_ = VK_NULL_HANDLE;
@@ -1833,6 +2002,8 @@ void Renderer::render(sim::SimState& sim, lua_State* L,
 
     // Finalize any async texture loads that completed this frame
     texture_cache_.flush_uploads(4);
+    // Upload meshes parsed in the background (before unit lookups below)
+    mesh_cache_.flush_uploads();
 
     // View-projection matrix (computed early for frustum culling)
     f32 aspect = static_cast<f32>(window_width_) /
@@ -1840,9 +2011,21 @@ void Renderer::render(sim::SimState& sim, lua_State* L,
     auto vp = camera_.view_proj(aspect);
     Frustum frustum(vp);
 
+    // Terrain chunk LODs by screen-space error, culled against the frustum
+    if (!terrain_mesh_.empty()) {
+        PROFILE_ZONE("Render::terrain_lod");
+        TerrainLODParams lod_params;
+        camera_.eye_position(lod_params.eye[0], lod_params.eye[1],
+                             lod_params.eye[2]);
+        lod_params.projection_scale = static_cast<f32>(window_height_) /
+                                      (2.0f * std::tan(Camera::FOV_Y * 0.5f));
+        terrain_mesh_.select(lod_params, &frustum);
+    }
+
     // Update unit instances (mesh + cube fallback + texture resolution + frustum culling)
     {
         PROFILE_ZONE("Render::unit_update");
+        unit_renderer_.set_frame_index(fi); // update() writes this frame's buffers
         unit_renderer_.update(sim, mesh_cache_, L, &texture_cache_, &camera_,
                               selected_ids, &frustum);
     }
@@ -1951,6 +2134,9 @@ void Renderer::render(sim::SimState& sim, lua_State* L,
 
     // Update minimap (terrain bg, unit dots, camera frustum box)
     minimap_renderer_.update(sim, camera_, texture_cache_, selected_ids,
+                              (fog_enabled_ && player_army_ >= 0)
+                                  ? sim.visibility_grid() : nullptr,
+                              static_cast<u32>(std::max(player_army_, 0)),
                               window_width_, window_height_);
 
     // Update strategic icons (zoom-dependent 2D icons replacing 3D meshes)
@@ -1995,6 +2181,32 @@ void Renderer::render(sim::SimState& sim, lua_State* L,
         fog_renderer_.record_upload(cmd_buf_[fi]);
     }
 
+    // Upload changed minimap dots and terrain tiles
+    minimap_renderer_.record_upload(cmd_buf_[fi]);
+
+    // Cull instances into indirect draws (compute, before any render pass)
+    record_instance_culling(cmd_buf_[fi], fi);
+
+    // Point the bone set at this frame's SSBO again after it was regrown
+    VkBuffer bone_buf = unit_renderer_.bone_ssbo_buffer(fi);
+    if (bone_ds_[fi] && bone_buf &&
+        unit_renderer_.bone_ssbo_version(fi) != bone_ds_version_[fi]) {
+        VkDescriptorBufferInfo buf_info{};
+        buf_info.buffer = bone_buf;
+        buf_info.offset = 0;
+        buf_info.range = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = bone_ds_[fi];
+        write.dstBinding = 0;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.descriptorCount = 1;
+        write.pBufferInfo = &buf_info;
+        vkUpdateDescriptorSets(device_, 1, &write, 0, nullptr);
+        bone_ds_version_[fi] = unit_renderer_.bone_ssbo_version(fi);
+    }
+
     // ==================== SHADOW PASS ====================
     if (shadow_render_pass_ && shadow_framebuffer_ && light_ubo_mapped_[fi]) {
         PROFILE_ZONE("Render::shadow_pass");
@@ -2026,24 +2238,20 @@ void Renderer::render(sim::SimState& sim, lua_State* L,
         vkCmdSetScissor(cmd_buf_[fi], 0, 1, &shadow_sc);
 
         // Shadow terrain
-        if (terrain_mesh_.index_count() > 0 && shadow_terrain_pipeline_) {
+        if (!terrain_mesh_.empty() && shadow_terrain_pipeline_) {
             vkCmdBindPipeline(cmd_buf_[fi], VK_PIPELINE_BIND_POINT_GRAPHICS,
                               shadow_terrain_pipeline_);
             vkCmdPushConstants(cmd_buf_[fi], shadow_terrain_layout_,
                                VK_SHADER_STAGE_VERTEX_BIT,
                                0, sizeof(f32) * 16, light_vp.data());
-
-            VkBuffer vbufs[] = {terrain_mesh_.vertex_buffer()};
-            VkDeviceSize offsets[] = {0};
-            vkCmdBindVertexBuffers(cmd_buf_[fi], 0, 1, vbufs, offsets);
-            vkCmdBindIndexBuffer(cmd_buf_[fi], terrain_mesh_.index_buffer(), 0,
-                                 VK_INDEX_TYPE_UINT32);
-            vkCmdDrawIndexed(cmd_buf_[fi], terrain_mesh_.index_count(), 1, 0, 0, 0);
+            terrain_mesh_.draw(cmd_buf_[fi], false);
         }
 
         // Shadow meshes (skip when strategic zoom replaces 3D units with icons)
         if (!strategic_icon_renderer_.is_strategic_zoom() &&
-            !unit_renderer_.mesh_groups().empty() && shadow_mesh_pipeline_ && bone_ds_[fi]) {
+            (!unit_renderer_.mesh_groups().empty() ||
+             !unit_renderer_.culled_groups().empty()) &&
+            shadow_mesh_pipeline_ && bone_ds_[fi] && bone_buf) {
             vkCmdBindPipeline(cmd_buf_[fi], VK_PIPELINE_BIND_POINT_GRAPHICS,
                               shadow_mesh_pipeline_);
 
@@ -2052,18 +2260,17 @@ void Renderer::render(sim::SimState& sim, lua_State* L,
                                     shadow_mesh_layout_, 0, 1, &bone_ds_[fi],
                                     0, nullptr);
 
+            // Bone ranges are per instance (vertex binding 1)
             struct ShadowMeshPC {
                 f32 lightVP[16];
-                u32 boneBase;
-                u32 bonesPerInst;
+                MeshQuantization quant;
             } spc{};
             std::memcpy(spc.lightVP, light_vp.data(), sizeof(f32) * 16);
 
             for (auto& group : unit_renderer_.mesh_groups()) {
                 if (!group.mesh || group.instance_count == 0) continue;
 
-                spc.boneBase = group.bone_base_offset;
-                spc.bonesPerInst = group.bones_per_instance;
+                spc.quant = group.mesh->quant;
                 vkCmdPushConstants(cmd_buf_[fi], shadow_mesh_layout_,
                                    VK_SHADER_STAGE_VERTEX_BIT,
                                    0, sizeof(spc), &spc);
@@ -2080,6 +2287,28 @@ void Renderer::render(sim::SimState& sim, lua_State* L,
                 vkCmdDrawIndexed(cmd_buf_[fi], group.mesh->index_count,
                                  group.instance_count, 0, 0, 0);
             }
+
+            // GPU-culled instances: counts come from the culling pass
+            for (auto& group : unit_renderer_.culled_groups()) {
+                spc.quant = group.mesh->quant;
+                vkCmdPushConstants(cmd_buf_[fi], shadow_mesh_layout_,
+                                   VK_SHADER_STAGE_VERTEX_BIT,
+                                   0, sizeof(spc), &spc);
+
+                VkBuffer vbufs[] = {group.mesh->vertex_buf.buffer,
+                                    unit_renderer_.culled_instance_buffer()};
+                VkDeviceSize buf_offsets[] = {
+                    0,
+                    static_cast<VkDeviceSize>(group.first_instance) *
+                        sizeof(MeshInstance)};
+                vkCmdBindVertexBuffers(cmd_buf_[fi], 0, 2, vbufs, buf_offsets);
+                vkCmdBindIndexBuffer(cmd_buf_[fi], group.mesh->index_buf.buffer, 0,
+                                     VK_INDEX_TYPE_UINT32);
+                vkCmdDrawIndexedIndirect(cmd_buf_[fi],
+                                         unit_renderer_.culled_draw_buffer(),
+                                         group.command_offset, 1,
+                                         sizeof(DrawIndexedIndirect));
+            }
         }
 
         // Shadow cubes (skip when strategic zoom active)
@@ -2137,7 +2366,7 @@ void Renderer::render(sim::SimState& sim, lua_State* L,
     vkCmdSetScissor(cmd_buf_[fi], 0, 1, &scissor);
 
     // 1. Draw terrain
-    if (terrain_mesh_.index_count() > 0 && terrain_pipeline_) {
+    if (!terrain_mesh_.empty() && terrain_pipeline_) {
         vkCmdBindPipeline(cmd_buf_[fi], VK_PIPELINE_BIND_POINT_GRAPHICS,
                           terrain_pipeline_);
 
@@ -2178,12 +2407,7 @@ void Renderer::render(sim::SimState& sim, lua_State* L,
                                     0, nullptr);
         }
 
-        VkBuffer vbufs[] = {terrain_mesh_.vertex_buffer()};
-        VkDeviceSize offsets[] = {0};
-        vkCmdBindVertexBuffers(cmd_buf_[fi], 0, 1, vbufs, offsets);
-        vkCmdBindIndexBuffer(cmd_buf_[fi], terrain_mesh_.index_buffer(), 0,
-                             VK_INDEX_TYPE_UINT32);
-        vkCmdDrawIndexed(cmd_buf_[fi], terrain_mesh_.index_count(), 1, 0, 0, 0);
+        terrain_mesh_.draw(cmd_buf_[fi], true);
     }
 
     // 2. Draw decals (textured quads on terrain)
@@ -2258,16 +2482,18 @@ void Renderer::render(sim::SimState& sim, lua_State* L,
     // 3. Draw mesh units (real SCM models with GPU skinning)
     //    Skip when strategic zoom replaces 3D units with 2D icons.
     if (!strategic_icon_renderer_.is_strategic_zoom() &&
-        !unit_renderer_.mesh_groups().empty() && mesh_pipeline_) {
+        (!unit_renderer_.mesh_groups().empty() ||
+         !unit_renderer_.culled_groups().empty()) && mesh_pipeline_ &&
+        unit_renderer_.bone_ssbo_buffer(fi)) {
         vkCmdBindPipeline(cmd_buf_[fi], VK_PIPELINE_BIND_POINT_GRAPHICS,
                           mesh_pipeline_);
 
-        // Push viewProj as first 64 bytes (bone offsets per-group below)
+        // Push viewProj as first 64 bytes (bone ranges are per instance)
         struct MeshPushConstants {
             f32 viewProj[16];
-            u32 boneBase;
-            u32 bonesPerInst;
             f32 eyeX, eyeY, eyeZ;
+            f32 pad;
+            MeshQuantization quant;
         } mesh_pc{};
         std::memcpy(mesh_pc.viewProj, vp.data(), sizeof(f32) * 16);
         camera_.eye_position(mesh_pc.eyeX, mesh_pc.eyeY, mesh_pc.eyeZ);
@@ -2312,39 +2538,36 @@ void Renderer::render(sim::SimState& sim, lua_State* L,
                                     0, nullptr);
         }
 
-        for (auto& group : unit_renderer_.mesh_groups()) {
-            if (!group.mesh || group.instance_count == 0) continue;
-
-            // Bind per-group albedo texture descriptor (always bind to avoid
-            // stale set=0 from prior group)
-            VkDescriptorSet albedo_ds = group.texture_ds ? group.texture_ds : fallback_ds;
+        // Bind per-group albedo / specteam / normal descriptors (always bind
+        // to avoid stale sets 0/2/3 from the prior group)
+        auto bind_group_textures = [&](VkDescriptorSet albedo, VkDescriptorSet spec,
+                                       VkDescriptorSet norm) {
+            VkDescriptorSet albedo_ds = albedo ? albedo : fallback_ds;
             if (albedo_ds) {
                 vkCmdBindDescriptorSets(cmd_buf_[fi], VK_PIPELINE_BIND_POINT_GRAPHICS,
                                         mesh_layout_, 0, 1, &albedo_ds,
                                         0, nullptr);
             }
-
-            // Bind per-group specteam texture descriptor (always bind to avoid
-            // stale set=2 from prior group)
-            VkDescriptorSet spec_ds = group.specteam_ds ? group.specteam_ds : specteam_fallback;
+            VkDescriptorSet spec_ds = spec ? spec : specteam_fallback;
             if (spec_ds) {
                 vkCmdBindDescriptorSets(cmd_buf_[fi], VK_PIPELINE_BIND_POINT_GRAPHICS,
                                         mesh_layout_, 2, 1, &spec_ds,
                                         0, nullptr);
             }
-
-            // Bind per-group normal map descriptor (always bind to avoid
-            // stale set=3 from prior group)
-            VkDescriptorSet norm_ds = group.normal_ds ? group.normal_ds : normal_fallback;
+            VkDescriptorSet norm_ds = norm ? norm : normal_fallback;
             if (norm_ds) {
                 vkCmdBindDescriptorSets(cmd_buf_[fi], VK_PIPELINE_BIND_POINT_GRAPHICS,
                                         mesh_layout_, 3, 1, &norm_ds,
                                         0, nullptr);
             }
+        };
+
+        for (auto& group : unit_renderer_.mesh_groups()) {
+            if (!group.mesh || group.instance_count == 0) continue;
+
+            bind_group_textures(group.texture_ds, group.specteam_ds, group.normal_ds);
 
-            // Push bone offsets per group
-            mesh_pc.boneBase = group.bone_base_offset;
-            mesh_pc.bonesPerInst = group.bones_per_instance;
+            mesh_pc.quant = group.mesh->quant;
             vkCmdPushConstants(cmd_buf_[fi], mesh_layout_,
                                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
                                0, sizeof(mesh_pc), &mesh_pc);
@@ -2361,6 +2584,30 @@ void Renderer::render(sim::SimState& sim, lua_State* L,
             vkCmdDrawIndexed(cmd_buf_[fi], group.mesh->index_count,
                              group.instance_count, 0, 0, 0);
         }
+
+        // GPU-culled instances: one indirect draw per LOD, counted by the
+        // culling pass
+        for (auto& group : unit_renderer_.culled_groups()) {
+            bind_group_textures(group.texture_ds, group.specteam_ds, group.normal_ds);
+
+            mesh_pc.quant = group.mesh->quant;
+            vkCmdPushConstants(cmd_buf_[fi], mesh_layout_,
+                               VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                               0, sizeof(mesh_pc), &mesh_pc);
+
+            VkBuffer vbufs[] = {group.mesh->vertex_buf.buffer,
+                                unit_renderer_.culled_instance_buffer()};
+            VkDeviceSize buf_offsets[] = {
+                0,
+                static_cast<VkDeviceSize>(group.first_instance) *
+                    sizeof(MeshInstance)};
+            vkCmdBindVertexBuffers(cmd_buf_[fi], 0, 2, vbufs, buf_offsets);
+            vkCmdBindIndexBuffer(cmd_buf_[fi], group.mesh->index_buf.buffer, 0,
+                                 VK_INDEX_TYPE_UINT32);
+            vkCmdDrawIndexedIndirect(cmd_buf_[fi], unit_renderer_.culled_draw_buffer(),
+                                     group.command_offset, 1,
+                                     sizeof(DrawIndexedIndirect));
+        }
     }
 
     // 4. Draw cube fallback units (skip when strategic zoom active)
@@ -2571,9 +2818,8 @@ void Renderer::render(sim::SimState& sim, lua_State* L,
 
     // 8. Draw minimap (terrain bg + unit dots + camera box)
     if (ui_pipeline_ && minimap_renderer_.quad_count() > 0) {
-        vkCmdBindPipeline(cmd_buf_[fi], VK_PIPELINE_BIND_POINT_GRAPHICS,
-                          ui_pipeline_);
-        minimap_renderer_.render(cmd_buf_[fi], ui_layout_,
+        minimap_renderer_.render(cmd_buf_[fi], ui_pipeline_, ui_layout_,
+                                  minimap_dot_pipeline_, minimap_dot_layout_,
                                   window_width_, window_height_);
     }
 
@@ -2679,12 +2925,13 @@ void Renderer::render_ui_only(lua_State* L, ui::UIControlRegistry* ui_registry)
 
     // Advance playing movie controls and upload new frames
     if (ui_registry) {
+        f64 now = glfwGetTime();
         for (auto& ctrl_ptr : ui_registry->all()) {
             if (!ctrl_ptr || ctrl_ptr->destroyed()) continue;
-            // Decode next frame for playing movies
+            // Swap in the frame due now (decoded on the movie's own thread)
             if (ctrl_ptr->movie_playing() && ctrl_ptr->video_decoder()) {
                 auto* dec = ctrl_ptr->video_decoder();
-                if (dec->is_open() && dec->decode_next_frame()) {
+                if (dec->is_open() && dec->present(now)) {
                     ctrl_ptr->set_video_needs_upload(true);
                 }
             }
@@ -2902,6 +3149,14 @@ void Renderer::shutdown() {
     mesh_cache_.destroy(device_, allocator_);
     texture_cache_.destroy(device_, allocator_);
 
+    // Instance culling
+    if (cull_ds_pool_)
+        vkDestroyDescriptorPool(device_, cull_ds_pool_, nullptr);
+    if (cull_pipeline_) vkDestroyPipeline(device_, cull_pipeline_, nullptr);
+    if (cull_layout_) vkDestroyPipelineLayout(device_, cull_layout_, nullptr);
+    if (cull_ds_layout_)
+        vkDestroyDescriptorSetLayout(device_, cull_ds_layout_, nullptr);
+
     // Bone SSBO infrastructure
     if (bone_ds_pool_)
         vkDestroyDescriptorPool(device_, bone_ds_pool_, nullptr);
@@ -2966,6 +3221,10 @@ void Renderer::shutdown() {
     vkDestroyPipelineLayout(device_, decal_layout_, nullptr);
     if (ui_pipeline_) vkDestroyPipeline(device_, ui_pipeline_, nullptr);
     if (ui_layout_) vkDestroyPipelineLayout(device_, ui_layout_, nullptr);
+    if (minimap_dot_pipeline_)
+        vkDestroyPipeline(device_, minimap_dot_pipeline_, nullptr);
+    if (minimap_dot_layout_)
+        vkDestroyPipelineLayout(device_, minimap_dot_layout_, nullptr);
 
     // Sync (per-frame)
     for (u32 i = 0; i < FRAMES_IN_FLIGHT; ++i) {
@@ -121,6 +121,8 @@ private:
     void recreate_swapchain();
     void create_shadow_resources();
     void create_shadow_pipelines();
+    void create_cull_pipeline();
+    void record_instance_culling(VkCommandBuffer cmd, u32 fi);
     std::array<f32, 16> compute_light_vp() const;
 
     // GLFW
@@ -181,6 +183,15 @@ private:
     VkDescriptorSetLayout bone_ds_layout_ = VK_NULL_HANDLE;
     VkDescriptorPool bone_ds_pool_ = VK_NULL_HANDLE;
     VkDescriptorSet bone_ds_[FRAMES_IN_FLIGHT] = {};
+    u32 bone_ds_version_[FRAMES_IN_FLIGHT] = {}; // UnitRenderer::bone_ssbo_version written
+
+    // GPU instance culling (compute; fills UnitRenderer's indirect draws)
+    VkPipeline cull_pipeline_ = VK_NULL_HANDLE;
+    VkPipelineLayout cull_layout_ = VK_NULL_HANDLE;
+    VkDescriptorSetLayout cull_ds_layout_ = VK_NULL_HANDLE;
+    VkDescriptorPool cull_ds_pool_ = VK_NULL_HANDLE;
+    VkDescriptorSet cull_ds_[FRAMES_IN_FLIGHT] = {};
+    u32 cull_ds_version_[FRAMES_IN_FLIGHT] = {}; // CullFrameBuffers::version written
 
     // Terrain texture infrastructure (set=0 for terrain pipeline: 11 samplers)
     VkDescriptorSetLayout terrain_tex_ds_layout_ = VK_NULL_HANDLE;
@@ -242,6 +253,10 @@ private:
     VkPipeline ui_pipeline_ = VK_NULL_HANDLE;
     VkPipelineLayout ui_layout_ = VK_NULL_HANDLE;
 
+    // Minimap unit dots (instanced sprites from MinimapRenderer's segments)
+    VkPipeline minimap_dot_pipeline_ = VK_NULL_HANDLE;
+    VkPipelineLayout minimap_dot_layout_ = VK_NULL_HANDLE;
+
     // Shadow mapping
     AllocatedImage shadow_image_{};
     VkSampler shadow_sampler_ = VK_NULL_HANDLE;
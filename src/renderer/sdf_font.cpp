@@ -0,0 +1,247 @@
+#include "stb/stb_truetype.h"
+
+#include "renderer/sdf_font.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace osc::renderer {
+
+namespace {
+
+/// File layout: header, glyph table, then the R8 atlas rows.
+struct AtlasHeader {
+    char magic[4];      // "OSCF"
+    u32 version;        // ATLAS_VERSION
+    u64 font_hash;
+    i32 ascent, descent, line_gap;
+    u32 width, height;
+    u32 glyph_count;
+    f32 base_size;      // SdfFont::BASE_SIZE when written
+    i32 padding;        // SdfFont::PADDING when written
+};
+
+constexpr char ATLAS_MAGIC[4] = {'O', 'S', 'C', 'F'};
+constexpr u32 ATLAS_VERSION = 1;
+constexpr u32 MAX_ATLAS_SIDE = 4096;
+
+static_assert(std::is_trivially_copyable_v<SdfFont::Glyph>);
+
+u32 next_pow2(u32 v) {
+    if (v <= 1) return 1;
+    v--;
+    v |= v >> 1; v |= v >> 2; v |= v >> 4;
+    v |= v >> 8; v |= v >> 16;
+    return v + 1;
+}
+
+} // namespace
+
+u64 SdfFont::hash(const u8* data, size_t len) {
+    u64 h = 14695981039346656037ull;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= data[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+bool SdfFont::build(const u8* ttf, size_t len) {
+    *this = SdfFont{};
+    // stb_truetype trusts its input: reject anything without a font header
+    if (!ttf || len < 12) return false;
+    const int offset = stbtt_GetFontOffsetForIndex(ttf, 0);
+    stbtt_fontinfo font;
+    if (offset < 0 || !stbtt_InitFont(&font, ttf, offset)) return false;
+
+    font_hash_ = hash(ttf, len);
+    stbtt_GetFontVMetrics(&font, &ascent_, &descent_, &line_gap_);
+    if (ascent_ - descent_ <= 0) return false;
+
+    const f32 scale = stbtt_ScaleForPixelHeight(&font, BASE_SIZE);
+    // Field falls from ON_EDGE on the outline to 0 at PADDING pixels out
+    const f32 dist_scale = static_cast<f32>(ON_EDGE) / PADDING;
+
+    // Shelf-pack in codepoint order, one pixel apart
+    std::vector<unsigned char*> bitmaps;
+    u32 pen_x = 0, pen_y = 0, shelf_h = 0;
+    for (u32 cp = FIRST_CHAR; cp <= LAST_CHAR; cp++) {
+        const int glyph = stbtt_FindGlyphIndex(&font, static_cast<int>(cp));
+
+        Glyph g;
+        g.codepoint = cp;
+        int advance_raw, lsb;
+        stbtt_GetGlyphHMetrics(&font, glyph, &advance_raw, &lsb);
+        g.advance = advance_raw;
+
+        int w = 0, h = 0, xoff = 0, yoff = 0;
+        unsigned char* sdf = stbtt_GetGlyphSDF(&font, scale, glyph, PADDING,
+                                               ON_EDGE, dist_scale,
+                                               &w, &h, &xoff, &yoff);
+        if (sdf) {
+            if (pen_x + static_cast<u32>(w) > ATLAS_WIDTH) {
+                pen_x = 0;
+                pen_y += shelf_h + 1;
+                shelf_h = 0;
+            }
+            g.x = static_cast<u16>(pen_x);
+            g.y = static_cast<u16>(pen_y);
+            g.w = static_cast<u16>(w);
+            g.h = static_cast<u16>(h);
+            g.x_offset = static_cast<i16>(xoff);
+            g.y_offset = static_cast<i16>(yoff);
+            pen_x += static_cast<u32>(w) + 1;
+            shelf_h = std::max(shelf_h, static_cast<u32>(h));
+        }
+        glyphs_.push_back(g);
+        bitmaps.push_back(sdf);
+    }
+
+    width_ = ATLAS_WIDTH;
+    height_ = next_pow2(pen_y + shelf_h);
+    pixels_.assign(static_cast<size_t>(width_) * height_, 0);
+    for (size_t i = 0; i < glyphs_.size(); i++) {
+        if (!bitmaps[i]) continue;
+        const Glyph& g = glyphs_[i];
+        for (u32 row = 0; row < g.h; row++)
+            std::memcpy(&pixels_[static_cast<size_t>(g.y + row) * width_ + g.x],
+                        bitmaps[i] + static_cast<size_t>(row) * g.w, g.w);
+        stbtt_FreeSDF(bitmaps[i], nullptr);
+    }
+
+    rebuild_index();
+    return true;
+}
+
+void SdfFont::rebuild_index() {
+    index_.assign(BMP_SIZE, 0);
+    for (size_t i = 0; i < glyphs_.size(); i++) {
+        if (glyphs_[i].codepoint < BMP_SIZE)
+            index_[glyphs_[i].codepoint] = static_cast<u16>(i + 1);
+    }
+}
+
+FontMetrics SdfFont::metrics(f32 pointsize) const {
+    FontMetrics m{};
+    if (ascent_ - descent_ <= 0) return m;
+    const f32 scale = pointsize / static_cast<f32>(ascent_ - descent_);
+    m.ascent = ascent_ * scale;
+    m.descent = -descent_ * scale; // stb gives negative descent
+    m.line_gap = line_gap_ * scale;
+    m.line_height = m.ascent + m.descent + m.line_gap;
+    return m;
+}
+
+void SdfFont::glyphs_at(f32 pointsize, std::vector<GlyphInfo>& out) const {
+    out.clear();
+    if (ascent_ - descent_ <= 0 || width_ == 0 || height_ == 0) return;
+    // Advances use the font's own scale, quads the atlas scale
+    const f32 units = pointsize / static_cast<f32>(ascent_ - descent_);
+    const f32 s = pointsize / BASE_SIZE;
+    const f32 inv_w = 1.0f / static_cast<f32>(width_);
+    const f32 inv_h = 1.0f / static_cast<f32>(height_);
+
+    // Keep one screen pixel of padding around the outline for the edge
+    // ramp; the rest only matters when the field is magnified further
+    const f32 keep = std::min(static_cast<f32>(PADDING), 1.0f / s);
+    const f32 trim = static_cast<f32>(PADDING) - keep;
+
+    out.reserve(glyphs_.size());
+    for (const auto& g : glyphs_) {
+        GlyphInfo gi{};
+        gi.x_advance = g.advance * units;
+        if (g.w > 0 && g.h > 0) {
+            gi.u0 = SDF_UV_OFFSET + (g.x + trim) * inv_w;
+            gi.v0 = (g.y + trim) * inv_h;
+            gi.u1 = SDF_UV_OFFSET + (g.x + g.w - trim) * inv_w;
+            gi.v1 = (g.y + g.h - trim) * inv_h;
+            gi.x_offset = (g.x_offset + trim) * s;
+            gi.y_offset = (g.y_offset + trim) * s;
+            gi.width = (g.w - 2.0f * trim) * s;
+            gi.height = (g.h - 2.0f * trim) * s;
+        }
+        out.push_back(gi);
+    }
+}
+
+bool SdfFont::save(const fs::path& path) const {
+    AtlasHeader header{};
+    std::memcpy(header.magic, ATLAS_MAGIC, sizeof(ATLAS_MAGIC));
+    header.version = ATLAS_VERSION;
+    header.font_hash = font_hash_;
+    header.ascent = ascent_;
+    header.descent = descent_;
+    header.line_gap = line_gap_;
+    header.width = width_;
+    header.height = height_;
+    header.glyph_count = static_cast<u32>(glyphs_.size());
+    header.base_size = BASE_SIZE;
+    header.padding = PADDING;
+
+    std::error_code ec;
+    if (path.has_parent_path()) fs::create_directories(path.parent_path(), ec);
+
+    // Write beside the file and rename over it, so a concurrent reader
+    // never sees a partial atlas
+    fs::path tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+            !out.write(reinterpret_cast<const char*>(glyphs_.data()),
+                       glyphs_.size() * sizeof(Glyph)) ||
+            !out.write(reinterpret_cast<const char*>(pixels_.data()),
+                       pixels_.size())) {
+            out.close();
+            fs::remove(tmp, ec);
+            return false;
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+bool SdfFont::load(const fs::path& path, u64 font_hash) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    AtlasHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, ATLAS_MAGIC, sizeof(ATLAS_MAGIC)) != 0 ||
+        header.version != ATLAS_VERSION || header.font_hash != font_hash ||
+        header.base_size != BASE_SIZE || header.padding != PADDING ||
+        header.ascent - header.descent <= 0 ||
+        header.width == 0 || header.width > MAX_ATLAS_SIDE ||
+        header.height == 0 || header.height > MAX_ATLAS_SIDE ||
+        header.glyph_count == 0 || header.glyph_count >= BMP_SIZE)
+        return false;
+
+    std::vector<Glyph> glyphs(header.glyph_count);
+    std::vector<u8> pixels(static_cast<size_t>(header.width) * header.height);
+    if (!in.read(reinterpret_cast<char*>(glyphs.data()),
+                 glyphs.size() * sizeof(Glyph)) ||
+        !in.read(reinterpret_cast<char*>(pixels.data()), pixels.size()))
+        return false;
+    for (const auto& g : glyphs) {
+        if (g.x + g.w > header.width || g.y + g.h > header.height) return false;
+    }
+
+    font_hash_ = header.font_hash;
+    ascent_ = header.ascent;
+    descent_ = header.descent;
+    line_gap_ = header.line_gap;
+    width_ = header.width;
+    height_ = header.height;
+    glyphs_ = std::move(glyphs);
+    pixels_ = std::move(pixels);
+    rebuild_index();
+    return true;
+}
+
+} // namespace osc::renderer
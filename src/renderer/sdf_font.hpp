@@ -0,0 +1,106 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <vector>
+
+namespace osc::renderer {
+
+/// Per-glyph data for a character at one point size.
+struct GlyphInfo {
+    f32 u0, v0, u1, v1;  // UV coords in atlas (SDF atlases: u + SDF_UV_OFFSET)
+    f32 x_offset;         // left bearing in pixels
+    f32 y_offset;         // top bearing in pixels (from baseline)
+    f32 width;            // glyph bitmap width in pixels
+    f32 height;           // glyph bitmap height in pixels
+    f32 x_advance;        // horizontal advance in pixels
+};
+
+/// Font metrics for a loaded font at a specific point size.
+struct FontMetrics {
+    f32 ascent;           // pixels above baseline
+    f32 descent;          // pixels below baseline (positive value)
+    f32 line_gap;         // extra leading between lines
+    f32 line_height;      // ascent + descent + line_gap
+};
+
+/// Glyph UVs into a distance-field atlas are shifted by this much, far
+/// below anything a bitmap or tiled quad uses. ui.frag reads u < -32 as
+/// "alpha is a distance, 0.5 on the outline" and samples at
+/// u - SDF_UV_OFFSET, so text keeps the plain UIInstance layout and every
+/// UI pipeline user draws it unchanged.
+inline constexpr f32 SDF_UV_OFFSET = -64.0f;
+
+/// A signed-distance-field glyph atlas for one font file.
+///
+/// Glyphs are rasterized once at BASE_SIZE pixels with a PADDING margin of
+/// distance falloff, then scaled to any point size: glyphs_at() produces the
+/// same metrics and advances as rasterizing with stb_truetype at that size,
+/// with each quad keeping about a pixel of the padding for the edge ramp.
+/// Codepoints in the Basic Multilingual Plane map to glyph slots through a
+/// flat index.
+///
+/// The atlas serializes to a file keyed by a hash of the font data, so a
+/// later launch with the same font skips rasterization.
+class SdfFont {
+public:
+    static constexpr f32 BASE_SIZE = 48.0f;
+    static constexpr i32 PADDING = 6;      ///< field margin, base pixels
+    static constexpr u8 ON_EDGE = 128;     ///< field value on the outline
+    static constexpr u32 ATLAS_WIDTH = 512;
+    static constexpr u32 FIRST_CHAR = 32;  ///< printable ASCII, as before
+    static constexpr u32 LAST_CHAR = 126;
+    static constexpr u32 BMP_SIZE = 0x10000;
+
+    /// One glyph's bitmap in the atlas, at BASE_SIZE.
+    struct Glyph {
+        u32 codepoint = 0;
+        u16 x = 0, y = 0;          // atlas position
+        u16 w = 0, h = 0;          // bitmap size including padding
+        i16 x_offset = 0;          // bitmap left relative to the pen
+        i16 y_offset = 0;          // bitmap top relative to the baseline
+        i32 advance = 0;           // font units
+    };
+
+    /// Rasterize the atlas from TrueType data. False if the font cannot
+    /// be parsed.
+    bool build(const u8* ttf, size_t len);
+
+    /// Write the atlas to `path` (through a temporary file and a rename).
+    bool save(const fs::path& path) const;
+
+    /// Read an atlas written by save(). False if the file is missing,
+    /// malformed, or was built from other font data.
+    bool load(const fs::path& path, u64 font_hash);
+
+    /// 64-bit FNV-1a of the font data, stored with the atlas.
+    static u64 hash(const u8* data, size_t len);
+
+    /// Metrics at `pointsize` pixels of height (stbtt_ScaleForPixelHeight).
+    FontMetrics metrics(f32 pointsize) const;
+
+    /// Glyph quads at `pointsize`, in slot order (see index()).
+    void glyphs_at(f32 pointsize, std::vector<GlyphInfo>& out) const;
+
+    /// BMP codepoint -> slot + 1; 0 when the font has no glyph.
+    const std::vector<u16>& index() const { return index_; }
+
+    bool empty() const { return glyphs_.empty(); }
+    u64 font_hash() const { return font_hash_; }
+    u32 width() const { return width_; }
+    u32 height() const { return height_; }
+    const std::vector<u8>& pixels() const { return pixels_; }
+    const std::vector<Glyph>& glyphs() const { return glyphs_; }
+
+private:
+    void rebuild_index();
+
+    u64 font_hash_ = 0;
+    i32 ascent_ = 0, descent_ = 0, line_gap_ = 0; // font units (descent < 0)
+    u32 width_ = 0, height_ = 0;
+    std::vector<u8> pixels_;
+    std::vector<Glyph> glyphs_;
+    std::vector<u16> index_;
+};
+
+} // namespace osc::renderer
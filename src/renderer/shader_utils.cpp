@@ -5,15 +5,16 @@
 
 namespace osc::renderer {
 
-VkShaderModule compile_glsl(VkDevice device, const char* source,
-                            const char* name, bool is_vertex) {
+namespace {
+
+VkShaderModule compile_stage(VkDevice device, const char* source,
+                             const char* name, shaderc_shader_kind kind) {
     shaderc::Compiler compiler;
     shaderc::CompileOptions options;
     options.SetTargetEnvironment(shaderc_target_env_vulkan,
                                 shaderc_env_version_vulkan_1_0);
     options.SetOptimizationLevel(shaderc_optimization_level_performance);
 
-    auto kind = is_vertex ? shaderc_vertex_shader : shaderc_fragment_shader;
     auto result = compiler.CompileGlslToSpv(source, kind, name, options);
 
     if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
@@ -37,6 +38,20 @@ VkShaderModule compile_glsl(VkDevice device, const char* source,
     return mod;
 }
 
+} // namespace
+
+VkShaderModule compile_glsl(VkDevice device, const char* source,
+                            const char* name, bool is_vertex) {
+    return compile_stage(device, source, name,
+                         is_vertex ? shaderc_vertex_shader
+                                   : shaderc_fragment_shader);
+}
+
+VkShaderModule compile_compute_glsl(VkDevice device, const char* source,
+                                    const char* name) {
+    return compile_stage(device, source, name, shaderc_compute_shader);
+}
+
 // Embedded GLSL sources
 namespace shaders {
 
@@ -529,22 +544,22 @@ const char* mesh_vert = R"glsl(
 
 layout(push_constant) uniform PushConstants {
     mat4 viewProj;
-    uint boneBase;
-    uint bonesPerInst;
     float eyeX, eyeY, eyeZ;
+    vec4 quantOffset;   // position (xyz) and UV (w) dequantization
+    vec4 quantScale;
 } pc;
 
-// Per-vertex (binding 0): position + normal + UV + bone_indices + bone_weights + tangent
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec2 inUV;
+// Per-vertex (binding 0): packed PackedMeshVertex, 24 bytes
+layout(location = 0) in vec4 inPosition;     // snorm16 within the mesh bounds
+layout(location = 1) in vec2 inNormal;       // octahedral snorm16
+layout(location = 2) in vec2 inUV;           // unorm16 within the mesh UV range
 layout(location = 8) in uvec4 inBoneIndices;
-layout(location = 9) in vec4 inBoneWeights;
-layout(location = 10) in vec3 inTangent;
+layout(location = 10) in vec2 inTangent;     // octahedral snorm16
 
 // Per-instance (binding 1) — mat4 uses locations 3-6 (4 vec4 columns)
 layout(location = 3) in mat4 inModel;
 layout(location = 7) in vec4 inColor;
+layout(location = 9) in uvec2 inBones;       // bone SSBO base, count (0 = unskinned)
 
 // Bone SSBO (set=1, binding=0)
 layout(std430, set = 1, binding = 0) readonly buffer BoneBuffer {
@@ -558,29 +573,38 @@ layout(location = 3) out vec3 fragTangent;
 layout(location = 4) out vec3 fragBitangent;
 layout(location = 5) out vec3 fragWorldPos;
 
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
 void main() {
-    // Blend-weight skeletal skinning: skip for unskinned meshes (bonesPerInst == 0)
+    // Blend-weight skeletal skinning: skip for unskinned instances (no bones).
+    // SCM blends its four bone slots equally, so the weights are not stored.
     mat4 bone;
-    if (pc.bonesPerInst > 0u) {
-        uint base = pc.boneBase + uint(gl_InstanceIndex) * pc.bonesPerInst;
-        bone = inBoneWeights[0] * boneSSBO.bones[base + inBoneIndices[0]]
-             + inBoneWeights[1] * boneSSBO.bones[base + inBoneIndices[1]]
-             + inBoneWeights[2] * boneSSBO.bones[base + inBoneIndices[2]]
-             + inBoneWeights[3] * boneSSBO.bones[base + inBoneIndices[3]];
+    if (inBones.y > 0u) {
+        uint base = inBones.x;
+        bone = 0.25 * (boneSSBO.bones[base + inBoneIndices[0]]
+                     + boneSSBO.bones[base + inBoneIndices[1]]
+                     + boneSSBO.bones[base + inBoneIndices[2]]
+                     + boneSSBO.bones[base + inBoneIndices[3]]);
     } else {
         bone = mat4(1.0); // identity — no skinning for props/unskinned meshes
     }
-    vec4 skinnedPos = bone * vec4(inPosition, 1.0);
+    vec3 position = pc.quantOffset.xyz + inPosition.xyz * pc.quantScale.xyz;
+    vec4 skinnedPos = bone * vec4(position, 1.0);
     vec4 worldPos = inModel * skinnedPos;
     gl_Position = pc.viewProj * worldPos;
     fragWorldPos = worldPos.xyz;
     // Transform TBN vectors through blended bone then model
     mat3 normalMat = mat3(inModel) * mat3(bone);
-    fragNormal = normalMat * inNormal;
-    fragTangent = normalMat * inTangent;
+    fragNormal = normalMat * octDecode(inNormal);
+    fragTangent = normalMat * octDecode(inTangent);
     fragBitangent = cross(fragNormal, fragTangent);
     fragColor = inColor;
-    fragUV = inUV;
+    fragUV = pc.quantOffset.w + inUV * pc.quantScale.w;
 }
 )glsl";
 
@@ -591,9 +615,9 @@ const char* mesh_frag = R"glsl(
 // Full block declared for layout compatibility; only eyeX/Y/Z read in this stage
 layout(push_constant) uniform PushConstants {
     mat4 viewProj;
-    uint boneBase;
-    uint bonesPerInst;
     float eyeX, eyeY, eyeZ;
+    vec4 quantOffset;
+    vec4 quantScale;
 } pc;
 
 layout(set = 0, binding = 0) uniform sampler2D texAlbedo;
@@ -750,21 +774,21 @@ const char* shadow_mesh_vert = R"glsl(
 
 layout(push_constant) uniform PushConstants {
     mat4 lightViewProj;
-    uint boneBase;
-    uint bonesPerInst;
+    vec4 quantOffset;   // position (xyz) dequantization; w unused here
+    vec4 quantScale;
 } pc;
 
-// Per-vertex (binding 0): position + normal + UV + bone_indices + bone_weights + tangent
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
+// Per-vertex (binding 0): packed PackedMeshVertex, 24 bytes
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec2 inNormal;
 layout(location = 2) in vec2 inUV;
 layout(location = 8) in uvec4 inBoneIndices;
-layout(location = 9) in vec4 inBoneWeights;
-layout(location = 10) in vec3 inTangent;
+layout(location = 10) in vec2 inTangent;
 
 // Per-instance (binding 1) — mat4 uses locations 3-6 (4 vec4 columns)
 layout(location = 3) in mat4 inModel;
 layout(location = 7) in vec4 inColor;
+layout(location = 9) in uvec2 inBones;
 
 // Bone SSBO (set=0, binding=0)
 layout(std430, set = 0, binding = 0) readonly buffer BoneBuffer {
@@ -773,16 +797,17 @@ layout(std430, set = 0, binding = 0) readonly buffer BoneBuffer {
 
 void main() {
     mat4 bone;
-    if (pc.bonesPerInst > 0u) {
-        uint base = pc.boneBase + uint(gl_InstanceIndex) * pc.bonesPerInst;
-        bone = inBoneWeights[0] * boneSSBO.bones[base + inBoneIndices[0]]
-             + inBoneWeights[1] * boneSSBO.bones[base + inBoneIndices[1]]
-             + inBoneWeights[2] * boneSSBO.bones[base + inBoneIndices[2]]
-             + inBoneWeights[3] * boneSSBO.bones[base + inBoneIndices[3]];
+    if (inBones.y > 0u) {
+        uint base = inBones.x;
+        bone = 0.25 * (boneSSBO.bones[base + inBoneIndices[0]]
+                     + boneSSBO.bones[base + inBoneIndices[1]]
+                     + boneSSBO.bones[base + inBoneIndices[2]]
+                     + boneSSBO.bones[base + inBoneIndices[3]]);
     } else {
         bone = mat4(1.0);
     }
-    vec4 skinnedPos = bone * vec4(inPosition, 1.0);
+    vec3 position = pc.quantOffset.xyz + inPosition.xyz * pc.quantScale.xyz;
+    vec4 skinnedPos = bone * vec4(position, 1.0);
     vec4 worldPos = inModel * skinnedPos;
     gl_Position = pc.lightViewProj * worldPos;
 }
@@ -869,12 +894,71 @@ layout(location = 1) in vec4 fragColor;
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    vec4 texColor = texture(texSampler, fragUV);
+    // Font glyphs carry u - 64 (SDF_UV_OFFSET): their alpha is a distance
+    // field with the outline at 0.5, resolved here at any scale
+    bool sdf = fragUV.x < -32.0;
+    vec4 texColor = texture(texSampler, sdf ? fragUV + vec2(64.0, 0.0) : fragUV);
+    float edge = max(fwidth(texColor.a), 1e-3);
+    if (sdf) texColor.a = smoothstep(0.5 - edge, 0.5 + edge, texColor.a);
     outColor = texColor * fragColor;
     if (outColor.a < 0.01) discard;
 }
 )glsl";
 
+// ---------------------------------------------------------------------------
+// Minimap unit dots: one instanced sprite per MinimapDot, read straight
+// from the per-army dot segments
+// ---------------------------------------------------------------------------
+
+const char* minimap_dot_vert = R"glsl(
+#version 450
+
+layout(push_constant) uniform PushConstants {
+    vec4 rect;        // minimap x, y, size in pixels; w = dot size
+    vec4 color;       // army color
+    vec2 viewport;    // viewport width, height
+    float resolution; // minimap pixels per side
+    float _pad;
+} pc;
+
+// Per-instance data (binding 0, instance rate)
+layout(location = 0) in uvec2 inPixel; // minimap pixel
+
+layout(location = 0) out vec4 fragColor;
+
+void main() {
+    vec2 pos;
+    int idx = gl_VertexIndex;
+    if (idx == 0)      pos = vec2(0, 0);
+    else if (idx == 1) pos = vec2(1, 0);
+    else if (idx == 2) pos = vec2(1, 1);
+    else if (idx == 3) pos = vec2(0, 0);
+    else if (idx == 4) pos = vec2(1, 1);
+    else               pos = vec2(0, 1);
+
+    vec2 center = pc.rect.xy + (vec2(inPixel) + 0.5) / pc.resolution * pc.rect.z;
+    vec2 pixel = center + (pos - 0.5) * pc.rect.w;
+
+    gl_Position = vec4(
+        pixel.x / pc.viewport.x * 2.0 - 1.0,
+        pixel.y / pc.viewport.y * 2.0 - 1.0,
+        0.0, 1.0
+    );
+    fragColor = pc.color;
+}
+)glsl";
+
+const char* minimap_dot_frag = R"glsl(
+#version 450
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = fragColor;
+}
+)glsl";
+
 // ---------------------------------------------------------------------------
 // Particle billboard shaders
 // ---------------------------------------------------------------------------
@@ -1028,6 +1112,92 @@ void main() {
 }
 )glsl";
 
+// Instance culling: one invocation per CullInstance record (see
+// instance_culling.hpp for the layouts and the CPU reference). Visible
+// instances pick a LOD like MeshCache::get_lod and are appended to that
+// LOD's output range; the draw's instanceCount is the append counter.
+const char* instance_cull_comp = R"glsl(
+#version 450
+
+layout(local_size_x = 64) in;
+
+layout(push_constant) uniform PushConstants {
+    vec4 planes[6];      // normalized frustum planes
+    vec4 eye;            // camera position; w = 0 -> finest LOD
+    uint instanceCount;
+} pc;
+
+struct CullInstance {
+    mat4 model;
+    vec4 color;
+    vec4 sphere;         // center xyz, radius w
+    uint lodSet;
+    uint boneBase;       // first matrix in the bone SSBO
+    uint boneCount;      // 0 = not skinned
+    uint pad0;
+};
+
+struct LODSet {
+    uint firstLod;
+    uint lodCount;
+};
+
+struct LOD {
+    float cutoff;        // 0 = no limit
+    uint firstInstance;
+};
+
+struct DrawCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+struct MeshInstance {
+    mat4 model;
+    vec4 color;
+    uvec4 bones;         // x = base, y = count
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Instances { CullInstance instances[]; };
+layout(std430, set = 0, binding = 1) readonly buffer Sets { LODSet sets[]; };
+layout(std430, set = 0, binding = 2) readonly buffer Lods { LOD lods[]; };
+layout(std430, set = 0, binding = 3) buffer Draws { DrawCommand draws[]; };
+layout(std430, set = 0, binding = 4) writeonly buffer Visible { MeshInstance visible[]; };
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= pc.instanceCount) return;
+
+    vec4 s = instances[i].sphere;
+    for (int p = 0; p < 6; ++p) {
+        if (dot(pc.planes[p].xyz, s.xyz) + pc.planes[p].w < -s.w) return;
+    }
+
+    float dist = pc.eye.w != 0.0 ? distance(s.xyz, pc.eye.xyz) : 0.0;
+
+    LODSet chain = sets[instances[i].lodSet];
+    if (chain.lodCount == 0u) return;
+    uint level = chain.lodCount - 1u;
+    for (uint k = 0u; k < chain.lodCount; ++k) {
+        float cutoff = lods[chain.firstLod + k].cutoff;
+        if (cutoff == 0.0 || cutoff >= dist) {
+            level = k;
+            break;
+        }
+    }
+
+    uint lod = chain.firstLod + level;
+    uint slot = atomicAdd(draws[lod].instanceCount, 1u);
+    uint dst = lods[lod].firstInstance + slot;
+    visible[dst].model = instances[i].model;
+    visible[dst].color = instances[i].color;
+    visible[dst].bones = uvec4(instances[i].boneBase, instances[i].boneCount, 0u, 0u);
+}
+)glsl";
+
 } // namespace shaders
 
 } // namespace osc::renderer
@@ -11,6 +11,10 @@ namespace osc::renderer {
 VkShaderModule compile_glsl(VkDevice device, const char* source,
                             const char* name, bool is_vertex);
 
+/// Same, for a compute shader.
+VkShaderModule compile_compute_glsl(VkDevice device, const char* source,
+                                    const char* name);
+
 /// All embedded shader sources.
 namespace shaders {
 extern const char* terrain_vert;
@@ -28,13 +32,16 @@ extern const char* shadow_mesh_vert;  // mesh shadow (blend-weight skinning + li
 extern const char* shadow_unit_vert;  // cube shadow (instanced + lightVP)
 extern const char* shadow_frag;       // empty (depth-only write)
 extern const char* ui_vert;           // 2D UI quad (pixel coords → NDC)
-extern const char* ui_frag;           // 2D UI quad (texture * color)
+extern const char* ui_frag;           // 2D UI quad (texture * color, SDF text)
+extern const char* minimap_dot_vert;  // minimap unit dot (instanced sprite)
+extern const char* minimap_dot_frag;  // flat army color
 extern const char* particle_vert;     // 3D billboard particle (instanced)
 extern const char* particle_frag;     // textured particle with alpha/additive
 extern const char* bloom_bright_vert;     // fullscreen triangle (no VBO)
 extern const char* bloom_bright_frag;     // brightness extraction
 extern const char* bloom_blur_frag;       // separable Gaussian blur
 extern const char* bloom_composite_frag;  // additive composite
+extern const char* instance_cull_comp;    // frustum cull + LOD + compaction
 } // namespace shaders
 
 } // namespace osc::renderer
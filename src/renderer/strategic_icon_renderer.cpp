@@ -12,10 +12,8 @@
 
 namespace osc::renderer {
 
-static void get_army_color(const sim::Entity& entity,
-                            const sim::SimState& sim,
+static void get_army_color(i32 army, const sim::SimState& sim,
                             f32& r, f32& g, f32& b) {
-    i32 army = entity.army();
     if (army >= 0 && army < static_cast<i32>(sim.army_count())) {
         auto* brain = sim.army_at(static_cast<size_t>(army));
         if (brain && (brain->color_r() || brain->color_g() ||
@@ -230,6 +228,42 @@ void StrategicIconRenderer::draw_icon_shape(u8* pixels, u32 atlas_w,
     }
 }
 
+void StrategicIconRenderer::draw_digit(u8* pixels, u32 atlas_w,
+                                        u32 cell_x, u32 cell_y,
+                                        u32 cell_size, u32 digit) {
+    // Segments a-g, bit 0 = a (top), clockwise, g = middle
+    static constexpr u8 SEGMENTS[10] = {
+        0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F
+    };
+    f32 cs = static_cast<f32>(cell_size);
+    f32 x0 = static_cast<f32>(cell_x) + cs * 0.3f;
+    f32 x1 = static_cast<f32>(cell_x) + cs * 0.7f;
+    f32 y0 = static_cast<f32>(cell_y) + cs * 0.15f;
+    f32 ym = static_cast<f32>(cell_y) + cs * 0.5f;
+    f32 y1 = static_cast<f32>(cell_y) + cs * 0.85f;
+    f32 t = cs * 0.06f; // half stroke
+
+    // {left, top, right, bottom} per segment
+    const f32 rects[7][4] = {
+        {x0, y0 - t, x1, y0 + t}, // a
+        {x1 - t, y0, x1 + t, ym}, // b
+        {x1 - t, ym, x1 + t, y1}, // c
+        {x0, y1 - t, x1, y1 + t}, // d
+        {x0 - t, ym, x0 + t, y1}, // e
+        {x0 - t, y0, x0 + t, ym}, // f
+        {x0, ym - t, x1, ym + t}, // g
+    };
+    for (u32 seg = 0; seg < 7; seg++) {
+        if (!(SEGMENTS[digit % 10] & (1u << seg))) continue;
+        const f32* rc = rects[seg];
+        f32 verts[4][2] = {
+            {rc[0], rc[1]}, {rc[2], rc[1]},
+            {rc[2], rc[3]}, {rc[0], rc[3]}
+        };
+        draw_polygon(pixels, atlas_w, ATLAS_H, verts, 4);
+    }
+}
+
 void StrategicIconRenderer::build_atlas(TextureCache& tex_cache) {
     std::vector<u8> pixels(ATLAS_W * ATLAS_H * 4, 0); // transparent black
 
@@ -238,6 +272,11 @@ void StrategicIconRenderer::build_atlas(TextureCache& tex_cache) {
                          i * ICON_CELL_SIZE, 0, ICON_CELL_SIZE,
                          static_cast<StrategicIconType>(i));
     }
+    for (u32 d = 0; d < 10; d++) {
+        draw_digit(pixels.data(), ATLAS_W,
+                   (ICON_DIGIT_FIRST_CELL + d) * ICON_CELL_SIZE, 0,
+                   ICON_CELL_SIZE, d);
+    }
 
     auto* tex = tex_cache.upload_rgba("__strategic_icon_atlas",
                                        pixels.data(), ATLAS_W, ATLAS_H);
@@ -265,24 +304,6 @@ StrategicIconType StrategicIconRenderer::classify_unit(const sim::Unit& unit) {
 
 // --- Rendering ---
 
-bool StrategicIconRenderer::world_to_screen(f32 wx, f32 wy, f32 wz,
-                                              const std::array<f32, 16>& vp,
-                                              f32 sw, f32 sh,
-                                              f32& out_x, f32& out_y) {
-    f32 cx = vp[0]*wx + vp[4]*wy + vp[8]*wz  + vp[12];
-    f32 cy = vp[1]*wx + vp[5]*wy + vp[9]*wz  + vp[13];
-    f32 cw = vp[3]*wx + vp[7]*wy + vp[11]*wz + vp[15];
-
-    if (cw <= 0.001f) return false;
-
-    f32 ndc_x = cx / cw;
-    f32 ndc_y = cy / cw;
-
-    out_x = (ndc_x + 1.0f) * 0.5f * sw;
-    out_y = (ndc_y + 1.0f) * 0.5f * sh;
-    return true;
-}
-
 void StrategicIconRenderer::emit_quad(f32 x, f32 y, f32 w, f32 h,
                                        f32 u0, f32 v0, f32 u1, f32 v1,
                                        f32 r, f32 g, f32 b, f32 a) {
@@ -323,16 +344,8 @@ bool StrategicIconRenderer::update(const sim::SimState& sim,
 
     auto& registry = sim.entity_registry();
 
-    // Collect visible units with screen positions (two-pass: rings first, icons second)
-    struct VisibleUnit {
-        f32 sx, sy;
-        f32 r, g, b;
-        StrategicIconType icon_type;
-        bool is_selected;
-    };
-    std::vector<VisibleUnit> visible;
-    visible.reserve(256);
-
+    // Bin visible units; only units that crossed a cell edge touch the bins
+    clusterer_.begin_frame();
     registry.for_each([&](const sim::Entity& entity) {
         if (entity.destroyed() || !entity.is_unit()) return;
 
@@ -353,52 +366,32 @@ bool StrategicIconRenderer::update(const sim::SimState& sim,
             sy < -icon_size || sy > sh + icon_size)
             return;
 
-        // Get army color
-        f32 r, g, b;
-        get_army_color(entity, sim, r, g, b);
-
         bool is_selected = selected_ids &&
                            selected_ids->count(entity.entity_id()) > 0;
 
         auto* unit = static_cast<const sim::Unit*>(&entity);
-        visible.push_back({sx, sy, r, g, b, classify_unit(*unit), is_selected});
+        clusterer_.add(entity.entity_id(), entity.army(), classify_unit(*unit),
+                       sx, sy, is_selected);
     });
+    clusterer_.end_frame();
 
-    // Pass 1: Selection rings (drawn with white_ds, behind icons)
-    // Limit rings to half the budget so icons always have room.
-    constexpr u32 MAX_RINGS = MAX_ICON_QUADS / 2;
-    for (auto& vu : visible) {
-        if (!vu.is_selected) continue;
-        if (quad_count_ >= MAX_RINGS) break;
-        f32 ring_size = icon_size + 4.0f;
-        f32 ring_half = ring_size * 0.5f;
-        emit_quad(vu.sx - ring_half, vu.sy - ring_half, ring_size, ring_size,
-                  0.0f, 0.0f, 1.0f, 1.0f,
-                  0.2f, 1.0f, 0.2f, 0.5f);
+    // Merge icons that would overlap at this zoom; coarser if over budget
+    const auto& clusters = clusterer_.build(
+        IconClusterer::level_for_icon(icon_size), MAX_ICON_QUADS);
+
+    IconPalette palette{};
+    for (i32 a = 0; a < IconClusterer::MAX_ARMIES; a++) {
+        auto& rgb = palette[static_cast<size_t>(a)];
+        get_army_color(a, sim, rgb[0], rgb[1], rgb[2]);
     }
-    ring_count_ = quad_count_;
-
-    // Pass 2: Icon quads (drawn with atlas_ds)
-    for (auto& vu : visible) {
-        if (quad_count_ >= MAX_ICON_QUADS) break;
-
-        u32 icon_idx = static_cast<u32>(vu.icon_type);
-        f32 u0 = static_cast<f32>(icon_idx * ICON_CELL_SIZE) /
-                  static_cast<f32>(ATLAS_W);
-        f32 u1 = static_cast<f32>((icon_idx + 1) * ICON_CELL_SIZE) /
-                  static_cast<f32>(ATLAS_W);
-
-        f32 half = icon_size * 0.5f;
-        f32 r = vu.r, g = vu.g, b = vu.b;
-        if (vu.is_selected) {
-            r = r * 0.5f + 0.5f;
-            g = g * 0.5f + 0.5f;
-            b = b * 0.5f + 0.5f;
-        }
 
-        emit_quad(vu.sx - half, vu.sy - half, icon_size, icon_size,
-                  u0, 0.0f, u1, 1.0f,
-                  r, g, b, 1.0f);
+    // Rings first (white_ds), then icons and badges (atlas_ds)
+    ring_count_ = build_icon_quads(clusters, icon_size, palette,
+                                   MAX_ICON_QUADS, layout_);
+    for (const auto& q : layout_) {
+        emit_quad(q.rect[0], q.rect[1], q.rect[2], q.rect[3],
+                  q.uv[0], q.uv[1], q.uv[2], q.uv[3],
+                  q.color[0], q.color[1], q.color[2], q.color[3]);
     }
 
     // Upload to GPU
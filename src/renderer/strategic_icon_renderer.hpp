@@ -1,6 +1,7 @@
 #pragma once
 
 #include "renderer/vk_types.hpp"
+#include "renderer/icon_clustering.hpp"
 #include "renderer/ui_renderer.hpp" // UIInstance, UIDrawGroup
 #include "core/types.hpp"
 
@@ -18,20 +19,9 @@ namespace osc::renderer {
 class Camera;
 class TextureCache;
 
-/// Icon types derived from unit categories.
-enum class StrategicIconType : u8 {
-    Land = 0,
-    Air,
-    Naval,
-    Engineer,
-    Commander,
-    Structure,
-    Generic,
-    COUNT
-};
-
 /// Renders strategic zoom icons: when camera is zoomed out past a threshold,
-/// units are replaced with 2D category icons in army colors.
+/// units are replaced with 2D category icons in army colors. Icons sharing
+/// a screen cell are merged into one with a count badge (IconClusterer).
 class StrategicIconRenderer {
 public:
     void init(VkDevice device, VmaAllocator allocator);
@@ -55,6 +45,7 @@ public:
     void set_frame_index(u32 fi) { fi_ = fi; }
 
     u32 quad_count() const { return quad_count_; }
+    const IconClusterer& clusterer() const { return clusterer_; }
     bool is_strategic_zoom() const { return strategic_zoom_active_; }
     VkDescriptorSet atlas_descriptor() const { return atlas_ds_; }
 
@@ -68,17 +59,11 @@ public:
 
     /// Atlas layout constants (public for reuse by SelectionInfoRenderer).
     static constexpr u32 ICON_CELL_SIZE = 32;
-    static constexpr u32 ATLAS_COLS = static_cast<u32>(StrategicIconType::COUNT);
-    static constexpr u32 ATLAS_W = ATLAS_COLS * ICON_CELL_SIZE; // 7 * 32 = 224
+    static constexpr u32 ATLAS_COLS = ICON_ATLAS_COLS;          // icons, then digits
+    static constexpr u32 ATLAS_W = ATLAS_COLS * ICON_CELL_SIZE; // 17 * 32 = 544
     static constexpr u32 ATLAS_H = ICON_CELL_SIZE;              // single row
 
 private:
-    /// Project world position to screen pixel coordinates.
-    static bool world_to_screen(f32 wx, f32 wy, f32 wz,
-                                const std::array<f32, 16>& vp,
-                                f32 screen_w, f32 screen_h,
-                                f32& out_x, f32& out_y);
-
     void emit_quad(f32 x, f32 y, f32 w, f32 h,
                    f32 u0, f32 v0, f32 u1, f32 v1,
                    f32 r, f32 g, f32 b, f32 a);
@@ -88,10 +73,16 @@ private:
                                 u32 cell_x, u32 cell_y, u32 cell_size,
                                 StrategicIconType type);
 
+    /// Generate a seven-segment digit glyph into pixel buffer.
+    static void draw_digit(u8* pixels, u32 atlas_w,
+                           u32 cell_x, u32 cell_y, u32 cell_size, u32 digit);
+
     AllocatedBuffer instance_buf_[FRAMES_IN_FLIGHT] = {};
     void* instance_mapped_[FRAMES_IN_FLIGHT] = {};
     u32 fi_ = 0;
 
+    IconClusterer clusterer_;
+    std::vector<IconQuad> layout_;
     std::vector<UIInstance> quads_;
     u32 quad_count_ = 0;
 
@@ -0,0 +1,242 @@
+#include "renderer/terrain_lod.hpp"
+#include "renderer/frustum.hpp"
+#include "map/heightmap.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace osc::renderer {
+
+static_assert(std::tuple_size_v<decltype(TerrainChunk::error)> == TerrainLOD::LOD_COUNT);
+static_assert((TerrainLOD::CHUNK_QUADS >> (TerrainLOD::LOD_COUNT - 1)) == 1);
+
+namespace {
+
+/// Central-difference normal at a heightmap grid point.
+void grid_normal(const map::Heightmap& hm, u32 gx, u32 gz,
+                 f32& nx, f32& ny, f32& nz) {
+    u32 gw = hm.grid_width(), gh = hm.grid_height();
+    f32 h = hm.get_height_at_grid(gx, gz);
+    f32 hL = (gx > 0) ? hm.get_height_at_grid(gx - 1, gz) : h;
+    f32 hR = (gx + 1 < gw) ? hm.get_height_at_grid(gx + 1, gz) : h;
+    f32 hD = (gz > 0) ? hm.get_height_at_grid(gx, gz - 1) : h;
+    f32 hU = (gz + 1 < gh) ? hm.get_height_at_grid(gx, gz + 1) : h;
+
+    nx = hL - hR;
+    nz = hD - hU;
+    ny = 2.0f;
+    f32 len = std::sqrt(nx * nx + ny * ny + nz * nz);
+    if (len > 0) { nx /= len; ny /= len; nz /= len; }
+}
+
+/// Vertical error of LOD `lod` over one chunk: every chunk vertex against
+/// bilinear interpolation of the LOD's coarser grid.
+f32 lod_error(const TerrainVertex* v, u32 lod) {
+    constexpr u32 N = TerrainLOD::CHUNK_VERTS;
+    const u32 step = 1u << lod;
+    auto h = [&](u32 i, u32 j) { return v[j * N + i].y; };
+
+    f32 err = 0.0f;
+    for (u32 j = 0; j < N; ++j) {
+        u32 j0 = std::min(j / step * step, N - 1 - step);
+        f32 tz = static_cast<f32>(j - j0) / static_cast<f32>(step);
+        for (u32 i = 0; i < N; ++i) {
+            u32 i0 = std::min(i / step * step, N - 1 - step);
+            f32 tx = static_cast<f32>(i - i0) / static_cast<f32>(step);
+            f32 top = h(i0, j0) + (h(i0 + step, j0) - h(i0, j0)) * tx;
+            f32 bot = h(i0, j0 + step) + (h(i0 + step, j0 + step) - h(i0, j0 + step)) * tx;
+            f32 interp = top + (bot - top) * tz;
+            err = std::max(err, std::abs(h(i, j) - interp));
+        }
+    }
+    return err;
+}
+
+} // namespace
+
+void TerrainLOD::build(const map::Heightmap& hm, u32 decimate) {
+    vertices_.clear();
+    chunks_.clear();
+
+    u32 gw = hm.grid_width();
+    u32 gh = hm.grid_height();
+    u32 chunk_span = CHUNK_QUADS * decimate; // grid units per chunk side
+    chunks_x_ = std::max((gw - 1 + chunk_span - 1) / chunk_span, 1u);
+    chunks_z_ = std::max((gh - 1 + chunk_span - 1) / chunk_span, 1u);
+
+    vertices_.resize(static_cast<size_t>(chunks_x_) * chunks_z_ *
+                     CHUNK_VERTS * CHUNK_VERTS);
+    chunks_.resize(static_cast<size_t>(chunks_x_) * chunks_z_);
+
+    for (u32 cz = 0; cz < chunks_z_; ++cz) {
+        for (u32 cx = 0; cx < chunks_x_; ++cx) {
+            auto& chunk = chunks_[cz * chunks_x_ + cx];
+            chunk.cx = cx;
+            chunk.cz = cz;
+            chunk.vertex_offset = (cz * chunks_x_ + cx) * CHUNK_VERTS * CHUNK_VERTS;
+            TerrainVertex* block = vertices_.data() + chunk.vertex_offset;
+
+            // Past the map edge (sizes that are not a chunk multiple) the
+            // samples clamp, which only adds zero-area triangles
+            f32 lo_y = 0.0f, hi_y = 0.0f;
+            for (u32 j = 0; j < CHUNK_VERTS; ++j) {
+                u32 gz = std::min(cz * chunk_span + j * decimate, gh - 1);
+                for (u32 i = 0; i < CHUNK_VERTS; ++i) {
+                    u32 gx = std::min(cx * chunk_span + i * decimate, gw - 1);
+                    auto& v = block[j * CHUNK_VERTS + i];
+                    v.x = static_cast<f32>(gx);
+                    v.y = hm.get_height_at_grid(gx, gz);
+                    v.z = static_cast<f32>(gz);
+                    grid_normal(hm, gx, gz, v.nx, v.ny, v.nz);
+                    if (i == 0 && j == 0) lo_y = hi_y = v.y;
+                    lo_y = std::min(lo_y, v.y);
+                    hi_y = std::max(hi_y, v.y);
+                }
+            }
+            const auto& first = block[0];
+            const auto& last = block[CHUNK_VERTS * CHUNK_VERTS - 1];
+            chunk.min[0] = first.x; chunk.min[1] = lo_y; chunk.min[2] = first.z;
+            chunk.max[0] = last.x;  chunk.max[1] = hi_y; chunk.max[2] = last.z;
+
+            chunk.error[0] = 0.0f;
+            for (u32 lod = 1; lod < LOD_COUNT; ++lod)
+                chunk.error[lod] = std::max(chunk.error[lod - 1], lod_error(block, lod));
+        }
+    }
+
+    build_index_variants();
+}
+
+void TerrainLOD::build_index_variants() {
+    indices_.clear();
+    ranges_.assign(LOD_COUNT * terrain_stitch::VARIANTS, {});
+
+    for (u32 lod = 0; lod < LOD_COUNT; ++lod) {
+        const u32 n = CHUNK_QUADS >> lod; // quads per side
+        const u32 step = 1u << lod;
+        for (u32 mask = 0; mask < terrain_stitch::VARIANTS; ++mask) {
+            // The coarsest LOD never has a coarser neighbour
+            const u32 stitch = n > 1 ? mask : 0;
+
+            // LOD grid (i, j) -> chunk vertex, with odd vertices on
+            // stitched edges collapsed onto their even predecessor
+            auto vertex = [&](u32 i, u32 j, i32& gi, i32& gj) {
+                if ((stitch & terrain_stitch::NEG_X) && i == 0 && (j & 1)) j--;
+                if ((stitch & terrain_stitch::POS_X) && i == n && (j & 1)) j--;
+                if ((stitch & terrain_stitch::NEG_Z) && j == 0 && (i & 1)) i--;
+                if ((stitch & terrain_stitch::POS_Z) && j == n && (i & 1)) i--;
+                gi = static_cast<i32>(i);
+                gj = static_cast<i32>(j);
+                return (j * step) * CHUNK_VERTS + i * step;
+            };
+            auto emit = [&](u32 ai, u32 aj, u32 bi, u32 bj, u32 ci, u32 cj) {
+                i32 ax, az, bx, bz, cx, cz;
+                u32 a = vertex(ai, aj, ax, az);
+                u32 b = vertex(bi, bj, bx, bz);
+                u32 c = vertex(ci, cj, cx, cz);
+                // Collapsing leaves some triangles degenerate or flat
+                if ((bx - ax) * (cz - az) - (bz - az) * (cx - ax) == 0) return;
+                indices_.push_back(a);
+                indices_.push_back(b);
+                indices_.push_back(c);
+            };
+
+            IndexRange& range = ranges_[lod * terrain_stitch::VARIANTS + mask];
+            range.first = static_cast<u32>(indices_.size());
+            for (u32 z = 0; z < n; ++z) {
+                for (u32 x = 0; x < n; ++x) {
+                    // Same winding as the old single mesh: (tl, bl, tr), (tr, bl, br)
+                    emit(x, z, x, z + 1, x + 1, z);
+                    emit(x + 1, z, x, z + 1, x + 1, z + 1);
+                }
+            }
+            range.count = static_cast<u32>(indices_.size()) - range.first;
+        }
+    }
+}
+
+void TerrainLOD::select(const TerrainLODParams& params, const Frustum* frustum,
+                        std::vector<TerrainChunkDraw>& out) const {
+    out.assign(chunks_.size(), {});
+    if (chunks_.empty()) return;
+
+    // Coarsest LOD whose projected error stays within budget
+    const f32 budget = params.max_pixel_error / std::max(params.projection_scale, 1e-6f);
+    for (size_t c = 0; c < chunks_.size(); ++c) {
+        const auto& chunk = chunks_[c];
+        f32 d2 = 0.0f;
+        for (int a = 0; a < 3; ++a) {
+            f32 e = params.eye[a];
+            f32 delta = e < chunk.min[a] ? chunk.min[a] - e
+                      : e > chunk.max[a] ? e - chunk.max[a] : 0.0f;
+            d2 += delta * delta;
+        }
+        f32 dist = std::max(std::sqrt(d2), 1.0f);
+        u32 lod = 0;
+        for (u32 l = LOD_COUNT; l-- > 1;) {
+            if (chunk.error[l] <= budget * dist) {
+                lod = l;
+                break;
+            }
+        }
+        out[c].lod = static_cast<u8>(lod);
+
+        if (frustum) {
+            f32 cx = 0.5f * (chunk.min[0] + chunk.max[0]);
+            f32 cy = 0.5f * (chunk.min[1] + chunk.max[1]);
+            f32 cz = 0.5f * (chunk.min[2] + chunk.max[2]);
+            f32 hx = 0.5f * (chunk.max[0] - chunk.min[0]);
+            f32 hy = 0.5f * (chunk.max[1] - chunk.min[1]);
+            f32 hz = 0.5f * (chunk.max[2] - chunk.min[2]);
+            out[c].visible = frustum->is_sphere_visible(
+                cx, cy, cz, std::sqrt(hx * hx + hy * hy + hz * hz));
+        }
+    }
+
+    // Neighbours at most one LOD apart: lod = min(lod, neighbour + 1),
+    // exact in two raster passes (a city-block distance transform)
+    const u32 w = chunks_x_, h = chunks_z_;
+    auto at = [&](u32 x, u32 z) -> u8& { return out[z * w + x].lod; };
+    for (u32 z = 0; z < h; ++z) {
+        for (u32 x = 0; x < w; ++x) {
+            if (x > 0) at(x, z) = std::min<u8>(at(x, z), at(x - 1, z) + 1);
+            if (z > 0) at(x, z) = std::min<u8>(at(x, z), at(x, z - 1) + 1);
+        }
+    }
+    for (u32 z = h; z-- > 0;) {
+        for (u32 x = w; x-- > 0;) {
+            if (x + 1 < w) at(x, z) = std::min<u8>(at(x, z), at(x + 1, z) + 1);
+            if (z + 1 < h) at(x, z) = std::min<u8>(at(x, z), at(x, z + 1) + 1);
+        }
+    }
+
+    for (u32 z = 0; z < h; ++z) {
+        for (u32 x = 0; x < w; ++x) {
+            u8 lod = at(x, z);
+            u8 stitch = 0;
+            if (x > 0 && at(x - 1, z) > lod) stitch |= terrain_stitch::NEG_X;
+            if (x + 1 < w && at(x + 1, z) > lod) stitch |= terrain_stitch::POS_X;
+            if (z > 0 && at(x, z - 1) > lod) stitch |= terrain_stitch::NEG_Z;
+            if (z + 1 < h && at(x, z + 1) > lod) stitch |= terrain_stitch::POS_Z;
+            out[z * w + x].stitch = stitch;
+        }
+    }
+}
+
+u64 TerrainLOD::triangle_count(const std::vector<TerrainChunkDraw>& draws,
+                               bool all) const {
+    u64 tris = 0;
+    for (const auto& d : draws) {
+        if (all || d.visible) tris += index_range(d.lod, d.stitch).count / 3;
+    }
+    return tris;
+}
+
+void TerrainLOD::release_geometry() {
+    vertices_.clear();
+    vertices_.shrink_to_fit();
+    indices_.clear();
+    indices_.shrink_to_fit();
+}
+
+} // namespace osc::renderer
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <array>
+#include <vector>
+
+namespace osc::map {
+class Heightmap;
+}
+
+namespace osc::renderer {
+
+class Frustum; // forward
+
+struct TerrainVertex {
+    f32 x, y, z;    // position
+    f32 nx, ny, nz; // normal
+};
+
+/// Stitch mask bits: set when the neighbour across that chunk edge is one
+/// LOD coarser, so the edge drops its odd vertices to match.
+namespace terrain_stitch {
+constexpr u8 NEG_X = 1 << 0;
+constexpr u8 POS_X = 1 << 1;
+constexpr u8 NEG_Z = 1 << 2;
+constexpr u8 POS_Z = 1 << 3;
+constexpr u32 VARIANTS = 16;
+} // namespace terrain_stitch
+
+/// One terrain chunk: a (CHUNK_QUADS + 1)^2 block of vertices in the
+/// shared vertex buffer, and its geometric error per LOD.
+struct TerrainChunk {
+    u32 cx = 0, cz = 0;   // chunk coordinates
+    u32 vertex_offset = 0; // first vertex in the shared vertex buffer
+    f32 min[3] = {};      // world-space bounds
+    f32 max[3] = {};
+    /// Max vertical error (world units) of each LOD against the full chunk
+    /// grid; non-decreasing with LOD, error[0] = 0.
+    std::array<f32, 7> error{};
+};
+
+/// Per-chunk result of TerrainLOD::select().
+struct TerrainChunkDraw {
+    u8 lod = 0;
+    u8 stitch = 0;       // terrain_stitch bits
+    bool visible = true; // inside the frustum
+};
+
+/// Screen-space error inputs.
+struct TerrainLODParams {
+    f32 eye[3] = {};
+    /// Pixels per world unit at distance 1: viewport height / (2 tan(fov_y / 2)).
+    f32 projection_scale = 1.0f;
+    /// Largest allowed projected error, in pixels.
+    f32 max_pixel_error = 2.0f;
+};
+
+/// Chunked terrain LOD. The heightmap is cut into square chunks; every LOD
+/// of a chunk indexes a subset of the chunk's own vertices, so one shared
+/// vertex buffer holds the terrain once and a small set of index-buffer
+/// variants (per LOD and stitch mask) is shared by every chunk.
+///
+/// Neighbouring chunks are kept within one LOD of each other; the finer
+/// side collapses its odd edge vertices onto the even ones, which are
+/// exactly the coarser side's edge vertices, so edges match with no cracks.
+class TerrainLOD {
+public:
+    static constexpr u32 CHUNK_QUADS = 64; // quads per chunk side at LOD 0
+    static constexpr u32 CHUNK_VERTS = CHUNK_QUADS + 1;
+    static constexpr u32 LOD_COUNT = 7;    // 64, 32, ..., 1 quads per side
+
+    /// Build chunk vertices (sampling every `decimate`-th heightmap point
+    /// at LOD 0), error tables and the index variants.
+    void build(const map::Heightmap& hm, u32 decimate);
+
+    /// Pick each chunk's LOD by screen-space error, limit neighbours to
+    /// one LOD apart, derive stitch masks and frustum-test the chunks
+    /// (null frustum: all visible). `out` gets one entry per chunk.
+    void select(const TerrainLODParams& params, const Frustum* frustum,
+                std::vector<TerrainChunkDraw>& out) const;
+
+    /// Index range of one LOD / stitch variant in indices().
+    struct IndexRange {
+        u32 first = 0;
+        u32 count = 0;
+    };
+    IndexRange index_range(u32 lod, u8 stitch) const {
+        return ranges_[lod * terrain_stitch::VARIANTS + stitch];
+    }
+
+    const std::vector<TerrainVertex>& vertices() const { return vertices_; }
+    const std::vector<u32>& indices() const { return indices_; } // chunk-local
+    const std::vector<TerrainChunk>& chunks() const { return chunks_; }
+    u32 chunks_x() const { return chunks_x_; }
+    u32 chunks_z() const { return chunks_z_; }
+
+    /// Triangles drawn for a selection (visible chunks only unless `all`).
+    u64 triangle_count(const std::vector<TerrainChunkDraw>& draws,
+                       bool all = false) const;
+
+    /// Release the CPU copies once the GPU has them (keeps chunk data,
+    /// index ranges and the grid size).
+    void release_geometry();
+
+private:
+    void build_index_variants();
+
+    std::vector<TerrainVertex> vertices_;
+    std::vector<u32> indices_;
+    std::vector<IndexRange> ranges_;
+    std::vector<TerrainChunk> chunks_;
+    u32 chunks_x_ = 0;
+    u32 chunks_z_ = 0;
+};
+
+} // namespace osc::renderer
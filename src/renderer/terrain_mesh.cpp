@@ -5,81 +5,19 @@
 
 #include <spdlog/spdlog.h>
 
-#include <cmath>
-#include <vector>
-
 namespace osc::renderer {
 
 void TerrainMesh::build(const osc::map::Terrain& terrain, VkDevice device,
                         VmaAllocator allocator, VkCommandPool cmd_pool,
                         VkQueue queue) {
-    const auto& hm = terrain.heightmap();
-    u32 gw = hm.grid_width();
-    u32 gh = hm.grid_height();
-
-    // Decimated grid dimensions
-    u32 dw = (gw - 1) / DECIMATE + 1;
-    u32 dh = (gh - 1) / DECIMATE + 1;
-
-    // Generate vertices with normals
-    std::vector<TerrainVertex> vertices(dw * dh);
-
-    for (u32 dz = 0; dz < dh; dz++) {
-        for (u32 dx = 0; dx < dw; dx++) {
-            u32 gx = std::min(dx * DECIMATE, gw - 1);
-            u32 gz = std::min(dz * DECIMATE, gh - 1);
-
-            f32 h = hm.get_height_at_grid(gx, gz);
-            auto& v = vertices[dz * dw + dx];
-            v.x = static_cast<f32>(gx);
-            v.y = h;
-            v.z = static_cast<f32>(gz);
-
-            // Central-difference normal
-            f32 hL = (gx > 0) ? hm.get_height_at_grid(gx - 1, gz) : h;
-            f32 hR = (gx + 1 < gw) ? hm.get_height_at_grid(gx + 1, gz) : h;
-            f32 hD = (gz > 0) ? hm.get_height_at_grid(gx, gz - 1) : h;
-            f32 hU = (gz + 1 < gh) ? hm.get_height_at_grid(gx, gz + 1) : h;
-
-            f32 nx = hL - hR;
-            f32 nz = hD - hU;
-            f32 ny = 2.0f;
-            f32 len = std::sqrt(nx * nx + ny * ny + nz * nz);
-            if (len > 0) { nx /= len; ny /= len; nz /= len; }
-
-            v.nx = nx;
-            v.ny = ny;
-            v.nz = nz;
-        }
-    }
+    lod_.build(terrain.heightmap(), DECIMATE);
+    draws_.clear();
 
-    // Generate indices (two triangles per quad)
-    u32 quads_x = dw - 1;
-    u32 quads_z = dh - 1;
-    std::vector<u32> indices;
-    indices.reserve(quads_x * quads_z * 6);
-
-    for (u32 z = 0; z < quads_z; z++) {
-        for (u32 x = 0; x < quads_x; x++) {
-            u32 tl = z * dw + x;
-            u32 tr = tl + 1;
-            u32 bl = (z + 1) * dw + x;
-            u32 br = bl + 1;
-
-            indices.push_back(tl);
-            indices.push_back(bl);
-            indices.push_back(tr);
-
-            indices.push_back(tr);
-            indices.push_back(bl);
-            indices.push_back(br);
-        }
-    }
-
-    index_count_ = static_cast<u32>(indices.size());
-
-    spdlog::info("Terrain mesh: {}x{} grid, {} vertices, {} indices",
-                 dw, dh, vertices.size(), index_count_);
+    const auto& vertices = lod_.vertices();
+    const auto& indices = lod_.indices();
+    spdlog::info("Terrain mesh: {}x{} chunks, {} vertices, {} variant indices",
+                 lod_.chunks_x(), lod_.chunks_z(), vertices.size(),
+                 indices.size());
 
     // Upload to GPU
     vertex_buf_ = upload_buffer(device, allocator, cmd_pool, queue,
@@ -90,6 +28,25 @@ void TerrainMesh::build(const osc::map::Terrain& terrain, VkDevice device,
                                indices.data(),
                                indices.size() * sizeof(u32),
                                VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+    lod_.release_geometry();
+}
+
+void TerrainMesh::draw(VkCommandBuffer cmd, bool visible_only) const {
+    if (empty() || draws_.size() != lod_.chunks().size()) return;
+
+    VkBuffer vbufs[] = {vertex_buf_.buffer};
+    VkDeviceSize offsets[] = {0};
+    vkCmdBindVertexBuffers(cmd, 0, 1, vbufs, offsets);
+    vkCmdBindIndexBuffer(cmd, index_buf_.buffer, 0, VK_INDEX_TYPE_UINT32);
+
+    const auto& chunks = lod_.chunks();
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        const auto& d = draws_[c];
+        if (visible_only && !d.visible) continue;
+        auto range = lod_.index_range(d.lod, d.stitch);
+        vkCmdDrawIndexed(cmd, range.count, 1, range.first,
+                         static_cast<i32>(chunks[c].vertex_offset), 0);
+    }
 }
 
 void TerrainMesh::destroy(VkDevice device, VmaAllocator allocator) {
@@ -99,7 +56,8 @@ void TerrainMesh::destroy(VkDevice device, VmaAllocator allocator) {
         vmaDestroyBuffer(allocator, index_buf_.buffer, index_buf_.allocation);
     vertex_buf_ = {};
     index_buf_ = {};
-    index_count_ = 0;
+    lod_ = {};
+    draws_.clear();
 }
 
 } // namespace osc::renderer
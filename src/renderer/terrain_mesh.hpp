@@ -1,38 +1,47 @@
 #pragma once
 
+#include "renderer/terrain_lod.hpp"
 #include "renderer/vk_types.hpp"
 #include "core/types.hpp"
 
+#include <vector>
+
 namespace osc::map {
 class Terrain;
 }
 
 namespace osc::renderer {
 
-struct TerrainVertex {
-    f32 x, y, z;    // position
-    f32 nx, ny, nz; // normal
-};
-
-/// Generates a decimated heightmap mesh and uploads to GPU.
+/// Chunked, LOD-selected heightmap mesh on the GPU (see TerrainLOD).
 class TerrainMesh {
 public:
-    /// Generate mesh from terrain heightmap (every DECIMATE-th sample).
+    /// Build chunks from the terrain heightmap (LOD 0 samples every
+    /// DECIMATE-th point) and upload the shared vertex/index buffers.
     void build(const osc::map::Terrain& terrain, VkDevice device,
                VmaAllocator allocator, VkCommandPool cmd_pool, VkQueue queue);
 
     void destroy(VkDevice device, VmaAllocator allocator);
 
-    VkBuffer vertex_buffer() const { return vertex_buf_.buffer; }
-    VkBuffer index_buffer() const { return index_buf_.buffer; }
-    u32 index_count() const { return index_count_; }
+    /// Per-frame chunk LOD selection and frustum culling.
+    void select(const TerrainLODParams& params, const Frustum* frustum) {
+        lod_.select(params, frustum, draws_);
+    }
+
+    /// Bind the buffers and draw the selected chunks. The shadow pass
+    /// passes `visible_only = false`: casters outside the view still matter.
+    void draw(VkCommandBuffer cmd, bool visible_only) const;
+
+    bool empty() const { return vertex_buf_.buffer == VK_NULL_HANDLE; }
+    const TerrainLOD& lod() const { return lod_; }
+    const std::vector<TerrainChunkDraw>& chunk_draws() const { return draws_; }
 
     static constexpr u32 DECIMATE = 2; // sample every 2nd point
 
 private:
+    TerrainLOD lod_;
+    std::vector<TerrainChunkDraw> draws_;
     AllocatedBuffer vertex_buf_{};
     AllocatedBuffer index_buf_{};
-    u32 index_count_ = 0;
 };
 
 } // namespace osc::renderer
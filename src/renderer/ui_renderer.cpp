@@ -115,18 +115,17 @@ void UIRenderer::emit_text_quads(ui::UIControl* ctrl, FontCache& font_cache,
     for (unsigned char c : text) {
         if (quad_count_ >= MAX_UI_QUADS) break;
 
-        auto git = atlas->glyphs.find(static_cast<u32>(c));
-        if (git == atlas->glyphs.end()) {
+        const GlyphInfo* glyph = atlas->glyph(c);
+        if (!glyph) {
             // Unknown glyph — advance by space width
-            auto space = atlas->glyphs.find(32);
-            if (space != atlas->glyphs.end())
-                cursor_x += space->second.x_advance;
+            if (const GlyphInfo* space = atlas->glyph(32))
+                cursor_x += space->x_advance;
             else
                 cursor_x += static_cast<f32>(ctrl->font_pointsize()) * 0.6f;
             continue;
         }
 
-        const auto& gi = git->second;
+        const auto& gi = *glyph;
 
         // Skip spaces (no visible glyph)
         if (gi.width > 0 && gi.height > 0) {
@@ -215,10 +214,10 @@ void UIRenderer::emit_edit_quads(ui::UIControl* ctrl, TextureCache& tex_cache,
             // Advance cursor_x through glyphs up to caret_position
             i32 pos = ctrl->caret_position();
             for (i32 i = 0; i < pos && i < static_cast<i32>(text.size()); i++) {
-                auto git = atlas->glyphs.find(static_cast<u32>(
-                    static_cast<unsigned char>(text[i])));
-                if (git != atlas->glyphs.end()) {
-                    caret_x += git->second.x_advance;
+                const GlyphInfo* glyph = atlas->glyph(
+                    static_cast<unsigned char>(text[i]));
+                if (glyph) {
+                    caret_x += glyph->x_advance;
                 } else {
                     caret_x += static_cast<f32>(ctrl->font_pointsize()) * 0.6f;
                 }
@@ -313,15 +312,14 @@ void UIRenderer::emit_itemlist_quads(ui::UIControl* ctrl,
 
             for (unsigned char c : items[i]) {
                 if (quad_count_ >= MAX_UI_QUADS) break;
-                auto git = atlas->glyphs.find(static_cast<u32>(c));
-                if (git == atlas->glyphs.end()) {
-                    auto sp = atlas->glyphs.find(32);
-                    cursor_x += sp != atlas->glyphs.end()
-                        ? sp->second.x_advance
-                        : static_cast<f32>(ctrl->font_pointsize()) * 0.6f;
+                const GlyphInfo* glyph = atlas->glyph(c);
+                if (!glyph) {
+                    const GlyphInfo* sp = atlas->glyph(32);
+                    cursor_x += sp ? sp->x_advance
+                                   : static_cast<f32>(ctrl->font_pointsize()) * 0.6f;
                     continue;
                 }
-                const auto& gi = git->second;
+                const auto& gi = *glyph;
                 if (gi.width > 0 && gi.height > 0) {
                     f32 gx = cursor_x + gi.x_offset;
                     f32 gy = baseline_y + gi.y_offset;
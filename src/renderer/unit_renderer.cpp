@@ -1,4 +1,5 @@
 #include "renderer/unit_renderer.hpp"
+#include "core/profiler.hpp"
 #include "renderer/army_colors.hpp"
 #include "renderer/camera.hpp"
 #include "renderer/texture_cache.hpp"
@@ -10,12 +11,20 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <unordered_map>
 #include <unordered_set>
 
 namespace osc::renderer {
 
+static_assert(sizeof(MeshInstance) == sizeof(CulledInstance),
+              "culled instances are drawn with the MeshInstance vertex layout");
+static_assert(offsetof(MeshInstance, bone_base) == offsetof(CulledInstance, bone_base),
+              "culled instances are drawn with the MeshInstance vertex layout");
+
 // Cube vertex: position + normal
 struct CubeVertex {
     f32 x, y, z;
@@ -78,8 +87,98 @@ static void build_model_matrix(f32* out, const sim::Vector3& pos,
     out[15] = 1.0f;
 }
 
+/// Bounding sphere radius for frustum culling, by entity kind.
+static f32 bound_radius(const sim::Entity& entity) {
+    if (entity.is_unit()) {
+        auto* unit = static_cast<const sim::Unit*>(&entity);
+        return std::max(unit->footprint_size_x() * 1.5f, 5.0f);
+    }
+    if (entity.is_prop()) return std::max(entity.scale_x() * 2.0f, 2.0f);
+    return 5.0f; // projectiles
+}
+
+/// Selection highlight: brighten team color.
+static void apply_selection_tint(f32& r, f32& g, f32& b) {
+    r = r * 0.5f + 0.5f;
+    g = g * 0.5f + 0.5f;
+    b = b * 0.5f + 0.5f;
+}
+
+/// Wreckage: desaturate + darken to distinguish from live units.
+static void apply_wreckage_tint(f32& r, f32& g, f32& b) {
+    f32 lum = 0.299f * r + 0.587f * g + 0.114f * b;
+    r = lum * 0.5f + r * 0.15f;
+    g = lum * 0.5f + g * 0.15f;
+    b = lum * 0.5f + b * 0.15f;
+}
+
+/// Resolve a mesh's albedo / SpecTeam / normal descriptors, with fallbacks.
+static void resolve_mesh_textures(const GPUMesh* mesh, TextureCache* tex_cache,
+                                  VkDescriptorSet& albedo,
+                                  VkDescriptorSet& specteam,
+                                  VkDescriptorSet& normal) {
+    if (!tex_cache || !mesh) return;
+    auto resolve = [&](const std::string& path, VkDescriptorSet fallback) {
+        if (!path.empty()) {
+            if (auto* tex = tex_cache->get(path)) return tex->descriptor_set;
+        }
+        return fallback;
+    };
+    albedo = resolve(mesh->texture_path, tex_cache->fallback_descriptor());
+    specteam = resolve(mesh->specteam_path,
+                       tex_cache->specteam_fallback_descriptor());
+    normal = resolve(mesh->normal_path, tex_cache->normal_fallback_descriptor());
+}
+
+/// Grow a culling or bone buffer to hold `need` bytes. Sets `grown` if it
+/// was (re)allocated; the old contents are not kept. On failure the buffer
+/// is left empty.
+static VkResult ensure_buffer(VmaAllocator allocator, AllocatedBuffer& buf,
+                                   void** mapped, VkDeviceSize& capacity,
+                                   VkDeviceSize need, VkBufferUsageFlags usage,
+                                   bool& grown) {
+    if (buf.buffer && need <= capacity) return VK_SUCCESS;
+    if (buf.buffer) vmaDestroyBuffer(allocator, buf.buffer, buf.allocation);
+    buf = {};
+    if (mapped) *mapped = nullptr;
+    grown = true;
+    capacity = std::max(need, capacity * 2);
+
+    VkBufferCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    ci.size = capacity;
+    ci.usage = usage;
+
+    VmaAllocationCreateInfo alloc_ci{};
+    if (mapped) {
+        alloc_ci.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+        alloc_ci.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT |
+                         VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        alloc_ci.requiredFlags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    } else {
+        alloc_ci.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+    }
+
+    VmaAllocationInfo info{};
+    VkResult result = vmaCreateBuffer(allocator, &ci, &alloc_ci, &buf.buffer,
+                                      &buf.allocation, &info);
+    if (result == VK_SUCCESS && mapped && !info.pMappedData) {
+        vmaDestroyBuffer(allocator, buf.buffer, buf.allocation);
+        result = VK_ERROR_MEMORY_MAP_FAILED;
+    }
+    if (result != VK_SUCCESS) {
+        buf = {};
+        capacity = 0;
+        return result;
+    }
+    if (mapped) *mapped = info.pMappedData;
+    return VK_SUCCESS;
+}
+
 void UnitRenderer::build(VkDevice device, VmaAllocator allocator,
                          VkCommandPool cmd_pool, VkQueue queue) {
+    allocator_ = allocator;
+
     // Unit cube: centered at origin, 1x1x1
     static const CubeVertex cube_verts[] = {
         // Front (+Z)
@@ -145,28 +244,14 @@ void UnitRenderer::build(VkDevice device, VmaAllocator allocator,
                             sizeof(MeshInstance));
     }
 
-    // Bone SSBO (persistently mapped, for GPU skinning, per-frame)
-    {
-        VkBufferCreateInfo ci{};
-        ci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        // MAX_INSTANCES * MAX_BONES_PER_UNIT * sizeof(mat4) = 8192*64*64 = 32MB
-        ci.size = static_cast<VkDeviceSize>(MAX_INSTANCES) *
-                  MAX_BONES_PER_UNIT * sizeof(f32) * 16;
-        ci.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-
-        VmaAllocationCreateInfo alloc_ci{};
-        alloc_ci.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
-        alloc_ci.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT |
-                         VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
-        alloc_ci.requiredFlags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-
-        for (u32 i = 0; i < FRAMES_IN_FLIGHT; i++) {
-            VmaAllocationInfo info{};
-            vmaCreateBuffer(allocator, &ci, &alloc_ci,
-                            &bone_ssbo_[i].buffer, &bone_ssbo_[i].allocation,
-                            &info);
-            bone_ssbo_mapped_[i] = info.pMappedData;
-        }
+    // Bone SSBO (persistently mapped, for GPU skinning, per-frame). Starts
+    // at 256 fully skinned units (1 MB) and grows with the instances.
+    for (u32 i = 0; i < FRAMES_IN_FLIGHT; i++) {
+        bool grown = false;
+        ensure_buffer(allocator, bone_ssbo_[i], &bone_ssbo_mapped_[i],
+                      bone_ssbo_size_[i],
+                      256 * MAX_BONES_PER_UNIT * sizeof(f32) * 16,
+                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, grown);
     }
 }
 
@@ -181,6 +266,10 @@ void UnitRenderer::preload_meshes(const sim::SimState& sim,
         }
     });
 
+    // Queue every blueprint first so the loader parses them in parallel
+    for (auto& id : bp_ids) mesh_cache.get(id, L);
+    mesh_cache.finish_loading();
+
     u32 loaded = 0, failed = 0;
     for (auto& id : bp_ids) {
         if (mesh_cache.get(id, L))
@@ -193,7 +282,7 @@ void UnitRenderer::preload_meshes(const sim::SimState& sim,
                  bp_ids.size(), loaded, failed);
 }
 
-void UnitRenderer::update(const sim::SimState& sim, MeshCache& mesh_cache,
+void UnitRenderer::update(sim::SimState& sim, MeshCache& mesh_cache,
                            lua_State* L, TextureCache* tex_cache,
                            const Camera* camera,
                            const std::unordered_set<u32>* selected_ids,
@@ -204,27 +293,22 @@ void UnitRenderer::update(const sim::SimState& sim, MeshCache& mesh_cache,
 
     auto* cube_instances = static_cast<CubeInstance*>(cube_instance_mapped_[fi_]);
     auto* mesh_instances = static_cast<MeshInstance*>(mesh_instance_mapped_[fi_]);
-    auto* bone_data = bone_ssbo_mapped_[fi_]
-                          ? static_cast<f32*>(bone_ssbo_mapped_[fi_]) : nullptr;
     u32 cube_count = 0;
     u32 mesh_count = 0;
+    u32 cpu_bones = 0; // bone matrices needed by the CPU path
 
     // Frustum culling replaces old distance-only prop culling
 
-    // Per-instance bone info (parallel to mesh_groups entries)
-    struct InstanceBones {
-        const sim::Unit* unit = nullptr;
-        u32 bone_count = 0;  // 0 = no skinning
-    };
-
-    // Group mesh instances by GPUMesh pointer, with bone info
+    // Group mesh instances by GPUMesh pointer, with the unit whose bones
+    // each instance uses (null = no skinning)
     struct GroupData {
         std::vector<MeshInstance> instances;
-        std::vector<InstanceBones> bones;
+        std::vector<const sim::Unit*> units;
     };
     std::unordered_map<const GPUMesh*, GroupData> mesh_groups;
 
-    sim.entity_registry().for_each([&](const sim::Entity& entity) {
+    // CPU path: frustum test, LOD pick and grouping for one entity
+    auto emit = [&](const sim::Entity& entity) {
         if ((!entity.is_unit() && !entity.is_prop() && !entity.is_projectile()) || entity.destroyed())
             return;
         if (cube_count + mesh_count >= MAX_INSTANCES)
@@ -232,16 +316,9 @@ void UnitRenderer::update(const sim::SimState& sim, MeshCache& mesh_cache,
 
         // Frustum cull all entities (units, props, projectiles)
         if (frustum) {
-            f32 bound_radius = 5.0f; // default for projectiles
-            if (entity.is_unit()) {
-                auto* unit = static_cast<const sim::Unit*>(&entity);
-                f32 fp = unit->footprint_size_x();
-                bound_radius = std::max(fp * 1.5f, 5.0f);
-            } else if (entity.is_prop()) {
-                bound_radius = std::max(entity.scale_x() * 2.0f, 2.0f);
-            }
             const auto& pos = entity.position();
-            if (!frustum->is_sphere_visible(pos.x, pos.y, pos.z, bound_radius)) {
+            if (!frustum->is_sphere_visible(pos.x, pos.y, pos.z,
+                                            bound_radius(entity))) {
                 return;
             }
         }
@@ -275,19 +352,11 @@ void UnitRenderer::update(const sim::SimState& sim, MeshCache& mesh_cache,
             f32 sz = entity.scale_z() * gpu->uniform_scale;
             build_model_matrix(inst.model, entity.position(),
                                entity.orientation(), sx, sy, sz);
-            // Wreckage: desaturate + darken to distinguish from live units
-            if (entity.is_wreckage()) {
-                f32 lum = 0.299f * r + 0.587f * g + 0.114f * b;
-                r = lum * 0.5f + r * 0.15f;
-                g = lum * 0.5f + g * 0.15f;
-                b = lum * 0.5f + b * 0.15f;
-            }
+            if (entity.is_wreckage()) apply_wreckage_tint(r, g, b);
             // Selection highlight: brighten team color
             if (selected_ids && entity.is_unit() &&
                 selected_ids->count(entity.entity_id())) {
-                r = r * 0.5f + 0.5f;
-                g = g * 0.5f + 0.5f;
-                b = b * 0.5f + 0.5f;
+                apply_selection_tint(r, g, b);
             }
             inst.r = r; inst.g = g; inst.b = b; inst.a = a;
 
@@ -297,11 +366,11 @@ void UnitRenderer::update(const sim::SimState& sim, MeshCache& mesh_cache,
             // Track bone data for this instance (props have no bones)
             if (entity.is_unit()) {
                 auto* unit = static_cast<const sim::Unit*>(&entity);
-                u32 bc = unit->animated_bone_count();
-                if (bc > MAX_BONES_PER_UNIT) bc = MAX_BONES_PER_UNIT;
-                gd.bones.push_back({unit, bc});
+                gd.units.push_back(unit);
+                cpu_bones += std::min(unit->animated_bone_count(),
+                                      MAX_BONES_PER_UNIT);
             } else {
-                gd.bones.push_back({nullptr, 0});
+                gd.units.push_back(nullptr);
             }
 
             mesh_count++;
@@ -320,16 +389,92 @@ void UnitRenderer::update(const sim::SimState& sim, MeshCache& mesh_cache,
             }
             cube_count++;
         }
-    });
+    };
+
+    if (gpu_culling_) {
+        PROFILE_ZONE("UnitRenderer::sync_cull_scene");
+        auto& registry = sim.entity_registry();
+        bool all = cull_registry_ != &registry;
+        if (all) {
+            reset_cull_scene();
+            cull_registry_ = &registry;
+        }
+        changed_.clear();
+        if (!registry.take_render_changes(changed_)) all = true;
+
+        // Selection changes recolor the units selected or deselected
+        for (u32 id : highlighted_) {
+            if (!selected_ids || !selected_ids->count(id)) changed_.push_back(id);
+        }
+        if (selected_ids) {
+            for (u32 id : *selected_ids) {
+                if (!highlighted_.count(id)) changed_.push_back(id);
+            }
+        }
+
+        // Entities waiting for a mesh get another look once one arrives
+        for (const auto& key : waiting_meshes_) {
+            if (mesh_cache.loading(key)) continue;
+            changed_.insert(changed_.end(), pending_.begin(), pending_.end());
+            waiting_meshes_.clear();
+            break;
+        }
+
+        selected_ = selected_ids;
+        sync_cull_scene(sim, mesh_cache, L, all);
+        selected_ = nullptr;
+
+        if (!ensure_bone_ssbo(bone_end_) || !upload_cull_scene()) {
+            // Out of memory for the cull buffers: stay on the CPU path
+            spdlog::error("UnitRenderer: cannot allocate culling buffers, "
+                          "GPU culling disabled");
+            gpu_culling_ = false;
+            reset_cull_scene();
+            cull_registry_ = nullptr;
+        }
+    }
+
+    if (gpu_culling_) {
+        for (u32 id : pending_) {
+            if (auto* entity = sim.entity_registry().find(id)) emit(*entity);
+        }
+
+        f32 eye[3];
+        if (camera) camera->eye_position(eye[0], eye[1], eye[2]);
+        cull_params_ = make_cull_params(
+            frustum, camera ? eye : nullptr,
+            static_cast<u32>(cull_scene_.instances().size()));
+
+        culled_groups_.clear();
+        for (size_t i = 0; i < cull_meshes_.size(); ++i) {
+            if (!cull_meshes_[i] || cull_params_.instance_count == 0 ||
+                cull_scene_.set_instance_count(cull_lod_set_[i]) == 0)
+                continue;
+            CulledDrawGroup group;
+            group.mesh = cull_meshes_[i];
+            group.first_instance = cull_scene_.lods()[i].first_instance;
+            group.command_offset = i * sizeof(DrawIndexedIndirect);
+            resolve_mesh_textures(group.mesh, tex_cache, group.texture_ds,
+                                  group.specteam_ds, group.normal_ds);
+            culled_groups_.push_back(group);
+        }
+    } else {
+        sim.entity_registry().for_each(emit);
+    }
 
     cube_instance_count_ = cube_count;
 
+    // CPU-path bones follow the cull records' ranges in the same SSBO
+    u32 bone_offset = gpu_culling_ ? bone_end_ : 0; // in mat4 units
+    if (!ensure_bone_ssbo(bone_offset + cpu_bones)) {
+        spdlog::error("UnitRenderer: cannot allocate the bone buffer");
+        culled_groups_.clear();
+        return;
+    }
+    auto* bone_data = static_cast<f32*>(bone_ssbo_mapped_[fi_]);
+
     // Flatten mesh groups into contiguous instance buffer + bone SSBO
     u32 offset = 0;
-    u32 bone_offset = 0; // in mat4 units (each mat4 = 16 floats)
-    static constexpr f32 IDENTITY[16] = {
-        1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
-    u32 max_bone_entries = MAX_INSTANCES * MAX_BONES_PER_UNIT;
 
     mesh_groups_.clear();
     for (auto& [gpu, gd] : mesh_groups) {
@@ -337,52 +482,28 @@ void UnitRenderer::update(const sim::SimState& sim, MeshCache& mesh_cache,
         if (offset + count > MAX_INSTANCES) {
             count = MAX_INSTANCES - offset;
         }
-        std::memcpy(mesh_instances + offset, gd.instances.data(),
-                     count * sizeof(MeshInstance));
 
         MeshDrawGroup group;
         group.mesh = gpu;
         group.instance_offset = offset;
         group.instance_count = count;
 
-        // Determine bones_per_instance: use max across the group
-        // (all instances in a group share the same blueprint/mesh)
-        u32 group_bones = 0;
+        // Write each instance with its own range of bone matrices
         for (u32 i = 0; i < count; i++) {
-            if (gd.bones[i].bone_count > group_bones)
-                group_bones = gd.bones[i].bone_count;
-        }
-
-        // Write bone matrices to SSBO
-        group.bone_base_offset = bone_offset;
-        group.bones_per_instance = group_bones;
-
-        if (bone_data && group_bones > 0 && bone_offset < max_bone_entries) {
-            u32 max_for_bones = (max_bone_entries - bone_offset) / group_bones;
-            u32 safe_count = std::min(count, max_for_bones);
-            for (u32 i = 0; i < safe_count; i++) {
-                u32 base = bone_offset + i * group_bones;
-
-                auto* unit = gd.bones[i].unit;
-                u32 bc = 0;
-                if (unit) {
-                    auto& mats = unit->animated_bone_matrices();
-                    bc = static_cast<u32>(mats.size());
-                    if (bc > group_bones) bc = group_bones;
-
-                    // Copy actual bone matrices
-                    for (u32 b = 0; b < bc; b++) {
-                        std::memcpy(bone_data + (base + b) * 16,
-                                    mats[b].data(), sizeof(f32) * 16);
-                    }
-                }
-                // Fill remaining with identity
-                for (u32 b = bc; b < group_bones; b++) {
-                    std::memcpy(bone_data + (base + b) * 16,
-                                IDENTITY, sizeof(f32) * 16);
+            auto& inst = gd.instances[i];
+            if (auto* unit = gd.units[i]) {
+                const auto& mats = unit->animated_bone_matrices();
+                u32 bc = std::min(static_cast<u32>(mats.size()),
+                                  MAX_BONES_PER_UNIT);
+                for (u32 b = 0; b < bc; b++) {
+                    std::memcpy(bone_data + (bone_offset + b) * 16,
+                                mats[b].data(), sizeof(f32) * 16);
                 }
+                inst.bone_base = bone_offset;
+                inst.bone_count = bc;
+                bone_offset += bc;
             }
-            bone_offset += safe_count * group_bones;
+            mesh_instances[offset + i] = inst;
         }
 
         // Resolve texture descriptors for this group
@@ -425,6 +546,306 @@ void UnitRenderer::update(const sim::SimState& sim, MeshCache& mesh_cache,
 
         offset += count;
     }
+
+    if (gpu_culling_) write_cull_bones(sim);
+}
+
+void UnitRenderer::sync_cull_scene(sim::SimState& sim, MeshCache& mesh_cache,
+                                   lua_State* L, bool all) {
+    if (all) {
+        reset_cull_scene();
+        sim.entity_registry().for_each([&](const sim::Entity& entity) {
+            sync_entity(entity.entity_id(), sim, mesh_cache, L);
+        });
+    } else {
+        for (u32 id : changed_) sync_entity(id, sim, mesh_cache, L);
+    }
+    if (cull_scene_.layout_changed()) {
+        cull_scene_.finalize();
+        spdlog::debug("UnitRenderer: cull scene has {} instances in {} mesh "
+                      "sets, {} on the CPU path",
+                      cull_scene_.instances().size(),
+                      cull_scene_.sets().size(), pending_.size());
+    }
+}
+
+void UnitRenderer::sync_entity(u32 id, const sim::SimState& sim,
+                               MeshCache& mesh_cache, lua_State* L) {
+    const sim::Entity* entity = sim.entity_registry().find(id);
+    if (!entity || entity->destroyed() ||
+        (!entity->is_unit() && !entity->is_prop() && !entity->is_projectile())) {
+        drop_record(id);
+        pending_.erase(id);
+        highlighted_.erase(id);
+        return;
+    }
+
+    // Same mesh choice as the CPU path: SetMesh override, then the
+    // blueprint. Sets still loading stay on the CPU path for now.
+    const LODSet* lods = nullptr;
+    const std::string* key = nullptr;
+    for (const auto* mesh_id : {&entity->mesh_override(), &entity->blueprint_id()}) {
+        if (mesh_id->empty()) continue;
+        mesh_cache.get_lod(*mesh_id, 0.0f, L); // starts loading on a miss
+        if (mesh_cache.loading(*mesh_id)) {
+            waiting_meshes_.insert(*mesh_id);
+            break;
+        }
+        lods = mesh_cache.get_lod_set(*mesh_id);
+        if (lods && !lods->lods.empty()) {
+            key = mesh_id;
+            break;
+        }
+        lods = nullptr;
+    }
+    if (!key) {
+        drop_record(id);
+        pending_.insert(id);
+        highlighted_.erase(id);
+        return;
+    }
+    pending_.erase(id);
+
+    auto [set_it, added] = cull_set_index_.try_emplace(*key, 0);
+    if (added) {
+        std::vector<f32> cutoffs;
+        std::vector<u32> index_counts;
+        for (const auto& lod : lods->lods) {
+            cutoffs.push_back(lod.cutoff);
+            index_counts.push_back(lod.mesh.index_count);
+        }
+        set_it->second = cull_scene_.add_set(cutoffs, index_counts);
+        for (const auto& lod : lods->lods) {
+            cull_meshes_.push_back(&lod.mesh);
+            cull_lod_set_.push_back(set_it->second);
+        }
+    }
+
+    CullInstance inst{};
+    f32 s = lods->lods.front().mesh.uniform_scale;
+    build_model_matrix(inst.model, entity->position(), entity->orientation(),
+                       entity->scale_x() * s, entity->scale_y() * s,
+                       entity->scale_z() * s);
+    get_army_color(*entity, sim, inst.color[0], inst.color[1],
+                   inst.color[2], inst.color[3]);
+    if (entity->is_wreckage())
+        apply_wreckage_tint(inst.color[0], inst.color[1], inst.color[2]);
+    if (selected_ && entity->is_unit() && selected_->count(id)) {
+        apply_selection_tint(inst.color[0], inst.color[1], inst.color[2]);
+        highlighted_.insert(id);
+    } else {
+        highlighted_.erase(id);
+    }
+    const auto& pos = entity->position();
+    inst.sphere[0] = pos.x;
+    inst.sphere[1] = pos.y;
+    inst.sphere[2] = pos.z;
+    inst.sphere[3] = bound_radius(*entity);
+    inst.lod_set = set_it->second;
+
+    // Skinned units keep their bone range while their bone count holds
+    u32 bones = 0;
+    if (entity->is_unit()) {
+        bones = std::min(static_cast<const sim::Unit*>(entity)->animated_bone_count(),
+                         MAX_BONES_PER_UNIT);
+    }
+    auto record = cull_record_.find(id);
+    if (record != cull_record_.end()) {
+        const auto& old = cull_scene_.instances()[record->second];
+        inst.bone_base = old.bone_base;
+        inst.bone_count = old.bone_count;
+    }
+    if (inst.bone_count != bones) {
+        if (inst.bone_count) release_bones(inst.bone_base, inst.bone_count);
+        inst.bone_base = bones ? alloc_bones(bones) : 0;
+        inst.bone_count = bones;
+    }
+    if (bones)
+        skinned_.insert(id);
+    else
+        skinned_.erase(id);
+
+    if (record != cull_record_.end()) {
+        cull_scene_.update_instance(record->second, inst);
+    } else {
+        cull_record_[id] = cull_scene_.add_instance(inst);
+        cull_owner_.push_back(id);
+    }
+}
+
+void UnitRenderer::drop_record(u32 id) {
+    auto it = cull_record_.find(id);
+    if (it == cull_record_.end()) return;
+    u32 index = it->second;
+    const auto& inst = cull_scene_.instances()[index];
+    if (inst.bone_count) release_bones(inst.bone_base, inst.bone_count);
+    skinned_.erase(id);
+    cull_record_.erase(it);
+
+    u32 moved = cull_scene_.remove_instance(index);
+    if (moved != CullScene::NO_INSTANCE) {
+        u32 owner = cull_owner_[moved];
+        cull_owner_[index] = owner;
+        cull_record_[owner] = index;
+    }
+    cull_owner_.pop_back();
+}
+
+void UnitRenderer::write_cull_bones(const sim::SimState& sim) {
+    static constexpr f32 IDENTITY[16] = {
+        1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    auto* bone_data = static_cast<f32*>(bone_ssbo_mapped_[fi_]);
+    if (!bone_data) return;
+
+    // Both frames' SSBOs need every range, so all skinned units are
+    // written each frame, visible or not
+    for (u32 id : skinned_) {
+        auto record = cull_record_.find(id);
+        auto* entity = sim.entity_registry().find(id);
+        if (record == cull_record_.end() || !entity) continue;
+        const auto& inst = cull_scene_.instances()[record->second];
+        const auto& mats = static_cast<const sim::Unit*>(entity)->animated_bone_matrices();
+        u32 bc = std::min(static_cast<u32>(mats.size()), inst.bone_count);
+        for (u32 b = 0; b < bc; b++) {
+            std::memcpy(bone_data + (inst.bone_base + b) * 16,
+                        mats[b].data(), sizeof(f32) * 16);
+        }
+        for (u32 b = bc; b < inst.bone_count; b++) {
+            std::memcpy(bone_data + (inst.bone_base + b) * 16,
+                        IDENTITY, sizeof(f32) * 16);
+        }
+    }
+}
+
+u32 UnitRenderer::alloc_bones(u32 count) {
+    auto it = free_bones_.find(count);
+    if (it != free_bones_.end() && !it->second.empty()) {
+        u32 base = it->second.back();
+        it->second.pop_back();
+        return base;
+    }
+    u32 base = bone_end_;
+    bone_end_ += count;
+    return base;
+}
+
+void UnitRenderer::release_bones(u32 base, u32 count) {
+    free_bones_[count].push_back(base);
+}
+
+bool UnitRenderer::ensure_bone_ssbo(u32 matrices) {
+    if (!allocator_) return bone_ssbo_mapped_[fi_] != nullptr;
+    bool grown = false;
+    VkResult result = ensure_buffer(
+        allocator_, bone_ssbo_[fi_], &bone_ssbo_mapped_[fi_], bone_ssbo_size_[fi_],
+        std::max<VkDeviceSize>(matrices, 1) * sizeof(f32) * 16,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, grown);
+    if (grown) bone_ssbo_version_[fi_]++;
+    return result == VK_SUCCESS;
+}
+
+void UnitRenderer::reset_cull_scene() {
+    cull_scene_.clear();
+    cull_set_index_.clear();
+    cull_meshes_.clear();
+    cull_lod_set_.clear();
+    cull_record_.clear();
+    cull_owner_.clear();
+    skinned_.clear();
+    highlighted_.clear();
+    pending_.clear();
+    waiting_meshes_.clear();
+    bone_end_ = 0;
+    free_bones_.clear();
+    cull_params_ = {};
+    culled_groups_.clear();
+    for (auto& cb : cull_bufs_) {
+        cb.dirty.clear();
+        cb.dirty_all = true;
+    }
+}
+
+bool UnitRenderer::upload_cull_scene() {
+    auto& cb = cull_bufs_[fi_];
+    const auto& instances = cull_scene_.instances();
+
+    // Records changed since the last frame must reach both frames' copies
+    changed_.clear();
+    cull_scene_.take_dirty(changed_);
+    for (auto& frame : cull_bufs_) {
+        if (frame.dirty_all) continue;
+        frame.dirty.insert(frame.dirty.end(), changed_.begin(), changed_.end());
+        if (frame.dirty.size() > instances.size()) {
+            frame.dirty.clear();
+            frame.dirty_all = true;
+        }
+    }
+    if (instances.empty() || !allocator_) return true;
+
+    constexpr VkBufferUsageFlags STORAGE = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    const auto& sets = cull_scene_.sets();
+    const auto& lods = cull_scene_.lods();
+    const auto& draws = cull_scene_.draws();
+
+    bool grown = false;
+    VkResult result = ensure_buffer(
+        allocator_, cb.instances, &cb.instances_mapped, cb.instances_size,
+        instances.size() * sizeof(CullInstance), STORAGE, grown);
+    if (result == VK_SUCCESS)
+        result = ensure_buffer(allocator_, cb.sets, &cb.sets_mapped, cb.sets_size,
+                               sets.size() * sizeof(CullLODSet), STORAGE, grown);
+    if (result == VK_SUCCESS)
+        result = ensure_buffer(allocator_, cb.lods, &cb.lods_mapped, cb.lods_size,
+                               lods.size() * sizeof(CullLOD), STORAGE, grown);
+    if (result == VK_SUCCESS)
+        result = ensure_buffer(allocator_, cb.draws, &cb.draws_mapped, cb.draws_size,
+                               draws.size() * sizeof(DrawIndexedIndirect),
+                               STORAGE | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, grown);
+    if (result == VK_SUCCESS)
+        result = ensure_buffer(allocator_, cb.visible, nullptr, cb.visible_size,
+                               static_cast<VkDeviceSize>(cull_scene_.output_capacity()) *
+                                   sizeof(CulledInstance),
+                               STORAGE | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, grown);
+    if (grown) {
+        cb.version++;
+        cb.dirty_all = true;
+        cb.uploaded_layout = ~0u;
+    }
+    if (result != VK_SUCCESS) return false;
+
+    // Only the records that changed are copied, and the tables only when
+    // a set gained or lost instances; the draw commands are reset every
+    // frame (the culling pass counts instances into them)
+    auto* dst = static_cast<CullInstance*>(cb.instances_mapped);
+    if (cb.dirty_all) {
+        std::memcpy(dst, instances.data(), instances.size() * sizeof(CullInstance));
+    } else {
+        for (u32 index : cb.dirty) {
+            if (index < instances.size()) dst[index] = instances[index];
+        }
+    }
+    cb.dirty.clear();
+    cb.dirty_all = false;
+    if (cb.uploaded_layout != cull_scene_.layout_revision()) {
+        std::memcpy(cb.sets_mapped, sets.data(), sets.size() * sizeof(CullLODSet));
+        std::memcpy(cb.lods_mapped, lods.data(), lods.size() * sizeof(CullLOD));
+        cb.uploaded_layout = cull_scene_.layout_revision();
+    }
+    std::memcpy(cb.draws_mapped, draws.data(),
+                draws.size() * sizeof(DrawIndexedIndirect));
+    return true;
+}
+
+CullFrameBuffers UnitRenderer::cull_buffers(u32 fi) const {
+    const auto& cb = cull_bufs_[fi];
+    CullFrameBuffers out;
+    out.instances = cb.instances.buffer;
+    out.sets = cb.sets.buffer;
+    out.lods = cb.lods.buffer;
+    out.draws = cb.draws.buffer;
+    out.visible = cb.visible.buffer;
+    out.version = cb.version;
+    return out;
 }
 
 bool UnitRenderer::inject_ghost(const GPUMesh* mesh, f32 x, f32 y, f32 z,
@@ -446,6 +867,8 @@ bool UnitRenderer::inject_ghost(const GPUMesh* mesh, f32 x, f32 y, f32 z,
     inst.model[0] = s;  inst.model[5] = s;  inst.model[10] = s;  inst.model[15] = 1.0f;
     inst.model[12] = x; inst.model[13] = y;  inst.model[14] = z;
     inst.r = r; inst.g = g; inst.b = b; inst.a = a;
+    inst.bone_base = 0;
+    inst.bone_count = 0;
 
     // Find existing group for this mesh or create new one
     MeshDrawGroup* target = nullptr;
@@ -464,8 +887,6 @@ bool UnitRenderer::inject_ghost(const GPUMesh* mesh, f32 x, f32 y, f32 z,
         grp.mesh = mesh;
         grp.instance_offset = total;
         grp.instance_count = 1;
-        grp.bone_base_offset = 0;
-        grp.bones_per_instance = 0;
 
         if (tex_cache && !mesh->texture_path.empty()) {
             auto* tex = tex_cache->get(mesh->texture_path);
@@ -508,12 +929,23 @@ void UnitRenderer::destroy(VkDevice device, VmaAllocator allocator) {
         safe_destroy(cube_instance_buf_[i]);
         safe_destroy(mesh_instance_buf_[i]);
         safe_destroy(bone_ssbo_[i]);
+        bone_ssbo_size_[i] = 0;
+        auto& cb = cull_bufs_[i];
+        safe_destroy(cb.instances);
+        safe_destroy(cb.sets);
+        safe_destroy(cb.lods);
+        safe_destroy(cb.draws);
+        safe_destroy(cb.visible);
+        cb = {};
         cube_instance_mapped_[i] = nullptr;
         mesh_instance_mapped_[i] = nullptr;
         bone_ssbo_mapped_[i] = nullptr;
     }
     cube_instance_count_ = 0;
     mesh_groups_.clear();
+
+    reset_cull_scene();
+    cull_registry_ = nullptr;
 }
 
 } // namespace osc::renderer
@@ -3,6 +3,7 @@
 #include "renderer/vk_types.hpp"
 #include "renderer/mesh_cache.hpp"
 #include "renderer/frustum.hpp"
+#include "renderer/instance_culling.hpp"
 #include "core/types.hpp"
 
 #include <string>
@@ -13,6 +14,7 @@
 struct lua_State;
 
 namespace osc::sim {
+class EntityRegistry;
 class SimState;
 }
 
@@ -32,6 +34,9 @@ struct CubeInstance {
 struct MeshInstance {
     f32 model[16];    // column-major 4x4 model matrix
     f32 r, g, b, a;  // army color + alpha
+    u32 bone_base = 0;  // first matrix in the bone SSBO
+    u32 bone_count = 0; // 0 = no skinning
+    u32 pad[2] = {};
 };
 
 /// A group of instances sharing the same GPU mesh.
@@ -42,11 +47,40 @@ struct MeshDrawGroup {
     VkDescriptorSet texture_ds = VK_NULL_HANDLE;  // albedo texture descriptor (set=0)
     VkDescriptorSet specteam_ds = VK_NULL_HANDLE; // SpecTeam texture descriptor (set=2)
     VkDescriptorSet normal_ds = VK_NULL_HANDLE;   // Normal map descriptor (set=3)
-    u32 bone_base_offset = 0; // index into bone SSBO (in mat4 units)
-    u32 bones_per_instance = 0; // 0 = no skinning, else bone count
+};
+
+/// An indirect draw over GPU-culled instances: one per LOD level of each
+/// mesh in the cull scene. The culling pass writes the command's instance
+/// count and the instances themselves.
+struct CulledDrawGroup {
+    const GPUMesh* mesh = nullptr;
+    u32 first_instance = 0;          // start of the LOD's culled output range
+    VkDeviceSize command_offset = 0; // into culled_draw_buffer()
+    VkDescriptorSet texture_ds = VK_NULL_HANDLE;
+    VkDescriptorSet specteam_ds = VK_NULL_HANDLE;
+    VkDescriptorSet normal_ds = VK_NULL_HANDLE;
+};
+
+/// Buffers of one frame's culling pass, in shader binding order.
+struct CullFrameBuffers {
+    VkBuffer instances = VK_NULL_HANDLE; // binding 0: CullInstance
+    VkBuffer sets = VK_NULL_HANDLE;      // binding 1: CullLODSet
+    VkBuffer lods = VK_NULL_HANDLE;      // binding 2: CullLOD
+    VkBuffer draws = VK_NULL_HANDLE;     // binding 3: DrawIndexedIndirect
+    VkBuffer visible = VK_NULL_HANDLE;   // binding 4: CulledInstance
+    u32 version = 0; // bumped whenever a buffer is reallocated
 };
 
 /// Renders units as real SCM meshes where available, with cube fallback.
+///
+/// With GPU culling enabled, units, projectiles and props whose meshes are
+/// loaded live in a persistent CullScene: a record is added, rewritten or
+/// removed when the registry's render journal reports the entity, and a
+/// compute pass culls, picks LODs and fills indirect draws each frame.
+/// Skinned units own a fixed range of the bone SSBO (the record's
+/// bone_base), refreshed every frame. Entities whose meshes are still
+/// loading, and everything when GPU culling is off, take the per-frame CPU
+/// path and its MAX_INSTANCES cap.
 class UnitRenderer {
 public:
     /// Upload static cube mesh to GPU.
@@ -57,9 +91,10 @@ public:
     void preload_meshes(const sim::SimState& sim, MeshCache& mesh_cache,
                         lua_State* L);
 
-    /// Update per-frame instance data from sim state.
+    /// Update per-frame instance data from sim state (takes the registry's
+    /// render journal when GPU culling is on).
     /// If selected_ids is non-null, those units get a selection highlight.
-    void update(const sim::SimState& sim, MeshCache& mesh_cache,
+    void update(sim::SimState& sim, MeshCache& mesh_cache,
                 lua_State* L, TextureCache* tex_cache = nullptr,
                 const Camera* camera = nullptr,
                 const std::unordered_set<u32>* selected_ids = nullptr,
@@ -81,6 +116,8 @@ public:
     VkBuffer mesh_instance_buffer() const { return mesh_instance_buf_[fi_].buffer; }
     VkBuffer bone_ssbo_buffer(u32 fi) const { return bone_ssbo_[fi].buffer; }
     VkBuffer bone_ssbo_buffer() const { return bone_ssbo_[fi_].buffer; }
+    /// Bumped whenever frame fi's bone SSBO is reallocated.
+    u32 bone_ssbo_version(u32 fi) const { return bone_ssbo_version_[fi]; }
 
     /// Inject a single ghost mesh instance (for build preview).
     /// Call after update(). Returns true if the ghost was added.
@@ -90,6 +127,24 @@ public:
 
     void set_frame_index(u32 fi) { fi_ = fi; }
 
+    // --- GPU-culled instances ---
+    /// Route units, projectiles and props with loaded meshes through the
+    /// culling pass (needs the compute pipeline; off by default). Turns
+    /// itself off if the culling buffers cannot be allocated.
+    void set_gpu_culling(bool enabled) { gpu_culling_ = enabled; }
+    bool gpu_culling() const { return gpu_culling_; }
+
+    /// Records for the culling dispatch this frame (0 = skip the pass).
+    u32 cull_instance_count() const { return cull_params_.instance_count; }
+    const CullParams& cull_params() const { return cull_params_; }
+    CullFrameBuffers cull_buffers(u32 fi) const;
+    const std::vector<CulledDrawGroup>& culled_groups() const {
+        return culled_groups_;
+    }
+    VkBuffer culled_draw_buffer() const { return cull_bufs_[fi_].draws.buffer; }
+    VkBuffer culled_instance_buffer() const { return cull_bufs_[fi_].visible.buffer; }
+
+    /// Instances per frame on the CPU path (GPU-culled ones are uncapped).
     static constexpr u32 MAX_INSTANCES = 8192;
     static constexpr u32 MAX_BONES_PER_UNIT = 64;
     static constexpr u32 FRAMES_IN_FLIGHT = 2;
@@ -108,12 +163,73 @@ private:
     AllocatedBuffer mesh_instance_buf_[FRAMES_IN_FLIGHT] = {};
     void* mesh_instance_mapped_[FRAMES_IN_FLIGHT] = {};
 
-    // Bone SSBO (all bone matrices for all mesh instances)
+    // Bone SSBO (all bone matrices for all mesh instances), grown on demand
     AllocatedBuffer bone_ssbo_[FRAMES_IN_FLIGHT] = {};
     void* bone_ssbo_mapped_[FRAMES_IN_FLIGHT] = {};
+    VkDeviceSize bone_ssbo_size_[FRAMES_IN_FLIGHT] = {};
+    u32 bone_ssbo_version_[FRAMES_IN_FLIGHT] = {};
+
+    /// Size frame fi_'s bone SSBO for `matrices`; false if it cannot be.
+    bool ensure_bone_ssbo(u32 matrices);
 
     // Per-frame draw groups (rebuilt each frame)
     std::vector<MeshDrawGroup> mesh_groups_;
+
+    // GPU-culled instances
+    struct CullBuffers {
+        AllocatedBuffer instances{}, sets{}, lods{}, draws{}; // host-visible
+        AllocatedBuffer visible{};                            // device-local
+        void* instances_mapped = nullptr;
+        void* sets_mapped = nullptr;
+        void* lods_mapped = nullptr;
+        void* draws_mapped = nullptr;
+        VkDeviceSize instances_size = 0, sets_size = 0, lods_size = 0;
+        VkDeviceSize draws_size = 0, visible_size = 0;
+        std::vector<u32> dirty;       // records changed since this copy
+        bool dirty_all = true;        //  or all of them
+        u32 uploaded_layout = ~0u;    // CullScene::layout_revision() copied
+        u32 version = 0;
+    };
+
+    /// Bring the cull scene up to date: every entity when `all` (first
+    /// frame, new registry or a dropped journal), else the journal's.
+    void sync_cull_scene(sim::SimState& sim, MeshCache& mesh_cache,
+                         lua_State* L, bool all);
+    /// Add, rewrite or remove the record of one entity. Entities whose
+    /// meshes are still loading (or failed) go to pending_ instead.
+    void sync_entity(u32 id, const sim::SimState& sim, MeshCache& mesh_cache,
+                     lua_State* L);
+    void drop_record(u32 id);
+    /// Copy the skinned units' bone matrices into this frame's SSBO.
+    void write_cull_bones(const sim::SimState& sim);
+    /// Size this frame's cull buffers and copy what changed into them.
+    /// False if a buffer could not be allocated.
+    bool upload_cull_scene();
+    void reset_cull_scene();
+
+    u32 alloc_bones(u32 count);
+    void release_bones(u32 base, u32 count);
+
+    bool gpu_culling_ = false;
+    VmaAllocator allocator_ = VK_NULL_HANDLE;
+    CullScene cull_scene_;
+    const sim::EntityRegistry* cull_registry_ = nullptr; // mirrored by the scene
+    std::unordered_map<std::string, u32> cull_set_index_; // mesh key -> set
+    std::vector<const GPUMesh*> cull_meshes_; // per LOD level of the scene
+    std::vector<u32> cull_lod_set_;           //  and the set it belongs to
+    std::unordered_map<u32, u32> cull_record_; // entity id -> record index
+    std::vector<u32> cull_owner_;              // record index -> entity id
+    std::unordered_set<u32> skinned_;          // ids of records with bones
+    std::unordered_set<u32> highlighted_;      // ids drawn as selected
+    std::unordered_set<u32> pending_;          // ids drawn on the CPU path
+    std::unordered_set<std::string> waiting_meshes_; // mesh keys still loading
+    const std::unordered_set<u32>* selected_ = nullptr; // during update()
+    std::vector<u32> changed_;                 // scratch: journal, dirty
+    u32 bone_end_ = 0;                         // bone matrices reserved
+    std::unordered_map<u32, std::vector<u32>> free_bones_; // by range size
+    CullBuffers cull_bufs_[FRAMES_IN_FLIGHT] = {};
+    CullParams cull_params_{};
+    std::vector<CulledDrawGroup> culled_groups_;
 };
 
 } // namespace osc::renderer
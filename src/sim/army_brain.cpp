@@ -3,6 +3,7 @@
 #include "sim/unit.hpp"
 
 #include <algorithm>
+#include <cassert>
 
 namespace osc::sim {
 
@@ -101,36 +102,30 @@ bool ArmyBrain::is_neutral(i32 other_army) const {
 }
 
 void ArmyBrain::update_economy(const EntityRegistry& registry, f64 dt) {
-    f64 mass_income = 0.0;
-    f64 energy_income = 0.0;
-    f64 mass_consumption = 0.0;
-    f64 energy_consumption = 0.0;
-    f64 total_storage_mass = 200.0;    // base storage
-    f64 total_storage_energy = 200.0;
-
-    registry.for_each([&](const Entity& e) {
-        if (e.army() != index_ || e.destroyed() || !e.is_unit()) return;
-        const auto& unit = static_cast<const Unit&>(e);
-        const auto& econ = unit.economy();
-
-        if (econ.production_active) {
-            mass_income += econ.production_mass;
-            energy_income += econ.production_energy;
-        }
-
-        if (econ.consumption_active) {
-            mass_consumption += econ.consumption_mass;
-            energy_consumption += econ.consumption_energy;
-        }
-
-        if (econ.maintenance_active && econ.energy_maintenance_override >= 0.0) {
-            energy_consumption += econ.energy_maintenance_override;
-        }
-
-        // Storage contribution always counted
-        total_storage_mass += econ.storage_mass;
-        total_storage_energy += econ.storage_energy;
-    });
+    // Running totals kept by the registry's ledger; units post deltas when
+    // their economy, army or destroyed flag changes
+    const EconomyFlow& totals = registry.economy_ledger().totals(index_);
+
+#ifndef NDEBUG
+    // Cross-check against the full per-unit sum the ledger replaces. Both
+    // sides add the same fixed-point values, so any mismatch is a write
+    // that bypassed Unit::edit_economy().
+    {
+        EconomyFlow full;
+        registry.for_each([&](const Entity& e) {
+            if (e.army() == index_ && !e.destroyed()) full += e.economy_flow();
+        });
+        assert(full == totals && "economy ledger out of sync; flush_economy() missed?");
+    }
+#endif
+
+    f64 mass_income = EconomyFlow::to_f64(totals.mass_income);
+    f64 energy_income = EconomyFlow::to_f64(totals.energy_income);
+    f64 mass_consumption = EconomyFlow::to_f64(totals.mass_requested);
+    f64 energy_consumption = EconomyFlow::to_f64(totals.energy_requested);
+    constexpr f64 BASE_STORAGE = 200.0;
+    f64 total_storage_mass = BASE_STORAGE + EconomyFlow::to_f64(totals.mass_storage);
+    f64 total_storage_energy = BASE_STORAGE + EconomyFlow::to_f64(totals.energy_storage);
 
     economy_.mass.income = mass_income;
     economy_.energy.income = energy_income;
@@ -84,7 +84,8 @@ public:
     f64 get_economy_usage(const std::string& resource_type) const;
     f64 get_economy_trend(const std::string& resource_type) const;
 
-    /// Per-tick economy update: sum unit production/consumption, update stored.
+    /// Per-tick economy update: resolve storage and efficiency from the
+    /// army's ledger totals. Call registry.flush_economy() first.
     void update_economy(const EntityRegistry& registry, f64 dt);
     f64 mass_efficiency() const { return mass_efficiency_; }
     f64 energy_efficiency() const { return energy_efficiency_; }
@@ -0,0 +1,153 @@
+#include "sim/category_index.hpp"
+#include "sim/entity.hpp"
+#include "sim/entity_registry.hpp"
+
+#include <algorithm>
+
+namespace osc::sim {
+
+namespace {
+
+constexpr u32 MAX_STACK = 64;
+
+} // namespace
+
+// --- CategoryExpr ---
+
+CategoryExpr CategoryExpr::all() {
+    CategoryExpr e;
+    e.push_op(Op::All);
+    return e;
+}
+
+void CategoryExpr::push_name(const std::string& name) {
+    if (name == "ALLUNITS") {
+        push_op(Op::All);
+        return;
+    }
+    auto it = std::find(names_.begin(), names_.end(), name);
+    u32 index = static_cast<u32>(it - names_.begin());
+    if (it == names_.end()) names_.push_back(name);
+    program_.push_back({Op::Name, index});
+    key_ += name;
+    key_ += ';';
+}
+
+void CategoryExpr::push_op(Op op) {
+    program_.push_back({op, 0});
+    switch (op) {
+        case Op::Name: break;
+        case Op::All: key_ += "*;"; break;
+        case Op::None: key_ += "!;"; break;
+        case Op::Union: key_ += "+;"; break;
+        case Op::Intersection: key_ += "&;"; break;
+        case Op::Difference: key_ += "-;"; break;
+    }
+}
+
+bool CategoryExpr::matches(const CategorySet& cats) const {
+    bool stack[MAX_STACK];
+    u32 top = 0;
+    for (const auto& step : program_) {
+        switch (step.op) {
+            case Op::Name:
+                if (top == MAX_STACK) return false;
+                stack[top++] = cats.count(names_[step.name]) > 0;
+                break;
+            case Op::All:
+            case Op::None:
+                if (top == MAX_STACK) return false;
+                stack[top++] = step.op == Op::All;
+                break;
+            case Op::Union:
+            case Op::Intersection:
+            case Op::Difference: {
+                if (top < 2) return false;
+                bool r = stack[--top];
+                bool l = stack[top - 1];
+                stack[top - 1] = step.op == Op::Union        ? (l || r)
+                                 : step.op == Op::Intersection ? (l && r)
+                                                               : (l && !r);
+                break;
+            }
+        }
+    }
+    return top == 1 && stack[0];
+}
+
+// --- CategoryIndex ---
+
+bool CategoryIndex::member(const Entity* e, i32 army, const CategoryExpr& expr) {
+    if (!e || !e->is_unit() || e->destroyed() || e->army() != army) return false;
+    const CategorySet* cats = e->category_set();
+    return cats && expr.matches(*cats);
+}
+
+const std::vector<u32>& CategoryIndex::members(const EntityRegistry& registry,
+                                               i32 army,
+                                               const CategoryExpr& expr) {
+    stats_.queries++;
+    flush(registry);
+
+    std::string key = std::to_string(army);
+    key += '|';
+    key += expr.key();
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        if (entries_.size() >= MAX_ENTRIES) evict_least_recent();
+        it = entries_.emplace(std::move(key), nullptr).first;
+    }
+    auto& slot = it->second;
+    if (!slot) {
+        slot = std::make_unique<Entry>(Entry{army, expr, {}});
+        registry.for_each([&](const Entity& e) {
+            if (member(&e, army, expr)) slot->ids.push_back(e.entity_id());
+        });
+        std::sort(slot->ids.begin(), slot->ids.end());
+        stats_.fills++;
+    }
+    slot->last_query = stats_.queries;
+    return slot->ids;
+}
+
+void CategoryIndex::evict_least_recent() {
+    // Linear, but only on a fill, which scans the whole registry anyway
+    auto oldest = std::min_element(
+        entries_.begin(), entries_.end(), [](const auto& a, const auto& b) {
+            return a.second->last_query < b.second->last_query;
+        });
+    if (oldest == entries_.end()) return;
+    entries_.erase(oldest);
+    stats_.evictions++;
+}
+
+void CategoryIndex::notify(u32 entity_id) {
+    if (!entries_.empty()) dirty_.push_back(entity_id);
+}
+
+void CategoryIndex::flush(const EntityRegistry& registry) {
+    if (dirty_.empty()) return;
+    std::sort(dirty_.begin(), dirty_.end());
+    dirty_.erase(std::unique(dirty_.begin(), dirty_.end()), dirty_.end());
+    for (u32 id : dirty_) {
+        const Entity* e = registry.find(id);
+        for (auto& [key, entry] : entries_) {
+            (void)key;
+            auto& ids = entry->ids;
+            auto it = std::lower_bound(ids.begin(), ids.end(), id);
+            bool listed = it != ids.end() && *it == id;
+            bool wanted = member(e, entry->army, entry->expr);
+            if (wanted && !listed) ids.insert(it, id);
+            else if (!wanted && listed) ids.erase(it);
+        }
+        stats_.updates += entries_.size();
+    }
+    dirty_.clear();
+}
+
+void CategoryIndex::clear() {
+    entries_.clear();
+    dirty_.clear();
+}
+
+} // namespace osc::sim
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace osc::sim {
+
+class Entity;
+class EntityRegistry;
+
+using CategorySet = std::unordered_set<std::string>;
+
+/// A category expression (the Lua category tree: names joined by union,
+/// intersection and difference) compiled to a postfix program.
+///
+/// `key` is a canonical text of the program, so two Lua trees with the
+/// same shape share one key however they were built.
+class CategoryExpr {
+public:
+    enum class Op : u8 { Name, All, None, Union, Intersection, Difference };
+
+    /// Matches every unit (the ALLUNITS category).
+    static CategoryExpr all();
+
+    void push_name(const std::string& name);
+    void push_op(Op op);
+
+    bool matches(const CategorySet& cats) const;
+    const std::string& key() const { return key_; }
+    bool empty() const { return program_.empty(); }
+
+private:
+    struct Step {
+        Op op;
+        u32 name; ///< index into names_ for Op::Name
+    };
+    std::vector<Step> program_;
+    std::vector<std::string> names_;
+    std::string key_;
+};
+
+/// Units matching a category expression, per army, kept current.
+///
+/// An entry for (army, expression) is filled by one registry scan on its
+/// first query. After that the registry queues every unit whose membership
+/// may have changed (creation, death, capture, category change, removal)
+/// and the queue is applied at the start of the next query, so a repeat
+/// query returns the stored id list. Ids are kept ascending, so results
+/// do not depend on registry iteration order.
+///
+/// Every queued unit is re-tested against every entry, and AI scripts
+/// build ad-hoc expressions, so the entry count is capped: creating an
+/// entry past MAX_ENTRIES evicts the least recently queried one. An
+/// evicted expression is refilled by a scan if it is queried again.
+class CategoryIndex {
+public:
+    static constexpr size_t MAX_ENTRIES = 256;
+
+    /// Units of `army` matching `expr`, ascending by entity id. Destroyed
+    /// units are never members. The reference is valid until the next
+    /// members() or clear() call.
+    const std::vector<u32>& members(const EntityRegistry& registry, i32 army,
+                                    const CategoryExpr& expr);
+
+    /// Queue a unit whose membership may have changed. Nothing is queued
+    /// while no entry exists.
+    void notify(u32 entity_id);
+
+    /// Drop every entry (and the queue).
+    void clear();
+
+    size_t entry_count() const { return entries_.size(); }
+
+    struct Stats {
+        u64 queries = 0;
+        u64 fills = 0;   ///< entries built by a registry scan
+        u64 updates = 0; ///< queued units re-evaluated against an entry
+        u64 evictions = 0; ///< entries dropped to stay under MAX_ENTRIES
+    };
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Entry {
+        i32 army;
+        CategoryExpr expr;
+        std::vector<u32> ids;
+        u64 last_query = 0; ///< stats_.queries when last asked for
+    };
+
+    void flush(const EntityRegistry& registry);
+    void evict_least_recent();
+    static bool member(const Entity* e, i32 army, const CategoryExpr& expr);
+
+    std::unordered_map<std::string, std::unique_ptr<Entry>> entries_;
+    std::vector<u32> dirty_;
+    Stats stats_;
+};
+
+} // namespace osc::sim
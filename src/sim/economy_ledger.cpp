@@ -0,0 +1,39 @@
+#include "sim/economy_ledger.hpp"
+
+namespace osc::sim {
+
+void EconomyLedger::post(u32 entity_id, i32 army, const EconomyFlow& flow) {
+    auto it = posted_.find(entity_id);
+    if (it != posted_.end()) {
+        if (it->second.army == army && it->second.flow == flow) return;
+        if (it->second.army >= 0) totals_[it->second.army] -= it->second.flow;
+    }
+
+    if (army < 0 || flow.empty()) {
+        if (it != posted_.end()) posted_.erase(it);
+        return;
+    }
+    if (static_cast<size_t>(army) >= totals_.size()) totals_.resize(army + 1);
+    totals_[army] += flow;
+    if (it != posted_.end())
+        it->second = {army, flow};
+    else
+        posted_.emplace(entity_id, Posted{army, flow});
+}
+
+void EconomyLedger::retract(u32 entity_id) {
+    post(entity_id, -1, {});
+}
+
+const EconomyFlow& EconomyLedger::totals(i32 army) const {
+    static const EconomyFlow none{};
+    if (army < 0 || static_cast<size_t>(army) >= totals_.size()) return none;
+    return totals_[army];
+}
+
+void EconomyLedger::clear() {
+    posted_.clear();
+    totals_.clear();
+}
+
+} // namespace osc::sim
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+namespace osc::sim {
+
+/// Per-second resource flows in fixed point (2^-24 resolution). Integer
+/// sums are exact, so posting and retracting the same contribution always
+/// cancels and a running total equals the sum of the live contributions no
+/// matter how many changes it has absorbed.
+struct EconomyFlow {
+    static constexpr f64 ONE = 16777216.0; // 2^24
+
+    i64 mass_income = 0;
+    i64 energy_income = 0;
+    i64 mass_requested = 0;
+    i64 energy_requested = 0;
+    i64 mass_storage = 0;
+    i64 energy_storage = 0;
+
+    static i64 to_fixed(f64 v) { return std::llround(v * ONE); }
+    static f64 to_f64(i64 v) { return static_cast<f64>(v) / ONE; }
+
+    bool empty() const { return *this == EconomyFlow{}; }
+    bool operator==(const EconomyFlow&) const = default;
+
+    EconomyFlow& operator+=(const EconomyFlow& o) {
+        mass_income += o.mass_income;
+        energy_income += o.energy_income;
+        mass_requested += o.mass_requested;
+        energy_requested += o.energy_requested;
+        mass_storage += o.mass_storage;
+        energy_storage += o.energy_storage;
+        return *this;
+    }
+    EconomyFlow& operator-=(const EconomyFlow& o) {
+        mass_income -= o.mass_income;
+        energy_income -= o.energy_income;
+        mass_requested -= o.mass_requested;
+        energy_requested -= o.energy_requested;
+        mass_storage -= o.mass_storage;
+        energy_storage -= o.energy_storage;
+        return *this;
+    }
+};
+
+/// Running economy totals per army. Each entity's last posted contribution
+/// is remembered, so a change posts only the difference and the per-tick
+/// economy step reads totals instead of re-summing every unit.
+class EconomyLedger {
+public:
+    /// Replace the contribution of `entity_id` with `flow` on `army` (the
+    /// army may differ from the previous post, e.g. after a capture).
+    void post(u32 entity_id, i32 army, const EconomyFlow& flow);
+
+    /// Drop the contribution of `entity_id`, if any.
+    void retract(u32 entity_id);
+
+    /// Totals of one army (all zero for an army with no contributions).
+    const EconomyFlow& totals(i32 army) const;
+
+    /// Entities currently contributing.
+    size_t contributor_count() const { return posted_.size(); }
+
+    void clear();
+
+private:
+    struct Posted {
+        i32 army = -1;
+        EconomyFlow flow;
+    };
+    std::unordered_map<u32, Posted> posted_;
+    std::vector<EconomyFlow> totals_; // indexed by army
+};
+
+} // namespace osc::sim
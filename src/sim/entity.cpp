@@ -5,7 +5,34 @@ namespace osc::sim {
 
 void Entity::set_position(const Vector3& p) {
     position_ = p;
+    render_changed();
     if (registry_) registry_->notify_position_changed(*this);
 }
 
+void Entity::set_army(i32 a) {
+    army_ = a;
+    render_changed();
+    if (registry_) registry_->notify_state_changed(*this);
+}
+
+void Entity::set_fraction_complete(f32 f) {
+    // Only finished vs. under construction changes how the entity is drawn
+    bool was_complete = fraction_complete_ >= 1.0f;
+    fraction_complete_ = f;
+    if ((f >= 1.0f) != was_complete) render_changed();
+}
+
+void Entity::mark_destroyed() {
+    destroyed_ = true;
+    if (registry_) {
+        registry_->notify_state_changed(*this);
+        registry_->notify_render_changed(*this);
+    }
+}
+
+void Entity::render_changed() {
+    render_version_++;
+    if (registry_) registry_->notify_render_changed(*this);
+}
+
 } // namespace osc::sim
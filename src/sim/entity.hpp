@@ -1,8 +1,10 @@
 #pragma once
 
 #include "core/types.hpp"
+#include "sim/entity_registry.hpp" // SpatialSlot, LEVEL_COUNT
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <string>
 #include <vector>
@@ -118,7 +120,6 @@ struct ChildAttachment {
 };
 
 struct BoneData; // forward decl
-class EntityRegistry; // forward decl for grid auto-notify
 
 class Entity {
 public:
@@ -129,13 +130,13 @@ public:
     void set_entity_id(u32 id) { entity_id_ = id; }
 
     i32 army() const { return army_; }
-    void set_army(i32 a) { army_ = a; }
+    void set_army(i32 a); // implemented in entity.cpp (updates spatial index)
 
     const Vector3& position() const { return position_; }
     void set_position(const Vector3& p); // implemented in entity.cpp (auto-notifies spatial grid)
 
     const Quaternion& orientation() const { return orientation_; }
-    void set_orientation(const Quaternion& o) { orientation_ = o; }
+    void set_orientation(const Quaternion& o) { orientation_ = o; render_changed(); }
 
     f32 health() const { return health_; }
     void set_health(f32 h) { health_ = std::max(0.0f, h); }
@@ -147,10 +148,10 @@ public:
     void set_regen_rate(f32 r) { regen_rate_ = r; }
 
     f32 fraction_complete() const { return fraction_complete_; }
-    void set_fraction_complete(f32 f) { fraction_complete_ = f; }
+    void set_fraction_complete(f32 f); // implemented in entity.cpp (render state at 1.0)
 
     bool destroyed() const { return destroyed_; }
-    void mark_destroyed() { destroyed_ = true; }
+    void mark_destroyed(); // implemented in entity.cpp (updates spatial index)
 
     const std::string& blueprint_id() const { return blueprint_id_; }
     void set_blueprint_id(const std::string& id) { blueprint_id_ = id; }
@@ -176,7 +177,10 @@ public:
     f32 scale_x() const { return scale_x_; }
     f32 scale_y() const { return scale_y_; }
     f32 scale_z() const { return scale_z_; }
-    void set_scale(f32 sx, f32 sy, f32 sz) { scale_x_ = sx; scale_y_ = sy; scale_z_ = sz; }
+    void set_scale(f32 sx, f32 sy, f32 sz) {
+        scale_x_ = sx; scale_y_ = sy; scale_z_ = sz;
+        render_changed();
+    }
 
     // Visibility
     VizMode viz_allies() const { return viz_allies_; }
@@ -194,11 +198,21 @@ public:
 
     // Mesh override (runtime mesh switching via SetMesh)
     const std::string& mesh_override() const { return mesh_override_; }
-    void set_mesh_override(const std::string& path) { mesh_override_ = path; }
+    void set_mesh_override(const std::string& path) { mesh_override_ = path; render_changed(); }
 
     // Wreckage flag (set by SetMaxReclaimValues to visually distinguish wrecks)
     bool is_wreckage() const { return is_wreckage_; }
-    void set_is_wreckage(bool b) { is_wreckage_ = b; }
+    void set_is_wreckage(bool b) { is_wreckage_ = b; render_changed(); }
+
+    /// Bumped by every change to what the renderer caches per entity:
+    /// position, orientation, scale, mesh override, army, wreckage tint and
+    /// whether it is finished.
+    u32 render_version() const { return render_version_; }
+
+    /// Bump render_version() and queue the entity in its registry's render
+    /// journal. The setters above call this; so does anything else that
+    /// changes how the entity is drawn (e.g. a unit's skeleton).
+    void render_changed(); // implemented in entity.cpp
 
     // Selection
     bool unselectable() const { return unselectable_; }
@@ -229,11 +243,36 @@ public:
             children_.end());
     }
 
-    // Spatial grid cell tracking (managed by EntityRegistry)
-    i32 grid_cell_x() const { return grid_cell_x_; }
-    i32 grid_cell_z() const { return grid_cell_z_; }
-    void set_grid_cell(i32 cx, i32 cz) { grid_cell_x_ = cx; grid_cell_z_ = cz; }
+    // Spatial index tracking (managed by EntityRegistry)
+    SpatialSlot& spatial_slot(u32 level) { return spatial_slots_[level]; }
+    bool in_static_layer() const { return in_static_layer_; }
+    void set_in_static_layer(bool s) { in_static_layer_ = s; }
+    /// Index in the registry's pending-move list (or its projectile list for
+    /// projectiles); EntityRegistry::NO_MOVE_INDEX when in neither.
+    u32 move_index() const { return move_index_; }
+    void set_move_index(u32 i) { move_index_ = i; }
     void set_registry(EntityRegistry* r) { registry_ = r; }
+    EntityRegistry* registry() const { return registry_; }
+
+    // Economy ledger tracking (managed by EntityRegistry)
+    /// This entity's contribution to its army's economy; only units have one.
+    virtual EconomyFlow economy_flow() const { return {}; }
+    /// Queued in the registry's economy flush list.
+    bool economy_dirty() const { return economy_dirty_; }
+    void set_economy_dirty(bool d) { economy_dirty_ = d; }
+
+    // Render journal tracking (managed by EntityRegistry)
+    /// Queued in the registry's render journal.
+    bool render_queued() const { return render_queued_; }
+    void set_render_queued(bool q) { render_queued_ = q; }
+
+    /// Category names for the registry's category index; only units have
+    /// them.
+    virtual const CategorySet* category_set() const { return nullptr; }
+
+    /// Entities that never move after placement (props, structures) are
+    /// indexed in the registry's static layer.
+    virtual bool is_static() const { return false; }
 
     virtual bool is_unit() const { return false; }
     virtual bool is_projectile() const { return false; }
@@ -280,14 +319,18 @@ private:
     std::string mesh_override_;
     bool unselectable_ = false;
     bool is_wreckage_ = false;
+    u32 render_version_ = 0;
     u32 parent_entity_id_ = 0;
     i32 parent_bone_ = -1;
     i32 attached_bone_ = -1;
     Vector3 parent_offset_;
     std::vector<ChildAttachment> children_;
-    i32 grid_cell_x_ = -1; // spatial grid cell, -1 = not in grid
-    i32 grid_cell_z_ = -1;
+    std::array<SpatialSlot, EntityRegistry::LEVEL_COUNT> spatial_slots_;
+    bool in_static_layer_ = false;
+    u32 move_index_ = EntityRegistry::NO_MOVE_INDEX;
     EntityRegistry* registry_ = nullptr; // back-pointer for auto grid update
+    bool economy_dirty_ = false;
+    bool render_queued_ = false;
     // CollisionBeam fields
     bool is_collision_beam_ = false;
     bool beam_enabled_ = false;
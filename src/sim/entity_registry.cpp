@@ -1,7 +1,9 @@
 #include "sim/entity_registry.hpp"
 #include "sim/entity.hpp"
+#include "core/profiler.hpp"
 
 #include <cmath>
+#include <cstring>
 #include <spdlog/spdlog.h>
 
 namespace osc::sim {
@@ -13,27 +15,23 @@ u32 EntityRegistry::register_entity(std::unique_ptr<Entity> entity) {
     u32 id = next_id_++;
     entity->set_entity_id(id);
     entity->set_registry(this);
+    auto* e = entity.get();
     entities_[id] = std::move(entity);
 
-    if (grid_initialized_) {
-        auto* e = entities_[id].get();
-        i32 cx, cz;
-        world_to_cell(e->position().x, e->position().z, cx, cz);
-        grid_insert(id, cx, cz);
-        e->set_grid_cell(cx, cz);
-    }
-
+    if (grid_initialized_) grid_insert(*e);
+    notify_economy_changed(*e);
+    if (e->is_unit()) category_index_.notify(id);
+    notify_render_changed(*e);
     return id;
 }
 
 void EntityRegistry::unregister_entity(u32 id) {
     auto it = entities_.find(id);
     if (it != entities_.end()) {
-        if (grid_initialized_) {
-            i32 cx = it->second->grid_cell_x();
-            i32 cz = it->second->grid_cell_z();
-            if (cx >= 0) grid_remove(id, cx, cz);
-        }
+        if (grid_initialized_) grid_remove(*it->second);
+        economy_ledger_.retract(id);
+        if (it->second->is_unit()) category_index_.notify(id);
+        if (!it->second->render_queued()) render_journal_.push_back(id);
         it->second->set_registry(nullptr);
         entities_.erase(it);
     }
@@ -44,146 +42,361 @@ Entity* EntityRegistry::find(u32 id) const {
     return it != entities_.end() ? it->second.get() : nullptr;
 }
 
-// --- Spatial hash grid ---
+// --- Spatial index: cell storage ---
+
+u32 EntityRegistry::Cell::push(u32 id, f32 x, f32 z, i32 army, u8 kind,
+                               Entity* owner) {
+    if (size_ == capacity_) {
+        // Capacity stays a multiple of 4 so the owner column is 8-aligned
+        u32 cap = capacity_ ? capacity_ * 2 : 4;
+        auto block = std::make_unique<u8[]>(25 * static_cast<size_t>(cap));
+        auto* dst = block.get();
+        if (size_ > 0) {
+            std::memcpy(dst, col(0), 4 * size_);
+            std::memcpy(dst + 4 * cap, col(1), 4 * size_);
+            std::memcpy(dst + 8 * cap, col(2), 4 * size_);
+            std::memcpy(dst + 12 * cap, col(3), 4 * size_);
+            std::memcpy(dst + 16 * cap, col(4), 8 * size_);
+            std::memcpy(dst + 24 * cap, col(6), size_);
+        }
+        block_ = std::move(block);
+        capacity_ = cap;
+    }
+    u32 slot = size_++;
+    reinterpret_cast<u32*>(col(0))[slot] = id;
+    set_pos(slot, x, z);
+    set_state(slot, army, kind);
+    reinterpret_cast<Entity**>(col(4))[slot] = owner;
+    return slot;
+}
+
+Entity* EntityRegistry::Cell::erase(u32 slot) {
+    u32 last = --size_;
+    if (slot == last) return nullptr;
+    reinterpret_cast<u32*>(col(0))[slot] = ids()[last];
+    set_pos(slot, xs()[last], zs()[last]);
+    set_state(slot, armies()[last], kinds()[last]);
+    Entity* moved = owners()[last];
+    reinterpret_cast<Entity**>(col(4))[slot] = moved;
+    return moved;
+}
+
+// --- Spatial index ---
 
 void EntityRegistry::init_spatial_grid(u32 map_width, u32 map_height) {
-    // Reset all entity grid cells so stale coordinates are not reused on re-init
-    for (const auto& [id, e] : entities_)
-        e->set_grid_cell(-1, -1);
-    grid_cells_.clear();
-
-    grid_width_ = (map_width + CELL_SIZE - 1) / CELL_SIZE;
-    grid_height_ = (map_height + CELL_SIZE - 1) / CELL_SIZE;
-    if (grid_width_ == 0) grid_width_ = 1;
-    if (grid_height_ == 0) grid_height_ = 1;
-    grid_cells_.resize(static_cast<size_t>(grid_width_) * grid_height_);
+    // Reset all entity slots so stale coordinates are not reused on re-init
+    for (const auto& [id, e] : entities_) {
+        for (u32 l = 0; l < LEVEL_COUNT; ++l)
+            e->spatial_slot(l) = SpatialSlot{};
+    }
+    for (auto& layer : levels_) {
+        for (u32 l = 0; l < LEVEL_COUNT; ++l) {
+            auto& level = layer[l];
+            level.cell_size = LEVEL_CELL_SIZE[l];
+            level.width = std::max(1u, (map_width + level.cell_size - 1) / level.cell_size);
+            level.height = std::max(1u, (map_height + level.cell_size - 1) / level.cell_size);
+            level.cells.clear();
+            level.cells.resize(static_cast<size_t>(level.width) * level.height);
+        }
+    }
+    for (auto* e : dirty_) e->set_move_index(NO_MOVE_INDEX);
+    for (auto* e : projectiles_) e->set_move_index(NO_MOVE_INDEX);
+    dirty_.clear();
+    projectiles_.clear();
     grid_initialized_ = true;
+    static_count_ = 0;
 
     // Retroactively insert all existing entities (e.g. props created before grid init)
-    for (const auto& [id, e] : entities_) {
-        i32 cx, cz;
-        world_to_cell(e->position().x, e->position().z, cx, cz);
-        grid_insert(id, cx, cz);
-        e->set_grid_cell(cx, cz);
-    }
+    for (const auto& [id, e] : entities_) grid_insert(*e);
 
-    spdlog::info("Spatial hash grid: {}x{} cells (cell_size={}u, {} entities indexed)",
-                 grid_width_, grid_height_, CELL_SIZE, entities_.size());
+    spdlog::info("Spatial index: {} levels ({}..{}u cells, {}x{} at {}u), "
+                 "{} entities indexed ({} static)",
+                 LEVEL_COUNT, LEVEL_CELL_SIZE.front(), LEVEL_CELL_SIZE.back(),
+                 grid_width(), grid_height(), CELL_SIZE, entities_.size(),
+                 static_count_);
 }
 
-void EntityRegistry::world_to_cell(f32 wx, f32 wz, i32& cx, i32& cz) const {
-    cx = static_cast<i32>(std::floor(wx / static_cast<f32>(CELL_SIZE)));
-    cz = static_cast<i32>(std::floor(wz / static_cast<f32>(CELL_SIZE)));
-    cx = std::clamp(cx, 0, static_cast<i32>(grid_width_) - 1);
-    cz = std::clamp(cz, 0, static_cast<i32>(grid_height_) - 1);
+u8 EntityRegistry::kind_bits(const Entity& e) {
+    u8 k = e.is_unit()         ? spatial_kind::UNIT
+         : e.is_projectile()   ? spatial_kind::PROJECTILE
+         : e.is_prop()         ? spatial_kind::PROP
+         : e.is_shield()       ? spatial_kind::SHIELD
+                               : spatial_kind::OTHER;
+    if (e.destroyed()) k |= spatial_kind::DESTROYED;
+    return k;
 }
 
-size_t EntityRegistry::cell_index(i32 cx, i32 cz) const {
-    return static_cast<size_t>(cz) * grid_width_ + static_cast<size_t>(cx);
+u32 EntityRegistry::level_for_radius(f32 radius) {
+    for (u32 l = 0; l + 1 < LEVEL_COUNT; ++l) {
+        if (radius <= 2.0f * static_cast<f32>(LEVEL_CELL_SIZE[l])) return l;
+    }
+    return LEVEL_COUNT - 1;
 }
 
-void EntityRegistry::grid_insert(u32 entity_id, i32 cx, i32 cz) {
-    grid_cells_[cell_index(cx, cz)].push_back(entity_id);
+u32 EntityRegistry::cell_of(const Level& level, f32 wx, f32 wz) const {
+    f32 inv = 1.0f / static_cast<f32>(level.cell_size);
+    i32 cx = static_cast<i32>(std::floor(wx * inv));
+    i32 cz = static_cast<i32>(std::floor(wz * inv));
+    cx = std::clamp(cx, 0, static_cast<i32>(level.width) - 1);
+    cz = std::clamp(cz, 0, static_cast<i32>(level.height) - 1);
+    return static_cast<u32>(cz) * level.width + static_cast<u32>(cx);
 }
 
-void EntityRegistry::grid_remove(u32 entity_id, i32 cx, i32 cz) {
-    auto& cell = grid_cells_[cell_index(cx, cz)];
-    auto it = std::find(cell.begin(), cell.end(), entity_id);
-    if (it != cell.end()) {
-        *it = cell.back(); // swap-and-pop for O(1) removal
-        cell.pop_back();
+void EntityRegistry::grid_insert(Entity& e) {
+    bool is_static = e.is_static();
+    e.set_in_static_layer(is_static);
+    if (is_static) static_count_++;
+
+    auto& layer = levels_[is_static ? 1 : 0];
+    f32 x = e.position().x, z = e.position().z;
+    u8 kind = kind_bits(e);
+    if (kind & spatial_kind::PROJECTILE) {
+        e.set_move_index(static_cast<u32>(projectiles_.size()));
+        projectiles_.push_back(&e);
+    }
+    for (u32 l = 0; l < LEVEL_COUNT; ++l) {
+        auto& ref = e.spatial_slot(l);
+        ref.cell = cell_of(layer[l], x, z);
+        ref.slot = layer[l].cells[ref.cell].push(e.entity_id(), x, z,
+                                                 e.army(), kind, &e);
+    }
+}
+
+void EntityRegistry::list_remove(std::vector<Entity*>& list, Entity& e) {
+    u32 i = e.move_index();
+    list[i] = list.back();
+    list[i]->set_move_index(i);
+    list.pop_back();
+    e.set_move_index(NO_MOVE_INDEX);
+}
+
+void EntityRegistry::grid_remove(Entity& e) {
+    if (e.move_index() != NO_MOVE_INDEX)
+        list_remove(e.is_projectile() ? projectiles_ : dirty_, e);
+    auto& layer = levels_[e.in_static_layer() ? 1 : 0];
+    for (u32 l = 0; l < LEVEL_COUNT; ++l) {
+        auto& ref = e.spatial_slot(l);
+        if (ref.cell == SpatialSlot::NO_CELL) return; // never indexed
+        // Swap-and-pop for O(1) removal; fix up the entry that moved
+        if (Entity* moved = layer[l].cells[ref.cell].erase(ref.slot))
+            moved->spatial_slot(l).slot = ref.slot;
+        ref = SpatialSlot{};
     }
+    if (e.in_static_layer()) static_count_--;
 }
 
 void EntityRegistry::notify_position_changed(Entity& entity) {
     if (!grid_initialized_) return;
+    if (batching_) {
+        // Projectiles are always refreshed at end_move_batch()
+        if (entity.move_index() == NO_MOVE_INDEX &&
+            entity.spatial_slot(0).cell != SpatialSlot::NO_CELL) {
+            entity.set_move_index(static_cast<u32>(dirty_.size()));
+            dirty_.push_back(&entity);
+        }
+        return;
+    }
+    rebucket(entity);
+}
 
-    i32 new_cx, new_cz;
-    world_to_cell(entity.position().x, entity.position().z, new_cx, new_cz);
+void EntityRegistry::begin_move_batch() {
+    batching_ = grid_initialized_;
+}
 
-    i32 old_cx = entity.grid_cell_x();
-    i32 old_cz = entity.grid_cell_z();
+void EntityRegistry::end_move_batch() {
+    if (!batching_) return;
+    PROFILE_ZONE("EntityRegistry::end_move_batch");
+    batching_ = false;
 
-    if (old_cx == new_cx && old_cz == new_cz) return; // same cell, no update
+    // Sort by target cell so consecutive moves touch the same cell columns
+    pending_.clear();
+    pending_.reserve(dirty_.size());
+    for (auto* e : dirty_) {
+        e->set_move_index(NO_MOVE_INDEX);
+        const auto& level = levels_[e->in_static_layer() ? 1 : 0][0];
+        u64 cell = cell_of(level, e->position().x, e->position().z);
+        pending_.push_back({cell << 32 | e->entity_id(), e});
+    }
+    dirty_.clear();
+    std::sort(pending_.begin(), pending_.end(),
+              [](const PendingMove& a, const PendingMove& b) {
+                  return a.key < b.key;
+              });
+    for (const auto& m : pending_) rebucket(*m.entity);
 
-    if (old_cx >= 0) grid_remove(entity.entity_id(), old_cx, old_cz);
-    grid_insert(entity.entity_id(), new_cx, new_cz);
-    entity.set_grid_cell(new_cx, new_cz);
+    for (auto* e : projectiles_) rebucket(*e);
 }
 
-std::vector<u32> EntityRegistry::collect_in_radius(f32 x, f32 z,
-                                                    f32 radius) const {
+void EntityRegistry::rebucket(Entity& entity) {
+    auto& layer = levels_[entity.in_static_layer() ? 1 : 0];
+    f32 x = entity.position().x, z = entity.position().z;
+
+    for (u32 l = 0; l < LEVEL_COUNT; ++l) {
+        auto& ref = entity.spatial_slot(l);
+        if (ref.cell == SpatialSlot::NO_CELL) return; // not indexed
+        auto& level = layer[l];
+        u32 cell = cell_of(level, x, z);
+        if (cell == ref.cell) {
+            level.cells[cell].set_pos(ref.slot, x, z); // same cell: update in place
+            continue;
+        }
+        auto& old_cell = level.cells[ref.cell];
+        i32 army = old_cell.armies()[ref.slot];
+        u8 kind = old_cell.kinds()[ref.slot];
+        if (Entity* moved = old_cell.erase(ref.slot))
+            moved->spatial_slot(l).slot = ref.slot;
+        ref.cell = cell;
+        ref.slot = level.cells[cell].push(entity.entity_id(), x, z, army, kind,
+                                          &entity);
+    }
+}
+
+void EntityRegistry::notify_state_changed(Entity& entity) {
+    notify_economy_changed(entity);
+    if (entity.is_unit()) category_index_.notify(entity.entity_id());
+    if (!grid_initialized_) return;
+    auto& layer = levels_[entity.in_static_layer() ? 1 : 0];
+    u8 kind = kind_bits(entity);
+    for (u32 l = 0; l < LEVEL_COUNT; ++l) {
+        const auto& ref = entity.spatial_slot(l);
+        if (ref.cell == SpatialSlot::NO_CELL) return;
+        layer[l].cells[ref.cell].set_state(ref.slot, entity.army(), kind);
+    }
+}
+
+template <typename Accept>
+void EntityRegistry::collect(const Level& level, f32 x0, f32 z0, f32 x1,
+                             f32 z1, const SpatialFilter& filter,
+                             Accept&& accept, std::vector<u32>& out) const {
+    u32 c0 = cell_of(level, x0, z0);
+    u32 c1 = cell_of(level, x1, z1);
+    u32 cx_min = c0 % level.width, cz_min = c0 / level.width;
+    u32 cx_max = c1 % level.width, cz_max = c1 / level.width;
+
+    for (u32 cz = cz_min; cz <= cz_max; ++cz) {
+        for (u32 cx = cx_min; cx <= cx_max; ++cx) {
+            const auto& cell = level.cells[cz * level.width + cx];
+            u32 n = cell.size();
+            if (n == 0) continue;
+            const u32* ids = cell.ids();
+            const f32* xs = cell.xs();
+            const f32* zs = cell.zs();
+            const u8* ks = cell.kinds();
+            const i32* armies = cell.armies();
+            for (u32 i = 0; i < n; ++i) {
+                if (!matches(filter, ks[i], armies[i])) continue;
+                if (accept(xs[i], zs[i])) out.push_back(ids[i]);
+            }
+        }
+    }
+}
+
+std::vector<u32> EntityRegistry::collect_in_radius(
+    f32 x, f32 z, f32 radius, const SpatialFilter& filter) const {
     std::vector<u32> result;
     f32 r2 = radius * radius;
+    auto in_circle = [x, z, r2](f32 ex, f32 ez) {
+        f32 dx = ex - x;
+        f32 dz = ez - z;
+        return dx * dx + dz * dz <= r2;
+    };
 
     if (!grid_initialized_) {
         // Fallback to O(N) scan
         for (const auto& [id, e] : entities_) {
-            if (e->destroyed()) continue;
-            f32 dx = e->position().x - x;
-            f32 dz = e->position().z - z;
-            if (dx * dx + dz * dz <= r2) result.push_back(id);
+            if (!matches(filter, kind_bits(*e), e->army())) continue;
+            if (in_circle(e->position().x, e->position().z)) result.push_back(id);
         }
         return result;
     }
 
-    // Compute cell range covering the bounding box of the circle
-    i32 cx_min, cz_min, cx_max, cz_max;
-    world_to_cell(x - radius, z - radius, cx_min, cz_min);
-    world_to_cell(x + radius, z + radius, cx_max, cz_max);
-
-    for (i32 cz = cz_min; cz <= cz_max; ++cz) {
-        for (i32 cx = cx_min; cx <= cx_max; ++cx) {
-            const auto& cell = grid_cells_[cell_index(cx, cz)];
-            for (u32 id : cell) {
-                auto* e = find(id);
-                if (!e || e->destroyed()) continue;
-                f32 dx = e->position().x - x;
-                f32 dz = e->position().z - z;
-                if (dx * dx + dz * dz <= r2)
-                    result.push_back(id);
-            }
-        }
+    u32 l = level_for_radius(radius);
+    for (const auto& layer : levels_) {
+        collect(layer[l], x - radius, z - radius, x + radius, z + radius,
+                filter, in_circle, result);
     }
     return result;
 }
 
 std::vector<u32> EntityRegistry::collect_in_rect(f32 x0, f32 z0,
-                                                  f32 x1, f32 z1) const {
+                                                 f32 x1, f32 z1,
+                                                 const SpatialFilter& filter) const {
     std::vector<u32> result;
     if (x0 > x1) std::swap(x0, x1);
     if (z0 > z1) std::swap(z0, z1);
+    auto in_rect = [=](f32 ex, f32 ez) {
+        return ex >= x0 && ex <= x1 && ez >= z0 && ez <= z1;
+    };
 
     if (!grid_initialized_) {
         // Fallback to O(N) scan
         for (const auto& [id, e] : entities_) {
-            if (e->destroyed()) continue;
-            f32 ex = e->position().x;
-            f32 ez = e->position().z;
-            if (ex >= x0 && ex <= x1 && ez >= z0 && ez <= z1)
-                result.push_back(id);
+            if (!matches(filter, kind_bits(*e), e->army())) continue;
+            if (in_rect(e->position().x, e->position().z)) result.push_back(id);
         }
         return result;
     }
 
-    i32 cx_min, cz_min, cx_max, cz_max;
-    world_to_cell(x0, z0, cx_min, cz_min);
-    world_to_cell(x1, z1, cx_max, cz_max);
-
-    for (i32 cz = cz_min; cz <= cz_max; ++cz) {
-        for (i32 cx = cx_min; cx <= cx_max; ++cx) {
-            const auto& cell = grid_cells_[cell_index(cx, cz)];
-            for (u32 id : cell) {
-                auto* e = find(id);
-                if (!e || e->destroyed()) continue;
-                f32 ex = e->position().x;
-                f32 ez = e->position().z;
-                if (ex >= x0 && ex <= x1 && ez >= z0 && ez <= z1)
-                    result.push_back(id);
-            }
-        }
+    u32 l = level_for_radius(0.5f * std::max(x1 - x0, z1 - z0));
+    for (const auto& layer : levels_) {
+        collect(layer[l], x0, z0, x1, z1, filter, in_rect, result);
     }
     return result;
 }
 
+// --- Economy ledger ---
+
+void EntityRegistry::notify_economy_changed(Entity& entity) {
+    if (!entity.is_unit() || entity.economy_dirty()) return;
+    entity.set_economy_dirty(true);
+    economy_dirty_.push_back(entity.entity_id());
+}
+
+void EntityRegistry::flush_economy() {
+    for (u32 id : economy_dirty_) {
+        Entity* e = find(id);
+        if (!e) continue; // unregistered: already retracted
+        e->set_economy_dirty(false);
+        if (e->destroyed())
+            economy_ledger_.retract(id);
+        else
+            economy_ledger_.post(id, e->army(), e->economy_flow());
+    }
+    economy_dirty_.clear();
+}
+
+// --- Render journal ---
+
+void EntityRegistry::notify_render_changed(Entity& entity) {
+    if (entity.render_queued()) return;
+    // Nobody is taking the journal (headless, or the renderer is off):
+    // drop it rather than grow with every entity ever removed
+    if (render_journal_.size() >= entities_.size() + 4096) {
+        for (u32 queued : render_journal_) {
+            if (Entity* e = find(queued)) e->set_render_queued(false);
+        }
+        render_journal_.clear();
+        render_journal_lost_ = true;
+    }
+    entity.set_render_queued(true);
+    render_journal_.push_back(entity.entity_id());
+}
+
+bool EntityRegistry::take_render_changes(std::vector<u32>& out) {
+    for (u32 id : render_journal_) {
+        if (Entity* e = find(id)) e->set_render_queued(false);
+        out.push_back(id);
+    }
+    render_journal_.clear();
+    bool complete = !render_journal_lost_;
+    render_journal_lost_ = false;
+    return complete;
+}
+
+// --- Category index ---
+
+void EntityRegistry::notify_categories_changed(Entity& entity) {
+    category_index_.notify(entity.entity_id());
+}
+
 } // namespace osc::sim
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "core/types.hpp"
+#include "sim/category_index.hpp"
+#include "sim/economy_ledger.hpp"
 
 #include <algorithm>
+#include <array>
+#include <climits>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -11,9 +15,44 @@ namespace osc::sim {
 
 class Entity;
 
+/// Kind bits stored alongside each entity in the spatial index, so queries
+/// can filter without touching Entity objects.
+namespace spatial_kind {
+constexpr u8 UNIT = 1 << 0;
+constexpr u8 PROJECTILE = 1 << 1;
+constexpr u8 PROP = 1 << 2;
+constexpr u8 SHIELD = 1 << 3;
+constexpr u8 OTHER = 1 << 4;
+constexpr u8 ANY = UNIT | PROJECTILE | PROP | SHIELD | OTHER;
+constexpr u8 DESTROYED = 1 << 7; // never matched by queries
+} // namespace spatial_kind
+
+/// Query filter evaluated on the index columns (no Entity access).
+struct SpatialFilter {
+    static constexpr i32 ANY_ARMY = INT32_MIN;
+    u8 kinds = spatial_kind::ANY; ///< mask of spatial_kind bits
+    i32 only_army = ANY_ARMY;     ///< keep only this army
+    i32 exclude_army = ANY_ARMY;  ///< drop this army
+};
+
+/// Per-entity position in one level of the spatial index (managed by
+/// EntityRegistry; cell == NO_CELL when not indexed).
+struct SpatialSlot {
+    static constexpr u32 NO_CELL = ~0u;
+    u32 cell = NO_CELL;
+    u32 slot = 0;
+};
+
 class EntityRegistry {
 public:
-    static constexpr u32 CELL_SIZE = 32;
+    /// Spatial index levels, finest first. Queries use the finest level
+    /// whose cells are at least half the query radius, so air separation
+    /// (r=8) scans 8-unit cells and radar-range queries (r=300+) scan a few
+    /// 128-unit cells instead of hundreds of small ones.
+    static constexpr u32 LEVEL_COUNT = 3;
+    static constexpr std::array<u32, LEVEL_COUNT> LEVEL_CELL_SIZE = {8, 32, 128};
+    static constexpr u32 CELL_SIZE = LEVEL_CELL_SIZE[1]; // grid_width/height
+    static constexpr u32 NO_MOVE_INDEX = ~0u;
 
     EntityRegistry();
     ~EntityRegistry();
@@ -34,14 +73,66 @@ public:
     /// If not called, collect_in_radius/collect_in_rect fall back to O(N) scan.
     void init_spatial_grid(u32 map_width, u32 map_height);
 
-    /// Notify the registry that an entity's position has changed.
+    /// Notify the registry that an entity's position has changed. Inside a
+    /// move batch this only marks the entity dirty.
     void notify_position_changed(Entity& entity);
 
+    /// Start deferring spatial updates. Until end_move_batch(), queries see
+    /// the positions indexed when the batch began, however often entities
+    /// move in between, so every entity updated in the phase sees the same
+    /// world.
+    void begin_move_batch();
+
+    /// Re-bucket every entity that moved since begin_move_batch() in one
+    /// pass (sorted by target cell), plus all projectiles, which move every
+    /// tick and are refreshed in bulk without per-write dirty tracking.
+    void end_move_batch();
+    bool in_move_batch() const { return batching_; }
+
+    /// Notify the registry that an entity's army or destroyed flag changed.
+    void notify_state_changed(Entity& entity);
+
+    /// Queue a unit whose economy contribution may have changed. Cheap and
+    /// idempotent; the ledger sees the change at the next flush_economy().
+    void notify_economy_changed(Entity& entity);
+
+    /// Post the queued units' contributions to the ledger. Costs one
+    /// ledger update per changed unit, independent of the unit count.
+    void flush_economy();
+
+    /// Per-army economy totals (current as of the last flush_economy()).
+    const EconomyLedger& economy_ledger() const { return economy_ledger_; }
+
+    /// Queue a unit whose category set changed for the category index.
+    /// Creation, removal, death and capture are queued by the registry.
+    void notify_categories_changed(Entity& entity);
+
+    /// Queue an entity whose render state changed (see
+    /// Entity::render_changed()). Registration and removal are queued by
+    /// the registry. Cheap and idempotent until the next take.
+    void notify_render_changed(Entity& entity);
+
+    /// Move the ids queued since the last call into `out` (appended, each
+    /// once; removed entities' ids included, so look them up). The journal
+    /// is bounded: when nobody takes it for long, it is dropped and this
+    /// returns false, and the caller must resync from for_each(). The
+    /// first call also returns false.
+    bool take_render_changes(std::vector<u32>& out);
+
+    /// Units of `army` matching `expr`, ascending by id (see CategoryIndex).
+    const std::vector<u32>& category_members(i32 army, const CategoryExpr& expr) {
+        return category_index_.members(*this, army, expr);
+    }
+    const CategoryIndex& category_index() const { return category_index_; }
+
     /// Collect entity IDs within radius of a point (2D distance, ignoring Y).
-    std::vector<u32> collect_in_radius(f32 x, f32 z, f32 radius) const;
+    /// Destroyed entities never match.
+    std::vector<u32> collect_in_radius(f32 x, f32 z, f32 radius,
+                                       const SpatialFilter& filter = {}) const;
 
     /// Collect entity IDs within an axis-aligned rectangle (2D, ignoring Y).
-    std::vector<u32> collect_in_rect(f32 x0, f32 z0, f32 x1, f32 z1) const;
+    std::vector<u32> collect_in_rect(f32 x0, f32 z0, f32 x1, f32 z1,
+                                     const SpatialFilter& filter = {}) const;
 
     /// Iterate all entities.
     template <typename F>
@@ -50,24 +141,106 @@ public:
             fn(*e);
     }
 
-    u32 grid_width() const { return grid_width_; }
-    u32 grid_height() const { return grid_height_; }
+    u32 grid_width() const { return levels_[0][1].width; }
+    u32 grid_height() const { return levels_[0][1].height; }
     bool grid_initialized() const { return grid_initialized_; }
 
+    /// Entities in the static layer (props, structures). They are indexed
+    /// once at registration and never re-bucketed by unit movement.
+    size_t static_count() const { return static_count_; }
+
 private:
+    /// One grid cell: entries stored column-wise in a single allocation so
+    /// a radius test streams only the x/z columns.
+    class Cell {
+    public:
+        u32 size() const { return size_; }
+        const u32* ids() const { return reinterpret_cast<const u32*>(block_.get()); }
+        const f32* xs() const { return reinterpret_cast<const f32*>(col(1)); }
+        const f32* zs() const { return reinterpret_cast<const f32*>(col(2)); }
+        const i32* armies() const { return reinterpret_cast<const i32*>(col(3)); }
+        Entity* const* owners() const { return reinterpret_cast<Entity* const*>(col(4)); }
+        const u8* kinds() const { return col(6); }
+
+        /// Append an entry; returns its slot.
+        u32 push(u32 id, f32 x, f32 z, i32 army, u8 kind, Entity* owner);
+        /// Swap-remove `slot`; returns the entity moved into it (or null).
+        Entity* erase(u32 slot);
+        void set_pos(u32 slot, f32 x, f32 z) { mxs()[slot] = x; mzs()[slot] = z; }
+        void set_state(u32 slot, i32 army, u8 kind) {
+            reinterpret_cast<i32*>(col(3))[slot] = army;
+            col(6)[slot] = kind;
+        }
+
+    private:
+        // Column byte offsets for capacity c: id, x, z, army (4 bytes each),
+        // owner (8 bytes, two column units), kind (1 byte)
+        const u8* col(u32 i) const { return block_.get() + 4 * i * capacity_; }
+        u8* col(u32 i) { return block_.get() + 4 * i * capacity_; }
+        f32* mxs() { return reinterpret_cast<f32*>(col(1)); }
+        f32* mzs() { return reinterpret_cast<f32*>(col(2)); }
+
+        std::unique_ptr<u8[]> block_;
+        u32 size_ = 0;
+        u32 capacity_ = 0;
+    };
+
+    struct Level {
+        u32 cell_size = 0;
+        u32 width = 0;
+        u32 height = 0;
+        std::vector<Cell> cells;
+    };
+
+    /// levels_[layer][level]: layer 0 = dynamic, 1 = static
+    using Layer = std::array<Level, LEVEL_COUNT>;
+    std::array<Layer, 2> levels_;
+
     std::unordered_map<u32, std::unique_ptr<Entity>> entities_;
     u32 next_id_ = 1;
-
-    // Spatial hash grid
     bool grid_initialized_ = false;
-    u32 grid_width_ = 0;
-    u32 grid_height_ = 0;
-    std::vector<std::vector<u32>> grid_cells_;
-
-    void world_to_cell(f32 wx, f32 wz, i32& cx, i32& cz) const;
-    size_t cell_index(i32 cx, i32 cz) const;
-    void grid_insert(u32 id, i32 cx, i32 cz);
-    void grid_remove(u32 id, i32 cx, i32 cz);
+    size_t static_count_ = 0;
+
+    // Move batching: entities written since begin_move_batch(), and every
+    // indexed projectile (re-bucketed wholesale at end_move_batch()).
+    bool batching_ = false;
+    std::vector<Entity*> dirty_;
+    std::vector<Entity*> projectiles_;
+    struct PendingMove {
+        u64 key; // target cell << 32 | entity id, for a deterministic order
+        Entity* entity;
+    };
+    std::vector<PendingMove> pending_;
+
+    // Economy: running per-army totals and the ids of units queued since
+    // the last flush (ids, so units unregistered meanwhile are skipped).
+    EconomyLedger economy_ledger_;
+    std::vector<u32> economy_dirty_;
+
+    // Render journal: ids queued since the last take_render_changes(), and
+    // whether it was dropped meanwhile (or never taken)
+    std::vector<u32> render_journal_;
+    bool render_journal_lost_ = true;
+
+    // Category membership per (army, expression)
+    CategoryIndex category_index_;
+
+    static u8 kind_bits(const Entity& e);
+    static u32 level_for_radius(f32 radius);
+    u32 cell_of(const Level& level, f32 wx, f32 wz) const;
+    void grid_insert(Entity& e);
+    void grid_remove(Entity& e);
+    void rebucket(Entity& e);
+    static void list_remove(std::vector<Entity*>& list, Entity& e);
+    template <typename Accept>
+    void collect(const Level& level, f32 x0, f32 z0, f32 x1, f32 z1,
+                 const SpatialFilter& filter, Accept&& accept,
+                 std::vector<u32>& out) const;
+    static bool matches(const SpatialFilter& f, u8 kind, i32 army) {
+        return (kind & f.kinds) && !(kind & spatial_kind::DESTROYED) &&
+               (f.only_army == SpatialFilter::ANY_ARMY || army == f.only_army) &&
+               army != f.exclude_army;
+    }
 };
 
 } // namespace osc::sim
@@ -0,0 +1,383 @@
+#include "sim/formation.hpp"
+#include "sim/unit.hpp"
+#include "map/pathfinder.hpp"
+#include "map/pathfinding_grid.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <spdlog/spdlog.h>
+
+namespace osc::sim {
+
+namespace {
+
+constexpr u32 LINE_WIDTH = 12;         // slots per rank before a Line wraps
+constexpr u32 MAX_OPTIMAL_ASSIGN = 256; // above this, assign by sorted order
+constexpr f32 FORMATION_GAP = 1.0f;    // clearance between footprints
+
+/// Lay rows of the given sizes front to back, each centred on x = 0.
+std::vector<Vector3> rows_layout(const std::vector<u32>& row_sizes,
+                                 f32 spacing) {
+    std::vector<Vector3> out;
+    for (size_t r = 0; r < row_sizes.size(); ++r) {
+        f32 half = 0.5f * static_cast<f32>(row_sizes[r] - 1);
+        for (u32 j = 0; j < row_sizes[r]; ++j)
+            out.push_back({(static_cast<f32>(j) - half) * spacing, 0,
+                           -static_cast<f32>(r) * spacing});
+    }
+    return out;
+}
+
+std::vector<u32> fixed_rows(u32 count, u32 width) {
+    std::vector<u32> rows;
+    for (u32 left = count; left > 0; left -= std::min(left, width))
+        rows.push_back(std::min(left, width));
+    return rows;
+}
+
+/// Greedy fallback for very large groups: match members and slots in the
+/// same front-to-back, left-to-right order.
+std::vector<u32> assign_sorted(const std::vector<Vector3>& members,
+                               const std::vector<Vector3>& slots) {
+    auto order = [](const std::vector<Vector3>& pts) {
+        std::vector<u32> idx(pts.size());
+        std::iota(idx.begin(), idx.end(), 0u);
+        std::stable_sort(idx.begin(), idx.end(), [&](u32 a, u32 b) {
+            if (pts[a].z != pts[b].z) return pts[a].z > pts[b].z;
+            return pts[a].x < pts[b].x;
+        });
+        return idx;
+    };
+    auto m = order(members);
+    auto s = order(slots);
+    std::vector<u32> result(members.size());
+    for (size_t i = 0; i < m.size(); ++i) result[m[i]] = s[i];
+    return result;
+}
+
+/// Where a unit will stand when an order appended to its queue starts: the
+/// target of the last queued order that moves it, else where it is now.
+/// Orders that end somewhere unpredictable (attack, guard, ...) are skipped;
+/// join_formation_leg() covers the difference when the move starts.
+Vector3 queue_end_position(const Unit& u) {
+    const auto& queue = u.command_queue();
+    for (size_t i = queue.size(); i-- > 0;) {
+        const auto& cmd = queue[i];
+        switch (cmd.type) {
+        case CommandType::Move:
+        case CommandType::Patrol:
+        case CommandType::Teleport:
+        case CommandType::Ferry:
+        case CommandType::TransportUnload:
+            return {cmd.target_pos.x, 0, cmd.target_pos.z};
+        default:
+            break;
+        }
+    }
+    return u.position();
+}
+
+} // namespace
+
+FormationShape parse_formation(std::string_view name) {
+    if (name == "GrowthFormation") return FormationShape::Growth;
+    if (name == "AttackFormation") return FormationShape::Attack;
+    if (name == "LineFormation") return FormationShape::Line;
+    if (name == "WedgeFormation") return FormationShape::Wedge;
+    return FormationShape::None;
+}
+
+std::vector<Vector3> formation_slots(FormationShape shape, u32 count,
+                                     f32 spacing) {
+    if (count == 0) return {};
+    std::vector<u32> rows;
+    switch (shape) {
+    case FormationShape::None:
+        return std::vector<Vector3>(count);
+    case FormationShape::Line:
+        rows = fixed_rows(count, LINE_WIDTH);
+        break;
+    case FormationShape::Wedge:
+        // Rank r holds 2r + 1 slots behind the point
+        for (u32 r = 0, left = count; left > 0; ++r) {
+            rows.push_back(std::min(left, 2 * r + 1));
+            left -= rows.back();
+        }
+        break;
+    case FormationShape::Growth:
+        // Square block
+        rows = fixed_rows(count, static_cast<u32>(std::ceil(
+                                     std::sqrt(static_cast<f32>(count)))));
+        break;
+    case FormationShape::Attack:
+        // Wide front, half as deep
+        rows = fixed_rows(count, static_cast<u32>(std::ceil(
+                                     std::sqrt(2.0f * static_cast<f32>(count)))));
+        break;
+    }
+    auto slots = rows_layout(rows, spacing);
+
+    // Centre on the slot centroid so the group centroid lands on the goal
+    f32 cx = 0, cz = 0;
+    for (const auto& s : slots) { cx += s.x; cz += s.z; }
+    cx /= static_cast<f32>(count);
+    cz /= static_cast<f32>(count);
+    for (auto& s : slots) { s.x -= cx; s.z -= cz; }
+    return slots;
+}
+
+std::vector<u32> assign_slots(const std::vector<Vector3>& members,
+                              const std::vector<Vector3>& slots) {
+    const size_t n = members.size();
+    if (n == 0) return {};
+    if (n > MAX_OPTIMAL_ASSIGN) return assign_sorted(members, slots);
+
+    std::vector<f64> cost(n * n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            f64 dx = members[i].x - slots[j].x;
+            f64 dz = members[i].z - slots[j].z;
+            cost[i * n + j] = std::sqrt(dx * dx + dz * dz);
+        }
+    }
+
+    // Hungarian algorithm with potentials (1-based; column 0 is a sentinel)
+    constexpr f64 INF = std::numeric_limits<f64>::infinity();
+    std::vector<f64> u(n + 1, 0), v(n + 1, 0), minv(n + 1);
+    std::vector<size_t> p(n + 1, 0), way(n + 1, 0);
+    std::vector<char> used(n + 1);
+    for (size_t i = 1; i <= n; ++i) {
+        p[0] = i;
+        size_t j0 = 0;
+        std::fill(minv.begin(), minv.end(), INF);
+        std::fill(used.begin(), used.end(), 0);
+        do {
+            used[j0] = 1;
+            size_t i0 = p[j0], j1 = 0;
+            f64 delta = INF;
+            for (size_t j = 1; j <= n; ++j) {
+                if (used[j]) continue;
+                f64 cur = cost[(i0 - 1) * n + (j - 1)] - u[i0] - v[j];
+                if (cur < minv[j]) { minv[j] = cur; way[j] = j0; }
+                if (minv[j] < delta) { delta = minv[j]; j1 = j; }
+            }
+            for (size_t j = 0; j <= n; ++j) {
+                if (used[j]) { u[p[j]] += delta; v[j] -= delta; }
+                else minv[j] -= delta;
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+        do {
+            size_t j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    std::vector<u32> result(n);
+    for (size_t j = 1; j <= n; ++j)
+        result[p[j] - 1] = static_cast<u32>(j - 1);
+    return result;
+}
+
+FormationPlan plan_formation(const std::vector<Vector3>& positions,
+                             const Vector3& goal, FormationShape shape,
+                             f32 spacing, std::optional<f32> facing) {
+    FormationPlan plan;
+    const u32 n = static_cast<u32>(positions.size());
+    if (n == 0) return plan;
+
+    Vector3 c;
+    for (const auto& p : positions) { c.x += p.x; c.z += p.z; }
+    c.x /= static_cast<f32>(n);
+    c.z /= static_cast<f32>(n);
+
+    if (facing) {
+        plan.facing = *facing;
+    } else {
+        f32 dx = goal.x - c.x, dz = goal.z - c.z;
+        plan.facing = (dx * dx + dz * dz > 1e-6f) ? std::atan2(dx, dz) : 0.0f;
+    }
+
+    auto slots = formation_slots(shape, n, spacing);
+    std::vector<Vector3> local(n);
+    for (u32 i = 0; i < n; ++i) {
+        local[i] = rotate_heading({positions[i].x - c.x, 0, positions[i].z - c.z},
+                                  -plan.facing);
+    }
+    auto assignment = assign_slots(local, slots);
+    plan.slots.resize(n);
+    for (u32 i = 0; i < n; ++i) plan.slots[i] = slots[assignment[i]];
+    return plan;
+}
+
+u32 issue_formation_move(CommandStore& store, const std::vector<Unit*>& units,
+                         const Vector3& goal, FormationShape shape,
+                         u32 command_id, bool clear_existing,
+                         const map::Pathfinder* pathfinder,
+                         const map::PathfindingGrid* grid,
+                         std::optional<f32> facing) {
+    UnitCommand cmd;
+    cmd.type = CommandType::Move;
+    cmd.target_pos = goal;
+    cmd.command_id = command_id;
+    CommandGroup group(store, cmd);
+
+    // Split by movement layer; each layer gets its own formation and path.
+    // An appended order is planned from where each member's queue leaves
+    // it, not from where it stands now.
+    struct LayerGroup {
+        std::string layer;
+        std::vector<Unit*> members;
+        std::vector<Vector3> positions; // planned start per member
+    };
+    std::vector<LayerGroup> by_layer;
+    u32 ordered = 0;
+    for (auto* u : units) {
+        if (!u || u->destroyed()) continue;
+        Vector3 start = clear_existing ? u->position() : queue_end_position(*u);
+        u->push_command(group, clear_existing);
+        ordered++;
+        if (u->is_air_unit() || shape == FormationShape::None ||
+            u->effective_speed() <= 0)
+            continue;
+        auto it = std::find_if(by_layer.begin(), by_layer.end(),
+                               [&](const auto& g) { return g.layer == u->layer(); });
+        if (it == by_layer.end()) {
+            by_layer.push_back({u->layer(), {}, {}});
+            it = by_layer.end() - 1;
+        }
+        it->members.push_back(u);
+        it->positions.push_back(start);
+    }
+
+    for (const auto& [layer, members, positions] : by_layer) {
+        f32 spacing = 2.0f, speed = std::numeric_limits<f32>::max();
+        f32 draft = 0;
+        bool amphibious = true;
+        for (auto* u : members) {
+            spacing = std::max(spacing, std::max(u->footprint_size_x(),
+                                                 u->footprint_size_z()) +
+                                            FORMATION_GAP);
+            speed = std::min(speed, u->effective_speed());
+            draft = std::max(draft, u->naval_draft());
+            amphibious = amphibious && (u->is_amphibious() || u->is_hover());
+        }
+        auto plan = plan_formation(positions, goal, shape, spacing, facing);
+
+        // One path for the whole group, from its planned centroid. A centroid in a
+        // lake or on a cliff between sub-groups starts from the nearest
+        // passable cell instead.
+        Vector3 c;
+        for (const auto& p : positions) { c.x += p.x; c.z += p.z; }
+        c.x /= static_cast<f32>(positions.size());
+        c.z /= static_cast<f32>(positions.size());
+        if (!pathfinder ||
+            !pathfinder->snap_to_passable(c.x, c.z, layer, draft, amphibious)) {
+            continue; // members path to the goal on their own
+        }
+        auto shared = pathfinder->find_path(c.x, c.z, goal.x, goal.z, layer,
+                                            draft, amphibious);
+        if (!shared.found) {
+            spdlog::debug("Formation move: no group path for {} {} units",
+                          members.size(), layer);
+            continue;
+        }
+        std::vector<Vector3> path = std::move(shared.waypoints);
+        if (path.size() > 1) path.erase(path.begin()); // centroid's own cell
+
+        auto passable = [&](const Vector3& p) {
+            if (!grid) return true;
+            u32 gx, gz;
+            grid->world_to_grid(p.x, p.z, gx, gz);
+            return grid->is_passable_for(gx, gz, layer, draft, amphibious);
+        };
+        auto clear = [&](const Vector3& a, const Vector3& b) {
+            return pathfinder->segment_passable(a.x, a.z, b.x, b.z, layer,
+                                                draft, amphibious);
+        };
+        // Each member follows the shared path shifted by its slot, rotated to
+        // the heading of the leg it is on. Legs are line-walked: a blocked
+        // slot leg falls back to the centre line, and one blocked even then
+        // (the join from the member's start, or a return from a shifted
+        // slot) is pathed within the per-tick search budget. Once the budget
+        // runs out, the remaining members follow the bare centre line and
+        // are joined to it when their move starts. A member with no route
+        // paths to the goal itself.
+        u32 fallback = 0, centre_line = 0;
+        for (size_t m = 0; m < members.size(); ++m) {
+            std::vector<Vector3> own;
+            own.reserve(path.size() + 1);
+            Vector3 at = positions[m];
+            at.y = 0;
+            Vector3 prev = c;
+            bool routed = true, throttled = false;
+            for (size_t w = 0; w < path.size() && routed; ++w) {
+                bool last = w + 1 == path.size();
+                f32 dx = path[w].x - prev.x, dz = path[w].z - prev.z;
+                f32 heading = last ? plan.facing
+                            : (dx * dx + dz * dz > 1e-6f ? std::atan2(dx, dz)
+                                                         : plan.facing);
+                auto off = rotate_heading(plan.slots[m], heading);
+                Vector3 slot{path[w].x + off.x, 0, path[w].z + off.z};
+                prev = path[w];
+
+                Vector3 next = passable(slot) ? slot : path[w];
+                if (!clear(at, next) && clear(at, path[w])) next = path[w];
+                if (clear(at, next)) {
+                    own.push_back(next);
+                } else {
+                    // Route around whatever blocks the leg
+                    auto r = pathfinder->find_path(at.x, at.z, next.x, next.z,
+                                                   layer, draft, amphibious);
+                    throttled = r.throttled;
+                    routed = r.found;
+                    if (routed) {
+                        auto first = r.waypoints.begin();
+                        if (r.waypoints.size() > 1) ++first; // at's own cell
+                        own.insert(own.end(), first, r.waypoints.end());
+                    }
+                }
+                at = next;
+            }
+            if (throttled) {
+                own = path;
+                centre_line++;
+            } else if (!routed) {
+                fallback++;
+                continue;
+            }
+            members[m]->set_formation_order(command_id, speed, std::move(own));
+        }
+        if (fallback > 0)
+            spdlog::debug("Formation move: {} of {} {} units have no slot route",
+                          fallback, members.size(), layer);
+        if (centre_line > 0)
+            spdlog::debug("Formation move: search budget spent, {} of {} {} "
+                          "units follow the centre line",
+                          centre_line, members.size(), layer);
+        spdlog::debug("Formation move: {} {} units, {} waypoints, speed {:.1f}",
+                      members.size(), layer, path.size(), speed);
+    }
+    return ordered;
+}
+
+bool join_formation_leg(std::vector<Vector3>& path, const Vector3& from,
+                        const map::Pathfinder* pathfinder,
+                        const std::string& layer, f32 draft, bool amphibious) {
+    if (!pathfinder || path.empty() || layer == "Air") return true;
+    const auto& to = path.front();
+    if (pathfinder->segment_passable(from.x, from.z, to.x, to.z, layer, draft,
+                                     amphibious))
+        return true;
+    auto r = pathfinder->find_path(from.x, from.z, to.x, to.z, layer, draft,
+                                   amphibious);
+    if (r.throttled) return false;
+    // No route: walk straight, as Navigator does for an unreachable goal
+    if (r.found && r.waypoints.size() > 1)
+        path.insert(path.begin(), r.waypoints.begin(), r.waypoints.end() - 1);
+    return true;
+}
+
+} // namespace osc::sim
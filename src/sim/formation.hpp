@@ -0,0 +1,83 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "sim/entity.hpp" // Vector3
+
+#include <cmath>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace osc::map {
+class Pathfinder;
+class PathfindingGrid;
+}
+
+namespace osc::sim {
+
+class CommandStore;
+class Unit;
+
+/// Formation layouts. Names follow FA's formation strings
+/// ("GrowthFormation", "AttackFormation", ...).
+enum class FormationShape : u8 { None, Line, Wedge, Growth, Attack };
+
+/// Parse an FA formation name. Unknown names and "NoFormation" map to None.
+FormationShape parse_formation(std::string_view name);
+
+/// Slot offsets in formation space (+z toward the goal, +x to the right),
+/// centred on the origin, `spacing` apart.
+std::vector<Vector3> formation_slots(FormationShape shape, u32 count,
+                                     f32 spacing);
+
+/// Minimum-cost assignment (Hungarian, O(n^3)): result[i] is the slot for
+/// member i, minimising the total member→slot distance. Both lists must
+/// have the same length.
+std::vector<u32> assign_slots(const std::vector<Vector3>& members,
+                              const std::vector<Vector3>& slots);
+
+/// Heading convention used by the navigator: atan2(dx, dz).
+inline Vector3 rotate_heading(const Vector3& v, f32 heading) {
+    f32 s = std::sin(heading), c = std::cos(heading);
+    return {v.x * c + v.z * s, v.y, -v.x * s + v.z * c};
+}
+
+struct FormationPlan {
+    f32 facing = 0;             ///< heading of the formation at the goal
+    std::vector<Vector3> slots; ///< formation-space slot per member (input order)
+};
+
+/// Lay out `count` members around `goal`. Slots are matched to the
+/// members' current arrangement (relative to their centroid, in formation
+/// space), so the group keeps its shape instead of crossing over. The
+/// formation faces the direction of travel unless `facing` is given.
+FormationPlan plan_formation(const std::vector<Vector3>& positions,
+                             const Vector3& goal, FormationShape shape,
+                             f32 spacing, std::optional<f32> facing = {});
+
+/// Issue a formation move: one shared path from the group centroid, slot
+/// assignment, and a speed cap at the slowest member. Members are split by
+/// movement layer; air units get a plain move. All members share one queued
+/// command payload in `store` carrying `command_id`. Without
+/// `clear_existing` the move is planned from where each member's queued
+/// orders leave it. Slot legs that need a search share the pathfinder's
+/// per-tick budget; members past it follow the centre line. Returns the
+/// number of units ordered.
+u32 issue_formation_move(CommandStore& store, const std::vector<Unit*>& units,
+                         const Vector3& goal, FormationShape shape,
+                         u32 command_id, bool clear_existing,
+                         const map::Pathfinder* pathfinder,
+                         const map::PathfindingGrid* grid,
+                         std::optional<f32> facing = {});
+
+/// Prepend a route from `from` to the start of a formation leg when the
+/// straight walk there is blocked (the member's earlier orders left it
+/// elsewhere than planned). False if the search budget is spent for this
+/// tick; the caller retries next tick.
+bool join_formation_leg(std::vector<Vector3>& path, const Vector3& from,
+                        const map::Pathfinder* pathfinder,
+                        const std::string& layer, f32 draft = 0,
+                        bool amphibious = false);
+
+} // namespace osc::sim
@@ -0,0 +1,211 @@
+#include "sim/local_avoidance.hpp"
+#include "core/tracer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace osc::sim {
+
+namespace {
+
+constexpr f32 MIN_CELL = 1.0f;
+constexpr u32 MAX_THREADS = 8;
+constexpr size_t MIN_CHUNK_AGENTS = 512; // below this a hand-off costs more than it saves
+constexpr f32 STIFFNESS = 0.5f;          // resolve half the overlap per tick
+constexpr f32 IDLE_YIELD = 3.0f;         // idle agents take 3/4 of a shared push
+constexpr f32 MIN_SEPARATION_SQ = 1e-8f;
+
+} // namespace
+
+LocalAvoidance::LocalAvoidance(u32 threads) {
+    if (threads == 0)
+        threads = std::min(MAX_THREADS,
+                           std::max(1u, std::thread::hardware_concurrency()));
+    threads_ = threads;
+}
+
+LocalAvoidance::~LocalAvoidance() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& w : workers_) w.join();
+}
+
+void LocalAvoidance::worker_loop(u32 chunk) {
+    Tracer::instance().set_thread_name("avoidance worker");
+    u64 seen = 0;
+    for (;;) {
+        size_t begin, end;
+        f32 max_step;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            if (chunk >= pass_chunks_) continue;
+            begin = std::min(pass_n_, chunk * pass_per_);
+            end = std::min(pass_n_, begin + pass_per_);
+            max_step = pass_max_step_;
+        }
+
+        compute_range(begin, end, max_step);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            remaining_--;
+        }
+        done_cv_.notify_all();
+    }
+}
+
+void LocalAvoidance::compute(const AvoidanceAgents& agents, f32 max_step) {
+    const size_t n = agents.size();
+    dx_.assign(n, 0.0f);
+    dz_.assign(n, 0.0f);
+    last_chunks_ = 0;
+    if (n < 2) return;
+
+    // Grid bounds; cells at least one footprint diameter wide so every
+    // overlapping pair is in the 3x3 neighbourhood.
+    f32 min_x = agents.x[0], max_x = min_x;
+    f32 min_z = agents.z[0], max_z = min_z;
+    f32 max_r = 0;
+    for (size_t i = 0; i < n; ++i) {
+        min_x = std::min(min_x, agents.x[i]);
+        max_x = std::max(max_x, agents.x[i]);
+        min_z = std::min(min_z, agents.z[i]);
+        max_z = std::max(max_z, agents.z[i]);
+        max_r = std::max(max_r, agents.radius[i]);
+    }
+    f32 cell = std::max(MIN_CELL, 2.0f * max_r);
+    // Keep the grid proportional to the agent count when units are spread
+    // thin over a large map.
+    const size_t max_cells = std::max<size_t>(4096, 4 * n);
+    for (;;) {
+        grid_w_ = static_cast<u32>((max_x - min_x) / cell) + 1;
+        grid_h_ = static_cast<u32>((max_z - min_z) / cell) + 1;
+        if (static_cast<size_t>(grid_w_) * grid_h_ <= max_cells) break;
+        cell *= 2.0f;
+    }
+    origin_x_ = min_x;
+    origin_z_ = min_z;
+    inv_cell_ = 1.0f / cell;
+
+    // Counting sort into cell order; stable, so each cell lists its agents
+    // in input order.
+    const size_t cells = static_cast<size_t>(grid_w_) * grid_h_;
+    cell_start_.assign(cells + 1, 0);
+    agent_cell_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        u32 cx = std::min(grid_w_ - 1, static_cast<u32>((agents.x[i] - min_x) * inv_cell_));
+        u32 cz = std::min(grid_h_ - 1, static_cast<u32>((agents.z[i] - min_z) * inv_cell_));
+        agent_cell_[i] = cz * grid_w_ + cx;
+        cell_start_[agent_cell_[i] + 1]++;
+    }
+    for (size_t c = 0; c < cells; ++c) cell_start_[c + 1] += cell_start_[c];
+
+    sx_.resize(n); sz_.resize(n); sr_.resize(n);
+    slayer_.resize(n); smoving_.resize(n); sindex_.resize(n);
+    {
+        std::vector<u32> cursor(cell_start_.begin(), cell_start_.end() - 1);
+        for (size_t i = 0; i < n; ++i) {
+            u32 k = cursor[agent_cell_[i]]++;
+            sx_[k] = agents.x[i];
+            sz_[k] = agents.z[i];
+            sr_[k] = agents.radius[i];
+            slayer_[k] = agents.layer[i];
+            smoving_[k] = agents.moving[i];
+            sindex_[k] = static_cast<u32>(i);
+        }
+    }
+
+    // Corrections per agent, in contiguous chunks
+    u32 chunks = static_cast<u32>(std::min<size_t>(threads_, n / MIN_CHUNK_AGENTS));
+    if (chunks <= 1) {
+        last_chunks_ = 1;
+        compute_range(0, n, max_step);
+        return;
+    }
+    last_chunks_ = chunks;
+    if (workers_.empty()) {
+        workers_.reserve(threads_ - 1);
+        for (u32 c = 1; c < threads_; ++c)
+            workers_.emplace_back([this, c] { worker_loop(c); });
+    }
+    const size_t per = (n + chunks - 1) / chunks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pass_chunks_ = chunks;
+        pass_n_ = n;
+        pass_per_ = per;
+        pass_max_step_ = max_step;
+        remaining_ = chunks - 1;
+        generation_++;
+    }
+    work_cv_.notify_all();
+    compute_range(0, std::min(n, per), max_step);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return remaining_ == 0; });
+}
+
+void LocalAvoidance::compute_range(size_t begin, size_t end, f32 max_step) {
+    TRACE_ZONE("LocalAvoidance::compute_range");
+    for (size_t k = begin; k < end; ++k) {
+        // Walk the sorted arrays: k is a slot in cell order
+        const u32 self = sindex_[k];
+        const f32 x = sx_[k], z = sz_[k], r = sr_[k];
+        const u8 layer = slayer_[k];
+        const f32 yield_self = smoving_[k] ? 1.0f : IDLE_YIELD;
+        // Share of a pairwise push this agent takes, by the other's state
+        const f32 share[2] = {STIFFNESS * yield_self / (yield_self + IDLE_YIELD),
+                              STIFFNESS * yield_self / (yield_self + 1.0f)};
+        const u32 cell = agent_cell_[self];
+        const u32 cx = cell % grid_w_, cz = cell / grid_w_;
+
+        f32 px = 0, pz = 0;
+        const u32 x0 = cx > 0 ? cx - 1 : 0, x1 = std::min(grid_w_ - 1, cx + 1);
+        const u32 z0 = cz > 0 ? cz - 1 : 0, z1 = std::min(grid_h_ - 1, cz + 1);
+        for (u32 gz = z0; gz <= z1; ++gz) {
+            // Cells x0..x1 of a row are adjacent in the sorted arrays
+            const u32 from = cell_start_[gz * grid_w_ + x0];
+            const u32 to = cell_start_[gz * grid_w_ + x1 + 1];
+            for (u32 j = from; j < to; ++j) {
+                f32 ddx = x - sx_[j], ddz = z - sz_[j];
+                f32 reach = r + sr_[j];
+                f32 d2 = ddx * ddx + ddz * ddz;
+                if (d2 >= reach * reach || slayer_[j] != layer || j == k)
+                    continue;
+
+                f32 s = share[smoving_[j]];
+                if (d2 > MIN_SEPARATION_SQ) {
+                    // n * (reach - d) = delta * (reach / d - 1)
+                    f32 f = (reach / std::sqrt(d2) - 1.0f) * s;
+                    px += ddx * f;
+                    pz += ddz * f;
+                } else {
+                    // Stacked exactly: split along a direction fixed by the
+                    // pair, opposite for each side.
+                    u32 lo = std::min(self, sindex_[j]);
+                    f32 a = 6.2831853f * std::fmod(static_cast<f32>(lo) * 0.618034f, 1.0f);
+                    f32 f = (self < sindex_[j] ? reach : -reach) * s;
+                    px += std::cos(a) * f;
+                    pz += std::sin(a) * f;
+                }
+            }
+        }
+
+        f32 len2 = px * px + pz * pz;
+        if (len2 > max_step * max_step) {
+            f32 s = max_step / std::sqrt(len2);
+            px *= s;
+            pz *= s;
+        }
+        dx_[self] = px;
+        dz_[self] = pz;
+    }
+}
+
+} // namespace osc::sim
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace osc::sim {
+
+/// Agents for one avoidance pass, structure-of-arrays. Agent order is the
+/// caller's (the sim sorts by entity id), and it fixes the result.
+struct AvoidanceAgents {
+    std::vector<f32> x, z, radius;
+    std::vector<u8> layer;  ///< agents only push others on the same layer
+    std::vector<u8> moving; ///< idle agents give way to moving ones
+
+    size_t size() const { return x.size(); }
+    void clear() {
+        x.clear(); z.clear(); radius.clear();
+        layer.clear(); moving.clear();
+    }
+    void add(f32 ax, f32 az, f32 r, u8 l, bool m) {
+        x.push_back(ax); z.push_back(az); radius.push_back(r);
+        layer.push_back(l); moving.push_back(m ? 1 : 0);
+    }
+};
+
+/// Local collision avoidance for ground and naval units: overlapping
+/// footprints push each other apart, a little each tick.
+///
+/// Each pass bins the agents into a dense occupancy grid (one counting-sort
+/// sweep into cell-ordered SoA arrays) and computes every agent's correction
+/// from the start-of-pass positions only. Agents are split into contiguous
+/// chunks across threads; since no agent reads another's result and the
+/// neighbour order is fixed by the grid, the output is bit-identical for
+/// any thread count. Small passes run on the calling thread; the workers
+/// are started by the first pass large enough to split and then kept
+/// waiting between passes.
+class LocalAvoidance {
+public:
+    /// `threads` = 0 uses the hardware concurrency (capped at 8).
+    explicit LocalAvoidance(u32 threads = 0);
+    ~LocalAvoidance();
+
+    LocalAvoidance(const LocalAvoidance&) = delete;
+    LocalAvoidance& operator=(const LocalAvoidance&) = delete;
+
+    /// Compute a displacement per agent. Corrections are capped at
+    /// `max_step` world units.
+    void compute(const AvoidanceAgents& agents, f32 max_step);
+
+    const std::vector<f32>& dx() const { return dx_; }
+    const std::vector<f32>& dz() const { return dz_; }
+
+    u32 threads() const { return threads_; }
+    /// Chunks used by the last pass (1 when it ran serially).
+    u32 last_chunks() const { return last_chunks_; }
+    /// Worker threads started so far (0 until a pass is split).
+    u32 worker_count() const { return static_cast<u32>(workers_.size()); }
+
+private:
+    void compute_range(size_t begin, size_t end, f32 max_step);
+    void worker_loop(u32 chunk);
+
+    u32 threads_;
+    u32 last_chunks_ = 0;
+
+    // Workers for chunks 1..threads_-1; the caller runs chunk 0
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    u64 generation_ = 0;  // guarded by mutex_, bumped per split pass
+    u32 pass_chunks_ = 0; // guarded by mutex_
+    u32 remaining_ = 0;   // guarded by mutex_, chunks still running
+    size_t pass_n_ = 0, pass_per_ = 0; // guarded by mutex_
+    f32 pass_max_step_ = 0;            // guarded by mutex_
+    bool stop_ = false;   // guarded by mutex_
+
+    // Grid for the current pass
+    f32 origin_x_ = 0, origin_z_ = 0, inv_cell_ = 1;
+    u32 grid_w_ = 0, grid_h_ = 0;
+    std::vector<u32> cell_start_; ///< grid_w_ * grid_h_ + 1 offsets
+    std::vector<u32> agent_cell_;
+
+    // Agents in cell order
+    std::vector<f32> sx_, sz_, sr_;
+    std::vector<u8> slayer_, smoving_;
+    std::vector<u32> sindex_;
+
+    std::vector<f32> dx_, dz_;
+};
+
+} // namespace osc::sim
@@ -0,0 +1,278 @@
+#include "sim/lua_callbacks.hpp"
+#include "sim/entity_registry.hpp"
+#include "sim/unit.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <bit>
+
+extern "C" {
+#include <lua.h>
+#include <lauxlib.h>
+}
+
+namespace osc::sim {
+
+namespace {
+
+constexpr const char* HOOK_NAMES[UNIT_HOOK_COUNT] = {
+    "OnDamage",
+    "OnStopBeingBuilt",
+    "OnSiloBuildFinish",
+    "OnStartSacrifice",
+    "OnStopSacrifice",
+    "OnTeleportUnit",
+    "OnStartBuild",
+    "OnStopBuild",
+    "OnFailedToBuild",
+    "OnStartBeingBuilt",
+    "OnStartCapture",
+    "OnStopCapture",
+    "OnFailedCapture",
+    "OnStartBeingCaptured",
+    "OnStopBeingCaptured",
+    "OnFailedBeingCaptured",
+    "OnCaptured",
+    "OnWorkBegin",
+    "OnWorkEnd",
+    "OnWorkFail",
+    "OnTransportAttach",
+    "OnTransportDetach",
+    "OnLayerChange",
+    "OnVeteran",
+    "OnReclaimed",
+    "OnAdjacentTo",
+    "OnNotAdjacentTo",
+};
+
+// guard_newindex stores any other key without looking it up
+constexpr bool hooks_start_with_on() {
+    for (const char* name : HOOK_NAMES)
+        if (name[0] != 'O' || name[1] != 'n') return false;
+    return true;
+}
+static_assert(hooks_start_with_on(), "every unit hook name starts with On");
+
+int abs_index(lua_State* L, int idx) {
+    return (idx > 0 || idx <= LUA_REGISTRYINDEX) ? idx : lua_gettop(L) + idx + 1;
+}
+
+} // namespace
+
+const char* unit_hook_name(UnitHook hook) {
+    return HOOK_NAMES[static_cast<u32>(hook)];
+}
+
+/// Upvalue of the guard closure. Outlives the cache when a class copied
+/// the guard, so the cache clears its pointer on destruction.
+struct LuaCallbackCache::GuardBox {
+    LuaCallbackCache* cache;
+};
+
+LuaCallbackCache::LuaCallbackCache(lua_State* L, EntityRegistry& registry)
+    : L_(L), registry_(registry) {}
+
+LuaCallbackCache::~LuaCallbackCache() {
+    if (!guard_box_) return;
+    guard_box_->cache = nullptr;
+    // Take the guard back off the classes it was installed on
+    lua_rawgeti(L_, LUA_REGISTRYINDEX, guard_ref_);
+    for (const auto& [key, table] : tables_) {
+        (void)key;
+        if (!table->guarded) continue;
+        lua_rawgeti(L_, LUA_REGISTRYINDEX, table->class_ref);
+        lua_pushstring(L_, "__newindex");
+        lua_rawget(L_, -2);
+        bool ours = lua_rawequal(L_, -1, -3) != 0;
+        lua_pop(L_, 1);
+        if (ours) {
+            lua_pushstring(L_, "__newindex");
+            lua_pushnil(L_);
+            lua_rawset(L_, -3);
+        }
+        lua_pop(L_, 1);
+    }
+    lua_pop(L_, 1);
+    clear();
+    luaL_unref(L_, LUA_REGISTRYINDEX, guard_ref_);
+    luaL_unref(L_, LUA_REGISTRYINDEX, names_ref_);
+}
+
+void LuaCallbackCache::init_lua() {
+    lua_State* L = L_;
+    lua_newtable(L);
+    for (u32 i = 0; i < UNIT_HOOK_COUNT; ++i) {
+        lua_pushstring(L, HOOK_NAMES[i]);
+        lua_pushnumber(L, i + 1);
+        lua_rawset(L, -3);
+    }
+    lua_pushvalue(L, -1);
+    names_ref_ = luaL_ref(L, LUA_REGISTRYINDEX);
+
+    guard_box_ = static_cast<GuardBox*>(lua_newuserdata(L, sizeof(GuardBox)));
+    guard_box_->cache = this;
+    lua_insert(L, -2); // box, names
+    lua_pushcclosure(L, guard_newindex, 2);
+    guard_ref_ = luaL_ref(L, LUA_REGISTRYINDEX);
+}
+
+int LuaCallbackCache::guard_newindex(lua_State* L) {
+    // (t, k, v): plain assignment, plus a note when k names a hook. Scripts
+    // write many instance fields in OnCreate, so a key that cannot be a
+    // hook name goes straight to the rawset.
+    lua_settop(L, 3);
+    if (lua_type(L, 2) == LUA_TSTRING) {
+        const char* key = lua_tostring(L, 2);
+        if (key[0] == 'O' && key[1] == 'n') {
+            auto* box = static_cast<GuardBox*>(lua_touserdata(L, lua_upvalueindex(1)));
+            if (box && box->cache) {
+                lua_pushvalue(L, 2);
+                lua_rawget(L, lua_upvalueindex(2));
+                if (lua_isnumber(L, -1))
+                    box->cache->note_override(
+                        L, 1, static_cast<u32>(lua_tonumber(L, -1)) - 1);
+                lua_pop(L, 1);
+            }
+        }
+    }
+    lua_rawset(L, 1);
+    return 0;
+}
+
+void LuaCallbackCache::note_override(lua_State* L, int idx, u32 hook) {
+    // EntityId rather than _c_object: the entity may already be gone
+    lua_pushstring(L, "EntityId");
+    lua_rawget(L, idx);
+    u32 id = lua_isnumber(L, -1) ? static_cast<u32>(lua_tonumber(L, -1)) : 0;
+    lua_pop(L, 1);
+    auto* entity = id ? registry_.find(id) : nullptr;
+    if (!entity || !entity->is_unit()) return;
+    auto& binding = static_cast<Unit*>(entity)->lua_callbacks();
+    if (binding.cache == this) binding.overrides |= 1u << hook;
+}
+
+void LuaCallbackCache::bind(lua_State* L, int idx, Unit& unit,
+                            const void* lua_class) {
+    // Metatable is on top of the stack
+    if (!guard_box_) init_lua();
+    int cls = lua_gettop(L);
+    auto& binding = unit.lua_callbacks();
+
+    auto& slot = tables_[{lua_class, unit.blueprint_id()}];
+    if (!slot) {
+        slot = std::make_unique<LuaCallbackTable>();
+        auto& table = *slot;
+        table.fn_refs.fill(LUA_NOREF);
+
+        // Resolve through a bare instance of the class: same __index
+        // chain as a real unit, without its own fields
+        lua_newtable(L);
+        lua_pushvalue(L, cls);
+        lua_setmetatable(L, -2);
+        int probe = lua_gettop(L);
+        for (u32 i = 0; i < UNIT_HOOK_COUNT; ++i) {
+            lua_pushstring(L, HOOK_NAMES[i]);
+            lua_gettable(L, probe);
+            if (lua_isfunction(L, -1)) {
+                table.fn_refs[i] = luaL_ref(L, LUA_REGISTRYINDEX);
+                table.present |= 1u << i;
+            } else {
+                lua_pop(L, 1);
+            }
+        }
+        lua_pop(L, 1); // probe
+
+        lua_pushstring(L, "__newindex");
+        lua_rawget(L, cls);
+        if (lua_isnil(L, -1)) {
+            lua_pushstring(L, "__newindex");
+            lua_rawgeti(L, LUA_REGISTRYINDEX, guard_ref_);
+            lua_rawset(L, cls);
+            table.guarded = true;
+        } else {
+            lua_rawgeti(L, LUA_REGISTRYINDEX, guard_ref_);
+            table.guarded = lua_rawequal(L, -1, -2) != 0;
+            lua_pop(L, 1);
+        }
+        lua_pop(L, 1);
+
+        lua_pushvalue(L, cls);
+        table.class_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+        stats_.tables++;
+        spdlog::debug("Lua callbacks: resolved {} for {} ({} hooks{})",
+                      lua_class, unit.blueprint_id(),
+                      std::popcount(table.present),
+                      table.guarded ? "" : ", unguarded");
+    }
+
+    // Hooks the instance already defines itself
+    binding.overrides = 0;
+    for (u32 i = 0; i < UNIT_HOOK_COUNT; ++i) {
+        lua_pushstring(L, HOOK_NAMES[i]);
+        lua_rawget(L, idx);
+        if (!lua_isnil(L, -1)) binding.overrides |= 1u << i;
+        lua_pop(L, 1);
+    }
+    binding.table = slot.get();
+    binding.lua_class = lua_class;
+    binding.generation = generation_;
+}
+
+bool LuaCallbackCache::push(lua_State* L, int idx, Unit& unit, UnitHook hook) {
+    idx = abs_index(L, idx);
+    if (!enabled_ || !lua_getmetatable(L, idx)) {
+        stats_.uncached++;
+        return push_uncached(L, idx, hook);
+    }
+    const void* lua_class = lua_topointer(L, -1);
+    auto& binding = unit.lua_callbacks();
+    if (binding.generation != generation_ || binding.lua_class != lua_class)
+        bind(L, idx, unit, lua_class);
+    lua_pop(L, 1);
+
+    const u32 h = static_cast<u32>(hook);
+    const u32 bit = 1u << h;
+    const auto& table = *binding.table;
+    if ((binding.overrides & bit) || !table.guarded) {
+        stats_.uncached++;
+        return push_uncached(L, idx, hook);
+    }
+    if (!(table.present & bit)) {
+        stats_.missing++;
+        return false;
+    }
+    stats_.cached++;
+    lua_rawgeti(L, LUA_REGISTRYINDEX, table.fn_refs[h]);
+    return true;
+}
+
+bool LuaCallbackCache::push_hook(lua_State* L, int idx, Entity* entity,
+                                 UnitHook hook) {
+    if (entity && entity->is_unit()) {
+        auto* unit = static_cast<Unit*>(entity);
+        if (auto* cache = unit->lua_callbacks().cache)
+            return cache->push(L, idx, *unit, hook);
+    }
+    return push_uncached(L, idx, hook);
+}
+
+bool LuaCallbackCache::push_uncached(lua_State* L, int idx, UnitHook hook) {
+    idx = abs_index(L, idx);
+    lua_pushstring(L, unit_hook_name(hook));
+    lua_gettable(L, idx);
+    if (lua_isfunction(L, -1)) return true;
+    lua_pop(L, 1);
+    return false;
+}
+
+void LuaCallbackCache::clear() {
+    for (auto& [key, table] : tables_) {
+        (void)key;
+        for (int ref : table->fn_refs) luaL_unref(L_, LUA_REGISTRYINDEX, ref);
+        luaL_unref(L_, LUA_REGISTRYINDEX, table->class_ref);
+    }
+    tables_.clear();
+    generation_++;
+}
+
+} // namespace osc::sim
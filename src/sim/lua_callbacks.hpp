@@ -0,0 +1,146 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <array>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+struct lua_State;
+
+namespace osc::sim {
+
+class Entity;
+class EntityRegistry;
+class LuaCallbackCache;
+class Unit;
+
+/// Script hooks the engine calls on unit instances. Every unit hook the
+/// engine dispatches goes through LuaCallbackCache::push_hook.
+enum class UnitHook : u8 {
+    OnDamage,
+    OnStopBeingBuilt,
+    OnSiloBuildFinish,
+    OnStartSacrifice,
+    OnStopSacrifice,
+    OnTeleportUnit,
+    OnStartBuild,
+    OnStopBuild,
+    OnFailedToBuild,
+    OnStartBeingBuilt,
+    OnStartCapture,
+    OnStopCapture,
+    OnFailedCapture,
+    OnStartBeingCaptured,
+    OnStopBeingCaptured,
+    OnFailedBeingCaptured,
+    OnCaptured,
+    OnWorkBegin,
+    OnWorkEnd,
+    OnWorkFail,
+    OnTransportAttach,
+    OnTransportDetach,
+    OnLayerChange,
+    OnVeteran,
+    OnReclaimed,
+    OnAdjacentTo,
+    OnNotAdjacentTo,
+    Count
+};
+
+constexpr u32 UNIT_HOOK_COUNT = static_cast<u32>(UnitHook::Count);
+static_assert(UNIT_HOOK_COUNT <= 32, "hook bits must fit a u32 mask");
+
+const char* unit_hook_name(UnitHook hook);
+
+/// Hook functions of one (Lua class, blueprint) pair, resolved once
+/// through the class's __index chain.
+struct LuaCallbackTable {
+    int class_ref = -2;     ///< pins the class so its address stays unique
+    u32 present = 0;        ///< bit per UnitHook that resolved to a function
+    bool guarded = false;   ///< assignments on instances are observed
+    std::array<int, UNIT_HOOK_COUNT> fn_refs{};
+};
+
+/// A unit's link into the cache (lives in Unit).
+struct LuaCallbackBinding {
+    LuaCallbackCache* cache = nullptr;
+    const LuaCallbackTable* table = nullptr;
+    const void* lua_class = nullptr; ///< metatable `table` was resolved for
+    u32 generation = 0;
+    u32 overrides = 0;               ///< hooks assigned on the instance itself
+};
+
+/// Cached C++-to-script dispatch for unit hooks.
+///
+/// Looking a hook up by name costs a string push and a walk up the class
+/// chain on every event, even when the script never defines the hook.
+/// The cache resolves every hook once per (metatable, blueprint) into
+/// registry refs plus a presence mask, so a missing hook is one bit test
+/// and a present one is a registry index.
+///
+/// Instance overrides: the cache installs a __newindex guard on each class
+/// it resolves. A script assigning a hook on an instance (`self.OnDamage =
+/// f`) marks that unit, which then uses the name lookup for that hook.
+/// Keys that are not hook names are stored directly, but each first write
+/// of an instance field still costs a C call (see the creation benchmark).
+/// Classes with their own __newindex are not guarded and always use the
+/// name lookup. Replacing a method on the class itself after units exist
+/// is not observed; call clear() after such a change.
+class LuaCallbackCache {
+public:
+    LuaCallbackCache(lua_State* L, EntityRegistry& registry);
+    ~LuaCallbackCache();
+
+    LuaCallbackCache(const LuaCallbackCache&) = delete;
+    LuaCallbackCache& operator=(const LuaCallbackCache&) = delete;
+
+    /// Push `unit`'s function for `hook`, its Lua table being at `idx`.
+    /// Returns false and pushes nothing when the unit has no such hook.
+    bool push(lua_State* L, int idx, Unit& unit, UnitHook hook);
+
+    /// Call-site entry point: goes through the entity's cache when it is
+    /// a bound unit, through the name lookup otherwise.
+    static bool push_hook(lua_State* L, int idx, Entity* entity, UnitHook hook);
+
+    /// The uncached path: table[name] through __index, if a function.
+    static bool push_uncached(lua_State* L, int idx, UnitHook hook);
+
+    /// Drop every resolved table (bindings re-resolve on next use).
+    void clear();
+
+    /// When disabled every push takes the name lookup.
+    void set_enabled(bool enabled) { enabled_ = enabled; }
+    bool enabled() const { return enabled_; }
+
+    struct Stats {
+        u32 tables = 0;   ///< (class, blueprint) pairs resolved
+        u64 cached = 0;   ///< hooks pushed from the cache
+        u64 missing = 0;  ///< hooks skipped on the presence mask
+        u64 uncached = 0; ///< pushes that fell back to the name lookup
+    };
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct GuardBox;
+
+    void init_lua();
+    void bind(lua_State* L, int idx, Unit& unit, const void* lua_class);
+    void note_override(lua_State* L, int idx, u32 hook);
+    static int guard_newindex(lua_State* L);
+
+    lua_State* L_;
+    EntityRegistry& registry_;
+    GuardBox* guard_box_ = nullptr;
+    int guard_ref_ = -2;  ///< the __newindex closure
+    int names_ref_ = -2;  ///< hook name -> index + 1
+    u32 generation_ = 1;
+    bool enabled_ = true;
+    std::map<std::pair<const void*, std::string>,
+             std::unique_ptr<LuaCallbackTable>> tables_;
+    Stats stats_;
+};
+
+} // namespace osc::sim
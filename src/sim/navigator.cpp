@@ -9,10 +9,16 @@
 
 namespace osc::sim {
 
+Navigator::Navigator() = default;
+Navigator::~Navigator() = default;
+Navigator::Navigator(Navigator&&) noexcept = default;
+Navigator& Navigator::operator=(Navigator&&) noexcept = default;
+
 void Navigator::set_goal(const Vector3& pos, const map::Pathfinder* pathfinder,
                           const Vector3& current_pos,
                           const std::string& layer,
                           f32 draft, bool amphibious) {
+    end_pursuit();
     goal_ = pos;
     waypoints_.clear();
     waypoint_index_ = 0;
@@ -46,6 +52,7 @@ void Navigator::set_goal(const Vector3& pos, const map::Pathfinder* pathfinder,
 }
 
 void Navigator::set_goal(const Vector3& pos) {
+    end_pursuit();
     goal_ = pos;
     waypoints_.clear();
     waypoint_index_ = 0;
@@ -53,7 +60,54 @@ void Navigator::set_goal(const Vector3& pos) {
     status_ = Status::Moving;
 }
 
+void Navigator::follow_path(std::vector<Vector3> waypoints) {
+    if (waypoints.empty()) {
+        abort_move();
+        return;
+    }
+    end_pursuit();
+    goal_ = waypoints.back();
+    waypoints_ = std::move(waypoints);
+    waypoint_index_ = 0;
+    status_ = Status::Moving;
+}
+
+void Navigator::pursue(const Vector3& pos, const map::Pathfinder* pathfinder,
+                       const Vector3& current_pos, const std::string& layer,
+                       f32 draft, bool amphibious) {
+    if (layer == "Air" || !pathfinder) {
+        set_goal(pos);
+        return;
+    }
+    if (!pursuit_) pursuit_ = std::make_unique<map::PursuitState>();
+
+    auto result = pathfinder->pursue(*pursuit_, current_pos.x, current_pos.z,
+                                     pos.x, pos.z, layer, draft, amphibious);
+    if (result.throttled) {
+        // Budget exhausted; keep following the old path and retry next tick
+        return;
+    }
+    goal_ = pos;
+    if (result.retargeted && !waypoints_.empty() &&
+        waypoint_index_ < waypoints_.size()) {
+        waypoints_.back() = result.waypoints.back();
+    } else if (result.found && !result.waypoints.empty()) {
+        waypoints_ = std::move(result.waypoints);
+        waypoint_index_ = 0;
+    } else {
+        // Genuinely no path — fall back to straight line
+        waypoints_.assign(1, pos);
+        waypoint_index_ = 0;
+    }
+    status_ = Status::Moving;
+}
+
+void Navigator::end_pursuit() {
+    pursuit_.reset();
+}
+
 void Navigator::abort_move() {
+    end_pursuit();
     status_ = Status::Idle;
     waypoints_.clear();
     waypoint_index_ = 0;
@@ -3,12 +3,14 @@
 #include "core/types.hpp"
 #include "sim/entity.hpp" // Vector3
 
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace osc::map {
 class Pathfinder;
 class Terrain;
+struct PursuitState;
 }
 
 namespace osc::sim {
@@ -19,6 +21,11 @@ class Navigator {
 public:
     enum class Status : u8 { Idle, Moving };
 
+    Navigator();
+    ~Navigator();
+    Navigator(Navigator&&) noexcept;
+    Navigator& operator=(Navigator&&) noexcept;
+
     /// Set goal with A* pathfinding (preferred).
     void set_goal(const Vector3& pos, const map::Pathfinder* pathfinder,
                   const Vector3& current_pos, const std::string& layer,
@@ -27,8 +34,25 @@ public:
     /// Set goal with straight-line movement (legacy/fallback).
     void set_goal(const Vector3& pos);
 
+    /// Follow precomputed waypoints (e.g. a formation's shared path); the
+    /// last one becomes the goal.
+    void follow_path(std::vector<Vector3> waypoints);
+
+    /// Chase a moving goal. Keeps its search between calls and repairs the
+    /// current path where it can (map::Pathfinder::pursue), so a target
+    /// that moves every tick does not cost a full A* every tick.
+    void pursue(const Vector3& pos, const map::Pathfinder* pathfinder,
+                const Vector3& current_pos, const std::string& layer,
+                f32 draft = 0, bool amphibious = false);
+
+    /// Stop moving and free any pursuit search state.
     void abort_move();
 
+    /// Free the pursuit search state (up to tens of thousands of nodes)
+    /// once nothing is chasing; the next pursue() starts a fresh search.
+    void end_pursuit();
+    bool has_pursuit_state() const { return pursuit_ != nullptr; }
+
     const Vector3& goal() const { return goal_; }
     Status status() const { return status_; }
     bool is_moving() const { return status_ == Status::Moving; }
@@ -55,6 +79,7 @@ private:
     bool speed_through_goal_ = false;
     std::vector<Vector3> waypoints_;
     size_t waypoint_index_ = 0;
+    std::unique_ptr<map::PursuitState> pursuit_; // from first pursue() until the move ends
     static constexpr f32 ARRIVAL_TOLERANCE = 0.5f;
     static constexpr f32 WAYPOINT_TOLERANCE = 1.5f;
 };
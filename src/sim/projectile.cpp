@@ -1,5 +1,6 @@
 #include "sim/projectile.hpp"
 #include "sim/entity_registry.hpp"
+#include "sim/shield_index.hpp"
 #include "map/terrain.hpp"
 
 #include <algorithm>
@@ -28,7 +29,7 @@ static void push_vec3(lua_State* L, const Vector3& v) {
 }
 
 void Projectile::update(f64 dt, EntityRegistry& registry, lua_State* L,
-                         const map::Terrain* terrain) {
+                         const map::Terrain* terrain, ShieldIndex* shields) {
     if (destroyed()) return;
 
     // Tick lifetime
@@ -117,6 +118,7 @@ void Projectile::update(f64 dt, EntityRegistry& registry, lua_State* L,
 
     // Move
     auto pos = position();
+    const Vector3 prev = pos;
     pos.x += velocity.x * static_cast<f32>(dt);
     pos.y += velocity.y * static_cast<f32>(dt);
     pos.z += velocity.z * static_cast<f32>(dt);
@@ -140,6 +142,17 @@ void Projectile::update(f64 dt, EntityRegistry& registry, lua_State* L,
         }
     }
 
+    // Shield interception: the first enemy bubble crossed this tick takes
+    // the whole hit
+    if (shields && collision_enabled) {
+        ShieldHit hit;
+        if (shields->intercept(prev, pos, army(), hit)) {
+            set_position(hit.point);
+            on_impact(L, registry.find(hit.shield_id), registry, true);
+            return;
+        }
+    }
+
     f32 speed = std::sqrt(velocity.x * velocity.x + velocity.z * velocity.z);
     f32 step = speed * static_cast<f32>(dt);
 
@@ -171,7 +184,7 @@ void Projectile::update(f64 dt, EntityRegistry& registry, lua_State* L,
 }
 
 void Projectile::on_impact(lua_State* L, Entity* target,
-                           EntityRegistry& registry) {
+                           EntityRegistry& registry, bool absorbed) {
     if (!L) {
         mark_destroyed();
         registry.unregister_entity(entity_id());
@@ -189,7 +202,7 @@ void Projectile::on_impact(lua_State* L, Entity* target,
             launcher_ref = launcher->lua_table_ref();
     }
 
-    if (damage_radius > 0) {
+    if (damage_radius > 0 && !absorbed) {
         // Area damage: DamageArea(instigator, position, radius, damage,
         //                         damageType, damageFriendly)
         lua_pushstring(L, "DamageArea");
@@ -11,6 +11,7 @@ namespace osc::map { class Terrain; }
 namespace osc::sim {
 
 class EntityRegistry;
+class ShieldIndex;
 
 class Projectile : public Entity {
 public:
@@ -43,12 +44,17 @@ public:
     bool collide_surface = true;     // SetCollideSurface
     bool stay_underwater = false;    // StayUnderwater
 
-    /// Per-tick: move, check collision, impact.
+    /// Per-tick: move, check collision, impact. With `shields`, the tick's
+    /// swept segment is tested against enemy bubbles first.
     void update(f64 dt, EntityRegistry& registry, lua_State* L,
-                const map::Terrain* terrain = nullptr);
+                const map::Terrain* terrain = nullptr,
+                ShieldIndex* shields = nullptr);
 
 private:
-    void on_impact(lua_State* L, Entity* target, EntityRegistry& registry);
+    /// `absorbed`: a shield took the hit, so area damage is not spread
+    /// past it and the shield alone receives the damage.
+    void on_impact(lua_State* L, Entity* target, EntityRegistry& registry,
+                   bool absorbed = false);
     static constexpr f32 HIT_RADIUS = 1.5f;
 };
 
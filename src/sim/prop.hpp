@@ -7,6 +7,7 @@ namespace osc::sim {
 class Prop : public Entity {
 public:
     bool is_prop() const override { return true; }
+    bool is_static() const override { return true; }
 };
 
 } // namespace osc::sim
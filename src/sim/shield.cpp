@@ -4,3 +4,5 @@
 // regeneration, damage absorption, energy management) lives in FA Lua
 // (shield.lua). The C++ side just provides entity identity, health tracking,
 // and a few moho method fields (is_on, size, shield_type).
+//
+// Projectile interception against active bubbles is native: see ShieldIndex.
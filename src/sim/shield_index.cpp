@@ -0,0 +1,265 @@
+#include "sim/shield_index.hpp"
+#include "sim/entity_registry.hpp"
+#include "sim/shield.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace osc::sim {
+
+namespace {
+
+constexpr f32 MIN_CELL = 32.0f;
+constexpr size_t MAX_CELLS = 4096;
+constexpr f32 MIN_SEGMENT_SQ = 1e-8f;
+constexpr f32 NO_HIT = 2.0f; // any t > 1
+
+bool army_bit(i32 army, u32& bit) {
+    if (army < 0 || army >= static_cast<i32>(ShieldIndex::MAX_ARMIES)) return false;
+    bit = 1u << army;
+    return true;
+}
+
+} // namespace
+
+void ShieldIndex::track(u32 shield_id) {
+    if (std::find(tracked_.begin(), tracked_.end(), shield_id) == tracked_.end())
+        tracked_.push_back(shield_id);
+}
+
+void ShieldIndex::set_friendly_mask(i32 army, u32 mask) {
+    u32 bit;
+    if (army_bit(army, bit)) friendly_[army] = mask | bit;
+}
+
+u32 ShieldIndex::friendly_mask(i32 army) const {
+    u32 bit;
+    if (!army_bit(army, bit)) return 0;
+    return friendly_[army] | bit;
+}
+
+void ShieldIndex::refresh(const EntityRegistry& registry) {
+    for (size_t i = 0; i < tracked_.size();) {
+        const u32 id = tracked_[i];
+        auto* e = registry.find(id);
+        auto slot_it = slot_of_.find(id);
+        if (!e || !e->is_shield()) {
+            if (slot_it != slot_of_.end()) erase(slot_it->second);
+            tracked_[i] = tracked_.back();
+            tracked_.pop_back();
+            continue;
+        }
+        ++i;
+
+        const auto* s = static_cast<const Shield*>(e);
+        const bool active = s->is_on && !s->destroyed() && s->health() > 0 &&
+                            s->size > 0 && s->shield_type == "Bubble";
+        if (!active) {
+            if (slot_it != slot_of_.end()) erase(slot_it->second);
+            continue;
+        }
+
+        Vector3 c = s->position();
+        if (s->owner_id) {
+            auto* owner = registry.find(s->owner_id);
+            if (owner && !owner->destroyed()) c = owner->position();
+        }
+        if (slot_it == slot_of_.end()) {
+            insert(id, c, s->size, s->army(), s->owner_id);
+            continue;
+        }
+        const u32 k = slot_it->second;
+        if (cx_[k] != c.x || cy_[k] != c.y || cz_[k] != c.z ||
+            radius_[k] != s->size) {
+            cx_[k] = c.x; cy_[k] = c.y; cz_[k] = c.z;
+            radius_[k] = s->size;
+            grid_dirty_ = true;
+        }
+        army_[k] = s->army();
+    }
+    if (grid_dirty_) rebuild_grid();
+}
+
+void ShieldIndex::insert(u32 id, const Vector3& c, f32 r, i32 army, u32 owner) {
+    slot_of_[id] = static_cast<u32>(ids_.size());
+    cx_.push_back(c.x); cy_.push_back(c.y); cz_.push_back(c.z);
+    radius_.push_back(r);
+    army_.push_back(army);
+    owner_.push_back(owner);
+    ids_.push_back(id);
+    grid_dirty_ = true;
+}
+
+void ShieldIndex::erase(u32 slot) {
+    const u32 last = static_cast<u32>(ids_.size() - 1);
+    slot_of_.erase(ids_[slot]);
+    if (slot != last) {
+        cx_[slot] = cx_[last]; cy_[slot] = cy_[last]; cz_[slot] = cz_[last];
+        radius_[slot] = radius_[last];
+        army_[slot] = army_[last];
+        owner_[slot] = owner_[last];
+        ids_[slot] = ids_[last];
+        slot_of_[ids_[slot]] = slot;
+    }
+    cx_.pop_back(); cy_.pop_back(); cz_.pop_back();
+    radius_.pop_back();
+    army_.pop_back();
+    owner_.pop_back();
+    ids_.pop_back();
+    grid_dirty_ = true;
+}
+
+void ShieldIndex::rebuild_grid() {
+    grid_dirty_ = false;
+    stats_.grid_rebuilds++;
+    const size_t n = ids_.size();
+    stamp_.assign(n, 0);
+    query_stamp_ = 0;
+    if (n == 0) {
+        grid_w_ = grid_h_ = 0;
+        cell_start_.assign(1, 0);
+        cell_slots_.clear();
+        return;
+    }
+
+    f32 min_x = cx_[0] - radius_[0], max_x = cx_[0] + radius_[0];
+    f32 min_z = cz_[0] - radius_[0], max_z = cz_[0] + radius_[0];
+    f32 max_r = 0;
+    for (size_t k = 0; k < n; ++k) {
+        min_x = std::min(min_x, cx_[k] - radius_[k]);
+        max_x = std::max(max_x, cx_[k] + radius_[k]);
+        min_z = std::min(min_z, cz_[k] - radius_[k]);
+        max_z = std::max(max_z, cz_[k] + radius_[k]);
+        max_r = std::max(max_r, radius_[k]);
+    }
+    // Cells about one bubble wide: a shield lands in at most 3x3 cells
+    f32 cell = std::max(MIN_CELL, max_r);
+    for (;;) {
+        grid_w_ = static_cast<u32>((max_x - min_x) / cell) + 1;
+        grid_h_ = static_cast<u32>((max_z - min_z) / cell) + 1;
+        if (static_cast<size_t>(grid_w_) * grid_h_ <= MAX_CELLS) break;
+        cell *= 2.0f;
+    }
+    origin_x_ = min_x;
+    origin_z_ = min_z;
+    inv_cell_ = 1.0f / cell;
+
+    auto cell_range = [&](size_t k, u32& x0, u32& z0, u32& x1, u32& z1) {
+        x0 = static_cast<u32>((cx_[k] - radius_[k] - origin_x_) * inv_cell_);
+        z0 = static_cast<u32>((cz_[k] - radius_[k] - origin_z_) * inv_cell_);
+        x1 = std::min(grid_w_ - 1,
+                      static_cast<u32>((cx_[k] + radius_[k] - origin_x_) * inv_cell_));
+        z1 = std::min(grid_h_ - 1,
+                      static_cast<u32>((cz_[k] + radius_[k] - origin_z_) * inv_cell_));
+    };
+
+    const size_t cells = static_cast<size_t>(grid_w_) * grid_h_;
+    cell_start_.assign(cells + 1, 0);
+    for (size_t k = 0; k < n; ++k) {
+        u32 x0, z0, x1, z1;
+        cell_range(k, x0, z0, x1, z1);
+        for (u32 z = z0; z <= z1; ++z)
+            for (u32 x = x0; x <= x1; ++x) cell_start_[z * grid_w_ + x + 1]++;
+    }
+    for (size_t c = 0; c < cells; ++c) cell_start_[c + 1] += cell_start_[c];
+    cell_slots_.resize(cell_start_[cells]);
+    std::vector<u32> cursor(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t k = 0; k < n; ++k) {
+        u32 x0, z0, x1, z1;
+        cell_range(k, x0, z0, x1, z1);
+        for (u32 z = z0; z <= z1; ++z)
+            for (u32 x = x0; x <= x1; ++x)
+                cell_slots_[cursor[z * grid_w_ + x]++] = static_cast<u32>(k);
+    }
+}
+
+bool ShieldIndex::intercept(const Vector3& from, const Vector3& to, i32 army,
+                            ShieldHit& hit) {
+    if (ids_.empty()) return false;
+    const f32 dx = to.x - from.x, dy = to.y - from.y, dz = to.z - from.z;
+    const f32 a = dx * dx + dy * dy + dz * dz;
+    if (a < MIN_SEGMENT_SQ) return false;
+    stats_.queries++;
+
+    // Cells under the segment's bounds
+    const f32 fx0 = (std::min(from.x, to.x) - origin_x_) * inv_cell_;
+    const f32 fz0 = (std::min(from.z, to.z) - origin_z_) * inv_cell_;
+    const f32 fx1 = (std::max(from.x, to.x) - origin_x_) * inv_cell_;
+    const f32 fz1 = (std::max(from.z, to.z) - origin_z_) * inv_cell_;
+    if (fx1 < 0 || fz1 < 0 || fx0 >= static_cast<f32>(grid_w_) ||
+        fz0 >= static_cast<f32>(grid_h_))
+        return false;
+    const u32 x0 = fx0 < 0 ? 0 : static_cast<u32>(fx0);
+    const u32 z0 = fz0 < 0 ? 0 : static_cast<u32>(fz0);
+    const u32 x1 = std::min(grid_w_ - 1, static_cast<u32>(fx1));
+    const u32 z1 = std::min(grid_h_ - 1, static_cast<u32>(fz1));
+
+    if (++query_stamp_ == 0) {
+        std::fill(stamp_.begin(), stamp_.end(), 0);
+        query_stamp_ = 1;
+    }
+    const u32 friendly = friendly_mask(army);
+    cand_slot_.clear();
+    kx_.clear(); ky_.clear(); kz_.clear(); kr2_.clear();
+    for (u32 z = z0; z <= z1; ++z) {
+        for (u32 x = x0; x <= x1; ++x) {
+            const u32 c = z * grid_w_ + x;
+            for (u32 i = cell_start_[c]; i < cell_start_[c + 1]; ++i) {
+                const u32 k = cell_slots_[i];
+                if (stamp_[k] == query_stamp_) continue;
+                stamp_[k] = query_stamp_;
+                u32 bit;
+                if (army_[k] == army ||
+                    (army_bit(army_[k], bit) && (friendly & bit)))
+                    continue;
+                cand_slot_.push_back(k);
+                kx_.push_back(cx_[k] - from.x);
+                ky_.push_back(cy_[k] - from.y);
+                kz_.push_back(cz_[k] - from.z);
+                kr2_.push_back(radius_[k] * radius_[k]);
+            }
+        }
+    }
+    const size_t m = cand_slot_.size();
+    if (m == 0) return false;
+    stats_.candidates += m;
+
+    // Ray-sphere over the candidates: no early outs, so the loop
+    // vectorizes. With s = center - from: b = s.d, c = |s|^2 - r^2; the
+    // entry is at t = (b - sqrt(b^2 - a c)) / a and only counts when the
+    // segment starts outside (c > 0).
+    kt_.resize(m);
+    const f32 inv_a = 1.0f / a;
+    const f32* kx = kx_.data();
+    const f32* ky = ky_.data();
+    const f32* kz = kz_.data();
+    const f32* kr2 = kr2_.data();
+    f32* kt = kt_.data();
+    for (size_t i = 0; i < m; ++i) {
+        const f32 b = kx[i] * dx + ky[i] * dy + kz[i] * dz;
+        const f32 c = kx[i] * kx[i] + ky[i] * ky[i] + kz[i] * kz[i] - kr2[i];
+        const f32 disc = b * b - a * c;
+        const f32 t = (b - std::sqrt(std::max(disc, 0.0f))) * inv_a;
+        const bool entered = (c > 0) & (disc >= 0) & (t >= 0) & (t <= 1);
+        kt[i] = entered ? t : NO_HIT;
+    }
+
+    // Earliest crossing, ties to the lower entity id
+    size_t best = m;
+    for (size_t i = 0; i < m; ++i) {
+        if (kt[i] > 1) continue;
+        if (best == m || kt[i] < kt[best] ||
+            (kt[i] == kt[best] && ids_[cand_slot_[i]] < ids_[cand_slot_[best]]))
+            best = i;
+    }
+    if (best == m) return false;
+
+    stats_.hits++;
+    hit.shield_id = ids_[cand_slot_[best]];
+    hit.owner_id = owner_[cand_slot_[best]];
+    hit.t = kt[best];
+    hit.point = {from.x + dx * hit.t, from.y + dy * hit.t, from.z + dz * hit.t};
+    return true;
+}
+
+} // namespace osc::sim
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "sim/entity.hpp"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+namespace osc::sim {
+
+class EntityRegistry;
+
+/// A projectile segment's first shield crossing.
+struct ShieldHit {
+    u32 shield_id = 0;
+    u32 owner_id = 0;
+    f32 t = 0;      ///< fraction along the segment, 0..1
+    Vector3 point;  ///< where the segment enters the bubble
+};
+
+/// Active bubble shields for projectile interception.
+///
+/// Shields are kept as a compact structure-of-arrays (center, radius,
+/// army, owner) plus a coarse grid over their bounds. refresh() walks only
+/// the tracked shields and touches the arrays and grid when one turns on,
+/// turns off or moves, so a quiet tick costs one pass over the shields.
+///
+/// intercept() gathers the shields in the cells a segment's bounds cover
+/// into flat arrays and runs a branch-free ray-sphere kernel over them.
+/// Segments starting inside a bubble pass (units fire out of their own
+/// shields), and shields of the projectile's army and its allies are
+/// skipped. Overlapping bubbles resolve to the earliest crossing, ties to
+/// the lowest shield entity id, so the result never depends on array or
+/// grid order.
+class ShieldIndex {
+public:
+    static constexpr u32 MAX_ARMIES = 32;
+
+    /// Start tracking a shield entity (called when it is created).
+    void track(u32 shield_id);
+
+    /// Sync with the tracked shields: a shield is indexed while it is on,
+    /// a bubble, alive and has health left. Bubbles follow their owner
+    /// unit. Shields no longer in the registry are dropped.
+    void refresh(const EntityRegistry& registry);
+
+    /// Armies whose shields a projectile of `army` flies through, one bit
+    /// per army. Defaults to the army's own bit.
+    void set_friendly_mask(i32 army, u32 mask);
+    u32 friendly_mask(i32 army) const;
+
+    /// First enemy bubble the segment `from` -> `to` enters, if any.
+    bool intercept(const Vector3& from, const Vector3& to, i32 army,
+                   ShieldHit& hit);
+
+    /// Indexed (active) shields.
+    size_t size() const { return ids_.size(); }
+    size_t tracked() const { return tracked_.size(); }
+
+    struct Stats {
+        u32 grid_rebuilds = 0;
+        u64 queries = 0;
+        u64 candidates = 0; ///< spheres run through the kernel
+        u64 hits = 0;
+    };
+    const Stats& stats() const { return stats_; }
+
+private:
+    void insert(u32 id, const Vector3& c, f32 r, i32 army, u32 owner);
+    void erase(u32 slot);
+    void rebuild_grid();
+
+    std::vector<u32> tracked_;
+
+    // Active shields, swap-removed
+    std::vector<f32> cx_, cy_, cz_, radius_;
+    std::vector<i32> army_;
+    std::vector<u32> owner_, ids_;
+    std::unordered_map<u32, u32> slot_of_;
+    bool grid_dirty_ = false;
+
+    // Coarse grid over the active shields' bounds: each shield is listed
+    // in every cell its bounding square touches.
+    f32 origin_x_ = 0, origin_z_ = 0, inv_cell_ = 1;
+    u32 grid_w_ = 0, grid_h_ = 0;
+    std::vector<u32> cell_start_; ///< grid_w_ * grid_h_ + 1 offsets
+    std::vector<u32> cell_slots_;
+
+    // Query scratch: candidate dedup stamps and the kernel's input
+    std::vector<u32> stamp_;
+    u32 query_stamp_ = 0;
+    std::vector<u32> cand_slot_;
+    std::vector<f32> kx_, ky_, kz_, kr2_, kt_;
+
+    std::array<u32, MAX_ARMIES> friendly_{};
+    Stats stats_;
+};
+
+} // namespace osc::sim
@@ -18,12 +18,15 @@ extern "C" {
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+
 namespace osc::sim {
 
 u32 SimState::s_sim_generation_ = 0;
 
 SimState::SimState(lua_State* L, blueprints::BlueprintStore* store)
-    : L_(L), thread_manager_(L), blueprint_store_(store) {
+    : L_(L), thread_manager_(L), lua_callbacks_(L, entity_registry_),
+      blueprint_store_(store) {
     ++s_sim_generation_;
 }
 
@@ -120,6 +123,8 @@ void SimState::build_visibility_grid() {
     visibility_grid_ = std::make_unique<map::VisibilityGrid>(
         terrain_->map_width(), terrain_->map_height());
     visibility_grid_->build_height_grid(*terrain_);
+    visibility_grid_->set_horizon_cache_budget(
+        map::VisibilityGrid::DEFAULT_HORIZON_CACHE_BUDGET);
     spdlog::info("Built visibility grid: {}x{} cells (cell_size={})",
                  visibility_grid_->grid_width(),
                  visibility_grid_->grid_height(),
@@ -224,16 +229,23 @@ void SimState::tick() {
     game_time_ = tick_count_ * SECONDS_PER_TICK;
 
     if (pathfinder_) {
+        // Requests made since the previous tick began
+        TRACE_COUNTER("Path requests", pathfinder_->requests_this_tick());
         pathfinder_->reset_request_count();
     }
+    TRACE_COUNTER("Entities", entity_registry_.count());
+    plan_formation_moves();
 
     {
         PROFILE_ZONE("Sim::threads");
         thread_manager_.resume_all(tick_count_);
     }
+    TRACE_COUNTER("Lua resumes", thread_manager_.last_tick_stats().resumed);
 
     update_economies();
+    refresh_shields();
     update_entities();
+    resolve_ground_overlaps();
 
     // Process air crash impacts
     {
@@ -348,6 +360,7 @@ void SimState::tick() {
 
 void SimState::update_economies() {
     PROFILE_ZONE("Sim::economy");
+    entity_registry_.flush_economy();
     for (auto& army : armies_) {
         army->update_economy(entity_registry_, SECONDS_PER_TICK);
     }
@@ -365,6 +378,20 @@ void SimState::tick_economy_events() {
     economy_events_.gc();
 }
 
+void SimState::refresh_shields() {
+    PROFILE_ZONE("Sim::shields");
+    // Projectiles fly through their own and allied armies' shields
+    for (size_t i = 0; i < armies_.size() && i < ShieldIndex::MAX_ARMIES; ++i) {
+        u32 mask = 0;
+        for (size_t j = 0; j < armies_.size() && j < ShieldIndex::MAX_ARMIES; ++j) {
+            if (i == j || is_ally(static_cast<i32>(i), static_cast<i32>(j)))
+                mask |= 1u << j;
+        }
+        shield_index_.set_friendly_mask(static_cast<i32>(i), mask);
+    }
+    shield_index_.refresh(entity_registry_);
+}
+
 void SimState::update_entities() {
     PROFILE_ZONE("Sim::entities");
     // Snapshot IDs to avoid iterator invalidation if update() triggers removal
@@ -382,6 +409,9 @@ void SimState::update_entities() {
                                   armies_[i]->energy_efficiency()};
     }
 
+    // Spatial queries during the update phase see start-of-tick positions;
+    // everything that moved is re-bucketed once at the end.
+    entity_registry_.begin_move_batch();
     for (u32 id : ids) {
         auto* e = entity_registry_.find(id);
         if (!e || e->destroyed()) continue;
@@ -389,9 +419,113 @@ void SimState::update_entities() {
             static_cast<Unit*>(e)->update(SECONDS_PER_TICK, ctx);
         } else if (e->is_projectile()) {
             static_cast<Projectile*>(e)->update(SECONDS_PER_TICK,
-                                                 entity_registry_, L_, terrain_.get());
+                                                 entity_registry_, L_, terrain_.get(),
+                                                 &shield_index_);
+        }
+    }
+    entity_registry_.end_move_batch();
+}
+
+namespace {
+
+/// Units only collide with others on the same movement layer.
+u8 avoidance_layer(const std::string& layer) {
+    if (layer == "Land") return 0;
+    if (layer == "Water") return 1;
+    if (layer == "Seabed") return 2;
+    if (layer == "Sub") return 3;
+    return 4;
+}
+
+constexpr f32 AVOIDANCE_MAX_STEP = 0.5f; // world units per tick
+constexpr f32 AVOIDANCE_MIN_RADIUS = 0.25f;
+
+} // namespace
+
+void SimState::resolve_ground_overlaps() {
+    PROFILE_ZONE("Sim::avoidance");
+    avoidance_units_.clear();
+    entity_registry_.for_each([&](Entity& e) {
+        if (e.destroyed() || !e.is_unit() || e.is_static()) return;
+        auto* u = static_cast<Unit*>(&e);
+        // Cargo rides at its transport's position
+        if (u->is_air_unit() || u->immobile() || u->is_dying() ||
+            u->is_being_built() || u->parent_entity_id() != 0 ||
+            u->transport_id() != 0)
+            return;
+        avoidance_units_.push_back(u);
+    });
+    // Registry order is unspecified; entity ids fix the pass
+    std::sort(avoidance_units_.begin(), avoidance_units_.end(),
+              [](const Unit* a, const Unit* b) {
+                  return a->entity_id() < b->entity_id();
+              });
+
+    avoidance_agents_.clear();
+    for (auto* u : avoidance_units_) {
+        const auto& p = u->position();
+        f32 r = 0.5f * std::max(u->footprint_size_x(), u->footprint_size_z());
+        avoidance_agents_.add(p.x, p.z, std::max(r, AVOIDANCE_MIN_RADIUS),
+                              avoidance_layer(u->layer()), u->is_moving());
+    }
+    avoidance_.compute(avoidance_agents_, AVOIDANCE_MAX_STEP);
+
+    // Apply serially: never push a unit onto ground it cannot stand on
+    const auto& dx = avoidance_.dx();
+    const auto& dz = avoidance_.dz();
+    auto passable = [&](const Unit* u, f32 x, f32 z) {
+        if (!pathfinding_grid_) return true;
+        u32 gx, gz;
+        pathfinding_grid_->world_to_grid(x, z, gx, gz);
+        return pathfinding_grid_->is_passable_for(
+            gx, gz, u->layer(), u->naval_draft(),
+            u->is_amphibious() || u->is_hover());
+    };
+    entity_registry_.begin_move_batch();
+    for (size_t i = 0; i < avoidance_units_.size(); ++i) {
+        if (dx[i] == 0 && dz[i] == 0) continue;
+        auto* u = avoidance_units_[i];
+        Vector3 p = u->position();
+        // Keep the unit's height above what it moves on: seabed units
+        // follow the ground, subs keep their dive depth below the surface
+        bool on_seabed = u->layer() == "Seabed";
+        auto ground = [&](f32 x, f32 z) {
+            return on_seabed ? terrain_->get_terrain_height(x, z)
+                             : terrain_->get_surface_height(x, z);
+        };
+        f32 offset = terrain_ ? p.y - ground(p.x, p.z) : 0.0f;
+        if (passable(u, p.x + dx[i], p.z + dz[i])) {
+            p.x += dx[i];
+            p.z += dz[i];
+        } else if (passable(u, p.x + dx[i], p.z)) {
+            p.x += dx[i];
+        } else if (passable(u, p.x, p.z + dz[i])) {
+            p.z += dz[i];
+        } else {
+            continue;
+        }
+        if (terrain_) p.y = ground(p.x, p.z) + offset;
+        u->set_position(clamp_to_playable(p));
+    }
+    entity_registry_.end_move_batch();
+}
+
+void SimState::plan_formation_moves() {
+    if (formation_orders_.empty()) return;
+    PROFILE_ZONE("Sim::formation_moves");
+    std::vector<Unit*> units;
+    for (const auto& order : formation_orders_) {
+        units.clear();
+        for (u32 id : order.unit_ids) {
+            auto* e = entity_registry_.find(id);
+            if (e && e->is_unit() && !e->destroyed())
+                units.push_back(static_cast<Unit*>(e));
         }
+        issue_formation_move(command_store_, units, order.goal, order.shape,
+                             order.command_id, order.clear_existing,
+                             pathfinder_.get(), pathfinding_grid_.get());
     }
+    formation_orders_.clear();
 }
 
 void SimState::update_visibility() {
@@ -413,14 +547,17 @@ void SimState::update_visibility() {
         auto& pos = unit->position();
         u32 ua = static_cast<u32>(army);
 
-        // Vision: terrain LOS occlusion
+        // Vision: terrain LOS occlusion. Stationary units reuse the
+        // cached horizon table of their cell; movers run the sweep from
+        // the same cell-quantized eye height.
         if (unit->is_intel_enabled("Vision")) {
             f32 r = unit->get_intel_radius("Vision");
-            if (r > 0.0f) {
-                f32 eye_h = terrain_->get_terrain_height(pos.x, pos.z) +
-                            map::VisibilityGrid::EYE_OFFSET;
-                visibility_grid_->paint_circle_los(ua, pos.x, pos.z, r,
-                                                    eye_h);
+            if (r > 0.0f && !unit->is_moving()) {
+                visibility_grid_->paint_circle_los_cached(ua, pos.x, pos.z, r);
+            } else if (r > 0.0f) {
+                visibility_grid_->paint_circle_los(
+                    ua, pos.x, pos.z, r,
+                    visibility_grid_->eye_height(pos.x, pos.z));
             }
         }
 
@@ -4,8 +4,13 @@
 #include "sim/army_brain.hpp"
 #include "sim/economy_event.hpp"
 #include "sim/entity_registry.hpp"
+#include "sim/formation.hpp"
 #include "sim/ieffect.hpp"
+#include "sim/local_avoidance.hpp"
+#include "sim/lua_callbacks.hpp"
+#include "sim/shield_index.hpp"
 #include "sim/thread_manager.hpp"
+#include "sim/unit_command.hpp"
 
 #include <array>
 #include <memory>
@@ -38,6 +43,7 @@ namespace osc::sim {
 
 class AnimCache;
 class BoneCache;
+class Unit;
 
 /// Camera shake event queued by ShakeCamera moho method.
 struct CameraShakeEvent {
@@ -92,6 +98,12 @@ public:
 
     ThreadManager& thread_manager() { return thread_manager_; }
 
+    /// Cached unit hook lookup for C++-to-script dispatch.
+    LuaCallbackCache& lua_callbacks() { return lua_callbacks_; }
+
+    /// Active bubble shields, for projectile interception.
+    ShieldIndex& shield_index() { return shield_index_; }
+
     blueprints::BlueprintStore* blueprint_store() { return blueprint_store_; }
     blueprints::BlueprintStore* blueprint_store() const { return blueprint_store_; }
 
@@ -170,6 +182,27 @@ public:
     /// Monotonically increasing command ID for IsCommandsActive tracking.
     u32 next_command_id() { return ++next_command_id_; }
 
+    /// Payloads and names behind every unit command queue in this sim.
+    CommandStore& command_store() { return command_store_; }
+
+    /// A player's group move, waiting to be planned by the sim.
+    struct FormationMoveOrder {
+        std::vector<u32> unit_ids;
+        Vector3 goal;
+        FormationShape shape = FormationShape::Growth;
+        u32 command_id = 0;
+        bool clear_existing = true;
+    };
+
+    /// Queue a group move from input. It is planned (issue_formation_move)
+    /// at the start of the next tick, so its path searches share that
+    /// tick's budget instead of stalling the frame that issued it. Orders
+    /// are planned in the order they were queued.
+    void queue_formation_move(FormationMoveOrder order) {
+        formation_orders_.push_back(std::move(order));
+    }
+    size_t queued_formation_moves() const { return formation_orders_.size(); }
+
     // VFX / IEffect registry
     IEffectRegistry& effect_registry() { return effect_registry_; }
     const IEffectRegistry& effect_registry() const { return effect_registry_; }
@@ -222,7 +255,10 @@ public:
 
 private:
     void update_economies();
+    void refresh_shields();
     void update_entities();
+    void resolve_ground_overlaps();
+    void plan_formation_moves();
     void update_visibility();
     void tick_economy_events();
     void fire_on_intel_change(u32 entity_id, u32 army_idx,
@@ -238,8 +274,10 @@ private:
                               bool radar_stealth, bool sonar_stealth) const;
 
     lua_State* L_;
+    CommandStore command_store_; // before the registry: outlives the queues
     EntityRegistry entity_registry_;
     ThreadManager thread_manager_;
+    LuaCallbackCache lua_callbacks_;
     blueprints::BlueprintStore* blueprint_store_;
     std::unique_ptr<map::Terrain> terrain_;
     std::unique_ptr<map::PathfindingGrid> pathfinding_grid_;
@@ -252,6 +290,10 @@ private:
     IEffectRegistry effect_registry_;
     EconomyEventRegistry economy_events_;
     std::vector<std::unique_ptr<ArmyBrain>> armies_;
+    LocalAvoidance avoidance_;
+    AvoidanceAgents avoidance_agents_;
+    std::vector<Unit*> avoidance_units_;
+    ShieldIndex shield_index_;
     u32 tick_count_ = 0;
     f64 game_time_ = 0.0;
 
@@ -263,6 +305,7 @@ private:
     };
     std::vector<TempVision> temp_visions_;
     u32 next_command_id_ = 0;
+    std::vector<FormationMoveOrder> formation_orders_;
     bool game_ended_ = false;
     std::vector<CameraShakeEvent> camera_shake_events_;
     std::vector<ResourceDeposit> resource_deposits_;
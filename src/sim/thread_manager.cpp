@@ -1,6 +1,8 @@
 #include "sim/thread_manager.hpp"
 #include "sim/waitable.hpp"
 
+#include <algorithm>
+#include <cctype>
 #include <climits>
 #include <cstring>
 #include <spdlog/spdlog.h>
@@ -12,10 +14,39 @@ extern "C" {
 
 namespace osc::sim {
 
+namespace {
+// Manager whose deferrable thread is running on this OS thread (the sim
+// and UI managers tick on different threads).
+thread_local ThreadManager* governing_manager = nullptr;
+} // namespace
+
 void ThreadManager::instruction_hook(lua_State* L, lua_Debug*) {
     luaL_error(L, "instruction count exceeded");
 }
 
+void ThreadManager::governor_hook(lua_State* L, lua_Debug*) {
+    ThreadManager* mgr = governing_manager;
+    if (!mgr) return;
+    mgr->slice_used_ += QUANTUM;
+    // Inside pcall or a metamethod the coroutine cannot yield; keep
+    // counting and stop at the first quantum outside it.
+    if (mgr->slice_used_ >= mgr->slice_limit_ && lua_yieldable(L)) {
+        mgr->slice_preempted_ = true;
+        lua_yield(L, 0);
+    }
+}
+
+bool ThreadManager::is_deferrable_source(const std::string& source) {
+    // Substring match so mod AI ("@/mods/x/lua/AI/...") is covered too
+    std::string s = source;
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    for (const char* dir : {"/lua/ai/", "/lua/aibrain", "/lua/platoon"}) {
+        if (s.find(dir) != std::string::npos) return true;
+    }
+    return false;
+}
+
 ThreadManager::ThreadManager(lua_State* L) : L_(L) {}
 
 // Destroy method for thread wrapper tables.
@@ -63,7 +94,7 @@ void ThreadManager::register_in_registry(lua_State* L) {
     lua_rawset(L, LUA_REGISTRYINDEX);
 }
 
-int ThreadManager::fork_thread(lua_State* L) {
+int ThreadManager::fork_thread(lua_State* L, ThreadClass cls) {
     // Stack: [1]=function, [2..n]=args
     // No extra diagnostics needed — just the standard check
     luaL_checktype(L, 1, LUA_TFUNCTION);
@@ -109,6 +140,10 @@ int ThreadManager::fork_thread(lua_State* L) {
     entry.lua_ref = ref;
     entry.wait_until_tick = 0; // resume immediately on next tick
     entry.dead = false;
+    entry.cls = (cls == ThreadClass::Deferrable ||
+                 is_deferrable_source(source_info))
+                    ? ThreadClass::Deferrable
+                    : ThreadClass::Critical;
     entry.source = std::move(source_info);
 
     // If we're inside resume_all, buffer to avoid iterator invalidation
@@ -154,6 +189,9 @@ void ThreadManager::kill_thread(int ref) {
 
 void ThreadManager::resume_all(u32 current_tick) {
     resuming_ = true;
+    tick_stats_ = {};
+    bool governed = tick_budget_ > 0;
+    deferrable_queue_.clear();
 
     // Use index-based loop since pending_threads_ may grow via fork_thread,
     // but threads_ itself won't be modified during this loop.
@@ -161,72 +199,42 @@ void ThreadManager::resume_all(u32 current_tick) {
         auto& t = threads_[i];
         if (t.dead || t.wait_until_tick > static_cast<i32>(current_tick))
             continue;
-
-        // Set instruction count hook to prevent infinite loops.
-        // Skip hook setup for very large budgets (>= 1M) since they're
-        // effectively unlimited — avoids per-instruction callback overhead.
-        bool need_hook = (instruction_budget_ > 0 &&
-                          instruction_budget_ < 1000000);
-        if (need_hook) {
-            lua_sethook(t.coroutine, instruction_hook,
-                        LUA_MASKCOUNT, instruction_budget_);
-        }
-
-        // Lua 5.0 lua_resume(L, nargs): for initial call, the function
-        // is at L->top - (nargs+1).  On first resume the coroutine stack
-        // is [fn, arg1, ..., argN] so nargs = gettop - 1.  After a yield
-        // we clear the stack (settop 0), so gettop - 1 = -1 → clamp to 0.
-        int nargs = std::max(0, lua_gettop(t.coroutine) - 1);
-        int status = lua_resume(t.coroutine, nargs);
-
-        // Clear hook after resume
-        if (need_hook) {
-            lua_sethook(t.coroutine, nullptr, 0, 0);
+        if (governed && t.cls == ThreadClass::Deferrable) {
+            deferrable_queue_.push_back(i);
+            continue;
         }
+        resume_thread(t, current_tick, 0);
+    }
 
-        if (status == 0) {
-            // Lua 5.0: resume returns 0 for both yield and normal return.
-            // Check if the coroutine is dead or suspended using the same
-            // heuristic as Lua 5.0's coroutine.status (lbaselib.c):
-            lua_Debug ar;
-            if (lua_getstack(t.coroutine, 0, &ar) == 0) {
-                // Thread finished normally (dead) — no active frames.
-                // Discard any return values the thread may have produced.
-                lua_settop(t.coroutine, 0);
-                t.dead = true;
-            } else {
-                // Thread yielded. Check what it yielded:
-                // - number → WaitTicks(n), resume after n ticks
-                // - lightuserdata → WaitFor(manipulator), sleep until woken
-                i32 wait_ticks = 1;
-                if (lua_gettop(t.coroutine) > 0) {
-                    if (lua_type(t.coroutine, -1) == LUA_TNUMBER) {
-                        wait_ticks = std::max(
-                            1,
-                            static_cast<i32>(lua_tonumber(t.coroutine, -1)));
-                    } else if (lua_type(t.coroutine, -1) == LUA_TLIGHTUSERDATA) {
-                        // WaitFor(waitable) — store thread ref on
-                        // waitable, sleep until it completes
-                        auto* waitable = static_cast<Waitable*>(
-                            lua_touserdata(t.coroutine, -1));
-                        waitable->set_waiting_thread_ref(t.lua_ref);
-                        lua_settop(t.coroutine, 0);
-                        t.wait_until_tick = INT32_MAX;
-                        continue;
-                    }
-                }
-                lua_settop(t.coroutine, 0); // clear yielded values
-                t.wait_until_tick =
-                    static_cast<i32>(current_tick) + wait_ticks;
+    if (!deferrable_queue_.empty()) {
+        // Longest-deferred first, then fork order: deterministic, and a
+        // thread that lost out on budget goes ahead of those that ran.
+        std::stable_sort(deferrable_queue_.begin(), deferrable_queue_.end(),
+                         [&](size_t a, size_t b) {
+                             return threads_[a].deferred_ticks >
+                                    threads_[b].deferred_ticks;
+                         });
+        u64 used = 0;
+        for (size_t i : deferrable_queue_) {
+            auto& t = threads_[i];
+            // A critical thread may have killed it meanwhile
+            if (t.dead || t.wait_until_tick > static_cast<i32>(current_tick))
+                continue;
+            u64 slice = used < tick_budget_ ? tick_budget_ - used : 0;
+            if (t.deferred_ticks >= max_deferral_)
+                slice = std::max<u64>(slice, MIN_SLICE);
+            if (slice < QUANTUM) {
+                t.deferred_ticks++;
+                tick_stats_.deferred++;
+                continue;
             }
-        } else {
-            // Thread errored
-            const char* err = lua_tostring(t.coroutine, -1);
-            spdlog::warn("Thread error: {} [forked at {}]",
-                         err ? err : "(unknown)",
-                         t.source.empty() ? "?" : t.source);
-            t.dead = true;
+            tick_stats_.deferrable_resumed++;
+            tick_stats_.max_deferral =
+                std::max(tick_stats_.max_deferral, t.deferred_ticks);
+            resume_thread(t, current_tick, slice);
+            used += slice_used_;
         }
+        tick_stats_.deferrable_instructions = used;
     }
 
     resuming_ = false;
@@ -241,6 +249,98 @@ void ThreadManager::resume_all(u32 current_tick) {
     cleanup_dead_threads();
 }
 
+void ThreadManager::resume_thread(ThreadEntry& t, u32 current_tick,
+                                  u64 slice) {
+    ThreadManager* outer = governing_manager;
+    bool governed = slice > 0;
+    // Set instruction count hook to prevent infinite loops.
+    // Skip hook setup for very large budgets (>= 1M) since they're
+    // effectively unlimited — avoids per-instruction callback overhead.
+    bool need_hook = (!governed && instruction_budget_ > 0 &&
+                      instruction_budget_ < 1000000);
+    if (governed) {
+        // The resume itself is charged a quantum up front (see QUANTUM)
+        governing_manager = this;
+        slice_used_ = QUANTUM;
+        slice_limit_ = slice;
+        slice_preempted_ = false;
+        lua_sethook(t.coroutine, governor_hook, LUA_MASKCOUNT, QUANTUM);
+    } else if (need_hook) {
+        lua_sethook(t.coroutine, instruction_hook,
+                    LUA_MASKCOUNT, instruction_budget_);
+    }
+
+    // Lua 5.0 lua_resume(L, nargs): for initial call, the function
+    // is at L->top - (nargs+1).  On first resume the coroutine stack
+    // is [fn, arg1, ..., argN] so nargs = gettop - 1.  After a yield
+    // we clear the stack (settop 0), so gettop - 1 = -1 → clamp to 0.
+    // A preempted thread is resumed mid-function and takes no arguments.
+    int nargs = t.preempted ? 0 : std::max(0, lua_gettop(t.coroutine) - 1);
+    t.preempted = false;
+    tick_stats_.resumed++;
+    int status = lua_resume(t.coroutine, nargs);
+
+    // Clear hook after resume
+    if (governed || need_hook) {
+        lua_sethook(t.coroutine, nullptr, 0, 0);
+    }
+    governing_manager = outer;
+    t.deferred_ticks = 0;
+
+    if (status == 0 && governed && slice_preempted_) {
+        // Yielded by the governor hook: the stack holds the live frames
+        // of the interrupted function, so leave it as is. Still due, so
+        // it continues on the next tick.
+        t.preempted = true;
+        tick_stats_.preempted++;
+        return;
+    }
+
+    if (status == 0) {
+        // Lua 5.0: resume returns 0 for both yield and normal return.
+        // Check if the coroutine is dead or suspended using the same
+        // heuristic as Lua 5.0's coroutine.status (lbaselib.c):
+        lua_Debug ar;
+        if (lua_getstack(t.coroutine, 0, &ar) == 0) {
+            // Thread finished normally (dead) — no active frames.
+            // Discard any return values the thread may have produced.
+            lua_settop(t.coroutine, 0);
+            t.dead = true;
+        } else {
+            // Thread yielded. Check what it yielded:
+            // - number → WaitTicks(n), resume after n ticks
+            // - lightuserdata → WaitFor(manipulator), sleep until woken
+            i32 wait_ticks = 1;
+            if (lua_gettop(t.coroutine) > 0) {
+                if (lua_type(t.coroutine, -1) == LUA_TNUMBER) {
+                    wait_ticks = std::max(
+                        1,
+                        static_cast<i32>(lua_tonumber(t.coroutine, -1)));
+                } else if (lua_type(t.coroutine, -1) == LUA_TLIGHTUSERDATA) {
+                    // WaitFor(waitable) — store thread ref on
+                    // waitable, sleep until it completes
+                    auto* waitable = static_cast<Waitable*>(
+                        lua_touserdata(t.coroutine, -1));
+                    waitable->set_waiting_thread_ref(t.lua_ref);
+                    lua_settop(t.coroutine, 0);
+                    t.wait_until_tick = INT32_MAX;
+                    return;
+                }
+            }
+            lua_settop(t.coroutine, 0); // clear yielded values
+            t.wait_until_tick =
+                static_cast<i32>(current_tick) + wait_ticks;
+        }
+    } else {
+        // Thread errored
+        const char* err = lua_tostring(t.coroutine, -1);
+        spdlog::warn("Thread error: {} [forked at {}]",
+                     err ? err : "(unknown)",
+                     t.source.empty() ? "?" : t.source);
+        t.dead = true;
+    }
+}
+
 size_t ThreadManager::active_count() const {
     size_t count = 0;
     for (const auto& t : threads_) {
@@ -10,11 +10,20 @@ struct lua_Debug;
 
 namespace osc::sim {
 
+/// Scheduling class of a thread under the tick budget.
+enum class ThreadClass : u8 {
+    Critical,   ///< unit scripts, weapons, callbacks: always resumed when due
+    Deferrable, ///< AI brains, platoon loops, analysis: run within the budget
+};
+
 struct ThreadEntry {
     lua_State* coroutine = nullptr;
     int lua_ref = -2;       // LUA_NOREF — no registry ref yet
     i32 wait_until_tick = 0; // Tick at which to resume (0 = resume next tick)
     bool dead = false;
+    ThreadClass cls = ThreadClass::Critical;
+    bool preempted = false; // sliced mid-execution at the budget (not a yield)
+    u32 deferred_ticks = 0; // consecutive due ticks skipped for budget
     std::string source;     // Debug: where this thread was forked from
 };
 
@@ -26,12 +35,40 @@ public:
     // initialization.  A non-zero budget kills those threads before they finish.
     static constexpr i32 DEFAULT_INSTRUCTION_BUDGET = 0;
 
+    /// Per-tick instruction budget shared by deferrable threads (0 = no
+    /// governor: every due thread runs to its next yield, in fork order).
+    /// Counted in VM instructions, not wall time, so slicing is identical
+    /// on every machine and replay.
+    static constexpr u32 DEFAULT_TICK_BUDGET = 4000000;
+
+    /// A due deferrable thread waits at most this many ticks for budget;
+    /// after that it gets MIN_SLICE instructions even over the budget.
+    static constexpr u32 DEFAULT_MAX_DEFERRAL = 3;
+    static constexpr u32 MIN_SLICE = 100000;
+
+    /// Hook granularity for budget accounting. Every resume of a
+    /// deferrable thread is also charged one quantum up front, which
+    /// bounds the instructions run between the last hook and its yield.
+    static constexpr u32 QUANTUM = 1000;
+
+    /// Budget accounting of the last resume_all().
+    struct TickStats {
+        u32 resumed = 0;                 ///< threads resumed, either class
+        u64 deferrable_instructions = 0; ///< charged to deferrable threads
+        u32 deferrable_resumed = 0;
+        u32 preempted = 0;    ///< sliced at the budget, continue next tick
+        u32 deferred = 0;     ///< due but not resumed this tick
+        u32 max_deferral = 0; ///< longest wait of a thread resumed this tick
+    };
+
     explicit ThreadManager(lua_State* L);
 
     /// ForkThread: creates a coroutine from the function at stack position 1.
     /// Expects stack: [1]=function, [2..n]=args.
     /// Returns a wrapper table with Destroy() support (like CThread).
-    int fork_thread(lua_State* L);
+    /// Threads forked from AI scripts (see is_deferrable_source) are
+    /// deferrable whatever `cls` says.
+    int fork_thread(lua_State* L, ThreadClass cls = ThreadClass::Critical);
 
     /// Kill a thread by its registry ref.
     void kill_thread(int ref);
@@ -40,7 +77,11 @@ public:
     /// so thread wrapper Destroy() can find it.
     void register_in_registry(lua_State* L);
 
-    /// Resume all eligible threads for the given tick.
+    /// Resume all eligible threads for the given tick. Critical threads
+    /// run first, in fork order; then deferrable ones, longest-deferred
+    /// first, until the tick budget is spent. A deferrable thread that
+    /// hits the budget is preempted and continues where it stopped on a
+    /// later tick.
     void resume_all(u32 current_tick);
 
     /// Number of active (non-dead) threads.
@@ -52,8 +93,19 @@ public:
 
     /// Set the maximum number of Lua VM instructions per coroutine resume.
     /// Set to 0 to disable the instruction limit.
+    /// Not applied to deferrable threads while the tick governor is on.
     void set_instruction_budget(i32 budget) { instruction_budget_ = budget; }
 
+    void set_tick_budget(u32 instructions) { tick_budget_ = instructions; }
+    u32 tick_budget() const { return tick_budget_; }
+    void set_max_deferral(u32 ticks) { max_deferral_ = ticks; }
+    u32 max_deferral() const { return max_deferral_; }
+    const TickStats& last_tick_stats() const { return tick_stats_; }
+
+    /// True for chunk names of AI brain, platoon and AI library scripts
+    /// ("@/lua/AI/...", "@/lua/aibrain.lua", "@/lua/platoon.lua", ...).
+    static bool is_deferrable_source(const std::string& source);
+
 private:
     lua_State* L_;
     std::vector<ThreadEntry> threads_;
@@ -61,13 +113,30 @@ private:
     bool resuming_ = false; // true while inside resume_all loop
     i32 instruction_budget_ = DEFAULT_INSTRUCTION_BUDGET;
 
+    // Tick governor state; slice_* are valid while a deferrable thread runs
+    u32 tick_budget_ = DEFAULT_TICK_BUDGET;
+    u32 max_deferral_ = DEFAULT_MAX_DEFERRAL;
+    TickStats tick_stats_;
+    u64 slice_used_ = 0;
+    u64 slice_limit_ = 0;
+    bool slice_preempted_ = false;
+    std::vector<size_t> deferrable_queue_;
+
     void cleanup_dead_threads();
 
+    /// Resume one due thread and record how it stopped. `slice` > 0 runs
+    /// it under the governor hook with that many instructions.
+    void resume_thread(ThreadEntry& t, u32 current_tick, u64 slice);
+
     /// Create and cache the shared metatable for thread wrapper tables.
     static void create_thread_metatable(lua_State* L);
 
     /// Hook callback fired when a coroutine exceeds its instruction budget.
     static void instruction_hook(lua_State* L, lua_Debug* ar);
+
+    /// Count hook for deferrable threads: charges QUANTUM per call and
+    /// yields the coroutine once its slice is spent (when yieldable).
+    static void governor_hook(lua_State* L, lua_Debug* ar);
 };
 
 } // namespace osc::sim
@@ -1,6 +1,7 @@
 #include "sim/unit.hpp"
 #include "sim/bone_data.hpp"
 #include "sim/entity_registry.hpp"
+#include "sim/formation.hpp"
 #include "sim/manipulator.hpp"
 #include "sim/sim_state.hpp"
 #include "sim/thread_manager.hpp"
@@ -29,30 +30,79 @@ Weapon* Unit::get_weapon(i32 index) {
     return weapons_[index].get();
 }
 
-void Unit::push_command(const UnitCommand& cmd, bool clear_existing) {
+void Unit::add_category(std::string cat) {
+    if (categories_.insert(std::move(cat)).second) {
+        if (auto* reg = registry()) reg->notify_categories_changed(*this);
+    }
+}
+
+UnitEconomy& Unit::edit_economy() {
+    if (auto* reg = registry()) reg->notify_economy_changed(*this);
+    return economy_;
+}
+
+EconomyFlow Unit::economy_flow() const {
+    EconomyFlow flow;
+    if (economy_.production_active) {
+        flow.mass_income = EconomyFlow::to_fixed(economy_.production_mass);
+        flow.energy_income = EconomyFlow::to_fixed(economy_.production_energy);
+    }
+    f64 energy_requested = 0.0;
+    if (economy_.consumption_active) {
+        flow.mass_requested = EconomyFlow::to_fixed(economy_.consumption_mass);
+        energy_requested = economy_.consumption_energy;
+    }
+    i64 maintenance = 0;
+    if (economy_.maintenance_active && economy_.energy_maintenance_override >= 0.0)
+        maintenance = EconomyFlow::to_fixed(economy_.energy_maintenance_override);
+    flow.energy_requested = EconomyFlow::to_fixed(energy_requested) + maintenance;
+    // Storage contribution always counted
+    flow.mass_storage = EconomyFlow::to_fixed(economy_.storage_mass);
+    flow.energy_storage = EconomyFlow::to_fixed(economy_.storage_energy);
+    return flow;
+}
+
+void Unit::push_command(CommandStore& store, const UnitCommand& cmd,
+                        bool clear_existing) {
     // Note: block_command_queue_ is a UI-only flag in FA's original engine.
     // Issue*() C++ functions always bypass it; only the player input handler
     // respects it.  We store the flag for IsUnitState queries but do NOT
     // block push_command here.
-    if (clear_existing) {
-        command_queue_.clear();
-        navigator_.abort_move();
-    }
-    command_queue_.push_back(cmd);
+    if (clear_existing) clear_commands();
+    command_queue_.push_back(store, cmd);
+}
+
+void Unit::push_command(const CommandGroup& group, bool clear_existing) {
+    if (clear_existing) clear_commands();
+    command_queue_.push_back(group);
 }
 
 void Unit::clear_queued_commands() {
     // Keep the front command (currently executing), remove the rest
-    if (command_queue_.size() > 1) {
-        auto front = command_queue_.front();
-        command_queue_.clear();
-        command_queue_.push_back(front);
-    }
+    command_queue_.truncate(1);
+    u32 front_id = command_queue_.empty() ? 0 : command_queue_.front().command_id;
+    std::erase_if(formation_orders_, [front_id](const FormationOrder& o) {
+        return o.command_id != front_id;
+    });
 }
 
 void Unit::clear_commands(const char*) {
     command_queue_.clear();
     navigator_.abort_move();
+    formation_orders_.clear();
+    formation_leg_ = 0;
+}
+
+void Unit::set_formation_order(u32 command_id, f32 speed_cap,
+                               std::vector<Vector3> path) {
+    if (command_id == 0) return;
+    // Drop legs whose commands have left the queue
+    std::erase_if(formation_orders_, [this](const FormationOrder& o) {
+        for (const auto& c : command_queue_)
+            if (c.command_id == o.command_id) return false;
+        return true;
+    });
+    formation_orders_.push_back({command_id, speed_cap, std::move(path)});
 }
 
 // --- Adjacency helpers ---
@@ -84,9 +134,8 @@ bool call_on_adjacent_to(lua_State* L, int self_ref, int other_ref, int trigger_
                          u32 self_id, EntityRegistry& registry) {
     lua_rawgeti(L, LUA_REGISTRYINDEX, self_ref);
     int tbl = lua_gettop(L);
-    lua_pushstring(L, "OnAdjacentTo");
-    lua_gettable(L, tbl);
-    if (lua_isfunction(L, -1)) {
+    if (LuaCallbackCache::push_hook(L, tbl, registry.find(self_id),
+                                    UnitHook::OnAdjacentTo)) {
         lua_pushvalue(L, tbl);
         lua_rawgeti(L, LUA_REGISTRYINDEX, other_ref);
         lua_rawgeti(L, LUA_REGISTRYINDEX, trigger_ref);
@@ -94,8 +143,6 @@ bool call_on_adjacent_to(lua_State* L, int self_ref, int other_ref, int trigger_
             spdlog::warn("OnAdjacentTo error: {}", lua_tostring(L, -1));
             lua_pop(L, 1);
         }
-    } else {
-        lua_pop(L, 1);
     }
     lua_pop(L, 1); // tbl
     auto* e = registry.find(self_id);
@@ -114,9 +161,12 @@ void Unit::fire_adjacency_callbacks(EntityRegistry& registry, lua_State* L) {
     // (e.g., factory center at 200 has skirt edge at 204, 4 units away).
     // Use 12.0 to cover largest FA structures (experimental: ~8 footprint + ~8 skirt offset).
     constexpr f32 expand = 12.0f;
+    SpatialFilter own_units;
+    own_units.kinds = spatial_kind::UNIT;
+    own_units.only_army = army();
     auto candidates = registry.collect_in_rect(
         my_skirt.x0 - expand, my_skirt.z0 - expand,
-        my_skirt.x1 + expand, my_skirt.z1 + expand);
+        my_skirt.x1 + expand, my_skirt.z1 + expand, own_units);
 
     u32 my_id = entity_id();
 
@@ -197,12 +247,13 @@ void Unit::begin_air_crash(f32 crash_dmg) {
     crash_spin_rate_ = (static_cast<f32>(entity_id() % 100) / 100.0f - 0.5f) * 4.0f;
     clear_commands();
     set_do_not_target(true);
-    economy_.consumption_mass = 0;
-    economy_.consumption_energy = 0;
-    economy_.consumption_active = false;
-    economy_.production_mass = 0;
-    economy_.production_energy = 0;
-    economy_.production_active = false;
+    auto& econ = edit_economy();
+    econ.consumption_mass = 0;
+    econ.consumption_energy = 0;
+    econ.consumption_active = false;
+    econ.production_mass = 0;
+    econ.production_energy = 0;
+    econ.production_active = false;
 }
 
 void Unit::tick_dying(f32 dt, const map::Terrain* terrain) {
@@ -249,10 +300,31 @@ void Unit::tick_dying(f32 dt, const map::Terrain* terrain) {
     }
 }
 
-bool Unit::nav_update(f64 dt, const map::Terrain* terrain) {
+namespace {
+
+/// Commands that move with Navigator::pursue().
+bool chases_target(CommandType type) {
+    switch (type) {
+    case CommandType::Attack:
+    case CommandType::Reclaim:
+    case CommandType::Repair:
+    case CommandType::Capture:
+    case CommandType::Guard:
+    case CommandType::TransportLoad:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+bool Unit::nav_update(f64 dt, const map::Terrain* terrain, f32 speed_cap) {
     if (is_air_unit())
         return navigator_.update_air(*this, dt, terrain);
-    bool result = navigator_.update(*this, effective_speed(), dt, terrain);
+    f32 speed = effective_speed();
+    if (speed_cap > 0) speed = std::min(speed, speed_cap);
+    bool result = navigator_.update(*this, speed, dt, terrain);
 
     // Sub units: smooth transition to dive depth below water surface
     if (terrain && layer_ == "Sub") {
@@ -319,18 +391,38 @@ void Unit::update(f64 dt, SimContext& ctx) {
             command_queue_.pop_front();
             continue;
 
-        case CommandType::Move:
-            if (!navigator_.is_moving() ||
-                navigator_.goal().x != cmd.target_pos.x ||
-                navigator_.goal().z != cmd.target_pos.z) {
-                navigator_.set_goal(cmd.target_pos, ctx.pathfinder, position(), layer_,
-                                    naval_draft_, is_amphibious() || is_hover());
+        case CommandType::Move: {
+            // Formation leg: follow the precomputed slot path at group speed
+            auto leg = std::find_if(formation_orders_.begin(), formation_orders_.end(),
+                                    [&](const FormationOrder& o) {
+                                        return o.command_id == cmd.command_id;
+                                    });
+            if (leg != formation_orders_.end()) {
+                // Earlier orders may have left the unit off the planned start
+                if (!join_formation_leg(leg->path, position(), ctx.pathfinder,
+                                        layer_, naval_draft_,
+                                        is_amphibious() || is_hover()))
+                    goto done_commands; // search budget spent; retry next tick
+                navigator_.follow_path(std::move(leg->path));
+                formation_leg_ = leg->command_id;
+                formation_speed_ = leg->speed_cap;
+                formation_orders_.erase(leg);
+            } else if (formation_leg_ != cmd.command_id || cmd.command_id == 0) {
+                formation_leg_ = 0;
+                if (!navigator_.is_moving() ||
+                    navigator_.goal().x != cmd.target_pos.x ||
+                    navigator_.goal().z != cmd.target_pos.z) {
+                    navigator_.set_goal(cmd.target_pos, ctx.pathfinder, position(), layer_,
+                                        naval_draft_, is_amphibious() || is_hover());
+                }
             }
-            if (!nav_update(dt, ctx.terrain)) {
+            if (!nav_update(dt, ctx.terrain, formation_leg_ ? formation_speed_ : 0)) {
+                formation_leg_ = 0;
                 command_queue_.pop_front();
                 continue;
             }
             goto done_commands; // Still moving — break out of while
+        }
 
         case CommandType::Attack: {
             // Attack: move toward target if out of weapon range, else stop
@@ -363,8 +455,8 @@ void Unit::update(f64 dt, SimContext& ctx) {
                 if (!navigator_.is_moving() ||
                     navigator_.goal().x != target->position().x ||
                     navigator_.goal().z != target->position().z) {
-                    navigator_.set_goal(target->position(), ctx.pathfinder, position(), layer_,
-                                        naval_draft_, is_amphibious() || is_hover());
+                    navigator_.pursue(target->position(), ctx.pathfinder, position(), layer_,
+                                      naval_draft_, is_amphibious() || is_hover());
                 }
                 nav_update(dt, ctx.terrain);
             } else {
@@ -431,9 +523,7 @@ void Unit::update(f64 dt, SimContext& ctx) {
             }
             if (!nav_update(dt, ctx.terrain)) {
                 // Reached patrol point — cycle to back of queue
-                auto finished = cmd;
-                command_queue_.pop_front();
-                command_queue_.push_back(finished);
+                command_queue_.rotate();
                 continue;
             }
             goto done_commands;
@@ -461,8 +551,8 @@ void Unit::update(f64 dt, SimContext& ctx) {
                 if (!navigator_.is_moving() ||
                     navigator_.goal().x != target->position().x ||
                     navigator_.goal().z != target->position().z) {
-                    navigator_.set_goal(target->position(), ctx.pathfinder, position(), layer_,
-                                        naval_draft_, is_amphibious() || is_hover());
+                    navigator_.pursue(target->position(), ctx.pathfinder, position(), layer_,
+                                      naval_draft_, is_amphibious() || is_hover());
                 }
                 navigator_.update(*this, effective_speed(), dt, ctx.terrain);
                 goto done_commands;
@@ -511,11 +601,12 @@ void Unit::update(f64 dt, SimContext& ctx) {
                 reclaim_rate_ = static_cast<f32>(1.0 / reclaim_time);
 
                 // Set production rates (resources gained by reclaiming)
-                economy_.production_mass =
+                auto& econ = edit_economy();
+                econ.production_mass =
                     max_mass * static_cast<f64>(reclaim_rate_);
-                economy_.production_energy =
+                econ.production_energy =
                     max_energy * static_cast<f64>(reclaim_rate_);
-                economy_.production_active = true;
+                econ.production_active = true;
 
                 spdlog::info("Reclaim start: entity #{} reclaiming #{} "
                              "(mass={:.0f}, energy={:.0f}, time={:.1f}s)",
@@ -575,8 +666,8 @@ void Unit::update(f64 dt, SimContext& ctx) {
                 if (!navigator_.is_moving() ||
                     navigator_.goal().x != rtarget->position().x ||
                     navigator_.goal().z != rtarget->position().z) {
-                    navigator_.set_goal(rtarget->position(), ctx.pathfinder, position(), layer_,
-                                        naval_draft_, is_amphibious() || is_hover());
+                    navigator_.pursue(rtarget->position(), ctx.pathfinder, position(), layer_,
+                                      naval_draft_, is_amphibious() || is_hover());
                 }
                 navigator_.update(*this, effective_speed(), dt, ctx.terrain);
                 goto done_commands;
@@ -629,8 +720,8 @@ void Unit::update(f64 dt, SimContext& ctx) {
                 if (!navigator_.is_moving() ||
                     navigator_.goal().x != ctarget->position().x ||
                     navigator_.goal().z != ctarget->position().z) {
-                    navigator_.set_goal(ctarget->position(), ctx.pathfinder, position(), layer_,
-                                        naval_draft_, is_amphibious() || is_hover());
+                    navigator_.pursue(ctarget->position(), ctx.pathfinder, position(), layer_,
+                                      naval_draft_, is_amphibious() || is_hover());
                 }
                 navigator_.update(*this, effective_speed(), dt, ctx.terrain);
                 goto done_commands;
@@ -682,8 +773,8 @@ void Unit::update(f64 dt, SimContext& ctx) {
                 if (!navigator_.is_moving() ||
                     navigator_.goal().x != target->position().x ||
                     navigator_.goal().z != target->position().z) {
-                    navigator_.set_goal(target->position(), ctx.pathfinder, position(), layer_,
-                                        naval_draft_, is_amphibious() || is_hover());
+                    navigator_.pursue(target->position(), ctx.pathfinder, position(), layer_,
+                                      naval_draft_, is_amphibious() || is_hover());
                 }
                 navigator_.update(*this, effective_speed(), dt, ctx.terrain);
             } else {
@@ -707,11 +798,12 @@ void Unit::update(f64 dt, SimContext& ctx) {
                         work_progress_ = build_target->fraction_complete();
 
                         if (build_time_ > 0 && build_rate_ > 0) {
-                            economy_.consumption_mass =
+                            auto& econ = edit_economy();
+                            econ.consumption_mass =
                                 build_cost_mass_ * static_cast<f64>(build_rate_) / build_time_;
-                            economy_.consumption_energy =
+                            econ.consumption_energy =
                                 build_cost_energy_ * static_cast<f64>(build_rate_) / build_time_;
-                            economy_.consumption_active = true;
+                            econ.consumption_active = true;
                         }
 
                         spdlog::info("Guard assist: entity #{} assisting #{} "
@@ -881,9 +973,9 @@ void Unit::update(f64 dt, SimContext& ctx) {
                 if (!navigator_.is_moving() ||
                     navigator_.goal().x != transport->position().x ||
                     navigator_.goal().z != transport->position().z) {
-                    navigator_.set_goal(transport->position(), ctx.pathfinder,
-                                        position(), layer_,
-                                        naval_draft_, is_amphibious() || is_hover());
+                    navigator_.pursue(transport->position(), ctx.pathfinder,
+                                      position(), layer_,
+                                      naval_draft_, is_amphibious() || is_hover());
                 }
                 navigator_.update(*this, effective_speed(), dt, ctx.terrain);
                 goto done_commands;
@@ -944,7 +1036,7 @@ void Unit::update(f64 dt, SimContext& ctx) {
                 weapons_[0]->fire_cooldown = 0;
                 weapons_[0]->try_fire(*this, registry, L);
             }
-            call_lua_method(L, "OnSiloBuildFinish");
+            call_lua_method(L, UnitHook::OnSiloBuildFinish);
             command_queue_.pop_front();
             continue;
         }
@@ -961,7 +1053,7 @@ void Unit::update(f64 dt, SimContext& ctx) {
                 weapons_[0]->fire_cooldown = 0;
                 weapons_[0]->try_fire(*this, registry, L);
             }
-            call_lua_method(L, "OnSiloBuildFinish");
+            call_lua_method(L, UnitHook::OnSiloBuildFinish);
             command_queue_.pop_front();
             continue;
         }
@@ -1013,7 +1105,7 @@ void Unit::update(f64 dt, SimContext& ctx) {
             }
             auto* target = registry.find(cmd.target_id);
             if (!target || target->destroyed() || !target->is_unit()) {
-                call_lua_method(L, "OnStopSacrifice");
+                call_lua_method(L, UnitHook::OnStopSacrifice);
                 command_queue_.pop_front();
                 continue;
             }
@@ -1033,7 +1125,7 @@ void Unit::update(f64 dt, SimContext& ctx) {
                 // Fire OnStartSacrifice on first tick
                 if (!has_unit_state("Sacrificing")) {
                     set_unit_state("Sacrificing", true);
-                    call_lua_method_with_entity(L, "OnStartSacrifice", target);
+                    call_lua_method_with_entity(L, UnitHook::OnStartSacrifice, target);
                 }
                 goto done_commands;
             }
@@ -1048,7 +1140,7 @@ void Unit::update(f64 dt, SimContext& ctx) {
                 target_unit->set_work_progress(new_progress);
             }
             // Fire OnStopSacrifice then kill self
-            call_lua_method_with_entity(L, "OnStopSacrifice", target);
+            call_lua_method_with_entity(L, UnitHook::OnStopSacrifice, target);
             set_unit_state("Sacrificing", false);
             set_health(0);
             mark_destroyed();
@@ -1063,7 +1155,7 @@ void Unit::update(f64 dt, SimContext& ctx) {
             // Teleport: instant move to target position
             // FA handles energy drain via economy events in Lua; we just move
             set_position(cmd.target_pos);
-            call_lua_method(L, "OnTeleportUnit");
+            call_lua_method(L, UnitHook::OnTeleportUnit);
             command_queue_.pop_front();
             continue;
         }
@@ -1080,9 +1172,7 @@ void Unit::update(f64 dt, SimContext& ctx) {
             navigator_.update(*this, effective_speed(), dt, ctx.terrain);
             if (!navigator_.is_moving()) {
                 // Reached waypoint — cycle to end of queue
-                auto finished = cmd;
-                command_queue_.pop_front();
-                command_queue_.push_back(finished);
+                command_queue_.rotate();
             }
             goto done_commands;
         }
@@ -1094,6 +1184,12 @@ void Unit::update(f64 dt, SimContext& ctx) {
     }
 done_commands:
 
+    // A chase whose target died, or that gave way to a stationary command,
+    // leaves its search behind; free it rather than hold it while idle
+    if (navigator_.has_pursuit_state() &&
+        (command_queue_.empty() || !chases_target(command_queue_.front().type)))
+        navigator_.end_pursuit();
+
     // Amphibious layer transition: auto-switch Land↔Water based on terrain
     if (is_amphibious() && !dying_ && ctx.terrain) {
         f32 terrain_h = ctx.terrain->get_terrain_height(position().x, position().z);
@@ -1109,7 +1205,11 @@ done_commands:
     if (is_air_unit() && !dying_ && navigator_.is_moving()) {
         constexpr f32 SEPARATION_RADIUS = 8.0f;
         constexpr f32 SEPARATION_FORCE = 3.0f;
-        auto nearby = registry.collect_in_radius(position().x, position().z, SEPARATION_RADIUS);
+        SpatialFilter own_units;
+        own_units.kinds = spatial_kind::UNIT;
+        own_units.only_army = army();
+        auto nearby = registry.collect_in_radius(position().x, position().z,
+                                                 SEPARATION_RADIUS, own_units);
         f32 repulse_x = 0, repulse_z = 0;
         for (u32 nid : nearby) {
             if (nid == entity_id()) continue;
@@ -1166,6 +1266,9 @@ weapons_only:
 
 bool Unit::start_build(const UnitCommand& cmd, EntityRegistry& registry,
                        lua_State* L) {
+    // cmd is the front of this unit's queue, so the queue holds its store
+    const std::string& bp_id = cmd.blueprint_id(*command_queue_.store());
+
     // Call __osc_create_building_unit from Lua registry
     lua_pushstring(L, "__osc_create_building_unit");
     lua_rawget(L, LUA_REGISTRYINDEX);
@@ -1175,7 +1278,7 @@ bool Unit::start_build(const UnitCommand& cmd, EntityRegistry& registry,
         return false;
     }
 
-    lua_pushstring(L, cmd.blueprint_id.c_str());
+    lua_pushstring(L, bp_id.c_str());
     lua_pushnumber(L, army() + 1); // 1-based for Lua
     bool build_at_self = (cmd.type == CommandType::BuildFactory ||
                           cmd.type == CommandType::Upgrade);
@@ -1212,7 +1315,7 @@ bool Unit::start_build(const UnitCommand& cmd, EntityRegistry& registry,
     lua_pushstring(L, "__blueprints");
     lua_rawget(L, LUA_GLOBALSINDEX);
     if (lua_istable(L, -1)) {
-        lua_pushstring(L, cmd.blueprint_id.c_str());
+        lua_pushstring(L, bp_id.c_str());
         lua_gettable(L, -2);
         if (lua_istable(L, -1)) {
             lua_pushstring(L, "Economy");
@@ -1244,16 +1347,17 @@ bool Unit::start_build(const UnitCommand& cmd, EntityRegistry& registry,
 
     spdlog::info("start_build: entity #{} building {} (target #{}), "
                  "BuildTime={:.0f} BuildRate={:.1f} CostMass={:.0f} CostEnergy={:.0f}",
-                 entity_id(), cmd.blueprint_id, build_target_id_,
+                 entity_id(), bp_id, build_target_id_,
                  build_time_, build_rate_, build_cost_mass_, build_cost_energy_);
 
     // Set economy drain on builder
     if (build_time_ > 0 && build_rate_ > 0) {
-        economy_.consumption_mass =
+        auto& econ = edit_economy();
+        econ.consumption_mass =
             build_cost_mass_ * static_cast<f64>(build_rate_) / build_time_;
-        economy_.consumption_energy =
+        econ.consumption_energy =
             build_cost_energy_ * static_cast<f64>(build_rate_) / build_time_;
-        economy_.consumption_active = true;
+        econ.consumption_active = true;
     }
 
     // Set UnitBeingBuilt and UnitBuildOrder on builder Lua table
@@ -1280,9 +1384,8 @@ bool Unit::start_build(const UnitCommand& cmd, EntityRegistry& registry,
     if (lua_table_ref() >= 0) {
         lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
         int builder_tbl = lua_gettop(L);
-        lua_pushstring(L, "OnStartBuild");
-        lua_gettable(L, builder_tbl);
-        if (lua_isfunction(L, -1)) {
+        if (LuaCallbackCache::push_hook(L, builder_tbl, this,
+                                        UnitHook::OnStartBuild)) {
             lua_pushvalue(L, builder_tbl); // self
             lua_pushvalue(L, target_tbl);  // target
             lua_pushstring(L, order_str);
@@ -1290,16 +1393,13 @@ bool Unit::start_build(const UnitCommand& cmd, EntityRegistry& registry,
                 spdlog::warn("OnStartBuild error: {}", lua_tostring(L, -1));
                 lua_pop(L, 1);
             }
-        } else {
-            lua_pop(L, 1);
         }
         lua_pop(L, 1); // builder_tbl
     }
 
     // Call target:OnStartBeingBuilt(builder, layer)
-    lua_pushstring(L, "OnStartBeingBuilt");
-    lua_gettable(L, target_tbl);
-    if (lua_isfunction(L, -1)) {
+    if (LuaCallbackCache::push_hook(L, target_tbl, registry.find(build_target_id_),
+                                    UnitHook::OnStartBeingBuilt)) {
         lua_pushvalue(L, target_tbl); // self
         if (lua_table_ref() >= 0) {
             lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
@@ -1311,8 +1411,6 @@ bool Unit::start_build(const UnitCommand& cmd, EntityRegistry& registry,
             spdlog::warn("OnStartBeingBuilt error: {}", lua_tostring(L, -1));
             lua_pop(L, 1);
         }
-    } else {
-        lua_pop(L, 1);
     }
 
     lua_pop(L, 2); // pop entity_id + target_tbl from create_building_unit
@@ -1382,9 +1480,8 @@ void Unit::finish_build(EntityRegistry& registry, lua_State* L, bool success,
             if (target->lua_table_ref() >= 0) {
                 lua_rawgeti(L, LUA_REGISTRYINDEX, target->lua_table_ref());
                 int target_tbl = lua_gettop(L);
-                lua_pushstring(L, "OnStopBeingBuilt");
-                lua_gettable(L, target_tbl);
-                if (lua_isfunction(L, -1)) {
+                if (LuaCallbackCache::push_hook(L, target_tbl, target,
+                                                UnitHook::OnStopBeingBuilt)) {
                     lua_pushvalue(L, target_tbl); // self
                     if (lua_table_ref() >= 0) {
                         lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
@@ -1397,8 +1494,6 @@ void Unit::finish_build(EntityRegistry& registry, lua_State* L, bool success,
                                      lua_tostring(L, -1));
                         lua_pop(L, 1);
                     }
-                } else {
-                    lua_pop(L, 1);
                 }
                 lua_pop(L, 1); // target_tbl
             }
@@ -1452,9 +1547,8 @@ void Unit::finish_build(EntityRegistry& registry, lua_State* L, bool success,
             target->lua_table_ref() >= 0) {
             lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
             int builder_tbl = lua_gettop(L);
-            lua_pushstring(L, "OnStopBuild");
-            lua_gettable(L, builder_tbl);
-            if (lua_isfunction(L, -1)) {
+            if (LuaCallbackCache::push_hook(L, builder_tbl, this,
+                                            UnitHook::OnStopBuild)) {
                 lua_pushvalue(L, builder_tbl);
                 lua_rawgeti(L, LUA_REGISTRYINDEX, target->lua_table_ref());
                 if (lua_pcall(L, 2, 0, 0) != 0) {
@@ -1462,8 +1556,6 @@ void Unit::finish_build(EntityRegistry& registry, lua_State* L, bool success,
                                  lua_tostring(L, -1));
                     lua_pop(L, 1);
                 }
-            } else {
-                lua_pop(L, 1);
             }
             lua_pop(L, 1); // builder_tbl
         }
@@ -1475,17 +1567,14 @@ void Unit::finish_build(EntityRegistry& registry, lua_State* L, bool success,
         if (lua_table_ref() >= 0) {
             lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
             int builder_tbl = lua_gettop(L);
-            lua_pushstring(L, "OnFailedToBuild");
-            lua_gettable(L, builder_tbl);
-            if (lua_isfunction(L, -1)) {
+            if (LuaCallbackCache::push_hook(L, builder_tbl, this,
+                                            UnitHook::OnFailedToBuild)) {
                 lua_pushvalue(L, builder_tbl);
                 if (lua_pcall(L, 1, 0, 0) != 0) {
                     spdlog::warn("OnFailedToBuild error: {}",
                                  lua_tostring(L, -1));
                     lua_pop(L, 1);
                 }
-            } else {
-                lua_pop(L, 1);
             }
             lua_pop(L, 1); // builder_tbl
         }
@@ -1505,9 +1594,10 @@ void Unit::finish_build(EntityRegistry& registry, lua_State* L, bool success,
     }
 
     // Clear builder's economy drain
-    economy_.consumption_mass = 0;
-    economy_.consumption_energy = 0;
-    economy_.consumption_active = false;
+    auto& econ = edit_economy();
+    econ.consumption_mass = 0;
+    econ.consumption_energy = 0;
+    econ.consumption_active = false;
 
     build_target_id_ = 0;
     build_time_ = 0;
@@ -1517,9 +1607,10 @@ void Unit::finish_build(EntityRegistry& registry, lua_State* L, bool success,
 }
 
 void Unit::stop_assisting() {
-    economy_.consumption_mass = 0;
-    economy_.consumption_energy = 0;
-    economy_.consumption_active = false;
+    auto& econ = edit_economy();
+    econ.consumption_mass = 0;
+    econ.consumption_energy = 0;
+    econ.consumption_active = false;
     build_target_id_ = 0;
     build_time_ = 0;
     build_cost_mass_ = 0;
@@ -1554,9 +1645,10 @@ void Unit::stop_reclaiming() {
     // (assisters don't set production rates, so nothing to clear)
     if (reclaim_target_id_ != 0 && economy_.production_active &&
         reclaim_rate_ > 0) {
-        economy_.production_mass = 0;
-        economy_.production_energy = 0;
-        economy_.production_active = false;
+        auto& econ = edit_economy();
+        econ.production_mass = 0;
+        econ.production_energy = 0;
+        econ.production_active = false;
     }
     reclaim_target_id_ = 0;
     reclaim_rate_ = 0;
@@ -1571,17 +1663,14 @@ void Unit::call_on_reclaimed(u32 target_id, EntityRegistry& registry,
     if (target->lua_table_ref() >= 0 && lua_table_ref() >= 0) {
         lua_rawgeti(L, LUA_REGISTRYINDEX, target->lua_table_ref());
         int target_tbl = lua_gettop(L);
-        lua_pushstring(L, "OnReclaimed");
-        lua_gettable(L, target_tbl);
-        if (lua_isfunction(L, -1)) {
+        if (LuaCallbackCache::push_hook(L, target_tbl, target,
+                                        UnitHook::OnReclaimed)) {
             lua_pushvalue(L, target_tbl); // self
             lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
             if (lua_pcall(L, 2, 0, 0) != 0) {
                 spdlog::warn("OnReclaimed error: {}", lua_tostring(L, -1));
                 lua_pop(L, 1);
             }
-        } else {
-            lua_pop(L, 1);
         }
         lua_pop(L, 1); // target_tbl
     }
@@ -1705,11 +1794,12 @@ bool Unit::start_repair(const UnitCommand& cmd, EntityRegistry& registry,
     repair_target_id_ = cmd.target_id;
 
     // Set economy consumption (same formula as build)
-    economy_.consumption_mass =
+    auto& econ = edit_economy();
+    econ.consumption_mass =
         repair_cost_mass_ * static_cast<f64>(build_rate_) / repair_build_time_;
-    economy_.consumption_energy =
+    econ.consumption_energy =
         repair_cost_energy_ * static_cast<f64>(build_rate_) / repair_build_time_;
-    economy_.consumption_active = true;
+    econ.consumption_active = true;
 
     spdlog::info("start_repair: entity #{} repairing #{} "
                  "(BuildTime={:.0f} BuildRate={:.1f})",
@@ -1720,9 +1810,8 @@ bool Unit::start_repair(const UnitCommand& cmd, EntityRegistry& registry,
     if (lua_table_ref() >= 0 && target->lua_table_ref() >= 0) {
         lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
         int builder_tbl = lua_gettop(L);
-        lua_pushstring(L, "OnStartBuild");
-        lua_gettable(L, builder_tbl);
-        if (lua_isfunction(L, -1)) {
+        if (LuaCallbackCache::push_hook(L, builder_tbl, this,
+                                        UnitHook::OnStartBuild)) {
             lua_pushvalue(L, builder_tbl); // self
             lua_rawgeti(L, LUA_REGISTRYINDEX, target->lua_table_ref());
             lua_pushstring(L, "Repair");
@@ -1731,8 +1820,6 @@ bool Unit::start_repair(const UnitCommand& cmd, EntityRegistry& registry,
                              lua_tostring(L, -1));
                 lua_pop(L, 1);
             }
-        } else {
-            lua_pop(L, 1);
         }
         lua_pop(L, 1); // builder_tbl
     }
@@ -1786,9 +1873,10 @@ void Unit::stop_repairing(lua_State* L, EntityRegistry& registry) {
     repair_cost_energy_ = 0;
 
     // Clear economy drain
-    economy_.consumption_mass = 0;
-    economy_.consumption_energy = 0;
-    economy_.consumption_active = false;
+    auto& econ = edit_economy();
+    econ.consumption_mass = 0;
+    econ.consumption_energy = 0;
+    econ.consumption_active = false;
 
     // Call builder:OnStopBuild(target) — FA handles OnStopRepair inside
     if (target_id != 0 && lua_table_ref() >= 0) {
@@ -1796,9 +1884,8 @@ void Unit::stop_repairing(lua_State* L, EntityRegistry& registry) {
         if (target && !target->destroyed() && target->lua_table_ref() >= 0) {
             lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
             int builder_tbl = lua_gettop(L);
-            lua_pushstring(L, "OnStopBuild");
-            lua_gettable(L, builder_tbl);
-            if (lua_isfunction(L, -1)) {
+            if (LuaCallbackCache::push_hook(L, builder_tbl, this,
+                                            UnitHook::OnStopBuild)) {
                 lua_pushvalue(L, builder_tbl);
                 lua_rawgeti(L, LUA_REGISTRYINDEX, target->lua_table_ref());
                 if (lua_pcall(L, 2, 0, 0) != 0) {
@@ -1806,8 +1893,6 @@ void Unit::stop_repairing(lua_State* L, EntityRegistry& registry) {
                                  lua_tostring(L, -1));
                     lua_pop(L, 1);
                 }
-            } else {
-                lua_pop(L, 1);
             }
             lua_pop(L, 1); // builder_tbl
         }
@@ -1868,9 +1953,10 @@ bool Unit::start_capture(const UnitCommand& cmd, EntityRegistry& registry,
     work_progress_ = 0.0f;
 
     // Set economy: energy-only drain (zero mass to clear any stale value)
-    economy_.consumption_mass = 0;
-    economy_.consumption_energy = capture_energy_cost_ / capture_time_;
-    economy_.consumption_active = true;
+    auto& econ = edit_economy();
+    econ.consumption_mass = 0;
+    econ.consumption_energy = capture_energy_cost_ / capture_time_;
+    econ.consumption_active = true;
 
     spdlog::info("start_capture: entity #{} capturing #{} "
                  "(BuildTime={:.0f} BuildRate={:.1f} captureTime={:.1f}s energy={:.0f})",
@@ -1881,17 +1967,14 @@ bool Unit::start_capture(const UnitCommand& cmd, EntityRegistry& registry,
     if (lua_table_ref() >= 0 && target->lua_table_ref() >= 0) {
         lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
         int self_tbl = lua_gettop(L);
-        lua_pushstring(L, "OnStartCapture");
-        lua_gettable(L, self_tbl);
-        if (lua_isfunction(L, -1)) {
+        if (LuaCallbackCache::push_hook(L, self_tbl, this,
+                                        UnitHook::OnStartCapture)) {
             lua_pushvalue(L, self_tbl);
             lua_rawgeti(L, LUA_REGISTRYINDEX, target->lua_table_ref());
             if (lua_pcall(L, 2, 0, 0) != 0) {
                 spdlog::warn("OnStartCapture error: {}", lua_tostring(L, -1));
                 lua_pop(L, 1);
             }
-        } else {
-            lua_pop(L, 1);
         }
         lua_pop(L, 1); // self_tbl
     }
@@ -1907,9 +1990,8 @@ bool Unit::start_capture(const UnitCommand& cmd, EntityRegistry& registry,
     if (target->lua_table_ref() >= 0 && lua_table_ref() >= 0) {
         lua_rawgeti(L, LUA_REGISTRYINDEX, target->lua_table_ref());
         int target_tbl = lua_gettop(L);
-        lua_pushstring(L, "OnStartBeingCaptured");
-        lua_gettable(L, target_tbl);
-        if (lua_isfunction(L, -1)) {
+        if (LuaCallbackCache::push_hook(L, target_tbl, target,
+                                        UnitHook::OnStartBeingCaptured)) {
             lua_pushvalue(L, target_tbl);
             lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
             if (lua_pcall(L, 2, 0, 0) != 0) {
@@ -1917,8 +1999,6 @@ bool Unit::start_capture(const UnitCommand& cmd, EntityRegistry& registry,
                              lua_tostring(L, -1));
                 lua_pop(L, 1);
             }
-        } else {
-            lua_pop(L, 1);
         }
         lua_pop(L, 1); // target_tbl
     }
@@ -1964,9 +2044,10 @@ bool Unit::progress_capture(f64 dt, EntityRegistry& registry, lua_State* L,
         capture_target_id_ = 0;
         capture_time_ = 0;
         capture_energy_cost_ = 0;
-        economy_.consumption_mass = 0;
-        economy_.consumption_energy = 0;
-        economy_.consumption_active = false;
+        auto& econ = edit_economy();
+        econ.consumption_mass = 0;
+        econ.consumption_energy = 0;
+        econ.consumption_active = false;
         work_progress_ = 0.0f;
 
         spdlog::info("capture complete: entity #{} captured #{}",
@@ -1976,9 +2057,8 @@ bool Unit::progress_capture(f64 dt, EntityRegistry& registry, lua_State* L,
         if (lua_table_ref() >= 0 && target->lua_table_ref() >= 0) {
             lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
             int self_tbl = lua_gettop(L);
-            lua_pushstring(L, "OnStopCapture");
-            lua_gettable(L, self_tbl);
-            if (lua_isfunction(L, -1)) {
+            if (LuaCallbackCache::push_hook(L, self_tbl, this,
+                                            UnitHook::OnStopCapture)) {
                 lua_pushvalue(L, self_tbl);
                 lua_rawgeti(L, LUA_REGISTRYINDEX, target->lua_table_ref());
                 if (lua_pcall(L, 2, 0, 0) != 0) {
@@ -1986,8 +2066,6 @@ bool Unit::progress_capture(f64 dt, EntityRegistry& registry, lua_State* L,
                                  lua_tostring(L, -1));
                     lua_pop(L, 1);
                 }
-            } else {
-                lua_pop(L, 1);
             }
             lua_pop(L, 1); // self_tbl
         }
@@ -2000,9 +2078,8 @@ bool Unit::progress_capture(f64 dt, EntityRegistry& registry, lua_State* L,
         if (target->lua_table_ref() >= 0 && lua_table_ref() >= 0) {
             lua_rawgeti(L, LUA_REGISTRYINDEX, target->lua_table_ref());
             int target_tbl = lua_gettop(L);
-            lua_pushstring(L, "OnCaptured");
-            lua_gettable(L, target_tbl);
-            if (lua_isfunction(L, -1)) {
+            if (LuaCallbackCache::push_hook(L, target_tbl, target,
+                                            UnitHook::OnCaptured)) {
                 lua_pushvalue(L, target_tbl);
                 lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
                 if (lua_pcall(L, 2, 0, 0) != 0) {
@@ -2010,8 +2087,6 @@ bool Unit::progress_capture(f64 dt, EntityRegistry& registry, lua_State* L,
                                  lua_tostring(L, -1));
                     lua_pop(L, 1);
                 }
-            } else {
-                lua_pop(L, 1);
             }
             lua_pop(L, 1); // target_tbl
         }
@@ -2054,9 +2129,10 @@ void Unit::stop_capturing(lua_State* L, EntityRegistry& registry, bool failed) {
     capture_energy_cost_ = 0;
 
     // Clear economy drain
-    economy_.consumption_mass = 0;
-    economy_.consumption_energy = 0;
-    economy_.consumption_active = false;
+    auto& econ = edit_economy();
+    econ.consumption_mass = 0;
+    econ.consumption_energy = 0;
+    econ.consumption_active = false;
     work_progress_ = 0.0f;
 
     if (target_id == 0) return;
@@ -2073,9 +2149,8 @@ void Unit::stop_capturing(lua_State* L, EntityRegistry& registry, bool failed) {
         if (lua_table_ref() >= 0 && target->lua_table_ref() >= 0) {
             lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
             int self_tbl = lua_gettop(L);
-            lua_pushstring(L, "OnFailedCapture");
-            lua_gettable(L, self_tbl);
-            if (lua_isfunction(L, -1)) {
+            if (LuaCallbackCache::push_hook(L, self_tbl, this,
+                                            UnitHook::OnFailedCapture)) {
                 lua_pushvalue(L, self_tbl);
                 lua_rawgeti(L, LUA_REGISTRYINDEX, target->lua_table_ref());
                 if (lua_pcall(L, 2, 0, 0) != 0) {
@@ -2083,8 +2158,6 @@ void Unit::stop_capturing(lua_State* L, EntityRegistry& registry, bool failed) {
                                  lua_tostring(L, -1));
                     lua_pop(L, 1);
                 }
-            } else {
-                lua_pop(L, 1);
             }
             lua_pop(L, 1); // self_tbl
         }
@@ -2097,9 +2170,8 @@ void Unit::stop_capturing(lua_State* L, EntityRegistry& registry, bool failed) {
         if (target->lua_table_ref() >= 0 && lua_table_ref() >= 0) {
             lua_rawgeti(L, LUA_REGISTRYINDEX, target->lua_table_ref());
             int target_tbl = lua_gettop(L);
-            lua_pushstring(L, "OnFailedBeingCaptured");
-            lua_gettable(L, target_tbl);
-            if (lua_isfunction(L, -1)) {
+            if (LuaCallbackCache::push_hook(L, target_tbl, target,
+                                            UnitHook::OnFailedBeingCaptured)) {
                 lua_pushvalue(L, target_tbl);
                 lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
                 if (lua_pcall(L, 2, 0, 0) != 0) {
@@ -2107,8 +2179,6 @@ void Unit::stop_capturing(lua_State* L, EntityRegistry& registry, bool failed) {
                                  lua_tostring(L, -1));
                     lua_pop(L, 1);
                 }
-            } else {
-                lua_pop(L, 1);
             }
             lua_pop(L, 1); // target_tbl
         }
@@ -2118,9 +2188,8 @@ void Unit::stop_capturing(lua_State* L, EntityRegistry& registry, bool failed) {
         if (lua_table_ref() >= 0 && target->lua_table_ref() >= 0) {
             lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
             int self_tbl = lua_gettop(L);
-            lua_pushstring(L, "OnStopCapture");
-            lua_gettable(L, self_tbl);
-            if (lua_isfunction(L, -1)) {
+            if (LuaCallbackCache::push_hook(L, self_tbl, this,
+                                            UnitHook::OnStopCapture)) {
                 lua_pushvalue(L, self_tbl);
                 lua_rawgeti(L, LUA_REGISTRYINDEX, target->lua_table_ref());
                 if (lua_pcall(L, 2, 0, 0) != 0) {
@@ -2128,8 +2197,6 @@ void Unit::stop_capturing(lua_State* L, EntityRegistry& registry, bool failed) {
                                  lua_tostring(L, -1));
                     lua_pop(L, 1);
                 }
-            } else {
-                lua_pop(L, 1);
             }
             lua_pop(L, 1); // self_tbl
         }
@@ -2142,9 +2209,8 @@ void Unit::stop_capturing(lua_State* L, EntityRegistry& registry, bool failed) {
         if (target->lua_table_ref() >= 0 && lua_table_ref() >= 0) {
             lua_rawgeti(L, LUA_REGISTRYINDEX, target->lua_table_ref());
             int target_tbl = lua_gettop(L);
-            lua_pushstring(L, "OnStopBeingCaptured");
-            lua_gettable(L, target_tbl);
-            if (lua_isfunction(L, -1)) {
+            if (LuaCallbackCache::push_hook(L, target_tbl, target,
+                                            UnitHook::OnStopBeingCaptured)) {
                 lua_pushvalue(L, target_tbl);
                 lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
                 if (lua_pcall(L, 2, 0, 0) != 0) {
@@ -2152,8 +2218,6 @@ void Unit::stop_capturing(lua_State* L, EntityRegistry& registry, bool failed) {
                                  lua_tostring(L, -1));
                     lua_pop(L, 1);
                 }
-            } else {
-                lua_pop(L, 1);
             }
             lua_pop(L, 1); // target_tbl
         }
@@ -2198,7 +2262,8 @@ void Unit::remove_enhancement(const std::string& enh) {
 }
 
 bool Unit::start_enhance(const UnitCommand& cmd, lua_State* L) {
-    enhance_name_ = cmd.blueprint_id;
+    // cmd is the front of this unit's queue, so the queue holds its store
+    enhance_name_ = cmd.blueprint_id(*command_queue_.store());
 
     // Read enhancement BP from self.Blueprint.Enhancements[name]
     f64 enh_build_time = 0, enh_cost_mass = 0, enh_cost_energy = 0;
@@ -2251,19 +2316,19 @@ bool Unit::start_enhance(const UnitCommand& cmd, lua_State* L) {
     work_progress_ = 0.0f;
 
     // Set economy drain
-    economy_.consumption_mass =
+    auto& econ = edit_economy();
+    econ.consumption_mass =
         enh_cost_mass * static_cast<f64>(build_rate_) / enhance_build_time_;
-    economy_.consumption_energy =
+    econ.consumption_energy =
         enh_cost_energy * static_cast<f64>(build_rate_) / enhance_build_time_;
-    economy_.consumption_active = true;
+    econ.consumption_active = true;
 
     // Call self:OnWorkBegin(enhancement_name)
     if (lua_table_ref() >= 0) {
         lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
         int self_tbl = lua_gettop(L);
-        lua_pushstring(L, "OnWorkBegin");
-        lua_gettable(L, self_tbl);
-        if (lua_isfunction(L, -1)) {
+        if (LuaCallbackCache::push_hook(L, self_tbl, this,
+                                        UnitHook::OnWorkBegin)) {
             lua_pushvalue(L, self_tbl); // self
             lua_pushstring(L, enhance_name_.c_str());
             if (lua_pcall(L, 2, 0, 0) != 0) {
@@ -2271,15 +2336,14 @@ bool Unit::start_enhance(const UnitCommand& cmd, lua_State* L) {
                 lua_pop(L, 1);
                 lua_pop(L, 1); // self_tbl
                 // Cancel on error
-                economy_.consumption_mass = 0;
-                economy_.consumption_energy = 0;
-                economy_.consumption_active = false;
+                auto& econ = edit_economy();
+                econ.consumption_mass = 0;
+                econ.consumption_energy = 0;
+                econ.consumption_active = false;
                 enhance_build_time_ = 0;
                 enhance_name_.clear();
                 return false;
             }
-        } else {
-            lua_pop(L, 1); // non-function
         }
         lua_pop(L, 1); // self_tbl
     }
@@ -2321,25 +2385,23 @@ void Unit::finish_enhance(lua_State* L) {
     work_progress_ = 1.0f;
 
     // Clear economy drain
-    economy_.consumption_mass = 0;
-    economy_.consumption_energy = 0;
-    economy_.consumption_active = false;
+    auto& econ = edit_economy();
+    econ.consumption_mass = 0;
+    econ.consumption_energy = 0;
+    econ.consumption_active = false;
 
     // Call self:OnWorkEnd(enhancement_name)
     if (lua_table_ref() >= 0) {
         lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
         int self_tbl = lua_gettop(L);
-        lua_pushstring(L, "OnWorkEnd");
-        lua_gettable(L, self_tbl);
-        if (lua_isfunction(L, -1)) {
+        if (LuaCallbackCache::push_hook(L, self_tbl, this,
+                                        UnitHook::OnWorkEnd)) {
             lua_pushvalue(L, self_tbl); // self
             lua_pushstring(L, enhance_name_.c_str());
             if (lua_pcall(L, 2, 0, 0) != 0) {
                 spdlog::warn("OnWorkEnd error: {}", lua_tostring(L, -1));
                 lua_pop(L, 1);
             }
-        } else {
-            lua_pop(L, 1);
         }
         lua_pop(L, 1); // self_tbl
     }
@@ -2386,25 +2448,23 @@ void Unit::cancel_enhance(lua_State* L) {
     if (lua_table_ref() >= 0 && !enhance_name_.empty()) {
         lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
         int self_tbl = lua_gettop(L);
-        lua_pushstring(L, "OnWorkFail");
-        lua_gettable(L, self_tbl);
-        if (lua_isfunction(L, -1)) {
+        if (LuaCallbackCache::push_hook(L, self_tbl, this,
+                                        UnitHook::OnWorkFail)) {
             lua_pushvalue(L, self_tbl);
             lua_pushstring(L, enhance_name_.c_str());
             if (lua_pcall(L, 2, 0, 0) != 0) {
                 spdlog::warn("OnWorkFail error: {}", lua_tostring(L, -1));
                 lua_pop(L, 1);
             }
-        } else {
-            lua_pop(L, 1);
         }
         lua_pop(L, 1); // self_tbl
     }
 
     // Clear economy drain
-    economy_.consumption_mass = 0;
-    economy_.consumption_energy = 0;
-    economy_.consumption_active = false;
+    auto& econ = edit_economy();
+    econ.consumption_mass = 0;
+    econ.consumption_energy = 0;
+    econ.consumption_active = false;
 
     enhancing_ = false;
     enhance_build_time_ = 0;
@@ -2479,9 +2539,8 @@ void Unit::attach_to_transport(Unit* transport, EntityRegistry& registry,
     if (transport->lua_table_ref() >= 0 && lua_table_ref() >= 0) {
         lua_rawgeti(L, LUA_REGISTRYINDEX, transport->lua_table_ref());
         int transport_tbl = lua_gettop(L);
-        lua_pushstring(L, "OnTransportAttach");
-        lua_gettable(L, transport_tbl);
-        if (lua_isfunction(L, -1)) {
+        if (LuaCallbackCache::push_hook(L, transport_tbl, transport,
+                                        UnitHook::OnTransportAttach)) {
             lua_pushvalue(L, transport_tbl); // self (transport)
             lua_pushstring(L, "Attachpoint");  // bone placeholder
             lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref()); // cargo
@@ -2490,8 +2549,6 @@ void Unit::attach_to_transport(Unit* transport, EntityRegistry& registry,
                              lua_tostring(L, -1));
                 lua_pop(L, 1);
             }
-        } else {
-            lua_pop(L, 1); // non-function
         }
         lua_pop(L, 1); // transport_tbl
     }
@@ -2521,9 +2578,8 @@ void Unit::detach_all_cargo(EntityRegistry& registry, lua_State* L) {
         if (lua_table_ref() >= 0 && cargo->lua_table_ref() >= 0) {
             lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
             int transport_tbl = lua_gettop(L);
-            lua_pushstring(L, "OnTransportDetach");
-            lua_gettable(L, transport_tbl);
-            if (lua_isfunction(L, -1)) {
+            if (LuaCallbackCache::push_hook(L, transport_tbl, this,
+                                            UnitHook::OnTransportDetach)) {
                 lua_pushvalue(L, transport_tbl); // self (transport)
                 lua_pushstring(L, "Attachpoint");  // bone placeholder
                 lua_rawgeti(L, LUA_REGISTRYINDEX, cargo->lua_table_ref());
@@ -2532,8 +2588,6 @@ void Unit::detach_all_cargo(EntityRegistry& registry, lua_State* L) {
                                  lua_tostring(L, -1));
                     lua_pop(L, 1);
                 }
-            } else {
-                lua_pop(L, 1); // non-function
             }
             lua_pop(L, 1); // transport_tbl
         }
@@ -2554,9 +2608,8 @@ void Unit::set_layer_with_callback(const std::string& new_layer, lua_State* L) {
         lua_rawset(L, tbl);
 
         // Call self:OnLayerChange(new, old)
-        lua_pushstring(L, "OnLayerChange");
-        lua_gettable(L, tbl);
-        if (lua_isfunction(L, -1)) {
+        if (LuaCallbackCache::push_hook(L, tbl, this,
+                                        UnitHook::OnLayerChange)) {
             lua_pushvalue(L, tbl); // self
             lua_pushstring(L, new_layer.c_str());
             lua_pushstring(L, old_layer.c_str());
@@ -2564,8 +2617,6 @@ void Unit::set_layer_with_callback(const std::string& new_layer, lua_State* L) {
                 spdlog::warn("OnLayerChange error: {}", lua_tostring(L, -1));
                 lua_pop(L, 1);
             }
-        } else {
-            lua_pop(L, 1); // non-function
         }
         lua_pop(L, 1); // tbl
     }
@@ -2575,32 +2626,26 @@ void Unit::set_layer_with_callback(const std::string& new_layer, lua_State* L) {
 // Lua callback helpers
 // ---------------------------------------------------------------------------
 
-void Unit::call_lua_method(lua_State* L, const char* method_name) {
+void Unit::call_lua_method(lua_State* L, UnitHook hook) {
     if (lua_table_ref() < 0) return;
     lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
     int tbl = lua_gettop(L);
-    lua_pushstring(L, method_name);
-    lua_gettable(L, tbl);
-    if (lua_isfunction(L, -1)) {
+    if (LuaCallbackCache::push_hook(L, tbl, this, hook)) {
         lua_pushvalue(L, tbl); // self
         if (lua_pcall(L, 1, 0, 0) != 0) {
-            spdlog::warn("{} error: {}", method_name, lua_tostring(L, -1));
+            spdlog::warn("{} error: {}", unit_hook_name(hook), lua_tostring(L, -1));
             lua_pop(L, 1);
         }
-    } else {
-        lua_pop(L, 1); // non-function
     }
     lua_pop(L, 1); // tbl
 }
 
-void Unit::call_lua_method_with_entity(lua_State* L, const char* method_name,
+void Unit::call_lua_method_with_entity(lua_State* L, UnitHook hook,
                                         Entity* arg_entity) {
     if (lua_table_ref() < 0) return;
     lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
     int tbl = lua_gettop(L);
-    lua_pushstring(L, method_name);
-    lua_gettable(L, tbl);
-    if (lua_isfunction(L, -1)) {
+    if (LuaCallbackCache::push_hook(L, tbl, this, hook)) {
         lua_pushvalue(L, tbl); // self
         if (arg_entity && arg_entity->lua_table_ref() >= 0) {
             lua_rawgeti(L, LUA_REGISTRYINDEX, arg_entity->lua_table_ref());
@@ -2608,11 +2653,9 @@ void Unit::call_lua_method_with_entity(lua_State* L, const char* method_name,
             lua_pushnil(L);
         }
         if (lua_pcall(L, 2, 0, 0) != 0) {
-            spdlog::warn("{} error: {}", method_name, lua_tostring(L, -1));
+            spdlog::warn("{} error: {}", unit_hook_name(hook), lua_tostring(L, -1));
             lua_pop(L, 1);
         }
-    } else {
-        lua_pop(L, 1); // non-function
     }
     lua_pop(L, 1); // tbl
 }
@@ -2694,6 +2737,7 @@ void Unit::init_animated_bones() {
     for (auto& m : animated_bone_matrices_) {
         m = IDENTITY;
     }
+    render_changed(); // the renderer reserves bone slots per unit
 }
 
 void Unit::record_damage(u32 attacker_id, f32 amount) {
@@ -2797,16 +2841,13 @@ void Unit::fire_on_veteran(lua_State* L) {
     if (lua_table_ref() < 0) return;
     lua_rawgeti(L, LUA_REGISTRYINDEX, lua_table_ref());
     int tbl = lua_gettop(L);
-    lua_pushstring(L, "OnVeteran");
-    lua_gettable(L, tbl);
-    if (lua_isfunction(L, -1)) {
+    if (LuaCallbackCache::push_hook(L, tbl, this,
+                                    UnitHook::OnVeteran)) {
         lua_pushvalue(L, tbl); // self
         if (lua_pcall(L, 1, 0, 0) != 0) {
             spdlog::warn("OnVeteran error: {}", lua_tostring(L, -1));
             lua_pop(L, 1);
         }
-    } else {
-        lua_pop(L, 1); // not a function
     }
     lua_pop(L, 1); // unit table
 }
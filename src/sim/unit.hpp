@@ -1,12 +1,12 @@
 #pragma once
 
 #include "sim/entity.hpp"
+#include "sim/lua_callbacks.hpp"
 #include "sim/navigator.hpp"
 #include "sim/unit_command.hpp"
 #include "sim/weapon.hpp"
 
 #include <array>
-#include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -53,6 +53,7 @@ struct UnitEconomy {
 class Unit : public Entity {
 public:
     bool is_unit() const override { return true; }
+    bool is_static() const override { return has_category("STRUCTURE"); }
 
     const std::string& unit_id() const { return unit_id_; }
     void set_unit_id(const std::string& id) { unit_id_ = id; }
@@ -81,8 +82,11 @@ public:
     bool is_moving() const { return navigator_.is_moving(); }
 
     // Economy
-    UnitEconomy& economy() { return economy_; }
     const UnitEconomy& economy() const { return economy_; }
+    /// Mutable economy state; queues the unit for the army ledger, so every
+    /// write goes through here rather than through economy().
+    UnitEconomy& edit_economy();
+    EconomyFlow economy_flow() const override;
 
     // Weapons
     void add_weapon(std::unique_ptr<Weapon> w);
@@ -98,9 +102,8 @@ public:
     bool has_category(const std::string& cat) const {
         return categories_.count(cat) > 0;
     }
-    void add_category(std::string cat) {
-        categories_.insert(std::move(cat));
-    }
+    void add_category(std::string cat);
+    const CategorySet* category_set() const override { return &categories_; }
 
     // Rally point (factories send produced units here)
     bool has_rally_point() const { return has_rally_point_; }
@@ -181,13 +184,26 @@ public:
     const std::vector<BuildQueueEntry>& build_queue() const { return build_queue_; }
 
     // Command queue
-    const std::deque<UnitCommand>& command_queue() const {
-        return command_queue_;
-    }
-    void push_command(const UnitCommand& cmd, bool clear_existing);
+    const CommandQueue& command_queue() const { return command_queue_; }
+    void push_command(CommandStore& store, const UnitCommand& cmd,
+                      bool clear_existing);
+    void push_command(const CommandGroup& group, bool clear_existing);
     void clear_commands(const char* source = "?");
     void clear_queued_commands(); // remove all but current command
 
+    /// Per-unit leg of a formation move (see formation.hpp): the path to
+    /// follow and the group's speed, used when the queued Move command with
+    /// this command_id starts instead of pathing to the shared goal.
+    void set_formation_order(u32 command_id, f32 speed_cap,
+                             std::vector<Vector3> path);
+    bool in_formation_move() const { return formation_leg_ != 0; }
+    /// Queued formation leg for `command_id`, or null if it has none.
+    const std::vector<Vector3>* formation_path(u32 command_id) const {
+        for (const auto& o : formation_orders_)
+            if (o.command_id == command_id) return &o.path;
+        return nullptr;
+    }
+
     // Footprint (from blueprint, for pathfinding obstacle marking)
     f32 footprint_size_x() const { return footprint_size_x_; }
     f32 footprint_size_z() const { return footprint_size_z_; }
@@ -196,11 +212,14 @@ public:
     /// Per-tick update: process command queue + movement + weapons.
     void update(f64 dt, SimContext& ctx);
 
-    /// Lua callback helpers: call self:method() or self:method(entity)
-    void call_lua_method(lua_State* L, const char* method_name);
-    void call_lua_method_with_entity(lua_State* L, const char* method_name,
+    /// Lua callback helpers: call self:hook() or self:hook(entity)
+    void call_lua_method(lua_State* L, UnitHook hook);
+    void call_lua_method_with_entity(lua_State* L, UnitHook hook,
                                       Entity* arg_entity);
 
+    /// Cached hook resolution for this unit's Lua class (see LuaCallbackCache).
+    LuaCallbackBinding& lua_callbacks() { return lua_callbacks_; }
+
     /// Build helpers called from update()
     bool start_build(const UnitCommand& cmd, EntityRegistry& registry,
                      lua_State* L);
@@ -504,7 +523,7 @@ public:
 
 private:
     void call_on_reclaimed(u32 target_id, EntityRegistry& registry, lua_State* L);
-    bool nav_update(f64 dt, const map::Terrain* terrain);
+    bool nav_update(f64 dt, const map::Terrain* terrain, f32 speed_cap = 0);
     void apply_vet_buffs(lua_State* L);
     void fire_on_veteran(lua_State* L);
 
@@ -519,7 +538,15 @@ private:
     Navigator navigator_;
     UnitEconomy economy_;
     std::unordered_set<std::string> categories_;
-    std::deque<UnitCommand> command_queue_;
+    CommandQueue command_queue_;
+    struct FormationOrder {
+        u32 command_id = 0;
+        f32 speed_cap = 0;
+        std::vector<Vector3> path;
+    };
+    std::vector<FormationOrder> formation_orders_; // queued formation legs
+    u32 formation_leg_ = 0;     // command_id of the leg being followed
+    f32 formation_speed_ = 0;   // speed cap of that leg
     std::vector<std::unique_ptr<Weapon>> weapons_;
     Vector3 rally_point_;
     bool has_rally_point_ = false;
@@ -643,6 +670,8 @@ private:
     f32 death_duration_ = 0.0f;
     // OnGiven callbacks (Lua registry refs)
     std::vector<int> on_given_callbacks_;
+    // Cached script hook lookup
+    LuaCallbackBinding lua_callbacks_;
     // OnUnitBuilt callbacks (function + category filter)
     std::vector<UnitBuiltCallback> on_unit_built_callbacks_;
     // Build queue (factory production queue)
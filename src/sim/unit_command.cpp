@@ -0,0 +1,132 @@
+#include "sim/unit_command.hpp"
+
+#include <bit>
+#include <cassert>
+
+namespace osc::sim {
+
+// --- Interned command names ---
+
+u32 CommandStore::intern(std::string_view name) {
+    auto it = name_index_.find(name);
+    if (it != name_index_.end()) return it->second;
+    u32 id = static_cast<u32>(names_.size());
+    const auto& stored = names_.emplace_back(name);
+    name_index_.emplace(stored, id);
+    return id;
+}
+
+const std::string& CommandStore::name(u32 index) const {
+    return index < names_.size() ? names_[index] : names_[0];
+}
+
+// --- Payload pool ---
+
+u32 CommandStore::acquire(const UnitCommand& cmd) {
+    u32 h;
+    if (!free_.empty()) {
+        h = free_.back();
+        free_.pop_back();
+        payloads_[h] = cmd;
+    } else {
+        h = static_cast<u32>(payloads_.size());
+        payloads_.push_back(cmd);
+        refs_.push_back(0);
+    }
+    refs_[h] = 1;
+    live_++;
+    return h;
+}
+
+void CommandStore::release(u32 handle) {
+    assert(refs_[handle] > 0);
+    if (--refs_[handle] == 0) {
+        free_.push_back(handle);
+        live_--;
+    }
+}
+
+// --- Overflow ring buffers ---
+
+u32* CommandStore::take_block(u32 capacity) {
+    u32 cls = static_cast<u32>(std::countr_zero(capacity));
+    if (cls < free_blocks_.size() && !free_blocks_[cls].empty()) {
+        u32* block = free_blocks_[cls].back().release();
+        free_blocks_[cls].pop_back();
+        return block;
+    }
+    return new u32[capacity];
+}
+
+void CommandStore::give_block(u32* block, u32 capacity) {
+    u32 cls = static_cast<u32>(std::countr_zero(capacity));
+    if (cls >= free_blocks_.size()) free_blocks_.resize(cls + 1);
+    free_blocks_[cls].emplace_back(block);
+}
+
+// --- Queue ---
+
+CommandQueue::~CommandQueue() {
+    clear();
+}
+
+void CommandQueue::bind(CommandStore& store) {
+    assert(!store_ || store_ == &store);
+    store_ = &store;
+}
+
+void CommandQueue::push_handle(u32 handle) {
+    if (size_ == capacity_) {
+        u32 cap = capacity_ * 2;
+        u32* block = store_->take_block(cap);
+        for (u32 i = 0; i < size_; ++i)
+            block[i] = data()[(head_ + i) & (capacity_ - 1)];
+        if (heap_) store_->give_block(heap_, capacity_);
+        heap_ = block;
+        capacity_ = cap;
+        head_ = 0;
+    }
+    data()[(head_ + size_) & (capacity_ - 1)] = handle;
+    size_++;
+}
+
+void CommandQueue::push_back(CommandStore& store, const UnitCommand& cmd) {
+    bind(store);
+    push_handle(store.acquire(cmd));
+}
+
+void CommandQueue::push_back(const CommandGroup& group) {
+    bind(group.store());
+    store_->retain(group.handle());
+    push_handle(group.handle());
+}
+
+void CommandQueue::pop_front() {
+    assert(size_ > 0);
+    store_->release(data()[head_]);
+    head_ = (head_ + 1) & (capacity_ - 1);
+    size_--;
+}
+
+void CommandQueue::rotate() {
+    if (size_ < 2) return;
+    u32 h = data()[head_];
+    head_ = (head_ + 1) & (capacity_ - 1);
+    data()[(head_ + size_ - 1) & (capacity_ - 1)] = h;
+}
+
+void CommandQueue::truncate(size_t n) {
+    while (size_ > n) {
+        size_--;
+        store_->release(data()[(head_ + size_) & (capacity_ - 1)]);
+    }
+    if (size_ == 0) {
+        // Back to inline storage; the ring goes to the next long queue
+        if (heap_) store_->give_block(heap_, capacity_);
+        heap_ = nullptr;
+        capacity_ = INLINE_CAPACITY;
+        head_ = 0;
+    }
+}
+
+} // namespace osc::sim
@@ -3,7 +3,14 @@
 #include "core/types.hpp"
 #include "sim/entity.hpp" // Vector3
 
+#include <cstddef>
+#include <deque>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace osc::sim {
 
@@ -31,12 +38,151 @@ enum class CommandType : u8 {
     Ferry = 75,            // ferry route waypoint (transport loop)
 };
 
+class CommandStore;
+
 struct UnitCommand {
-    CommandType type;
+    CommandType type = CommandType::Stop;
     Vector3 target_pos;
     u32 target_id = 0;          // entity ID for Attack/Guard
-    std::string blueprint_id;   // for Build commands (empty for non-build)
+    u32 blueprint = 0;          // name interned in a CommandStore, for Build/Upgrade/Enhance
     u32 command_id = 0;         // unique ID for IsCommandsActive tracking
+
+    inline const std::string& blueprint_id(const CommandStore& store) const;
+    inline void set_blueprint_id(CommandStore& store, std::string_view id);
+};
+static_assert(std::is_trivially_copyable_v<UnitCommand>);
+
+/// What command queues share: refcounted payloads, interned names and
+/// recycled ring buffers. Each SimState owns one, so sims running side by
+/// side never share payload slots or name ids. It must outlive every queue
+/// and group that used it. Sim thread only.
+class CommandStore {
+public:
+    CommandStore() = default;
+    CommandStore(const CommandStore&) = delete;
+    CommandStore& operator=(const CommandStore&) = delete;
+
+    /// Intern a blueprint ID / enhancement name. Index 0 is the empty
+    /// string. The table only grows, so indices stay valid for the life of
+    /// the store.
+    u32 intern(std::string_view name);
+    const std::string& name(u32 index) const;
+
+    /// Payloads: queues hold 4-byte handles; a payload lives until the last
+    /// queue referencing it drops it. Addresses are stable while referenced.
+    u32 acquire(const UnitCommand& cmd); // new payload, refcount 1
+    void retain(u32 handle) { refs_[handle]++; }
+    void release(u32 handle);
+    const UnitCommand& get(u32 handle) const { return payloads_[handle]; }
+    size_t live_count() const { return live_; } // payloads currently referenced
+
+private:
+    friend class CommandQueue;
+
+    /// Spilled ring buffers, recycled per power-of-two size class.
+    u32* take_block(u32 capacity);
+    void give_block(u32* block, u32 capacity);
+
+    // deque: growing never moves existing strings, so the views used as
+    // map keys stay valid
+    std::deque<std::string> names_{std::string()};
+    std::unordered_map<std::string_view, u32> name_index_{{std::string_view(), 0}};
+
+    std::deque<UnitCommand> payloads_; // stable addresses
+    std::vector<u32> refs_;
+    std::vector<u32> free_;
+    size_t live_ = 0;
+
+    std::vector<std::vector<std::unique_ptr<u32[]>>> free_blocks_;
+};
+
+const std::string& UnitCommand::blueprint_id(const CommandStore& store) const {
+    return store.name(blueprint);
+}
+
+void UnitCommand::set_blueprint_id(CommandStore& store, std::string_view id) {
+    blueprint = store.intern(id);
+}
+
+/// One order issued to many units at once. Every unit's queue references
+/// the same payload instead of holding its own copy.
+class CommandGroup {
+public:
+    CommandGroup(CommandStore& store, const UnitCommand& cmd)
+        : store_(&store), handle_(store.acquire(cmd)) {}
+    ~CommandGroup() { store_->release(handle_); }
+    CommandGroup(const CommandGroup&) = delete;
+    CommandGroup& operator=(const CommandGroup&) = delete;
+
+    CommandStore& store() const { return *store_; }
+    u32 handle() const { return handle_; }
+    const UnitCommand& command() const { return store_->get(handle_); }
+
+private:
+    CommandStore* store_;
+    u32 handle_;
+};
+
+/// FIFO of command handles. The first INLINE_CAPACITY entries live inside
+/// the queue itself; longer queues (shift-click patrols, factory orders)
+/// spill into power-of-two ring buffers recycled through the store. A queue
+/// binds to the store of its first command and stays with it.
+class CommandQueue {
+public:
+    static constexpr u32 INLINE_CAPACITY = 4;
+
+    CommandQueue() = default;
+    ~CommandQueue();
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+    const UnitCommand& front() const { return (*this)[0]; }
+    const UnitCommand& operator[](size_t i) const {
+        return store_->get(data()[(head_ + i) & (capacity_ - 1)]);
+    }
+
+    /// The store this queue's commands live in; null before the first push.
+    const CommandStore* store() const { return store_; }
+
+    class const_iterator {
+    public:
+        const_iterator(const CommandQueue* q, size_t i) : q_(q), i_(i) {}
+        const UnitCommand& operator*() const { return (*q_)[i_]; }
+        const UnitCommand* operator->() const { return &(*q_)[i_]; }
+        const_iterator& operator++() { ++i_; return *this; }
+        bool operator==(const const_iterator& o) const { return i_ == o.i_; }
+        bool operator!=(const const_iterator& o) const { return i_ != o.i_; }
+
+    private:
+        const CommandQueue* q_;
+        size_t i_;
+    };
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size_}; }
+
+    void push_back(CommandStore& store, const UnitCommand& cmd);
+    void push_back(const CommandGroup& group);
+    void pop_front();
+    /// Move the front command to the back (patrol/ferry loops).
+    void rotate();
+    /// Drop everything after the first `n` commands.
+    void truncate(size_t n);
+    void clear() { truncate(0); }
+
+private:
+    void bind(CommandStore& store);
+    void push_handle(u32 handle);
+    u32* data() { return heap_ ? heap_ : inline_; }
+    const u32* data() const { return heap_ ? heap_ : inline_; }
+
+    CommandStore* store_ = nullptr;
+    u32 inline_[INLINE_CAPACITY] = {};
+    u32* heap_ = nullptr;
+    u32 capacity_ = INLINE_CAPACITY; // power of two
+    u32 head_ = 0;
+    u32 size_ = 0;
 };
 
 } // namespace osc::sim
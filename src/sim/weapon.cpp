@@ -69,8 +69,11 @@ void Weapon::update_targeting(Unit& owner, EntityRegistry& registry) {
     }
 
     // Find nearest enemy in range
+    SpatialFilter enemies;
+    enemies.kinds = spatial_kind::UNIT;
+    enemies.exclude_army = owner.army();
     auto candidates = registry.collect_in_radius(
-        owner.position().x, owner.position().z, max_range);
+        owner.position().x, owner.position().z, max_range, enemies);
 
     f32 best_dist2 = max_range * max_range + 1.0f;
     u32 best_id = 0;
@@ -1,6 +1,7 @@
 // Disable FILE*-based functions (not needed, avoids MSVC warnings)
 #define PLM_NO_STDIO
 #define PL_MPEG_IMPLEMENTATION
+#include <cstddef> // pl_mpeg.h uses size_t without including it
 #include "pl_mpeg.h"
 
 #include "video/video_decoder.hpp"
@@ -9,19 +10,139 @@
 #include <algorithm>
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OSC_VIDEO_SSE2 1
+#endif
+
 namespace osc::video {
 
+// --- YCbCr -> RGBA ---
+//
+// BT.601 in pl_mpeg's 16.16 fixed point. The multipliers exceed 16 bits, so
+// the SSE2 path splits each into an integer part and a 16-bit remainder
+// (76309 = 65536 + 10773, 104597 = 2*65536 - 26475, 132201 = 2*65536 + 1129,
+// 53278 = 65536 - 12258); _mm_mulhi_epi16 / _mm_madd_epi16 then give the
+// same floor as the scalar >> 16, so both paths are bit-exact.
+
+static inline u8 clamp_u8(int n) {
+    return static_cast<u8>(n < 0 ? 0 : n > 255 ? 255 : n);
+}
+
+void yuv420_to_rgba(const u8* y, u32 y_stride, const u8* cb, const u8* cr,
+                    u32 c_stride, u32 width, u32 height, u8* dst,
+                    u32 dst_stride) {
+    u32 cols = width >> 1;
+    u32 rows = height >> 1;
+    for (u32 row = 0; row < rows; row++) {
+        const u8* y0 = y + 2 * row * y_stride;
+        const u8* y1 = y0 + y_stride;
+        const u8* cbr = cb + row * c_stride;
+        const u8* crr = cr + row * c_stride;
+        u8* d0 = dst + 2 * row * dst_stride;
+        u8* d1 = d0 + dst_stride;
+        u32 col = 0;
+
+#ifdef OSC_VIDEO_SSE2
+        // 8 chroma samples -> 16x2 pixels per iteration
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i c128 = _mm_set1_epi16(128);
+        const __m128i y16 = _mm_set1_epi16(16);
+        const __m128i k_y = _mm_set1_epi16(10773);
+        const __m128i k_r = _mm_set1_epi16(-26475);
+        const __m128i k_b = _mm_set1_epi16(1129);
+        const __m128i k_g = _mm_set_epi16(-12258, 25674, -12258, 25674,
+                                          -12258, 25674, -12258, 25674);
+        const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+        for (; col + 8 <= cols; col += 8) {
+            __m128i vcb = _mm_sub_epi16(_mm_unpacklo_epi8(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(cbr + col)),
+                zero), c128);
+            __m128i vcr = _mm_sub_epi16(_mm_unpacklo_epi8(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(crr + col)),
+                zero), c128);
+
+            __m128i r = _mm_add_epi16(_mm_add_epi16(vcr, vcr),
+                                      _mm_mulhi_epi16(vcr, k_r));
+            __m128i b = _mm_add_epi16(_mm_add_epi16(vcb, vcb),
+                                      _mm_mulhi_epi16(vcb, k_b));
+            __m128i g_lo = _mm_srai_epi32(
+                _mm_madd_epi16(_mm_unpacklo_epi16(vcb, vcr), k_g), 16);
+            __m128i g_hi = _mm_srai_epi32(
+                _mm_madd_epi16(_mm_unpackhi_epi16(vcb, vcr), k_g), 16);
+            __m128i g = _mm_add_epi16(_mm_packs_epi32(g_lo, g_hi), vcr);
+
+            // Each chroma sample covers two horizontal pixels
+            __m128i r0 = _mm_unpacklo_epi16(r, r), r1 = _mm_unpackhi_epi16(r, r);
+            __m128i g0 = _mm_unpacklo_epi16(g, g), g1 = _mm_unpackhi_epi16(g, g);
+            __m128i b0 = _mm_unpacklo_epi16(b, b), b1 = _mm_unpackhi_epi16(b, b);
+
+            for (int line = 0; line < 2; line++) {
+                const u8* ys = (line ? y1 : y0) + 2 * col;
+                u8* d = (line ? d1 : d0) + 8 * col;
+                __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ys));
+                __m128i l0 = _mm_sub_epi16(_mm_unpacklo_epi8(vy, zero), y16);
+                __m128i l1 = _mm_sub_epi16(_mm_unpackhi_epi8(vy, zero), y16);
+                l0 = _mm_add_epi16(l0, _mm_mulhi_epi16(l0, k_y));
+                l1 = _mm_add_epi16(l1, _mm_mulhi_epi16(l1, k_y));
+
+                __m128i R = _mm_packus_epi16(_mm_add_epi16(l0, r0),
+                                             _mm_add_epi16(l1, r1));
+                __m128i G = _mm_packus_epi16(_mm_sub_epi16(l0, g0),
+                                             _mm_sub_epi16(l1, g1));
+                __m128i B = _mm_packus_epi16(_mm_add_epi16(l0, b0),
+                                             _mm_add_epi16(l1, b1));
+
+                __m128i rg_lo = _mm_unpacklo_epi8(R, G);
+                __m128i rg_hi = _mm_unpackhi_epi8(R, G);
+                __m128i ba_lo = _mm_unpacklo_epi8(B, alpha);
+                __m128i ba_hi = _mm_unpackhi_epi8(B, alpha);
+                auto* out = reinterpret_cast<__m128i*>(d);
+                _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(rg_lo, ba_lo));
+                _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(rg_lo, ba_lo));
+                _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(rg_hi, ba_hi));
+                _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(rg_hi, ba_hi));
+            }
+        }
+#endif
+
+        for (; col < cols; col++) {
+            int vcr = crr[col] - 128;
+            int vcb = cbr[col] - 128;
+            int r = (vcr * 104597) >> 16;
+            int g = (vcb * 25674 + vcr * 53278) >> 16;
+            int b = (vcb * 132201) >> 16;
+            for (u32 i = 0; i < 4; i++) {
+                const u8* ys = (i < 2 ? y0 : y1) + 2 * col + (i & 1);
+                u8* d = (i < 2 ? d0 : d1) + 8 * col + 4 * (i & 1);
+                int l = ((*ys - 16) * 76309) >> 16;
+                d[0] = clamp_u8(l + r);
+                d[1] = clamp_u8(l - g);
+                d[2] = clamp_u8(l + b);
+                d[3] = 255;
+            }
+        }
+    }
+}
+
+// --- VideoDecoder ---
+
 VideoDecoder::~VideoDecoder() { close(); }
 
 void VideoDecoder::close() {
+    stop_async();
     if (plm_) {
         plm_destroy(plm_);
         plm_ = nullptr;
     }
     mpeg_data_.clear();
     rgba_buf_.clear();
+    ring_.clear();
     width_ = height_ = 0;
     framerate_ = 0;
+    frame_time_ = pts_offset_ = last_pts_ = 0;
+    ended_ = false;
 }
 
 bool VideoDecoder::open(const u8* data, size_t size) {
@@ -73,30 +194,120 @@ bool VideoDecoder::open_file(const u8* file_data, size_t file_size) {
     return open(file_data, file_size);
 }
 
-bool VideoDecoder::decode_next_frame() {
-    if (!plm_) return false;
-
+bool VideoDecoder::decode_into(u8* dst, f64& pts) {
     plm_frame_t* frame = plm_decode_video(plm_);
     if (!frame) {
         if (loop_) {
+            // Keep timestamps monotonic across the wrap for present()
+            pts_offset_ = last_pts_ + (framerate_ > 0 ? 1.0 / framerate_ : 0);
             plm_rewind(plm_);
             frame = plm_decode_video(plm_);
         }
         if (!frame) return false;
     }
 
-    plm_frame_to_rgba(frame, rgba_buf_.data(),
-                      static_cast<int>(width_) * 4);
+    yuv420_to_rgba(frame->y.data, frame->y.width, frame->cb.data,
+                   frame->cr.data, frame->cb.width, frame->width,
+                   frame->height, dst, width_ * 4);
+    pts = last_pts_ = pts_offset_ + frame->time;
     return true;
 }
 
+bool VideoDecoder::decode_next_frame() {
+    if (!plm_ || is_async()) return false;
+    return decode_into(rgba_buf_.data(), frame_time_);
+}
+
+bool VideoDecoder::start_async(u32 ring_frames) {
+    if (!plm_ || is_async()) return false;
+
+    ring_.resize(std::max(ring_frames, 1u));
+    for (auto& f : ring_) f.rgba.resize(rgba_buf_.size());
+    head_ = count_ = 0;
+    stopping_ = false;
+    ended_ = false;
+    clock_base_ = -1;
+    worker_ = std::thread([this] { worker_loop(); });
+    return true;
+}
+
+void VideoDecoder::stop_async() {
+    if (!worker_.joinable()) return;
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    space_cv_.notify_one();
+    worker_.join();
+    head_ = count_ = 0;
+}
+
+void VideoDecoder::worker_loop() {
+    const u32 n = static_cast<u32>(ring_.size());
+    for (;;) {
+        u32 slot;
+        {
+            std::unique_lock lock(mutex_);
+            space_cv_.wait(lock, [&] { return stopping_ || count_ < n; });
+            if (stopping_) return;
+            slot = (head_ + count_) % n;
+        }
+
+        // The slot is ours until count_ covers it: decode without the lock
+        f64 pts = 0;
+        bool ok = decode_into(ring_[slot].rgba.data(), pts);
+
+        std::lock_guard lock(mutex_);
+        if (!ok) {
+            ended_ = true;
+            return;
+        }
+        ring_[slot].pts = pts;
+        count_++;
+    }
+}
+
+bool VideoDecoder::present(f64 now) {
+    if (!is_async()) return false;
+
+    bool changed = false;
+    {
+        std::lock_guard lock(mutex_);
+        const u32 n = static_cast<u32>(ring_.size());
+        if (count_ > 0 && clock_base_ < 0) clock_base_ = now - ring_[head_].pts;
+        f64 t = now - clock_base_ + 1e-6; // absorb clock rounding
+
+        // Take the newest due frame; older ones are skipped, not shown late
+        while (count_ > 0 && ring_[head_].pts <= t) {
+            std::swap(rgba_buf_, ring_[head_].rgba);
+            frame_time_ = ring_[head_].pts;
+            head_ = (head_ + 1) % n;
+            count_--;
+            changed = true;
+        }
+    }
+    if (changed) space_cv_.notify_one();
+    return changed;
+}
+
+bool VideoDecoder::finished() const {
+    if (!is_async()) return false;
+    std::lock_guard lock(mutex_);
+    return ended_ && count_ == 0;
+}
+
 void VideoDecoder::set_loop(bool loop) {
+    // Looping is handled in decode_into() so timestamps stay monotonic
     loop_ = loop;
-    if (plm_) plm_set_loop(plm_, loop ? 1 : 0);
 }
 
 void VideoDecoder::rewind() {
-    if (plm_) plm_rewind(plm_);
+    if (!plm_) return;
+    bool was_async = is_async();
+    stop_async();
+    plm_rewind(plm_);
+    pts_offset_ = last_pts_ = frame_time_ = 0;
+    if (was_async) start_async(static_cast<u32>(ring_.size()));
 }
 
 // --- SFD Demuxer ---
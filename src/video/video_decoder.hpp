@@ -2,6 +2,10 @@
 
 #include "core/types.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 struct plm_t;
@@ -10,8 +14,17 @@ namespace osc::video {
 
 /// Wraps pl_mpeg for MPEG-1 video decoding.
 /// Owns a copy of the input data (SFD demuxed or raw MPEG-1).
+///
+/// Two ways to drive it:
+///  - decode_next_frame(): synchronous, decodes on the calling thread.
+///  - start_async() + present(now): a worker thread decodes and converts
+///    ahead into a bounded ring of RGBA frames; present() only swaps in the
+///    newest frame whose timestamp is due, so playback costs the caller no
+///    decode time. Frames that fall behind the clock are skipped.
 class VideoDecoder {
 public:
+    static constexpr u32 DEFAULT_RING_FRAMES = 4;
+
     VideoDecoder() = default;
     ~VideoDecoder();
 
@@ -25,12 +38,31 @@ public:
     bool open_file(const u8* file_data, size_t file_size);
 
     /// Decode next frame. Returns false if no more frames (unless looping).
+    /// Not available while the decode thread is running.
     bool decode_next_frame();
 
+    /// Start the decode thread with a ring of `ring_frames` RGBA frames.
+    /// Playback time starts at the first present().
+    bool start_async(u32 ring_frames = DEFAULT_RING_FRAMES);
+
+    /// Stop and join the decode thread, dropping undisplayed frames. The
+    /// stream position is kept, so start_async() resumes where it stopped.
+    void stop_async();
+    bool is_async() const { return worker_.joinable(); }
+
+    /// Show the newest decoded frame due at `now` (seconds, any monotonic
+    /// clock). Returns true if rgba_data() changed.
+    bool present(f64 now);
+
+    /// True once the stream has ended (non-looping) and every decoded frame
+    /// has been presented.
+    bool finished() const;
+
     const u8* rgba_data() const { return rgba_buf_.data(); }
     u32 width() const { return width_; }
     u32 height() const { return height_; }
     f64 framerate() const { return framerate_; }
+    f64 frame_time() const { return frame_time_; } ///< PTS of rgba_data()
     bool is_open() const { return plm_ != nullptr; }
 
     void set_loop(bool loop);
@@ -38,15 +70,46 @@ public:
     void close();
 
 private:
+    struct Frame {
+        std::vector<u8> rgba;
+        f64 pts = 0;
+    };
+
+    /// Decode one picture into `dst`. Handles looping; false at end of stream.
+    bool decode_into(u8* dst, f64& pts);
+    void worker_loop();
+
     plm_t* plm_ = nullptr;
     std::vector<u8> mpeg_data_;
-    std::vector<u8> rgba_buf_;
+    std::vector<u8> rgba_buf_; // frame on display
     u32 width_ = 0;
     u32 height_ = 0;
     f64 framerate_ = 0;
-    bool loop_ = false;
+    f64 frame_time_ = 0;
+    f64 pts_offset_ = 0;  // accumulated duration of completed loops
+    f64 last_pts_ = 0;
+    std::atomic<bool> loop_{false};
+
+    // Decode thread and frame ring. Slots [head_, head_ + count_) hold
+    // decoded frames owned by the presenting thread; the rest belong to
+    // the worker.
+    std::thread worker_;
+    mutable std::mutex mutex_;
+    std::condition_variable space_cv_;
+    std::vector<Frame> ring_;
+    u32 head_ = 0;
+    u32 count_ = 0;
+    bool stopping_ = false;
+    bool ended_ = false;
+    f64 clock_base_ = -1; // now - pts at the first present()
 };
 
+/// Convert a decoded 4:2:0 picture to RGBA (alpha 255), bit-exact with
+/// pl_mpeg's plm_frame_to_rgba. Uses SSE2 where available.
+void yuv420_to_rgba(const u8* y, u32 y_stride, const u8* cb, const u8* cr,
+                    u32 c_stride, u32 width, u32 height, u8* dst,
+                    u32 dst_stride);
+
 /// Attempt to demux SFD (CRI Sofdec) container into raw MPEG-1.
 /// Returns empty vector if not an SFD file or demux fails.
 std::vector<u8> demux_sfd(const u8* data, size_t size);
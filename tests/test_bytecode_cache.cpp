@@ -0,0 +1,242 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "blueprints/blueprint_store.hpp"
+#include "lua/bytecode_cache.hpp"
+#include "lua/init_loader.hpp"
+#include "lua/lua_state.hpp"
+#include "vfs/virtual_file_system.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+extern "C" {
+#include <lua.h>
+}
+
+using namespace osc;
+using namespace osc::lua;
+
+namespace {
+
+constexpr const char* SCRIPT = R"(
+local function fib(n)
+    if n < 2 then return n end
+    return fib(n - 1) + fib(n - 2)
+end
+result = fib(15) .. ':' .. string.format('%.3f', 1 / 3)
+local info = debug.getinfo(1, 'Sl')
+where = info.source .. ':' .. info.currentline
+local ok, err = pcall(function()
+    local t = {}
+    return t + 1
+end)
+failure = err
+)";
+
+std::string global_string(LuaState& state, const char* name) {
+    lua_getglobal(state.raw(), name);
+    std::string s = lua_isstring(state.raw(), -1) ? lua_tostring(state.raw(), -1) : "";
+    lua_pop(state.raw(), 1);
+    return s;
+}
+
+/// Run SCRIPT as a file chunk and return everything it observed.
+std::string run_script(BytecodeCache* cache, const std::string& source = SCRIPT) {
+    LuaState state;
+    state.set_bytecode_cache(cache);
+    auto r = state.do_buffer(source.data(), source.size(), "@/lua/test.lua");
+    REQUIRE(r.ok());
+    return global_string(state, "result") + "|" + global_string(state, "where") +
+           "|" + global_string(state, "failure");
+}
+
+fs::path fresh_dir(const char* name) {
+    auto dir = fs::temp_directory_path() / name;
+    fs::remove_all(dir);
+    return dir;
+}
+
+void write_file(const fs::path& path, const std::string& text) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+/// Synthetic game tree: init.lua mounting data/, the system files the
+/// loader expects, and MODULES generated scripts that LoadBlueprints()
+/// pulls in through doscript.
+constexpr u32 MODULES = 150;
+
+fs::path make_game_tree() {
+    auto root = fresh_dir("osc_test_bytecode_tree");
+    auto data = (root / "data").generic_string();
+    write_file(root / "init.lua",
+               "path = { { dir = '" + data + "', mountpoint = '/' } }\n");
+    for (const char* sys : {"repr", "config", "utils", "class", "import"})
+        write_file(root / "data/lua/system" / (std::string(sys) + ".lua"),
+                   "-- " + std::string(sys) + "\n");
+    write_file(root / "data/lua/system/blueprints.lua",
+               "checksum = 0\n"
+               "function LoadBlueprints()\n"
+               "    for i = 1, " + std::to_string(MODULES) + " do\n"
+               "        doscript('/lua/gen/module' .. i .. '.lua')\n"
+               "    end\n"
+               "end\n");
+    for (u32 m = 1; m <= MODULES; ++m) {
+        std::string src = "local M = {}\n";
+        for (u32 f = 0; f < 40; ++f) {
+            auto fn = "f" + std::to_string(f);
+            src += "function M." + fn + "(a, b)\n"
+                   "    local t = { x = a, y = b, name = '" + fn + "' }\n"
+                   "    if t.x > t.y then return t.x - t.y end\n"
+                   "    for k = 1, 3 do t.x = t.x + k * " + std::to_string(f) + " end\n"
+                   "    return t.x + t.y\n"
+                   "end\n";
+        }
+        src += "checksum = checksum + M.f" + std::to_string(m % 40) + "(" +
+               std::to_string(m) + ", 2)\n";
+        write_file(root / ("data/lua/gen/module" + std::to_string(m) + ".lua"), src);
+    }
+    return root;
+}
+
+/// One full init_loader pass over the tree; returns the script checksum.
+std::string run_init(const fs::path& root, InitLoader& loader,
+                     const fs::path& cache_dir) {
+    LuaState state;
+    vfs::VirtualFileSystem vfs;
+    InitConfig config;
+    config.init_file = root / "init.lua";
+    config.bytecode_cache_dir = cache_dir;
+    REQUIRE(loader.execute_init(state, config, vfs).ok());
+    blueprints::BlueprintStore store(state.raw());
+    REQUIRE(loader.load_blueprints(state, vfs, store).ok());
+    return global_string(state, "checksum");
+}
+
+} // namespace
+
+TEST_CASE("Cached bytecode behaves like the source", "[lua][bytecode]") {
+    auto dir = fresh_dir("osc_test_bytecode_cache");
+    std::string expected = run_script(nullptr);
+    CHECK(expected.find("610:0.333|@/lua/test.lua:7|/lua/test.lua:11:") == 0);
+
+    BytecodeCache cold(dir);
+    CHECK(run_script(&cold) == expected);
+    CHECK(cold.stats().misses == 1);
+    CHECK(cold.stats().stores == 1);
+    CHECK(fs::exists(cold.entry_path("@/lua/test.lua")));
+
+    // A new cache over the same directory (next process run)
+    BytecodeCache warm(dir);
+    CHECK(run_script(&warm) == expected);
+    CHECK(warm.stats().hits == 1);
+    CHECK(warm.stats().misses == 0);
+}
+
+TEST_CASE("Changed sources invalidate their entries", "[lua][bytecode]") {
+    auto dir = fresh_dir("osc_test_bytecode_stale");
+    BytecodeCache cache(dir);
+    run_script(&cache);
+
+    std::string edited = std::string(SCRIPT) + "result = 'edited'\n";
+    CHECK(run_script(&cache, edited).find("edited|") == 0);
+    CHECK(cache.stats().rejected == 1);
+    CHECK(cache.stats().misses == 2);
+
+    // The replaced entry now serves the edited source
+    CHECK(run_script(&cache, edited).find("edited|") == 0);
+    CHECK(cache.stats().hits == 1);
+
+    // Unreadable entries are recompiled, not trusted
+    write_file(cache.entry_path("@/lua/test.lua"), "garbage");
+    CHECK(run_script(&cache, edited).find("edited|") == 0);
+    CHECK(cache.stats().rejected == 2);
+}
+
+TEST_CASE("Truncated and corrupt entries are recompiled", "[lua][bytecode]") {
+    auto dir = fresh_dir("osc_test_bytecode_corrupt");
+    BytecodeCache cache(dir);
+    std::string expected = run_script(&cache);
+    const auto path = cache.entry_path("@/lua/test.lua");
+    std::string entry;
+    {
+        std::ifstream in(path, std::ios::binary);
+        entry.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    constexpr size_t HEADER = 32;     // magic, version, hash, source len, bytecode len
+    constexpr size_t LEN_OFFSET = 24; // bytecode_len
+    REQUIRE(entry.size() > HEADER + 16);
+
+    // Cut off mid-bytecode
+    write_file(path, entry.substr(0, HEADER + 16));
+    CHECK(run_script(&cache) == expected);
+    CHECK(cache.stats().rejected == 1);
+
+    // A huge length must not size the read buffer
+    std::string huge = entry;
+    u64 len = ~0ull >> 2;
+    std::memcpy(huge.data() + LEN_OFFSET, &len, sizeof(len));
+    write_file(path, huge);
+    CHECK(run_script(&cache) == expected);
+    CHECK(cache.stats().rejected == 2);
+
+    // Each rejected entry was replaced by a good one
+    CHECK(run_script(&cache) == expected);
+    CHECK(cache.stats().hits == 1);
+}
+
+TEST_CASE("Only file chunks are cached", "[lua][bytecode]") {
+    auto dir = fresh_dir("osc_test_bytecode_strings");
+    BytecodeCache cache(dir);
+    LuaState state;
+    state.set_bytecode_cache(&cache);
+    REQUIRE(state.do_string("x = 1").ok());
+    const char* code = "y = 2";
+    REQUIRE(state.do_buffer(code, 5, "=inline").ok());
+    CHECK(cache.stats().misses == 0);
+    CHECK(cache.stats().stores == 0);
+    CHECK(fs::is_empty(dir));
+}
+
+TEST_CASE("Warm init_loader runs load every script from cache",
+          "[lua][bytecode][init]") {
+    auto root = make_game_tree();
+    auto dir = fresh_dir("osc_test_bytecode_init");
+    constexpr u32 SCRIPTS = MODULES + 7; // + init.lua and system files
+
+    InitLoader cold;
+    std::string checksum = run_init(root, cold, dir);
+    CHECK(cold.bytecode_cache()->stats().misses == SCRIPTS);
+    CHECK(cold.bytecode_cache()->stats().hits == 0);
+
+    InitLoader warm;
+    CHECK(run_init(root, warm, dir) == checksum);
+    CHECK(warm.bytecode_cache()->stats().hits == SCRIPTS);
+    CHECK(warm.bytecode_cache()->stats().misses == 0);
+
+    // The cache outlives a session reload within the same loader
+    CHECK(run_init(root, warm, dir) == checksum);
+    CHECK(warm.bytecode_cache()->stats().hits == 2 * SCRIPTS);
+}
+
+TEST_CASE("Init loader cold vs warm benchmark", "[.benchmark][lua][bytecode]") {
+    auto root = make_game_tree();
+    auto dir = fresh_dir("osc_test_bytecode_bench");
+
+    BENCHMARK("init_loader, no cache") {
+        InitLoader loader;
+        return run_init(root, loader, {});
+    };
+    BENCHMARK("init_loader, cold cache") {
+        fs::remove_all(dir);
+        InitLoader loader;
+        return run_init(root, loader, dir);
+    };
+    BENCHMARK("init_loader, warm cache") {
+        InitLoader loader;
+        return run_init(root, loader, dir);
+    };
+}
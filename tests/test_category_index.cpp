@@ -0,0 +1,312 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "lua/category_utils.hpp"
+#include "lua/lua_state.hpp"
+#include "sim/army_brain.hpp"
+#include "sim/category_index.hpp"
+#include "sim/entity_registry.hpp"
+#include "sim/manipulator.hpp"
+#include "sim/unit.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include <lua.h>
+#include <lauxlib.h>
+}
+
+using namespace osc;
+using namespace osc::sim;
+
+namespace {
+
+// Category trees shaped like the ones FA's categories table builds
+// (`categories.MOBILE * categories.LAND - categories.ENGINEER`, ...).
+constexpr const char* SCRIPT = R"(
+local function cat(n) return { __name = n } end
+local function op(o, l, r) return { __op = o, __left = l, __right = r } end
+exprs = {
+    cat('LAND'),
+    op('intersection', cat('MOBILE'), cat('LAND')),
+    op('difference', op('intersection', cat('MOBILE'), cat('LAND')), cat('ENGINEER')),
+    op('union', cat('TECH1'), op('intersection', cat('STRUCTURE'), cat('FACTORY'))),
+    cat('ALLUNITS'),
+    op('difference', cat('ALLUNITS'), cat('COMMAND')),
+    op('intersection', cat('EXPERIMENTAL'), cat('AIR')),
+    op('bogus', cat('LAND'), cat('AIR')),
+    op('union', cat('NAVAL'), 42),
+}
+same_as_2 = op('intersection', cat('MOBILE'), cat('LAND'))
+)";
+
+constexpr const char* CATEGORY_POOL[] = {
+    "LAND", "AIR", "NAVAL", "MOBILE", "STRUCTURE", "FACTORY", "ENGINEER",
+    "TECH1", "TECH2", "EXPERIMENTAL", "COMMAND",
+};
+constexpr u32 POOL_SIZE = sizeof(CATEGORY_POOL) / sizeof(CATEGORY_POOL[0]);
+
+struct Match {
+    lua::LuaState state;
+    EntityRegistry registry;
+    std::mt19937 rng{7};
+    std::vector<u32> ids;
+    u32 expr_count = 0;
+
+    Match() {
+        REQUIRE(state.do_string(SCRIPT).ok());
+        registry.init_spatial_grid(1024, 1024);
+        lua_State* L = state.raw();
+        lua_pushstring(L, "exprs");
+        lua_rawget(L, LUA_GLOBALSINDEX);
+        expr_count = static_cast<u32>(luaL_getn(L, -1));
+        lua_pop(L, 1);
+    }
+
+    u32 spawn(i32 army) {
+        auto unit = std::make_unique<Unit>();
+        unit->set_army(army);
+        std::uniform_real_distribution<f32> pos(0.0f, 1024.0f);
+        unit->set_position({pos(rng), 0, pos(rng)});
+        for (u32 c = 0; c < POOL_SIZE; ++c) {
+            if (rng() % 3 == 0) unit->add_category(CATEGORY_POOL[c]);
+        }
+        u32 id = registry.register_entity(std::move(unit));
+        ids.push_back(id);
+        return id;
+    }
+
+    Unit* pick() {
+        if (ids.empty()) return nullptr;
+        return static_cast<Unit*>(registry.find(ids[rng() % ids.size()]));
+    }
+
+    /// Push exprs[i] (1-based) onto the stack.
+    void push_expr(u32 i) {
+        lua_State* L = state.raw();
+        lua_pushstring(L, "exprs");
+        lua_rawget(L, LUA_GLOBALSINDEX);
+        lua_rawgeti(L, -1, static_cast<int>(i));
+        lua_remove(L, -2);
+    }
+
+    /// The existing path: ArmyBrain::get_units, then the Lua tree walk.
+    std::vector<u32> scan(i32 army, int cat_idx) {
+        ArmyBrain brain;
+        brain.set_index(army);
+        std::vector<u32> out;
+        for (auto* e : brain.get_units(registry)) {
+            auto* u = static_cast<Unit*>(e);
+            if (lua::unit_matches_category(state.raw(), cat_idx, u->categories()))
+                out.push_back(e->entity_id());
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    std::vector<u32> indexed(i32 army, int cat_idx) {
+        return registry.category_members(
+            army, lua::compile_category(state.raw(), cat_idx));
+    }
+};
+
+} // namespace
+
+TEST_CASE("Compiled categories match the Lua tree walk", "[sim][category_index]") {
+    Match m;
+    for (i32 army = 0; army < 2; ++army)
+        for (u32 i = 0; i < 300; ++i) m.spawn(army);
+
+    lua_State* L = m.state.raw();
+    for (u32 i = 1; i <= m.expr_count; ++i) {
+        m.push_expr(i);
+        int idx = lua_gettop(L);
+        auto expr = lua::compile_category(L, idx);
+        m.registry.for_each([&](Entity& e) {
+            const auto& cats = static_cast<Unit&>(e).categories();
+            CHECK(expr.matches(cats) == lua::unit_matches_category(L, idx, cats));
+        });
+        lua_pop(L, 1);
+    }
+
+    // Same shape, same key: both tables share one entry
+    m.push_expr(2);
+    auto a = lua::compile_category(L, -1);
+    lua_pop(L, 1);
+    lua_pushstring(L, "same_as_2");
+    lua_rawget(L, LUA_GLOBALSINDEX);
+    auto b = lua::compile_category(L, -1);
+    lua_pop(L, 1);
+    CHECK(a.key() == b.key());
+    m.registry.category_members(0, a);
+    m.registry.category_members(0, b);
+    CHECK(m.registry.category_index().entry_count() == 1);
+    CHECK(m.registry.category_index().stats().fills == 1);
+}
+
+TEST_CASE("Category index tracks a scripted match", "[sim][category_index]") {
+    constexpr i32 ARMIES = 3;
+    Match m;
+    for (i32 army = 0; army < ARMIES; ++army)
+        for (u32 i = 0; i < 200; ++i) m.spawn(army);
+
+    lua_State* L = m.state.raw();
+    u32 compared = 0, mismatches = 0;
+    auto compare_all = [&] {
+        for (u32 i = 1; i <= m.expr_count; ++i) {
+            m.push_expr(i);
+            for (i32 army = 0; army < ARMIES; ++army) {
+                ++compared;
+                if (m.indexed(army, lua_gettop(L)) != m.scan(army, lua_gettop(L)))
+                    ++mismatches;
+            }
+            lua_pop(L, 1);
+        }
+    };
+    compare_all();
+
+    for (u32 step = 0; step < 600; ++step) {
+        switch (m.rng() % 6) {
+            case 0: m.spawn(static_cast<i32>(m.rng() % ARMIES)); break;
+            case 1: // death
+                if (auto* u = m.pick()) u->mark_destroyed();
+                break;
+            case 2: // wreck cleanup
+                if (auto* u = m.pick(); u && u->destroyed())
+                    m.registry.unregister_entity(u->entity_id());
+                break;
+            case 3: // capture
+                if (auto* u = m.pick(); u && !u->destroyed())
+                    u->set_army(static_cast<i32>(m.rng() % ARMIES));
+                break;
+            case 4: // upgrade / enhancement adds a category
+                if (auto* u = m.pick())
+                    u->add_category(CATEGORY_POOL[m.rng() % POOL_SIZE]);
+                break;
+            default: break;
+        }
+        if (step % 20 == 0) compare_all();
+    }
+    compare_all();
+
+    CHECK(mismatches == 0);
+    CHECK(compared > 500);
+    // Every entry was filled once; the rest came from queued updates
+    const auto& stats = m.registry.category_index().stats();
+    CHECK(stats.fills == m.registry.category_index().entry_count());
+    CHECK(stats.updates > 0);
+}
+
+TEST_CASE("Category index evicts the least recently queried entries",
+          "[sim][category_index]") {
+    Match m;
+    for (u32 i = 0; i < 300; ++i) m.spawn(0);
+    auto& index = m.registry.category_index();
+
+    // Ad-hoc expressions, as AI scripts build them: NAME op NAME
+    static constexpr CategoryExpr::Op OPS[] = {CategoryExpr::Op::Union,
+                                               CategoryExpr::Op::Intersection,
+                                               CategoryExpr::Op::Difference};
+    auto ad_hoc = [](u32 i) {
+        CategoryExpr e;
+        e.push_name(CATEGORY_POOL[i % POOL_SIZE]);
+        e.push_name(CATEGORY_POOL[(i / POOL_SIZE) % POOL_SIZE]);
+        e.push_op(OPS[i / (POOL_SIZE * POOL_SIZE)]);
+        return e;
+    };
+    auto scan = [&](const CategoryExpr& e) {
+        std::vector<u32> out;
+        m.registry.for_each([&](const Entity& ent) {
+            if (ent.is_unit() && !ent.destroyed() && ent.army() == 0 &&
+                e.matches(*ent.category_set()))
+                out.push_back(ent.entity_id());
+        });
+        std::sort(out.begin(), out.end());
+        return out;
+    };
+
+    CategoryExpr hot;
+    hot.push_name("LAND");
+    constexpr u32 AD_HOC = 300;
+    for (u32 i = 0; i < AD_HOC; ++i) {
+        m.registry.category_members(0, hot);
+        m.registry.category_members(0, ad_hoc(i));
+    }
+    CHECK(index.entry_count() == CategoryIndex::MAX_ENTRIES);
+    CHECK(index.stats().fills == AD_HOC + 1); // the hot entry was never dropped
+    CHECK(index.stats().evictions == AD_HOC + 1 - CategoryIndex::MAX_ENTRIES);
+
+    // A flush only re-tests the entries still held
+    u64 updates = index.stats().updates;
+    m.pick()->add_category("SUBCOMMANDER");
+    m.registry.category_members(0, hot);
+    CHECK(index.stats().updates - updates == CategoryIndex::MAX_ENTRIES);
+
+    // An evicted expression is rebuilt on demand and stays correct
+    CHECK(m.registry.category_members(0, ad_hoc(0)) == scan(ad_hoc(0)));
+    CHECK(index.stats().fills == AD_HOC + 2);
+    CHECK(m.registry.category_members(0, hot) == scan(hot));
+}
+
+TEST_CASE("Category index serves area queries", "[sim][category_index]") {
+    Match m;
+    for (i32 army = 0; army < 2; ++army)
+        for (u32 i = 0; i < 500; ++i) m.spawn(army);
+    lua_State* L = m.state.raw();
+
+    // What GetUnitsAroundPoint does: spatial cells, then index membership
+    SpatialFilter units;
+    units.kinds = spatial_kind::UNIT;
+    for (u32 i = 1; i <= m.expr_count; ++i) {
+        m.push_expr(i);
+        int idx = lua_gettop(L);
+        auto expr = lua::compile_category(L, idx);
+        for (u32 q = 0; q < 20; ++q) {
+            f32 x = static_cast<f32>(m.rng() % 1024), z = static_cast<f32>(m.rng() % 1024);
+            std::vector<u32> via_index, via_walk;
+            for (u32 id : m.registry.collect_in_radius(x, z, 150.0f, units)) {
+                auto* u = static_cast<Unit*>(m.registry.find(id));
+                const auto& members = m.registry.category_members(u->army(), expr);
+                if (std::binary_search(members.begin(), members.end(), id))
+                    via_index.push_back(id);
+                if (lua::unit_matches_category(L, idx, u->categories()))
+                    via_walk.push_back(id);
+            }
+            CHECK(via_index == via_walk);
+        }
+        lua_pop(L, 1);
+    }
+}
+
+TEST_CASE("Category query benchmark", "[.benchmark][sim][category_index]") {
+    constexpr u32 QUERIES = 10000;
+    Match m;
+    for (i32 army = 0; army < 2; ++army)
+        for (u32 i = 0; i < 2000; ++i) m.spawn(army);
+    lua_State* L = m.state.raw();
+
+    BENCHMARK("10k GetListOfUnits, registry scan") {
+        size_t total = 0;
+        for (u32 q = 0; q < QUERIES; ++q) {
+            m.push_expr(1 + q % m.expr_count);
+            total += m.scan(static_cast<i32>(q & 1), lua_gettop(L)).size();
+            lua_pop(L, 1);
+        }
+        return total;
+    };
+    BENCHMARK("10k GetListOfUnits, category index") {
+        size_t total = 0;
+        for (u32 q = 0; q < QUERIES; ++q) {
+            m.push_expr(1 + q % m.expr_count);
+            total += m.registry
+                         .category_members(static_cast<i32>(q & 1),
+                                           lua::compile_category(L, lua_gettop(L)))
+                         .size();
+            lua_pop(L, 1);
+        }
+        return total;
+    };
+}
@@ -48,10 +48,11 @@ TEST_CASE("Unit: dying transitions to wreckage when timer expires", "[death]") {
 }
 
 TEST_CASE("Unit: dying clears command queue", "[death]") {
+    CommandStore store;
     Unit u;
     UnitCommand cmd;
     cmd.type = CommandType::Move;
-    u.push_command(cmd, false);
+    u.push_command(store, cmd, false);
     CHECK(u.command_queue().size() == 1);
 
     u.begin_dying(1.0f);
@@ -0,0 +1,194 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "sim/army_brain.hpp"
+#include "sim/economy_ledger.hpp"
+#include "sim/entity.hpp"
+#include "sim/entity_registry.hpp"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace osc;
+using namespace osc::sim;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+/// Unit stand-in with a directly settable contribution; like
+/// Unit::edit_economy(), every change queues it for the ledger.
+class EconUnit : public Entity {
+public:
+    bool is_unit() const override { return true; }
+    EconomyFlow economy_flow() const override { return flow_; }
+    void set_flow(const EconomyFlow& f) {
+        flow_ = f;
+        if (registry()) registry()->notify_economy_changed(*this);
+    }
+
+private:
+    EconomyFlow flow_;
+};
+
+EconomyFlow flow(f64 mass_in, f64 energy_in, f64 mass_req = 0.0,
+                 f64 energy_req = 0.0, f64 mass_store = 0.0,
+                 f64 energy_store = 0.0) {
+    EconomyFlow f;
+    f.mass_income = EconomyFlow::to_fixed(mass_in);
+    f.energy_income = EconomyFlow::to_fixed(energy_in);
+    f.mass_requested = EconomyFlow::to_fixed(mass_req);
+    f.energy_requested = EconomyFlow::to_fixed(energy_req);
+    f.mass_storage = EconomyFlow::to_fixed(mass_store);
+    f.energy_storage = EconomyFlow::to_fixed(energy_store);
+    return f;
+}
+
+EconomyFlow random_flow(std::mt19937& rng) {
+    std::uniform_real_distribution<f64> rate(0.0, 50.0);
+    std::uniform_int_distribution<int> coin(0, 1);
+    return flow(coin(rng) ? rate(rng) : 0.0, rate(rng), rate(rng) * 0.1,
+                coin(rng) ? rate(rng) : 0.0, coin(rng) ? 500.0 : 0.0, 0.0);
+}
+
+u32 spawn(EntityRegistry& reg, i32 army, const EconomyFlow& f) {
+    auto e = std::make_unique<EconUnit>();
+    e->set_army(army);
+    e->set_flow(f);
+    return reg.register_entity(std::move(e));
+}
+
+/// The per-tick full sum the ledger replaces.
+EconomyFlow full_sum(const EntityRegistry& reg, i32 army) {
+    EconomyFlow sum;
+    reg.for_each([&](const Entity& e) {
+        if (e.army() == army && !e.destroyed()) sum += e.economy_flow();
+    });
+    return sum;
+}
+
+} // namespace
+
+TEST_CASE("Economy ledger tracks unit changes exactly", "[sim][economy]") {
+    constexpr i32 ARMIES = 3;
+    EntityRegistry reg;
+    std::mt19937 rng(66);
+    std::vector<u32> ids;
+    for (u32 i = 0; i < 2000; ++i)
+        ids.push_back(spawn(reg, static_cast<i32>(i % ARMIES), random_flow(rng)));
+    reg.flush_economy();
+
+    std::uniform_int_distribution<u32> pick(0, 1999);
+    std::uniform_int_distribution<int> action(0, 9);
+    for (u32 tick = 0; tick < 300; ++tick) {
+        for (u32 k = 0; k < 20; ++k) {
+            u32 id = ids[pick(rng)];
+            auto* u = static_cast<EconUnit*>(reg.find(id));
+            if (!u) continue;
+            switch (action(rng)) {
+            case 0: // captured
+                u->set_army((u->army() + 1) % ARMIES);
+                break;
+            case 1: // killed
+                u->mark_destroyed();
+                break;
+            case 2: // removed outright
+                reg.unregister_entity(id);
+                break;
+            case 3: // replaced by a new unit
+                ids[pick(rng)] = spawn(reg, u->army(), random_flow(rng));
+                break;
+            default: // production toggle, build start/stop, upgrade...
+                u->set_flow(random_flow(rng));
+                break;
+            }
+        }
+        reg.flush_economy();
+        for (i32 a = 0; a < ARMIES; ++a)
+            REQUIRE(reg.economy_ledger().totals(a) == full_sum(reg, a));
+    }
+
+    // Nothing left once every unit is gone
+    reg.for_each([&](Entity& e) { e.mark_destroyed(); });
+    reg.flush_economy();
+    for (i32 a = 0; a < ARMIES; ++a)
+        CHECK(reg.economy_ledger().totals(a).empty());
+    CHECK(reg.economy_ledger().contributor_count() == 0);
+}
+
+TEST_CASE("Economy ledger totals do not drift", "[sim][economy]") {
+    // 0.1 has no exact binary form; a float running total would wander
+    EconomyLedger ledger;
+    for (u32 i = 0; i < 100000; ++i) {
+        ledger.post(1, 0, flow(0.1 * (i % 7), 0.3));
+        ledger.post(2, 0, flow(0.1, 0.7 * (i % 3)));
+    }
+    ledger.post(1, 0, flow(0.1, 0.1));
+    ledger.post(2, 0, flow(0.2, 0.2));
+    EconomyFlow expected = flow(0.1, 0.1);
+    expected += flow(0.2, 0.2);
+    CHECK(ledger.totals(0) == expected);
+
+    ledger.retract(1);
+    ledger.retract(2);
+    CHECK(ledger.totals(0).empty());
+    CHECK(ledger.totals(5).empty()); // unknown army
+}
+
+TEST_CASE("ArmyBrain resolves storage and efficiency from the ledger",
+          "[sim][economy]") {
+    EntityRegistry reg;
+    ArmyBrain brain;
+    brain.set_index(0);
+    brain.set_stored_resources(0.0, 0.0);
+
+    // Income 10 mass/s, 30 energy/s; requests 20 mass/s, 15 energy/s
+    spawn(reg, 0, flow(10.0, 30.0, 0.0, 0.0, 300.0, 800.0));
+    u32 factory = spawn(reg, 0, flow(0.0, 0.0, 20.0, 15.0));
+    spawn(reg, 1, flow(1000.0, 1000.0)); // another army's
+    reg.flush_economy();
+    brain.update_economy(reg, 0.1);
+
+    const auto& econ = brain.economy();
+    CHECK_THAT(econ.mass.income, WithinAbs(10.0, 1e-6));
+    CHECK_THAT(econ.mass.requested, WithinAbs(20.0, 1e-6));
+    CHECK_THAT(econ.mass.max_storage, WithinAbs(500.0, 1e-6));
+    CHECK_THAT(econ.energy.max_storage, WithinAbs(1000.0, 1e-6));
+    CHECK_THAT(brain.mass_efficiency(), WithinAbs(0.5, 1e-6));
+    CHECK_THAT(brain.energy_efficiency(), WithinAbs(1.0, 1e-6));
+    CHECK_THAT(econ.energy.stored, WithinAbs(1.5, 1e-6));
+
+    // The factory stops building: only its delta moves the totals
+    static_cast<EconUnit*>(reg.find(factory))->set_flow({});
+    reg.flush_economy();
+    brain.update_economy(reg, 0.1);
+    CHECK(econ.mass.requested == 0.0);
+    CHECK(brain.mass_efficiency() == 1.0);
+}
+
+TEST_CASE("Economy update benchmark", "[.benchmark][sim][economy]") {
+    // Each tick a handful of units change state (builds start and stop,
+    // toggles); the cost follows those changes, not the base size. In
+    // debug builds update_economy() also runs the full-sum cross-check.
+    for (u32 structures : {1000u, 10000u}) {
+        EntityRegistry reg;
+        ArmyBrain brain;
+        brain.set_index(0);
+        std::mt19937 rng(structures);
+        std::vector<u32> ids;
+        for (u32 i = 0; i < structures; ++i)
+            ids.push_back(spawn(reg, 0, random_flow(rng)));
+        reg.flush_economy();
+
+        std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+        BENCHMARK("economy tick, " + std::to_string(structures) +
+                  " structures, 8 changes") {
+            for (u32 k = 0; k < 8; ++k)
+                static_cast<EconUnit*>(reg.find(ids[pick(rng)]))->set_flow(random_flow(rng));
+            reg.flush_economy();
+            brain.update_economy(reg, 0.1);
+            return brain.economy().mass.income;
+        };
+    }
+}
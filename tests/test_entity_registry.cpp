@@ -0,0 +1,315 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "sim/entity.hpp"
+#include "sim/entity_registry.hpp"
+#include "sim/prop.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+
+using namespace osc;
+using namespace osc::sim;
+
+namespace {
+
+/// Minimal moving entity reported as a unit to the spatial index.
+class TestUnit : public Entity {
+public:
+    bool is_unit() const override { return true; }
+};
+
+class TestProjectile : public Entity {
+public:
+    bool is_projectile() const override { return true; }
+};
+
+template <typename T>
+u32 spawn(EntityRegistry& reg, f32 x, f32 z, i32 army) {
+    auto e = std::make_unique<T>();
+    e->set_position({x, 0, z});
+    e->set_army(army);
+    return reg.register_entity(std::move(e));
+}
+
+/// Reference answer: every live entity within `radius`, sorted.
+std::vector<u32> brute_radius(const EntityRegistry& reg, f32 x, f32 z,
+                              f32 radius) {
+    std::vector<u32> out;
+    reg.for_each([&](const Entity& e) {
+        f32 dx = e.position().x - x;
+        f32 dz = e.position().z - z;
+        if (!e.destroyed() && dx * dx + dz * dz <= radius * radius)
+            out.push_back(e.entity_id());
+    });
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+std::vector<u32> sorted(std::vector<u32> v) {
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+/// 1024x1024 map with a mix of moving units and static props.
+void populate(EntityRegistry& reg, u32 units, u32 props, u32 seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<f32> pos(0.0f, 1024.0f);
+    for (u32 i = 0; i < units; ++i)
+        spawn<TestUnit>(reg, pos(rng), pos(rng), static_cast<i32>(i % 4));
+    for (u32 i = 0; i < props; ++i)
+        spawn<Prop>(reg, pos(rng), pos(rng), -1);
+}
+
+} // namespace
+
+TEST_CASE("Spatial index matches brute force at every query radius",
+          "[sim][spatial]") {
+    EntityRegistry reg;
+    populate(reg, 1500, 500, 7);
+    reg.init_spatial_grid(1024, 1024);
+    CHECK(reg.static_count() == 500);
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<f32> pos(-50.0f, 1074.0f);
+    for (f32 radius : {3.0f, 8.0f, 50.0f, 300.0f, 900.0f}) {
+        for (int i = 0; i < 20; ++i) {
+            f32 x = pos(rng), z = pos(rng);
+            CHECK(sorted(reg.collect_in_radius(x, z, radius)) ==
+                  brute_radius(reg, x, z, radius));
+        }
+    }
+}
+
+TEST_CASE("Spatial index follows moves, state changes and removal",
+          "[sim][spatial]") {
+    EntityRegistry reg;
+    reg.init_spatial_grid(512, 512);
+    u32 uid = spawn<TestUnit>(reg, 100, 100, 0);
+    u32 pid = spawn<Prop>(reg, 102, 100, -1);
+    auto* u = reg.find(uid);
+
+    SpatialFilter units;
+    units.kinds = spatial_kind::UNIT;
+    CHECK(reg.collect_in_radius(100, 100, 5, units) == std::vector<u32>{uid});
+    SpatialFilter props;
+    props.kinds = spatial_kind::PROP;
+    CHECK(reg.collect_in_radius(100, 100, 5, props) == std::vector<u32>{pid});
+
+    // Crossing cells at every level
+    u->set_position({400, 0, 300});
+    CHECK(reg.collect_in_radius(100, 100, 5, units).empty());
+    CHECK(reg.collect_in_rect(390, 290, 410, 310) == std::vector<u32>{uid});
+    CHECK(reg.collect_in_radius(400, 300, 200) == std::vector<u32>{uid});
+
+    SpatialFilter army1;
+    army1.only_army = 1;
+    CHECK(reg.collect_in_radius(400, 300, 5, army1).empty());
+    u->set_army(1);
+    CHECK(reg.collect_in_radius(400, 300, 5, army1) == std::vector<u32>{uid});
+    SpatialFilter not_army1;
+    not_army1.exclude_army = 1;
+    CHECK(reg.collect_in_radius(400, 300, 5, not_army1).empty());
+
+    u->mark_destroyed();
+    CHECK(reg.collect_in_radius(400, 300, 5).empty());
+
+    reg.unregister_entity(pid);
+    CHECK(reg.static_count() == 0);
+    CHECK(reg.collect_in_radius(100, 100, 50).empty());
+    reg.unregister_entity(uid);
+    CHECK(reg.count() == 0);
+}
+
+TEST_CASE("Spatial index keeps slots consistent under churn",
+          "[sim][spatial]") {
+    EntityRegistry reg;
+    reg.init_spatial_grid(1024, 1024);
+    populate(reg, 800, 100, 3);
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<f32> step(-20.0f, 20.0f);
+    std::vector<u32> ids;
+    reg.for_each([&](const Entity& e) {
+        if (e.is_unit()) ids.push_back(e.entity_id());
+    });
+    for (int tick = 0; tick < 30; ++tick) {
+        for (u32 id : ids) {
+            auto* e = reg.find(id);
+            if (!e) continue;
+            auto p = e->position();
+            e->set_position({std::clamp(p.x + step(rng), 0.0f, 1023.0f), 0,
+                             std::clamp(p.z + step(rng), 0.0f, 1023.0f)});
+        }
+        // Remove a few so swap-and-pop moves other entries around
+        reg.unregister_entity(ids[static_cast<size_t>(tick) * 7]);
+    }
+    for (f32 radius : {8.0f, 50.0f, 300.0f}) {
+        CHECK(sorted(reg.collect_in_radius(512, 512, radius)) ==
+              brute_radius(reg, 512, 512, radius));
+    }
+    CHECK(sorted(reg.collect_in_rect(0, 0, 1024, 1024)) ==
+          brute_radius(reg, 512, 512, 1024));
+}
+
+TEST_CASE("Move batches defer re-bucketing to the end of the phase",
+          "[sim][spatial]") {
+    EntityRegistry reg;
+    reg.init_spatial_grid(512, 512);
+    u32 a = spawn<TestUnit>(reg, 100, 100, 0);
+    u32 b = spawn<TestUnit>(reg, 200, 200, 0);
+    u32 gone = spawn<TestUnit>(reg, 300, 300, 0);
+    u32 shot = spawn<TestProjectile>(reg, 50, 50, 0);
+
+    reg.begin_move_batch();
+    // Several writes per entity per phase, as navigator + snapping do
+    for (int i = 1; i <= 5; ++i) {
+        reg.find(a)->set_position({100.0f + 40.0f * i, 0, 100});
+        reg.find(shot)->set_position({50.0f + 20.0f * i, 0, 50});
+    }
+    reg.find(gone)->set_position({310, 0, 300});
+    reg.unregister_entity(gone);
+
+    // Queries inside the phase see start-of-phase positions
+    CHECK(reg.collect_in_radius(100, 100, 1) == std::vector<u32>{a});
+    CHECK(reg.collect_in_radius(300, 100, 1).empty());
+    CHECK(reg.collect_in_radius(50, 50, 1) == std::vector<u32>{shot});
+    reg.end_move_batch();
+
+    CHECK(reg.collect_in_radius(100, 100, 1).empty());
+    CHECK(reg.collect_in_radius(300, 100, 1) == std::vector<u32>{a});
+    CHECK(reg.collect_in_radius(150, 50, 1) == std::vector<u32>{shot});
+    CHECK(reg.collect_in_radius(200, 200, 1) == std::vector<u32>{b});
+    CHECK(reg.collect_in_radius(300, 300, 50).empty());
+
+    // Outside a batch, writes apply immediately
+    reg.find(b)->set_position({20, 0, 20});
+    CHECK(reg.collect_in_radius(20, 20, 1) == std::vector<u32>{b});
+    reg.unregister_entity(shot);
+    reg.begin_move_batch();
+    reg.end_move_batch();
+    CHECK(reg.count() == 2);
+}
+
+TEST_CASE("Render state setters bump the render version", "[sim][entity]") {
+    Prop prop;
+    u32 v = prop.render_version();
+    auto bumped = [&] {
+        bool changed = prop.render_version() != v;
+        v = prop.render_version();
+        return changed;
+    };
+    prop.set_position({1, 2, 3});
+    CHECK(bumped());
+    prop.set_orientation(Quaternion{});
+    CHECK(bumped());
+    prop.set_scale(2, 2, 2);
+    CHECK(bumped());
+    prop.set_mesh_override("/env/common/props/rock01_mesh");
+    CHECK(bumped());
+    prop.set_army(1);
+    CHECK(bumped());
+    prop.set_is_wreckage(true);
+    CHECK(bumped());
+    // Gameplay state the renderer does not cache leaves it alone
+    prop.set_health(10);
+    prop.set_reclaimable(false);
+    CHECK_FALSE(bumped());
+}
+
+TEST_CASE("Render journal queues changed entities once", "[sim][entity]") {
+    EntityRegistry reg;
+    std::vector<u32> ids;
+    // Nothing has been taken yet, so the caller must resync
+    CHECK_FALSE(reg.take_render_changes(ids));
+    ids.clear();
+
+    u32 a = spawn<TestUnit>(reg, 10, 10, 0);
+    u32 b = spawn<TestProjectile>(reg, 20, 20, 0);
+    REQUIRE(reg.take_render_changes(ids));
+    std::sort(ids.begin(), ids.end());
+    CHECK(ids == std::vector<u32>{a, b});
+
+    ids.clear();
+    REQUIRE(reg.take_render_changes(ids));
+    CHECK(ids.empty());
+
+    // Several changes to one entity queue it once
+    auto* unit = reg.find(a);
+    unit->set_position({11, 0, 10});
+    unit->set_orientation(Quaternion{});
+    unit->set_scale(2, 2, 2);
+    REQUIRE(reg.take_render_changes(ids));
+    CHECK(ids == std::vector<u32>{a});
+
+    // Build progress only matters when it starts or completes
+    ids.clear();
+    unit->set_fraction_complete(0.25f);
+    REQUIRE(reg.take_render_changes(ids));
+    CHECK(ids == std::vector<u32>{a});
+    ids.clear();
+    unit->set_fraction_complete(0.5f);
+    REQUIRE(reg.take_render_changes(ids));
+    CHECK(ids.empty());
+    unit->set_fraction_complete(1.0f);
+    REQUIRE(reg.take_render_changes(ids));
+    CHECK(ids == std::vector<u32>{a});
+
+    // Removal is queued; the id no longer resolves
+    ids.clear();
+    reg.unregister_entity(b);
+    REQUIRE(reg.take_render_changes(ids));
+    CHECK(ids == std::vector<u32>{b});
+    CHECK(reg.find(b) == nullptr);
+}
+
+TEST_CASE("Spatial index query benchmark", "[.benchmark][sim][spatial]") {
+    EntityRegistry reg;
+    populate(reg, 4000, 4000, 1);
+    reg.init_spatial_grid(1024, 1024);
+    SpatialFilter units;
+    units.kinds = spatial_kind::UNIT;
+
+    BENCHMARK("air separation, r=8") {
+        return reg.collect_in_radius(512, 512, 8, units).size();
+    };
+    BENCHMARK("weapon range, r=50") {
+        return reg.collect_in_radius(512, 512, 50, units).size();
+    };
+    BENCHMARK("radar range, r=300") {
+        return reg.collect_in_radius(512, 512, 300, units).size();
+    };
+}
+
+TEST_CASE("Move batch benchmark", "[.benchmark][sim][spatial]") {
+    EntityRegistry reg;
+    populate(reg, 4000, 0, 1);
+    for (u32 i = 0; i < 2000; ++i)
+        spawn<TestProjectile>(reg, static_cast<f32>(i % 1000), 500, 0);
+    reg.init_spatial_grid(1024, 1024);
+    std::vector<Entity*> movers;
+    reg.for_each([&](Entity& e) { movers.push_back(&e); });
+
+    // Three position writes per entity per tick
+    f32 t = 0;
+    auto tick = [&] {
+        t += 0.1f;
+        for (auto* e : movers) {
+            auto p = e->position();
+            for (int w = 0; w < 3; ++w)
+                e->set_position({std::fmod(p.x + t, 1024.0f), 0, p.z});
+        }
+    };
+    BENCHMARK("immediate") {
+        tick();
+        return reg.count();
+    };
+    BENCHMARK("batched") {
+        reg.begin_move_batch();
+        tick();
+        reg.end_move_batch();
+        return reg.count();
+    };
+}
@@ -0,0 +1,367 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "lua/lua_state.hpp"
+#include "map/heightmap.hpp"
+#include "map/pathfinder.hpp"
+#include "map/pathfinding_grid.hpp"
+#include "map/terrain.hpp"
+#include "sim/formation.hpp"
+#include "sim/manipulator.hpp"
+#include "sim/sim_state.hpp"
+#include "sim/unit.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+
+using namespace osc;
+using namespace osc::sim;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+f64 total_cost(const std::vector<Vector3>& members,
+               const std::vector<Vector3>& slots,
+               const std::vector<u32>& assignment) {
+    f64 sum = 0;
+    for (size_t i = 0; i < members.size(); ++i) {
+        f64 dx = members[i].x - slots[assignment[i]].x;
+        f64 dz = members[i].z - slots[assignment[i]].z;
+        sum += std::sqrt(dx * dx + dz * dz);
+    }
+    return sum;
+}
+
+std::vector<Vector3> random_points(u32 n, u32 seed, f32 extent) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<f32> d(-extent, extent);
+    std::vector<Vector3> pts(n);
+    for (auto& p : pts) p = {d(rng), 0, d(rng)};
+    return pts;
+}
+
+std::vector<std::unique_ptr<Unit>> land_units(
+    const std::vector<Vector3>& positions) {
+    std::vector<std::unique_ptr<Unit>> units;
+    for (const auto& p : positions) {
+        auto u = std::make_unique<Unit>();
+        u->set_layer("Land");
+        u->set_max_speed(3.0f);
+        u->set_footprint_size(1, 1);
+        u->set_position(p);
+        units.push_back(std::move(u));
+    }
+    return units;
+}
+
+/// Every leg a member would walk, from where it stands to its last
+/// waypoint, crosses only passable cells.
+bool legs_clear(const std::vector<Vector3>& path, Vector3 at,
+                const map::Pathfinder& pf) {
+    if (path.empty()) return false;
+    for (const auto& w : path) {
+        if (!pf.segment_passable(at.x, at.z, w.x, w.z, "Land")) return false;
+        at = w;
+    }
+    return true;
+}
+
+bool same_path(const std::vector<Vector3>& a, const std::vector<Vector3>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                      [](const Vector3& p, const Vector3& q) {
+                          return p.x == q.x && p.z == q.z;
+                      });
+}
+
+bool legs_clear(const Unit& u, u32 command_id, const map::Pathfinder& pf) {
+    const auto* path = u.formation_path(command_id);
+    return path && legs_clear(*path, u.position(), pf);
+}
+
+} // namespace
+
+TEST_CASE("Formation names parse like FA's", "[sim][formation]") {
+    CHECK(parse_formation("GrowthFormation") == FormationShape::Growth);
+    CHECK(parse_formation("AttackFormation") == FormationShape::Attack);
+    CHECK(parse_formation("NoFormation") == FormationShape::None);
+    CHECK(parse_formation("") == FormationShape::None);
+}
+
+TEST_CASE("Formation slots are distinct, spaced and centred",
+          "[sim][formation]") {
+    for (auto shape : {FormationShape::Line, FormationShape::Wedge,
+                       FormationShape::Growth, FormationShape::Attack}) {
+        for (u32 n : {1u, 2u, 7u, 25u, 200u}) {
+            auto slots = formation_slots(shape, n, 3.0f);
+            REQUIRE(slots.size() == n);
+            f32 cx = 0, cz = 0;
+            f32 min_d2 = 1e30f;
+            for (size_t i = 0; i < n; ++i) {
+                cx += slots[i].x;
+                cz += slots[i].z;
+                for (size_t j = i + 1; j < n; ++j) {
+                    f32 dx = slots[i].x - slots[j].x;
+                    f32 dz = slots[i].z - slots[j].z;
+                    min_d2 = std::min(min_d2, dx * dx + dz * dz);
+                }
+            }
+            CHECK_THAT(cx / static_cast<f32>(n), WithinAbs(0.0, 1e-3));
+            CHECK_THAT(cz / static_cast<f32>(n), WithinAbs(0.0, 1e-3));
+            if (n > 1) CHECK(min_d2 >= 9.0f - 1e-3f);
+        }
+    }
+
+    // Attack formation is wider than it is deep; Growth is roughly square
+    auto extent = [](const std::vector<Vector3>& s, bool x) {
+        auto [lo, hi] = std::minmax_element(s.begin(), s.end(),
+            [x](const Vector3& a, const Vector3& b) { return x ? a.x < b.x : a.z < b.z; });
+        return x ? hi->x - lo->x : hi->z - lo->z;
+    };
+    auto attack = formation_slots(FormationShape::Attack, 50, 2.0f);
+    CHECK(extent(attack, true) > 1.5f * extent(attack, false));
+    auto growth = formation_slots(FormationShape::Growth, 49, 2.0f);
+    CHECK_THAT(extent(growth, true), WithinAbs(extent(growth, false), 1e-3));
+}
+
+TEST_CASE("Slot assignment is optimal", "[sim][formation]") {
+    for (u32 seed = 0; seed < 20; ++seed) {
+        auto members = random_points(7, seed, 20.0f);
+        auto slots = random_points(7, seed + 100, 20.0f);
+        auto assignment = assign_slots(members, slots);
+
+        std::set<u32> distinct(assignment.begin(), assignment.end());
+        REQUIRE(distinct.size() == 7);
+
+        // Brute force over all 5040 permutations
+        std::vector<u32> perm(7);
+        std::iota(perm.begin(), perm.end(), 0u);
+        f64 best = 1e30;
+        do {
+            best = std::min(best, total_cost(members, slots, perm));
+        } while (std::next_permutation(perm.begin(), perm.end()));
+        CHECK_THAT(total_cost(members, slots, assignment), WithinAbs(best, 1e-6));
+    }
+}
+
+TEST_CASE("Formation plan keeps the group's arrangement", "[sim][formation]") {
+    // Five units in a row heading +z: the leftmost takes the leftmost slot
+    std::vector<Vector3> positions;
+    for (int i = 0; i < 5; ++i)
+        positions.push_back({100.0f + 4.0f * static_cast<f32>(i), 0, 100});
+    auto plan = plan_formation(positions, {108, 0, 300}, FormationShape::Line,
+                               3.0f);
+    CHECK_THAT(plan.facing, WithinAbs(0.0, 1e-5));
+    for (int i = 1; i < 5; ++i) CHECK(plan.slots[i].x > plan.slots[i - 1].x);
+
+    // Heading -x: formation-space right is world +z
+    auto west = plan_formation(positions, {-200, 0, 100}, FormationShape::Line,
+                               3.0f);
+    CHECK_THAT(west.facing, WithinAbs(-1.5707963, 1e-4));
+    auto right = rotate_heading({1, 0, 0}, west.facing);
+    CHECK_THAT(right.x, WithinAbs(0.0, 1e-5));
+    CHECK_THAT(right.z, WithinAbs(1.0, 1e-5));
+
+    // Fixed orientation overrides the direction of travel
+    auto fixed = plan_formation(positions, {108, 0, 300}, FormationShape::Line,
+                                3.0f, 1.0f);
+    CHECK(fixed.facing == 1.0f);
+}
+
+TEST_CASE("Formation legs route around obstacles", "[sim][formation]") {
+    CommandStore store; // outlives the units' queues
+    map::Heightmap hm(256, 256, 1.0f, std::vector<u16>(257 * 257, 0));
+
+    SECTION("centroid in a lake between two sub-groups") {
+        map::PathfindingGrid grid(hm, 0.0f, false);
+        grid.mark_obstacle(128, 100, 40, 40);
+        map::Pathfinder pf(grid);
+        auto units = land_units({{96, 0, 96}, {96, 0, 100}, {96, 0, 104},
+                                 {160, 0, 96}, {160, 0, 100}, {160, 0, 104}});
+        std::vector<Unit*> ptrs;
+        for (auto& u : units) ptrs.push_back(u.get());
+        CHECK(issue_formation_move(store, ptrs, {128, 0, 220},
+                                   FormationShape::Line, 7, true, &pf,
+                                   &grid) == 6);
+        for (auto* u : ptrs) {
+            REQUIRE(legs_clear(*u, 7, pf));
+            const auto& end = u->formation_path(7)->back();
+            CHECK(std::hypot(end.x - 128.0f, end.z - 220.0f) < 20.0f);
+        }
+    }
+
+    SECTION("slot leg through a wall the centre line misses") {
+        map::PathfindingGrid grid(hm, 0.0f, false);
+        grid.mark_obstacle(139, 120, 22, 2);
+        map::Pathfinder pf(grid);
+        std::vector<Vector3> positions;
+        for (int i = 0; i < 5; ++i)
+            positions.push_back({120.0f + 3.0f * static_cast<f32>(i), 0, 40});
+        auto units = land_units(positions);
+        std::vector<Unit*> ptrs;
+        for (auto& u : units) ptrs.push_back(u.get());
+        issue_formation_move(store, ptrs, {126, 0, 200}, FormationShape::Line,
+                             8, true, &pf, &grid);
+        for (auto* u : ptrs) CHECK(legs_clear(*u, 8, pf));
+    }
+
+    SECTION("no pathfinder leaves members to path on their own") {
+        auto units = land_units({{10, 0, 10}, {14, 0, 10}});
+        std::vector<Unit*> ptrs{units[0].get(), units[1].get()};
+        CHECK(issue_formation_move(store, ptrs, {10, 0, 100},
+                                   FormationShape::Line, 9, true, nullptr,
+                                   nullptr) == 2);
+        CHECK(units[0]->formation_path(9) == nullptr);
+        CHECK(units[0]->command_queue().size() == 1);
+    }
+}
+
+TEST_CASE("Queued formation moves start where the queue ends",
+          "[sim][formation]") {
+    CommandStore store;
+    map::Heightmap hm(256, 256, 1.0f, std::vector<u16>(257 * 257, 0));
+    map::PathfindingGrid grid(hm, 0.0f, false);
+    grid.mark_obstacle(128, 120, 160, 2);
+    map::Pathfinder pf(grid);
+
+    std::vector<Vector3> positions, ends;
+    for (int i = 0; i < 5; ++i) {
+        f32 x = 120.0f + 3.0f * static_cast<f32>(i);
+        positions.push_back({x, 0, 40});
+        ends.push_back({x, 0, 200});
+    }
+    auto units = land_units(positions);
+    std::vector<Unit*> ptrs;
+    for (size_t i = 0; i < units.size(); ++i) {
+        UnitCommand move;
+        move.type = CommandType::Move;
+        move.target_pos = ends[i];
+        move.command_id = 1;
+        units[i]->push_command(store, move, true);
+        ptrs.push_back(units[i].get());
+    }
+
+    // Shift-queued past the wall: legs start at each Move's target, so
+    // nothing detours back around the wall the units are about to cross
+    CHECK(issue_formation_move(store, ptrs, {126, 0, 230}, FormationShape::Line,
+                               2, false, &pf, &grid) == 5);
+    for (size_t i = 0; i < units.size(); ++i) {
+        CHECK(units[i]->command_queue().size() == 2);
+        const auto* path = units[i]->formation_path(2);
+        REQUIRE(path);
+        CHECK(legs_clear(*path, ends[i], pf));
+        for (const auto& w : *path) CHECK(w.z > 150.0f);
+    }
+
+    SECTION("a leg that starts off the plan is joined by a search") {
+        auto path = *units[0]->formation_path(2);
+        size_t planned = path.size();
+        REQUIRE_FALSE(legs_clear(path, positions[0], pf));
+        pf.reset_request_count();
+        REQUIRE(join_formation_leg(path, positions[0], &pf, "Land"));
+        CHECK(path.size() > planned);
+        CHECK(legs_clear(path, positions[0], pf));
+    }
+
+    SECTION("the join waits for the search budget") {
+        auto path = *units[0]->formation_path(2);
+        for (int i = 0; i < map::Pathfinder::MAX_REQUESTS_PER_TICK; ++i)
+            pf.increment_request_count();
+        CHECK_FALSE(join_formation_leg(path, positions[0], &pf, "Land"));
+        CHECK(same_path(path, *units[0]->formation_path(2)));
+        // A clear join needs no search
+        CHECK(join_formation_leg(path, ends[0], &pf, "Land"));
+        CHECK(same_path(path, *units[0]->formation_path(2)));
+    }
+}
+
+TEST_CASE("Formation legs stay within the search budget", "[sim][formation]") {
+    CommandStore store;
+    map::Heightmap hm(256, 256, 1.0f, std::vector<u16>(257 * 257, 0));
+    map::PathfindingGrid grid(hm, 0.0f, false);
+    grid.mark_obstacle(128, 100, 40, 40);
+    map::Pathfinder pf(grid);
+    std::vector<Vector3> positions;
+    for (int i = 0; i < 24; ++i) {
+        f32 z = 84.0f + 3.0f * static_cast<f32>(i % 12);
+        positions.push_back({i < 12 ? 96.0f : 160.0f, 0, z});
+    }
+    auto units = land_units(positions);
+    std::vector<Unit*> ptrs;
+    for (auto& u : units) ptrs.push_back(u.get());
+
+    // Only the shared path fits in this tick's budget
+    for (int i = 1; i < map::Pathfinder::MAX_REQUESTS_PER_TICK; ++i)
+        pf.increment_request_count();
+    issue_formation_move(store, ptrs, {128, 0, 220}, FormationShape::Growth, 3,
+                         true, &pf, &grid);
+    CHECK(pf.requests_this_tick() == map::Pathfinder::MAX_REQUESTS_PER_TICK);
+
+    // Nobody is dropped from the formation; members past the budget follow
+    // the centre line and are joined to it when the move starts
+    for (size_t i = 0; i < units.size(); ++i) {
+        const auto* planned = units[i]->formation_path(3);
+        REQUIRE(planned);
+        auto path = *planned;
+        pf.reset_request_count();
+        REQUIRE(join_formation_leg(path, positions[i], &pf, "Land"));
+        CHECK(legs_clear(path, positions[i], pf));
+    }
+}
+
+TEST_CASE("Player formation moves are planned on the next tick",
+          "[sim][formation]") {
+    lua::LuaState state;
+    SimState sim(state.raw(), nullptr);
+    map::Heightmap hm(256, 256, 1.0f, std::vector<u16>(257 * 257, 0));
+    sim.set_terrain(std::make_unique<map::Terrain>(std::move(hm), 0.0f));
+    sim.build_pathfinding_grid();
+
+    std::vector<u32> ids;
+    std::vector<Unit*> ptrs;
+    for (auto& u : land_units({{100, 0, 40}, {104, 0, 40}, {108, 0, 40}})) {
+        ptrs.push_back(u.get());
+        ids.push_back(sim.entity_registry().register_entity(std::move(u)));
+    }
+
+    SimState::FormationMoveOrder first;
+    first.unit_ids = ids;
+    first.goal = {104, 0, 150};
+    first.command_id = sim.next_command_id();
+    sim.queue_formation_move(first);
+    auto second = first;
+    second.goal = {104, 0, 200};
+    second.command_id = sim.next_command_id();
+    second.clear_existing = false;
+    sim.queue_formation_move(second);
+
+    // Nothing is planned on the input side
+    CHECK(sim.queued_formation_moves() == 2);
+    for (auto* u : ptrs) CHECK(u->command_queue().empty());
+
+    sim.tick();
+    CHECK(sim.queued_formation_moves() == 0);
+    for (auto* u : ptrs) {
+        REQUIRE(u->command_queue().size() == 2);
+        CHECK(u->is_moving()); // the first order started this tick
+        const auto* later = u->formation_path(second.command_id);
+        REQUIRE(later);
+        // The shift order was planned after, from where the first one ends
+        for (const auto& w : *later) CHECK(w.z > 140.0f);
+    }
+}
+
+TEST_CASE("Formation assignment benchmark", "[.benchmark][sim][formation]") {
+    auto members = random_points(200, 1, 60.0f);
+    auto slots = formation_slots(FormationShape::Growth, 200, 3.0f);
+    BENCHMARK("assign 200 units") { return assign_slots(members, slots); };
+    auto big = random_points(1000, 2, 150.0f);
+    auto big_slots = formation_slots(FormationShape::Attack, 1000, 3.0f);
+    BENCHMARK("assign 1000 units (sorted fallback)") {
+        return assign_slots(big, big_slots);
+    };
+}
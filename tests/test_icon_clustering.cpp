@@ -0,0 +1,286 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "renderer/camera.hpp"
+#include "renderer/icon_clustering.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace osc;
+using namespace osc::renderer;
+
+namespace {
+
+constexpr u32 UNITS = 20000;
+constexpr f32 MAP_SIZE = 1024.0f;
+constexpr f32 VIEW_W = 1920.0f;
+constexpr f32 VIEW_H = 1080.0f;
+constexpr u32 ICON_BUDGET = 4096; // StrategicIconRenderer::MAX_ICON_QUADS
+
+struct SimUnit {
+    u32 id;
+    i32 army;
+    StrategicIconType type;
+    f32 x, z;
+    bool selected;
+};
+
+/// A 20,000-unit army in blobs (a main army with a raiding enemy mixed
+/// in), seen from a zoomed-out strategic camera.
+struct Scene {
+    Camera camera;
+    std::array<f32, 16> vp{};
+    f32 icon_size = 0;
+    std::vector<SimUnit> units;
+    std::mt19937 rng{11};
+
+    Scene() {
+        camera.init(MAP_SIZE, MAP_SIZE);
+        camera.set_distance(700.0f);
+        vp = camera.view_proj(VIEW_W / VIEW_H);
+        // StrategicIconRenderer's zoom-scaled icon size
+        icon_size = std::clamp(24.0f * (250.0f / camera.distance()), 10.0f, 32.0f);
+
+        std::uniform_real_distribution<f32> coord(0.0f, MAP_SIZE);
+        std::normal_distribution<f32> spread(0.0f, 25.0f);
+        std::vector<std::pair<f32, f32>> blobs;
+        for (u32 b = 0; b < 40; ++b) blobs.emplace_back(coord(rng), coord(rng));
+        for (u32 i = 0; i < UNITS; ++i) {
+            auto [bx, bz] = blobs[rng() % blobs.size()];
+            SimUnit u;
+            u.id = i + 1;
+            u.army = (rng() % 5 == 0) ? 1 : 0;
+            u.type = static_cast<StrategicIconType>(rng() % ICON_TYPE_COUNT);
+            u.x = std::clamp(bx + spread(rng), 0.0f, MAP_SIZE);
+            u.z = std::clamp(bz + spread(rng), 0.0f, MAP_SIZE);
+            u.selected = (rng() % 50 == 0);
+            units.push_back(u);
+        }
+    }
+
+    /// StrategicIconRenderer::update's projection and culling.
+    bool project(const SimUnit& u, f32& sx, f32& sy) const {
+        if (!world_to_screen(u.x, 0.0f, u.z, vp, VIEW_W, VIEW_H, sx, sy))
+            return false;
+        return sx >= -icon_size && sx <= VIEW_W + icon_size &&
+               sy >= -icon_size && sy <= VIEW_H + icon_size;
+    }
+
+    /// One frame into `c`; returns the number of units added.
+    u32 frame(IconClusterer& c, u32 skip_every = 0) const {
+        c.begin_frame();
+        u32 added = 0;
+        for (const auto& u : units) {
+            if (skip_every && u.id % skip_every == 0) continue;
+            f32 sx, sy;
+            if (!project(u, sx, sy)) continue;
+            c.add(u.id, u.army, u.type, sx, sy, u.selected);
+            ++added;
+        }
+        c.end_frame();
+        return added;
+    }
+};
+
+struct RefCluster {
+    u32 count = 0;
+    u32 armies[2] = {};
+    u32 types[ICON_TYPE_COUNT] = {};
+    bool selected = false;
+};
+
+/// Direct binning of every visible unit into cells of BASE_CELL_PX << level.
+std::map<std::pair<i64, i64>, RefCluster> reference(const Scene& s, u32 level) {
+    const f32 cell = IconClusterer::BASE_CELL_PX * static_cast<f32>(1u << level);
+    std::map<std::pair<i64, i64>, RefCluster> out;
+    for (const auto& u : s.units) {
+        f32 sx, sy;
+        if (!s.project(u, sx, sy)) continue;
+        auto& r = out[{static_cast<i64>(std::floor(sy / cell)),
+                       static_cast<i64>(std::floor(sx / cell))}];
+        r.count++;
+        r.armies[u.army]++;
+        r.types[static_cast<u32>(u.type)]++;
+        r.selected |= u.selected;
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("Icon clusters match a direct grid binning", "[renderer][icon_clustering]") {
+    Scene s;
+    IconClusterer c;
+    const u32 visible = s.frame(c);
+    REQUIRE(visible > UNITS / 2);
+
+    for (u32 level = 0; level <= IconClusterer::MAX_LEVEL; ++level) {
+        const auto& clusters = c.build(level, UINT32_MAX);
+        CHECK(c.level() == level);
+        auto ref = reference(s, level);
+        REQUIRE(clusters.size() == ref.size());
+
+        u32 total = 0, mismatches = 0;
+        size_t i = 0;
+        for (const auto& [key, r] : ref) {
+            const auto& k = clusters[i++];
+            total += k.count;
+            i32 army = r.armies[1] > r.armies[0] ? 1 : 0;
+            u32 type = 0;
+            for (u32 t = 1; t < ICON_TYPE_COUNT; ++t)
+                if (r.types[t] > r.types[type]) type = t;
+            if (k.count != r.count || k.army != army ||
+                static_cast<u32>(k.type) != type || k.selected != r.selected)
+                ++mismatches;
+        }
+        CHECK(mismatches == 0);
+        CHECK(total == visible);
+    }
+
+    // Coarser levels never have more clusters
+    size_t prev = c.build(0, UINT32_MAX).size();
+    for (u32 level = 1; level <= IconClusterer::MAX_LEVEL; ++level) {
+        size_t n = c.build(level, UINT32_MAX).size();
+        CHECK(n <= prev);
+        prev = n;
+    }
+}
+
+TEST_CASE("Icon cluster cache only rebins units that cross cells",
+          "[renderer][icon_clustering]") {
+    Scene s;
+    IconClusterer c;
+    const u32 visible = s.frame(c);
+    CHECK(c.stats().moved == visible);
+    CHECK(c.unit_count() == visible);
+
+    // Same camera, same positions: nothing to rebin
+    s.frame(c);
+    CHECK(c.stats().moved == visible);
+    CHECK(c.stats().removed == 0);
+
+    // Nudge a tenth of the army; only cell crossings count
+    auto before = s.units;
+    std::uniform_real_distribution<f32> nudge(-3.0f, 3.0f);
+    for (u32 i = 0; i < s.units.size(); i += 10) {
+        s.units[i].x = std::clamp(s.units[i].x + nudge(s.rng), 0.0f, MAP_SIZE);
+        s.units[i].z = std::clamp(s.units[i].z + nudge(s.rng), 0.0f, MAP_SIZE);
+    }
+    u32 crossed = 0;
+    for (size_t i = 0; i < s.units.size(); ++i) {
+        f32 ax, ay, bx, by;
+        bool was = s.project(before[i], ax, ay);
+        bool now = s.project(s.units[i], bx, by);
+        if (now && (!was ||
+                    std::floor(ax / IconClusterer::BASE_CELL_PX) !=
+                        std::floor(bx / IconClusterer::BASE_CELL_PX) ||
+                    std::floor(ay / IconClusterer::BASE_CELL_PX) !=
+                        std::floor(by / IconClusterer::BASE_CELL_PX)))
+            ++crossed;
+    }
+    const u64 moved_before = c.stats().moved;
+    s.frame(c);
+    CHECK(c.stats().moved - moved_before == crossed);
+    CHECK(crossed > 0);
+    CHECK(crossed < UNITS / 10);
+
+    // Units leaving the view are dropped
+    const u64 removed_before = c.stats().removed;
+    const u32 still = s.frame(c, /*skip_every*/ 7);
+    CHECK(c.unit_count() == still);
+    CHECK(c.stats().removed - removed_before > 0);
+
+    // The cached bins agree with a clusterer built from scratch
+    IconClusterer fresh;
+    s.frame(fresh, 7);
+    const u32 level = IconClusterer::level_for_icon(s.icon_size);
+    auto cached = c.build(level, UINT32_MAX);
+    const auto& rebuilt = fresh.build(level, UINT32_MAX);
+    REQUIRE(cached.size() == rebuilt.size());
+    u32 mismatches = 0;
+    for (size_t i = 0; i < cached.size(); ++i) {
+        if (cached[i].count != rebuilt[i].count || cached[i].army != rebuilt[i].army ||
+            cached[i].type != rebuilt[i].type ||
+            std::abs(cached[i].sx - rebuilt[i].sx) > 0.01f ||
+            std::abs(cached[i].sy - rebuilt[i].sy) > 0.01f)
+            ++mismatches;
+    }
+    CHECK(mismatches == 0);
+}
+
+TEST_CASE("Clustered icons fit the quad budget", "[renderer][icon_clustering]") {
+    Scene s;
+    IconClusterer c;
+    const u32 visible = s.frame(c);
+    // One quad per unit would blow the budget
+    REQUIRE(visible > ICON_BUDGET);
+
+    const u32 min_level = IconClusterer::level_for_icon(s.icon_size);
+    CHECK(IconClusterer::BASE_CELL_PX * static_cast<f32>(1u << min_level) >= s.icon_size);
+    const auto& clusters = c.build(min_level, ICON_BUDGET);
+    CHECK(c.level() >= min_level);
+
+    u32 units = 0, expected_quads = 0, rings = 0, singles = 0;
+    for (const auto& k : clusters) {
+        units += k.count;
+        expected_quads += IconClusterer::quad_count(k);
+        rings += k.selected ? 1 : 0;
+        singles += k.count == 1 ? 1 : 0;
+    }
+    CHECK(units == visible);
+    CHECK(expected_quads <= ICON_BUDGET);
+    CHECK(clusters.size() < visible);
+    CHECK(singles < clusters.size());
+
+    IconPalette palette{};
+    std::vector<IconQuad> quads;
+    const u32 ring_count = build_icon_quads(clusters, s.icon_size, palette,
+                                            ICON_BUDGET, quads);
+    CHECK(ring_count == rings);
+    CHECK(quads.size() == expected_quads);
+    const u64 vertices = quads.size() * ICON_VERTICES_PER_QUAD;
+    CHECK(vertices == static_cast<u64>(expected_quads) * ICON_VERTICES_PER_QUAD);
+    CHECK(vertices <= static_cast<u64>(ICON_BUDGET) * ICON_VERTICES_PER_QUAD);
+    CHECK(vertices < static_cast<u64>(visible) * ICON_VERTICES_PER_QUAD);
+
+    // One icon per cluster; badges only on merged icons
+    u32 badge_quads = 0;
+    for (const auto& k : clusters)
+        badge_quads += IconClusterer::quad_count(k) - 1 - (k.selected ? 1 : 0);
+    CHECK(quads.size() == ring_count + clusters.size() + badge_quads);
+
+    // A tight budget still gets every unit into some cluster
+    const auto& coarse = c.build(0, 64);
+    u32 coarse_units = 0;
+    for (const auto& k : coarse) coarse_units += k.count;
+    CHECK(coarse_units == visible);
+    CHECK(c.level() > min_level);
+    build_icon_quads(coarse, s.icon_size, palette, 64, quads);
+    CHECK(quads.size() <= 64);
+}
+
+TEST_CASE("Icon clustering benchmark", "[.benchmark][renderer][icon_clustering]") {
+    Scene s;
+    IconClusterer c;
+    s.frame(c);
+    const u32 level = IconClusterer::level_for_icon(s.icon_size);
+    std::vector<IconQuad> quads;
+    IconPalette palette{};
+
+    BENCHMARK("20k units, still frame") {
+        s.frame(c);
+        return build_icon_quads(c.build(level, ICON_BUDGET), s.icon_size,
+                                palette, ICON_BUDGET, quads);
+    };
+    BENCHMARK("20k units, from scratch") {
+        IconClusterer fresh;
+        s.frame(fresh);
+        return build_icon_quads(fresh.build(level, ICON_BUDGET), s.icon_size,
+                                palette, ICON_BUDGET, quads);
+    };
+}
@@ -0,0 +1,561 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "renderer/instance_culling.hpp"
+#include "renderer/frustum.hpp"
+#include "renderer/camera.hpp"
+#include "renderer/shader_utils.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <tuple>
+
+using namespace osc;
+using namespace osc::renderer;
+
+namespace {
+
+/// LOD chains as blueprints have them (finest first, 0 = no limit).
+const std::vector<std::vector<f32>> LOD_CUTOFFS = {
+    {0.0f},
+    {120.0f, 0.0f},
+    {80.0f, 200.0f, 500.0f},
+    {60.0f, 150.0f, 300.0f, 0.0f},
+    {250.0f},
+};
+
+CullInstance make_instance(f32 x, f32 y, f32 z, f32 radius, u32 lod_set) {
+    CullInstance inst{};
+    inst.model[0] = inst.model[5] = inst.model[10] = inst.model[15] = 1.0f;
+    inst.model[12] = x;
+    inst.model[13] = y;
+    inst.model[14] = z;
+    inst.color[0] = inst.color[1] = inst.color[2] = inst.color[3] = 1.0f;
+    inst.sphere[0] = x;
+    inst.sphere[1] = y;
+    inst.sphere[2] = z;
+    inst.sphere[3] = radius;
+    inst.lod_set = lod_set;
+    return inst;
+}
+
+/// MeshCache::get_lod's walk over a cutoff chain.
+u32 expected_level(const std::vector<f32>& cutoffs, f32 dist) {
+    for (u32 k = 0; k < cutoffs.size(); ++k) {
+        if (cutoffs[k] == 0.0f || cutoffs[k] >= dist) return k;
+    }
+    return static_cast<u32>(cutoffs.size() - 1);
+}
+
+using Position = std::tuple<f32, f32, f32>;
+
+/// A compute-capable Vulkan device for running the culling shader;
+/// prefers a software one (lavapipe, SwiftShader) when several exist.
+struct ComputeDevice {
+    VkInstance instance = VK_NULL_HANDLE;
+    VkPhysicalDevice physical = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    VkCommandPool pool = VK_NULL_HANDLE;
+    u32 family = 0;
+
+    bool init() {
+        VkApplicationInfo app{};
+        app.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        app.pApplicationName = "osc_tests";
+        app.apiVersion = VK_API_VERSION_1_0;
+        VkInstanceCreateInfo inst_ci{};
+        inst_ci.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        inst_ci.pApplicationInfo = &app;
+        if (vkCreateInstance(&inst_ci, nullptr, &instance) != VK_SUCCESS) {
+            instance = VK_NULL_HANDLE;
+            return false;
+        }
+
+        u32 count = 0;
+        vkEnumeratePhysicalDevices(instance, &count, nullptr);
+        std::vector<VkPhysicalDevice> devices(count);
+        vkEnumeratePhysicalDevices(instance, &count, devices.data());
+        for (auto candidate : devices) {
+            u32 families = 0;
+            vkGetPhysicalDeviceQueueFamilyProperties(candidate, &families, nullptr);
+            std::vector<VkQueueFamilyProperties> props(families);
+            vkGetPhysicalDeviceQueueFamilyProperties(candidate, &families, props.data());
+            for (u32 f = 0; f < families; ++f) {
+                if (!(props[f].queueFlags & VK_QUEUE_COMPUTE_BIT)) continue;
+                VkPhysicalDeviceProperties dp{};
+                vkGetPhysicalDeviceProperties(candidate, &dp);
+                if (!physical || dp.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU) {
+                    physical = candidate;
+                    family = f;
+                }
+                break;
+            }
+        }
+        if (!physical) return false;
+
+        f32 priority = 1.0f;
+        VkDeviceQueueCreateInfo queue_ci{};
+        queue_ci.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queue_ci.queueFamilyIndex = family;
+        queue_ci.queueCount = 1;
+        queue_ci.pQueuePriorities = &priority;
+        VkDeviceCreateInfo dev_ci{};
+        dev_ci.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        dev_ci.queueCreateInfoCount = 1;
+        dev_ci.pQueueCreateInfos = &queue_ci;
+        if (vkCreateDevice(physical, &dev_ci, nullptr, &device) != VK_SUCCESS) {
+            device = VK_NULL_HANDLE;
+            return false;
+        }
+        vkGetDeviceQueue(device, family, 0, &queue);
+
+        VkCommandPoolCreateInfo pool_ci{};
+        pool_ci.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_ci.queueFamilyIndex = family;
+        return vkCreateCommandPool(device, &pool_ci, nullptr, &pool) == VK_SUCCESS;
+    }
+
+    ~ComputeDevice() {
+        if (pool) vkDestroyCommandPool(device, pool, nullptr);
+        if (device) vkDestroyDevice(device, nullptr);
+        if (instance) vkDestroyInstance(instance, nullptr);
+    }
+};
+
+/// Host-visible, coherent storage buffer, so results can be read back
+/// without a copy.
+struct HostBuffer {
+    VkDevice device = VK_NULL_HANDLE;
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    void* mapped = nullptr;
+
+    bool init(const ComputeDevice& dev, VkDeviceSize size) {
+        device = dev.device;
+        VkBufferCreateInfo ci{};
+        ci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        ci.size = std::max<VkDeviceSize>(size, 16);
+        ci.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        if (vkCreateBuffer(device, &ci, nullptr, &buffer) != VK_SUCCESS) return false;
+
+        VkMemoryRequirements req{};
+        vkGetBufferMemoryRequirements(device, buffer, &req);
+        VkPhysicalDeviceMemoryProperties mem{};
+        vkGetPhysicalDeviceMemoryProperties(dev.physical, &mem);
+        constexpr VkMemoryPropertyFlags HOST = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        for (u32 t = 0; t < mem.memoryTypeCount; ++t) {
+            if (!(req.memoryTypeBits & (1u << t)) ||
+                (mem.memoryTypes[t].propertyFlags & HOST) != HOST)
+                continue;
+            VkMemoryAllocateInfo alloc{};
+            alloc.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            alloc.allocationSize = req.size;
+            alloc.memoryTypeIndex = t;
+            if (vkAllocateMemory(device, &alloc, nullptr, &memory) != VK_SUCCESS)
+                return false;
+            vkBindBufferMemory(device, buffer, memory, 0);
+            return vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &mapped) == VK_SUCCESS;
+        }
+        return false;
+    }
+
+    ~HostBuffer() {
+        if (buffer) vkDestroyBuffer(device, buffer, nullptr);
+        if (memory) vkFreeMemory(device, memory, nullptr);
+    }
+};
+
+/// One culled record as the tests compare it: position and bone range.
+using Culled = std::tuple<f32, f32, f32, u32, u32>;
+
+Culled culled_key(const CulledInstance& c) {
+    return {c.model[12], c.model[13], c.model[14], c.bone_base, c.bone_count};
+}
+
+} // namespace
+
+TEST_CASE("Instance culling matches the CPU frustum over 50,000 instances",
+          "[renderer][culling]") {
+    constexpr u32 INSTANCES = 50000;
+    constexpr f32 MAP_SIZE = 1024.0f;
+
+    CullScene scene;
+    for (const auto& cutoffs : LOD_CUTOFFS) {
+        std::vector<u32> index_counts;
+        for (size_t k = 0; k < cutoffs.size(); ++k)
+            index_counts.push_back(static_cast<u32>(300 / (k + 1)));
+        scene.add_set(cutoffs, index_counts);
+    }
+
+    std::mt19937 rng(20240611);
+    std::uniform_real_distribution<f32> coord(0.0f, MAP_SIZE);
+    std::uniform_real_distribution<f32> height(0.0f, 40.0f);
+    std::uniform_real_distribution<f32> radius(2.0f, 12.0f);
+    for (u32 i = 0; i < INSTANCES; ++i) {
+        scene.add_instance(make_instance(coord(rng), height(rng), coord(rng),
+                                         radius(rng),
+                                         i % static_cast<u32>(LOD_CUTOFFS.size())));
+    }
+    scene.finalize();
+
+    // Tilted RTS camera over the middle of the map
+    const f32 eye[3] = {512.0f, 220.0f, 820.0f};
+    auto view = math::look_at(eye[0], eye[1], eye[2], 512.0f, 0.0f, 480.0f,
+                              0.0f, 1.0f, 0.0f);
+    auto proj = math::perspective(3.14159f / 4.0f, 16.0f / 9.0f, 1.0f, 900.0f);
+    Frustum frustum(math::mat4_mul(proj, view));
+
+    // Reference: the Frustum sphere test and get_lod's LOD pick
+    std::vector<u32> expected_draws(scene.draws().size(), 0);
+    std::vector<std::vector<Position>> expected_pos(scene.draws().size());
+    u32 expected_visible = 0;
+    for (const auto& inst : scene.instances()) {
+        const f32* s = inst.sphere;
+        if (!frustum.is_sphere_visible(s[0], s[1], s[2], s[3])) continue;
+        f32 dx = s[0] - eye[0], dy = s[1] - eye[1], dz = s[2] - eye[2];
+        f32 dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+        u32 lod = scene.sets()[inst.lod_set].first_lod +
+                  expected_level(LOD_CUTOFFS[inst.lod_set], dist);
+        expected_draws[lod]++;
+        expected_pos[lod].emplace_back(s[0], s[1], s[2]);
+        expected_visible++;
+    }
+    // The camera sees part of the map, not all or nothing
+    REQUIRE(expected_visible > INSTANCES / 20);
+    REQUIRE(expected_visible < INSTANCES / 2);
+
+    std::vector<DrawIndexedIndirect> draws;
+    std::vector<CulledInstance> out;
+    u32 visible = cull_instances(scene, make_cull_params(&frustum, eye, INSTANCES),
+                                 draws, out);
+    CHECK(visible == expected_visible);
+    REQUIRE(draws.size() == expected_draws.size());
+
+    u32 drawn = 0;
+    for (size_t d = 0; d < draws.size(); ++d) {
+        CHECK(draws[d].instance_count == expected_draws[d]);
+        CHECK(draws[d].index_count == scene.draws()[d].index_count);
+        CHECK(draws[d].first_instance == 0);
+        drawn += draws[d].instance_count;
+
+        // Compacted output: exactly this LOD's instances, inside its range
+        const u32 first = scene.lods()[d].first_instance;
+        std::vector<Position> got;
+        for (u32 i = 0; i < draws[d].instance_count; ++i) {
+            const auto& m = out[first + i].model;
+            got.emplace_back(m[12], m[13], m[14]);
+        }
+        std::sort(got.begin(), got.end());
+        std::sort(expected_pos[d].begin(), expected_pos[d].end());
+        CHECK(got == expected_pos[d]);
+    }
+    CHECK(drawn == visible);
+}
+
+TEST_CASE("Instance culling without a frustum or camera", "[renderer][culling]") {
+    CullScene scene;
+    scene.add_set({50.0f, 0.0f}, {90, 30});
+    for (u32 i = 0; i < 100; ++i)
+        scene.add_instance(make_instance(static_cast<f32>(i) * 10.0f, 0.0f,
+                                         -5000.0f, 1.0f, 0));
+    scene.finalize();
+
+    std::vector<DrawIndexedIndirect> draws;
+    std::vector<CulledInstance> out;
+
+    // No frustum keeps everything; no eye selects the finest LOD
+    CHECK(cull_instances(scene, make_cull_params(nullptr, nullptr, 100),
+                         draws, out) == 100);
+    CHECK(draws[0].instance_count == 100);
+    CHECK(draws[1].instance_count == 0);
+
+    // With an eye far away the coarse LOD takes them
+    const f32 eye[3] = {0.0f, 0.0f, 0.0f};
+    CHECK(cull_instances(scene, make_cull_params(nullptr, eye, 100),
+                         draws, out) == 100);
+    CHECK(draws[0].instance_count == 0);
+    CHECK(draws[1].instance_count == 100);
+
+    // instance_count limits the records processed
+    CHECK(cull_instances(scene, make_cull_params(nullptr, nullptr, 10),
+                         draws, out) == 10);
+}
+
+TEST_CASE("Cull scene reserves an output range per LOD", "[renderer][culling]") {
+    CullScene scene;
+    u32 a = scene.add_set({100.0f, 0.0f}, {600, 200});
+    u32 b = scene.add_set({0.0f}, {36});
+    for (u32 i = 0; i < 3; ++i) scene.add_instance(make_instance(0, 0, 0, 1, a));
+    for (u32 i = 0; i < 5; ++i) scene.add_instance(make_instance(0, 0, 0, 1, b));
+    scene.finalize();
+
+    REQUIRE(scene.lods().size() == 3);
+    CHECK(scene.lods()[0].first_instance == 0);
+    CHECK(scene.lods()[1].first_instance == 3);
+    CHECK(scene.lods()[2].first_instance == 6);
+    CHECK(scene.output_capacity() == 11);
+
+    REQUIRE(scene.draws().size() == 3);
+    CHECK(scene.draws()[0].index_count == 600);
+    CHECK(scene.draws()[1].index_count == 200);
+    CHECK(scene.draws()[2].index_count == 36);
+    for (const auto& d : scene.draws()) CHECK(d.instance_count == 0);
+
+    scene.clear();
+    CHECK(scene.instances().empty());
+    CHECK(scene.output_capacity() == 0);
+}
+
+TEST_CASE("Cull scene updates and removes records in place", "[renderer][culling]") {
+    CullScene scene;
+    u32 a = scene.add_set({100.0f, 0.0f}, {600, 200});
+    u32 b = scene.add_set({0.0f}, {36});
+    for (u32 i = 0; i < 4; ++i)
+        CHECK(scene.add_instance(make_instance(static_cast<f32>(i), 0, 0, 1, a)) == i);
+    scene.finalize();
+    CHECK_FALSE(scene.layout_changed());
+    std::vector<u32> dirty;
+    scene.take_dirty(dirty);
+    CHECK(dirty.size() == 4);
+    dirty.clear();
+
+    // Moving a record within its set leaves the output ranges alone
+    u32 revision = scene.layout_revision();
+    auto moved = make_instance(10, 0, 0, 1, a);
+    moved.bone_base = 64;
+    moved.bone_count = 12;
+    scene.update_instance(1, moved);
+    CHECK_FALSE(scene.layout_changed());
+    scene.take_dirty(dirty);
+    CHECK(dirty == std::vector<u32>{1});
+    dirty.clear();
+    CHECK(scene.instances()[1].bone_base == 64);
+
+    // Changing set or removing one does not
+    scene.update_instance(2, make_instance(2, 0, 0, 1, b));
+    CHECK(scene.layout_changed());
+    CHECK(scene.set_instance_count(a) == 3);
+    CHECK(scene.set_instance_count(b) == 1);
+
+    // Swap-remove: the last record takes the freed index
+    CHECK(scene.remove_instance(0) == 3);
+    REQUIRE(scene.instances().size() == 3);
+    CHECK(scene.instances()[0].model[12] == 3.0f);
+    CHECK(scene.remove_instance(2) == CullScene::NO_INSTANCE);
+    CHECK(scene.set_instance_count(a) == 2);
+    CHECK(scene.set_instance_count(b) == 0);
+
+    scene.finalize();
+    CHECK(scene.layout_revision() != revision);
+    CHECK(scene.lods()[1].first_instance == 2);
+    CHECK(scene.lods()[2].first_instance == 4);
+    CHECK(scene.output_capacity() == 4);
+}
+
+TEST_CASE("instance_cull.comp matches the CPU reference on a Vulkan device",
+          "[renderer][culling][vulkan]") {
+    ComputeDevice dev;
+    if (!dev.init()) {
+        WARN("no Vulkan device with a compute queue; skipping the shader run");
+        return;
+    }
+
+    // Units with bone ranges, props without, and records churned through
+    // update and remove as the renderer does
+    CullScene scene;
+    for (const auto& cutoffs : LOD_CUTOFFS) {
+        std::vector<u32> index_counts(cutoffs.size(), 36);
+        scene.add_set(cutoffs, index_counts);
+    }
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<f32> coord(0.0f, 1024.0f);
+    std::uniform_real_distribution<f32> radius(2.0f, 12.0f);
+    u32 next_bone = 0;
+    for (u32 i = 0; i < 3000; ++i) {
+        auto inst = make_instance(coord(rng), 10.0f, coord(rng), radius(rng),
+                                  i % static_cast<u32>(LOD_CUTOFFS.size()));
+        if (i % 3 == 0) {
+            inst.bone_base = next_bone;
+            inst.bone_count = 1 + i % 40;
+            next_bone += inst.bone_count;
+        }
+        scene.add_instance(inst);
+    }
+    for (u32 i = 0; i < 200; ++i) {
+        u32 index = (i * 13) % static_cast<u32>(scene.instances().size());
+        if (i % 2) {
+            auto inst = scene.instances()[index];
+            inst.sphere[0] = inst.model[12] = coord(rng);
+            inst.lod_set = (inst.lod_set + 1) % static_cast<u32>(LOD_CUTOFFS.size());
+            scene.update_instance(index, inst);
+        } else {
+            scene.remove_instance(index);
+        }
+    }
+    scene.finalize();
+    const u32 count = static_cast<u32>(scene.instances().size());
+
+    const f32 eye[3] = {512.0f, 220.0f, 820.0f};
+    auto view = math::look_at(eye[0], eye[1], eye[2], 512.0f, 0.0f, 480.0f,
+                              0.0f, 1.0f, 0.0f);
+    auto proj = math::perspective(3.14159f / 4.0f, 16.0f / 9.0f, 1.0f, 900.0f);
+    Frustum frustum(math::mat4_mul(proj, view));
+    CullParams params = make_cull_params(&frustum, eye, count);
+
+    std::vector<DrawIndexedIndirect> expected_draws;
+    std::vector<CulledInstance> expected_out;
+    u32 expected_visible = cull_instances(scene, params, expected_draws, expected_out);
+    REQUIRE(expected_visible > 0);
+    REQUIRE(expected_visible < count);
+
+    // Buffers in binding order: instances, sets, LODs, draws, output
+    HostBuffer bufs[5];
+    const std::pair<const void*, VkDeviceSize> inputs[4] = {
+        {scene.instances().data(), count * sizeof(CullInstance)},
+        {scene.sets().data(), scene.sets().size() * sizeof(CullLODSet)},
+        {scene.lods().data(), scene.lods().size() * sizeof(CullLOD)},
+        {scene.draws().data(), scene.draws().size() * sizeof(DrawIndexedIndirect)},
+    };
+    for (u32 i = 0; i < 4; ++i) {
+        REQUIRE(bufs[i].init(dev, inputs[i].second));
+        std::memcpy(bufs[i].mapped, inputs[i].first, inputs[i].second);
+    }
+    REQUIRE(bufs[4].init(dev, scene.output_capacity() * sizeof(CulledInstance)));
+
+    VkShaderModule cs = compile_compute_glsl(dev.device, shaders::instance_cull_comp,
+                                             "instance_cull.comp");
+    REQUIRE(cs != VK_NULL_HANDLE);
+
+    VkDescriptorSetLayoutBinding bindings[5]{};
+    for (u32 i = 0; i < 5; ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    VkDescriptorSetLayoutCreateInfo ds_ci{};
+    ds_ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    ds_ci.bindingCount = 5;
+    ds_ci.pBindings = bindings;
+    VkDescriptorSetLayout ds_layout = VK_NULL_HANDLE;
+    REQUIRE(vkCreateDescriptorSetLayout(dev.device, &ds_ci, nullptr, &ds_layout) == VK_SUCCESS);
+
+    VkPushConstantRange push_range{};
+    push_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    push_range.size = sizeof(CullParams);
+    VkPipelineLayoutCreateInfo layout_ci{};
+    layout_ci.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_ci.setLayoutCount = 1;
+    layout_ci.pSetLayouts = &ds_layout;
+    layout_ci.pushConstantRangeCount = 1;
+    layout_ci.pPushConstantRanges = &push_range;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    REQUIRE(vkCreatePipelineLayout(dev.device, &layout_ci, nullptr, &layout) == VK_SUCCESS);
+
+    VkComputePipelineCreateInfo pipe_ci{};
+    pipe_ci.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipe_ci.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipe_ci.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipe_ci.stage.module = cs;
+    pipe_ci.stage.pName = "main";
+    pipe_ci.layout = layout;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    REQUIRE(vkCreateComputePipelines(dev.device, VK_NULL_HANDLE, 1, &pipe_ci,
+                                     nullptr, &pipeline) == VK_SUCCESS);
+    vkDestroyShaderModule(dev.device, cs, nullptr);
+
+    VkDescriptorPoolSize pool_size{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5};
+    VkDescriptorPoolCreateInfo pool_ci{};
+    pool_ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_ci.maxSets = 1;
+    pool_ci.poolSizeCount = 1;
+    pool_ci.pPoolSizes = &pool_size;
+    VkDescriptorPool ds_pool = VK_NULL_HANDLE;
+    REQUIRE(vkCreateDescriptorPool(dev.device, &pool_ci, nullptr, &ds_pool) == VK_SUCCESS);
+    VkDescriptorSetAllocateInfo ds_alloc{};
+    ds_alloc.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    ds_alloc.descriptorPool = ds_pool;
+    ds_alloc.descriptorSetCount = 1;
+    ds_alloc.pSetLayouts = &ds_layout;
+    VkDescriptorSet ds = VK_NULL_HANDLE;
+    REQUIRE(vkAllocateDescriptorSets(dev.device, &ds_alloc, &ds) == VK_SUCCESS);
+
+    VkDescriptorBufferInfo infos[5]{};
+    VkWriteDescriptorSet writes[5]{};
+    for (u32 i = 0; i < 5; ++i) {
+        infos[i] = {bufs[i].buffer, 0, VK_WHOLE_SIZE};
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = ds;
+        writes[i].dstBinding = i;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &infos[i];
+    }
+    vkUpdateDescriptorSets(dev.device, 5, writes, 0, nullptr);
+
+    VkCommandBufferAllocateInfo cmd_alloc{};
+    cmd_alloc.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    cmd_alloc.commandPool = dev.pool;
+    cmd_alloc.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmd_alloc.commandBufferCount = 1;
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    REQUIRE(vkAllocateCommandBuffers(dev.device, &cmd_alloc, &cmd) == VK_SUCCESS);
+
+    VkCommandBufferBeginInfo begin{};
+    begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(cmd, &begin);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &ds,
+                            0, nullptr);
+    vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params),
+                       &params);
+    vkCmdDispatch(cmd, (count + 63) / 64, 1, 1);
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr,
+                         0, nullptr);
+    vkEndCommandBuffer(cmd);
+
+    VkSubmitInfo submit{};
+    submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit.commandBufferCount = 1;
+    submit.pCommandBuffers = &cmd;
+    REQUIRE(vkQueueSubmit(dev.queue, 1, &submit, VK_NULL_HANDLE) == VK_SUCCESS);
+    REQUIRE(vkQueueWaitIdle(dev.queue) == VK_SUCCESS);
+
+    // Same counts per draw, and the same records in each LOD's range; the
+    // order within a range follows the atomics
+    const auto* draws = static_cast<const DrawIndexedIndirect*>(bufs[3].mapped);
+    const auto* out = static_cast<const CulledInstance*>(bufs[4].mapped);
+    u32 drawn = 0;
+    for (size_t d = 0; d < expected_draws.size(); ++d) {
+        CHECK(draws[d].instance_count == expected_draws[d].instance_count);
+        CHECK(draws[d].index_count == expected_draws[d].index_count);
+        drawn += draws[d].instance_count;
+
+        const u32 first = scene.lods()[d].first_instance;
+        std::vector<Culled> got, expected;
+        for (u32 i = 0; i < draws[d].instance_count; ++i)
+            got.push_back(culled_key(out[first + i]));
+        for (u32 i = 0; i < expected_draws[d].instance_count; ++i)
+            expected.push_back(culled_key(expected_out[first + i]));
+        std::sort(got.begin(), got.end());
+        std::sort(expected.begin(), expected.end());
+        CHECK(got == expected);
+    }
+    CHECK(drawn == expected_visible);
+
+    vkDestroyDescriptorPool(dev.device, ds_pool, nullptr);
+    vkDestroyPipeline(dev.device, pipeline, nullptr);
+    vkDestroyPipelineLayout(dev.device, layout, nullptr);
+    vkDestroyDescriptorSetLayout(dev.device, ds_layout, nullptr);
+}
@@ -0,0 +1,338 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "lua/lua_state.hpp"
+#include "map/heightmap.hpp"
+#include "map/terrain.hpp"
+#include "sim/local_avoidance.hpp"
+#include "sim/manipulator.hpp"
+#include "sim/sim_state.hpp"
+#include "sim/unit.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace osc;
+using namespace osc::sim;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+AvoidanceAgents random_crowd(u32 n, u32 seed, f32 extent) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<f32> pos(-extent, extent);
+    std::uniform_real_distribution<f32> rad(0.5f, 1.5f);
+    AvoidanceAgents agents;
+    for (u32 i = 0; i < n; ++i)
+        agents.add(pos(rng), pos(rng), rad(rng), static_cast<u8>(i % 3 == 0),
+                   i % 4 != 0);
+    return agents;
+}
+
+/// Deepest footprint overlap among agents on the same layer.
+f32 max_overlap(const AvoidanceAgents& a) {
+    f32 worst = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = i + 1; j < a.size(); ++j) {
+            if (a.layer[i] != a.layer[j]) continue;
+            f32 dx = a.x[i] - a.x[j], dz = a.z[i] - a.z[j];
+            f32 d = std::sqrt(dx * dx + dz * dz);
+            worst = std::max(worst, a.radius[i] + a.radius[j] - d);
+        }
+    }
+    return worst;
+}
+
+/// A wall along x = 0 with a gap |z| < GAP_HALF. Units start on the left
+/// and head for a goal on the right, funnelling through the gap.
+struct Chokepoint {
+    static constexpr f32 GAP_HALF = 20.0f;
+    static constexpr f32 WALL_HALF = 1.0f;
+    static constexpr f32 SPEED = 0.4f; // per tick
+    static constexpr f32 GOAL_X = 150.0f;
+
+    AvoidanceAgents agents;
+
+    explicit Chokepoint(u32 n) {
+        u32 cols = static_cast<u32>(std::ceil(std::sqrt(static_cast<f32>(n))));
+        for (u32 i = 0; i < n; ++i) {
+            f32 x = -20.0f - 2.2f * static_cast<f32>(i / cols);
+            f32 z = 2.2f * (static_cast<f32>(i % cols) - 0.5f * static_cast<f32>(cols));
+            agents.add(x, z, 1.0f, 0, true);
+        }
+    }
+
+    static bool blocked(f32 x, f32 z) {
+        return std::abs(x) < WALL_HALF && std::abs(z) >= GAP_HALF;
+    }
+
+    void try_move(size_t i, f32 dx, f32 dz) {
+        f32 nx = agents.x[i] + dx, nz = agents.z[i] + dz;
+        if (!blocked(nx, nz)) { agents.x[i] = nx; agents.z[i] = nz; }
+        else if (!blocked(nx, agents.z[i])) agents.x[i] = nx;
+        else if (!blocked(agents.x[i], nz)) agents.z[i] = nz;
+    }
+
+    void steer() {
+        for (size_t i = 0; i < agents.size(); ++i) {
+            f32 tx = agents.x[i] < 0 ? 0.0f : GOAL_X;
+            f32 tz = agents.x[i] < 0
+                ? std::clamp(agents.z[i], -0.5f * GAP_HALF, 0.5f * GAP_HALF)
+                : agents.z[i];
+            f32 dx = tx - agents.x[i] + (agents.x[i] < 0 ? 1.0f : 0.0f);
+            f32 dz = tz - agents.z[i];
+            f32 d = std::sqrt(dx * dx + dz * dz);
+            if (d < 1e-3f) continue;
+            f32 step = std::min(SPEED, d);
+            try_move(i, dx / d * step, dz / d * step);
+        }
+    }
+
+    void avoid(LocalAvoidance& avoidance) {
+        avoidance.compute(agents, 0.5f);
+        for (size_t i = 0; i < agents.size(); ++i)
+            try_move(i, avoidance.dx()[i], avoidance.dz()[i]);
+    }
+
+    size_t crossed() const {
+        return static_cast<size_t>(std::count_if(agents.x.begin(), agents.x.end(),
+                                                 [](f32 x) { return x > WALL_HALF; }));
+    }
+};
+
+} // namespace
+
+TEST_CASE("Overlapping agents are pushed apart", "[sim][avoidance]") {
+    LocalAvoidance avoidance(1);
+
+    SECTION("Equal agents split the overlap") {
+        AvoidanceAgents a;
+        a.add(0, 0, 1, 0, true);
+        a.add(1, 0, 1, 0, true);
+        avoidance.compute(a, 10.0f);
+        CHECK_THAT(avoidance.dx()[0], WithinAbs(-0.25, 1e-6));
+        CHECK_THAT(avoidance.dx()[1], WithinAbs(0.25, 1e-6));
+        CHECK(avoidance.dz()[0] == 0.0f);
+    }
+
+    SECTION("Idle agents give way to moving ones") {
+        AvoidanceAgents a;
+        a.add(0, 0, 1, 0, true);
+        a.add(1, 0, 1, 0, false);
+        avoidance.compute(a, 10.0f);
+        CHECK(std::abs(avoidance.dx()[1]) > 2.0f * std::abs(avoidance.dx()[0]));
+    }
+
+    SECTION("Separate agents and other layers are left alone") {
+        AvoidanceAgents a;
+        a.add(0, 0, 1, 0, true);
+        a.add(3, 0, 1, 0, true);
+        a.add(0.5f, 0, 1, 1, true); // naval, overlapping a land unit
+        avoidance.compute(a, 10.0f);
+        for (size_t i = 0; i < a.size(); ++i) {
+            CHECK(avoidance.dx()[i] == 0.0f);
+            CHECK(avoidance.dz()[i] == 0.0f);
+        }
+    }
+
+    SECTION("Stacked agents split in opposite directions") {
+        AvoidanceAgents a;
+        a.add(5, 5, 1, 0, true);
+        a.add(5, 5, 1, 0, true);
+        avoidance.compute(a, 10.0f);
+        CHECK(avoidance.dx()[0] + avoidance.dx()[1] == 0.0f);
+        CHECK(avoidance.dz()[0] + avoidance.dz()[1] == 0.0f);
+        CHECK(avoidance.dx()[0] * avoidance.dx()[0] +
+              avoidance.dz()[0] * avoidance.dz()[0] > 0.1f);
+    }
+
+    SECTION("Corrections are capped per tick") {
+        AvoidanceAgents a;
+        for (int i = 0; i < 8; ++i) a.add(0.01f * static_cast<f32>(i), 0, 2, 0, true);
+        avoidance.compute(a, 0.3f);
+        for (size_t i = 0; i < a.size(); ++i) {
+            f32 len = std::sqrt(avoidance.dx()[i] * avoidance.dx()[i] +
+                                avoidance.dz()[i] * avoidance.dz()[i]);
+            CHECK(len <= 0.3f + 1e-5f);
+        }
+    }
+}
+
+TEST_CASE("Avoidance is identical for any thread count", "[sim][avoidance]") {
+    auto crowd = random_crowd(6000, 7, 90.0f);
+    LocalAvoidance serial(1);
+    serial.compute(crowd, 0.5f);
+    REQUIRE(serial.last_chunks() == 1);
+
+    for (u32 threads : {2u, 3u, 8u}) {
+        LocalAvoidance parallel(threads);
+        parallel.compute(crowd, 0.5f);
+        CHECK(parallel.last_chunks() == threads);
+        CHECK(parallel.dx() == serial.dx());
+        CHECK(parallel.dz() == serial.dz());
+    }
+}
+
+TEST_CASE("Avoidance workers persist across passes", "[sim][avoidance]") {
+    auto crowd = random_crowd(6000, 11, 90.0f);
+    LocalAvoidance serial(1);
+    LocalAvoidance parallel(4);
+
+    // Passes too small to split never start a worker
+    auto small = random_crowd(100, 5, 10.0f);
+    parallel.compute(small, 0.5f);
+    CHECK(parallel.last_chunks() == 1);
+    CHECK(parallel.worker_count() == 0);
+
+    for (int pass = 0; pass < 20; ++pass) {
+        serial.compute(crowd, 0.5f);
+        parallel.compute(crowd, 0.5f);
+        CHECK(parallel.last_chunks() == 4);
+        CHECK(parallel.worker_count() == 3);
+        CHECK(parallel.dx() == serial.dx());
+        CHECK(parallel.dz() == serial.dz());
+        for (size_t i = 0; i < crowd.size(); ++i) {
+            crowd.x[i] += serial.dx()[i];
+            crowd.z[i] += serial.dz()[i];
+        }
+        // Fewer agents than threads can split: only some chunks run
+        if (pass == 10) {
+            auto mid = random_crowd(1100, 9, 20.0f);
+            LocalAvoidance one(1);
+            one.compute(mid, 0.5f);
+            parallel.compute(mid, 0.5f);
+            CHECK(parallel.last_chunks() == 2);
+            CHECK(parallel.dx() == one.dx());
+        }
+    }
+}
+
+TEST_CASE("Cargo rides its transport through avoidance", "[sim][avoidance]") {
+    lua::LuaState state;
+    SimState sim(state.raw(), nullptr);
+    auto& registry = sim.entity_registry();
+
+    auto transport = std::make_unique<Unit>();
+    transport->set_layer("Air");
+    transport->set_transport_capacity(4);
+    transport->set_position({100, 20, 100});
+    auto* carrier = transport.get();
+    registry.register_entity(std::move(transport));
+
+    std::vector<Unit*> cargo;
+    for (int i = 0; i < 2; ++i) {
+        auto unit = std::make_unique<Unit>();
+        unit->set_layer("Land");
+        unit->set_footprint_size(2, 2);
+        unit->set_position({90.0f + static_cast<f32>(i), 0, 100});
+        cargo.push_back(unit.get());
+        registry.register_entity(std::move(unit));
+    }
+    // A land unit parked under the transport stays put as well
+    auto bystander = std::make_unique<Unit>();
+    bystander->set_layer("Land");
+    bystander->set_footprint_size(2, 2);
+    bystander->set_position({100, 0, 100});
+    auto* below = bystander.get();
+    registry.register_entity(std::move(bystander));
+
+    for (auto* c : cargo) c->attach_to_transport(carrier, registry, state.raw());
+    REQUIRE(carrier->cargo_ids().size() == 2);
+
+    for (int tick = 0; tick < 10; ++tick) sim.tick();
+
+    for (auto* c : cargo) {
+        CHECK(c->transport_id() == carrier->entity_id());
+        CHECK(c->position().x == carrier->position().x);
+        CHECK(c->position().y == carrier->position().y);
+        CHECK(c->position().z == carrier->position().z);
+    }
+    CHECK(below->position().x == 100.0f);
+    CHECK(below->position().z == 100.0f);
+}
+
+TEST_CASE("Pushed subs and seabed units stay submerged", "[sim][avoidance]") {
+    lua::LuaState state;
+    SimState sim(state.raw(), nullptr);
+    // Seabed at 0, water surface at 20
+    map::Heightmap hm(256, 256, 1.0f, std::vector<u16>(257 * 257, 0));
+    sim.set_terrain(std::make_unique<map::Terrain>(std::move(hm), 20.0f, true));
+    auto& registry = sim.entity_registry();
+
+    auto spawn = [&](const char* layer, f32 x, f32 y) {
+        auto unit = std::make_unique<Unit>();
+        unit->set_layer(layer);
+        unit->set_footprint_size(2, 2);
+        unit->set_position({x, y, 100});
+        auto* u = unit.get();
+        registry.register_entity(std::move(unit));
+        return u;
+    };
+    Unit* subs[] = {spawn("Sub", 100.0f, 12.0f), spawn("Sub", 100.5f, 12.0f)};
+    Unit* crawlers[] = {spawn("Seabed", 150.0f, 0.0f),
+                        spawn("Seabed", 150.5f, 0.0f)};
+
+    for (int tick = 0; tick < 10; ++tick) sim.tick();
+
+    CHECK(subs[1]->position().x - subs[0]->position().x > 1.0f);
+    CHECK(crawlers[1]->position().x - crawlers[0]->position().x > 1.0f);
+    for (auto* u : subs) CHECK_THAT(u->position().y, WithinAbs(12.0f, 1e-4f));
+    for (auto* u : crawlers) CHECK_THAT(u->position().y, WithinAbs(0.0f, 1e-4f));
+}
+
+TEST_CASE("A crowd settles without overlaps", "[sim][avoidance]") {
+    auto crowd = random_crowd(400, 3, 30.0f);
+    f32 before = max_overlap(crowd);
+    LocalAvoidance avoidance(1);
+    for (int tick = 0; tick < 200; ++tick) {
+        avoidance.compute(crowd, 0.5f);
+        for (size_t i = 0; i < crowd.size(); ++i) {
+            crowd.x[i] += avoidance.dx()[i];
+            crowd.z[i] += avoidance.dz()[i];
+        }
+    }
+    CHECK(before > 1.0f);
+    CHECK(max_overlap(crowd) < 0.05f);
+}
+
+TEST_CASE("Units funnel through a chokepoint", "[sim][avoidance]") {
+    Chokepoint choke(300);
+    LocalAvoidance avoidance(1);
+    for (int tick = 0; tick < 1500 && choke.crossed() < 300; ++tick) {
+        choke.steer();
+        choke.avoid(avoidance);
+    }
+    CHECK(choke.crossed() == 300);
+    CHECK(max_overlap(choke.agents) < 1.0f);
+}
+
+TEST_CASE("Local avoidance benchmark", "[.benchmark][sim][avoidance]") {
+    // 2,000 units jammed against a 40-wide gap
+    Chokepoint choke(2000);
+    LocalAvoidance warmup(1);
+    for (int tick = 0; tick < 150; ++tick) {
+        choke.steer();
+        choke.avoid(warmup);
+    }
+
+    LocalAvoidance serial(1);
+    BENCHMARK("2000 units at a chokepoint, 1 thread") {
+        serial.compute(choke.agents, 0.5f);
+        return serial.dx().size();
+    };
+    LocalAvoidance parallel(4);
+    BENCHMARK("2000 units at a chokepoint, 4 threads") {
+        parallel.compute(choke.agents, 0.5f);
+        return parallel.dx().size();
+    };
+    BENCHMARK("2000 units crossing a chokepoint, 1 thread, 10 ticks") {
+        Chokepoint run(2000);
+        for (int tick = 0; tick < 10; ++tick) {
+            run.steer();
+            run.avoid(serial);
+        }
+        return run.crossed();
+    };
+}
@@ -0,0 +1,298 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "lua/lua_state.hpp"
+#include "sim/entity_registry.hpp"
+#include "sim/lua_callbacks.hpp"
+#include "sim/manipulator.hpp"
+#include "sim/unit.hpp"
+
+#include <memory>
+#include <string>
+
+extern "C" {
+#include <lua.h>
+#include <lauxlib.h>
+}
+
+using namespace osc;
+using namespace osc::sim;
+
+namespace {
+
+// Five-level class chain, like a unit script deriving from the FA
+// Unit -> MobileUnit -> ... hierarchy. OnVeteran is never defined.
+constexpr const char* SCRIPT = R"(
+damage_calls = 0
+built_calls = 0
+
+Unit = {}
+Unit.__index = Unit
+function Unit:OnDamage(instigator, amount)
+    self.hp = self.hp - amount
+    damage_calls = damage_calls + 1
+end
+function Unit:OnStopBeingBuilt(builder, layer) built_calls = built_calls + 1 end
+function Unit:OnLayerChange(new, old) last_layer_change = old .. '>' .. new end
+
+local parent = Unit
+for i = 1, 4 do
+    local cls = setmetatable({}, parent)
+    cls.__index = cls
+    parent = cls
+end
+LeafUnit = parent
+
+OtherUnit = setmetatable({}, Unit)
+OtherUnit.__index = OtherUnit
+function OtherUnit:OnVeteran() end
+
+-- Never bound to the cache, so it carries no guard
+PlainUnit = setmetatable({}, parent)
+PlainUnit.__index = PlainUnit
+
+-- Field writes of a typical OnCreate
+function CreateUnits(cls, n)
+    for i = 1, n do
+        local self = setmetatable({}, cls)
+        self.EntityId = i
+        self.Trash = {}
+        self.EventCallbacks = {}
+        self.Buffs = { BuffTable = {}, Affects = {} }
+        self.WeaponInstances = {}
+        self.IntelDisables = {}
+        self.CanTakeDamage = true
+        self.CanBeKilled = true
+        self.DamageEffectsBag = {}
+        self.MovementEffectsBag = {}
+        self.IdleEffectsBag = {}
+        self.TopSpeedEffectsBag = {}
+        self.BeamExhaustEffectsBag = {}
+        self.TransportBeamEffectsBag = {}
+        self.BuildEffectsBag = {}
+        self.ReclaimEffectsBag = {}
+        self.OnBeingBuiltEffectsBag = {}
+        self.CaptureEffectsBag = {}
+        self.UpgradeEffectsBag = {}
+        self.TeleportFxBag = {}
+        self.HasFuel = true
+        self.Layer = 'Land'
+        self.Dead = false
+        self.OnlyOnce = true
+    end
+end
+
+instances = {}
+function NewInstance(id)
+    local inst = setmetatable({ EntityId = id, hp = 1e9 }, LeafUnit)
+    instances[id] = inst
+    return inst
+end
+)";
+
+struct Scenario {
+    lua::LuaState state;
+    EntityRegistry registry;
+    std::unique_ptr<LuaCallbackCache> cache =
+        std::make_unique<LuaCallbackCache>(state.raw(), registry);
+
+    Scenario() { REQUIRE(state.do_string(SCRIPT).ok()); }
+
+    Unit& add_unit(const char* bp_id) {
+        auto unit = std::make_unique<Unit>();
+        unit->set_blueprint_id(bp_id);
+        u32 id = registry.register_entity(std::move(unit));
+        auto& u = static_cast<Unit&>(*registry.find(id));
+        lua_State* L = state.raw();
+        lua_getglobal(L, "NewInstance");
+        lua_pushnumber(L, id);
+        lua_call(L, 1, 1);
+        u.set_lua_table_ref(luaL_ref(L, LUA_REGISTRYINDEX));
+        u.lua_callbacks().cache = cache.get();
+        return u;
+    }
+
+    /// What the Damage() binding does: self:OnDamage(nil, amount, nil, type)
+    bool damage(Unit& u, f32 amount) {
+        lua_State* L = state.raw();
+        lua_rawgeti(L, LUA_REGISTRYINDEX, u.lua_table_ref());
+        bool found = LuaCallbackCache::push_hook(L, -1, &u, UnitHook::OnDamage);
+        if (found) {
+            lua_pushvalue(L, -2);
+            lua_pushnil(L);
+            lua_pushnumber(L, amount);
+            lua_pushnil(L);
+            lua_pushstring(L, "Normal");
+            if (lua_pcall(L, 5, 0, 0) != 0) lua_pop(L, 1);
+        }
+        lua_pop(L, 1);
+        return found;
+    }
+
+    bool has_hook(Unit& u, UnitHook hook) {
+        lua_State* L = state.raw();
+        lua_rawgeti(L, LUA_REGISTRYINDEX, u.lua_table_ref());
+        bool found = LuaCallbackCache::push_hook(L, -1, &u, hook);
+        lua_pop(L, found ? 2 : 1);
+        return found;
+    }
+
+    f64 global(const char* name) {
+        lua_getglobal(state.raw(), name);
+        f64 v = lua_tonumber(state.raw(), -1);
+        lua_pop(state.raw(), 1);
+        return v;
+    }
+};
+
+} // namespace
+
+TEST_CASE("Cached hooks dispatch like the name lookup", "[sim][lua_callbacks]") {
+    Scenario s;
+    auto& a = s.add_unit("uel0201");
+    auto& b = s.add_unit("uel0201");
+    auto& c = s.add_unit("uel0106");
+
+    CHECK(s.damage(a, 10));
+    CHECK(s.damage(b, 10));
+    CHECK(s.damage(c, 10));
+    CHECK(s.global("damage_calls") == 3);
+    a.call_lua_method(s.state.raw(), UnitHook::OnStopBeingBuilt);
+    CHECK(s.global("built_calls") == 1);
+
+    // Missing hooks are answered from the presence mask
+    CHECK_FALSE(s.has_hook(a, UnitHook::OnVeteran));
+    CHECK(s.cache->stats().missing == 1);
+    CHECK(s.cache->stats().cached == 4);
+    CHECK(s.cache->stats().uncached == 0);
+    CHECK(s.cache->stats().tables == 2); // one per blueprint
+
+    // Without a cache the same calls go through the name lookup
+    s.cache->set_enabled(false);
+    CHECK(s.damage(a, 10));
+    CHECK_FALSE(s.has_hook(a, UnitHook::OnVeteran));
+    CHECK(s.global("damage_calls") == 4);
+    CHECK(s.cache->stats().uncached == 2);
+}
+
+TEST_CASE("Engine events go through the cache", "[sim][lua_callbacks]") {
+    Scenario s;
+    auto& a = s.add_unit("uel0201");
+    a.set_layer("Land");
+    a.set_layer_with_callback("Water", s.state.raw());
+    a.set_vet_thresholds({10.0f, 30.0f, 60.0f, 100.0f, 200.0f});
+    a.add_xp(15.0f, s.state.raw(), s.registry);
+    CHECK(a.vet_level() == 1);
+
+    REQUIRE(s.state.do_string("layer_ok = last_layer_change == 'Land>Water'").ok());
+    lua_getglobal(s.state.raw(), "layer_ok");
+    CHECK(lua_toboolean(s.state.raw(), -1));
+    lua_pop(s.state.raw(), 1);
+    CHECK(s.cache->stats().cached == 1);  // OnLayerChange
+    CHECK(s.cache->stats().missing == 1); // OnVeteran
+    CHECK(s.cache->stats().uncached == 0);
+}
+
+TEST_CASE("Instance assignments invalidate cached hooks", "[sim][lua_callbacks]") {
+    Scenario s;
+    auto& a = s.add_unit("uel0201");
+    auto& b = s.add_unit("uel0201");
+    CHECK(s.damage(a, 1));
+    CHECK_FALSE(s.has_hook(a, UnitHook::OnVeteran));
+
+    std::string id = std::to_string(a.entity_id());
+    REQUIRE(s.state.do_string(
+        "local inst = instances[" + id + "]\n"
+        "inst.OnDamage = function(self) overridden = (overridden or 0) + 1 end\n"
+        "inst.OnVeteran = function(self) end\n"
+        "inst.Trash = {}\n"
+        "inst.OnlyOnce = true\n").ok());
+    CHECK(a.lua_callbacks().overrides ==
+          ((1u << u32(UnitHook::OnDamage)) | (1u << u32(UnitHook::OnVeteran))));
+    CHECK(b.lua_callbacks().overrides == 0);
+
+    CHECK(s.damage(a, 1));
+    CHECK(s.global("overridden") == 1);
+    CHECK(s.global("damage_calls") == 1);
+    CHECK(s.has_hook(a, UnitHook::OnVeteran));
+    // The guard still stores the value
+    REQUIRE(s.state.do_string("has_trash = instances[" + id + "].Trash ~= nil").ok());
+    lua_getglobal(s.state.raw(), "has_trash");
+    CHECK(lua_toboolean(s.state.raw(), -1));
+    lua_pop(s.state.raw(), 1);
+
+    // Other units of the class keep the cached class method
+    CHECK(s.damage(b, 1));
+    CHECK(s.global("damage_calls") == 2);
+    CHECK_FALSE(s.has_hook(b, UnitHook::OnVeteran));
+}
+
+TEST_CASE("Class changes and clear() re-resolve", "[sim][lua_callbacks]") {
+    Scenario s;
+    auto& a = s.add_unit("uel0201");
+    CHECK_FALSE(s.has_hook(a, UnitHook::OnVeteran));
+
+    std::string id = std::to_string(a.entity_id());
+    REQUIRE(s.state.do_string("setmetatable(instances[" + id + "], OtherUnit)").ok());
+    CHECK(s.has_hook(a, UnitHook::OnVeteran));
+    CHECK(s.cache->stats().tables == 2);
+
+    s.cache->clear();
+    CHECK(s.has_hook(a, UnitHook::OnVeteran));
+    CHECK(s.damage(a, 1));
+    CHECK(s.cache->stats().tables == 3);
+
+    // A destroyed cache takes its guard back off the classes
+    s.cache.reset();
+    REQUIRE(s.state.do_string("guard_left = rawget(OtherUnit, '__newindex') ~= nil").ok());
+    lua_getglobal(s.state.raw(), "guard_left");
+    CHECK_FALSE(lua_toboolean(s.state.raw(), -1));
+    lua_pop(s.state.raw(), 1);
+}
+
+TEST_CASE("OnDamage dispatch benchmark", "[.benchmark][sim][lua_callbacks]") {
+    constexpr u32 EVENTS = 100000;
+    Scenario s;
+    auto& u = s.add_unit("uel0201");
+
+    BENCHMARK("100k OnDamage, name lookup") {
+        s.cache->set_enabled(false);
+        for (u32 i = 0; i < EVENTS; ++i) s.damage(u, 1);
+        return s.global("damage_calls");
+    };
+    BENCHMARK("100k OnDamage, cached") {
+        s.cache->set_enabled(true);
+        for (u32 i = 0; i < EVENTS; ++i) s.damage(u, 1);
+        return s.global("damage_calls");
+    };
+    BENCHMARK("100k missing hook, name lookup") {
+        s.cache->set_enabled(false);
+        u32 found = 0;
+        for (u32 i = 0; i < EVENTS; ++i) found += s.has_hook(u, UnitHook::OnVeteran);
+        return found;
+    };
+    BENCHMARK("100k missing hook, cached") {
+        s.cache->set_enabled(true);
+        u32 found = 0;
+        for (u32 i = 0; i < EVENTS; ++i) found += s.has_hook(u, UnitHook::OnVeteran);
+        return found;
+    };
+}
+
+TEST_CASE("Unit creation benchmark", "[.benchmark][sim][lua_callbacks]") {
+    constexpr u32 UNITS = 10000;
+    Scenario s;
+    auto& u = s.add_unit("uel0201");
+    s.damage(u, 1); // binds LeafUnit, installing the guard
+    lua_State* L = s.state.raw();
+    auto create = [&](const char* cls) {
+        lua_getglobal(L, "CreateUnits");
+        lua_getglobal(L, cls);
+        lua_pushnumber(L, UNITS);
+        lua_call(L, 2, 0);
+        return lua_gettop(L);
+    };
+
+    BENCHMARK("10k OnCreate, unguarded class") { return create("PlainUnit"); };
+    BENCHMARK("10k OnCreate, guarded class") { return create("LeafUnit"); };
+}
@@ -0,0 +1,214 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "renderer/mesh_loader.hpp"
+
+extern "C" {
+#include <lauxlib.h>
+#include <lua.h>
+#include <lualib.h>
+}
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace osc;
+using namespace osc::renderer;
+
+namespace {
+
+template <typename T>
+void put(std::vector<char>& buf, const T& value) {
+    const char* p = reinterpret_cast<const char*>(&value);
+    buf.insert(buf.end(), p, p + sizeof(T));
+}
+
+/// Minimal SCM v5 file: `n` vertices on a line, one triangle.
+std::vector<char> build_scm(u32 n) {
+    constexpr u32 HEADER = 48, VERT_SIZE = 68;
+    std::vector<char> buf;
+    buf.reserve(HEADER + n * VERT_SIZE + 6);
+    for (char c : {'M', 'O', 'D', 'L'}) buf.push_back(c);
+    for (u32 v : {5u, 0u, 1u, HEADER, 0u, n, HEADER + n * VERT_SIZE, 3u, 0u, 0u, 1u})
+        put(buf, v);
+    for (u32 i = 0; i < n; ++i) {
+        const f32 f[16] = {static_cast<f32>(i), 0, 0,  1, 0, 0,  0, 1, 0,
+                           0, 0, 1,  0.5f, 0.5f,  0, 0};
+        for (f32 c : f) put(buf, c);
+        put(buf, u32{0});
+    }
+    for (u16 i : {u16{0}, u16{1}, u16{2}}) put(buf, i);
+    return buf;
+}
+
+/// Every Lua instruction executed on the state, by thread.
+std::mutex lua_threads_mutex;
+std::set<std::thread::id> lua_threads;
+std::atomic<u32> lua_instructions{0};
+
+void record_lua_thread(lua_State*, lua_Debug*) {
+    std::lock_guard<std::mutex> lock(lua_threads_mutex);
+    lua_threads.insert(std::this_thread::get_id());
+    lua_instructions++;
+}
+
+/// Blueprint table in Lua, read through a Lua function so that the count
+/// hook sees every access that goes through the interpreter.
+struct BlueprintLua {
+    lua_State* L = lua_open();
+
+    BlueprintLua() {
+        luaopen_base(L);
+        REQUIRE(lua_dostring(L, R"(
+            __blueprints = {
+                ['/units/a/a_mesh'] = { LODs = {
+                    { MeshName = '/units/a/a_lod0.scm', LODCutoff = 100 },
+                    { MeshName = '/units/a/a_lod1.scm', LODCutoff = 300 },
+                    { MeshName = '/units/a/a_lod2.scm', LODCutoff = 0 },
+                } },
+                ['/units/b/b_mesh'] = { LODs = {
+                    { MeshName = '/units/b/b_lod0.scm', LODCutoff = 150 },
+                } },
+            }
+            function MeshLODs(id) return __blueprints[id].LODs end
+        )") == 0);
+        lua_threads.clear();
+        lua_instructions = 0;
+        lua_sethook(L, record_lua_thread, LUA_MASKCOUNT, 1);
+    }
+    ~BlueprintLua() { lua_close(L); }
+
+    /// The main-thread stage MeshCache::resolve_mesh_set performs.
+    MeshSetDescriptor resolve(const std::string& mesh_bp_id) {
+        MeshSetDescriptor set;
+        set.bp_id = mesh_bp_id;
+        lua_getglobal(L, "MeshLODs");
+        lua_pushstring(L, mesh_bp_id.c_str());
+        REQUIRE(lua_pcall(L, 1, 1, 0) == 0);
+        int lods = lua_gettop(L);
+        for (int i = 1;; ++i) {
+            lua_rawgeti(L, lods, i);
+            if (!lua_istable(L, -1)) { lua_pop(L, 1); break; }
+            LODDescriptor lod;
+            lua_pushstring(L, "MeshName");
+            lua_rawget(L, -2);
+            lod.mesh_path = lua_tostring(L, -1);
+            lua_pushstring(L, "LODCutoff");
+            lua_rawget(L, -3);
+            lod.cutoff = static_cast<f32>(lua_tonumber(L, -1));
+            lua_pop(L, 3);
+            set.lods.push_back(std::move(lod));
+        }
+        lua_pop(L, 1);
+        return set;
+    }
+};
+
+/// File reader standing in for the VFS; records who read what.
+struct MockFiles {
+    std::mutex mutex;
+    std::vector<std::string> reads;
+    std::set<std::thread::id> threads;
+    std::set<std::string> missing;
+
+    MeshLoader::ReadFile reader() {
+        return [this](const std::string& path) -> std::optional<std::vector<char>> {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                reads.push_back(path);
+                threads.insert(std::this_thread::get_id());
+            }
+            if (missing.count(path)) return std::nullopt;
+            return build_scm(4 + static_cast<u32>(path.size() % 5));
+        };
+    }
+};
+
+} // namespace
+
+TEST_CASE("Mesh loader parses on workers without touching Lua",
+          "[renderer][mesh_loader]") {
+    BlueprintLua lua;
+    MockFiles files;
+    const auto main_thread = std::this_thread::get_id();
+
+    MeshLoader loader(files.reader(), 2);
+    REQUIRE(loader.worker_count() == 2);
+    for (const char* id : {"/units/a/a_mesh", "/units/b/b_mesh"})
+        loader.submit(lua.resolve(id));
+    CHECK(loader.pending("/units/a/a_mesh") == 3);
+    CHECK(loader.pending("/units/b/b_mesh") == 1);
+
+    // Lua after resolution: the descriptors must not see it
+    REQUIRE(lua_dostring(lua.L, "__blueprints['/units/a/a_mesh'].LODs[1].MeshName = 'x'") == 0);
+
+    loader.wait_parsed();
+
+    // Mock uploader: takes everything
+    std::vector<ParsedLOD> uploaded;
+    u32 accepted = loader.drain([&](ParsedLOD& lod) {
+        CHECK(std::this_thread::get_id() == main_thread);
+        uploaded.push_back(std::move(lod));
+        return true;
+    });
+    CHECK(accepted == 4);
+    CHECK(loader.idle());
+    for (const auto& lod : uploaded) {
+        CHECK(lod.ok());
+        CHECK(lod.desc.mesh_path != "x");
+    }
+
+    // All file work ran on workers; all Lua ran on the main thread
+    CHECK(files.reads.size() == 4);
+    CHECK_FALSE(files.threads.empty());
+    CHECK(files.threads.count(main_thread) == 0);
+    CHECK(lua_instructions > 0);
+    CHECK(lua_threads == std::set<std::thread::id>{main_thread});
+}
+
+TEST_CASE("Mesh loader queues the coarsest LOD first", "[renderer][mesh_loader]") {
+    BlueprintLua lua;
+    MockFiles files;
+    MeshLoader loader(files.reader(), 1);
+    loader.submit(lua.resolve("/units/a/a_mesh"));
+    loader.wait_parsed();
+
+    // One worker: reads happen in queue order. Cutoff 0 (no limit) first.
+    REQUIRE(files.reads.size() == 3);
+    CHECK(files.reads[0] == "/units/a/a_lod2.scm");
+    CHECK(files.reads[1] == "/units/a/a_lod1.scm");
+    CHECK(files.reads[2] == "/units/a/a_lod0.scm");
+}
+
+TEST_CASE("Declined LODs wait for the next drain", "[renderer][mesh_loader]") {
+    BlueprintLua lua;
+    MockFiles files;
+    files.missing.insert("/units/a/a_lod1.scm");
+    MeshLoader loader(files.reader(), 1);
+    loader.submit(lua.resolve("/units/a/a_mesh"));
+    loader.wait_parsed();
+
+    // An uploader with room for one LOD per flush
+    std::vector<std::string> order;
+    u32 failed = 0;
+    for (u32 flush = 0; flush < 3; ++flush) {
+        bool room = true;
+        u32 n = loader.drain([&](ParsedLOD& lod) {
+            if (!room) return false;
+            room = false;
+            order.push_back(lod.desc.mesh_path);
+            if (!lod.ok()) failed++;
+            return true;
+        });
+        CHECK(n == 1);
+        CHECK(loader.pending("/units/a/a_mesh") == 2 - flush);
+    }
+    CHECK(loader.idle());
+    CHECK(order == std::vector<std::string>{"/units/a/a_lod2.scm",
+                                            "/units/a/a_lod1.scm",
+                                            "/units/a/a_lod0.scm"});
+    // A missing file still completes its slot, as an empty LOD
+    CHECK(failed == 1);
+}
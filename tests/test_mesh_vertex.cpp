@@ -0,0 +1,189 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "renderer/mesh_vertex.hpp"
+#include "sim/scm_parser.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+using namespace osc;
+using namespace osc::renderer;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+struct SourceVertex {
+    f32 pos[3], tangent[3], normal[3], uv[2];
+    u8 bones[4];
+};
+
+void normalize(f32 (&v)[3]) {
+    f32 len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    for (f32& c : v) c /= len;
+}
+
+/// Random vertices over a unit-sized box, as a tank hull might span.
+std::vector<SourceVertex> random_vertices(u32 n, u32 seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<f32> pos(-1.0f, 1.0f);
+    std::uniform_real_distribution<f32> dir(-1.0f, 1.0f);
+    std::uniform_real_distribution<f32> uv(-0.25f, 1.5f);
+    std::uniform_int_distribution<int> bone(0, 7);
+    std::vector<SourceVertex> out(n);
+    for (auto& v : out) {
+        v.pos[0] = 1.2f * pos(rng);
+        v.pos[1] = 0.4f + 0.35f * pos(rng);
+        v.pos[2] = 2.5f * pos(rng);
+        for (int a = 0; a < 3; ++a) {
+            v.normal[a] = dir(rng);
+            v.tangent[a] = dir(rng);
+        }
+        normalize(v.normal);
+        normalize(v.tangent);
+        v.uv[0] = uv(rng);
+        v.uv[1] = uv(rng);
+        for (u8& b : v.bones) b = static_cast<u8>(bone(rng));
+    }
+    // Axis-aligned frames are common in real meshes; keep a few exact ones
+    const f32 axes[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0},
+                            {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    for (int i = 0; i < 6 && i < static_cast<int>(n); ++i)
+        std::memcpy(out[static_cast<size_t>(i)].normal, axes[i], sizeof(axes[i]));
+    return out;
+}
+
+template <typename T>
+void put(std::vector<char>& buf, const T& value) {
+    const char* p = reinterpret_cast<const char*>(&value);
+    buf.insert(buf.end(), p, p + sizeof(T));
+}
+
+/// Minimal SCM v5 file: header, 68-byte vertices, one triangle.
+std::vector<char> build_scm(const std::vector<SourceVertex>& verts) {
+    constexpr u32 HEADER = 48, VERT_SIZE = 68;
+    const u32 vert_count = static_cast<u32>(verts.size());
+    std::vector<char> buf;
+    buf.reserve(HEADER + vert_count * VERT_SIZE + 6);
+    for (char c : {'M', 'O', 'D', 'L'}) buf.push_back(c);
+    put(buf, u32{5});
+    put(buf, u32{0});                             // bone_offset
+    put(buf, u32{8});                             // bone_count
+    put(buf, HEADER);                             // vert_offset
+    put(buf, u32{0});                             // extra_vert_offset
+    put(buf, vert_count);
+    put(buf, HEADER + vert_count * VERT_SIZE);    // index_offset
+    put(buf, u32{3});                             // index_count
+    put(buf, u32{0});
+    put(buf, u32{0});
+    put(buf, u32{8});
+    for (const auto& v : verts) {
+        for (f32 c : v.pos) put(buf, c);
+        for (f32 c : v.tangent) put(buf, c);
+        for (f32 c : v.normal) put(buf, c);
+        for (int i = 0; i < 3; ++i) put(buf, 0.0f); // binormal
+        for (f32 c : v.uv) put(buf, c);
+        put(buf, 0.0f);                              // uv2
+        put(buf, 0.0f);
+        buf.insert(buf.end(), v.bones, v.bones + 4);
+    }
+    for (u16 i : {u16{0}, u16{1}, u16{2}}) put(buf, i);
+    return buf;
+}
+
+/// Angle in radians between two directions, via atan2 so that tiny
+/// angles stay resolvable (acos of a dot product near 1 does not).
+f64 angle_between(f64 ax, f64 ay, f64 az, f64 bx, f64 by, f64 bz) {
+    f64 cx = ay * bz - az * by, cy = az * bx - ax * bz, cz = ax * by - ay * bx;
+    return std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz),
+                      ax * bx + ay * by + az * bz);
+}
+
+} // namespace
+
+TEST_CASE("Packed mesh vertex round-trips SCM data", "[renderer][mesh_vertex]") {
+    auto source = random_vertices(4000, 17);
+    auto mesh = sim::parse_scm_mesh(build_scm(source));
+    REQUIRE(mesh);
+    REQUIRE(mesh->vertices.size() == source.size());
+
+    auto packed = pack_scm_mesh(*mesh);
+    REQUIRE(packed.vertices.size() == mesh->vertices.size());
+    const auto& q = packed.quant;
+
+    // One snorm16 step is scale / 32767; rounding is within half of it
+    // plus float slack.
+    f32 pos_tol[3];
+    for (int a = 0; a < 3; ++a) pos_tol[a] = q.scale[a] / 32767.0f * 0.5f + 1e-6f;
+    const f32 uv_tol = q.scale[3] / 65535.0f * 0.5f + 1e-6f;
+
+    f64 worst_normal = 0, worst_tangent = 0;
+    for (size_t i = 0; i < mesh->vertices.size(); ++i) {
+        const auto& src = mesh->vertices[i];
+        auto out = unpack_vertex(packed.vertices[i], q);
+        CHECK_THAT(out.px, WithinAbs(src.px, pos_tol[0]));
+        CHECK_THAT(out.py, WithinAbs(src.py, pos_tol[1]));
+        CHECK_THAT(out.pz, WithinAbs(src.pz, pos_tol[2]));
+        CHECK_THAT(out.u, WithinAbs(src.u, uv_tol));
+        CHECK_THAT(out.v, WithinAbs(src.v, uv_tol));
+        CHECK(std::memcmp(packed.vertices[i].bone_indices, src.bone_indices, 4) == 0);
+
+        worst_normal = std::max(worst_normal,
+            angle_between(out.nx, out.ny, out.nz, src.nx, src.ny, src.nz));
+        worst_tangent = std::max(worst_tangent,
+            angle_between(out.tx, out.ty, out.tz, src.tx, src.ty, src.tz));
+    }
+    // 16-bit octahedral encoding stays well under a hundredth of a degree
+    INFO("worst normal error " << worst_normal << " rad, tangent "
+         << worst_tangent << " rad");
+    CHECK(worst_normal < 1e-4);
+    CHECK(worst_tangent < 1e-4);
+}
+
+TEST_CASE("Packed mesh vertex keeps bounds and axis frames exact",
+          "[renderer][mesh_vertex]") {
+    SECTION("Bounding box corners land on the extreme codes") {
+        sim::SCMMesh mesh;
+        mesh.vertices.resize(2);
+        mesh.vertices[0] = {-3, 0, 1, 0, 1, 0, 0, 0, {0, 0, 0, 0}, {}, 1, 0, 0};
+        mesh.vertices[1] = {5, 2, 9, 0, 1, 0, 1, 1, {1, 1, 1, 1}, {}, 1, 0, 0};
+        auto packed = pack_scm_mesh(mesh);
+        auto lo = unpack_vertex(packed.vertices[0], packed.quant);
+        auto hi = unpack_vertex(packed.vertices[1], packed.quant);
+        CHECK(lo.px == -3.0f);
+        CHECK(hi.px == 5.0f);
+        CHECK(lo.pz == 1.0f);
+        CHECK(hi.pz == 9.0f);
+        CHECK(lo.u == 0.0f);
+        CHECK(hi.v == 1.0f);
+    }
+
+    SECTION("Flat meshes keep their constant axis") {
+        sim::SCMMesh mesh;
+        mesh.vertices.resize(3);
+        for (int i = 0; i < 3; ++i)
+            mesh.vertices[static_cast<size_t>(i)] =
+                {static_cast<f32>(i), 0.75f, 2.0f, 0, 1, 0, 0.5f, 0.5f, {}, {}, 1, 0, 0};
+        auto packed = pack_scm_mesh(mesh);
+        for (const auto& v : packed.vertices) {
+            auto out = unpack_vertex(v, packed.quant);
+            CHECK(out.py == 0.75f);
+            CHECK(out.pz == 2.0f);
+            CHECK(out.u == 0.5f);
+        }
+    }
+
+    SECTION("Axis-aligned normals decode exactly") {
+        const f32 axes[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0},
+                                {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+        for (const auto& a : axes) {
+            auto e = oct_encode(a[0], a[1], a[2]);
+            auto d = oct_decode(e[0], e[1]);
+            CHECK(d[0] == a[0]);
+            CHECK(d[1] == a[1]);
+            CHECK(d[2] == a[2]);
+        }
+    }
+}
@@ -0,0 +1,313 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "renderer/minimap_tiles.hpp"
+#include "map/visibility_grid.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace osc;
+using namespace osc::renderer;
+
+namespace {
+
+constexpr f32 MAP_SIZE = 1024.0f;
+constexpr u32 RES = 256;
+constexpr u32 COPIES = 2;
+constexpr u32 UNITS = 10000;
+constexpr i32 ARMIES = 8;
+
+/// Stands in for MinimapRenderer: keeps what the GPU copies would hold.
+struct MockUploader : MinimapUploader {
+    std::array<std::vector<MinimapDot>, MinimapDotBuffer::SEGMENTS> dots;
+    std::vector<u8> image = std::vector<u8>(RES * RES * 4, 0);
+    u32 dot_calls = 0;
+    u32 tiles = 0;
+
+    MockUploader() {
+        for (auto& d : dots) d.resize(MinimapDotBuffer::MAX_DOTS_PER_SEGMENT);
+    }
+
+    void upload_dots(u32 segment, u32 first, const MinimapDot* src,
+                     u32 count) override {
+        std::copy(src, src + count, dots[segment].begin() + first);
+        ++dot_calls;
+    }
+
+    void upload_tile(u32 tx, u32 ty, const u8* rgba) override {
+        constexpr u32 T = MinimapTiles::TILE_SIZE;
+        for (u32 y = 0; y < T; ++y)
+            std::copy(rgba + y * T * 4, rgba + (y + 1) * T * 4,
+                      image.begin() + ((ty * T + y) * RES + tx * T) * 4);
+        ++tiles;
+    }
+
+    /// The GPU copy of every segment matches the CPU mirror up to its count.
+    bool matches(const MinimapDotBuffer& buf) const {
+        for (u32 seg = 0; seg < MinimapDotBuffer::SEGMENTS; ++seg) {
+            const auto& cpu = buf.dots(seg);
+            for (size_t i = 0; i < cpu.size(); ++i)
+                if (cpu[i].x != dots[seg][i].x || cpu[i].y != dots[seg][i].y)
+                    return false;
+        }
+        return true;
+    }
+};
+
+struct GameUnit {
+    u32 id;
+    i32 army;
+    f32 x, z;
+    bool alive = true;
+};
+
+struct Game {
+    std::vector<GameUnit> units;
+    std::mt19937 rng{5};
+
+    Game() {
+        std::uniform_real_distribution<f32> coord(0.0f, MAP_SIZE);
+        for (u32 i = 0; i < UNITS; ++i)
+            units.push_back({i + 1, static_cast<i32>(i % ARMIES), coord(rng), coord(rng)});
+    }
+
+    /// What MinimapRenderer::update feeds the dot buffer.
+    void frame(MinimapDotBuffer& buf) const {
+        buf.begin_frame();
+        for (const auto& u : units)
+            if (u.alive) buf.add(u.id, u.army, u.x, u.z);
+        buf.end_frame();
+    }
+
+    void move(GameUnit& u, f32 dist) {
+        std::uniform_real_distribution<f32> angle(0.0f, 6.2831853f);
+        f32 a = angle(rng);
+        u.x = std::clamp(u.x + std::cos(a) * dist, 0.0f, MAP_SIZE);
+        u.z = std::clamp(u.z + std::sin(a) * dist, 0.0f, MAP_SIZE);
+    }
+};
+
+std::pair<u32, u32> pixel_of(f32 x, f32 z) {
+    f32 res = static_cast<f32>(RES);
+    return {static_cast<u32>(std::min(x / MAP_SIZE * res, res - 1)),
+            static_cast<u32>(std::min(z / MAP_SIZE * res, res - 1))};
+}
+
+/// Every live unit's dot sits in its army's segment at its pixel.
+bool dots_match_units(const MinimapDotBuffer& buf, const Game& g) {
+    for (i32 army = 0; army < ARMIES; ++army) {
+        std::vector<std::pair<u32, u32>> want, have;
+        for (const auto& u : g.units)
+            if (u.alive && u.army == army) want.push_back(pixel_of(u.x, u.z));
+        for (const auto& d : buf.dots(MinimapDotBuffer::segment_of(army)))
+            have.emplace_back(d.x, d.y);
+        std::sort(want.begin(), want.end());
+        std::sort(have.begin(), have.end());
+        if (want != have) return false;
+    }
+    return true;
+}
+
+std::vector<u8> make_terrain() {
+    std::vector<u8> rgba(RES * RES * 4);
+    for (u32 y = 0; y < RES; ++y)
+        for (u32 x = 0; x < RES; ++x) {
+            u8* p = &rgba[(y * RES + x) * 4];
+            p[0] = static_cast<u8>(40 + x % 100);
+            p[1] = static_cast<u8>(60 + y % 120);
+            p[2] = static_cast<u8>(30 + (x + y) % 60);
+            p[3] = 255;
+        }
+    return rgba;
+}
+
+/// A from-scratch composite of the same state, for comparison.
+std::vector<u8> reference_image(const map::VisibilityGrid* grid, u32 army,
+                                const std::vector<std::pair<f32, f32>>& reclaim) {
+    MinimapTiles fresh(RES);
+    fresh.set_terrain(make_terrain(), MAP_SIZE, MAP_SIZE);
+    fresh.update_fog(grid, army);
+    fresh.begin_reclaim();
+    for (auto [x, z] : reclaim) fresh.add_reclaim(x, z);
+    fresh.end_reclaim();
+    MockUploader up;
+    fresh.flush(up);
+    return up.image;
+}
+
+} // namespace
+
+TEST_CASE("Minimap dots upload only units that change pixel", "[renderer][minimap]") {
+    Game g;
+    MinimapDotBuffer buf(RES, COPIES);
+    buf.set_map_size(MAP_SIZE, MAP_SIZE);
+    MockUploader gpu[COPIES];
+
+    g.frame(buf);
+    CHECK(buf.unit_count() == UNITS);
+    CHECK(dots_match_units(buf, g));
+    for (u32 c = 0; c < COPIES; ++c) buf.flush(gpu[c], c);
+    CHECK(buf.stats().uploaded == UNITS * COPIES);
+    // Fresh segments are contiguous: one run per army and copy
+    CHECK(buf.stats().runs == ARMIES * COPIES);
+    CHECK(gpu[0].matches(buf));
+    CHECK(gpu[1].matches(buf));
+
+    // Nothing moved: nothing to send
+    g.frame(buf);
+    buf.flush(gpu[0], 0);
+    CHECK(buf.stats().uploaded == UNITS * COPIES);
+
+    // Shuffle within a pixel (4 world units) for some, walk for others
+    u32 expected = 0;
+    for (u32 i = 0; i < UNITS; i += 5) {
+        auto& u = g.units[i];
+        auto before = pixel_of(u.x, u.z);
+        g.move(u, (i % 10 == 0) ? 0.3f : 12.0f);
+        if (pixel_of(u.x, u.z) != before) ++expected;
+    }
+    const u64 moved = buf.stats().moved;
+    const u64 uploaded = buf.stats().uploaded;
+    g.frame(buf);
+    CHECK(buf.stats().moved - moved == expected);
+    CHECK(expected > UNITS / 20);
+    CHECK(expected < UNITS / 5);
+    buf.flush(gpu[0], 0);
+    CHECK(buf.stats().uploaded - uploaded == expected);
+    CHECK(gpu[0].matches(buf));
+    CHECK(dots_match_units(buf, g));
+
+    // Deaths and captures: segments shrink and swap, the other copy
+    // catches up on both frames at once
+    for (u32 i = 0; i < UNITS; i += 20) g.units[i].alive = false;
+    for (u32 i = 3; i < UNITS; i += 97) g.units[i].army = (g.units[i].army + 1) % ARMIES;
+    g.frame(buf);
+    u32 alive = 0;
+    for (const auto& u : g.units) alive += u.alive ? 1 : 0;
+    CHECK(buf.unit_count() == alive);
+    CHECK(dots_match_units(buf, g));
+    buf.flush(gpu[0], 0);
+    buf.flush(gpu[1], 1);
+    CHECK(gpu[0].matches(buf));
+    CHECK(gpu[1].matches(buf));
+}
+
+TEST_CASE("Minimap tiles follow fog, intel and reclaim", "[renderer][minimap]") {
+    map::VisibilityGrid grid(static_cast<u32>(MAP_SIZE), static_cast<u32>(MAP_SIZE));
+    MinimapTiles tiles(RES);
+    const u32 all = tiles.tiles_per_side() * tiles.tiles_per_side();
+    REQUIRE(all == 64);
+    tiles.set_terrain(make_terrain(), MAP_SIZE, MAP_SIZE);
+    MockUploader gpu;
+    std::vector<std::pair<f32, f32>> reclaim;
+
+    // First frame sends everything, then nothing until something changes
+    tiles.update_fog(&grid, 0);
+    tiles.flush(gpu);
+    CHECK(gpu.tiles == all);
+    CHECK(gpu.image == reference_image(&grid, 0, reclaim));
+    tiles.update_fog(&grid, 0);
+    CHECK(tiles.dirty_count() == 0);
+
+    // A scout's vision: only the tiles under it
+    grid.paint_circle(0, 200.0f, 200.0f, 60.0f, map::VisFlag::Vision);
+    tiles.update_fog(&grid, 0);
+    const u32 vision_tiles = tiles.dirty_count();
+    CHECK(vision_tiles > 0);
+    CHECK(vision_tiles <= 9);
+    CHECK(tiles.dirty(1, 1));
+    CHECK_FALSE(tiles.dirty(7, 7));
+    tiles.flush(gpu);
+    CHECK(gpu.image == reference_image(&grid, 0, reclaim));
+    CHECK(tiles.fog_at(50, 50) == MinimapTiles::FOG_VISION);
+    CHECK(tiles.fog_at(200, 200) == MinimapTiles::FOG_UNEXPLORED);
+
+    // Vision ends (explored stays), radar appears elsewhere
+    grid.clear_transient();
+    grid.paint_circle(0, 800.0f, 800.0f, 100.0f, map::VisFlag::Radar);
+    tiles.update_fog(&grid, 0);
+    CHECK(tiles.dirty(1, 1));
+    CHECK(tiles.dirty(6, 6));
+    CHECK_FALSE(tiles.dirty(0, 7));
+    tiles.flush(gpu);
+    CHECK(gpu.image == reference_image(&grid, 0, reclaim));
+    CHECK(tiles.fog_at(50, 50) == MinimapTiles::FOG_EXPLORED);
+    CHECK(tiles.fog_at(200, 200) == MinimapTiles::FOG_INTEL);
+
+    // Another army's vision is not ours
+    grid.paint_circle(1, 500.0f, 500.0f, 80.0f, map::VisFlag::Vision);
+    tiles.update_fog(&grid, 0);
+    CHECK(tiles.dirty_count() == 0);
+
+    // A wreck appears, stays, then is reclaimed
+    auto reclaim_frame = [&] {
+        tiles.begin_reclaim();
+        for (auto [x, z] : reclaim) tiles.add_reclaim(x, z);
+        tiles.end_reclaim();
+    };
+    reclaim.emplace_back(210.0f, 190.0f);
+    reclaim_frame();
+    CHECK(tiles.dirty_count() == 1);
+    CHECK(tiles.dirty(1, 1));
+    tiles.flush(gpu);
+    CHECK(gpu.image == reference_image(&grid, 0, reclaim));
+    reclaim_frame();
+    CHECK(tiles.dirty_count() == 0);
+    reclaim.clear();
+    reclaim_frame();
+    CHECK(tiles.dirty_count() == 1);
+    tiles.flush(gpu);
+    CHECK(gpu.image == reference_image(&grid, 0, reclaim));
+
+    // Fog off shows the plain terrain everywhere
+    tiles.update_fog(nullptr, 0);
+    CHECK(tiles.dirty_count() == all);
+    tiles.flush(gpu);
+    CHECK(gpu.image == make_terrain());
+}
+
+TEST_CASE("Minimap update benchmark", "[.benchmark][renderer][minimap]") {
+    Game g;
+    MinimapDotBuffer buf(RES, COPIES);
+    buf.set_map_size(MAP_SIZE, MAP_SIZE);
+    MockUploader gpu;
+    g.frame(buf);
+    buf.flush(gpu, 0);
+
+    map::VisibilityGrid grid(static_cast<u32>(MAP_SIZE), static_cast<u32>(MAP_SIZE));
+    MinimapTiles tiles(RES);
+    tiles.set_terrain(make_terrain(), MAP_SIZE, MAP_SIZE);
+    tiles.update_fog(&grid, 0);
+    tiles.flush(gpu);
+
+    // The quad path this replaces: one 48-byte instance per unit per frame
+    struct Quad { f32 rect[4], uv[4], color[4]; };
+    std::vector<Quad> quads;
+    quads.reserve(UNITS);
+
+    u32 tick = 0;
+    BENCHMARK("10k units, per-frame quads") {
+        quads.clear();
+        for (const auto& u : g.units) {
+            Quad q{};
+            q.rect[0] = 10.0f + u.x / MAP_SIZE * 200.0f;
+            q.rect[1] = 10.0f + u.z / MAP_SIZE * 200.0f;
+            q.rect[2] = q.rect[3] = 3.0f;
+            quads.push_back(q);
+        }
+        return quads.size();
+    };
+    BENCHMARK("10k units, incremental dots + fog tiles (2% moving)") {
+        for (u32 i = tick % 50; i < UNITS; i += 50) g.move(g.units[i], 3.0f);
+        ++tick;
+        g.frame(buf);
+        buf.flush(gpu, tick % COPIES);
+        tiles.update_fog(&grid, 0);
+        tiles.flush(gpu);
+        return buf.stats().uploaded;
+    };
+}
@@ -0,0 +1,225 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "map/heightmap.hpp"
+#include "map/pathfinder.hpp"
+#include "map/pathfinding_grid.hpp"
+#include "sim/navigator.hpp"
+
+#include <cmath>
+#include <memory>
+#include <random>
+
+using namespace osc;
+using namespace osc::map;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+/// Flat 256x256 map (128x128 cells) with a few walls.
+std::unique_ptr<PathfindingGrid> walled_grid() {
+    Heightmap hm(256, 256, 1.0f, std::vector<u16>(257 * 257, 0));
+    auto grid = std::make_unique<PathfindingGrid>(hm, 0.0f, false);
+    grid->mark_obstacle(80, 128, 4, 120);
+    grid->mark_obstacle(176, 128, 4, 120);
+    grid->mark_obstacle(128, 60, 90, 4);
+    grid->mark_obstacle(128, 196, 90, 4);
+    return grid;
+}
+
+bool passable(const PathfindingGrid& grid, f32 x, f32 z) {
+    u32 gx, gz;
+    grid.world_to_grid(x, z, gx, gz);
+    return grid.is_passable_for(gx, gz, "Land");
+}
+
+/// Target that wanders on an ellipse; some cross the walls.
+sim::Vector3 target_at(u32 i, u32 tick) {
+    f32 phase = static_cast<f32>(i) * 2.39996f;
+    f32 cx = 40.0f + static_cast<f32>(i % 10) * 19.0f;
+    f32 cz = 20.0f + static_cast<f32>(i / 10) * 11.0f;
+    f32 a = phase + 0.01f * static_cast<f32>(tick);
+    return {cx + 12.0f * std::cos(a), 0, cz + 6.0f * std::sin(a)};
+}
+
+/// Chaser that walks its waypoints at a fixed speed per tick.
+struct Chaser {
+    sim::Vector3 pos;
+    std::vector<sim::Vector3> waypoints;
+    size_t next = 0;
+    PursuitState pursuit;
+
+    void step(f32 speed) {
+        while (next < waypoints.size() && speed > 0) {
+            f32 dx = waypoints[next].x - pos.x, dz = waypoints[next].z - pos.z;
+            f32 d = std::sqrt(dx * dx + dz * dz);
+            if (d <= speed) {
+                pos.x = waypoints[next].x;
+                pos.z = waypoints[next].z;
+                speed -= d;
+                next++;
+            } else {
+                pos.x += dx / d * speed;
+                pos.z += dz / d * speed;
+                speed = 0;
+            }
+        }
+    }
+};
+
+struct ChaseStats {
+    u64 expansions = 0;
+    u32 searches = 0;
+    f32 mean_gap = 0; ///< mean chaser-target distance over the last tick
+};
+
+ChaseStats run_chase(bool pursuit, u32 count, u32 ticks) {
+    auto grid = walled_grid();
+    Pathfinder pf(*grid);
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<f32> d(8.0f, 248.0f);
+    std::vector<Chaser> chasers(count);
+    for (auto& c : chasers) {
+        do { c.pos = {d(rng), 0, d(rng)}; } while (!passable(*grid, c.pos.x, c.pos.z));
+    }
+
+    ChaseStats stats;
+    for (u32 tick = 0; tick < ticks; ++tick) {
+        for (u32 i = 0; i < chasers.size(); ++i) {
+            auto& c = chasers[i];
+            auto t = target_at(i, tick);
+            f32 dx = t.x - c.pos.x, dz = t.z - c.pos.z;
+            if (dx * dx + dz * dz > 4.0f * 4.0f) {
+                // Unit::update asks for a new path whenever the target moved;
+                // the budget is lifted so both modes answer every request.
+                pf.reset_request_count();
+                u64 expanded = pf.nodes_expanded();
+                PathResult r = pursuit
+                    ? pf.pursue(c.pursuit, c.pos.x, c.pos.z, t.x, t.z, "Land")
+                    : pf.find_path(c.pos.x, c.pos.z, t.x, t.z, "Land");
+                REQUIRE(r.found);
+                if (passable(*grid, t.x, t.z))
+                    CHECK_THAT(r.waypoints.back().x, WithinAbs(t.x, 1e-4));
+                if (pf.nodes_expanded() != expanded) stats.searches++;
+                if (r.retargeted && !c.waypoints.empty()) {
+                    c.waypoints.back() = r.waypoints.back();
+                } else {
+                    c.waypoints = std::move(r.waypoints);
+                    c.next = 0;
+                }
+            }
+            c.step(0.8f);
+        }
+    }
+    for (u32 i = 0; i < chasers.size(); ++i) {
+        auto t = target_at(i, ticks - 1);
+        stats.mean_gap += std::hypot(t.x - chasers[i].pos.x, t.z - chasers[i].pos.z);
+    }
+    stats.mean_gap /= static_cast<f32>(chasers.size());
+    stats.expansions = pf.nodes_expanded();
+    return stats;
+}
+
+} // namespace
+
+TEST_CASE("Pursuit keeps or splices the path for small goal moves",
+          "[map][pathfinder]") {
+    auto grid = walled_grid();
+    Pathfinder pf(*grid);
+    PursuitState state;
+
+    auto first = pf.pursue(state, 20, 20, 230, 230, "Land");
+    REQUIRE(first.found);
+    CHECK_FALSE(first.retargeted);
+    CHECK_THAT(first.waypoints.back().x, WithinAbs(230.0, 1e-4));
+    u64 searched = pf.nodes_expanded();
+    CHECK(searched > 0);
+
+    // Within a cell of the old goal: keep the path, no search
+    pf.reset_request_count();
+    auto same = pf.pursue(state, 20, 20, 231, 230.5f, "Land");
+    CHECK(same.found);
+    CHECK(same.retargeted);
+    CHECK(pf.nodes_expanded() == searched);
+
+    // A few cells along: spliced onto the path, still no search
+    auto spliced = pf.pursue(state, 20, 20, 236, 228, "Land");
+    CHECK(spliced.found);
+    CHECK_FALSE(spliced.retargeted);
+    CHECK_THAT(spliced.waypoints.back().x, WithinAbs(236.0, 1e-4));
+    CHECK(pf.nodes_expanded() == searched);
+
+    // Far away: a search, resumed from the retained tree
+    auto moved = pf.pursue(state, 20, 20, 240, 40, "Land");
+    CHECK(moved.found);
+    u64 resumed = pf.nodes_expanded() - searched;
+    Pathfinder fresh(*grid);
+    REQUIRE(fresh.find_path(20, 20, 240, 40, "Land").found);
+    CHECK(resumed < fresh.nodes_expanded());
+
+    // Passability changes drop the tree
+    grid->mark_obstacle(10, 10, 2, 2);
+    pf.reset_request_count();
+    auto after = pf.pursue(state, 20, 20, 240, 41, "Land");
+    CHECK(after.found);
+    CHECK_FALSE(after.retargeted);
+    CHECK(state.root != PursuitState::NO_CELL);
+}
+
+TEST_CASE("Pursuit searches respect the request budget", "[map][pathfinder]") {
+    auto grid = walled_grid();
+    Pathfinder pf(*grid);
+    for (int i = 0; i < Pathfinder::MAX_REQUESTS_PER_TICK; ++i)
+        pf.increment_request_count();
+    PursuitState state;
+    auto r = pf.pursue(state, 20, 20, 230, 230, "Land");
+    CHECK(r.throttled);
+    CHECK_FALSE(r.found);
+}
+
+TEST_CASE("Navigator frees its pursuit search when the chase ends",
+          "[map][pathfinder]") {
+    auto grid = walled_grid();
+    Pathfinder pf(*grid);
+    sim::Navigator nav;
+    const sim::Vector3 from{20, 0, 20};
+
+    nav.pursue({230, 0, 230}, &pf, from, "Land");
+    CHECK(nav.has_pursuit_state());
+    nav.abort_move();
+    CHECK_FALSE(nav.has_pursuit_state());
+    CHECK_FALSE(nav.is_moving());
+
+    // A plain goal replaces the chase
+    nav.pursue({230, 0, 230}, &pf, from, "Land");
+    nav.set_goal({40, 0, 40}, &pf, from, "Land");
+    CHECK_FALSE(nav.has_pursuit_state());
+    CHECK(nav.is_moving());
+
+    nav.pursue({230, 0, 230}, &pf, from, "Land");
+    nav.follow_path({{30, 0, 30}});
+    CHECK_FALSE(nav.has_pursuit_state());
+
+    // Air never searches
+    nav.pursue({230, 0, 230}, &pf, from, "Air");
+    CHECK_FALSE(nav.has_pursuit_state());
+}
+
+TEST_CASE("Chasers expand an order of magnitude fewer nodes in pursuit",
+          "[map][pathfinder]") {
+    auto full = run_chase(false, 20, 100);
+    auto incremental = run_chase(true, 20, 100);
+    INFO("full A*: " << full.expansions << " expansions, " << full.searches
+         << " searches; pursuit: " << incremental.expansions << " expansions, "
+         << incremental.searches << " searches");
+    CHECK(incremental.expansions * 10 <= full.expansions);
+    CHECK(incremental.searches * 10 <= full.searches);
+    // ...and the chase is just as close
+    CHECK(incremental.mean_gap <= full.mean_gap + 2.0f);
+}
+
+TEST_CASE("200-chaser pursuit benchmark", "[.benchmark][map][pathfinder]") {
+    BENCHMARK("full A*") { return run_chase(false, 200, 300).expansions; };
+    BENCHMARK("pursuit") { return run_chase(true, 200, 300).expansions; };
+}
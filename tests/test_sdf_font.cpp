@@ -0,0 +1,245 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "renderer/sdf_font.hpp"
+
+#include "stb/stb_truetype.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace osc;
+using namespace osc::renderer;
+
+namespace {
+
+constexpr i32 SIZES[] = {8, 10, 12, 14, 16, 18, 20, 24, 32, 48};
+
+std::vector<u8> read_file(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return {};
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+/// A TrueType font to test with: $OSC_TEST_FONT, FA's Arial under
+/// $FA_PATH, or a common system font. Empty if none is installed.
+std::vector<u8> find_font() {
+    std::vector<fs::path> candidates;
+    if (const char* font = std::getenv("OSC_TEST_FONT")) candidates.emplace_back(font);
+    if (const char* fa = std::getenv("FA_PATH")) {
+        candidates.push_back(fs::path(fa) / "fonts" / "ARIAL.TTF");
+        candidates.push_back(fs::path(fa) / "fonts" / "arial.ttf");
+    }
+    for (const char* p : {"C:/Windows/Fonts/arial.ttf",
+                          "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+                          "/usr/share/fonts/TTF/DejaVuSans.ttf",
+                          "/usr/share/fonts/dejavu/DejaVuSans.ttf",
+                          "/Library/Fonts/Arial.ttf",
+                          "/System/Library/Fonts/Supplemental/Arial.ttf"})
+        candidates.emplace_back(p);
+    for (const auto& path : candidates) {
+        auto data = read_file(path);
+        if (!data.empty()) return data;
+    }
+    return {};
+}
+
+fs::path fresh_dir(const char* name) {
+    auto dir = fs::temp_directory_path() / name;
+    fs::remove_all(dir);
+    return dir;
+}
+
+} // namespace
+
+TEST_CASE("SDF glyphs match the stb rasterizer at every size", "[renderer][font]") {
+    const auto ttf = find_font();
+    if (ttf.empty()) {
+        WARN("no TrueType font found (set OSC_TEST_FONT)");
+        return;
+    }
+    SdfFont sdf;
+    REQUIRE(sdf.build(ttf.data(), ttf.size()));
+    REQUIRE(sdf.width() == SdfFont::ATLAS_WIDTH);
+
+    stbtt_fontinfo font;
+    REQUIRE(stbtt_InitFont(&font, ttf.data(), stbtt_GetFontOffsetForIndex(ttf.data(), 0)));
+    int ascent, descent, line_gap;
+    stbtt_GetFontVMetrics(&font, &ascent, &descent, &line_gap);
+
+    std::vector<GlyphInfo> glyphs;
+    for (i32 size : SIZES) {
+        // What FontCache used to rasterize for this size
+        const f32 scale = stbtt_ScaleForPixelHeight(&font, static_cast<f32>(size));
+        const FontMetrics m = sdf.metrics(static_cast<f32>(size));
+        CHECK(m.ascent == ascent * scale);
+        CHECK(m.descent == -descent * scale);
+        CHECK(m.line_gap == line_gap * scale);
+
+        sdf.glyphs_at(static_cast<f32>(size), glyphs);
+        // The quad keeps this much of the padding around the outline
+        const f32 margin = std::min(SdfFont::PADDING * size / SdfFont::BASE_SIZE, 1.0f);
+        u32 missing = 0, advances = 0, boxes = 0;
+        for (u32 cp = SdfFont::FIRST_CHAR; cp <= SdfFont::LAST_CHAR; cp++) {
+            const u16 slot = sdf.index()[cp];
+            if (!slot) {
+                ++missing;
+                continue;
+            }
+            const GlyphInfo& gi = glyphs[slot - 1];
+
+            int advance_raw, lsb;
+            stbtt_GetCodepointHMetrics(&font, static_cast<int>(cp), &advance_raw, &lsb);
+            if (gi.x_advance != advance_raw * scale) ++advances;
+
+            int x0, y0, x1, y1;
+            stbtt_GetCodepointBitmapBox(&font, static_cast<int>(cp), scale, scale,
+                                        &x0, &y0, &x1, &y1);
+            if (x1 <= x0 || y1 <= y0) {
+                // Nothing to draw (space): advance only
+                if (gi.width != 0 || gi.height != 0) ++boxes;
+                continue;
+            }
+            // Ink box of the scaled field within a pixel of stb's bitmap box
+            const f32 ix0 = gi.x_offset + margin;
+            const f32 iy0 = gi.y_offset + margin;
+            const f32 ix1 = gi.x_offset + gi.width - margin;
+            const f32 iy1 = gi.y_offset + gi.height - margin;
+            if (std::abs(ix0 - x0) > 1.001f || std::abs(iy0 - y0) > 1.001f ||
+                std::abs(ix1 - x1) > 1.001f || std::abs(iy1 - y1) > 1.001f)
+                ++boxes;
+        }
+        CHECK(missing == 0);
+        CHECK(advances == 0);
+        CHECK(boxes == 0);
+    }
+
+    // Every SDF glyph crosses the outline inside its bitmap and fades to
+    // "outside" at its border
+    u32 bad_fields = 0;
+    for (const auto& g : sdf.glyphs()) {
+        if (g.w == 0) continue;
+        u8 inside = 0, border = 0;
+        for (u32 y = 0; y < g.h; y++) {
+            for (u32 x = 0; x < g.w; x++) {
+                u8 v = sdf.pixels()[static_cast<size_t>(g.y + y) * sdf.width() + g.x + x];
+                inside = std::max(inside, v);
+                if (x == 0 || y == 0 || x + 1 == g.w || y + 1 == g.h)
+                    border = std::max(border, v);
+            }
+        }
+        if (inside < SdfFont::ON_EDGE || border >= SdfFont::ON_EDGE) ++bad_fields;
+    }
+    CHECK(bad_fields == 0);
+
+    // SDF UVs are tagged for ui.frag and stay inside the atlas
+    sdf.glyphs_at(16.0f, glyphs);
+    const GlyphInfo& a = glyphs[sdf.index()['A'] - 1];
+    CHECK(a.u0 < -32.0f);
+    CHECK(a.u0 - SDF_UV_OFFSET >= 0.0f);
+    CHECK(a.u1 - SDF_UV_OFFSET <= 1.0f);
+    CHECK(a.v1 <= 1.0f);
+
+    // Flat BMP lookup: outside the atlas's range finds nothing
+    CHECK(sdf.index().size() == SdfFont::BMP_SIZE);
+    CHECK(sdf.index()[31] == 0);
+    CHECK(sdf.index()[0x4E2D] == 0);
+}
+
+TEST_CASE("SDF atlas file round-trips and rejects other fonts", "[renderer][font]") {
+    const auto ttf = find_font();
+    if (ttf.empty()) {
+        WARN("no TrueType font found (set OSC_TEST_FONT)");
+        return;
+    }
+    SdfFont built;
+    REQUIRE(built.build(ttf.data(), ttf.size()));
+    CHECK(built.font_hash() == SdfFont::hash(ttf.data(), ttf.size()));
+
+    const fs::path dir = fresh_dir("osc_sdf_font_test");
+    const fs::path path = dir / "font.sdf";
+    REQUIRE(built.save(path));
+    CHECK_FALSE(fs::exists(dir / "font.sdf.tmp"));
+
+    SdfFont loaded;
+    REQUIRE(loaded.load(path, built.font_hash()));
+    CHECK(loaded.width() == built.width());
+    CHECK(loaded.height() == built.height());
+    CHECK(loaded.pixels() == built.pixels());
+    CHECK(loaded.index() == built.index());
+    REQUIRE(loaded.glyphs().size() == built.glyphs().size());
+    CHECK(std::memcmp(loaded.glyphs().data(), built.glyphs().data(),
+                      built.glyphs().size() * sizeof(SdfFont::Glyph)) == 0);
+
+    std::vector<GlyphInfo> a, b;
+    built.glyphs_at(13.0f, a);
+    loaded.glyphs_at(13.0f, b);
+    REQUIRE(a.size() == b.size());
+    CHECK(std::memcmp(a.data(), b.data(), a.size() * sizeof(GlyphInfo)) == 0);
+
+    // Changed font data, truncated or missing files are rejected
+    SdfFont other;
+    CHECK_FALSE(other.load(path, built.font_hash() + 1));
+    CHECK_FALSE(other.load(dir / "missing.sdf", built.font_hash()));
+    fs::resize_file(path, fs::file_size(path) / 2);
+    CHECK_FALSE(other.load(path, built.font_hash()));
+    CHECK(other.empty());
+
+    // Not a font at all
+    const u8 junk[16] = {};
+    CHECK_FALSE(other.build(junk, sizeof(junk)));
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("Font atlas startup benchmark", "[.benchmark][renderer][font]") {
+    const auto ttf = find_font();
+    if (ttf.empty()) return;
+
+    stbtt_fontinfo font;
+    stbtt_InitFont(&font, ttf.data(), stbtt_GetFontOffsetForIndex(ttf.data(), 0));
+    const fs::path dir = fresh_dir("osc_sdf_font_bench");
+    SdfFont sdf;
+    sdf.build(ttf.data(), ttf.size());
+    sdf.save(dir / "font.sdf");
+    std::vector<GlyphInfo> glyphs;
+
+    // The per-size path this replaces: one coverage atlas per size
+    BENCHMARK("stb coverage glyphs, 10 sizes") {
+        u64 pixels = 0;
+        for (i32 size : SIZES) {
+            const f32 scale = stbtt_ScaleForPixelHeight(&font, static_cast<f32>(size));
+            for (u32 cp = SdfFont::FIRST_CHAR; cp <= SdfFont::LAST_CHAR; cp++) {
+                int w, h, xoff, yoff;
+                unsigned char* bmp = stbtt_GetCodepointBitmap(
+                    &font, 0, scale, static_cast<int>(cp), &w, &h, &xoff, &yoff);
+                pixels += static_cast<u64>(w) * h;
+                stbtt_FreeBitmap(bmp, nullptr);
+            }
+        }
+        return pixels;
+    };
+    BENCHMARK("SDF atlas build (first launch)") {
+        SdfFont fresh;
+        return fresh.build(ttf.data(), ttf.size());
+    };
+    BENCHMARK("SDF atlas load (later launches)") {
+        SdfFont cached;
+        return cached.load(dir / "font.sdf", SdfFont::hash(ttf.data(), ttf.size()));
+    };
+    BENCHMARK("SDF glyph tables, 10 sizes") {
+        size_t n = 0;
+        for (i32 size : SIZES) {
+            sdf.glyphs_at(static_cast<f32>(size), glyphs);
+            n += glyphs.size();
+        }
+        return n;
+    };
+
+    fs::remove_all(dir);
+}
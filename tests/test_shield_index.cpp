@@ -0,0 +1,318 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "sim/entity_registry.hpp"
+#include "sim/projectile.hpp"
+#include "sim/shield.hpp"
+#include "sim/shield_index.hpp"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace osc;
+using namespace osc::sim;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+class TestUnit : public Entity {
+public:
+    bool is_unit() const override { return true; }
+};
+
+u32 spawn_shield(EntityRegistry& reg, ShieldIndex& index, Vector3 c, f32 r,
+                 i32 army, u32 owner = 0) {
+    auto s = std::make_unique<Shield>();
+    s->set_position(c);
+    s->set_army(army);
+    s->size = r;
+    s->shield_type = "Bubble";
+    s->is_on = true;
+    s->owner_id = owner;
+    s->set_max_health(1000);
+    s->set_health(1000);
+    u32 id = reg.register_entity(std::move(s));
+    index.track(id);
+    return id;
+}
+
+Shield& shield(EntityRegistry& reg, u32 id) {
+    return static_cast<Shield&>(*reg.find(id));
+}
+
+/// Reference answer: every shield tested, scalar, same rules.
+u32 brute_intercept(const EntityRegistry& reg, const std::vector<u32>& ids,
+                    const ShieldIndex& index, const Vector3& p0,
+                    const Vector3& p1, i32 army) {
+    u32 best_id = 0;
+    f32 best_t = 2;
+    for (u32 id : ids) {
+        const auto& s = static_cast<const Shield&>(*reg.find(id));
+        if (!s.is_on) continue;
+        if (s.army() >= 0 && (index.friendly_mask(army) >> s.army()) & 1u) continue;
+        const Vector3& c = s.position();
+        f32 dx = p1.x - p0.x, dy = p1.y - p0.y, dz = p1.z - p0.z;
+        f32 mx = c.x - p0.x, my = c.y - p0.y, mz = c.z - p0.z;
+        f32 a = dx * dx + dy * dy + dz * dz;
+        f32 b = mx * dx + my * dy + mz * dz;
+        f32 cc = mx * mx + my * my + mz * mz - s.size * s.size;
+        f32 disc = b * b - a * cc;
+        if (cc <= 0 || disc < 0) continue;
+        f32 t = (b - std::sqrt(disc)) * (1.0f / a);
+        if (t < 0 || t > 1) continue;
+        if (t < best_t || (t == best_t && id < best_id)) { best_t = t; best_id = id; }
+    }
+    return best_id;
+}
+
+/// 100 heavily overlapping bubbles on a 10x10 lattice (spacing 15,
+/// radius 20); every 7th belongs to the shells' own army.
+struct ShieldField {
+    static constexpr f32 CENTER = 500.0f;
+    static constexpr f32 SPACING = 15.0f;
+    static constexpr f32 RADIUS = 20.0f;
+
+    EntityRegistry registry;
+    ShieldIndex index;
+    std::vector<u32> ids;
+    std::vector<Vector3> enemy_centers;
+
+    ShieldField() {
+        for (u32 i = 0; i < 100; ++i) {
+            Vector3 c{CENTER + SPACING * (static_cast<f32>(i % 10) - 4.5f), 0,
+                      CENTER + SPACING * (static_cast<f32>(i / 10) - 4.5f)};
+            i32 army = i % 7 == 0 ? 0 : 1;
+            ids.push_back(spawn_shield(registry, index, c, RADIUS, army));
+            if (army == 1) enemy_centers.push_back(c);
+        }
+        index.refresh(registry);
+    }
+};
+
+/// Artillery shells fired from a 400-unit ring, each landing just off
+/// the centre of an enemy bubble after a 4-5 second arc.
+struct Barrage {
+    static constexpr f32 GRAVITY = -4.9f;
+    static constexpr f32 DT = 0.1f;
+
+    std::vector<Vector3> pos, vel;
+    std::vector<u8> live;
+
+    Barrage(u32 n, const std::vector<Vector3>& targets) {
+        for (u32 i = 0; i < n; ++i) {
+            f32 angle = 6.2831853f * static_cast<f32>(i) / static_cast<f32>(n);
+            Vector3 from{ShieldField::CENTER + 400.0f * std::cos(angle), 0,
+                         ShieldField::CENTER + 400.0f * std::sin(angle)};
+            const Vector3& c = targets[i % targets.size()];
+            Vector3 to{c.x + 0.3f * ShieldField::RADIUS * std::sin(1.7f * i), 0,
+                       c.z + 0.3f * ShieldField::RADIUS * std::cos(2.3f * i)};
+            f32 flight = 4.0f + static_cast<f32>(i % 10) * 0.1f;
+            pos.push_back(from);
+            vel.push_back({(to.x - from.x) / flight, -0.5f * GRAVITY * flight,
+                           (to.z - from.z) / flight});
+            live.push_back(1);
+        }
+    }
+
+    /// Advance one tick like Projectile::update: gravity, then move.
+    /// `on_segment(i, from, to)` returns true when shell i was stopped.
+    template <typename F>
+    u32 tick(F&& on_segment) {
+        u32 active = 0;
+        for (size_t i = 0; i < pos.size(); ++i) {
+            if (!live[i]) continue;
+            vel[i].y += GRAVITY * DT;
+            Vector3 next{pos[i].x + vel[i].x * DT, pos[i].y + vel[i].y * DT,
+                         pos[i].z + vel[i].z * DT};
+            if (on_segment(i, pos[i], next) || next.y < 0) live[i] = 0;
+            else ++active;
+            pos[i] = next;
+        }
+        return active;
+    }
+};
+
+} // namespace
+
+TEST_CASE("Shield index follows shield state", "[sim][shield_index]") {
+    EntityRegistry reg;
+    ShieldIndex index;
+    auto owner = std::make_unique<TestUnit>();
+    owner->set_position({100, 0, 100});
+    u32 owner_id = reg.register_entity(std::move(owner));
+    u32 a = spawn_shield(reg, index, {0, 0, 0}, 10, 1, owner_id);
+    u32 b = spawn_shield(reg, index, {300, 0, 300}, 10, 1);
+    index.refresh(reg);
+    CHECK(index.size() == 2);
+
+    // Bubbles are centred on their owner
+    ShieldHit hit;
+    REQUIRE(index.intercept({80, 5, 100}, {100, 5, 100}, 0, hit));
+    CHECK(hit.shield_id == a);
+    CHECK(hit.owner_id == owner_id);
+    CHECK_THAT(hit.point.x, WithinAbs(100 - std::sqrt(75.0f), 1e-3));
+
+    // Moving the owner moves the bubble; a quiet tick does not rebuild
+    u32 rebuilds = index.stats().grid_rebuilds;
+    index.refresh(reg);
+    CHECK(index.stats().grid_rebuilds == rebuilds);
+    reg.find(owner_id)->set_position({150, 0, 100});
+    index.refresh(reg);
+    CHECK(index.stats().grid_rebuilds == rebuilds + 1);
+    CHECK_FALSE(index.intercept({80, 5, 100}, {100, 5, 100}, 0, hit));
+    CHECK(index.intercept({130, 5, 100}, {150, 5, 100}, 0, hit));
+
+    // Off, depleted, personal and removed shields drop out
+    shield(reg, a).is_on = false;
+    index.refresh(reg);
+    CHECK(index.size() == 1);
+    shield(reg, a).is_on = true;
+    shield(reg, a).set_health(0);
+    shield(reg, b).shield_type = "Personal";
+    index.refresh(reg);
+    CHECK(index.size() == 0);
+    shield(reg, b).shield_type = "Bubble";
+    index.refresh(reg);
+    CHECK(index.size() == 1);
+    reg.unregister_entity(b);
+    index.refresh(reg);
+    CHECK(index.size() == 0);
+    CHECK(index.tracked() == 1);
+}
+
+TEST_CASE("Shield interception rules", "[sim][shield_index]") {
+    EntityRegistry reg;
+    ShieldIndex index;
+    u32 first = spawn_shield(reg, index, {0, 0, 0}, 10, 1);
+    u32 twin = spawn_shield(reg, index, {0, 0, 0}, 10, 2);
+    u32 inner = spawn_shield(reg, index, {0, 0, 0}, 5, 3);
+    index.refresh(reg);
+
+    // Identical bubbles: the lower entity id takes the hit
+    ShieldHit hit;
+    REQUIRE(index.intercept({-20, 1, 0}, {0, 1, 0}, 0, hit));
+    CHECK(hit.shield_id == first);
+
+    // Allied shields are passed; the next bubble in line takes it
+    index.set_friendly_mask(0, 1u << 1);
+    REQUIRE(index.intercept({-20, 1, 0}, {0, 1, 0}, 0, hit));
+    CHECK(hit.shield_id == twin);
+    index.set_friendly_mask(0, (1u << 1) | (1u << 2));
+    REQUIRE(index.intercept({-20, 1, 0}, {0, 1, 0}, 0, hit));
+    CHECK(hit.shield_id == inner);
+
+    // Segments starting inside a bubble fly out of it
+    CHECK_FALSE(index.intercept({-2, 1, 0}, {-30, 1, 0}, 0, hit));
+    // ... and a segment that stops short does not reach it
+    CHECK_FALSE(index.intercept({-30, 1, 0}, {-11, 1, 0}, 0, hit));
+    // A shell's own army never blocks it
+    index.set_friendly_mask(3, (1u << 1) | (1u << 2));
+    CHECK_FALSE(index.intercept({-20, 1, 0}, {0, 1, 0}, 3, hit));
+}
+
+TEST_CASE("Projectiles stop at enemy shields", "[sim][shield_index]") {
+    EntityRegistry reg;
+    ShieldIndex index;
+    u32 sid = spawn_shield(reg, index, {50, 0, 0}, 10, 1);
+    index.refresh(reg);
+
+    auto fire = [&](i32 army) {
+        auto p = std::make_unique<Projectile>();
+        p->set_position({0, 2, 0});
+        p->set_army(army);
+        p->velocity = {20, 0, 0};
+        p->target_position = {50, 0, 0};
+        return reg.register_entity(std::move(p));
+    };
+
+    // Enemy shell: destroyed at the bubble surface, 20 units short
+    u32 enemy = fire(0);
+    u32 ticks = 0;
+    while (reg.find(enemy) && ticks < 100) {
+        auto* p = static_cast<Projectile*>(reg.find(enemy));
+        p->update(0.1, reg, nullptr, nullptr, &index);
+        ++ticks;
+    }
+    CHECK(ticks == 21); // 40 units to the surface at 2 per tick
+    CHECK(index.stats().hits == 1);
+
+    // Own-army shell flies through to its ground target
+    u32 own = fire(1);
+    ticks = 0;
+    while (reg.find(own) && ticks < 100) {
+        static_cast<Projectile*>(reg.find(own))->update(0.1, reg, nullptr,
+                                                         nullptr, &index);
+        ++ticks;
+    }
+    CHECK(ticks > 21);
+    CHECK(index.stats().hits == 1);
+    CHECK(reg.find(sid));
+}
+
+TEST_CASE("5000 shells into 100 overlapping shields", "[sim][shield_index]") {
+    ShieldField field;
+    REQUIRE(field.index.size() == 100);
+    Barrage barrage(5000, field.enemy_centers);
+
+    u32 hits = 0, mismatches = 0;
+    std::vector<u32> per_shield(field.ids.back() + 1, 0);
+    for (u32 t = 0; t < 100; ++t) {
+        u32 active = barrage.tick([&](size_t, const Vector3& from, const Vector3& to) {
+            ShieldHit hit;
+            bool found = field.index.intercept(from, to, 0, hit);
+            u32 expect = brute_intercept(field.registry, field.ids, field.index,
+                                         from, to, 0);
+            if ((found ? hit.shield_id : 0) != expect) ++mismatches;
+            if (!found) return false;
+            ++hits;
+            ++per_shield[hit.shield_id];
+            return true;
+        });
+        if (active == 0) break;
+    }
+
+    // Every shell lands inside an enemy bubble, so every shell is caught
+    CHECK(mismatches == 0);
+    CHECK(hits == 5000);
+    CHECK(field.index.stats().hits == 5000);
+    for (size_t k = 0; k < field.ids.size(); ++k) {
+        if (k % 7 == 0) CHECK(per_shield[field.ids[k]] == 0);
+    }
+    // The grid keeps the kernel to a handful of spheres per segment
+    CHECK(field.index.stats().candidates < 100 * field.index.stats().queries / 2);
+}
+
+TEST_CASE("Shield interception benchmark", "[.benchmark][sim][shield_index]") {
+    ShieldField field;
+    Barrage barrage(5000, field.enemy_centers);
+    // Fly the barrage 3 s in, above the bubbles, and time one tick of
+    // segment tests for every shell.
+    for (u32 t = 0; t < 30; ++t) barrage.tick([](size_t, const Vector3&, const Vector3&) { return false; });
+
+    BENCHMARK("5000 shells x 100 shields, one tick") {
+        u32 hits = 0;
+        for (size_t i = 0; i < barrage.pos.size(); ++i) {
+            const Vector3& p = barrage.pos[i];
+            const Vector3& v = barrage.vel[i];
+            Vector3 next{p.x + v.x * Barrage::DT, p.y + v.y * Barrage::DT,
+                         p.z + v.z * Barrage::DT};
+            ShieldHit hit;
+            hits += field.index.intercept(p, next, 0, hit);
+        }
+        return hits;
+    };
+    BENCHMARK("5000 shells x 100 shields, brute force") {
+        u32 hits = 0;
+        for (size_t i = 0; i < barrage.pos.size(); ++i) {
+            const Vector3& p = barrage.pos[i];
+            const Vector3& v = barrage.vel[i];
+            Vector3 next{p.x + v.x * Barrage::DT, p.y + v.y * Barrage::DT,
+                         p.z + v.z * Barrage::DT};
+            hits += brute_intercept(field.registry, field.ids, field.index, p,
+                                    next, 0) != 0;
+        }
+        return hits;
+    };
+}
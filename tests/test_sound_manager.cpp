@@ -0,0 +1,316 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "audio/pcm_cache.hpp"
+#include "audio/sound_manager.hpp"
+#include "audio/xwb_parser.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+using namespace osc;
+using namespace osc::audio;
+
+namespace {
+
+void put_u16(std::vector<u8>& buf, size_t at, u16 v) {
+    buf[at] = static_cast<u8>(v);
+    buf[at + 1] = static_cast<u8>(v >> 8);
+}
+
+void put_u32(std::vector<u8>& buf, size_t at, u32 v) {
+    for (int i = 0; i < 4; i++) buf[at + i] = static_cast<u8>(v >> (8 * i));
+}
+
+/// Write a minimal XACT3 bank pair: `tracks` 16-bit mono PCM sine waves
+/// of `seconds` each, and one simple cue "Cue_<n>" per track.
+void write_test_bank(const fs::path& dir, const std::string& name,
+                     u32 tracks, f32 seconds) {
+    constexpr u32 RATE = 22050;
+    u32 frames = static_cast<u32>(RATE * seconds);
+    u32 wave_bytes = frames * 2;
+
+    // ---- .xwb: header, BANKDATA, 24-byte entry metadata, wave data ----
+    u32 meta_off = 52 + 96;
+    u32 data_off = meta_off + 24 * tracks;
+    std::vector<u8> xwb(data_off + wave_bytes * tracks, 0);
+    std::memcpy(xwb.data(), "WBND", 4);
+    put_u32(xwb, 4, 46);                     // version
+    put_u32(xwb, 12, 52);                    // BANKDATA
+    put_u32(xwb, 16, 96);
+    put_u32(xwb, 20, meta_off);              // ENTRYMETADATA
+    put_u32(xwb, 24, 24 * tracks);
+    put_u32(xwb, 44, data_off);              // ENTRYWAVEDATA
+    put_u32(xwb, 48, wave_bytes * tracks);
+    put_u32(xwb, 52 + 4, tracks);
+    std::memcpy(xwb.data() + 52 + 8, name.data(), name.size());
+    put_u32(xwb, 52 + 72, 24);               // entry metadata size
+    u32 format = (1u << 2) | (RATE << 5) | (1u << 31); // PCM mono 16-bit
+    for (u32 t = 0; t < tracks; t++) {
+        size_t e = meta_off + 24 * t;
+        put_u32(xwb, e, frames << 4);
+        put_u32(xwb, e + 4, format);
+        put_u32(xwb, e + 8, wave_bytes * t);
+        put_u32(xwb, e + 12, wave_bytes);
+        for (u32 i = 0; i < frames; i++) {
+            f32 v = std::sin(static_cast<f32>(i) * 0.05f * (t + 1)) * 8000.0f;
+            put_u16(xwb, data_off + wave_bytes * t + i * 2,
+                    static_cast<u16>(static_cast<i16>(v)));
+        }
+    }
+
+    // ---- .xsb: header, wave bank name, cue names, sounds, simple cues ----
+    std::string names;
+    for (u32 t = 0; t < tracks; t++) {
+        names += "Cue_" + std::to_string(t);
+        names.push_back('\0');
+    }
+    u32 wb_names_off = 0x4A + 64;
+    u32 cue_names_off = wb_names_off + 64;
+    u32 sounds_off = cue_names_off + static_cast<u32>(names.size());
+    u32 cues_off = sounds_off + 12 * tracks;
+    std::vector<u8> xsb(cues_off + 4 * tracks, 0);
+    std::memcpy(xsb.data(), "SDBK", 4);
+    put_u16(xsb, 0x04, 46);                  // tool version
+    put_u16(xsb, 0x13, static_cast<u16>(tracks)); // simple cues
+    put_u16(xsb, 0x19, static_cast<u16>(tracks)); // total cues
+    xsb[0x1B] = 1;                           // wave bank count
+    put_u32(xsb, 0x22, cues_off);
+    put_u32(xsb, 0x26, 0xFFFFFFFF);          // no complex cues
+    put_u32(xsb, 0x2A, cue_names_off);
+    put_u32(xsb, 0x3A, wb_names_off);
+    std::memcpy(xsb.data() + wb_names_off, name.data(), name.size());
+    std::memcpy(xsb.data() + cue_names_off, names.data(), names.size());
+    for (u32 t = 0; t < tracks; t++) {
+        put_u16(xsb, sounds_off + 12 * t + 9, static_cast<u16>(t));
+        size_t c = cues_off + 4 * t;
+        put_u32(xsb, c, (sounds_off + 12 * t) << 8);
+        xsb[c] = 0x04;                       // cue has a sound
+    }
+
+    fs::create_directories(dir);
+    std::ofstream(dir / (name + ".xwb"), std::ios::binary)
+        .write(reinterpret_cast<const char*>(xwb.data()),
+               static_cast<std::streamsize>(xwb.size()));
+    std::ofstream(dir / (name + ".xsb"), std::ios::binary)
+        .write(reinterpret_cast<const char*>(xsb.data()),
+               static_cast<std::streamsize>(xsb.size()));
+}
+
+/// Emitter positions far enough apart that plays never coalesce.
+sim::Vector3 spread(u32 i) {
+    return {static_cast<f32>(i) * 3.0f * SoundManager::COALESCE_RADIUS, 0, 0};
+}
+
+std::shared_ptr<DecodedWave> make_wave(size_t samples) {
+    auto w = std::make_shared<DecodedWave>();
+    w->samples.resize(samples);
+    w->frames = samples;
+    return w;
+}
+
+} // namespace
+
+TEST_CASE("PcmCache evicts least recently used waves", "[audio]") {
+    PcmCache cache(3 * 1024 * sizeof(f32));
+    cache.insert("a", make_wave(1024));
+    cache.insert("b", make_wave(1024));
+    cache.insert("c", make_wave(1024));
+    REQUIRE(cache.size() == 3);
+
+    // Touch "a" so "b" becomes the eviction candidate
+    REQUIRE(cache.find("a"));
+    cache.insert("d", make_wave(1024));
+    CHECK(cache.size() == 3);
+    CHECK(cache.find("a"));
+    CHECK_FALSE(cache.find("b"));
+    CHECK(cache.bytes() <= cache.budget());
+
+    // A held wave survives eviction from the cache
+    auto held = cache.find("c");
+    cache.set_budget(0);
+    CHECK(cache.size() == 0);
+    CHECK(cache.bytes() == 0);
+    CHECK(held->frames == 1024);
+
+    // Oversized waves are not cached
+    cache.set_budget(16);
+    cache.insert("big", make_wave(1024));
+    CHECK(cache.size() == 0);
+}
+
+TEST_CASE("XwbParser serves concurrent reads of one bank", "[audio]") {
+    constexpr u32 TRACKS = 6;
+    auto dir = fs::temp_directory_path() / "osc_test_sounds_xwb_threads";
+    write_test_bank(dir, "TestBank", TRACKS, 0.25f);
+
+    XwbParser xwb;
+    REQUIRE(xwb.parse(dir / "TestBank.xwb").ok());
+    std::vector<std::vector<u8>> expected;
+    for (u32 t = 0; t < TRACKS; t++) {
+        expected.push_back(xwb.read_wave_data(t));
+        REQUIRE_FALSE(expected.back().empty());
+    }
+
+    // Each reader walks the tracks in its own order, so seeks interleave
+    std::vector<u32> mismatches(4, 0);
+    std::vector<std::thread> readers;
+    for (u32 r = 0; r < mismatches.size(); r++) {
+        readers.emplace_back([&, r] {
+            for (u32 i = 0; i < 200; i++) {
+                u32 t = (i * (r + 1) + r) % TRACKS;
+                if (xwb.read_wave_data(t) != expected[t]) mismatches[r]++;
+            }
+        });
+    }
+    for (auto& th : readers) th.join();
+    for (u32 m : mismatches) CHECK(m == 0);
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("SoundManager decodes once and bounds voices per cue", "[audio]") {
+    auto dir = fs::temp_directory_path() / "osc_test_sounds_cache";
+    write_test_bank(dir, "TestBank", 2, 2.0f);
+
+    SoundManager mgr(dir, true);
+    if (mgr.is_headless()) {
+        WARN("null audio backend unavailable; skipping playback checks");
+        fs::remove_all(dir);
+        return;
+    }
+
+    for (u32 i = 0; i < 50; i++) {
+        auto pos = spread(i);
+        CHECK(mgr.play("TestBank", "Cue_0", &pos) != INVALID_SOUND);
+    }
+    CHECK(mgr.stats().decodes == 1);
+    CHECK(mgr.stats().cache_hits == 49);
+    CHECK(mgr.active_voice_count() == SoundManager::MAX_VOICES_PER_CUE);
+    CHECK(mgr.stats().voices_stolen == 50 - SoundManager::MAX_VOICES_PER_CUE);
+
+    sim::Vector3 pos{10.0f, 0.0f, 10.0f};
+    CHECK(mgr.play("TestBank", "Cue_1", &pos) != INVALID_SOUND);
+    CHECK(mgr.stats().decodes == 2);
+    CHECK(mgr.pcm_cache().size() == 2);
+
+    // Unknown cues never touch the pool
+    CHECK(mgr.play("TestBank", "Missing", &pos) == INVALID_SOUND);
+    CHECK(mgr.active_voice_count() == SoundManager::MAX_VOICES_PER_CUE + 1);
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("SoundManager steals voices by priority", "[audio]") {
+    constexpr u32 CUES = SoundManager::MAX_VOICES / 4 + 2;
+    auto dir = fs::temp_directory_path() / "osc_test_sounds_pool";
+    write_test_bank(dir, "PoolBank", CUES, 2.0f);
+
+    SoundManager mgr(dir, true);
+    if (mgr.is_headless()) {
+        WARN("null audio backend unavailable; skipping playback checks");
+        fs::remove_all(dir);
+        return;
+    }
+
+    // Fill the pool with positional one-shots, four per cue
+    sim::Vector3 pos{0.0f, 0.0f, 0.0f};
+    for (u32 i = 0; i < SoundManager::MAX_VOICES; i++) {
+        auto at = spread(i % 4);
+        mgr.play("PoolBank", "Cue_" + std::to_string(i / 4), &at);
+    }
+    REQUIRE(mgr.active_voice_count() == SoundManager::MAX_VOICES);
+    REQUIRE(mgr.stats().voices_stolen == 0);
+
+    // Loops and interface sounds outrank positional one-shots
+    std::string spare = "Cue_" + std::to_string(CUES - 1);
+    auto loop = mgr.play_loop("PoolBank", spare, &pos);
+    CHECK(loop != INVALID_SOUND);
+    CHECK(mgr.play("PoolBank", spare) != INVALID_SOUND);
+    CHECK(mgr.active_voice_count() == SoundManager::MAX_VOICES);
+    CHECK(mgr.stats().voices_stolen == 2);
+
+    // Stopping a loop returns its voice to the pool
+    mgr.stop(loop);
+    CHECK(mgr.active_voice_count() == SoundManager::MAX_VOICES - 1);
+    mgr.gc(); // everything else is still playing
+    CHECK(mgr.active_voice_count() == SoundManager::MAX_VOICES - 1);
+
+    // A pool full of loops rejects new one-shots instead of cutting loops
+    for (SoundHandle h = 1; h < 2 * SoundManager::MAX_VOICES; h++) {
+        mgr.stop(h);
+    }
+    REQUIRE(mgr.active_voice_count() == 0);
+    for (u32 i = 0; i < SoundManager::MAX_VOICES; i++) {
+        mgr.play_loop("PoolBank", "Cue_" + std::to_string(i % CUES), &pos);
+    }
+    REQUIRE(mgr.active_voice_count() == SoundManager::MAX_VOICES);
+    auto far = spread(7);
+    CHECK(mgr.play("PoolBank", "Cue_0", &far) == INVALID_SOUND);
+    CHECK(mgr.stats().rejected == 1);
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("SoundManager culls and coalesces positional one-shots", "[audio]") {
+    auto dir = fs::temp_directory_path() / "osc_test_sounds_spatial";
+    write_test_bank(dir, "SpatialBank", 2, 2.0f);
+
+    SoundManager mgr(dir, true);
+    if (mgr.is_headless()) {
+        WARN("null audio backend unavailable; skipping playback checks");
+        fs::remove_all(dir);
+        return;
+    }
+
+    // Out of earshot: dropped before the bank is even loaded
+    mgr.set_listener_position({1000.0f, 0.0f, 1000.0f});
+    sim::Vector3 far{1000.0f + SoundManager::MAX_DISTANCE + 1.0f, 0, 1000.0f};
+    CHECK(mgr.play("SpatialBank", "Cue_0", &far) == INVALID_SOUND);
+    CHECK(mgr.stats().culled == 1);
+    CHECK(mgr.stats().decodes == 0);
+
+    // Loops and interface sounds are never culled
+    auto loop = mgr.play_loop("SpatialBank", "Cue_1", &far);
+    CHECK(loop != INVALID_SOUND);
+    CHECK(mgr.play("SpatialBank", "Cue_1") != INVALID_SOUND);
+    CHECK(mgr.active_voice_count() == 2);
+
+    // A volley in one place folds into a single voice...
+    sim::Vector3 near{1010.0f, 0.0f, 1000.0f};
+    auto first = mgr.play("SpatialBank", "Cue_0", &near);
+    REQUIRE(first != INVALID_SOUND);
+    for (int i = 0; i < 9; i++) {
+        sim::Vector3 p{near.x + 0.5f * i, 0.0f, near.z};
+        CHECK(mgr.play("SpatialBank", "Cue_0", &p) == first);
+    }
+    CHECK(mgr.stats().coalesced == 9);
+    CHECK(mgr.active_voice_count() == 3);
+
+    // ...but not once the window has passed or outside the radius
+    sim::Vector3 aside{near.x, 0.0f,
+                       near.z + 2.0f * SoundManager::COALESCE_RADIUS};
+    CHECK(mgr.play("SpatialBank", "Cue_0", &aside) != first);
+    mgr.update(2.0 * SoundManager::COALESCE_WINDOW);
+    CHECK(mgr.play("SpatialBank", "Cue_0", &near) != first);
+    CHECK(mgr.stats().coalesced == 9);
+    CHECK(mgr.active_voice_count() == 5);
+
+    // Moving the listener away silences but keeps playing voices
+    mgr.set_listener_position({0.0f, 0.0f, 0.0f}, 1.0f);
+    mgr.update(0.016);
+    CHECK(mgr.active_voice_count() == 5);
+    mgr.stop(loop);
+    CHECK(mgr.active_voice_count() == 4);
+
+    // Zoomed out, the culled emitter is on screen: it plays, quietly
+    mgr.set_listener_position({1000.0f, 0.0f, 1000.0f}, 0.0f,
+                              3.0f * SoundManager::MAX_DISTANCE);
+    CHECK(mgr.hearing_range() == 3.0f * SoundManager::MAX_DISTANCE);
+    CHECK(mgr.play("SpatialBank", "Cue_0", &far) != INVALID_SOUND);
+    CHECK(mgr.stats().culled == 1);
+    CHECK(mgr.active_voice_count() == 5);
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,290 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "renderer/terrain_lod.hpp"
+#include "renderer/frustum.hpp"
+#include "renderer/camera.hpp"
+#include "map/heightmap.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace osc;
+using namespace osc::renderer;
+using osc::map::Heightmap;
+
+namespace {
+
+constexpr u32 DECIMATE = 2;
+constexpr u32 N = TerrainLOD::CHUNK_QUADS;
+constexpr u32 VERTS = TerrainLOD::CHUNK_VERTS;
+
+/// Rolling hills with smaller ripples, so chunk errors vary.
+Heightmap synthetic_heightmap(u32 size) {
+    std::vector<u16> data(static_cast<size_t>(size + 1) * (size + 1));
+    for (u32 z = 0; z <= size; ++z) {
+        for (u32 x = 0; x <= size; ++x) {
+            f32 fx = static_cast<f32>(x), fz = static_cast<f32>(z);
+            f32 h = 6000.0f + 2500.0f * std::sin(fx * 0.013f) * std::cos(fz * 0.011f) +
+                    200.0f * std::sin(fx * 0.071f + fz * 0.053f);
+            data[static_cast<size_t>(z) * (size + 1) + x] = static_cast<u16>(h);
+        }
+    }
+    return Heightmap(size, size, 1.0f / 128.0f, std::move(data));
+}
+
+/// Pixels per world unit at distance 1 for a 1080-pixel-high viewport.
+f32 projection_scale() {
+    return 1080.0f / (2.0f * std::tan(Camera::FOV_Y * 0.5f));
+}
+
+/// Typical RTS camera: above `(tx, tz)`, tilted ~50 degrees, looking +Z.
+Frustum rts_frustum(f32 tx, f32 tz, f32 dist, f32 eye[3]) {
+    eye[0] = tx;
+    eye[1] = dist * std::sin(0.87f);
+    eye[2] = tz - dist * std::cos(0.87f);
+    auto view = math::look_at(eye[0], eye[1], eye[2], tx, 0.0f, tz,
+                              0.0f, 1.0f, 0.0f);
+    auto proj = math::perspective(Camera::FOV_Y, 16.0f / 9.0f, 1.0f, 5000.0f);
+    return Frustum(math::mat4_mul(proj, view));
+}
+
+enum class Side { NegX, PosX, NegZ, PosZ };
+
+using Point = std::tuple<f32, f32, f32>;
+using Segment = std::pair<Point, Point>;
+
+/// World-space triangle edges lying on one side of a chunk, drawn with the
+/// given LOD / stitch variant.
+std::vector<Segment> edge_segments(const TerrainLOD& lod, u32 chunk, u32 level,
+                                   u8 stitch, Side side) {
+    auto on_side = [&](u32 v) {
+        u32 i = v % VERTS, j = v / VERTS;
+        switch (side) {
+        case Side::NegX: return i == 0;
+        case Side::PosX: return i == N;
+        case Side::NegZ: return j == 0;
+        case Side::PosZ: return j == N;
+        }
+        return false;
+    };
+    const auto& verts = lod.vertices();
+    const u32 base = lod.chunks()[chunk].vertex_offset;
+    auto point = [&](u32 v) {
+        const auto& p = verts[base + v];
+        return Point{p.x, p.y, p.z};
+    };
+
+    std::vector<Segment> out;
+    auto range = lod.index_range(level, stitch);
+    const auto& idx = lod.indices();
+    for (u32 t = range.first; t < range.first + range.count; t += 3) {
+        for (u32 e = 0; e < 3; ++e) {
+            u32 a = idx[t + e], b = idx[t + (e + 1) % 3];
+            if (!on_side(a) || !on_side(b)) continue;
+            Point pa = point(a), pb = point(b);
+            out.emplace_back(std::min(pa, pb), std::max(pa, pb));
+        }
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("Terrain LOD index variants tile each chunk", "[renderer][terrain]") {
+    TerrainLOD lod;
+    lod.build(synthetic_heightmap(128), DECIMATE);
+
+    for (u32 level = 0; level < TerrainLOD::LOD_COUNT; ++level) {
+        for (u32 mask = 0; mask < terrain_stitch::VARIANTS; ++mask) {
+            auto range = lod.index_range(level, static_cast<u8>(mask));
+            REQUIRE(range.count % 3 == 0);
+            REQUIRE(range.count > 0);
+
+            // Every triangle keeps the mesh winding and together they
+            // cover the chunk's square exactly once
+            i64 area2 = 0;
+            for (u32 t = range.first; t < range.first + range.count; t += 3) {
+                i64 p[3][2];
+                for (u32 k = 0; k < 3; ++k) {
+                    u32 v = lod.indices()[t + k];
+                    p[k][0] = v % VERTS;
+                    p[k][1] = v / VERTS;
+                }
+                i64 cross = (p[1][0] - p[0][0]) * (p[2][1] - p[0][1]) -
+                            (p[1][1] - p[0][1]) * (p[2][0] - p[0][0]);
+                CHECK(cross < 0);
+                area2 -= cross;
+            }
+            CHECK(area2 == 2 * static_cast<i64>(N) * N);
+        }
+    }
+    // Unstitched LOD 0 is the full grid; each level quarters it
+    CHECK(lod.index_range(0, 0).count == N * N * 6);
+    CHECK(lod.index_range(1, 0).count == N * N * 6 / 4);
+    CHECK(lod.index_range(TerrainLOD::LOD_COUNT - 1, 0).count == 6);
+}
+
+TEST_CASE("Terrain LOD stitched edges match the coarser neighbour",
+          "[renderer][terrain]") {
+    TerrainLOD lod;
+    lod.build(synthetic_heightmap(256), DECIMATE); // 2x2 chunks
+    REQUIRE(lod.chunks_x() == 2);
+    REQUIRE(lod.chunks_z() == 2);
+    const u32 left = 0, right = 1, above = 2; // above: the +Z neighbour
+
+    for (u32 level = 0; level + 1 < TerrainLOD::LOD_COUNT; ++level) {
+        // Same LOD on both sides: no stitching needed
+        CHECK(edge_segments(lod, left, level, 0, Side::PosX) ==
+              edge_segments(lod, right, level, 0, Side::NegX));
+
+        // Finer on the left / bottom, coarser on the right / top
+        CHECK(edge_segments(lod, left, level, terrain_stitch::POS_X, Side::PosX) ==
+              edge_segments(lod, right, level + 1, 0, Side::NegX));
+        CHECK(edge_segments(lod, left, level, terrain_stitch::POS_Z, Side::PosZ) ==
+              edge_segments(lod, above, level + 1, 0, Side::NegZ));
+
+        // Coarser on the left / bottom
+        CHECK(edge_segments(lod, left, level + 1, 0, Side::PosX) ==
+              edge_segments(lod, right, level, terrain_stitch::NEG_X, Side::NegX));
+        CHECK(edge_segments(lod, left, level + 1, 0, Side::PosZ) ==
+              edge_segments(lod, above, level, terrain_stitch::NEG_Z, Side::NegZ));
+
+        // Without the stitch the finer edge has extra vertices: a crack
+        CHECK(edge_segments(lod, left, level, 0, Side::PosX) !=
+              edge_segments(lod, right, level + 1, 0, Side::NegX));
+    }
+}
+
+TEST_CASE("Terrain LOD selection by screen-space error", "[renderer][terrain]") {
+    TerrainLOD lod;
+    lod.build(synthetic_heightmap(1024), DECIMATE); // 8x8 chunks
+    REQUIRE(lod.chunks().size() == 64);
+
+    // Low camera over one corner
+    TerrainLODParams params;
+    params.eye[0] = 20.0f;
+    params.eye[1] = 80.0f;
+    params.eye[2] = 20.0f;
+    params.projection_scale = projection_scale();
+
+    std::vector<TerrainChunkDraw> draws;
+    lod.select(params, nullptr, draws);
+    REQUIRE(draws.size() == lod.chunks().size());
+
+    const u32 w = lod.chunks_x(), h = lod.chunks_z();
+    auto at = [&](u32 x, u32 z) { return draws[z * w + x]; };
+    CHECK(at(0, 0).lod == 0);
+    CHECK(at(w - 1, h - 1).lod > at(0, 0).lod);
+
+    u32 stitched = 0;
+    for (u32 z = 0; z < h; ++z) {
+        for (u32 x = 0; x < w; ++x) {
+            const auto& d = at(x, z);
+            const auto& chunk = lod.chunks()[z * w + x];
+            CHECK(d.visible);
+
+            // The projected error stays within budget
+            f32 d2 = 0.0f;
+            for (int a = 0; a < 3; ++a) {
+                f32 e = params.eye[a];
+                f32 delta = std::max({chunk.min[a] - e, e - chunk.max[a], 0.0f});
+                d2 += delta * delta;
+            }
+            f32 dist = std::max(std::sqrt(d2), 1.0f);
+            CHECK(chunk.error[d.lod] * params.projection_scale / dist <=
+                  params.max_pixel_error);
+
+            // Neighbours at most one LOD apart, stitched toward the coarser
+            auto expect_stitch = [&](bool has, u32 nx, u32 nz, u8 bit) {
+                if (!has) {
+                    CHECK((d.stitch & bit) == 0);
+                    return;
+                }
+                u8 n = at(nx, nz).lod;
+                CHECK(std::abs(static_cast<int>(n) - d.lod) <= 1);
+                CHECK(((d.stitch & bit) != 0) == (n > d.lod));
+                if (d.stitch & bit) stitched++;
+            };
+            expect_stitch(x > 0, x - 1, z, terrain_stitch::NEG_X);
+            expect_stitch(x + 1 < w, x + 1, z, terrain_stitch::POS_X);
+            expect_stitch(z > 0, x, z - 1, terrain_stitch::NEG_Z);
+            expect_stitch(z + 1 < h, x, z + 1, terrain_stitch::POS_Z);
+
+            // Shared edges are identical with the selected variants
+            if (x + 1 < w) {
+                CHECK(edge_segments(lod, z * w + x, d.lod, d.stitch, Side::PosX) ==
+                      edge_segments(lod, z * w + x + 1, at(x + 1, z).lod,
+                                    at(x + 1, z).stitch, Side::NegX));
+            }
+            if (z + 1 < h) {
+                CHECK(edge_segments(lod, z * w + x, d.lod, d.stitch, Side::PosZ) ==
+                      edge_segments(lod, (z + 1) * w + x, at(x, z + 1).lod,
+                                    at(x, z + 1).stitch, Side::NegZ));
+            }
+        }
+    }
+    CHECK(stitched > 0);
+
+    // Frustum culling drops chunks behind the camera
+    f32 eye[3];
+    Frustum frustum = rts_frustum(512.0f, 300.0f, 250.0f, eye);
+    std::copy(eye, eye + 3, params.eye);
+    lod.select(params, &frustum, draws);
+    auto visible = std::count_if(draws.begin(), draws.end(),
+                                 [](const auto& d) { return d.visible; });
+    CHECK(visible > 0);
+    CHECK(visible < static_cast<long>(draws.size()));
+    CHECK(lod.triangle_count(draws) < lod.triangle_count(draws, true));
+}
+
+TEST_CASE("Terrain LOD triangle counts for 5, 10, 20 and 81 km maps",
+          "[renderer][terrain]") {
+    // Map size (heightmap units) -> km: 256 = 5, 512 = 10, 1024 = 20, 4096 = 81
+    for (u32 size : {256u, 512u, 1024u, 4096u}) {
+        TerrainLOD lod;
+        lod.build(synthetic_heightmap(size), DECIMATE);
+
+        // The old single mesh drew every decimated quad
+        u64 dw = size / DECIMATE;
+        u64 full = 2 * dw * dw;
+
+        f32 eye[3];
+        Frustum frustum = rts_frustum(size * 0.5f, size * 0.5f, 300.0f, eye);
+        TerrainLODParams params;
+        std::copy(eye, eye + 3, params.eye);
+        params.projection_scale = projection_scale();
+        std::vector<TerrainChunkDraw> draws;
+        lod.select(params, &frustum, draws);
+
+        u64 drawn = lod.triangle_count(draws);
+        u64 shadow = lod.triangle_count(draws, true);
+        INFO(size << ": " << drawn << " visible / " << shadow << " selected / "
+                  << full << " full");
+        CHECK(drawn > 0);
+        CHECK(drawn <= shadow);
+        CHECK(shadow < full);
+        // Large maps: the view is a small part, distant chunks are coarse
+        if (size >= 1024) CHECK(drawn * 10 < full);
+    }
+}
+
+TEST_CASE("Terrain LOD selection benchmark", "[.benchmark][renderer][terrain]") {
+    TerrainLOD lod;
+    lod.build(synthetic_heightmap(4096), DECIMATE);
+    f32 eye[3];
+    Frustum frustum = rts_frustum(2048.0f, 2048.0f, 300.0f, eye);
+    TerrainLODParams params;
+    std::copy(eye, eye + 3, params.eye);
+    params.projection_scale = projection_scale();
+    std::vector<TerrainChunkDraw> draws;
+
+    BENCHMARK("select, 81 km map (1024 chunks)") {
+        lod.select(params, &frustum, draws);
+        return lod.triangle_count(draws);
+    };
+}
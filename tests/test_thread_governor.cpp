@@ -0,0 +1,169 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "lua/lua_state.hpp"
+#include "sim/thread_manager.hpp"
+
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <lua.h>
+}
+
+using namespace osc;
+using namespace osc::sim;
+
+namespace {
+
+constexpr const char* SCRIPT = R"(
+steps = {}
+results = {}
+unit_ticks = 0
+
+-- Synthetic AI analysis: millions of instructions without a single
+-- WaitTicks, then it records its answer and idles.
+function Hog(id, n)
+    local acc = 0
+    for i = 1, n do
+        acc = acc + i * 0.5
+        steps[id] = i
+    end
+    -- pcall sections cannot be sliced; they must still run correctly
+    local ok, part = pcall(function()
+        local s = 0
+        for i = 1, 20000 do s = s + i end
+        return s
+    end)
+    results[id] = acc + part
+    while true do coroutine.yield(10) end
+end
+
+function UnitScript()
+    while true do
+        unit_ticks = unit_ticks + 1
+        coroutine.yield(1)
+    end
+end
+)";
+
+struct Scenario {
+    lua::LuaState state;
+    ThreadManager threads{state.raw()};
+
+    Scenario(u32 budget, u32 hogs, u32 hog_iterations) {
+        threads.set_tick_budget(budget);
+        REQUIRE(state.do_string(SCRIPT).ok());
+        lua_State* L = state.raw();
+        lua_settop(L, 0); // fork_thread takes the function at index 1
+        lua_getglobal(L, "UnitScript");
+        threads.fork_thread(L);
+        lua_settop(L, 0);
+        for (u32 id = 1; id <= hogs; ++id) {
+            lua_getglobal(L, "Hog");
+            lua_pushnumber(L, id);
+            lua_pushnumber(L, hog_iterations);
+            threads.fork_thread(L, ThreadClass::Deferrable);
+            lua_settop(L, 0);
+        }
+    }
+
+    f64 number(const char* table, u32 id) {
+        lua_State* L = state.raw();
+        lua_getglobal(L, table);
+        lua_rawgeti(L, -1, static_cast<int>(id));
+        f64 v = lua_isnumber(L, -1) ? lua_tonumber(L, -1) : -1.0;
+        lua_pop(L, 2);
+        return v;
+    }
+
+    f64 global(const char* name) {
+        lua_getglobal(state.raw(), name);
+        f64 v = lua_tonumber(state.raw(), -1);
+        lua_pop(state.raw(), 1);
+        return v;
+    }
+};
+
+/// Everything observable per tick, for comparing runs.
+std::vector<f64> run_trace(u32 ticks) {
+    Scenario s(500000, 4, 400000);
+    std::vector<f64> trace;
+    for (u32 tick = 0; tick < ticks; ++tick) {
+        s.threads.resume_all(tick);
+        const auto& st = s.threads.last_tick_stats();
+        trace.insert(trace.end(),
+                     {f64(st.deferrable_instructions), f64(st.preempted),
+                      f64(st.deferred), f64(st.max_deferral)});
+        for (u32 id = 1; id <= 4; ++id)
+            trace.push_back(s.number("steps", id));
+    }
+    return trace;
+}
+
+} // namespace
+
+TEST_CASE("Deferrable threads are sliced at the tick budget",
+          "[sim][threads]") {
+    constexpr u32 BUDGET = 1000000;
+    constexpr u32 ITERATIONS = 2000000;
+
+    // Reference: no governor, each hog finishes inside tick 0
+    Scenario ref(0, 2, ITERATIONS);
+    ref.threads.resume_all(0);
+    REQUIRE(ref.number("results", 1) > 0.0);
+    REQUIRE(ref.number("results", 2) > 0.0);
+
+    Scenario s(BUDGET, 2, ITERATIONS);
+    u32 tick = 0;
+    u32 max_deferral = 0;
+    for (; tick < 200 && (s.number("results", 1) < 0.0 ||
+                          s.number("results", 2) < 0.0);
+         ++tick) {
+        s.threads.resume_all(tick);
+        const auto& st = s.threads.last_tick_stats();
+        // A preempted thread stops at the first quantum past the budget
+        CHECK(st.deferrable_instructions <= BUDGET + ThreadManager::QUANTUM);
+        max_deferral = std::max(max_deferral, st.max_deferral);
+        // Critical threads run every tick regardless
+        CHECK(s.global("unit_ticks") == tick + 1);
+    }
+    CHECK(tick > 4); // the work was spread over several ticks
+    CHECK(tick < 200);
+    CHECK(max_deferral <= s.threads.max_deferral());
+    CHECK(s.number("results", 1) == ref.number("results", 1));
+    CHECK(s.number("results", 2) == ref.number("results", 2));
+}
+
+TEST_CASE("Overdue deferrable threads get a guaranteed slice",
+          "[sim][threads]") {
+    // Budget for roughly one hog per tick, eight hogs competing
+    Scenario s(200000, 8, 1000000);
+    for (u32 tick = 0; tick < 60; ++tick) {
+        s.threads.resume_all(tick);
+        const auto& st = s.threads.last_tick_stats();
+        CHECK(st.max_deferral <= s.threads.max_deferral());
+        CHECK(st.deferrable_resumed > 0);
+        CHECK(s.global("unit_ticks") == tick + 1);
+    }
+    // Every hog advanced, none starved behind the others
+    for (u32 id = 1; id <= 8; ++id)
+        CHECK(s.number("steps", id) > 100000.0);
+}
+
+TEST_CASE("Governed ticks are identical across runs", "[sim][threads]") {
+    auto a = run_trace(40);
+    auto b = run_trace(40);
+    CHECK(a == b);
+}
+
+TEST_CASE("AI script sources are deferrable", "[sim][threads]") {
+    CHECK(ThreadManager::is_deferrable_source("@/lua/AI/aiutilities.lua:120"));
+    CHECK(ThreadManager::is_deferrable_source("@/lua/aibrain.lua:88"));
+    CHECK(ThreadManager::is_deferrable_source("@/lua/aibrains/base-ai.lua:5"));
+    CHECK(ThreadManager::is_deferrable_source("@/lua/platoon.lua:300"));
+    CHECK(ThreadManager::is_deferrable_source("@/mods/m27/lua/AI/m27.lua:1"));
+    CHECK_FALSE(ThreadManager::is_deferrable_source("@/lua/sim/unit.lua:414"));
+    CHECK_FALSE(ThreadManager::is_deferrable_source("@/lua/sim/weapon.lua:70"));
+    CHECK_FALSE(ThreadManager::is_deferrable_source("@/lua/ui/game/hud.lua:3"));
+    CHECK_FALSE(ThreadManager::is_deferrable_source(""));
+}
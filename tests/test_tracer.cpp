@@ -0,0 +1,229 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "core/profiler.hpp"
+#include "core/tracer.hpp"
+
+#include <algorithm>
+#include <latch>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace osc;
+
+namespace {
+
+constexpr TraceSite OUTER{"outer"};
+constexpr TraceSite NESTED{"nested"};
+constexpr TraceSite WORK{"work"};
+
+/// Nest `depth` zones deeper than the old profiler's 16-entry stack.
+void nest(u32 depth) {
+    TraceScope scope(&NESTED);
+    if (depth > 1) nest(depth - 1);
+}
+
+/// Check one thread's events: timestamps never go back and every End
+/// closes the innermost open Begin. Returns the deepest nesting seen.
+u32 check_nesting(const std::vector<TraceEvent>& events) {
+    std::vector<const TraceSite*> stack;
+    u32 deepest = 0;
+    u64 last_ts = 0;
+    for (const auto& e : events) {
+        REQUIRE(e.ts_ns >= last_ts);
+        last_ts = e.ts_ns;
+        if (e.type == TraceEventType::Begin) {
+            stack.push_back(e.site);
+            deepest = std::max(deepest, static_cast<u32>(stack.size()));
+        } else if (e.type == TraceEventType::End) {
+            REQUIRE(!stack.empty());
+            REQUIRE(stack.back() == e.site);
+            stack.pop_back();
+        }
+    }
+    CHECK(stack.empty());
+    return deepest;
+}
+
+size_t count_of(const std::string& text, const std::string& what) {
+    size_t n = 0;
+    for (size_t p = text.find(what); p != std::string::npos;
+         p = text.find(what, p + what.size()))
+        ++n;
+    return n;
+}
+
+} // namespace
+
+TEST_CASE("Tracer keeps per-thread order and nesting", "[core][trace]") {
+    constexpr u32 THREADS = 4;
+    constexpr u32 ROUNDS = 200;
+    constexpr u32 DEPTH = 40;
+    auto& tracer = Tracer::instance();
+    tracer.start();
+
+    u64 outer_begin = 0, outer_end = 0;
+    {
+        TraceScope outer(&OUTER);
+        // Keep every worker alive together so their recording overlaps
+        std::latch started(THREADS), finished(THREADS);
+        std::vector<std::thread> workers;
+        for (u32 t = 0; t < THREADS; ++t) {
+            workers.emplace_back([t, &started, &finished] {
+                Tracer::instance().set_thread_name("worker " + std::to_string(t));
+                started.arrive_and_wait();
+                for (u32 r = 0; r < ROUNDS; ++r) {
+                    TRACE_COUNTER("rounds", r);
+                    TraceScope work(&WORK);
+                    nest(DEPTH);
+                }
+                finished.arrive_and_wait();
+            });
+        }
+        for (auto& w : workers) w.join();
+    }
+    tracer.stop();
+
+    auto threads = tracer.snapshot();
+    std::vector<u32> tids;
+    u32 workers_seen = 0;
+    for (const auto& t : threads) {
+        tids.push_back(t.tid);
+        u32 deepest = check_nesting(t.events);
+        if (t.name.rfind("worker ", 0) == 0) {
+            ++workers_seen;
+            // work + nested zones, Begin and End each, plus a counter
+            CHECK(t.events.size() == ROUNDS * (2 * (DEPTH + 1) + 1));
+            CHECK(deepest == DEPTH + 1);
+            const auto& last_counter = t.events[t.events.size() - 2 * (DEPTH + 1) - 1];
+            CHECK(last_counter.type == TraceEventType::Counter);
+            CHECK(last_counter.value == ROUNDS - 1);
+        } else {
+            for (const auto& e : t.events) {
+                if (e.site != &OUTER) continue;
+                (e.type == TraceEventType::Begin ? outer_begin : outer_end) = e.ts_ns;
+            }
+        }
+    }
+    CHECK(workers_seen == THREADS);
+    std::sort(tids.begin(), tids.end());
+    CHECK(std::adjacent_find(tids.begin(), tids.end()) == tids.end());
+
+    // Worker timelines sit inside the zone that spawned and joined them
+    REQUIRE(outer_end > outer_begin);
+    for (const auto& t : threads) {
+        if (t.name.rfind("worker ", 0) != 0) continue;
+        CHECK(t.events.front().ts_ns >= outer_begin);
+        CHECK(t.events.back().ts_ns <= outer_end);
+    }
+    CHECK(tracer.dropped() == 0);
+}
+
+TEST_CASE("Tracer exports Chrome trace JSON", "[core][trace]") {
+    auto& tracer = Tracer::instance();
+    tracer.start();
+    Tracer::instance().set_thread_name("main \"test\"");
+    {
+        PROFILE_ZONE("Sim::tick"); // profiler zones land on the timeline too
+        TRACE_ZONE("Sim::threads");
+        TRACE_COUNTER("Entities", 1234);
+    }
+    tracer.stop();
+    { TRACE_ZONE("after stop"); }
+
+    std::ostringstream out;
+    tracer.write_chrome_json(out);
+    std::string json = out.str();
+    CHECK(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0);
+    CHECK(count_of(json, "\"ph\":\"B\"") == 2);
+    CHECK(count_of(json, "\"ph\":\"E\"") == 2);
+    CHECK(count_of(json, "\"name\":\"Sim::tick\"") == 2);
+    CHECK(json.find("\"ph\":\"C\"") != std::string::npos);
+    CHECK(json.find("\"args\":{\"value\":1234}") != std::string::npos);
+    CHECK(json.find("\"args\":{\"name\":\"main \\\"test\\\"\"}") != std::string::npos);
+    CHECK(json.find("after stop") == std::string::npos);
+    CHECK(json.substr(json.size() - 4) == "\n]}\n");
+}
+
+TEST_CASE("Tracer start discards the previous capture", "[core][trace]") {
+    auto& tracer = Tracer::instance();
+    tracer.start();
+    { TraceScope s(&OUTER); }
+    tracer.start();
+    { TraceScope s(&WORK); }
+    tracer.stop();
+
+    size_t events = 0;
+    for (const auto& t : tracer.snapshot()) {
+        for (const auto& e : t.events) CHECK(e.site == &WORK);
+        events += t.events.size();
+    }
+    CHECK(events == 2);
+}
+
+TEST_CASE("Threads that start after others exit get their own track",
+          "[core][trace]") {
+    auto& tracer = Tracer::instance();
+    auto run_thread = [](const char* name) {
+        std::thread([name] {
+            Tracer::instance().set_thread_name(name);
+            TraceScope s(&WORK);
+        }).join();
+    };
+    auto find = [](const std::vector<Tracer::ThreadEvents>& threads,
+                   const std::string& name) {
+        auto it = std::find_if(threads.begin(), threads.end(),
+                               [&](const auto& t) { return t.name == name; });
+        REQUIRE(it != threads.end());
+        return *it;
+    };
+
+    tracer.start();
+    run_thread("first");
+    run_thread("second");
+    auto threads = tracer.snapshot();
+    auto first = find(threads, "first");
+    auto second = find(threads, "second");
+    CHECK(first.tid != second.tid);
+    CHECK(first.events.size() == 2);
+    CHECK(second.events.size() == 2);
+
+    // In the next capture their buffers are reused, each under a new track
+    tracer.start();
+    run_thread("third");
+    tracer.stop();
+    threads = tracer.snapshot();
+    auto third = find(threads, "third");
+    CHECK(third.tid != first.tid);
+    CHECK(third.tid != second.tid);
+    CHECK(third.events.size() == 2);
+    for (const auto& t : threads) CHECK(t.name != "first");
+}
+
+TEST_CASE("Tracer zone cost benchmark", "[.benchmark][core][trace]") {
+    // Per-zone cost against the aggregate Profiler (strcmp zone lookup)
+    auto& profiler = Profiler::instance();
+    profiler.set_enabled(true);
+    profiler.begin_frame();
+    for (const char* name : {"Sim::a", "Sim::b", "Sim::c", "Sim::d", "Sim::e",
+                             "Sim::f", "Sim::g", "Sim::h"}) {
+        ProfileScope warm(name);
+    }
+    BENCHMARK("Profiler zone (9 zones this frame)") {
+        ProfileScope scope("Sim::tick");
+    };
+    profiler.end_frame();
+    profiler.set_enabled(false);
+
+    auto& tracer = Tracer::instance();
+    tracer.start();
+    BENCHMARK("Tracer zone, recording") {
+        TRACE_ZONE("Sim::tick");
+    };
+    tracer.stop();
+    BENCHMARK("Tracer zone, idle") {
+        TRACE_ZONE("Sim::tick");
+    };
+}
@@ -0,0 +1,165 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "sim/unit_command.hpp"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+using namespace osc;
+using namespace osc::sim;
+
+namespace {
+
+UnitCommand move_to(f32 x, u32 id = 0) {
+    UnitCommand cmd;
+    cmd.type = CommandType::Move;
+    cmd.target_pos = {x, 0, 0};
+    cmd.command_id = id;
+    return cmd;
+}
+
+} // namespace
+
+TEST_CASE("Command names are interned", "[sim][command]") {
+    CommandStore store;
+    UnitCommand a, b;
+    a.set_blueprint_id(store, "uel0105");
+    b.set_blueprint_id(store, std::string("uel") + "0105");
+    CHECK(a.blueprint == b.blueprint);
+    CHECK(a.blueprint_id(store) == "uel0105");
+
+    UnitCommand none;
+    CHECK(none.blueprint == 0);
+    CHECK(none.blueprint_id(store).empty());
+    CHECK(store.intern("") == 0);
+    CHECK(store.intern("uel0106") != a.blueprint);
+}
+
+TEST_CASE("Command queue keeps FIFO order across inline and spilled storage",
+          "[sim][command]") {
+    CommandStore store;
+    {
+        CommandQueue q;
+        CHECK(q.empty());
+        CHECK(q.store() == nullptr);
+        for (u32 i = 0; i < 11; ++i)
+            q.push_back(store, move_to(static_cast<f32>(i)));
+        REQUIRE(q.size() == 11);
+        CHECK(q.store() == &store);
+        for (u32 i = 0; i < 11; ++i)
+            CHECK(q[i].target_pos.x == static_cast<f32>(i));
+
+        // Wrap the ring: pop from the front, push at the back
+        for (u32 i = 0; i < 6; ++i) {
+            q.pop_front();
+            q.push_back(store, move_to(static_cast<f32>(100 + i)));
+        }
+        std::vector<f32> xs;
+        for (const auto& cmd : q) xs.push_back(cmd.target_pos.x);
+        CHECK(xs == std::vector<f32>{6, 7, 8, 9, 10, 100, 101, 102, 103,
+                                     104, 105});
+
+        q.rotate();
+        CHECK(q.front().target_pos.x == 7.0f);
+        CHECK(q[q.size() - 1].target_pos.x == 6.0f);
+        CHECK(q.size() == 11);
+
+        q.truncate(1);
+        CHECK(q.size() == 1);
+        CHECK(q.front().target_pos.x == 7.0f);
+        CHECK(store.live_count() == 1);
+
+        q.clear();
+        CHECK(q.empty());
+        q.push_back(store, move_to(1));
+        q.push_back(store, move_to(2));
+        q.rotate();
+        CHECK(q.front().target_pos.x == 2.0f);
+    }
+    CHECK(store.live_count() == 0);
+}
+
+TEST_CASE("Group commands share one payload", "[sim][command]") {
+    CommandStore store;
+    std::vector<std::unique_ptr<CommandQueue>> queues;
+    for (int i = 0; i < 200; ++i)
+        queues.push_back(std::make_unique<CommandQueue>());
+
+    {
+        UnitCommand cmd = move_to(42, 7);
+        cmd.set_blueprint_id(store, "urb0101");
+        CommandGroup group(store, cmd);
+        for (auto& q : queues) q->push_back(group);
+        CHECK(store.live_count() == 1);
+        CHECK(&queues[0]->front() == &queues[199]->front());
+    }
+    // The group handle is gone; queues keep the payload alive
+    CHECK(store.live_count() == 1);
+    CHECK(queues[5]->front().command_id == 7);
+    CHECK(queues[5]->front().blueprint_id(store) == "urb0101");
+
+    for (size_t i = 0; i + 1 < queues.size(); ++i) queues[i]->pop_front();
+    CHECK(store.live_count() == 1);
+    CHECK(queues.back()->front().target_pos.x == 42.0f);
+    queues.clear();
+    CHECK(store.live_count() == 0);
+}
+
+TEST_CASE("Separate stores share no slots or names", "[sim][command]") {
+    // Two sims side by side (replay next to a live game, or two tests)
+    CommandStore first, second;
+    UnitCommand a = move_to(1), b = move_to(2);
+    a.set_blueprint_id(first, "uel0105");
+    b.set_blueprint_id(second, "urb0101");
+    CHECK(a.blueprint == 1);
+    CHECK(b.blueprint == 1);
+    CHECK(a.blueprint_id(first) == "uel0105");
+    CHECK(b.blueprint_id(second) == "urb0101");
+
+    CommandQueue qa, qb;
+    for (u32 i = 0; i < 6; ++i) {
+        qa.push_back(first, a);
+        qb.push_back(second, b);
+    }
+    CHECK(first.live_count() == 6);
+    CHECK(second.live_count() == 6);
+    CHECK(qa.front().target_pos.x == 1.0f);
+    CHECK(qb.front().target_pos.x == 2.0f);
+
+    qa.clear();
+    CHECK(first.live_count() == 0);
+    CHECK(second.live_count() == 6);
+    CHECK(qb[5].blueprint_id(second) == "urb0101");
+}
+
+TEST_CASE("Command queue benchmark", "[.benchmark][sim][command]") {
+    CommandStore store;
+    UnitCommand cmd = move_to(1);
+    cmd.set_blueprint_id(store, "uel0105");
+
+    BENCHMARK("order 200 units, 3 queued each (queue)") {
+        std::vector<CommandQueue> queues(200);
+        for (int n = 0; n < 3; ++n) {
+            CommandGroup group(store, cmd);
+            for (auto& q : queues) q.push_back(group);
+        }
+        return queues.size();
+    };
+
+    struct OldCommand {
+        CommandType type;
+        Vector3 target_pos;
+        u32 target_id = 0;
+        std::string blueprint_id;
+        u32 command_id = 0;
+    };
+    OldCommand old{CommandType::Move, {1, 0, 0}, 0, "uel0105", 0};
+    BENCHMARK("order 200 units, 3 queued each (deque of strings)") {
+        std::vector<std::deque<OldCommand>> queues(200);
+        for (int n = 0; n < 3; ++n)
+            for (auto& q : queues) q.push_back(old);
+        return queues.size();
+    };
+}
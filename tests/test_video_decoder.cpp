@@ -1,7 +1,18 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include "video/video_decoder.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+
+#include "pl_mpeg.h"
+
 using namespace osc;
+using Catch::Matchers::WithinAbs;
 
 TEST_CASE("VideoDecoder basics", "[video]") {
     video::VideoDecoder decoder;
@@ -40,3 +51,293 @@ TEST_CASE("SFD demuxer", "[video]") {
         REQUIRE(result.empty());
     }
 }
+
+namespace {
+
+/// MSB-first bit writer for building test streams.
+struct BitWriter {
+    std::vector<u8> bytes;
+    u32 bit = 0;
+
+    void put(u32 value, u32 count) {
+        for (u32 i = count; i-- > 0;) {
+            if (bit % 8 == 0) bytes.push_back(0);
+            if ((value >> i) & 1) bytes.back() |= static_cast<u8>(0x80 >> (bit % 8));
+            bit++;
+        }
+    }
+    void align() { while (bit % 8) put(0, 1); }
+    void start_code(u8 code) { align(); put(0x000001, 24); put(code, 8); }
+};
+
+/// dct_dc_size VLCs (ISO 11172-2 tables B.5a/B.5b) as {code, length}.
+constexpr std::pair<u32, u32> DC_SIZE_LUMA[9] = {
+    {0b100, 3}, {0b00, 2}, {0b01, 2}, {0b101, 3}, {0b110, 3},
+    {0b1110, 4}, {0b11110, 5}, {0b111110, 6}, {0b1111110, 7}};
+constexpr std::pair<u32, u32> DC_SIZE_CHROMA[9] = {
+    {0b00, 2}, {0b01, 2}, {0b10, 2}, {0b110, 3}, {0b1110, 4},
+    {0b11110, 5}, {0b111110, 6}, {0b1111110, 7}, {0b11111110, 8}};
+
+/// Intra block carrying only a DC value (8-bit units), then end_of_block.
+void put_dc_block(BitWriter& w, int dc, int& predictor, bool luma) {
+    int diff = dc - predictor;
+    predictor = dc;
+    u32 size = 0;
+    for (int mag = diff < 0 ? -diff : diff; mag; mag >>= 1) size++;
+    auto [code, len] = luma ? DC_SIZE_LUMA[size] : DC_SIZE_CHROMA[size];
+    w.put(code, len);
+    if (size > 0) {
+        w.put(static_cast<u32>(diff > 0 ? diff : diff + (1 << size) - 1), size);
+    }
+    w.put(0b10, 2); // end_of_block
+}
+
+/// Build an MPEG-PS stream of `frames` DC-only I-pictures at 25 fps whose
+/// colours shift every frame. The pictures are flat per macroblock, so
+/// decode cost is dominated by IDCT and colour conversion as in real
+/// movies, without needing an encoder or a binary fixture.
+std::vector<u8> make_test_mpeg(u32 width, u32 height, u32 frames) {
+    u32 mb_w = (width + 15) / 16, mb_h = (height + 15) / 16;
+
+    BitWriter es;
+    es.start_code(0xB3); // sequence header
+    es.put(width, 12);
+    es.put(height, 12);
+    es.put(1, 4);        // square pixels
+    es.put(3, 4);        // 25 fps
+    es.put(0x3FFFF, 18); // variable bit rate
+    es.put(1, 1);
+    es.put(16, 10);      // vbv buffer size
+    es.put(0, 3);        // constrained, default quant matrices
+    es.start_code(0xB8); // group of pictures
+    es.put(0, 25);
+    es.put(1, 2);        // closed gop
+    for (u32 f = 0; f < frames; f++) {
+        es.start_code(0x00); // picture
+        es.put(f % 1024, 10);
+        es.put(1, 3);        // I-picture
+        es.put(0xFFFF, 16);
+        es.put(0, 1);
+        for (u32 my = 0; my < mb_h; my++) {
+            es.start_code(static_cast<u8>(my + 1)); // slice
+            es.put(8, 5);                           // quantizer scale
+            es.put(0, 1);
+            int pred[3] = {128, 128, 128};
+            for (u32 mx = 0; mx < mb_w; mx++) {
+                es.put(1, 1); // address increment 1
+                es.put(1, 1); // intra
+                int luma = static_cast<int>((mx * 16 + f * 8) % 220) + 16;
+                int cb = static_cast<int>((my * 24 + f * 4) % 200) + 28;
+                int cr = static_cast<int>(((mx + my) * 12 + f * 2) % 200) + 28;
+                for (int b = 0; b < 4; b++) put_dc_block(es, luma, pred[0], true);
+                put_dc_block(es, cb, pred[1], false);
+                put_dc_block(es, cr, pred[2], false);
+            }
+        }
+    }
+    es.start_code(0xB7); // sequence end
+
+    // Program stream: pack + system header, then video PES packets
+    BitWriter ps;
+    ps.start_code(0xBA);
+    ps.put(0b0010, 4);
+    ps.put(0, 3); ps.put(1, 1); ps.put(0, 15); ps.put(1, 1); // SCR
+    ps.put(0, 15); ps.put(1, 1);
+    ps.put(1, 1); ps.put(0x3FFF, 22); ps.put(1, 1);         // mux rate
+    ps.start_code(0xBB);
+    ps.put(6, 16);                                           // header length
+    ps.put(1, 1); ps.put(0x3FFF, 22); ps.put(1, 1);         // rate bound
+    ps.put(0, 6);                                            // no audio
+    ps.put(0b00111, 5);
+    ps.put(1, 5);                                            // one video
+    ps.put(0xFF, 8);
+    constexpr size_t CHUNK = 2048;
+    for (size_t at = 0; at < es.bytes.size(); at += CHUNK) {
+        size_t n = std::min(CHUNK, es.bytes.size() - at);
+        ps.start_code(0xE0);
+        ps.put(static_cast<u32>(n + 1), 16);
+        ps.put(0x0F, 8); // no P-STD, no timestamps
+        ps.align();
+        ps.bytes.insert(ps.bytes.end(), es.bytes.begin() + at,
+                        es.bytes.begin() + at + n);
+        ps.bit += static_cast<u32>(n * 8);
+    }
+    ps.start_code(0xB9); // program end
+    return ps.bytes;
+}
+
+} // namespace
+
+TEST_CASE("yuv420_to_rgba matches pl_mpeg's converter", "[video]") {
+    // Odd chroma widths exercise the SIMD remainder path
+    for (u32 width : {16u, 30u, 48u, 94u}) {
+        u32 height = 6;
+        u32 cw = width / 2, ch = height / 2;
+        std::vector<u8> y(width * height), cb(cw * ch), cr(cw * ch);
+        u32 seed = width;
+        auto next = [&] { seed = seed * 1664525u + 1013904223u; return u8(seed >> 24); };
+        for (auto& v : y) v = next();
+        for (auto& v : cb) v = next();
+        for (auto& v : cr) v = next();
+
+        plm_frame_t frame{};
+        frame.width = width;
+        frame.height = height;
+        frame.y = {width, height, y.data()};
+        frame.cb = {cw, ch, cb.data()};
+        frame.cr = {cw, ch, cr.data()};
+        std::vector<u8> expected(width * height * 4, 255);
+        plm_frame_to_rgba(&frame, expected.data(), static_cast<int>(width * 4));
+
+        std::vector<u8> actual(width * height * 4, 0);
+        video::yuv420_to_rgba(y.data(), width, cb.data(), cr.data(), cw,
+                              width, height, actual.data(), width * 4);
+        REQUIRE(actual == expected);
+    }
+}
+
+TEST_CASE("VideoDecoder decodes a synthetic MPEG-1 stream", "[video]") {
+    constexpr u32 FRAMES = 12;
+    auto mpeg = make_test_mpeg(64, 48, FRAMES);
+    video::VideoDecoder decoder;
+    REQUIRE(decoder.open(mpeg.data(), mpeg.size()));
+    CHECK(decoder.width() == 64);
+    CHECK(decoder.height() == 48);
+    CHECK(decoder.framerate() == 25.0);
+
+    u32 decoded = 0;
+    while (decoder.decode_next_frame()) {
+        CHECK_THAT(decoder.frame_time(), WithinAbs(decoded / 25.0, 1e-9));
+        decoded++;
+    }
+    CHECK(decoded == FRAMES);
+    // Flat macroblocks: the first pixel of the last frame is opaque and
+    // matches its neighbour in the same block
+    CHECK(decoder.rgba_data()[3] == 255);
+    CHECK(std::memcmp(decoder.rgba_data(), decoder.rgba_data() + 4, 4) == 0);
+}
+
+TEST_CASE("VideoDecoder paces threaded decode by timestamp", "[video]") {
+    constexpr u32 FRAMES = 20;
+    auto mpeg = make_test_mpeg(64, 48, FRAMES);
+
+    // Reference frames from the synchronous path
+    std::vector<std::vector<u8>> reference;
+    {
+        video::VideoDecoder sync;
+        REQUIRE(sync.open(mpeg.data(), mpeg.size()));
+        while (sync.decode_next_frame()) {
+            reference.emplace_back(sync.rgba_data(),
+                                   sync.rgba_data() + 64 * 48 * 4);
+        }
+    }
+    REQUIRE(reference.size() == FRAMES);
+
+    video::VideoDecoder decoder;
+    REQUIRE(decoder.open(mpeg.data(), mpeg.size()));
+    REQUIRE(decoder.start_async(3));
+    CHECK_FALSE(decoder.decode_next_frame()); // worker owns the stream
+
+    auto wait_present = [&](f64 now) {
+        for (int i = 0; i < 2000; i++) {
+            if (decoder.present(now)) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    };
+
+    // The first present() anchors the clock and shows frame 0
+    REQUIRE(wait_present(100.0));
+    CHECK(decoder.frame_time() == 0.0);
+    CHECK(std::memcmp(decoder.rgba_data(), reference[0].data(),
+                      reference[0].size()) == 0);
+
+    // Not due yet: nothing changes even though frames are buffered
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK_FALSE(decoder.present(100.0 + 0.5 / 25.0));
+
+    // One frame period later, frame 1
+    REQUIRE(wait_present(100.0 + 1.0 / 25.0));
+    CHECK_THAT(decoder.frame_time(), WithinAbs(1.0 / 25.0, 1e-9));
+    CHECK(std::memcmp(decoder.rgba_data(), reference[1].data(),
+                      reference[1].size()) == 0);
+
+    // Far behind the clock: late frames are skipped, the stream drains
+    f64 last = decoder.frame_time();
+    while (!decoder.finished()) {
+        if (wait_present(1000.0)) {
+            CHECK(decoder.frame_time() > last);
+            last = decoder.frame_time();
+        }
+    }
+    CHECK_THAT(last, WithinAbs((FRAMES - 1) / 25.0, 1e-9));
+    CHECK(std::memcmp(decoder.rgba_data(), reference.back().data(),
+                      reference.back().size()) == 0);
+    decoder.stop_async();
+}
+
+TEST_CASE("VideoDecoder keeps timestamps monotonic when looping", "[video]") {
+    constexpr u32 FRAMES = 5;
+    auto mpeg = make_test_mpeg(32, 32, FRAMES);
+    video::VideoDecoder decoder;
+    REQUIRE(decoder.open(mpeg.data(), mpeg.size()));
+    decoder.set_loop(true);
+    REQUIRE(decoder.start_async(2));
+
+    f64 now = 0, last = -1;
+    u32 shown = 0;
+    while (shown < 3 * FRAMES) {
+        now += 1.0 / 25.0;
+        for (int i = 0; i < 2000 && !decoder.present(now); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(decoder.frame_time() > last);
+        last = decoder.frame_time();
+        shown++;
+    }
+    CHECK_FALSE(decoder.finished());
+    CHECK_THAT(last, WithinAbs((3 * FRAMES - 1) / 25.0, 1e-9));
+}
+
+TEST_CASE("VideoDecoder benchmarks", "[.benchmark][video]") {
+    auto mpeg = make_test_mpeg(640, 480, 60);
+    video::VideoDecoder decoder;
+    REQUIRE(decoder.open(mpeg.data(), mpeg.size()));
+
+    BENCHMARK("decode + convert, calling thread (640x480)") {
+        if (!decoder.decode_next_frame()) {
+            decoder.rewind();
+            decoder.decode_next_frame();
+        }
+        return decoder.rgba_data()[0];
+    };
+
+    // Colour conversion alone: pl_mpeg scalar vs the SIMD path
+    std::vector<u8> y(640 * 480, 90), cb(320 * 240, 110), cr(320 * 240, 150);
+    std::vector<u8> out(640 * 480 * 4);
+    plm_frame_t frame{};
+    frame.width = 640;
+    frame.height = 480;
+    frame.y = {640, 480, y.data()};
+    frame.cb = {320, 240, cb.data()};
+    frame.cr = {320, 240, cr.data()};
+    BENCHMARK("plm_frame_to_rgba (640x480)") {
+        plm_frame_to_rgba(&frame, out.data(), 640 * 4);
+        return out[0];
+    };
+    BENCHMARK("yuv420_to_rgba (640x480)") {
+        video::yuv420_to_rgba(y.data(), 640, cb.data(), cr.data(), 320, 640,
+                              480, out.data(), 640 * 4);
+        return out[0];
+    };
+
+    // Main-thread cost once decode runs ahead on the worker
+    decoder.set_loop(true);
+    decoder.start_async();
+    f64 now = 0;
+    BENCHMARK("present() with threaded decode") {
+        now += 1.0 / 25.0;
+        return decoder.present(now);
+    };
+    decoder.stop_async();
+}
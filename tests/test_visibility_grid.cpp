@@ -0,0 +1,314 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "map/heightmap.hpp"
+#include "map/terrain.hpp"
+#include "map/visibility_grid.hpp"
+
+#include <cmath>
+#include <functional>
+
+using namespace osc;
+using namespace osc::map;
+
+namespace {
+
+/// Build a square terrain whose height (world units) is given per grid point.
+Terrain make_terrain(u32 size, const std::function<f32(u32, u32)>& height) {
+    std::vector<u16> data(static_cast<size_t>(size + 1) * (size + 1));
+    for (u32 z = 0; z <= size; ++z)
+        for (u32 x = 0; x <= size; ++x)
+            data[z * (size + 1) + x] =
+                static_cast<u16>(std::max(0.0f, height(x, z)));
+    return Terrain(Heightmap(size, size, 1.0f, std::move(data)), 0.0f);
+}
+
+/// Rolling hills with a few sharp ridges — stresses occlusion.
+f32 hilly(u32 x, u32 z) {
+    f32 fx = static_cast<f32>(x);
+    f32 fz = static_cast<f32>(z);
+    return 60.0f + 25.0f * std::sin(fx * 0.011f) * std::cos(fz * 0.013f) +
+           12.0f * std::sin(fx * 0.047f + fz * 0.031f) +
+           (((x / 97) + (z / 131)) % 3 == 0 ? 18.0f : 0.0f);
+}
+
+/// Paint army 0 with the sweep and army 1 with the Bresenham reference.
+void paint_both(VisibilityGrid& grid, const Terrain& terrain, f32 wx, f32 wz,
+                f32 radius) {
+    f32 eye = terrain.get_terrain_height(wx, wz) + VisibilityGrid::EYE_OFFSET;
+    grid.paint_circle_los(0, wx, wz, radius, eye);
+    grid.paint_circle_los_bresenham(1, wx, wz, radius, eye);
+}
+
+} // namespace
+
+TEST_CASE("Viewshed sweep sees everything on flat terrain", "[map][vis]") {
+    auto terrain = make_terrain(512, [](u32, u32) { return 50.0f; });
+    VisibilityGrid grid(512, 512);
+    grid.build_height_grid(terrain);
+
+    paint_both(grid, terrain, 250.0f, 250.0f, 160.0f);
+    grid.paint_circle(2, 250.0f, 250.0f, 160.0f, VisFlag::Vision);
+
+    for (u32 gz = 0; gz < grid.grid_height(); ++gz) {
+        for (u32 gx = 0; gx < grid.grid_width(); ++gx) {
+            bool plain = has_flag(grid.get(gx, gz, 2), VisFlag::Vision);
+            CHECK(has_flag(grid.get(gx, gz, 0), VisFlag::Vision) == plain);
+            CHECK(has_flag(grid.get(gx, gz, 1), VisFlag::Vision) == plain);
+        }
+    }
+}
+
+TEST_CASE("Viewshed sweep occludes cells behind a ridge", "[map][vis]") {
+    // Wall along grid column 12 (world x 192..208)
+    auto terrain = make_terrain(512, [](u32 x, u32) {
+        return (x >= 192 && x <= 208) ? 200.0f : 20.0f;
+    });
+    VisibilityGrid grid(512, 512);
+    grid.build_height_grid(terrain);
+
+    // Unit at grid cell (6, 16), looking east across the wall
+    paint_both(grid, terrain, 104.0f, 264.0f, 240.0f);
+
+    for (u32 gx = 7; gx <= 12; ++gx) {
+        CHECK(has_flag(grid.get(gx, 16, 0), VisFlag::Vision));
+        CHECK(has_flag(grid.get(gx, 16, 1), VisFlag::Vision));
+    }
+    for (u32 gx = 13; gx <= 20; ++gx) {
+        CHECK_FALSE(has_flag(grid.get(gx, 16, 0), VisFlag::Vision));
+        CHECK_FALSE(has_flag(grid.get(gx, 16, 1), VisFlag::Vision));
+    }
+    // Occlusion still marks nothing as EverSeen behind the wall
+    CHECK_FALSE(has_flag(grid.get(18, 16, 0), VisFlag::EverSeen));
+}
+
+TEST_CASE("Viewshed sweep is at least as accurate as Bresenham",
+          "[map][vis]") {
+    auto terrain = make_terrain(1024, hilly);
+    VisibilityGrid grid(1024, 1024);
+    grid.build_height_grid(terrain);
+    const f32 cell = static_cast<f32>(VisibilityGrid::CELL_SIZE);
+
+    struct Src { f32 x, z, r; };
+    const Src sources[] = {
+        {520.0f, 520.0f, 400.0f},
+        {136.0f, 904.0f, 320.0f},
+        {808.0f, 200.0f, 500.0f},
+        {24.0f, 24.0f, 250.0f}, // clipped at map corner
+    };
+    for (auto& s : sources) {
+        grid.clear_transient();
+        paint_both(grid, terrain, s.x, s.z, s.r);
+
+        u32 sgx, sgz;
+        grid.world_to_grid(s.x, s.z, sgx, sgz);
+        f32 ex = (static_cast<f32>(sgx) + 0.5f) * cell;
+        f32 ez = (static_cast<f32>(sgz) + 0.5f) * cell;
+        f32 eye = terrain.get_terrain_height(s.x, s.z) +
+                  VisibilityGrid::EYE_OFFSET;
+
+        // Ground truth: march the continuous terrain along each ray.
+        u32 total = 0, sweep_ok = 0, ray_ok = 0, agree = 0;
+        for (u32 gz = 0; gz < grid.grid_height(); ++gz) {
+            for (u32 gx = 0; gx < grid.grid_width(); ++gx) {
+                f32 tx = (static_cast<f32>(gx) + 0.5f) * cell;
+                f32 tz = (static_cast<f32>(gz) + 0.5f) * cell;
+                f32 dist = std::hypot(tx - ex, tz - ez);
+                if (std::hypot(tx - s.x, tz - s.z) > s.r || dist <= 0.0f)
+                    continue;
+                f32 target = (terrain.get_terrain_height(tx, tz) - eye) / dist;
+                f32 horizon = -1e30f;
+                for (f32 d = cell * 0.5f; d < dist - cell * 0.5f; d += 1.0f) {
+                    f32 t = d / dist;
+                    f32 h = terrain.get_terrain_height(ex + (tx - ex) * t,
+                                                       ez + (tz - ez) * t);
+                    horizon = std::max(horizon, (h - eye) / d);
+                }
+                bool truth = target >= horizon;
+                bool sweep = has_flag(grid.get(gx, gz, 0), VisFlag::Vision);
+                bool ray = has_flag(grid.get(gx, gz, 1), VisFlag::Vision);
+                ++total;
+                if (sweep == truth) ++sweep_ok;
+                if (ray == truth) ++ray_ok;
+                if (sweep == ray) ++agree;
+            }
+        }
+        REQUIRE(total > 0);
+        f32 n = static_cast<f32>(total);
+        CHECK(static_cast<f32>(agree) / n >= 0.9f);
+        CHECK(static_cast<f32>(sweep_ok) / n >=
+              static_cast<f32>(ray_ok) / n - 0.01f);
+    }
+}
+
+TEST_CASE("Cached horizon table matches the sweep", "[map][vis]") {
+    auto terrain = make_terrain(1024, hilly);
+    VisibilityGrid grid(1024, 1024);
+    grid.build_height_grid(terrain);
+    grid.set_horizon_cache_budget(
+        VisibilityGrid::DEFAULT_HORIZON_CACHE_BUDGET);
+
+    // Off-center sources too: movers take the eye from their cell
+    const f32 sources[][3] = {
+        {520.0f, 520.0f, 480.0f},
+        {40.0f, 1000.0f, 300.0f},
+        {1016.0f, 8.0f, 512.0f},
+        {301.0f, 714.5f, 400.0f},
+    };
+    for (auto& s : sources) {
+        grid.clear_transient();
+        grid.paint_circle_los(0, s[0], s[1], s[2],
+                              grid.eye_height(s[0], s[1]));
+        grid.paint_circle_los_cached(1, s[0], s[1], s[2]);
+
+        u32 total = 0, same = 0;
+        for (u32 gz = 0; gz < grid.grid_height(); ++gz) {
+            for (u32 gx = 0; gx < grid.grid_width(); ++gx) {
+                bool sweep = has_flag(grid.get(gx, gz, 0), VisFlag::Vision);
+                bool cached = has_flag(grid.get(gx, gz, 1), VisFlag::Vision);
+                if (!sweep && !cached) continue;
+                ++total;
+                if (sweep == cached) ++same;
+                // Quantization can only ever round towards visible
+                if (sweep) CHECK(cached);
+            }
+        }
+        CHECK(static_cast<f32>(same) / static_cast<f32>(total) >= 0.99f);
+    }
+    CHECK(grid.horizon_cache_size() == 4);
+}
+
+TEST_CASE("Cached horizon tables cover only the emitter's reach",
+          "[map][vis]") {
+    auto terrain = make_terrain(1024, hilly);
+    VisibilityGrid grid(1024, 1024);
+    grid.build_height_grid(terrain);
+    grid.set_horizon_cache_budget(
+        VisibilityGrid::DEFAULT_HORIZON_CACHE_BUDGET);
+
+    auto table_bytes = [](f32 radius) {
+        size_t side = 2 * VisibilityGrid::horizon_reach(radius) + 1;
+        return side * side * sizeof(u16);
+    };
+    CHECK(VisibilityGrid::horizon_reach(512.0f) ==
+          VisibilityGrid::HORIZON_TABLE_RADIUS);
+
+    // A scout-sized radius stores a small table
+    grid.paint_circle_los_cached(0, 500.0f, 500.0f, 100.0f);
+    CHECK(grid.horizon_cache_bytes() == table_bytes(100.0f));
+
+    // A wider emitter in the same cell widens it; smaller ones reuse it
+    grid.paint_circle_los_cached(0, 505.0f, 510.0f, 300.0f);
+    grid.paint_circle_los_cached(0, 500.0f, 500.0f, 100.0f);
+    CHECK(grid.horizon_cache_size() == 1);
+    CHECK(grid.horizon_cache_bytes() == table_bytes(300.0f));
+
+    // Still matches the sweep at both radii
+    for (f32 radius : {100.0f, 300.0f}) {
+        grid.clear_transient();
+        grid.paint_circle_los(0, 503.0f, 498.0f, radius,
+                              grid.eye_height(503.0f, 498.0f));
+        grid.paint_circle_los_cached(1, 503.0f, 498.0f, radius);
+        u32 missed = 0;
+        for (u32 gz = 0; gz < grid.grid_height(); ++gz)
+            for (u32 gx = 0; gx < grid.grid_width(); ++gx)
+                if (has_flag(grid.get(gx, gz, 0), VisFlag::Vision) &&
+                    !has_flag(grid.get(gx, gz, 1), VisFlag::Vision))
+                    ++missed;
+        CHECK(missed == 0);
+    }
+}
+
+TEST_CASE("Cached horizon table on flat terrain equals paint_circle",
+          "[map][vis]") {
+    auto terrain = make_terrain(512, [](u32, u32) { return 50.0f; });
+    VisibilityGrid grid(512, 512);
+    grid.build_height_grid(terrain);
+    grid.set_horizon_cache_budget(
+        VisibilityGrid::DEFAULT_HORIZON_CACHE_BUDGET);
+
+    grid.paint_circle_los_cached(0, 250.0f, 250.0f, 300.0f);
+    grid.paint_circle(1, 250.0f, 250.0f, 300.0f, VisFlag::Vision);
+    for (u32 gz = 0; gz < grid.grid_height(); ++gz)
+        for (u32 gx = 0; gx < grid.grid_width(); ++gx)
+            CHECK(grid.get(gx, gz, 0) == grid.get(gx, gz, 1));
+}
+
+TEST_CASE("Horizon cache respects its byte budget", "[map][vis]") {
+    auto terrain = make_terrain(2048, hilly);
+    VisibilityGrid grid(2048, 2048);
+    grid.build_height_grid(terrain);
+
+    // Disabled cache falls back to the sweep and stores nothing
+    grid.paint_circle_los_cached(0, 1000.0f, 1000.0f, 200.0f);
+    CHECK(grid.horizon_cache_size() == 0);
+    CHECK(has_flag(grid.get(62, 62, 0), VisFlag::Vision));
+
+    // Interior tables are (2 * reach + 1)^2 codes; room for exactly two
+    const size_t side = 2 * VisibilityGrid::horizon_reach(200.0f) + 1;
+    const size_t table_bytes = side * side * sizeof(u16);
+    grid.set_horizon_cache_budget(table_bytes * 2);
+
+    grid.paint_circle_los_cached(0, 1000.0f, 1000.0f, 200.0f);
+    grid.paint_circle_los_cached(0, 1000.0f, 1000.0f, 200.0f);
+    CHECK(grid.horizon_cache_size() == 1);
+    grid.paint_circle_los_cached(0, 1100.0f, 1000.0f, 200.0f);
+    grid.paint_circle_los_cached(0, 1200.0f, 1000.0f, 200.0f);
+    CHECK(grid.horizon_cache_size() == 2);
+    CHECK(grid.horizon_cache_bytes() <= table_bytes * 2);
+
+    // Radius beyond the table reach bypasses the cache
+    grid.paint_circle_los_cached(0, 600.0f, 600.0f, 700.0f);
+    CHECK(grid.horizon_cache_size() == 2);
+
+    grid.set_horizon_cache_budget(0);
+    CHECK(grid.horizon_cache_size() == 0);
+    CHECK(grid.horizon_cache_bytes() == 0);
+}
+
+TEST_CASE("Viewshed sweep vs Bresenham benchmark", "[map][vis][.benchmark]") {
+    // 4096 map → 256x256 cells, enough for a 120-cell radius
+    auto terrain = make_terrain(4096, hilly);
+    VisibilityGrid grid(4096, 4096);
+    grid.build_height_grid(terrain);
+    f32 eye = terrain.get_terrain_height(2048.0f, 2048.0f) +
+              VisibilityGrid::EYE_OFFSET;
+
+    for (u32 cells : {20u, 40u, 80u, 120u}) {
+        f32 r = static_cast<f32>(cells * VisibilityGrid::CELL_SIZE);
+        BENCHMARK("sweep r=" + std::to_string(cells)) {
+            grid.paint_circle_los(0, 2048.0f, 2048.0f, r, eye);
+            return grid.get(128, 128, 0);
+        };
+        BENCHMARK("bresenham r=" + std::to_string(cells)) {
+            grid.paint_circle_los_bresenham(1, 2048.0f, 2048.0f, r, eye);
+            return grid.get(128, 128, 1);
+        };
+    }
+}
+
+TEST_CASE("Cached horizon table benchmark", "[map][vis][.benchmark]") {
+    auto terrain = make_terrain(4096, hilly);
+    VisibilityGrid grid(4096, 4096);
+    grid.build_height_grid(terrain);
+    grid.set_horizon_cache_budget(
+        VisibilityGrid::DEFAULT_HORIZON_CACHE_BUDGET);
+    f32 eye = terrain.get_terrain_height(2056.0f, 2056.0f) +
+              VisibilityGrid::EYE_OFFSET;
+
+    for (u32 cells : {8u, 20u, 32u}) {
+        f32 r = static_cast<f32>(cells * VisibilityGrid::CELL_SIZE);
+        BENCHMARK("paint_circle r=" + std::to_string(cells)) {
+            grid.paint_circle(0, 2056.0f, 2056.0f, r, VisFlag::Vision);
+            return grid.get(128, 128, 0);
+        };
+        BENCHMARK("cached r=" + std::to_string(cells)) {
+            grid.paint_circle_los_cached(1, 2056.0f, 2056.0f, r);
+            return grid.get(128, 128, 1);
+        };
+        BENCHMARK("sweep r=" + std::to_string(cells)) {
+            grid.paint_circle_los(2, 2056.0f, 2056.0f, r, eye);
+            return grid.get(128, 128, 2);
+        };
+    }
+}
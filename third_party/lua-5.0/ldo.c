@@ -405,6 +405,12 @@ LUA_API int lua_yield (lua_State *L, int nresults) {
 }
 
 
+/* OpenSupCom: can a count hook running now yield (no C call boundary)? */
+LUA_API int lua_yieldable (lua_State *L) {
+  return L->nCcalls == 0;
+}
+
+
 int luaD_pcall (lua_State *L, Pfunc func, void *u,
                 ptrdiff_t old_top, ptrdiff_t ef) {
   int status;
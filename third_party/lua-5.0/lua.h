@@ -199,6 +199,7 @@ LUA_API int lua_dump (lua_State *L, lua_Chunkwriter writer, void *data);
 */
 LUA_API int  lua_yield (lua_State *L, int nresults);
 LUA_API int  lua_resume (lua_State *L, int narg);
+LUA_API int  lua_yieldable (lua_State *L);  /* OpenSupCom */
 
 /*
 ** garbage-collection functions